@@ -0,0 +1,139 @@
+#include "counting_allocator.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+namespace piano_fingering::bench {
+
+namespace {
+
+// Each block is preceded by its size, stored in the last word of a header
+// that keeps the block aligned
+constexpr size_t kHeader = alignof(std::max_align_t);
+
+std::atomic<size_t> g_allocations{0};
+std::atomic<size_t> g_bytes{0};
+std::atomic<size_t> g_live{0};
+std::atomic<size_t> g_peak{0};
+
+size_t& stored_size(void* p) noexcept {
+  return *(static_cast<size_t*>(p) - 1);
+}
+
+void* record(void* block, size_t header, size_t size) noexcept {
+  if (block == nullptr) {
+    return nullptr;
+  }
+  g_allocations.fetch_add(1, std::memory_order_relaxed);
+  g_bytes.fetch_add(size, std::memory_order_relaxed);
+  const size_t live = g_live.fetch_add(size, std::memory_order_relaxed) + size;
+  size_t peak = g_peak.load(std::memory_order_relaxed);
+  while (live > peak &&
+         !g_peak.compare_exchange_weak(peak, live, std::memory_order_relaxed)) {
+  }
+  void* p = static_cast<char*>(block) + header;
+  stored_size(p) = size;
+  return p;
+}
+
+// The block to free
+void* release(void* p, size_t header) noexcept {
+  g_live.fetch_sub(stored_size(p), std::memory_order_relaxed);
+  return static_cast<char*>(p) - header;
+}
+
+void* counted(size_t size) noexcept {
+  return record(std::malloc(kHeader + size), kHeader, size);
+}
+
+void* counted(size_t size, std::align_val_t alignment) noexcept {
+  // aligned_alloc wants a multiple of the alignment
+  const auto align = static_cast<size_t>(alignment);
+  const size_t header = std::max(align, kHeader);
+  return record(
+      std::aligned_alloc(align, (header + size + align - 1) / align * align),
+      header, size);
+}
+
+void uncounted(void* p) noexcept {
+  if (p != nullptr) {
+    std::free(release(p, kHeader));
+  }
+}
+
+void uncounted(void* p, std::align_val_t alignment) noexcept {
+  if (p != nullptr) {
+    std::free(
+        release(p, std::max(static_cast<size_t>(alignment), kHeader)));
+  }
+}
+
+}  // namespace
+
+AllocationCounts allocation_counts() noexcept {
+  return {g_allocations.load(std::memory_order_relaxed),
+          g_bytes.load(std::memory_order_relaxed)};
+}
+
+size_t peak_bytes() noexcept { return g_peak.load(std::memory_order_relaxed); }
+
+void reset_peak_bytes() noexcept {
+  g_peak.store(g_live.load(std::memory_order_relaxed),
+               std::memory_order_relaxed);
+}
+
+void* counted_malloc(size_t size) noexcept { return counted(size); }
+
+void counted_free(void* p) noexcept { uncounted(p); }
+
+}  // namespace piano_fingering::bench
+
+using piano_fingering::bench::counted;
+using piano_fingering::bench::uncounted;
+
+void* operator new(size_t size) {
+  if (void* p = counted(size)) {
+    return p;
+  }
+  throw std::bad_alloc();
+}
+
+void* operator new[](size_t size) { return ::operator new(size); }
+
+void* operator new(size_t size, const std::nothrow_t&) noexcept {
+  return counted(size);
+}
+
+void* operator new[](size_t size, const std::nothrow_t&) noexcept {
+  return counted(size);
+}
+
+void* operator new(size_t size, std::align_val_t alignment) {
+  if (void* p = counted(size, alignment)) {
+    return p;
+  }
+  throw std::bad_alloc();
+}
+
+void* operator new[](size_t size, std::align_val_t alignment) {
+  return ::operator new(size, alignment);
+}
+
+void operator delete(void* p) noexcept { uncounted(p); }
+void operator delete[](void* p) noexcept { uncounted(p); }
+void operator delete(void* p, size_t) noexcept { uncounted(p); }
+void operator delete[](void* p, size_t) noexcept { uncounted(p); }
+void operator delete(void* p, std::align_val_t alignment) noexcept {
+  uncounted(p, alignment);
+}
+void operator delete[](void* p, std::align_val_t alignment) noexcept {
+  uncounted(p, alignment);
+}
+void operator delete(void* p, size_t, std::align_val_t alignment) noexcept {
+  uncounted(p, alignment);
+}
+void operator delete[](void* p, size_t, std::align_val_t alignment) noexcept {
+  uncounted(p, alignment);
+}
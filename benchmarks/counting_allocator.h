@@ -0,0 +1,35 @@
+// benchmarks/counting_allocator.h - Heap allocation counters
+#ifndef PIANO_FINGERING_BENCHMARKS_COUNTING_ALLOCATOR_H_
+#define PIANO_FINGERING_BENCHMARKS_COUNTING_ALLOCATOR_H_
+
+#include <cstddef>
+
+namespace piano_fingering::bench {
+
+struct AllocationCounts {
+  size_t allocations{0};
+  size_t bytes{0};
+
+  [[nodiscard]] AllocationCounts operator-(
+      const AllocationCounts& earlier) const noexcept {
+    return {allocations - earlier.allocations, bytes - earlier.bytes};
+  }
+};
+
+// Every operator new and counted_malloc() since startup, on any thread.
+// Linking counting_allocator.cpp replaces the global operator new and
+// delete, so only executables that want the counts should.
+[[nodiscard]] AllocationCounts allocation_counts() noexcept;
+
+// Most bytes held at once since the last reset_peak_bytes()
+[[nodiscard]] size_t peak_bytes() noexcept;
+void reset_peak_bytes() noexcept;
+
+// malloc and free with the same accounting, for libraries that take
+// allocation hooks (pugi::set_memory_management_functions)
+void* counted_malloc(size_t size) noexcept;
+void counted_free(void* p) noexcept;
+
+}  // namespace piano_fingering::bench
+
+#endif  // PIANO_FINGERING_BENCHMARKS_COUNTING_ALLOCATOR_H_
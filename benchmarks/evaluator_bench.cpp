@@ -0,0 +1,147 @@
+// benchmarks/evaluator_bench.cpp - ScoreEvaluator entry points per piece
+
+#include <benchmark/benchmark.h>
+
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "config/config.h"
+#include "config/preset.h"
+#include "domain/finger.h"
+#include "domain/fingering.h"
+#include "evaluator/incremental_evaluation.h"
+#include "evaluator/rule_stats.h"
+#include "evaluator/score_evaluator.h"
+#include "golden_set.h"
+
+namespace piano_fingering::bench {
+
+namespace {
+
+using evaluator::IncrementalEvaluation;
+using evaluator::ScoreEvaluator;
+
+const ScoreEvaluator& shared_evaluator() {
+  static const ScoreEvaluator evaluator = [] {
+    config::Config config{};
+    config.right_hand = config::make_medium_right_hand();
+    config.left_hand = config::mirror_to_left_hand(config.right_hand);
+    config.weights = config::RuleWeights::defaults();
+    return ScoreEvaluator(config);
+  }();
+  return evaluator;
+}
+
+// Finger of note 0 shifted by `step`, so every move changes the assignment
+domain::Finger shifted_finger(const domain::Fingering& fingering,
+                              size_t step) {
+  const int current =
+      domain::to_int(fingering[0].value_or(domain::Finger::kThumb));
+  return domain::all_fingers()[(static_cast<size_t>(current) + step) %
+                               domain::kFingerCount];
+}
+
+void set_counters(benchmark::State& state, const GoldenHand& hand) {
+  state.SetItemsProcessed(static_cast<int64_t>(state.iterations()));
+  state.counters["notes"] =
+      benchmark::Counter(static_cast<double>(hand.piece.note_count()));
+}
+
+void bm_evaluate(benchmark::State& state, const GoldenHand& hand) {
+  const auto& evaluator = shared_evaluator();
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(evaluator.evaluate(hand.piece, hand.fingerings));
+  }
+  set_counters(state, hand);
+}
+
+void bm_evaluate_instrumented(benchmark::State& state,
+                              const GoldenHand& hand) {
+  const auto& evaluator = shared_evaluator();
+  evaluator::RuleStats stats;
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(
+        evaluator.evaluate(hand.piece, hand.fingerings, stats));
+  }
+  set_counters(state, hand);
+}
+
+void bm_evaluate_delta(benchmark::State& state, const GoldenHand& hand) {
+  const auto& evaluator = shared_evaluator();
+  const size_t slices = hand.fingerings.size();
+
+  // Alternatives are swapped in and out so the loop never allocates
+  std::vector<domain::Fingering> alternatives;
+  alternatives.reserve(slices);
+  for (const auto& fingering : hand.fingerings) {
+    std::vector<std::optional<domain::Finger>> notes(fingering.begin(),
+                                                     fingering.end());
+    notes[0] = shifted_finger(fingering, 1);
+    alternatives.emplace_back(std::move(notes));
+  }
+  std::vector<domain::Fingering> proposed = hand.fingerings;
+
+  size_t slice = 0;
+  for (auto _ : state) {
+    std::swap(proposed[slice], alternatives[slice]);
+    ScoreEvaluator::SliceLocation loc{0, slice, 0, slice};
+    benchmark::DoNotOptimize(
+        evaluator.evaluate_delta(hand.piece, hand.fingerings, proposed, loc));
+    std::swap(proposed[slice], alternatives[slice]);
+    slice = (slice + 1 == slices) ? 0 : slice + 1;
+  }
+  set_counters(state, hand);
+}
+
+void bm_incremental_delta(benchmark::State& state, const GoldenHand& hand) {
+  IncrementalEvaluation session(shared_evaluator(), hand.piece,
+                                hand.fingerings);
+  const size_t slices = session.slice_count();
+
+  size_t slice = 0;
+  for (auto _ : state) {
+    ScoreEvaluator::SliceLocation loc{0, slice, 0, slice};
+    benchmark::DoNotOptimize(
+        session.delta(loc, shifted_finger(hand.fingerings[slice], 1)));
+    slice = (slice + 1 == slices) ? 0 : slice + 1;
+  }
+  set_counters(state, hand);
+}
+
+void bm_neighborhood(benchmark::State& state, const GoldenHand& hand) {
+  IncrementalEvaluation session(shared_evaluator(), hand.piece,
+                                hand.fingerings);
+  const size_t slices = session.slice_count();
+
+  size_t slice = 0;
+  for (auto _ : state) {
+    ScoreEvaluator::SliceLocation loc{0, slice, 0, slice};
+    benchmark::DoNotOptimize(session.neighborhood(loc));
+    slice = (slice + 1 == slices) ? 0 : slice + 1;
+  }
+  set_counters(state, hand);
+}
+
+}  // namespace
+
+void register_evaluator_benchmarks(const std::vector<GoldenHand>& hands) {
+  using Fn = void (*)(benchmark::State&, const GoldenHand&);
+  const std::pair<const char*, Fn> benchmarks[] = {
+      {"Evaluate", bm_evaluate},
+      {"EvaluateInstrumented", bm_evaluate_instrumented},
+      {"EvaluateDelta", bm_evaluate_delta},
+      {"IncrementalDelta", bm_incremental_delta},
+      {"Neighborhood", bm_neighborhood},
+  };
+  for (const auto& [label, fn] : benchmarks) {
+    for (const auto& hand : hands) {
+      const std::string name = std::string(label) + "/" + hand.name;
+      benchmark::RegisterBenchmark(name.c_str(), fn, std::cref(hand));
+    }
+  }
+}
+
+}  // namespace piano_fingering::bench
@@ -0,0 +1,61 @@
+#include "golden_set.h"
+
+#include <array>
+#include <optional>
+#include <utility>
+
+#include "domain/finger.h"
+#include "parser/musicxml_parser.h"
+
+namespace piano_fingering::bench {
+
+namespace {
+
+constexpr std::array<const char*, 8> kBaselineFiles = {
+    "czerny_op821_1.musicxml",  "czerny_op821_37.musicxml",
+    "czerny_op821_38.musicxml", "czerny_op821_54.musicxml",
+    "czerny_op821_62.musicxml", "czerny_op821_66.musicxml",
+    "czerny_op821_96.musicxml", "poly_test.musicxml"};
+
+}  // namespace
+
+std::span<const char* const> baseline_files() noexcept {
+  return kBaselineFiles;
+}
+
+std::vector<domain::Fingering> make_fingerings(
+    const evaluator::EvalPiece& piece) {
+  std::vector<domain::Fingering> fingerings;
+  fingerings.reserve(piece.slice_count());
+  for (size_t slice = 0; slice < piece.slice_count(); ++slice) {
+    std::vector<std::optional<domain::Finger>> assignments;
+    for (size_t k = 0; k < piece.slice_size(slice); ++k) {
+      assignments.emplace_back(
+          domain::all_fingers()[(slice + k) % domain::kFingerCount]);
+    }
+    fingerings.emplace_back(std::move(assignments));
+  }
+  return fingerings;
+}
+
+std::vector<GoldenHand> load_golden_set(const std::filesystem::path& dir) {
+  std::vector<GoldenHand> hands;
+  for (const char* file : kBaselineFiles) {
+    const auto path = dir / file;
+    auto result = parser::MusicXMLParser::parse(path);
+    const std::string stem = path.stem().string();
+    for (domain::Hand hand : {domain::Hand::kRight, domain::Hand::kLeft}) {
+      evaluator::EvalPiece piece(result.piece, hand);
+      if (piece.empty()) {
+        continue;
+      }
+      auto fingerings = make_fingerings(piece);
+      const char* side = (hand == domain::Hand::kRight) ? "right" : "left";
+      hands.push_back(
+          {stem + "/" + side, hand, std::move(piece), std::move(fingerings)});
+    }
+  }
+  return hands;
+}
+
+}  // namespace piano_fingering::bench
@@ -0,0 +1,42 @@
+// benchmarks/golden_set.h - Baseline pieces shared by the benchmarks
+#ifndef PIANO_FINGERING_BENCHMARKS_GOLDEN_SET_H_
+#define PIANO_FINGERING_BENCHMARKS_GOLDEN_SET_H_
+
+#include <filesystem>
+#include <span>
+#include <string>
+#include <vector>
+
+#include "domain/fingering.h"
+#include "domain/hand.h"
+#include "domain/piece.h"
+#include "evaluator/eval_piece.h"
+
+namespace piano_fingering::bench {
+
+// One hand of a baseline piece, compiled, with a fixed valid fingering
+struct GoldenHand {
+  std::string name;  // e.g. "czerny_op821_1/right"
+  domain::Hand hand;
+  evaluator::EvalPiece piece;
+  std::vector<domain::Fingering> fingerings;
+};
+
+// File names of the golden set in tests/baseline
+[[nodiscard]] std::span<const char* const> baseline_files() noexcept;
+
+// Loads every baseline file under `dir`; hands without notes are skipped
+[[nodiscard]] std::vector<GoldenHand> load_golden_set(
+    const std::filesystem::path& dir);
+
+// Deterministic fingering with distinct fingers per chord
+[[nodiscard]] std::vector<domain::Fingering> make_fingerings(
+    const evaluator::EvalPiece& piece);
+
+// Registered from main() once the golden set is loaded; `hands` must outlive
+// the benchmark run
+void register_evaluator_benchmarks(const std::vector<GoldenHand>& hands);
+
+}  // namespace piano_fingering::bench
+
+#endif  // PIANO_FINGERING_BENCHMARKS_GOLDEN_SET_H_
@@ -0,0 +1,30 @@
+// benchmarks/main.cpp - Loads the golden set, then runs all benchmarks
+
+#include <benchmark/benchmark.h>
+
+#include <exception>
+#include <iostream>
+#include <vector>
+
+#include "golden_set.h"
+
+int main(int argc, char** argv) {
+  benchmark::Initialize(&argc, argv);
+  if (benchmark::ReportUnrecognizedArguments(argc, argv)) {
+    return 1;
+  }
+
+  // Kept alive for the whole run: registered benchmarks refer into it
+  std::vector<piano_fingering::bench::GoldenHand> hands;
+  try {
+    hands = piano_fingering::bench::load_golden_set(BASELINE_DIR);
+  } catch (const std::exception& e) {
+    std::cerr << "Failed to load golden set: " << e.what() << '\n';
+    return 1;
+  }
+  piano_fingering::bench::register_evaluator_benchmarks(hands);
+
+  benchmark::RunSpecifiedBenchmarks();
+  benchmark::Shutdown();
+  return 0;
+}
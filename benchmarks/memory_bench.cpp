@@ -0,0 +1,271 @@
+// benchmarks/memory_bench.cpp - Peak memory and allocation regression check
+//
+// Parses, optimizes and writes a generated score of 2000 notes per hand,
+// recording heap allocations, the most heap bytes held at once and peak RSS
+// after each phase. pugixml's allocations are counted too. "parse" is the
+// pipeline's kDiscardDocument parse; "parse-document" repeats it with
+// kKeepDocument, DOM and all, for comparison. Fails if peak RSS passes the
+// SRS PERF-3.1 budget of 512 MB, if a phase allocates more often, or more
+// bytes, than its baseline allows, or if "parse" peaks no lower than
+// "parse-document".
+//
+// Usage: piano-fingering-memory [--baseline <file>] [--update-baseline]
+//                               [--tolerance <fraction>]
+
+#include <cstddef>
+#include <cstdio>
+#include <exception>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <map>
+#include <pugixml.hpp>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "config/config_manager.h"
+#include "counting_allocator.h"
+#include "generator/musicxml_generator.h"
+#include "optimizer/memory_budget.h"
+#include "optimizer/optimizer.h"
+#include "parser/musicxml_parser.h"
+#include "synthetic_piece.h"
+
+namespace piano_fingering::bench {
+
+namespace {
+
+constexpr size_t kNotesPerHand = 2000;
+constexpr size_t kRssBudgetBytes = size_t{512} * 1024 * 1024;
+// Fixed rather than the core count, so counts compare across machines
+constexpr size_t kThreads = 4;
+constexpr double kMiB = 1024.0 * 1024.0;
+
+struct Options {
+  std::filesystem::path baseline;
+  bool update_baseline{false};
+  double tolerance{0.10};
+};
+
+struct Phase {
+  std::string name;
+  AllocationCounts counts;
+  size_t peak_heap{0};
+  size_t peak_rss{0};
+};
+
+// Allocations and bytes per phase name
+using Baseline = std::map<std::string, AllocationCounts, std::less<>>;
+
+Options parse_options(int argc, char** argv) {
+  Options options;
+  for (int i = 1; i < argc; ++i) {
+    const std::string_view arg = argv[i];
+    const bool has_value = i + 1 < argc;
+    if (arg == "--baseline" && has_value) {
+      options.baseline = argv[++i];
+    } else if (arg == "--update-baseline") {
+      options.update_baseline = true;
+    } else if (arg == "--tolerance" && has_value) {
+      options.tolerance = std::stod(argv[++i]);
+    } else {
+      throw std::invalid_argument("unknown argument: " + std::string(arg));
+    }
+  }
+  if (options.update_baseline && options.baseline.empty()) {
+    throw std::invalid_argument("--update-baseline needs --baseline");
+  }
+  return options;
+}
+
+// One "<phase> <allocations> <bytes>" per line; '#' starts a comment line
+Baseline read_baseline(const std::filesystem::path& path) {
+  Baseline baseline;
+  std::ifstream in(path);
+  if (!in) {
+    throw std::runtime_error("cannot read baseline " + path.string());
+  }
+  std::string line;
+  while (std::getline(in, line)) {
+    if (line.empty() || line[0] == '#') {
+      continue;
+    }
+    std::istringstream fields(line);
+    std::string name;
+    AllocationCounts counts;
+    if (!(fields >> name >> counts.allocations >> counts.bytes)) {
+      throw std::runtime_error("malformed baseline line: " + line);
+    }
+    baseline[name] = counts;
+  }
+  return baseline;
+}
+
+void write_baseline(const std::filesystem::path& path,
+                    const std::vector<Phase>& phases) {
+  std::ofstream out(path);
+  if (!out) {
+    throw std::runtime_error("cannot write baseline " + path.string());
+  }
+  out << "# Heap allocations and bytes per phase of piano-fingering-memory\n"
+      << "# (regenerate with --update-baseline)\n";
+  for (const Phase& phase : phases) {
+    out << phase.name << ' ' << phase.counts.allocations << ' '
+        << phase.counts.bytes << '\n';
+  }
+}
+
+// Runs each phase of the pipeline, recording what it allocated
+std::vector<Phase> run_pipeline(const std::filesystem::path& dir) {
+  const std::filesystem::path input = dir / "synthetic.musicxml";
+  {
+    SyntheticOptions synthetic;
+    synthetic.notes_per_hand = kNotesPerHand;
+    std::ofstream out(input);
+    write_musicxml(out, make_synthetic_piece(synthetic));
+  }
+
+  std::vector<Phase> phases;
+  AllocationCounts mark = allocation_counts();
+  reset_peak_bytes();
+  auto end_phase = [&](std::string name) {
+    const AllocationCounts now = allocation_counts();
+    phases.push_back({std::move(name), now - mark, peak_bytes(),
+                      optimizer::peak_rss_bytes()});
+    mark = now;
+    reset_peak_bytes();
+  };
+
+  parser::MusicXMLParser::ParseOptions parse_options;
+  parse_options.mode = parser::MusicXMLParser::ParseMode::kDiscardDocument;
+  parse_options.keep_score = true;
+  auto parsed = parser::MusicXMLParser::parse(input, parse_options);
+  const std::string score = std::move(parsed.score);
+  end_phase("parse");
+
+  (void)parser::MusicXMLParser::parse(input);
+  end_phase("parse-document");
+
+  optimizer::Optimizer optimizer(
+      config::ConfigManager::load_preset("Medium"), kThreads);
+  end_phase("setup");
+
+  const auto result = optimizer.optimize_piece(parsed.piece, 0);
+  end_phase("optimize");
+
+  generator::MusicXMLGenerator::generate(
+      dir / "synthetic_fingered.musicxml", score, parsed.piece,
+      parsed.source_map, result.left_hand.fingerings,
+      result.right_hand.fingerings, true);
+  end_phase("write");
+  return phases;
+}
+
+void print_phases(const std::vector<Phase>& phases) {
+  std::printf("%-14s %14s %16s %14s %12s\n", "phase", "allocations",
+              "bytes", "peak heap KiB", "peak RSS MiB");
+  for (const Phase& phase : phases) {
+    std::printf("%-14s %14zu %16zu %14.1f %12.1f\n", phase.name.c_str(),
+                phase.counts.allocations, phase.counts.bytes,
+                static_cast<double>(phase.peak_heap) / 1024.0,
+                static_cast<double>(phase.peak_rss) / kMiB);
+  }
+}
+
+// Failures, one message each
+std::vector<std::string> check(const std::vector<Phase>& phases,
+                               const Baseline* baseline, double tolerance) {
+  std::vector<std::string> failures;
+  const size_t peak = phases.empty() ? 0 : phases.back().peak_rss;
+  if (peak > kRssBudgetBytes) {
+    failures.push_back("peak RSS " + std::to_string(peak) +
+                       " bytes exceeds the 512 MB budget (PERF-3.1)");
+  }
+  auto peak_heap = [&](std::string_view name) -> size_t {
+    for (const Phase& phase : phases) {
+      if (phase.name == name) {
+        return phase.peak_heap;
+      }
+    }
+    return 0;
+  };
+  if (peak_heap("parse") >= peak_heap("parse-document")) {
+    failures.push_back("parse: peak heap " +
+                       std::to_string(peak_heap("parse")) +
+                       " bytes, no lower than with the DOM (" +
+                       std::to_string(peak_heap("parse-document")) + ")");
+  }
+  if (baseline == nullptr) {
+    return failures;
+  }
+  auto over = [&](size_t measured, size_t expected) {
+    return static_cast<double>(measured) >
+           static_cast<double>(expected) * (1.0 + tolerance);
+  };
+  for (const Phase& phase : phases) {
+    const auto it = baseline->find(phase.name);
+    if (it == baseline->end()) {
+      failures.push_back(phase.name +
+                         ": no baseline; record it with --update-baseline");
+      continue;
+    }
+    if (over(phase.counts.allocations, it->second.allocations)) {
+      failures.push_back(phase.name + ": " +
+                         std::to_string(phase.counts.allocations) +
+                         " allocations, baseline " +
+                         std::to_string(it->second.allocations));
+    }
+    if (over(phase.counts.bytes, it->second.bytes)) {
+      failures.push_back(phase.name + ": " +
+                         std::to_string(phase.counts.bytes) +
+                         " bytes allocated, baseline " +
+                         std::to_string(it->second.bytes));
+    }
+  }
+  return failures;
+}
+
+int run(int argc, char** argv) {
+  const Options options = parse_options(argc, argv);
+  pugi::set_memory_management_functions(counted_malloc, counted_free);
+  const std::filesystem::path dir =
+      std::filesystem::temp_directory_path() / "piano-fingering-memory";
+  std::filesystem::create_directories(dir);
+  const std::vector<Phase> phases = run_pipeline(dir);
+  std::filesystem::remove_all(dir);
+  print_phases(phases);
+
+  if (options.update_baseline) {
+    write_baseline(options.baseline, phases);
+    std::cout << "Baseline written to " << options.baseline.string() << '\n';
+  }
+  Baseline baseline;
+  const bool compare = !options.baseline.empty() && !options.update_baseline;
+  if (compare) {
+    baseline = read_baseline(options.baseline);
+  }
+  const auto failures =
+      check(phases, compare ? &baseline : nullptr, options.tolerance);
+  for (const std::string& failure : failures) {
+    std::cerr << "FAIL " << failure << '\n';
+  }
+  return failures.empty() ? 0 : 1;
+}
+
+}  // namespace
+
+}  // namespace piano_fingering::bench
+
+int main(int argc, char** argv) {
+  try {
+    return piano_fingering::bench::run(argc, argv);
+  } catch (const std::exception& e) {
+    std::cerr << "piano-fingering-memory: " << e.what() << '\n';
+    return 1;
+  }
+}
@@ -0,0 +1,316 @@
+// benchmarks/optimality_bench.cpp - Optimality gap of each search mode
+//
+// Optimizes every golden-set piece in each mode and compares the score with
+// the exact optimum of the same objective, exact_search() summed over both
+// hands. Prints one row per piece and mode, then a summary per mode, so a
+// speed change can be weighed against the optimality it costs. Fails if a
+// mode scores below the exact optimum, which only a broken search or
+// objective can do.
+//
+// The optimum that piano_fingering_scorer.py recorded in
+// tests/baseline/baseline_scores.json is shown alongside, but only a piece
+// the parser read without skipping a note, and that scores no better than
+// the Python optimum, is compared with it. No golden-set piece qualifies
+// today: their left hands are written in voices 5 and 6, which the parser
+// skips, and the Python penalty model totals differently from the
+// evaluator's (czerny_op821_1's right hand: 15.0 there, 55.5 here).
+//
+// Usage: piano-fingering-optimality [--threads <n>] [--json <file>]
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdio>
+#include <exception>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <nlohmann/json.hpp>
+#include <optional>
+#include <stdexcept>
+#include <stop_token>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "domain/hand.h"
+#include "domain/piece.h"
+#include "evaluator/eval_piece.h"
+#include "golden_set.h"
+#include "optimizer/exact_search.h"
+#include "optimizer/optimizer.h"
+#include "optimizer/thread_pool.h"
+#include "parser/musicxml_parser.h"
+#include "search_mode.h"
+
+namespace piano_fingering::bench {
+
+namespace {
+
+// Slack for summed half-point costs
+constexpr double kTolerance = 1e-9;
+
+struct Options {
+  size_t threads{optimizer::ThreadPool::default_thread_count()};
+  std::filesystem::path json;
+};
+
+// Percent of `score` above `optimal`
+double gap_percent(double score, double optimal) noexcept {
+  return optimal > 0.0 ? (score - optimal) / optimal * 100.0 : 0.0;
+}
+
+struct Row {
+  std::string piece;
+  Mode mode;
+  double score;
+  // exact_search() of both hands
+  double exact;
+  // From baseline_scores.json, if recorded
+  std::optional<double> python;
+  // Whether `python` scores the same objective
+  // (see comparable_with_python())
+  bool comparable;
+  double milliseconds;
+  double evaluations_per_second;
+
+  [[nodiscard]] double gap() const noexcept {
+    return gap_percent(score, exact);
+  }
+  [[nodiscard]] bool below_exact() const noexcept {
+    return score < exact - kTolerance;
+  }
+};
+
+Options parse_options(int argc, char** argv) {
+  Options options;
+  for (int i = 1; i < argc; ++i) {
+    const std::string_view arg = argv[i];
+    const bool has_value = i + 1 < argc;
+    if (arg == "--threads" && has_value) {
+      options.threads = std::stoul(argv[++i]);
+    } else if (arg == "--json" && has_value) {
+      options.json = argv[++i];
+    } else {
+      throw std::invalid_argument("unknown argument: " + std::string(arg));
+    }
+  }
+  return options;
+}
+
+nlohmann::json read_optimal_scores(const std::filesystem::path& dir) {
+  std::ifstream in(dir / "baseline_scores.json");
+  if (!in) {
+    throw std::runtime_error("cannot read baseline_scores.json in " +
+                             dir.string());
+  }
+  return nlohmann::json::parse(in);
+}
+
+struct GoldenPiece {
+  std::string name;
+  domain::Piece piece;
+  // From baseline_scores.json, if recorded
+  std::optional<double> python;
+  // Notes the parser skipped, which the Python scorer keeps
+  size_t skipped_notes;
+};
+
+std::vector<GoldenPiece> load_pieces() {
+  const std::filesystem::path dir = BASELINE_DIR;
+  const nlohmann::json optimal_scores = read_optimal_scores(dir);
+  std::vector<GoldenPiece> pieces;
+  for (const char* file : baseline_files()) {
+    std::optional<double> python;
+    const auto optimal = optimal_scores.find(file);
+    if (optimal != optimal_scores.end() && optimal->is_number()) {
+      python = optimal->get<double>();
+    } else {
+      std::cerr << "note: no Python optimum for " << file << '\n';
+    }
+    auto parsed = parser::MusicXMLParser::parse(
+        dir / file, parser::MusicXMLParser::ParseMode::kDiscardDocument);
+    pieces.push_back({std::filesystem::path(file).stem().string(),
+                      std::move(parsed.piece), python,
+                      parsed.warnings.size()});
+  }
+  return pieces;
+}
+
+// exact_search() summed over both hands, with the optimizer's evaluator
+double exact_score(const optimizer::Optimizer& optimizer,
+                   const domain::Piece& piece) {
+  double total = 0.0;
+  for (const domain::Hand hand : {domain::Hand::kRight, domain::Hand::kLeft}) {
+    const evaluator::EvalPiece compiled(piece, hand);
+    total += optimizer::exact_search(optimizer.evaluator(), compiled).cost;
+  }
+  return total;
+}
+
+// Whether the Python optimum of `golden` can be compared with `score`: it
+// must cover the same notes and not be beaten, or the objectives differ
+bool comparable_with_python(const GoldenPiece& golden,
+                            double score) noexcept {
+  return golden.python && golden.skipped_notes == 0 &&
+         score >= *golden.python - kTolerance;
+}
+
+std::vector<Row> run_golden_set(const Options& options) {
+  const std::vector<GoldenPiece> pieces = load_pieces();
+  std::vector<Row> rows;
+  for (const Mode mode : kModes) {
+    // Built once per mode so pool start-up is not timed
+    optimizer::Optimizer optimizer(mode_config(mode), options.threads);
+    for (const GoldenPiece& golden : pieces) {
+      const double exact = exact_score(optimizer, golden.piece);
+      std::stop_source stopped;
+      const auto limits = mode_limits(mode, stopped);
+
+      const auto start = std::chrono::steady_clock::now();
+      const auto result = optimizer.optimize_piece(golden.piece, 0, limits);
+      const std::chrono::duration<double> elapsed =
+          std::chrono::steady_clock::now() - start;
+
+      rows.push_back(
+          {golden.name, mode, result.score, exact,
+           golden.python, comparable_with_python(golden, result.score),
+           elapsed.count() * 1000.0,
+           elapsed.count() > 0.0
+               ? static_cast<double>(result.stats.evaluations()) /
+                     elapsed.count()
+               : 0.0});
+    }
+  }
+  return rows;
+}
+
+// Python columns read "-" without a recorded optimum and "n/c" when it is
+// not comparable
+void print_rows(const std::vector<Row>& rows) {
+  std::printf("%-18s %-9s %10s %10s %8s %10s %8s %10s %12s\n", "piece",
+              "mode", "score", "exact", "gap %", "python", "py gap %", "ms",
+              "evals/s");
+  for (const Row& row : rows) {
+    char python[16] = "-";
+    char python_gap[16] = "-";
+    if (row.python) {
+      std::snprintf(python, sizeof(python), "%.1f", *row.python);
+      if (row.comparable) {
+        std::snprintf(python_gap, sizeof(python_gap), "%.2f",
+                      gap_percent(row.score, *row.python));
+      } else {
+        std::snprintf(python_gap, sizeof(python_gap), "n/c");
+      }
+    }
+    std::printf("%-18s %-9s %10.1f %10.1f %8.2f %10s %8s %10.1f %12.0f\n",
+                row.piece.c_str(), mode_name(row.mode), row.score, row.exact,
+                row.gap(), python, python_gap, row.milliseconds,
+                row.evaluations_per_second);
+  }
+}
+
+// Per mode: total time, mean and worst gap and pieces solved exactly, then
+// the mean gap over the pieces comparable with the Python optimum
+void print_summary(const std::vector<Row>& rows) {
+  std::printf("\n%-9s %10s %10s %10s %10s %10s %10s\n", "mode", "total ms",
+              "mean gap %", "max gap %", "optimal", "python", "py gap %");
+  for (const Mode mode : kModes) {
+    double milliseconds = 0.0;
+    double gap_sum = 0.0;
+    double gap_max = 0.0;
+    size_t count = 0;
+    size_t optimal = 0;
+    double python_gap_sum = 0.0;
+    size_t python_count = 0;
+    for (const Row& row : rows) {
+      if (row.mode != mode) {
+        continue;
+      }
+      milliseconds += row.milliseconds;
+      gap_sum += row.gap();
+      gap_max = std::max(gap_max, row.gap());
+      optimal += row.score <= row.exact + kTolerance ? 1 : 0;
+      if (row.comparable) {
+        python_gap_sum += gap_percent(row.score, *row.python);
+        ++python_count;
+      }
+      ++count;
+    }
+    if (count == 0) {
+      continue;
+    }
+    char python_gap[16] = "-";
+    if (python_count > 0) {
+      std::snprintf(python_gap, sizeof(python_gap), "%.2f",
+                    python_gap_sum / static_cast<double>(python_count));
+    }
+    std::printf("%-9s %10.1f %10.2f %10.2f %6zu/%-3zu %6zu/%-3zu %10s\n",
+                mode_name(mode), milliseconds,
+                gap_sum / static_cast<double>(count), gap_max, optimal, count,
+                python_count, count, python_gap);
+  }
+}
+
+void write_json(const std::filesystem::path& path,
+                const std::vector<Row>& rows) {
+  nlohmann::json out = nlohmann::json::array();
+  for (const Row& row : rows) {
+    nlohmann::json python = nullptr;
+    nlohmann::json python_gap = nullptr;
+    if (row.python) {
+      python = *row.python;
+    }
+    if (row.comparable) {
+      python_gap = gap_percent(row.score, *row.python);
+    }
+    out.push_back({{"piece", row.piece},
+                   {"mode", mode_name(row.mode)},
+                   {"score", row.score},
+                   {"exact", row.exact},
+                   {"gap_percent", row.gap()},
+                   {"python_optimal", python},
+                   {"python_gap_percent", python_gap},
+                   {"milliseconds", row.milliseconds},
+                   {"evaluations_per_second", row.evaluations_per_second}});
+  }
+  std::ofstream file(path);
+  if (!file) {
+    throw std::runtime_error("cannot write " + path.string());
+  }
+  file << out.dump(2) << '\n';
+}
+
+int run(int argc, char** argv) {
+  const Options options = parse_options(argc, argv);
+  const std::vector<Row> rows = run_golden_set(options);
+  print_rows(rows);
+  print_summary(rows);
+  if (!options.json.empty()) {
+    write_json(options.json, rows);
+  }
+  int exit_code = 0;
+  for (const Row& row : rows) {
+    if (row.below_exact()) {
+      std::cerr << "FAIL " << row.piece << " (" << mode_name(row.mode)
+                << "): score " << row.score << " is below the exact optimum "
+                << row.exact << '\n';
+      exit_code = 1;
+    }
+  }
+  return exit_code;
+}
+
+}  // namespace
+
+}  // namespace piano_fingering::bench
+
+int main(int argc, char** argv) {
+  try {
+    return piano_fingering::bench::run(argc, argv);
+  } catch (const std::exception& e) {
+    std::cerr << "piano-fingering-optimality: " << e.what() << '\n';
+    return 1;
+  }
+}
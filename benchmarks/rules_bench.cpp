@@ -0,0 +1,197 @@
+// benchmarks/rules_bench.cpp - Individual rule kernels and table lookups
+
+#include <benchmark/benchmark.h>
+
+#include <array>
+#include <cstdint>
+
+#include "config/finger_pair.h"
+#include "config/preset.h"
+#include "config/rule_weights.h"
+#include "domain/finger.h"
+#include "domain/hand.h"
+#include "evaluator/penalty_tables.h"
+#include "evaluator/rules.h"
+
+namespace piano_fingering::evaluator {
+
+namespace {
+
+using domain::Finger;
+
+// Distances sweep through every threshold of the medium preset
+constexpr int kMinDistance = -20;
+constexpr int kMaxDistance = 20;
+constexpr int64_t kDistancesPerIteration = kMaxDistance - kMinDistance + 1;
+
+// One call per finger in the inner loop
+constexpr int64_t kFingersPerIteration = 5;
+
+void BM_ApplyCascadingPenalty(benchmark::State& state) {
+  const auto matrix = config::make_medium_right_hand();
+  const auto& d = matrix.get_pair(finger_pair_from(Finger::kThumb,
+                                                   Finger::kIndex));
+  const auto weights = config::RuleWeights::defaults();
+  for (auto _ : state) {
+    for (int dist = kMinDistance; dist <= kMaxDistance; ++dist) {
+      benchmark::DoNotOptimize(apply_cascading_penalty(d, dist, weights));
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * kDistancesPerIteration);
+}
+BENCHMARK(BM_ApplyCascadingPenalty);
+
+void BM_ApplyChordPenalty(benchmark::State& state) {
+  const auto matrix = config::make_medium_right_hand();
+  const auto& d = matrix.get_pair(finger_pair_from(Finger::kThumb,
+                                                   Finger::kPinky));
+  const auto weights = config::RuleWeights::defaults();
+  for (auto _ : state) {
+    for (int dist = kMinDistance; dist <= kMaxDistance; ++dist) {
+      benchmark::DoNotOptimize(apply_chord_penalty(d, dist, weights));
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * kDistancesPerIteration);
+}
+BENCHMARK(BM_ApplyChordPenalty);
+
+// Same work as BM_ApplyCascadingPenalty through the precomputed table
+void BM_TableDistancePenalty(benchmark::State& state) {
+  const HandPenaltyTable table(config::make_medium_right_hand(),
+                               config::RuleWeights::defaults(),
+                               domain::Hand::kRight);
+  for (auto _ : state) {
+    for (int dist = kMinDistance; dist <= kMaxDistance; ++dist) {
+      benchmark::DoNotOptimize(
+          table.distance_penalty(Finger::kThumb, Finger::kIndex, dist));
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * kDistancesPerIteration);
+}
+BENCHMARK(BM_TableDistancePenalty);
+
+void BM_ApplyRule3(benchmark::State& state) {
+  const auto matrix = config::make_medium_right_hand();
+  const auto& d = matrix.get_pair(finger_pair_from(Finger::kThumb,
+                                                   Finger::kMiddle));
+  for (auto _ : state) {
+    for (int p3 = kMinDistance; p3 <= kMaxDistance; ++p3) {
+      TripletContext triplet{0, 4, p3, Finger::kThumb, Finger::kMiddle,
+                             Finger::kIndex};
+      benchmark::DoNotOptimize(apply_rule_3(d, triplet));
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * kDistancesPerIteration);
+}
+BENCHMARK(BM_ApplyRule3);
+
+void BM_ApplyRule4(benchmark::State& state) {
+  const auto matrix = config::make_medium_right_hand();
+  const auto& d = matrix.get_pair(finger_pair_from(Finger::kThumb,
+                                                   Finger::kRing));
+  for (auto _ : state) {
+    for (int span = kMinDistance; span <= kMaxDistance; ++span) {
+      benchmark::DoNotOptimize(apply_rule_4(d, span));
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * kDistancesPerIteration);
+}
+BENCHMARK(BM_ApplyRule4);
+
+void BM_ApplyRule5(benchmark::State& state) {
+  for (auto _ : state) {
+    for (Finger f : domain::all_fingers()) {
+      benchmark::DoNotOptimize(apply_rule_5(f));
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * kFingersPerIteration);
+}
+BENCHMARK(BM_ApplyRule5);
+
+void BM_ApplyRule6(benchmark::State& state) {
+  for (auto _ : state) {
+    for (Finger f : domain::all_fingers()) {
+      benchmark::DoNotOptimize(apply_rule_6(f, Finger::kRing));
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * kFingersPerIteration);
+}
+BENCHMARK(BM_ApplyRule6);
+
+void BM_ApplyRule7(benchmark::State& state) {
+  for (auto _ : state) {
+    for (Finger f : domain::all_fingers()) {
+      benchmark::DoNotOptimize(apply_rule_7(f, false, Finger::kRing, true));
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * kFingersPerIteration);
+}
+BENCHMARK(BM_ApplyRule7);
+
+void BM_ApplyRule8(benchmark::State& state) {
+  for (auto _ : state) {
+    for (Finger f : domain::all_fingers()) {
+      benchmark::DoNotOptimize(apply_rule_8(f, true, false, false));
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * kFingersPerIteration);
+}
+BENCHMARK(BM_ApplyRule8);
+
+void BM_ApplyRule9(benchmark::State& state) {
+  for (auto _ : state) {
+    for (Finger f : domain::all_fingers()) {
+      benchmark::DoNotOptimize(apply_rule_9(f, true, false));
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * kFingersPerIteration);
+}
+BENCHMARK(BM_ApplyRule9);
+
+void BM_ApplyRule10(benchmark::State& state) {
+  for (auto _ : state) {
+    for (Finger f : domain::all_fingers()) {
+      const bool crossing =
+          is_crossing(Finger::kThumb, 4, f, 2, domain::Hand::kRight);
+      benchmark::DoNotOptimize(apply_rule_10(crossing, false, false));
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * kFingersPerIteration);
+}
+BENCHMARK(BM_ApplyRule10);
+
+void BM_ApplyRule11(benchmark::State& state) {
+  for (auto _ : state) {
+    for (Finger f : domain::all_fingers()) {
+      Rule11Params params{0, true, Finger::kThumb, 4, false, f};
+      benchmark::DoNotOptimize(apply_rule_11(params));
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * kFingersPerIteration);
+}
+BENCHMARK(BM_ApplyRule11);
+
+void BM_ApplyRule12(benchmark::State& state) {
+  for (auto _ : state) {
+    for (Finger f : domain::all_fingers()) {
+      TripletContext triplet{0, 4, 8, f, Finger::kIndex, f};
+      benchmark::DoNotOptimize(apply_rule_12(triplet));
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * kFingersPerIteration);
+}
+BENCHMARK(BM_ApplyRule12);
+
+void BM_ApplyRule15(benchmark::State& state) {
+  for (auto _ : state) {
+    for (Finger f : domain::all_fingers()) {
+      benchmark::DoNotOptimize(apply_rule_15(Finger::kIndex, f, 4, 4));
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * kFingersPerIteration);
+}
+BENCHMARK(BM_ApplyRule15);
+
+}  // namespace
+
+}  // namespace piano_fingering::evaluator
@@ -0,0 +1,107 @@
+// benchmarks/scaling_bench.cpp - Full optimizer on synthetic pieces by size
+//
+// Times Optimizer::optimize_piece() per mode, texture, size and thread
+// count, for the PERF-1.x scaling curve. Each run reports the piece's notes,
+// its score, evaluations per second and the process's peak RSS. Built as
+// its own executable so `make bench` stays quick.
+
+#include <benchmark/benchmark.h>
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <stop_token>
+#include <string>
+#include <vector>
+
+#include "domain/piece.h"
+#include "optimizer/memory_budget.h"
+#include "optimizer/optimizer.h"
+#include "optimizer/thread_pool.h"
+#include "search_mode.h"
+#include "synthetic_piece.h"
+
+namespace piano_fingering::bench {
+
+namespace {
+
+constexpr double kMiB = 1024.0 * 1024.0;
+
+void bm_optimize(benchmark::State& state, Mode mode, Texture texture,
+                 size_t notes, size_t threads) {
+  const domain::Piece piece =
+      make_synthetic_piece({notes, texture, /*seed=*/1});
+  optimizer::Optimizer optimizer(mode_config(mode), threads);
+  std::stop_source stopped;
+  const auto limits = mode_limits(mode, stopped);
+
+  optimizer::Optimizer::PieceResult result;
+  for (auto _ : state) {
+    result = optimizer.optimize_piece(piece, 1, limits);
+    benchmark::DoNotOptimize(result.score);
+  }
+
+  const double wall = std::chrono::duration<double>(result.stats.wall).count();
+  state.counters["notes"] = benchmark::Counter(static_cast<double>(2 * notes));
+  state.counters["score"] = benchmark::Counter(result.score);
+  state.counters["evals_per_s"] = benchmark::Counter(
+      wall > 0.0 ? static_cast<double>(result.stats.evaluations()) / wall
+                 : 0.0);
+  state.counters["peak_rss_mib"] = benchmark::Counter(
+      static_cast<double>(optimizer::peak_rss_bytes()) / kMiB);
+  state.SetItemsProcessed(static_cast<int64_t>(state.iterations()) *
+                          static_cast<int64_t>(2 * notes));
+}
+
+void add(Mode mode, Texture texture, size_t notes, size_t threads) {
+  const std::string name = std::string("Optimize/") + mode_name(mode) + "/" +
+                           std::string(texture_name(texture)) + "/" +
+                           std::to_string(notes) +
+                           "/threads:" + std::to_string(threads);
+  benchmark::RegisterBenchmark(name.c_str(), bm_optimize, mode, texture,
+                               notes, threads)
+      ->Unit(benchmark::kMillisecond)
+      ->UseRealTime()
+      ->Iterations(1);
+}
+
+void register_scaling_benchmarks() {
+  constexpr std::array<size_t, 5> kSizes = {500, 2000, 10000, 30000, 100000};
+  std::vector<size_t> thread_counts = {1};
+  const size_t all = optimizer::ThreadPool::default_thread_count();
+  for (size_t threads = 4; threads < all; threads *= 2) {
+    thread_counts.push_back(threads);
+  }
+  if (all > 1) {
+    thread_counts.push_back(all);
+  }
+
+  // The scaling curve: every mode, size and thread count on mixed textures
+  for (const Mode mode : kModes) {
+    for (const size_t notes : kSizes) {
+      for (const size_t threads : thread_counts) {
+        add(mode, Texture::kMixed, notes, threads);
+      }
+    }
+  }
+  // Each texture alone at the PERF-1.2 size
+  for (const Texture texture : {Texture::kScales, Texture::kArpeggios,
+                                Texture::kChords, Texture::kLeaps}) {
+    add(Mode::kBalanced, texture, 2000, all);
+  }
+}
+
+}  // namespace
+
+}  // namespace piano_fingering::bench
+
+int main(int argc, char** argv) {
+  benchmark::Initialize(&argc, argv);
+  if (benchmark::ReportUnrecognizedArguments(argc, argv)) {
+    return 1;
+  }
+  piano_fingering::bench::register_scaling_benchmarks();
+  benchmark::RunSpecifiedBenchmarks();
+  benchmark::Shutdown();
+  return 0;
+}
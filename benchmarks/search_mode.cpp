@@ -0,0 +1,35 @@
+#include "search_mode.h"
+
+#include "config/config_manager.h"
+
+namespace piano_fingering::bench {
+
+const char* mode_name(Mode mode) noexcept {
+  switch (mode) {
+    case Mode::kFast:
+      return "fast";
+    case Mode::kBalanced:
+      return "balanced";
+    case Mode::kQuality:
+      return "quality";
+  }
+  return "unknown";
+}
+
+config::Config mode_config(Mode mode) {
+  config::Config config = config::ConfigManager::load_preset("Medium");
+  config.algorithm.ils_iterations = mode == Mode::kQuality ? 5000 : 1000;
+  return config;
+}
+
+optimizer::Optimizer::Limits mode_limits(Mode mode,
+                                         std::stop_source& stopped) {
+  optimizer::Optimizer::Limits limits;
+  if (mode == Mode::kFast) {
+    stopped.request_stop();
+    limits.stop_token = stopped.get_token();
+  }
+  return limits;
+}
+
+}  // namespace piano_fingering::bench
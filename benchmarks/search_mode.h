@@ -0,0 +1,33 @@
+// benchmarks/search_mode.h - The SRS optimization modes
+#ifndef PIANO_FINGERING_BENCHMARKS_SEARCH_MODE_H_
+#define PIANO_FINGERING_BENCHMARKS_SEARCH_MODE_H_
+
+#include <array>
+#include <cstdint>
+#include <stop_token>
+
+#include "config/config.h"
+#include "optimizer/optimizer.h"
+
+namespace piano_fingering::bench {
+
+// Not a config field in this tree: fast is the beam search alone, balanced
+// and quality add 1000 and 5000 ILS iterations per trajectory
+enum class Mode : std::uint8_t { kFast, kBalanced, kQuality };
+
+inline constexpr std::array<Mode, 3> kModes = {Mode::kFast, Mode::kBalanced,
+                                               Mode::kQuality};
+
+[[nodiscard]] const char* mode_name(Mode mode) noexcept;
+
+// The Medium preset with the mode's ILS iterations
+[[nodiscard]] config::Config mode_config(Mode mode);
+
+// Fast mode stops through `stopped` before the first ILS iteration, so it
+// must outlive the run
+[[nodiscard]] optimizer::Optimizer::Limits mode_limits(
+    Mode mode, std::stop_source& stopped);
+
+}  // namespace piano_fingering::bench
+
+#endif  // PIANO_FINGERING_BENCHMARKS_SEARCH_MODE_H_
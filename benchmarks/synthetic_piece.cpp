@@ -0,0 +1,248 @@
+#include "synthetic_piece.h"
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <ostream>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "domain/measure.h"
+#include "domain/metadata.h"
+#include "domain/note.h"
+#include "domain/pitch.h"
+#include "domain/slice.h"
+#include "domain/time_signature.h"
+
+namespace piano_fingering::bench {
+
+namespace {
+
+constexpr size_t kSlicesPerMeasure = 16;
+constexpr std::uint32_t kSixteenth = 120;
+
+// White keys of one octave, C to B, as the parser maps them
+constexpr std::array<int, 7> kWhiteKeys = {0, 2, 4, 6, 7, 9, 11};
+constexpr std::array<char, 7> kSteps = {'C', 'D', 'E', 'F', 'G', 'A', 'B'};
+constexpr int kRightHandStaff = 1;
+constexpr int kLeftHandStaff = 2;
+
+// Diatonic degree, counted in white keys from octave 0
+int degree_pitch(int degree) { return kWhiteKeys[degree % 7]; }
+int degree_octave(int degree) { return degree / 7; }
+
+// One hand's voice. Only the raw engine output is used: the standard
+// distributions are not specified bit for bit, so they would make pieces
+// differ by platform.
+class Line {
+ public:
+  Line(std::uint64_t seed, int low_octave)
+      : rng_(seed), low_(low_octave * 7), high_(low_ + 3 * 7 - 1) {}
+
+  // Appends the next slice of `texture` at position `step` of its measure
+  void next(Texture texture, size_t step, std::vector<int>& degrees) {
+    switch (texture) {
+      case Texture::kScales:
+        scale(degrees);
+        break;
+      case Texture::kArpeggios:
+        arpeggio(step, degrees);
+        break;
+      case Texture::kChords:
+        chord(step, degrees);
+        break;
+      case Texture::kLeaps:
+      case Texture::kMixed:
+        leap(degrees);
+        break;
+    }
+  }
+
+ private:
+  size_t below(size_t bound) { return static_cast<size_t>(rng_() % bound); }
+
+  void move_to(int degree) { current_ = std::clamp(degree, low_, high_); }
+
+  void scale(std::vector<int>& degrees) {
+    if (current_ + direction_ > high_ || current_ + direction_ < low_) {
+      direction_ = -direction_;
+    }
+    move_to(current_ + direction_);
+    degrees.push_back(current_);
+  }
+
+  void arpeggio(size_t step, std::vector<int>& degrees) {
+    // Root, third, fifth, octave; a new root from I-IV-V-vi each beat
+    static constexpr std::array<int, 4> kShape = {0, 2, 4, 7};
+    static constexpr std::array<int, 4> kRoots = {0, 3, 4, 5};
+    if (step % 4 == 0) {
+      root_ = low_ + 7 + kRoots[below(kRoots.size())];
+    }
+    move_to(root_ + kShape[step % 4]);
+    degrees.push_back(current_);
+  }
+
+  void chord(size_t step, std::vector<int>& degrees) {
+    // A chord on each beat, a melody note between
+    if (step % 4 != 0) {
+      leap_by(2);
+      degrees.push_back(current_);
+      return;
+    }
+    const int root = low_ + static_cast<int>(below(10));
+    const size_t size = 3 + below(2);
+    static constexpr std::array<int, 4> kVoicing = {0, 2, 4, 7};
+    for (size_t k = 0; k < size; ++k) {
+      degrees.push_back(std::min(root + kVoicing[k], high_));
+    }
+    current_ = root + 4;
+  }
+
+  void leap(std::vector<int>& degrees) {
+    leap_by(11);
+    degrees.push_back(current_);
+  }
+
+  void leap_by(int reach) {
+    const int offset = static_cast<int>(below(2 * reach + 1)) - reach;
+    move_to(current_ + offset);
+  }
+
+  std::mt19937_64 rng_;
+  int low_;
+  int high_;
+  int current_{low_ + 7};
+  int direction_{1};
+  int root_{low_ + 7};
+};
+
+std::vector<domain::Measure> make_hand(const SyntheticOptions& options,
+                                       std::uint64_t seed, int low_octave,
+                                       int staff) {
+  Line line(seed, low_octave);
+  std::vector<domain::Measure> measures;
+  std::vector<domain::Slice> slices;
+  std::vector<domain::Note> notes;
+  std::vector<int> degrees;
+  constexpr std::array<Texture, 4> kCycle = {
+      Texture::kScales, Texture::kArpeggios, Texture::kChords,
+      Texture::kLeaps};
+
+  size_t remaining = options.notes_per_hand;
+  while (remaining > 0) {
+    const size_t measure = measures.size();
+    const Texture texture = options.texture == Texture::kMixed
+                                ? kCycle[measure % kCycle.size()]
+                                : options.texture;
+    for (size_t step = 0; step < kSlicesPerMeasure && remaining > 0; ++step) {
+      degrees.clear();
+      line.next(texture, step, degrees);
+      std::sort(degrees.begin(), degrees.end());
+      degrees.erase(std::unique(degrees.begin(), degrees.end()),
+                    degrees.end());
+      degrees.resize(std::min(degrees.size(), remaining));
+      remaining -= degrees.size();
+      notes.clear();
+      for (const int degree : degrees) {
+        notes.emplace_back(domain::Pitch(degree_pitch(degree)),
+                           degree_octave(degree), kSixteenth, false, staff, 1);
+      }
+      slices.emplace_back(notes);
+    }
+    measures.emplace_back(static_cast<int>(measure + 1), std::move(slices),
+                          domain::TimeSignature(4, 4));
+    slices = {};
+  }
+  return measures;
+}
+
+char step_of(const domain::Note& note) {
+  const auto* key = std::find(kWhiteKeys.begin(), kWhiteKeys.end(),
+                              note.pitch().value());
+  return kSteps[static_cast<size_t>(key - kWhiteKeys.begin())];
+}
+
+// One hand's slices of a measure, returning their total duration
+std::uint32_t write_staff(std::ostream& out, const domain::Measure& measure) {
+  std::uint32_t duration = 0;
+  for (const domain::Slice& slice : measure) {
+    bool first = true;
+    for (const domain::Note& note : slice) {
+      out << "      <note>\n";
+      if (!first) {
+        out << "        <chord/>\n";
+      }
+      out << "        <pitch><step>" << step_of(note) << "</step><octave>"
+          << note.octave() << "</octave></pitch>\n"
+          << "        <duration>" << note.duration() << "</duration>\n"
+          << "        <voice>1</voice>\n"
+          << "        <staff>" << note.staff() << "</staff>\n"
+          << "      </note>\n";
+      first = false;
+    }
+    duration += slice[0].duration();
+  }
+  return duration;
+}
+
+}  // namespace
+
+std::string_view texture_name(Texture texture) noexcept {
+  switch (texture) {
+    case Texture::kScales:
+      return "scales";
+    case Texture::kArpeggios:
+      return "arpeggios";
+    case Texture::kChords:
+      return "chords";
+    case Texture::kLeaps:
+      return "leaps";
+    case Texture::kMixed:
+      return "mixed";
+  }
+  return "unknown";
+}
+
+domain::Piece make_synthetic_piece(const SyntheticOptions& options) {
+  return domain::Piece(
+      domain::Metadata("Synthetic", std::string(texture_name(options.texture))),
+      make_hand(options, options.seed * 2 + 1, 2, kLeftHandStaff),
+      make_hand(options, options.seed * 2, 4, kRightHandStaff));
+}
+
+void write_musicxml(std::ostream& out, const domain::Piece& piece) {
+  out << "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n"
+      << "<score-partwise version=\"4.0\">\n"
+      << "  <work><work-title>" << piece.metadata().title()
+      << "</work-title></work>\n"
+      << "  <part-list><score-part id=\"P1\"><part-name>Piano</part-name>"
+      << "</score-part></part-list>\n"
+      << "  <part id=\"P1\">\n";
+  const auto& right = piece.right_hand();
+  const auto& left = piece.left_hand();
+  for (size_t m = 0; m < std::max(right.size(), left.size()); ++m) {
+    out << "    <measure number=\"" << m + 1 << "\">\n";
+    if (m == 0) {
+      out << "      <attributes><divisions>" << 4 * kSixteenth
+          << "</divisions><time><beats>4</beats><beat-type>4</beat-type>"
+          << "</time><staves>2</staves></attributes>\n";
+    }
+    if (m < right.size()) {
+      const std::uint32_t duration = write_staff(out, right[m]);
+      if (m < left.size()) {
+        out << "      <backup><duration>" << duration
+            << "</duration></backup>\n";
+      }
+    }
+    if (m < left.size()) {
+      write_staff(out, left[m]);
+    }
+    out << "    </measure>\n";
+  }
+  out << "  </part>\n"
+      << "</score-partwise>\n";
+}
+
+}  // namespace piano_fingering::bench
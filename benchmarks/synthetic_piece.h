@@ -0,0 +1,44 @@
+// benchmarks/synthetic_piece.h - Deterministic generated pieces of any size
+#ifndef PIANO_FINGERING_BENCHMARKS_SYNTHETIC_PIECE_H_
+#define PIANO_FINGERING_BENCHMARKS_SYNTHETIC_PIECE_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+#include <string_view>
+
+#include "domain/piece.h"
+
+namespace piano_fingering::bench {
+
+enum class Texture : std::uint8_t {
+  kScales,     // stepwise runs over two octaves
+  kArpeggios,  // broken triads moving through a progression
+  kChords,     // three- and four-note chords under a melody
+  kLeaps,      // random intervals of up to an octave and a fifth
+  kMixed,      // the four above, one measure each in turn
+};
+
+[[nodiscard]] std::string_view texture_name(Texture texture) noexcept;
+
+struct SyntheticOptions {
+  // Notes in each hand, chord notes included; the last chord is cut short
+  // if needed so the count is exact
+  size_t notes_per_hand{2000};
+  Texture texture{Texture::kMixed};
+  std::uint64_t seed{1};
+};
+
+// Both hands of a 4/4 piece in sixteenths, sixteen slices per measure: the
+// right hand in octaves 4-6 and the left in 2-4. The same options give the
+// same piece on every platform.
+[[nodiscard]] domain::Piece make_synthetic_piece(
+    const SyntheticOptions& options);
+
+// `piece` as a two-staff MusicXML score the parser reads back unchanged.
+// Only for generated pieces: every note must be a natural.
+void write_musicxml(std::ostream& out, const domain::Piece& piece);
+
+}  // namespace piano_fingering::bench
+
+#endif  // PIANO_FINGERING_BENCHMARKS_SYNTHETIC_PIECE_H_
@@ -19,6 +19,9 @@ FetchContent_Declare(
 )
 FetchContent_MakeAvailable(pugixml)
 
+# zlib (system) for compressed .mxl input
+find_package(ZLIB REQUIRED)
+
 # nlohmann_json
 FetchContent_Declare(
   nlohmann_json
@@ -26,3 +29,20 @@ FetchContent_Declare(
   GIT_TAG v3.12.0
 )
 FetchContent_MakeAvailable(nlohmann_json)
+
+# Google Benchmark (only for the benchmarks/ target); prefer an installed copy
+if(BUILD_BENCHMARKS)
+  find_package(benchmark QUIET)
+  if(NOT benchmark_FOUND)
+    FetchContent_Declare(
+      benchmark
+      GIT_REPOSITORY https://github.com/google/benchmark.git
+      GIT_TAG v1.8.3
+    )
+    set(BENCHMARK_ENABLE_TESTING OFF CACHE BOOL "" FORCE)
+    set(BENCHMARK_ENABLE_GTEST_TESTS OFF CACHE BOOL "" FORCE)
+    set(BENCHMARK_ENABLE_WERROR OFF CACHE BOOL "" FORCE)
+    set(BENCHMARK_ENABLE_INSTALL OFF CACHE BOOL "" FORCE)
+    FetchContent_MakeAvailable(benchmark)
+  endif()
+endif()
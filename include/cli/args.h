@@ -0,0 +1,58 @@
+#ifndef PIANO_FINGERING_CLI_ARGS_H_
+#define PIANO_FINGERING_CLI_ARGS_H_
+
+#include <cstddef>
+#include <filesystem>
+#include <optional>
+#include <stdexcept>
+#include <string>
+
+#include "optimizer/thread_pool.h"
+
+namespace piano_fingering::cli {
+
+class ArgumentError : public std::runtime_error {
+ public:
+  explicit ArgumentError(const std::string& message)
+      : std::runtime_error(message) {}
+};
+
+struct Arguments {
+  // A score, or with --batch a directory of scores or a manifest file
+  std::filesystem::path input;
+  // Single-score output; empty for the default next to the input
+  std::filesystem::path output;
+  // Where batch outputs go; empty for next to each input
+  std::filesystem::path output_dir;
+  bool batch{false};
+  // JSON-lines server on stdin/stdout instead of an input (see server.h)
+  bool serve{false};
+  // Requests a server handles at once
+  size_t max_requests{4};
+  // Result cache for repeated scores (batch and server); 0 disables it
+  size_t result_cache_mib{64};
+  std::string preset{"Medium"};
+  std::filesystem::path config_path;
+  std::optional<unsigned int> seed;
+  size_t threads{optimizer::ThreadPool::default_thread_count()};
+  // Chrome trace of the run's phases; empty for none. Needs a build with
+  // ENABLE_TRACING
+  std::filesystem::path trace_path;
+  // Print optimizer counters after each score
+  bool stats{false};
+  bool force_overwrite{false};
+  bool quiet{false};
+  bool help{false};
+  bool version{false};
+};
+
+// Options take their value as --name=value or --name value. Throws
+// ArgumentError for unknown options, bad values and missing or extra
+// positional arguments; --help, --version and --serve need no input.
+[[nodiscard]] Arguments parse_arguments(int argc, const char* const* argv);
+
+[[nodiscard]] std::string usage();
+
+}  // namespace piano_fingering::cli
+
+#endif  // PIANO_FINGERING_CLI_ARGS_H_
@@ -0,0 +1,94 @@
+#ifndef PIANO_FINGERING_CLI_BATCH_H_
+#define PIANO_FINGERING_CLI_BATCH_H_
+
+#include <cstddef>
+#include <exception>
+#include <filesystem>
+#include <functional>
+#include <string>
+#include <vector>
+
+#include "config/config.h"
+#include "optimizer/search_stats.h"
+#include "optimizer/thread_pool.h"
+
+namespace piano_fingering::optimizer {
+class Optimizer;
+class ProgressChannel;
+class ResultCache;
+}  // namespace piano_fingering::optimizer
+
+namespace piano_fingering::cli {
+
+struct BatchJob {
+  std::filesystem::path input;
+  std::filesystem::path output;
+};
+
+// <stem>_fingered.musicxml (.mxl input is written uncompressed), in
+// `output_dir` or, when that is empty, next to the input
+[[nodiscard]] std::filesystem::path default_output_path(
+    const std::filesystem::path& input,
+    const std::filesystem::path& output_dir);
+
+// Jobs for every score in `source`, paired with their default outputs:
+// - a directory: each .musicxml, .xml and .mxl file directly inside it,
+//   sorted by name (outputs of an earlier run are skipped)
+// - any other file: a manifest listing one input per line, relative to
+//   the manifest's directory; blank lines and lines starting with '#' are
+//   ignored
+// Throws parser::FileNotFoundError if `source` does not exist.
+[[nodiscard]] std::vector<BatchJob> collect_batch_jobs(
+    const std::filesystem::path& source,
+    const std::filesystem::path& output_dir);
+
+struct BatchOptions {
+  unsigned int seed{0};
+  bool force_overwrite{false};
+  // Optimizer pool size
+  size_t threads{optimizer::ThreadPool::default_thread_count()};
+  // Pieces buffered between stages: parsed ahead, or waiting to be written
+  size_t queue_capacity{2};
+  // Byte limit of the result cache shared by the batch's jobs, so repeated
+  // scores are optimized once; 0 disables it
+  size_t result_cache_bytes{0};
+  // Receives the optimizer's progress events, if set
+  optimizer::ProgressChannel* progress{nullptr};
+};
+
+struct BatchItemResult {
+  BatchJob job;
+  // 0 on success, else the CLI exit code for the error (see cli.md)
+  int exit_code{0};
+  std::string error;
+  double score{0.0};
+  // Both hands' optimizer counters (see --stats)
+  optimizer::SearchStats stats;
+  // Notes the parser skipped (see parser::MusicXMLParser::ParseResult)
+  std::vector<std::string> warnings;
+};
+
+// Parses, optimizes and writes one job on the calling thread, reusing
+// results from `cache` unless it is null. Errors are recorded in the
+// result rather than thrown.
+[[nodiscard]] BatchItemResult run_job(const BatchJob& job,
+                                      optimizer::Optimizer& optimizer,
+                                      optimizer::ResultCache* cache,
+                                      unsigned int seed, bool force_overwrite);
+
+// CLI exit code for an exception thrown while processing a piece
+[[nodiscard]] int exit_code_for(const std::exception_ptr& error) noexcept;
+
+// Parses, optimizes and writes every job as overlapped pipeline stages
+// (see run_pipeline): while one piece is optimized on the shared pool, the
+// next is parsed and the previous one written. A failing job is recorded
+// and the rest carry on. `on_complete` is called on the writer thread as
+// each job finishes, in job order. Results are in job order.
+[[nodiscard]] std::vector<BatchItemResult> run_batch(
+    const std::vector<BatchJob>& jobs, const config::Config& config,
+    const BatchOptions& options,
+    const std::function<void(const BatchItemResult&)>& on_complete);
+
+}  // namespace piano_fingering::cli
+
+#endif  // PIANO_FINGERING_CLI_BATCH_H_
@@ -0,0 +1,82 @@
+#ifndef PIANO_FINGERING_CLI_BOUNDED_QUEUE_H_
+#define PIANO_FINGERING_CLI_BOUNDED_QUEUE_H_
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <mutex>
+#include <optional>
+#include <stdexcept>
+#include <utility>
+
+namespace piano_fingering::cli {
+
+// Blocking FIFO of at most `capacity` items between two pipeline stages.
+// push() waits while the queue is full, so a fast producer cannot run
+// ahead of its consumer by more than the capacity; pop() waits while it is
+// empty. close() ends the stream: pushes fail from then on, and pop()
+// drains what is left before returning nullopt.
+template <class T>
+class BoundedQueue {
+ public:
+  // Throws std::invalid_argument for a zero capacity
+  explicit BoundedQueue(size_t capacity) : capacity_(capacity) {
+    if (capacity == 0) {
+      throw std::invalid_argument("Queue capacity must be > 0");
+    }
+  }
+
+  BoundedQueue(const BoundedQueue&) = delete;
+  BoundedQueue& operator=(const BoundedQueue&) = delete;
+
+  // Returns false, dropping the item, if the queue was closed
+  bool push(T item) {
+    std::unique_lock lock(mutex_);
+    not_full_.wait(lock,
+                   [this] { return closed_ || items_.size() < capacity_; });
+    if (closed_) {
+      return false;
+    }
+    items_.push_back(std::move(item));
+    lock.unlock();
+    not_empty_.notify_one();
+    return true;
+  }
+
+  // nullopt once the queue is closed and empty
+  [[nodiscard]] std::optional<T> pop() {
+    std::unique_lock lock(mutex_);
+    not_empty_.wait(lock, [this] { return closed_ || !items_.empty(); });
+    if (items_.empty()) {
+      return std::nullopt;
+    }
+    T item = std::move(items_.front());
+    items_.pop_front();
+    lock.unlock();
+    not_full_.notify_one();
+    return item;
+  }
+
+  void close() {
+    {
+      std::lock_guard lock(mutex_);
+      closed_ = true;
+    }
+    not_full_.notify_all();
+    not_empty_.notify_all();
+  }
+
+  [[nodiscard]] size_t capacity() const noexcept { return capacity_; }
+
+ private:
+  const size_t capacity_;
+  std::mutex mutex_;
+  std::condition_variable not_full_;
+  std::condition_variable not_empty_;
+  std::deque<T> items_;
+  bool closed_{false};
+};
+
+}  // namespace piano_fingering::cli
+
+#endif  // PIANO_FINGERING_CLI_BOUNDED_QUEUE_H_
@@ -0,0 +1,101 @@
+#ifndef PIANO_FINGERING_CLI_PIPELINE_H_
+#define PIANO_FINGERING_CLI_PIPELINE_H_
+
+#include <cstddef>
+#include <exception>
+#include <optional>
+#include <thread>
+#include <utility>
+
+#include "cli/bounded_queue.h"
+
+namespace piano_fingering::cli {
+
+namespace detail {
+
+template <class T>
+struct PipelineItem {
+  size_t index;
+  std::optional<T> value;
+  std::exception_ptr error;
+};
+
+}  // namespace detail
+
+// Runs items [0, count) through three overlapped stages:
+//
+//   parse(i) -> Parsed          on a dedicated producer thread
+//   optimize(i, Parsed&) -> Optimized   on the calling thread
+//   write(i, Optimized&)        on a dedicated consumer thread
+//
+// Stages are linked by queues of `capacity` items, so while item i is
+// being optimized, item i+1 is parsed and item i-1 written, and memory
+// stays bounded however long the batch. Items keep their order through
+// every stage. An item that throws in any stage skips the stages after it
+// and is reported through fail(i, error) on the write thread, in order
+// with the others; the batch carries on. fail() must not throw.
+template <class Parsed, class Optimized, class Parse, class Optimize,
+          class Write, class Fail>
+void run_pipeline(size_t count, size_t capacity, Parse&& parse,
+                  Optimize&& optimize, Write&& write, Fail&& fail) {
+  BoundedQueue<detail::PipelineItem<Parsed>> parsed(capacity);
+  BoundedQueue<detail::PipelineItem<Optimized>> optimized(capacity);
+
+  std::jthread writer([&] {
+    while (auto item = optimized.pop()) {
+      if (!item->error) {
+        try {
+          write(item->index, *item->value);
+        } catch (...) {
+          item->error = std::current_exception();
+        }
+      }
+      if (item->error) {
+        fail(item->index, item->error);
+      }
+    }
+  });
+  std::jthread reader([&] {
+    for (size_t i = 0; i < count; ++i) {
+      detail::PipelineItem<Parsed> item{i, std::nullopt, nullptr};
+      try {
+        item.value.emplace(parse(i));
+      } catch (...) {
+        item.error = std::current_exception();
+      }
+      if (!parsed.push(std::move(item))) {
+        break;
+      }
+    }
+    parsed.close();
+  });
+  // Declared last, so it unblocks both threads before they are joined,
+  // even if this thread unwinds early
+  struct CloseOnExit {
+    BoundedQueue<detail::PipelineItem<Parsed>>& parsed;
+    BoundedQueue<detail::PipelineItem<Optimized>>& optimized;
+    ~CloseOnExit() {
+      parsed.close();
+      optimized.close();
+    }
+  } close_on_exit{parsed, optimized};
+
+  while (auto item = parsed.pop()) {
+    detail::PipelineItem<Optimized> result{item->index, std::nullopt,
+                                           item->error};
+    if (!result.error) {
+      try {
+        result.value.emplace(optimize(item->index, *item->value));
+      } catch (...) {
+        result.error = std::current_exception();
+      }
+    }
+    // Free the parsed form before blocking on a full queue
+    item.reset();
+    optimized.push(std::move(result));
+  }
+}
+
+}  // namespace piano_fingering::cli
+
+#endif  // PIANO_FINGERING_CLI_PIPELINE_H_
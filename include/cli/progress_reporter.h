@@ -0,0 +1,62 @@
+#ifndef PIANO_FINGERING_CLI_PROGRESS_REPORTER_H_
+#define PIANO_FINGERING_CLI_PROGRESS_REPORTER_H_
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <ostream>
+#include <stop_token>
+#include <string>
+#include <thread>
+
+#include "optimizer/progress.h"
+
+namespace piano_fingering::cli {
+
+// Drains an optimizer ProgressChannel on its own thread and rewrites one
+//
+//   Processing Measure [12 / 40]...
+//
+// line on `out` (FR-6.2). A hand's measure is its share of scheduled ILS
+// iterations done; the line shows the further of the two hands. The first
+// line is printed as soon as an event arrives, later ones at most once per
+// `interval` and only when the text changes. Searches never wait for the
+// terminal: they only publish to the channel.
+class ProgressReporter {
+ public:
+  static constexpr std::chrono::milliseconds kDefaultInterval{250};
+
+  // `channel` and `out` must outlive the reporter
+  ProgressReporter(optimizer::ProgressChannel& channel, std::ostream& out,
+                   std::chrono::milliseconds interval);
+
+  // Drains what is left, prints the final line and ends it with a newline
+  ~ProgressReporter();
+
+  ProgressReporter(const ProgressReporter&) = delete;
+  ProgressReporter& operator=(const ProgressReporter&) = delete;
+
+ private:
+  struct HandProgress {
+    std::uint32_t measures{0};
+    std::uint64_t scheduled{0};
+    std::uint64_t done{0};
+    bool complete{false};
+  };
+
+  void run(const std::stop_token& stop);
+  void drain();
+  [[nodiscard]] std::string line() const;
+
+  optimizer::ProgressChannel* channel_;
+  std::ostream* out_;
+  std::chrono::milliseconds interval_;
+  std::array<HandProgress, 2> hands_{};
+  std::string printed_;
+  // Last, so it stops before the state it reads is destroyed
+  std::jthread thread_;
+};
+
+}  // namespace piano_fingering::cli
+
+#endif  // PIANO_FINGERING_CLI_PROGRESS_REPORTER_H_
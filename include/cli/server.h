@@ -0,0 +1,97 @@
+#ifndef PIANO_FINGERING_CLI_SERVER_H_
+#define PIANO_FINGERING_CLI_SERVER_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <istream>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <string_view>
+
+#include "config/config.h"
+#include "optimizer/optimizer.h"
+#include "optimizer/result_cache.h"
+#include "optimizer/thread_pool.h"
+
+namespace piano_fingering::cli {
+
+// Long-lived JSON-lines server (--serve). Each input line is a request
+//
+//   {"id": 7, "input": "in.musicxml", "output": "out.musicxml",
+//    "preset": "Large", "config": "hand.json", "seed": 1, "force": true}
+//
+// where only "input" is required; the rest default as on the command line.
+// Each request gets one response line, in completion order:
+//
+//   {"id": 7, "ok": true, "output": "out.musicxml", "seed": 1,
+//    "score": 12.5, "warnings": ["Measure 3: skipping note: ..."]}
+//   {"id": 7, "ok": false, "exit_code": 3, "error": "..."}
+//
+// A process pays its startup once: one thread pool serves every request,
+// and an Optimizer (holding the validated config and its derived penalty
+// tables) is built on first use of each distinct configuration and kept,
+// up to kMaxCachedConfigs, least recently used first out. A config file is
+// read on every request, so an edit takes effect at once; the optimizer is
+// keyed by the loaded values, not the path. Hands already optimized with
+// the same notes, config and seed come from a result cache, so a score
+// submitted again costs only its parse and write.
+class Server {
+ public:
+  // Optimizers kept for reuse; each holds its config's penalty tables
+  static constexpr size_t kMaxCachedConfigs = 8;
+
+  // `threads` compute workers are shared by all requests, of which up to
+  // `max_requests` are handled at once. Throws std::invalid_argument if
+  // either is zero.
+  Server(size_t threads, size_t max_requests);
+
+  // With a result cache of `result_cache_bytes` (0 disables it)
+  Server(size_t threads, size_t max_requests, size_t result_cache_bytes);
+
+  Server(const Server&) = delete;
+  Server& operator=(const Server&) = delete;
+
+  // Serves requests from `in` until end of input, then returns once every
+  // response has been written. Blank lines are ignored.
+  void serve(std::istream& in, std::ostream& out);
+
+  // One request line to one response line (without the newline). Never
+  // throws: malformed requests get an error response with exit code 1.
+  // Safe to call from several threads at once.
+  [[nodiscard]] std::string handle(std::string_view request);
+
+  // Distinct configurations currently cached, at most kMaxCachedConfigs
+  [[nodiscard]] size_t cached_configs() const;
+
+  [[nodiscard]] const optimizer::ResultCache& result_cache() const noexcept {
+    return results_;
+  }
+
+ private:
+  struct CachedOptimizer {
+    // config::fingerprint of `config`
+    std::uint64_t key{0};
+    config::Config config;
+    // Shared with the requests using it, so eviction never pulls it from
+    // under one
+    std::shared_ptr<optimizer::Optimizer> optimizer;
+  };
+
+  [[nodiscard]] std::shared_ptr<optimizer::Optimizer> optimizer_for(
+      const std::string& preset, const std::filesystem::path& config_path);
+
+  optimizer::ThreadPool pool_;
+  size_t max_requests_;
+  mutable std::mutex mutex_;
+  // Most recently used first
+  std::list<CachedOptimizer> optimizers_;
+  optimizer::ResultCache results_;
+};
+
+}  // namespace piano_fingering::cli
+
+#endif  // PIANO_FINGERING_CLI_SERVER_H_
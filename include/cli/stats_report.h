@@ -0,0 +1,22 @@
+#ifndef PIANO_FINGERING_CLI_STATS_REPORT_H_
+#define PIANO_FINGERING_CLI_STATS_REPORT_H_
+
+#include <ostream>
+
+#include "optimizer/search_stats.h"
+
+namespace piano_fingering::cli {
+
+// Writes `stats` as a few indented lines for --stats:
+//
+//   evaluations: 1204 full, 3.1M delta, 2.4M/s over 1.30 s
+//   beam: 412 slices, 98% occupancy, 61% of children pruned by bound
+//   ils: 8000 iterations, 37 improvements, 51022 moves
+//   threads: 8 busy 91% of the time (1.19 1.20 ... s)
+//
+// Lines for phases that did not run are left out.
+void write_stats(std::ostream& out, const optimizer::SearchStats& stats);
+
+}  // namespace piano_fingering::cli
+
+#endif  // PIANO_FINGERING_CLI_STATS_REPORT_H_
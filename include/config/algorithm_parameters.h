@@ -9,9 +9,20 @@ struct AlgorithmParameters {
   std::size_t beam_width = 100;
   std::size_t ils_iterations = 1000;
   std::size_t perturbation_strength = 3;
+  // Average beam states per slice, spread by local ambiguity with
+  // beam_width as the per-slice cap; 0 keeps beam_width on every slice
+  std::size_t beam_states_per_slice = 0;
+  // ILS trajectories per hand; fixed so results do not depend on the
+  // thread count
+  std::size_t ils_trajectories = 8;
+  // Beam and exact searches accumulate integer fixed-point costs when the
+  // rule weights allow it exactly (see evaluator::fixed_point_scale()), so
+  // ties compare exactly whatever the summation order
+  bool fixed_point_costs = false;
 
   [[nodiscard]] constexpr bool is_valid() const noexcept {
-    return beam_width > 0 && ils_iterations > 0 && perturbation_strength > 0;
+    return beam_width > 0 && ils_iterations > 0 && perturbation_strength > 0 &&
+           ils_trajectories > 0;
   }
 
   [[nodiscard]] constexpr bool operator==(
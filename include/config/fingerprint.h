@@ -0,0 +1,120 @@
+#ifndef PIANO_FINGERING_CONFIG_FINGERPRINT_H_
+#define PIANO_FINGERING_CONFIG_FINGERPRINT_H_
+
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+#include "config/config.h"
+
+namespace piano_fingering::config {
+
+// Incremental 64-bit hash over integer values: multiply-xor per word and a
+// splitmix64 finalizer. Values are fed as numbers, not object bytes, so a
+// fingerprint is the same on every platform and in every run, and can be
+// computed at compile time.
+class Fingerprinter {
+ public:
+  constexpr void add(std::uint64_t word) noexcept {
+    hash_ = (hash_ ^ word) * 0x9E3779B97F4A7C15ULL;
+    hash_ ^= hash_ >> 32;
+  }
+
+  constexpr void add(double value) noexcept {
+    // Equal weights must hash alike
+    add(std::bit_cast<std::uint64_t>(value == 0.0 ? 0.0 : value));
+  }
+
+  constexpr void add(std::string_view bytes) noexcept {
+    add(static_cast<std::uint64_t>(bytes.size()));
+    std::uint64_t word = 0;
+    for (std::size_t i = 0; i < bytes.size(); ++i) {
+      word |= std::uint64_t{static_cast<unsigned char>(bytes[i])}
+              << (8 * (i % 8));
+      if (i % 8 == 7) {
+        add(word);
+        word = 0;
+      }
+    }
+    add(word);
+  }
+
+  // Size first, so concatenations of different ranges differ
+  template <class Range>
+  constexpr void add_all(const Range& values) noexcept {
+    add(static_cast<std::uint64_t>(values.size()));
+    for (const auto value : values) {
+      add(static_cast<std::uint64_t>(value));
+    }
+  }
+
+  [[nodiscard]] constexpr std::uint64_t finish() const noexcept {
+    std::uint64_t hash = hash_;
+    hash ^= hash >> 30;
+    hash *= 0xBF58476D1CE4E5B9ULL;
+    hash ^= hash >> 27;
+    hash *= 0x94D049BB133111EBULL;
+    return hash ^ (hash >> 31);
+  }
+
+ private:
+  std::uint64_t hash_{0xCBF29CE484222325ULL};
+};
+
+constexpr void add_to(Fingerprinter& hasher,
+                      const DistanceMatrix& matrix) noexcept {
+  for (const auto& pair : matrix.finger_pairs) {
+    for (const int value : {pair.min_prac, pair.min_comf, pair.min_rel,
+                            pair.max_rel, pair.max_comf, pair.max_prac}) {
+      hasher.add(static_cast<std::uint64_t>(static_cast<std::int64_t>(value)));
+    }
+  }
+}
+
+constexpr void add_to(Fingerprinter& hasher,
+                      const RuleWeights& weights) noexcept {
+  for (const double weight : weights.values) {
+    hasher.add(weight);
+  }
+}
+
+constexpr void add_to(Fingerprinter& hasher,
+                      const AlgorithmParameters& algorithm) noexcept {
+  for (const std::size_t value :
+       {algorithm.beam_width, algorithm.ils_iterations,
+        algorithm.perturbation_strength, algorithm.beam_states_per_slice,
+        algorithm.ils_trajectories}) {
+    hasher.add(static_cast<std::uint64_t>(value));
+  }
+  hasher.add(static_cast<std::uint64_t>(algorithm.fixed_point_costs));
+}
+
+// Stable 64-bit identity of a config: equal configs always match, and
+// configs differing in any field almost never do. Use it to find a config
+// that was seen before, confirming with operator== where a collision would
+// matter.
+[[nodiscard]] constexpr std::uint64_t fingerprint(
+    const Config& config) noexcept {
+  Fingerprinter hasher;
+  add_to(hasher, config.left_hand);
+  add_to(hasher, config.right_hand);
+  add_to(hasher, config.weights);
+  add_to(hasher, config.algorithm);
+  return hasher.finish();
+}
+
+// Fingerprint of what the penalty tables derive from: the distance
+// matrices and rule weights, not the search parameters
+[[nodiscard]] constexpr std::uint64_t penalty_fingerprint(
+    const Config& config) noexcept {
+  Fingerprinter hasher;
+  add_to(hasher, config.left_hand);
+  add_to(hasher, config.right_hand);
+  add_to(hasher, config.weights);
+  return hasher.finish();
+}
+
+}  // namespace piano_fingering::config
+
+#endif  // PIANO_FINGERING_CONFIG_FINGERPRINT_H_
@@ -1,7 +1,8 @@
 #ifndef PIANO_FINGERING_CONFIG_PRESET_H_
 #define PIANO_FINGERING_CONFIG_PRESET_H_
 
-#include <string>
+#include <array>
+#include <cstddef>
 #include <string_view>
 
 #include "config/config.h"
@@ -12,28 +13,143 @@ inline constexpr std::string_view kPresetSmall = "Small";
 inline constexpr std::string_view kPresetMedium = "Medium";
 inline constexpr std::string_view kPresetLarge = "Large";
 
+// A literal type: every preset below is constant-initialized data in the
+// binary, with nothing built at startup
 struct Preset {
-  std::string name;
+  std::string_view name;
   DistanceMatrix left_hand{};
   DistanceMatrix right_hand{};
   RuleWeights weights{};
 
-  [[nodiscard]] Config to_config() const {
+  [[nodiscard]] constexpr Config to_config() const noexcept {
     return Config{left_hand, right_hand, weights, AlgorithmParameters{}};
   }
 };
 
-[[nodiscard]] const Preset& get_small_preset();
-[[nodiscard]] const Preset& get_medium_preset();
-[[nodiscard]] const Preset& get_large_preset();
+// Mirror right hand to create left hand by swapping and negating min/max
+[[nodiscard]] constexpr DistanceMatrix mirror_to_left_hand(
+    const DistanceMatrix& right) noexcept {
+  DistanceMatrix left{};
+  for (std::size_t i = 0; i < right.finger_pairs.size(); ++i) {
+    // NOLINTNEXTLINE(cppcoreguidelines-pro-bounds-constant-array-index)
+    const auto& r_pair = right.finger_pairs[i];
+    // NOLINTNEXTLINE(cppcoreguidelines-pro-bounds-constant-array-index)
+    auto& l_pair = left.finger_pairs[i];
 
-// Preset factory functions for right hand matrices
-[[nodiscard]] DistanceMatrix make_small_right_hand();
-[[nodiscard]] DistanceMatrix make_medium_right_hand();
-[[nodiscard]] DistanceMatrix make_large_right_hand();
+    // Min and Max have to be interchanged and multiplied by -1
+    // R(1-2) [-8, 10]  ->  Swap [10, -8]  ->  Negate [-10, 8]
+    l_pair.min_prac = -r_pair.max_prac;
+    l_pair.min_comf = -r_pair.max_comf;
+    l_pair.min_rel = -r_pair.max_rel;
+    l_pair.max_rel = -r_pair.min_rel;
+    l_pair.max_comf = -r_pair.min_comf;
+    l_pair.max_prac = -r_pair.min_prac;
+  }
+  return left;
+}
+
+// From SRS Appendix A.1 - Medium Hand (Default)
+// Note: Left hand distances are mirrored (negated min/max)
+[[nodiscard]] constexpr DistanceMatrix make_medium_right_hand() noexcept {
+  DistanceMatrix m{};
+  m.finger_pairs[0] = {-8, -6, 1, 5, 8, 10};    // 1-2
+  m.finger_pairs[1] = {-7, -5, 3, 9, 12, 14};   // 1-3
+  m.finger_pairs[2] = {-5, -3, 5, 11, 13, 15};  // 1-4
+  m.finger_pairs[3] = {-2, 0, 7, 12, 14, 16};   // 1-5
+  m.finger_pairs[4] = {1, 1, 1, 2, 5, 7};       // 2-3
+  m.finger_pairs[5] = {1, 1, 3, 4, 6, 8};       // 2-4
+  m.finger_pairs[6] = {2, 2, 5, 6, 10, 12};     // 2-5
+  m.finger_pairs[7] = {1, 1, 1, 2, 2, 4};       // 3-4
+  m.finger_pairs[8] = {1, 1, 3, 4, 6, 8};       // 3-5
+  m.finger_pairs[9] = {1, 1, 1, 2, 4, 6};       // 4-5
+  return m;
+}
+
+// Small hand (exact values from spec)
+[[nodiscard]] constexpr DistanceMatrix make_small_right_hand() noexcept {
+  DistanceMatrix m{};
+  m.finger_pairs[0] = {-7, -5, 1, 3, 8, 10};   // 1-2
+  m.finger_pairs[1] = {-6, -4, 3, 6, 10, 12};  // 1-3
+  m.finger_pairs[2] = {-4, -2, 5, 8, 11, 13};  // 1-4
+  m.finger_pairs[3] = {-2, 0, 7, 10, 12, 14};  // 1-5
+  m.finger_pairs[4] = {1, 1, 1, 2, 4, 6};      // 2-3
+  m.finger_pairs[5] = {1, 1, 3, 4, 6, 8};      // 2-4
+  m.finger_pairs[6] = {2, 2, 5, 6, 8, 10};     // 2-5
+  m.finger_pairs[7] = {1, 1, 1, 2, 2, 4};      // 3-4
+  m.finger_pairs[8] = {1, 1, 3, 4, 6, 8};      // 3-5
+  m.finger_pairs[9] = {1, 1, 1, 2, 4, 6};      // 4-5
+  return m;
+}
+
+// Large hand (exact values from spec)
+[[nodiscard]] constexpr DistanceMatrix make_large_right_hand() noexcept {
+  DistanceMatrix m{};
+  m.finger_pairs[0] = {-10, -8, 1, 6, 9, 11};   // 1-2
+  m.finger_pairs[1] = {-8, -6, 3, 9, 13, 15};   // 1-3
+  m.finger_pairs[2] = {-6, -4, 5, 11, 14, 16};  // 1-4
+  m.finger_pairs[3] = {-2, 0, 7, 12, 16, 18};   // 1-5
+  m.finger_pairs[4] = {1, 1, 1, 2, 5, 7};       // 2-3
+  m.finger_pairs[5] = {1, 1, 3, 4, 6, 8};       // 2-4
+  m.finger_pairs[6] = {2, 2, 5, 6, 10, 12};     // 2-5
+  m.finger_pairs[7] = {1, 1, 1, 2, 2, 4};       // 3-4
+  m.finger_pairs[8] = {1, 1, 3, 4, 6, 8};       // 3-5
+  m.finger_pairs[9] = {1, 1, 1, 2, 4, 6};       // 4-5
+  return m;
+}
+
+inline constexpr Preset kSmallPreset{
+    kPresetSmall, mirror_to_left_hand(make_small_right_hand()),
+    make_small_right_hand(), RuleWeights::defaults()};
+inline constexpr Preset kMediumPreset{
+    kPresetMedium, mirror_to_left_hand(make_medium_right_hand()),
+    make_medium_right_hand(), RuleWeights::defaults()};
+inline constexpr Preset kLargePreset{
+    kPresetLarge, mirror_to_left_hand(make_large_right_hand()),
+    make_large_right_hand(), RuleWeights::defaults()};
+
+static_assert(kSmallPreset.to_config().is_valid());
+static_assert(kMediumPreset.to_config().is_valid());
+static_assert(kLargePreset.to_config().is_valid());
 
-// Mirror right hand matrix to left hand
-[[nodiscard]] DistanceMatrix mirror_to_left_hand(const DistanceMatrix& right);
+[[nodiscard]] constexpr const Preset& get_small_preset() noexcept {
+  return kSmallPreset;
+}
+[[nodiscard]] constexpr const Preset& get_medium_preset() noexcept {
+  return kMediumPreset;
+}
+[[nodiscard]] constexpr const Preset& get_large_preset() noexcept {
+  return kLargePreset;
+}
+
+// ASCII case-insensitive equality, without allocating
+[[nodiscard]] constexpr bool equals_ignore_case(std::string_view a,
+                                                std::string_view b) noexcept {
+  if (a.size() != b.size()) {
+    return false;
+  }
+  auto lower = [](char c) {
+    return (c >= 'A' && c <= 'Z') ? static_cast<char>(c - 'A' + 'a') : c;
+  };
+  for (std::size_t i = 0; i < a.size(); ++i) {
+    if (lower(a[i]) != lower(b[i])) {
+      return false;
+    }
+  }
+  return true;
+}
+
+// Preset named `name`, in any case; nullptr if there is none
+[[nodiscard]] constexpr const Preset* find_preset(
+    std::string_view name) noexcept {
+  constexpr std::array<const Preset*, 3> kPresets = {
+      &kSmallPreset, &kMediumPreset, &kLargePreset};
+  for (const Preset* preset : kPresets) {
+    if (equals_ignore_case(name, preset->name)) {
+      return preset;
+    }
+  }
+  return nullptr;
+}
 
 }  // namespace piano_fingering::config
 
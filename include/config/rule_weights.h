@@ -29,6 +29,16 @@ enum class RuleIndex : std::uint8_t {
   kSamePitchDifferentFinger = 14  // Rule 15: Same pitch, different finger
 };
 
+// Bit i set for RuleIndex i
+using RuleMask = std::uint16_t;
+
+inline constexpr RuleMask kAllRules =
+    static_cast<RuleMask>((1U << kRuleCount) - 1U);
+
+[[nodiscard]] constexpr RuleMask rule_bit(RuleIndex index) noexcept {
+  return static_cast<RuleMask>(1U << static_cast<unsigned>(index));
+}
+
 struct RuleWeights {
   std::array<double, kRuleCount> values{};
 
@@ -41,6 +51,17 @@ struct RuleWeights {
                        [](double w) { return w >= 0.0; });
   }
 
+  // Rules with a nonzero weight; a zero weight disables the rule
+  [[nodiscard]] constexpr RuleMask enabled_rules() const noexcept {
+    RuleMask mask = 0;
+    for (std::size_t i = 0; i < kRuleCount; ++i) {
+      if (values[i] != 0.0) {
+        mask = static_cast<RuleMask>(mask | (1U << i));
+      }
+    }
+    return mask;
+  }
+
   [[nodiscard]] static constexpr RuleWeights defaults() noexcept {
     // From SRS Appendix A.2
     return RuleWeights{{
@@ -2,6 +2,7 @@
 #define PIANO_FINGERING_DOMAIN_FINGER_H_
 
 #include <array>
+#include <cstddef>
 #include <cstdint>
 #include <ostream>
 #include <stdexcept>
@@ -27,7 +28,10 @@ enum class Finger : std::uint8_t {
   return static_cast<Finger>(value);
 }
 
-[[nodiscard]] constexpr std::array<Finger, 5> all_fingers() noexcept {
+inline constexpr std::size_t kFingerCount = 5;
+
+[[nodiscard]] constexpr std::array<Finger, kFingerCount>
+all_fingers() noexcept {
   return {Finger::kThumb, Finger::kIndex, Finger::kMiddle, Finger::kRing,
           Finger::kPinky};
 }
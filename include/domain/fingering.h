@@ -2,14 +2,17 @@
 #define PIANO_FINGERING_DOMAIN_FINGERING_H_
 
 #include <algorithm>
+#include <cstddef>
 #include <initializer_list>
+#include <iterator>
 #include <optional>
 #include <ostream>
 #include <stdexcept>
-#include <unordered_set>
+#include <utility>
 #include <vector>
 
 #include "domain/finger.h"
+#include "domain/inline_vector.h"
 #include "domain/slice.h"
 
 namespace piano_fingering::domain {
@@ -18,8 +21,17 @@ class Fingering {
  public:
   Fingering() = default;
 
+  // Throws std::invalid_argument for more than kMaxNotesPerSlice
+  // assignments, as no slice has that many notes
   Fingering(std::initializer_list<std::optional<Finger>> assignments)
-      : assignments_(assignments.begin(), assignments.end()) {}
+      : assignments_(checked(assignments.begin(), assignments.end())) {}
+
+  explicit Fingering(const std::vector<std::optional<Finger>>& assignments)
+      : assignments_(checked(assignments.begin(), assignments.end())) {}
+
+  // From any range of assignments, without an intermediate vector
+  template <std::forward_iterator It>
+  Fingering(It first, It last) : assignments_(checked(first, last)) {}
 
   [[nodiscard]] size_t size() const noexcept { return assignments_.size(); }
   [[nodiscard]] bool empty() const noexcept { return assignments_.empty(); }
@@ -42,14 +54,15 @@ class Fingering {
           "Fingering size must match slice size for constraint check");
     }
 
-    std::unordered_set<int> used_fingers;
+    // One bit per finger; a finger seen twice is a duplicate
+    unsigned used_fingers = 0;
     for (const auto& assignment : assignments_) {
       if (assignment.has_value()) {
-        int finger_val = to_int(assignment.value());
-        if (used_fingers.contains(finger_val)) {
+        const unsigned bit = 1U << to_int(assignment.value());
+        if ((used_fingers & bit) != 0) {
           return true;  // Duplicate finger found
         }
-        used_fingers.insert(finger_val);
+        used_fingers |= bit;
       }
     }
     return false;
@@ -59,7 +72,20 @@ class Fingering {
   [[nodiscard]] auto end() const noexcept { return assignments_.end(); }
 
  private:
-  std::vector<std::optional<Finger>> assignments_;
+  using Assignments = InlineVector<std::optional<Finger>, kMaxNotesPerSlice>;
+
+  template <class It>
+  static Assignments checked(It first, It last) {
+    if (std::distance(first, last) >
+        static_cast<std::ptrdiff_t>(kMaxNotesPerSlice)) {
+      throw std::invalid_argument(
+          "Fingering cannot contain more than 5 assignments");
+    }
+    return Assignments(first, last);
+  }
+
+  // Inline: a fingering never allocates
+  Assignments assignments_;
 };
 
 inline std::ostream& operator<<(std::ostream& os, const Fingering& fingering) {
@@ -0,0 +1,74 @@
+#ifndef PIANO_FINGERING_DOMAIN_INLINE_VECTOR_H_
+#define PIANO_FINGERING_DOMAIN_INLINE_VECTOR_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <memory>
+#include <stdexcept>
+#include <type_traits>
+
+namespace piano_fingering::domain {
+
+// Vector of at most N elements stored inside the object, so creating,
+// copying and destroying one never touches the heap. Limited to trivially
+// copyable element types, which keeps copies a plain memcpy; elements need
+// not be default-constructible.
+template <class T, size_t N>
+class InlineVector {
+  static_assert(std::is_trivially_copyable_v<T> &&
+                std::is_trivially_destructible_v<T>);
+  static_assert(N <= UINT8_MAX);
+
+ public:
+  using value_type = T;
+  using iterator = T*;
+  using const_iterator = const T*;
+
+  InlineVector() noexcept = default;
+
+  // Throws std::length_error for more than N elements
+  template <std::input_iterator It>
+  InlineVector(It first, It last) {
+    for (; first != last; ++first) {
+      push_back(*first);
+    }
+  }
+
+  [[nodiscard]] static constexpr size_t capacity() noexcept { return N; }
+  [[nodiscard]] size_t size() const noexcept { return size_; }
+  [[nodiscard]] bool empty() const noexcept { return size_ == 0; }
+
+  // Throws std::length_error when full
+  void push_back(const T& value) {
+    if (size_ == N) {
+      throw std::length_error("InlineVector capacity exceeded");
+    }
+    std::construct_at(data() + size_, value);
+    ++size_;
+  }
+
+  [[nodiscard]] T& operator[](size_t index) noexcept { return data()[index]; }
+  [[nodiscard]] const T& operator[](size_t index) const noexcept {
+    return data()[index];
+  }
+
+  // Elements are implicit-lifetime, so the byte storage provides them
+  [[nodiscard]] T* data() noexcept { return reinterpret_cast<T*>(storage_); }
+  [[nodiscard]] const T* data() const noexcept {
+    return reinterpret_cast<const T*>(storage_);
+  }
+
+  [[nodiscard]] iterator begin() noexcept { return data(); }
+  [[nodiscard]] iterator end() noexcept { return data() + size_; }
+  [[nodiscard]] const_iterator begin() const noexcept { return data(); }
+  [[nodiscard]] const_iterator end() const noexcept { return data() + size_; }
+
+ private:
+  alignas(T) std::byte storage_[sizeof(T) * N];
+  std::uint8_t size_{0};
+};
+
+}  // namespace piano_fingering::domain
+
+#endif  // PIANO_FINGERING_DOMAIN_INLINE_VECTOR_H_
@@ -9,43 +9,60 @@
 
 namespace piano_fingering::domain {
 
+// Packed into 8 bytes: the duration plus one byte each for the absolute
+// pitch, octave, pitch class and the rest/staff/voice flags. Ordering
+// compares the stored absolute pitch directly.
 class Note {
  public:
   Note(Pitch pitch, int octave, uint32_t duration, bool is_rest, int staff,
        int voice)
-      : pitch_(pitch),
-        octave_(validate_octave(octave)),
-        duration_(validate_duration(duration)),
-        is_rest_(is_rest),
-        staff_(validate_staff(staff)),
-        voice_(validate_voice(voice)) {}
-
-  [[nodiscard]] Pitch pitch() const noexcept { return pitch_; }
+      : duration_(validate_duration(duration)),
+        absolute_(static_cast<uint8_t>(validate_octave(octave) * 14 +
+                                       pitch.value())),
+        octave_(static_cast<uint8_t>(octave)),
+        pitch_(static_cast<uint8_t>(pitch.value())),
+        flags_(pack_flags(is_rest, validate_staff(staff),
+                          validate_voice(voice))) {}
+
+  [[nodiscard]] Pitch pitch() const noexcept { return Pitch(pitch_); }
   [[nodiscard]] int octave() const noexcept { return octave_; }
   [[nodiscard]] uint32_t duration() const noexcept { return duration_; }
-  [[nodiscard]] bool is_rest() const noexcept { return is_rest_; }
-  [[nodiscard]] int staff() const noexcept { return staff_; }
-  [[nodiscard]] int voice() const noexcept { return voice_; }
-
-  [[nodiscard]] int absolute_pitch() const noexcept {
-    return octave_ * 14 + pitch_.value();
+  [[nodiscard]] bool is_rest() const noexcept {
+    return (flags_ & kRestBit) != 0;
+  }
+  [[nodiscard]] int staff() const noexcept {
+    return ((flags_ >> kStaffShift) & 1) + 1;
   }
+  [[nodiscard]] int voice() const noexcept {
+    return ((flags_ >> kVoiceShift) & 3) + 1;
+  }
+
+  [[nodiscard]] int absolute_pitch() const noexcept { return absolute_; }
 
   [[nodiscard]] auto operator<=>(const Note& other) const noexcept {
-    return absolute_pitch() <=> other.absolute_pitch();
+    return absolute_ <=> other.absolute_;
   }
 
   [[nodiscard]] bool operator==(const Note& other) const noexcept {
-    return absolute_pitch() == other.absolute_pitch();
+    return absolute_ == other.absolute_;
   }
 
  private:
-  Pitch pitch_;
-  int octave_;
+  static constexpr uint8_t kRestBit = 1;
+  static constexpr int kStaffShift = 1;
+  static constexpr int kVoiceShift = 2;
+
   uint32_t duration_;
-  bool is_rest_;
-  int staff_;
-  int voice_;
+  uint8_t absolute_;  // octave * 14 + pitch
+  uint8_t octave_;
+  uint8_t pitch_;
+  uint8_t flags_;  // bit 0 rest, bit 1 staff - 1, bits 2-3 voice - 1
+
+  static uint8_t pack_flags(bool is_rest, int staff, int voice) noexcept {
+    return static_cast<uint8_t>((is_rest ? kRestBit : 0) |
+                                ((staff - 1) << kStaffShift) |
+                                ((voice - 1) << kVoiceShift));
+  }
 
   static int validate_octave(int octave) {
     if (octave < 0 || octave > 10) {
@@ -76,6 +93,8 @@ class Note {
   }
 };
 
+static_assert(sizeof(Note) == 8);
+
 inline std::ostream& operator<<(std::ostream& os, const Note& note) {
   return os << "Note(" << note.pitch() << ", oct=" << note.octave()
             << ", dur=" << note.duration() << ", rest=" << note.is_rest()
@@ -0,0 +1,212 @@
+#ifndef PIANO_FINGERING_DOMAIN_PACKED_FINGERING_H_
+#define PIANO_FINGERING_DOMAIN_PACKED_FINGERING_H_
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <ostream>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+#include "domain/finger.h"
+#include "domain/fingering.h"
+#include "domain/slice.h"
+
+namespace piano_fingering::domain {
+
+// Fingering of one slice packed into 16 bits: three bits per note, note k at
+// bits [3k, 3k+3), 0 meaning unassigned. Trivially copyable, so search code
+// can copy it freely without allocating.
+class PackedFingering {
+ public:
+  static constexpr unsigned kBitsPerNote = 3;
+  static constexpr std::uint16_t kNoteMask = 0b111;
+
+  constexpr PackedFingering() noexcept = default;
+
+  explicit PackedFingering(const Fingering& fingering) {
+    if (fingering.size() > kMaxNotesPerSlice) {
+      throw std::invalid_argument(
+          "Fingering cannot contain more than 5 assignments");
+    }
+    size_t index = 0;
+    for (const auto& assignment : fingering) {
+      set(index++, assignment);
+    }
+  }
+
+  [[nodiscard]] static constexpr PackedFingering from_bits(
+      std::uint16_t bits) noexcept {
+    PackedFingering packed;
+    packed.bits_ = bits;
+    return packed;
+  }
+
+  [[nodiscard]] constexpr std::uint16_t bits() const noexcept { return bits_; }
+
+  [[nodiscard]] constexpr std::optional<Finger> operator[](
+      size_t index) const {
+    if (index >= kMaxNotesPerSlice) {
+      throw std::out_of_range("PackedFingering index out of range");
+    }
+    const auto value = static_cast<std::uint8_t>(
+        (bits_ >> (index * kBitsPerNote)) & kNoteMask);
+    if (value == 0) {
+      return std::nullopt;
+    }
+    return static_cast<Finger>(value);
+  }
+
+  constexpr void set(size_t index, std::optional<Finger> finger) {
+    if (index >= kMaxNotesPerSlice) {
+      throw std::out_of_range("PackedFingering index out of range");
+    }
+    const unsigned shift = static_cast<unsigned>(index) * kBitsPerNote;
+    const unsigned value =
+        finger.has_value() ? static_cast<unsigned>(to_int(*finger)) : 0U;
+    const unsigned cleared = bits_ & ~(unsigned{kNoteMask} << shift);
+    bits_ = static_cast<std::uint16_t>(cleared | (value << shift));
+  }
+
+  // Bit f-1 set for every finger f in use
+  [[nodiscard]] constexpr std::uint8_t finger_mask() const noexcept {
+    std::uint8_t mask = 0;
+    for (size_t k = 0; k < kMaxNotesPerSlice; ++k) {
+      const unsigned value = (bits_ >> (k * kBitsPerNote)) & kNoteMask;
+      if (value != 0) {
+        mask |= static_cast<std::uint8_t>(1U << (value - 1));
+      }
+    }
+    return mask;
+  }
+
+  // True if a finger is assigned to more than one note
+  [[nodiscard]] constexpr bool violates_hard_constraint() const noexcept {
+    std::uint8_t mask = 0;
+    for (size_t k = 0; k < kMaxNotesPerSlice; ++k) {
+      const unsigned value = (bits_ >> (k * kBitsPerNote)) & kNoteMask;
+      if (value == 0) {
+        continue;
+      }
+      const auto bit = static_cast<std::uint8_t>(1U << (value - 1));
+      if ((mask & bit) != 0) {
+        return true;
+      }
+      mask |= bit;
+    }
+    return false;
+  }
+
+  // Expands the first `note_count` assignments
+  [[nodiscard]] Fingering unpack(size_t note_count) const {
+    if (note_count > kMaxNotesPerSlice) {
+      throw std::out_of_range("PackedFingering index out of range");
+    }
+    std::array<std::optional<Finger>, kMaxNotesPerSlice> assignments{};
+    for (size_t k = 0; k < note_count; ++k) {
+      assignments[k] = (*this)[k];
+    }
+    return Fingering(assignments.begin(),
+                     assignments.begin() + static_cast<std::ptrdiff_t>(
+                                               note_count));
+  }
+
+  friend constexpr bool operator==(PackedFingering,
+                                   PackedFingering) noexcept = default;
+
+ private:
+  std::uint16_t bits_{0};
+};
+
+// Per-hand fingering sequence in two flat arrays: one packed fingering and
+// one note count per slice. Copying a whole sequence costs two allocations
+// regardless of the number of slices.
+class PackedFingeringSequence {
+ public:
+  PackedFingeringSequence() = default;
+
+  explicit PackedFingeringSequence(const std::vector<Fingering>& fingerings) {
+    reserve(fingerings.size());
+    for (const auto& fingering : fingerings) {
+      push_back(PackedFingering(fingering), fingering.size());
+    }
+  }
+
+  [[nodiscard]] size_t size() const noexcept { return slices_.size(); }
+  [[nodiscard]] bool empty() const noexcept { return slices_.empty(); }
+
+  // Unchecked accessors: callers index within size()
+  [[nodiscard]] PackedFingering operator[](size_t slice) const noexcept {
+    return slices_[slice];
+  }
+  [[nodiscard]] size_t note_count(size_t slice) const noexcept {
+    return note_counts_[slice];
+  }
+
+  void set(size_t slice, PackedFingering fingering) {
+    if (slice >= slices_.size()) {
+      throw std::out_of_range("PackedFingeringSequence index out of range");
+    }
+    slices_[slice] = fingering;
+  }
+
+  void push_back(PackedFingering fingering, size_t note_count) {
+    if (note_count > kMaxNotesPerSlice) {
+      throw std::invalid_argument("Slice cannot contain more than 5 notes");
+    }
+    slices_.push_back(fingering);
+    note_counts_.push_back(static_cast<std::uint8_t>(note_count));
+  }
+
+  void reserve(size_t slice_count) {
+    slices_.reserve(slice_count);
+    note_counts_.reserve(slice_count);
+  }
+
+  [[nodiscard]] bool violates_hard_constraint() const noexcept {
+    for (PackedFingering fingering : slices_) {
+      if (fingering.violates_hard_constraint()) {
+        return true;
+      }
+    }
+    return false;
+  }
+
+  [[nodiscard]] std::vector<Fingering> unpack() const {
+    std::vector<Fingering> fingerings;
+    fingerings.reserve(slices_.size());
+    for (size_t s = 0; s < slices_.size(); ++s) {
+      fingerings.push_back(slices_[s].unpack(note_counts_[s]));
+    }
+    return fingerings;
+  }
+
+  friend bool operator==(const PackedFingeringSequence&,
+                         const PackedFingeringSequence&) = default;
+
+ private:
+  std::vector<PackedFingering> slices_;
+  std::vector<std::uint8_t> note_counts_;
+};
+
+inline std::ostream& operator<<(std::ostream& os, PackedFingering fingering) {
+  os << "PackedFingering([";
+  for (size_t k = 0; k < kMaxNotesPerSlice; ++k) {
+    if (k > 0) {
+      os << ", ";
+    }
+    const auto assignment = fingering[k];
+    if (assignment.has_value()) {
+      os << to_int(*assignment);
+    } else {
+      os << "null";
+    }
+  }
+  return os << "])";
+}
+
+}  // namespace piano_fingering::domain
+
+#endif  // PIANO_FINGERING_DOMAIN_PACKED_FINGERING_H_
@@ -2,11 +2,14 @@
 #define PIANO_FINGERING_DOMAIN_SLICE_H_
 
 #include <algorithm>
+#include <cstddef>
 #include <initializer_list>
+#include <iterator>
 #include <ostream>
 #include <stdexcept>
 #include <vector>
 
+#include "domain/inline_vector.h"
 #include "domain/note.h"
 
 namespace piano_fingering::domain {
@@ -18,17 +21,18 @@ class Slice {
   Slice() = default;
 
   Slice(std::initializer_list<Note> notes)
-      : notes_(notes.begin(), notes.end()) {
-    if (notes_.size() > kMaxNotesPerSlice) {
-      throw std::invalid_argument("Slice cannot contain more than 5 notes");
-    }
+      : notes_(checked(notes.begin(), notes.end())) {
     std::sort(notes_.begin(), notes_.end());
   }
 
-  explicit Slice(std::vector<Note> notes) : notes_(std::move(notes)) {
-    if (notes_.size() > kMaxNotesPerSlice) {
-      throw std::invalid_argument("Slice cannot contain more than 5 notes");
-    }
+  explicit Slice(const std::vector<Note>& notes)
+      : notes_(checked(notes.begin(), notes.end())) {
+    std::sort(notes_.begin(), notes_.end());
+  }
+
+  // From any range of notes, without an intermediate vector
+  template <std::forward_iterator It>
+  Slice(It first, It last) : notes_(checked(first, last)) {
     std::sort(notes_.begin(), notes_.end());
   }
 
@@ -46,7 +50,19 @@ class Slice {
   [[nodiscard]] auto end() const noexcept { return notes_.end(); }
 
  private:
-  std::vector<Note> notes_;
+  using Notes = InlineVector<Note, kMaxNotesPerSlice>;
+
+  template <class It>
+  static Notes checked(It first, It last) {
+    if (std::distance(first, last) >
+        static_cast<std::ptrdiff_t>(kMaxNotesPerSlice)) {
+      throw std::invalid_argument("Slice cannot contain more than 5 notes");
+    }
+    return Notes(first, last);
+  }
+
+  // Inline: a slice never allocates
+  Notes notes_;
 };
 
 inline std::ostream& operator<<(std::ostream& os, const Slice& slice) {
@@ -0,0 +1,24 @@
+#ifndef PIANO_FINGERING_DOMAIN_SOURCE_MAP_H_
+#define PIANO_FINGERING_DOMAIN_SOURCE_MAP_H_
+
+#include <cstdint>
+#include <vector>
+
+namespace piano_fingering::domain {
+
+// Where the notes of a parsed Piece came from: byte offsets of their
+// <note> elements in the score text, one per note of each hand in piece
+// order (measure, slice, then position in the sorted slice, rests
+// included). Lets output splice into the original bytes without a DOM.
+struct SourceMap {
+  std::vector<std::uint32_t> left_hand;
+  std::vector<std::uint32_t> right_hand;
+
+  [[nodiscard]] bool empty() const noexcept {
+    return left_hand.empty() && right_hand.empty();
+  }
+};
+
+}  // namespace piano_fingering::domain
+
+#endif  // PIANO_FINGERING_DOMAIN_SOURCE_MAP_H_
@@ -0,0 +1,97 @@
+#ifndef PIANO_FINGERING_EVALUATOR_EVAL_PIECE_H_
+#define PIANO_FINGERING_EVALUATOR_EVAL_PIECE_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+#include "domain/hand.h"
+#include "domain/piece.h"
+#include "domain/slice.h"
+
+namespace piano_fingering::evaluator {
+
+// Compiled, structure-of-arrays view of one hand of a Piece.
+//
+// Only playable slices (slices holding at least one non-rest note) are kept,
+// in the order fingering vectors index them. Rests are dropped, so note k of
+// playable slice s is the k-th non-rest note of the original slice and lives
+// at flat index slice_begin(s) + k.
+class EvalPiece {
+ public:
+  EvalPiece(const domain::Piece& piece, domain::Hand hand);
+
+  // Empty hand, filled slice by slice with append() (streaming search)
+  explicit EvalPiece(domain::Hand hand);
+
+  // Compiles one more source slice the way the Piece constructor does: a
+  // rest-only slice adds nothing but marks the next playable slice as
+  // following a rest. Returns true if a playable slice was added.
+  bool append(const domain::Slice& slice, size_t measure_index,
+              size_t slice_index);
+
+  // Drops the first `count` playable slices (at most slice_count()),
+  // renumbering the rest from 0
+  void drop_front(size_t count);
+
+  [[nodiscard]] domain::Hand hand() const noexcept { return hand_; }
+
+  [[nodiscard]] size_t slice_count() const noexcept {
+    return slice_offsets_.size() - 1;
+  }
+  [[nodiscard]] size_t note_count() const noexcept { return pitches_.size(); }
+  [[nodiscard]] bool empty() const noexcept { return pitches_.empty(); }
+
+  // Unchecked accessors: callers index within slice_count()/note_count()
+  [[nodiscard]] size_t slice_begin(size_t slice) const noexcept {
+    return slice_offsets_[slice];
+  }
+  [[nodiscard]] size_t slice_size(size_t slice) const noexcept {
+    return slice_offsets_[slice + 1] - slice_offsets_[slice];
+  }
+  [[nodiscard]] int pitch(size_t note) const noexcept {
+    return pitches_[note];
+  }
+  [[nodiscard]] bool is_black(size_t note) const noexcept {
+    return black_keys_[note] != 0;
+  }
+
+  // Position of a playable slice in the source Piece
+  [[nodiscard]] size_t measure_index(size_t slice) const noexcept {
+    return measure_indices_[slice];
+  }
+  [[nodiscard]] size_t slice_index(size_t slice) const noexcept {
+    return slice_indices_[slice];
+  }
+  // True if at least one rest-only slice was dropped right before it
+  [[nodiscard]] bool follows_rest(size_t slice) const noexcept {
+    return follows_rest_[slice] != 0;
+  }
+
+  [[nodiscard]] std::span<const int> pitches() const noexcept {
+    return pitches_;
+  }
+  [[nodiscard]] std::span<const std::uint8_t> black_keys() const noexcept {
+    return black_keys_;
+  }
+  // slice_count() + 1 entries; slice s spans [offsets[s], offsets[s + 1])
+  [[nodiscard]] std::span<const std::uint32_t> slice_offsets() const noexcept {
+    return slice_offsets_;
+  }
+
+ private:
+  domain::Hand hand_;
+  std::vector<int> pitches_;
+  std::vector<std::uint8_t> black_keys_;
+  std::vector<std::uint32_t> slice_offsets_;
+  std::vector<std::uint32_t> measure_indices_;
+  std::vector<std::uint32_t> slice_indices_;
+  std::vector<std::uint8_t> follows_rest_;
+  // A rest-only slice was appended since the last playable one
+  bool after_rest_{false};
+};
+
+}  // namespace piano_fingering::evaluator
+
+#endif  // PIANO_FINGERING_EVALUATOR_EVAL_PIECE_H_
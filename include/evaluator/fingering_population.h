@@ -0,0 +1,68 @@
+#ifndef PIANO_FINGERING_EVALUATOR_FINGERING_POPULATION_H_
+#define PIANO_FINGERING_EVALUATOR_FINGERING_POPULATION_H_
+
+#include <cstddef>
+#include <span>
+#include <stdexcept>
+#include <vector>
+
+#include "domain/packed_fingering.h"
+
+namespace piano_fingering::evaluator {
+
+// Candidate fingerings of one compiled hand, stored position-major: the
+// states of every candidate for one playable slice are contiguous. So
+// ScoreEvaluator::evaluate_population() reads each slice's piece data once
+// for the whole population, and its candidate loops read one array.
+class FingeringPopulation {
+ public:
+  // `size` candidates over `slice_count` playable slices, all unfingered
+  FingeringPopulation(size_t slice_count, size_t size)
+      : slice_count_(slice_count),
+        size_(size),
+        states_(slice_count * size) {}
+
+  [[nodiscard]] size_t slice_count() const noexcept { return slice_count_; }
+  [[nodiscard]] size_t size() const noexcept { return size_; }
+
+  // Copies one whole fingering into slot `candidate`. Throws
+  // std::out_of_range for a slot past size() and std::invalid_argument
+  // unless `fingerings` has slice_count() slices.
+  void assign(size_t candidate,
+              const domain::PackedFingeringSequence& fingerings) {
+    if (candidate >= size_) {
+      throw std::out_of_range("Population candidate out of range");
+    }
+    if (fingerings.size() != slice_count_) {
+      throw std::invalid_argument("Fingerings do not match the population");
+    }
+    for (size_t slice = 0; slice < slice_count_; ++slice) {
+      states_[slice * size_ + candidate] = fingerings[slice];
+    }
+  }
+
+  // Unchecked accessors: callers index within slice_count() and size()
+  [[nodiscard]] domain::PackedFingering at(size_t slice,
+                                           size_t candidate) const noexcept {
+    return states_[slice * size_ + candidate];
+  }
+  void set(size_t slice, size_t candidate,
+           domain::PackedFingering fingering) noexcept {
+    states_[slice * size_ + candidate] = fingering;
+  }
+
+  // Every candidate's state of one slice
+  [[nodiscard]] std::span<const domain::PackedFingering> slice(
+      size_t slice) const noexcept {
+    return {states_.data() + slice * size_, size_};
+  }
+
+ private:
+  size_t slice_count_;
+  size_t size_;
+  std::vector<domain::PackedFingering> states_;
+};
+
+}  // namespace piano_fingering::evaluator
+
+#endif  // PIANO_FINGERING_EVALUATOR_FINGERING_POPULATION_H_
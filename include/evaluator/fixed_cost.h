@@ -0,0 +1,39 @@
+#ifndef PIANO_FINGERING_EVALUATOR_FIXED_COST_H_
+#define PIANO_FINGERING_EVALUATOR_FIXED_COST_H_
+
+#include <cmath>
+#include <cstdint>
+#include <optional>
+
+#include "config/rule_weights.h"
+
+namespace piano_fingering::evaluator {
+
+// A cost in fixed point: an integer count of 1/scale units
+using FixedCost = std::int64_t;
+
+// Largest scale fixed_point_scale() tries
+inline constexpr FixedCost kMaxFixedPointScale = FixedCost{1} << 16;
+
+// Smallest power-of-two scale at which every penalty under `weights` is a
+// whole number of units, or nullopt if none up to kMaxFixedPointScale is.
+// Rules 1, 2 and 13 (and Rule 14 through them) scale their integer
+// distances by the weights; the other rules score whole counts, apart from
+// Rule 8's base of 0.5. Every preset needs a scale of 2.
+[[nodiscard]] std::optional<FixedCost> fixed_point_scale(
+    const config::RuleWeights& weights) noexcept;
+
+// `cost` in units of 1/scale. Exact for any penalty sum when `scale` came
+// from fixed_point_scale() for the weights that produced it.
+[[nodiscard]] inline FixedCost to_fixed(double cost, FixedCost scale) noexcept {
+  return std::llround(cost * static_cast<double>(scale));
+}
+
+[[nodiscard]] inline double from_fixed(FixedCost cost,
+                                       FixedCost scale) noexcept {
+  return static_cast<double>(cost) / static_cast<double>(scale);
+}
+
+}  // namespace piano_fingering::evaluator
+
+#endif  // PIANO_FINGERING_EVALUATOR_FIXED_COST_H_
@@ -0,0 +1,103 @@
+#ifndef PIANO_FINGERING_EVALUATOR_INCREMENTAL_EVALUATION_H_
+#define PIANO_FINGERING_EVALUATOR_INCREMENTAL_EVALUATION_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <vector>
+
+#include "domain/finger.h"
+#include "domain/fingering.h"
+#include "domain/packed_fingering.h"
+#include "evaluator/eval_piece.h"
+#include "evaluator/penalty_tables.h"
+#include "evaluator/score_evaluator.h"
+
+namespace piano_fingering::evaluator {
+
+// Stateful local-search session over one compiled hand.
+//
+// Holds the current assignment as one finger per note plus the running
+// score, so a single-note move is scored, applied and undone by touching only
+// its neighborhood: the chord of the changed slice and at most two
+// sequential notes on either side. The evaluator and piece must outlive the
+// session.
+class IncrementalEvaluation {
+ public:
+  using SliceLocation = ScoreEvaluator::SliceLocation;
+
+  IncrementalEvaluation(const ScoreEvaluator& evaluator, const EvalPiece& piece,
+                        const std::vector<domain::Fingering>& fingerings);
+
+  IncrementalEvaluation(const ScoreEvaluator& evaluator, const EvalPiece& piece,
+                        const domain::PackedFingeringSequence& fingerings);
+
+  // Current score, identical to evaluator.evaluate(piece, fingerings())
+  // up to floating-point rounding
+  [[nodiscard]] double total() const noexcept { return total_; }
+
+  // Number of leading slices carrying a fingering
+  [[nodiscard]] size_t slice_count() const noexcept { return slice_count_; }
+
+  // Throws std::out_of_range for a location outside the session
+  [[nodiscard]] std::optional<domain::Finger> finger(size_t slice,
+                                                     size_t note) const;
+
+  // Score change of assigning `finger` to the note at location (only
+  // fingering_idx and note_idx_in_slice are used). The move stays pending
+  // until it is applied or replaced by another delta(). Throws
+  // std::out_of_range for a location outside the session.
+  [[nodiscard]] double delta(const SliceLocation& location,
+                             domain::Finger finger);
+
+  // Deltas for every replacement finger of one note, without making any of
+  // them pending. Throws std::out_of_range like delta().
+  [[nodiscard]] ScoreEvaluator::FingerDeltas neighborhood(
+      const SliceLocation& location) const;
+
+  // Commits the pending move. Throws std::logic_error if there is none.
+  void apply();
+
+  // Reverts the most recently applied move. Throws std::logic_error if
+  // nothing has been applied.
+  void undo();
+
+  [[nodiscard]] size_t applied_count() const noexcept {
+    return history_.size();
+  }
+
+  // Forgets the undo history, e.g. once a search accepts its current state
+  void clear_history() noexcept { history_.clear(); }
+
+  // Recomputes the running total from scratch, dropping accumulated rounding
+  double refresh();
+
+  [[nodiscard]] std::vector<domain::Fingering> fingerings() const;
+  [[nodiscard]] domain::PackedFingeringSequence packed() const;
+
+ private:
+  struct Move {
+    size_t note;  // flat note index
+    std::uint8_t old_finger;
+    std::uint8_t new_finger;
+    double delta;
+  };
+
+  IncrementalEvaluation(const ScoreEvaluator& evaluator, const EvalPiece& piece,
+                        size_t slice_count);
+
+  void check_location(size_t slice, size_t note) const;
+
+  const EvalPiece* piece_;
+  const PenaltyTables* tables_;
+  size_t slice_count_;
+  double total_{0.0};
+  // One entry per flat note, 0 where the note is unassigned
+  std::vector<std::uint8_t> fingers_;
+  std::optional<Move> pending_;
+  std::vector<Move> history_;
+};
+
+}  // namespace piano_fingering::evaluator
+
+#endif  // PIANO_FINGERING_EVALUATOR_INCREMENTAL_EVALUATION_H_
@@ -0,0 +1,200 @@
+#ifndef PIANO_FINGERING_EVALUATOR_PENALTY_TABLES_H_
+#define PIANO_FINGERING_EVALUATOR_PENALTY_TABLES_H_
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+#include "config/config.h"
+#include "config/distance_matrix.h"
+#include "config/finger_pair_distances.h"
+#include "config/rule_weights.h"
+#include "domain/finger.h"
+#include "domain/hand.h"
+#include "evaluator/rules.h"
+
+namespace piano_fingering::evaluator {
+
+// Distance-dependent rule results for one hand, precomputed for every
+// ordered finger pair (same-finger pairs included) and every distance in
+// [kMinDistanceValue, kMaxDistanceValue]. All thresholds lie inside that
+// range, so the tables cover every breakpoint; rarer, wider distances are
+// computed on the fly with the same rule functions.
+class HandPenaltyTable {
+ public:
+  HandPenaltyTable(const config::DistanceMatrix& distances,
+                   const config::RuleWeights& weights, domain::Hand hand);
+
+  // Rules 1, 2 and 13 between consecutive notes
+  [[nodiscard]] double distance_penalty(domain::Finger f1, domain::Finger f2,
+                                        int distance) const noexcept {
+    if (in_range(distance)) {
+      return sequential_[index(f1, f2, distance)];
+    }
+    return apply_cascading_penalty(pair(f1, f2), distance, weights_);
+  }
+
+  // distance_penalty() split into its Rule 1, 2 and 13 parts. Computed on
+  // the fly; meant for instrumentation, not the hot path.
+  struct DistanceParts {
+    double comfort;    // Rule 1
+    double relaxed;    // Rule 2
+    double practical;  // Rule 13
+  };
+  [[nodiscard]] DistanceParts distance_parts(domain::Finger f1,
+                                             domain::Finger f2,
+                                             int distance) const noexcept;
+
+  // Rule 14 split the same way, Rules 1 and 2 doubled
+  [[nodiscard]] DistanceParts chord_parts(domain::Finger f1, domain::Finger f2,
+                                          int distance) const noexcept;
+
+  // Rule 14: Rules 1, 2 and 13 within a chord
+  [[nodiscard]] double chord_penalty(domain::Finger f1, domain::Finger f2,
+                                     int distance) const noexcept {
+    if (in_range(distance)) {
+      return chord_[index(f1, f2, distance)];
+    }
+    return apply_chord_penalty(pair(f1, f2), distance, weights_);
+  }
+
+  // Rules 6-11 between consecutive notes. Apart from the two fingers and
+  // key colours they only depend on the pitch step and on the colour of the
+  // note before the pair (Rule 8), so the summed result is tabulated over
+  // those. Rules with a zero weight are left out.
+  static constexpr unsigned kStepUp = 0;
+  static constexpr unsigned kStepSame = 1;
+  static constexpr unsigned kStepDown = 2;
+  static constexpr unsigned kNoPrevious = 0;
+  static constexpr unsigned kPreviousWhite = 1;
+  static constexpr unsigned kPreviousBlack = 2;
+
+  // Fingers as to_int() values, colours as 0 (white) or 1 (black)
+  [[nodiscard]] static constexpr std::size_t transition_index(
+      unsigned f1, unsigned black1, unsigned f2, unsigned black2,
+      unsigned step, unsigned previous) noexcept {
+    const unsigned pair = (f1 - 1) * 5 + (f2 - 1);
+    return ((pair * 4 + black1 * 2 + black2) * 3 + step) * 3 + previous;
+  }
+
+  [[nodiscard]] double transition_penalty(std::size_t index) const noexcept {
+    return transition_[index];
+  }
+
+  // Rule 3 with the finger pair of the first two notes
+  [[nodiscard]] double rule_3(const TripletContext& triplet) const noexcept;
+
+  // Rule 3 range checks of a span against the (f1, f2) pair
+  static constexpr std::uint8_t kOutsideComfort = 1U << 0U;
+  static constexpr std::uint8_t kOutsidePractical = 1U << 1U;
+
+  [[nodiscard]] std::uint8_t rule_3_flags(domain::Finger f1,
+                                          domain::Finger f2,
+                                          int span) const noexcept {
+    if (in_range(span)) {
+      return rule_3_flags_[index(f1, f2, span)];
+    }
+    return span_flags(pair(f1, f2), span);
+  }
+
+  // Rule 4 with the finger pair of the outer notes
+  [[nodiscard]] double rule_4(domain::Finger f1, domain::Finger f3,
+                              int span) const noexcept {
+    if (in_range(span)) {
+      return span_[index(f1, f3, span)];
+    }
+    return evaluator::apply_rule_4(pair(f1, f3), span);
+  }
+
+ private:
+  static constexpr int kDistanceSpan =
+      config::kMaxDistanceValue - config::kMinDistanceValue + 1;
+  static constexpr std::size_t kEntries = 25 * kDistanceSpan;
+  static constexpr std::size_t kTransitionEntries = 25 * 4 * 3 * 3;
+
+  [[nodiscard]] static constexpr std::uint8_t span_flags(
+      const config::FingerPairDistances& d, int span) noexcept {
+    std::uint8_t flags = 0;
+    if (span < d.min_comf || span > d.max_comf) {
+      flags |= kOutsideComfort;
+    }
+    if (span < d.min_prac || span > d.max_prac) {
+      flags |= kOutsidePractical;
+    }
+    return flags;
+  }
+
+  [[nodiscard]] static constexpr bool in_range(int distance) noexcept {
+    return distance >= config::kMinDistanceValue &&
+           distance <= config::kMaxDistanceValue;
+  }
+
+  [[nodiscard]] static constexpr std::size_t index(domain::Finger f1,
+                                                   domain::Finger f2,
+                                                   int distance) noexcept {
+    const auto row = static_cast<std::size_t>(
+        (domain::to_int(f1) - 1) * 5 + (domain::to_int(f2) - 1));
+    return row * kDistanceSpan +
+           static_cast<std::size_t>(distance - config::kMinDistanceValue);
+  }
+
+  [[nodiscard]] const config::FingerPairDistances& pair(
+      domain::Finger f1, domain::Finger f2) const noexcept {
+    return distances_.get_pair(finger_pair_from(f1, f2));
+  }
+
+  [[nodiscard]] DistanceParts cascade_parts(domain::Finger f1,
+                                            domain::Finger f2, int distance,
+                                            double multiplier) const noexcept;
+
+  config::DistanceMatrix distances_;
+  config::RuleWeights weights_;
+  std::array<double, kEntries> sequential_{};
+  std::array<double, kEntries> chord_{};
+  std::array<double, kEntries> span_{};
+  std::array<std::uint8_t, kEntries> rule_3_flags_{};
+  std::array<double, kTransitionEntries> transition_{};
+};
+
+// Lookup tables for both hands, derived once from a Config
+class PenaltyTables {
+ public:
+  explicit PenaltyTables(const config::Config& config)
+      : left_(config.left_hand, config.weights, domain::Hand::kLeft),
+        right_(config.right_hand, config.weights, domain::Hand::kRight),
+        enabled_rules_(config.weights.enabled_rules()) {}
+
+  [[nodiscard]] const HandPenaltyTable& for_hand(
+      domain::Hand hand) const noexcept {
+    return (hand == domain::Hand::kLeft) ? left_ : right_;
+  }
+
+  // Rules with a nonzero weight; the evaluator skips the others
+  [[nodiscard]] config::RuleMask enabled_rules() const noexcept {
+    return enabled_rules_;
+  }
+
+ private:
+  HandPenaltyTable left_;
+  HandPenaltyTable right_;
+  config::RuleMask enabled_rules_;
+};
+
+// Tables for `config` from a process-wide cache keyed by
+// config::penalty_fingerprint(), so every evaluator of a config with the
+// same distances and weights shares one copy instead of deriving its own.
+// Hits are confirmed by comparing those fields. The cache keeps at most
+// kMaxSharedPenaltyTables entries and evicts ones no evaluator holds.
+// Thread-safe.
+inline constexpr std::size_t kMaxSharedPenaltyTables = 32;
+
+[[nodiscard]] std::shared_ptr<const PenaltyTables> shared_penalty_tables(
+    const config::Config& config);
+
+// Entries currently in the cache
+[[nodiscard]] std::size_t shared_penalty_table_count();
+
+}  // namespace piano_fingering::evaluator
+
+#endif  // PIANO_FINGERING_EVALUATOR_PENALTY_TABLES_H_
@@ -0,0 +1,69 @@
+#ifndef PIANO_FINGERING_EVALUATOR_RULE_FEATURES_H_
+#define PIANO_FINGERING_EVALUATOR_RULE_FEATURES_H_
+
+#include <array>
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+#include "config/config.h"
+#include "config/rule_weights.h"
+#include "domain/fingering.h"
+#include "domain/packed_fingering.h"
+#include "evaluator/eval_piece.h"
+#include "evaluator/penalty_tables.h"
+
+namespace piano_fingering::evaluator {
+
+// Weight-independent rule quantities of one fingering, so it can be
+// re-scored under any RuleWeights without walking the piece again.
+// score(weights) equals ScoreEvaluator::evaluate() for a config with those
+// weights and the extractor's distances, up to rounding.
+struct RuleFeatures {
+  // Per RuleIndex, the rule's penalty at unit weight: distance excess for
+  // Rules 1, 2 and 13, a count for the others. Only those three scale with
+  // their weight; any other rule is on for a nonzero weight and off for 0.
+  std::array<double, config::kRuleCount> values{};
+  // Rule 14 split into its Rule 1, 2 and 13 excess (the first two already
+  // doubled); Rule 14 only switches the whole term on or off
+  HandPenaltyTable::DistanceParts chord{};
+
+  [[nodiscard]] double value_of(config::RuleIndex rule) const noexcept {
+    return values[static_cast<std::size_t>(rule)];
+  }
+
+  [[nodiscard]] double score(const config::RuleWeights& weights) const noexcept;
+
+  RuleFeatures& operator+=(const RuleFeatures& other) noexcept {
+    for (std::size_t i = 0; i < config::kRuleCount; ++i) {
+      values[i] += other.values[i];
+    }
+    chord.comfort += other.chord.comfort;
+    chord.relaxed += other.chord.relaxed;
+    chord.practical += other.chord.practical;
+    return *this;
+  }
+};
+
+// Extracts RuleFeatures with every rule enabled at unit weight. Only the
+// config's distance matrices matter; its weights are ignored. Immutable and
+// thread-safe like ScoreEvaluator.
+class RuleFeatureExtractor {
+ public:
+  explicit RuleFeatureExtractor(const config::Config& config);
+
+  [[nodiscard]] RuleFeatures extract(
+      const EvalPiece& piece,
+      const std::vector<domain::Fingering>& fingerings) const;
+
+  [[nodiscard]] RuleFeatures extract(
+      const EvalPiece& piece,
+      const domain::PackedFingeringSequence& fingerings) const;
+
+ private:
+  std::shared_ptr<const PenaltyTables> tables_;
+};
+
+}  // namespace piano_fingering::evaluator
+
+#endif  // PIANO_FINGERING_EVALUATOR_RULE_FEATURES_H_
@@ -0,0 +1,56 @@
+#ifndef PIANO_FINGERING_EVALUATOR_RULE_STATS_H_
+#define PIANO_FINGERING_EVALUATOR_RULE_STATS_H_
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <numeric>
+
+#include "config/rule_weights.h"
+
+namespace piano_fingering::evaluator {
+
+// Per-rule breakdown filled by the instrumented ScoreEvaluator overloads.
+// Indexed by config::RuleIndex. For delta evaluation, penalty holds the
+// signed per-rule change and invocations count both the old and new side.
+struct RuleStats {
+  std::array<double, config::kRuleCount> penalty{};
+  std::array<std::uint64_t, config::kRuleCount> invocations{};
+  // Invocations that returned a nonzero penalty
+  std::array<std::uint64_t, config::kRuleCount> triggered{};
+
+  // evaluate_delta() calls answered locally vs by full re-evaluation
+  std::uint64_t delta_local{0};
+  std::uint64_t delta_fallback{0};
+
+  [[nodiscard]] double penalty_of(config::RuleIndex rule) const noexcept {
+    return penalty[static_cast<std::size_t>(rule)];
+  }
+  [[nodiscard]] std::uint64_t invocations_of(
+      config::RuleIndex rule) const noexcept {
+    return invocations[static_cast<std::size_t>(rule)];
+  }
+  [[nodiscard]] std::uint64_t triggered_of(
+      config::RuleIndex rule) const noexcept {
+    return triggered[static_cast<std::size_t>(rule)];
+  }
+
+  [[nodiscard]] double total_penalty() const noexcept {
+    return std::accumulate(penalty.begin(), penalty.end(), 0.0);
+  }
+
+  RuleStats& operator+=(const RuleStats& other) noexcept {
+    for (std::size_t i = 0; i < config::kRuleCount; ++i) {
+      penalty[i] += other.penalty[i];
+      invocations[i] += other.invocations[i];
+      triggered[i] += other.triggered[i];
+    }
+    delta_local += other.delta_local;
+    delta_fallback += other.delta_fallback;
+    return *this;
+  }
+};
+
+}  // namespace piano_fingering::evaluator
+
+#endif  // PIANO_FINGERING_EVALUATOR_RULE_STATS_H_
@@ -38,6 +38,9 @@ struct Rule11Params {
     const config::FingerPairDistances& distances, int actual_distance,
     const config::RuleWeights& weights, double multiplier = 1.0);
 
+// Chord context doubles penalties for Rules 1 and 2 (not Rule 13)
+inline constexpr double kChordMultiplier = 2.0;
+
 [[nodiscard]] double apply_chord_penalty(
     const config::FingerPairDistances& distances, int actual_distance,
     const config::RuleWeights& weights);
@@ -54,6 +57,27 @@ struct Rule11Params {
                                   bool adj_is_black);
 [[nodiscard]] bool is_crossing(domain::Finger f1, int pitch1, domain::Finger f2,
                                int pitch2, domain::Hand hand);
+
+// is_crossing() with the hand fixed at compile time, for the kernels
+template <domain::Hand H>
+[[nodiscard]] constexpr bool is_crossing(domain::Finger f1, int pitch1,
+                                         domain::Finger f2,
+                                         int pitch2) noexcept {
+  const bool f1_is_thumb = (f1 == domain::Finger::kThumb);
+  const bool f2_is_thumb = (f2 == domain::Finger::kThumb);
+  // Must have exactly one thumb
+  if (f1_is_thumb == f2_is_thumb) {
+    return false;
+  }
+
+  const int thumb_pitch = f1_is_thumb ? pitch1 : pitch2;
+  const int other_pitch = f1_is_thumb ? pitch2 : pitch1;
+  if constexpr (H == domain::Hand::kRight) {
+    return thumb_pitch > other_pitch;  // Thumb higher = crossing
+  } else {
+    return thumb_pitch < other_pitch;  // Thumb lower = crossing
+  }
+}
 [[nodiscard]] double apply_rule_10(bool is_crossing, bool note1_black,
                                    bool note2_black);
 [[nodiscard]] double apply_rule_11(const Rule11Params& params);
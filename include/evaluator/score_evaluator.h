@@ -1,16 +1,28 @@
 #ifndef PIANO_FINGERING_EVALUATOR_SCORE_EVALUATOR_H_
 #define PIANO_FINGERING_EVALUATOR_SCORE_EVALUATOR_H_
 
+#include <array>
 #include <memory>
+#include <optional>
 #include <vector>
 
 #include "config/config.h"
+#include "domain/finger.h"
 #include "domain/fingering.h"
 #include "domain/hand.h"
+#include "domain/packed_fingering.h"
 #include "domain/piece.h"
+#include "evaluator/eval_piece.h"
+#include "evaluator/fingering_population.h"
+#include "evaluator/fixed_cost.h"
+#include "evaluator/penalty_tables.h"
+#include "evaluator/rule_stats.h"
 
 namespace piano_fingering::evaluator {
 
+// Immutable after construction: one instance (and its copies, which share
+// the tables) may be used from any number of threads. Mutable search state
+// belongs in a per-thread IncrementalEvaluation.
 class ScoreEvaluator {
  public:
   struct SliceLocation {
@@ -20,16 +32,23 @@ class ScoreEvaluator {
     size_t fingering_idx;
   };
 
-  explicit ScoreEvaluator(const config::Config& config) noexcept;
+  // One slice of a partial assignment, for the decomposed cost terms
+  struct SliceFingering {
+    size_t slice;  // playable slice index in the EvalPiece
+    domain::PackedFingering fingering;
+  };
 
-  ~ScoreEvaluator();  // Needed for unique_ptr<CacheData> with incomplete type
+  // Score change per replacement finger for one note; entry f-1 is for
+  // Finger f. The current finger and fingers already used elsewhere in the
+  // chord are not legal replacements and hold +infinity.
+  using FingerDeltas = std::array<double, domain::kFingerCount>;
 
-  // Copy and move operations
-  ScoreEvaluator(const ScoreEvaluator&) = delete;
-  ScoreEvaluator& operator=(const ScoreEvaluator&) = delete;
-  ScoreEvaluator(ScoreEvaluator&&) noexcept;
-  ScoreEvaluator& operator=(ScoreEvaluator&&) noexcept;
+  // Takes the penalty lookup tables for config from the shared cache,
+  // deriving them on first use (see shared_penalty_tables())
+  explicit ScoreEvaluator(const config::Config& config);
 
+  // Convenience overloads: compile the requested hand on every call.
+  // Hot loops should compile an EvalPiece once and use the overloads below.
   [[nodiscard]] double evaluate(
       const domain::Piece& piece,
       const std::vector<domain::Fingering>& fingerings,
@@ -41,13 +60,102 @@ class ScoreEvaluator {
       const std::vector<domain::Fingering>& proposed_fingerings,
       const SliceLocation& changed_location, domain::Hand hand) const;
 
- private:
-  struct CacheData;  // Forward declaration for implementation detail
+  [[nodiscard]] double evaluate(
+      const EvalPiece& piece,
+      const std::vector<domain::Fingering>& fingerings) const;
+
+  // Packed per-hand sequence; scores exactly like the unpacked fingerings
+  [[nodiscard]] double evaluate(
+      const EvalPiece& piece,
+      const domain::PackedFingeringSequence& fingerings) const;
+
+  // Scores of every candidate of `population`, in slot order; entry c
+  // equals evaluate() of candidate c up to rounding. Scoring a population
+  // of fingerings of one piece at once reads each slice of the piece once
+  // rather than once per candidate. Throws std::invalid_argument unless the
+  // population covers exactly the playable slices of `piece`.
+  [[nodiscard]] std::vector<double> evaluate_population(
+      const EvalPiece& piece, const FingeringPopulation& population) const;
+
+  // Only fingering_idx and note_idx_in_slice of changed_location are used
+  [[nodiscard]] double evaluate_delta(
+      const EvalPiece& piece,
+      const std::vector<domain::Fingering>& current_fingerings,
+      const std::vector<domain::Fingering>& proposed_fingerings,
+      const SliceLocation& changed_location) const;
+
+  [[nodiscard]] const PenaltyTables& tables() const noexcept {
+    return *tables_;
+  }
+
+  // Same evaluator with a private copy of the penalty tables, allocated by
+  // the calling thread instead of taken from the shared cache; built on
+  // each NUMA node, it keeps table reads node-local
+  [[nodiscard]] ScoreEvaluator replicate() const;
+
+  // Scale at which search engines accumulate the local terms below as
+  // FixedCost, set when config.algorithm.fixed_point_costs is on and the
+  // weights allow one; nullopt keeps them in double
+  [[nodiscard]] std::optional<FixedCost> fixed_point_scale() const noexcept {
+    return fixed_point_scale_;
+  }
+
+  // Decomposition of evaluate() into local terms for DP and beam engines.
+  // Sequential rules see the first fingered note of each slice; slices
+  // without one are skipped. evaluate() equals the sum of the intra-slice
+  // terms of every slice, the transition terms of each two consecutive
+  // sequential slices and the triplet terms of each three, up to rounding.
+  // All three throw std::out_of_range for a slice outside the piece.
 
-  const config::Config* config_;
+  // Rules 5 and 14
+  [[nodiscard]] double evaluate_intra_slice(const EvalPiece& piece,
+                                            const SliceFingering& slice) const;
 
-  // Cache for delta evaluation (PIMPL to hide NoteInfo)
-  mutable std::unique_ptr<CacheData> cache_;
+  // Rules 1, 2, 6-11 and 13 between two consecutive sequential slices, with
+  // Rule 8 as if prev were the first note; 0 if either has no fingered note
+  [[nodiscard]] double evaluate_transition(const EvalPiece& piece,
+                                           const SliceFingering& prev,
+                                           const SliceFingering& curr) const;
+
+  // Rules 3, 4, 12 and 15 plus the Rule 8 part that depends on the note
+  // before a transition; 0 if any slice has no fingered note
+  [[nodiscard]] double evaluate_triplet(const EvalPiece& piece,
+                                        const SliceFingering& first,
+                                        const SliceFingering& middle,
+                                        const SliceFingering& last) const;
+
+  // Instrumented variants: same result, and additionally accumulate the
+  // per-rule breakdown into stats. Overload resolution selects a separately
+  // instantiated kernel, so the overloads above carry no instrumentation.
+  [[nodiscard]] double evaluate(
+      const EvalPiece& piece,
+      const std::vector<domain::Fingering>& fingerings,
+      RuleStats& stats) const;
+
+  [[nodiscard]] double evaluate_delta(
+      const EvalPiece& piece,
+      const std::vector<domain::Fingering>& current_fingerings,
+      const std::vector<domain::Fingering>& proposed_fingerings,
+      const SliceLocation& changed_location, RuleStats& stats) const;
+
+  // Batched evaluate_delta() for every replacement finger of one note,
+  // sharing the neighbor loads. Throws std::out_of_range if location does
+  // not name a note of a fingered slice.
+  [[nodiscard]] FingerDeltas evaluate_neighborhood(
+      const EvalPiece& piece,
+      const std::vector<domain::Fingering>& fingerings,
+      const SliceLocation& location) const;
+
+  // One FingerDeltas per note of slices [first_slice, last_slice), in note
+  // order; last_slice is clamped to the fingered slices
+  [[nodiscard]] std::vector<FingerDeltas> evaluate_neighborhood(
+      const EvalPiece& piece,
+      const std::vector<domain::Fingering>& fingerings, size_t first_slice,
+      size_t last_slice) const;
+
+ private:
+  std::shared_ptr<const PenaltyTables> tables_;
+  std::optional<FixedCost> fixed_point_scale_;
 };
 
 }  // namespace piano_fingering::evaluator
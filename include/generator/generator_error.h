@@ -0,0 +1,30 @@
+#ifndef PIANO_FINGERING_GENERATOR_GENERATOR_ERROR_H_
+#define PIANO_FINGERING_GENERATOR_GENERATOR_ERROR_H_
+
+#include <stdexcept>
+#include <string>
+
+namespace piano_fingering::generator {
+
+class GeneratorError : public std::runtime_error {
+ public:
+  explicit GeneratorError(const std::string& message)
+      : std::runtime_error(message) {}
+};
+
+class FileExistsError : public GeneratorError {
+ public:
+  explicit FileExistsError(const std::string& path)
+      : GeneratorError("Output file '" + path +
+                       "' already exists. Use --force to overwrite.") {}
+};
+
+class FileWriteError : public GeneratorError {
+ public:
+  explicit FileWriteError(const std::string& path)
+      : GeneratorError("Cannot write output file '" + path + "'") {}
+};
+
+}  // namespace piano_fingering::generator
+
+#endif  // PIANO_FINGERING_GENERATOR_GENERATOR_ERROR_H_
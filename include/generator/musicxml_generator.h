@@ -0,0 +1,50 @@
+#ifndef PIANO_FINGERING_GENERATOR_MUSICXML_GENERATOR_H_
+#define PIANO_FINGERING_GENERATOR_MUSICXML_GENERATOR_H_
+
+#include <filesystem>
+#include <ostream>
+#include <string_view>
+
+#include "domain/packed_fingering.h"
+#include "domain/piece.h"
+#include "domain/source_map.h"
+#include "generator/generator_error.h"
+
+namespace piano_fingering::generator {
+
+// Writes fingered MusicXML by splicing into the original score text rather
+// than editing and re-serializing a DOM: the bytes are copied through once,
+// and at each fingered note a
+//   <notations><technical><fingering>N</fingering></technical></notations>
+// element is inserted as its last child before any <lyric>, <play> or
+// <listen>, indented like the note's first child. Everything else,
+// formatting included, is preserved byte for byte. Notes that already
+// carry a <fingering> are left as they are, so re-running is idempotent.
+//
+// `score` is the text the parser located `source_map` in (see
+// MusicXMLParser::read_score), and each hand's fingerings index its
+// playable slices as the optimizer returns them.
+class MusicXMLGenerator {
+ public:
+  MusicXMLGenerator() = delete;
+
+  // Throws GeneratorError if the map, fingerings and score do not match
+  static void write(std::ostream& out, std::string_view score,
+                    const domain::Piece& piece,
+                    const domain::SourceMap& source_map,
+                    const domain::PackedFingeringSequence& left_hand,
+                    const domain::PackedFingeringSequence& right_hand);
+
+  // As write(), to a file. Throws FileExistsError if it exists and
+  // force_overwrite is false, FileWriteError if it cannot be written.
+  static void generate(const std::filesystem::path& output_path,
+                       std::string_view score, const domain::Piece& piece,
+                       const domain::SourceMap& source_map,
+                       const domain::PackedFingeringSequence& left_hand,
+                       const domain::PackedFingeringSequence& right_hand,
+                       bool force_overwrite);
+};
+
+}  // namespace piano_fingering::generator
+
+#endif  // PIANO_FINGERING_GENERATOR_MUSICXML_GENERATOR_H_
@@ -0,0 +1,95 @@
+#ifndef PIANO_FINGERING_OPTIMIZER_ASYNC_OPTIMIZE_H_
+#define PIANO_FINGERING_OPTIMIZER_ASYNC_OPTIMIZE_H_
+
+#include <coroutine>
+#include <exception>
+#include <functional>
+#include <utility>
+
+#include "domain/hand.h"
+#include "domain/piece.h"
+#include "optimizer/optimizer.h"
+#include "optimizer/thread_pool.h"
+
+namespace piano_fingering::optimizer {
+
+// Hands a suspended caller back to its event loop, e.g. by queueing
+// handle.resume() there. Called once, from a pool thread; must not throw.
+// Left empty, the caller resumes directly on the pool thread that
+// finished its job.
+using Resumer = std::function<void(std::coroutine_handle<>)>;
+
+// Awaitable that runs one job as a task on a ThreadPool and resumes the
+// awaiting coroutine with its result, or rethrows its exception, once it
+// completes. The job starts when awaited, and the awaiting thread is free
+// while it runs. Neither copyable nor movable: await it where it is made,
+// e.g. `co_await async_optimize(...)`, so the arguments it refers to
+// outlive it.
+template <class T>
+class [[nodiscard]] AsyncJob {
+ public:
+  AsyncJob(ThreadPool& pool, std::function<T()> job, Resumer resume)
+      : pool_(&pool), job_(std::move(job)), resume_(std::move(resume)) {}
+
+  AsyncJob(const AsyncJob&) = delete;
+  AsyncJob& operator=(const AsyncJob&) = delete;
+
+  [[nodiscard]] bool await_ready() const noexcept { return false; }
+
+  void await_suspend(std::coroutine_handle<> caller) {
+    caller_ = caller;
+    pool_->post([this] { run(); });
+  }
+
+  T await_resume() {
+    if (error_) {
+      std::rethrow_exception(error_);
+    }
+    return std::move(result_);
+  }
+
+ private:
+  void run() noexcept {
+    try {
+      result_ = job_();
+    } catch (...) {
+      error_ = std::current_exception();
+    }
+    // The caller may destroy *this as soon as it resumes, so nothing of it
+    // is touched after handing the caller over
+    const std::coroutine_handle<> caller = caller_;
+    Resumer resume = std::move(resume_);
+    if (resume) {
+      resume(caller);
+    } else {
+      caller.resume();
+    }
+  }
+
+  ThreadPool* pool_;
+  std::function<T()> job_;
+  Resumer resume_;
+  std::coroutine_handle<> caller_;
+  T result_{};
+  std::exception_ptr error_;
+};
+
+// Awaitable Optimizer::optimize() for callers on an event loop: the beam
+// and ILS phases run on the optimizer's pool while the caller is suspended.
+// The result equals optimize() with the same arguments. Cancel through
+// limits.stop_token, which makes the caller resume promptly with the best
+// fingering found so far (see Optimizer::Limits; the beam phase still
+// completes). Stream best-so-far fingerings through limits.on_improvement.
+// `optimizer` and `piece` must outlive the await.
+[[nodiscard]] AsyncJob<Optimizer::Result> async_optimize(
+    Optimizer& optimizer, const domain::Piece& piece, domain::Hand hand,
+    unsigned int seed, Optimizer::Limits limits = {}, Resumer resume = {});
+
+// Both hands, as Optimizer::optimize_piece()
+[[nodiscard]] AsyncJob<Optimizer::PieceResult> async_optimize_piece(
+    Optimizer& optimizer, const domain::Piece& piece, unsigned int seed,
+    Optimizer::Limits limits = {}, Resumer resume = {});
+
+}  // namespace piano_fingering::optimizer
+
+#endif  // PIANO_FINGERING_OPTIMIZER_ASYNC_OPTIMIZE_H_
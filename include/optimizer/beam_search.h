@@ -0,0 +1,85 @@
+#ifndef PIANO_FINGERING_OPTIMIZER_BEAM_SEARCH_H_
+#define PIANO_FINGERING_OPTIMIZER_BEAM_SEARCH_H_
+
+#include <cstddef>
+
+#include "evaluator/eval_piece.h"
+#include "evaluator/score_evaluator.h"
+#include "optimizer/memory_budget.h"
+#include "optimizer/search_result.h"
+#include "optimizer/search_stats.h"
+#include "optimizer/thread_pool.h"
+
+namespace piano_fingering::optimizer {
+
+// Phase 1 beam search over the playable slices of one compiled hand,
+// keeping the beam_width most promising partial assignments per slice.
+//
+// Partial assignments are ranked by their cost plus an admissible lower
+// bound on the remaining slices, built from each slice's cheapest
+// intra-slice cost per leading finger and the cheapest boundary terms. The
+// bound also yields a greedy complete assignment up front; children whose
+// optimistic total exceeds its cost are dropped, and it is returned when no
+// beam path is at least as cheap.
+//
+// A beam state is a 16-byte node: its cost, the index of its predecessor
+// and the id of its slice fingering among generate_valid_states(). Nodes of
+// every slice live in one flat arena and the path is rebuilt from
+// backpointers at the end, so a search allocates O(1) buffers regardless of
+// piece length. Ties are broken by predecessor and state id, so results are
+// deterministic. Throws std::invalid_argument for a zero beam_width.
+[[nodiscard]] SearchResult beam_search(
+    const evaluator::ScoreEvaluator& evaluator,
+    const evaluator::EvalPiece& piece, size_t beam_width);
+
+// Same search over the slices of `range` only, as if they were the whole
+// piece. Throws std::out_of_range unless begin <= end <= slice_count().
+[[nodiscard]] SearchResult beam_search(
+    const evaluator::ScoreEvaluator& evaluator,
+    const evaluator::EvalPiece& piece, size_t beam_width, SliceRange range);
+
+// Same search with each slice's expansion split across the pool: every
+// worker expands a contiguous run of parents and keeps its own top
+// beam_width, and the merged survivors are pruned once more. Ties are
+// broken as in the serial search, so the result is bit-identical to it.
+// Small slices are expanded on the calling thread.
+//
+// With a memory budget, the search charges its tables and arena to it for
+// its duration. Any slice too wide for the remaining bytes is narrowed to
+// the widest width that fits. MemoryBudgetError is thrown if the tables, or
+// the arena at width 1, do not fit.
+//
+// With `stats`, each thread adds the children it considered and pruned,
+// the survivors and its busy time to its own slot.
+[[nodiscard]] SearchResult beam_search(
+    const evaluator::ScoreEvaluator& evaluator,
+    const evaluator::EvalPiece& piece, size_t beam_width, ThreadPool& pool,
+    MemoryBudget* memory = nullptr, ThreadStats* stats = nullptr);
+
+// Limits of an adaptive beam: no slice keeps more than max_width nodes and
+// all slices together about total_states (at least one each)
+struct BeamBudget {
+  size_t max_width;
+  size_t total_states;
+};
+
+// Same search with per-slice widths. Each slice gets a share of
+// total_states proportional to its ambiguity: the number of its fingerings
+// that, charged their intra cost, their cheapest entry and the bound on the
+// rest, rank within one average slice cost of its best. Stepwise runs with
+// a clear winner stay narrow while chords and leaps widen. Throws
+// std::invalid_argument for a zero max_width or total_states.
+[[nodiscard]] SearchResult beam_search(
+    const evaluator::ScoreEvaluator& evaluator,
+    const evaluator::EvalPiece& piece, BeamBudget budget);
+
+// Adaptive search with parallel expansion; bit-identical to the serial one.
+// A memory budget and stats are handled as in the fixed-width overload.
+[[nodiscard]] SearchResult beam_search(
+    const evaluator::ScoreEvaluator& evaluator,
+    const evaluator::EvalPiece& piece, BeamBudget budget, ThreadPool& pool,
+    MemoryBudget* memory = nullptr, ThreadStats* stats = nullptr);
+
+}  // namespace piano_fingering::optimizer
+
+#endif  // PIANO_FINGERING_OPTIMIZER_BEAM_SEARCH_H_
@@ -0,0 +1,57 @@
+#ifndef PIANO_FINGERING_OPTIMIZER_EXACT_SEARCH_H_
+#define PIANO_FINGERING_OPTIMIZER_EXACT_SEARCH_H_
+
+#include "domain/packed_fingering.h"
+#include "evaluator/eval_piece.h"
+#include "evaluator/score_evaluator.h"
+#include "optimizer/search_result.h"
+
+namespace piano_fingering::optimizer {
+
+// Provably optimal fully fingered assignment of one compiled hand.
+//
+// Sequential rules see only the leading finger of each slice and reach at
+// most two slices back (the triplet rules 3, 4, 12 and 15), and the
+// slice-local rules 5 and 14 see only the slice itself. The score is
+// therefore a sum of evaluate_intra_slice(), evaluate_transition() and
+// evaluate_triplet() terms, and a Viterbi pass over the 25 pairs of
+// (previous lead, current lead) is exact. Chords add no DP states: each
+// slice contributes, per leading finger, its cheapest chord state with that
+// lead. Runs in O(slices * 125) cost lookups. Ties resolve to the
+// lexicographically smallest lead fingers and states, so results are
+// deterministic.
+[[nodiscard]] SearchResult exact_search(
+    const evaluator::ScoreEvaluator& evaluator,
+    const evaluator::EvalPiece& piece);
+
+// Optimum of the slices of `range` alone, as if they were the whole piece.
+// Throws std::out_of_range unless begin <= end <= slice_count().
+[[nodiscard]] SearchResult exact_search(
+    const evaluator::ScoreEvaluator& evaluator,
+    const evaluator::EvalPiece& piece, SliceRange range);
+
+// Optimum of the slices of `window` with every other slice keeping its
+// state in `fingerings`, one per playable slice. Only the two fixed slices
+// on each side reach into the window, and their terms are counted exactly.
+// Returns the whole sequence, with `cost` the window_cost() of `window`.
+// Throws std::invalid_argument if `fingerings` does not match the piece or
+// leaves the first note of a fixed slice near the window unfingered, and
+// std::out_of_range unless begin <= end <= slice_count().
+[[nodiscard]] SearchResult exact_search(
+    const evaluator::ScoreEvaluator& evaluator,
+    const evaluator::EvalPiece& piece,
+    const domain::PackedFingeringSequence& fingerings, SliceRange window);
+
+// Every term of the score that reads a slice of `window`: its slices'
+// intra-slice costs, the transitions into them and into window.end, and
+// the triplets ending in them or at the next two slices. Two fingerings of
+// a piece that differ only inside `window` differ in score by exactly the
+// difference of their window costs.
+[[nodiscard]] double window_cost(
+    const evaluator::ScoreEvaluator& evaluator,
+    const evaluator::EvalPiece& piece,
+    const domain::PackedFingeringSequence& fingerings, SliceRange window);
+
+}  // namespace piano_fingering::optimizer
+
+#endif  // PIANO_FINGERING_OPTIMIZER_EXACT_SEARCH_H_
@@ -0,0 +1,91 @@
+#ifndef PIANO_FINGERING_OPTIMIZER_ILS_H_
+#define PIANO_FINGERING_OPTIMIZER_ILS_H_
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory_resource>
+#include <optional>
+#include <stop_token>
+
+#include "domain/packed_fingering.h"
+#include "evaluator/eval_piece.h"
+#include "evaluator/score_evaluator.h"
+#include "optimizer/progress.h"
+#include "optimizer/search_result.h"
+#include "optimizer/search_stats.h"
+
+namespace piano_fingering::optimizer {
+
+enum class IlsStrategy : std::uint8_t {
+  // Perturb the best solution at random positions
+  kClassic,
+  // Additionally keep recently perturbed slices and recently reached local
+  // optima tabu: perturbations avoid the former, and revisiting one of the
+  // latter strengthens the next perturbation until a new optimum is found
+  kTabu,
+};
+
+struct IlsOptions {
+  size_t iterations{1000};
+  // Notes reassigned per perturbation
+  size_t perturbation_strength{3};
+  std::uint64_t seed{0};
+  IlsStrategy strategy{IlsStrategy::kTabu};
+  // Iterations a perturbed slice and a reached optimum stay tabu
+  size_t tabu_tenure{16};
+  // Cooperative limits, polled before every iteration: once either fires
+  // the best solution so far is returned
+  std::stop_token stop_token;
+  std::optional<std::chrono::steady_clock::time_point> deadline;
+  // Receives a kLocalSearch event every kIlsProgressInterval iterations
+  // and one for the remainder; never blocks the search
+  ProgressChannel* progress{nullptr};
+  // Receives the trajectory's evaluation, iteration and move counts when
+  // it ends; must belong to the calling thread (see ThreadStats::local())
+  SearchStats* stats{nullptr};
+  // Backs the search's own scratch (worklist, Zobrist keys, tabu memory),
+  // e.g. a worker arena from ScratchScope; the default resource when null.
+  // Only used during the call.
+  std::pmr::memory_resource* scratch{nullptr};
+  // Called on the calling thread with every new best solution and its
+  // running cost, starting with the descent from `initial`. Each call
+  // copies the fingering, so it stays unset unless someone listens.
+  std::function<void(const domain::PackedFingeringSequence&, double)>
+      on_improvement;
+};
+
+inline constexpr size_t kIlsProgressInterval = 256;
+
+struct IlsResult : SearchResult {
+  // Perturbation rounds completed before the iteration limit, a stop
+  // request or the deadline ended the search
+  size_t iterations_performed{0};
+};
+
+// Phase 2 iterated local search from `initial`, which must finger every
+// playable slice (std::invalid_argument otherwise).
+//
+// Local search runs on an IncrementalEvaluation session and only rescans
+// dirty slices: a worklist holds the slices whose +/-2 neighbourhood
+// changed since they were last found locally optimal, so an accepted move
+// requeues five slices instead of restarting the scan. Each note takes its
+// best improving replacement finger. The best cost is tracked from the
+// session's running total, and a worse local optimum is abandoned by
+// undoing the moves made since the best, never by re-evaluating. The
+// result is deterministic for a given seed.
+[[nodiscard]] IlsResult ils_improve(
+    const evaluator::ScoreEvaluator& evaluator,
+    const evaluator::EvalPiece& piece,
+    const domain::PackedFingeringSequence& initial,
+    const IlsOptions& options = {});
+
+// Approximate bytes one ils_improve() call holds for `piece`: its session,
+// worklist, hash keys, tabu memory and an undo stack of one move per slice
+[[nodiscard]] size_t ils_session_bytes(
+    const evaluator::EvalPiece& piece) noexcept;
+
+}  // namespace piano_fingering::optimizer
+
+#endif  // PIANO_FINGERING_OPTIMIZER_ILS_H_
@@ -0,0 +1,45 @@
+#ifndef PIANO_FINGERING_OPTIMIZER_INCREMENTAL_H_
+#define PIANO_FINGERING_OPTIMIZER_INCREMENTAL_H_
+
+#include <cstddef>
+
+#include "domain/packed_fingering.h"
+#include "evaluator/eval_piece.h"
+#include "evaluator/score_evaluator.h"
+#include "optimizer/search_result.h"
+
+namespace piano_fingering::optimizer {
+
+// Slices on each side of an edit re-solved along with it, so the
+// fingering can bend towards the edit rather than only meet it
+inline constexpr size_t kDefaultEditMargin = 8;
+
+// Playable slices two versions of a hand share at their start and end.
+// Slices match when they hold the same pitches and agree on
+// follows_rest(). prefix + suffix never exceeds either slice count.
+struct SliceDiff {
+  size_t prefix{0};
+  size_t suffix{0};
+};
+
+[[nodiscard]] SliceDiff diff_slices(const evaluator::EvalPiece& previous,
+                                    const evaluator::EvalPiece& edited);
+
+// Fingers `edited` after an edit of `previous`, whose fingerings scored
+// `previous_cost`. The slices that differ, plus `margin` on each side, are
+// re-solved with exact_search() against the unchanged fingerings around
+// them; every other slice keeps its previous state. The cost is
+// previous_cost corrected by the window_cost() of the edit in each
+// version, so the search and the rescoring scale with the edit rather than
+// the piece. Throws std::invalid_argument if `previous_fingerings` does not
+// match `previous`.
+[[nodiscard]] SearchResult refinger(
+    const evaluator::ScoreEvaluator& evaluator,
+    const evaluator::EvalPiece& previous,
+    const domain::PackedFingeringSequence& previous_fingerings,
+    double previous_cost, const evaluator::EvalPiece& edited,
+    size_t margin = kDefaultEditMargin);
+
+}  // namespace piano_fingering::optimizer
+
+#endif  // PIANO_FINGERING_OPTIMIZER_INCREMENTAL_H_
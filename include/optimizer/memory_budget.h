@@ -0,0 +1,106 @@
+#ifndef PIANO_FINGERING_OPTIMIZER_MEMORY_BUDGET_H_
+#define PIANO_FINGERING_OPTIMIZER_MEMORY_BUDGET_H_
+
+#include <atomic>
+#include <cstddef>
+#include <stdexcept>
+#include <string>
+#include <utility>
+
+namespace piano_fingering::optimizer {
+
+// Thrown when a search cannot run within its memory budget even at its
+// smallest setting
+class MemoryBudgetError : public std::runtime_error {
+ public:
+  explicit MemoryBudgetError(const std::string& message)
+      : std::runtime_error(message) {}
+};
+
+// Byte accounting shared by every search charged against it, e.g. all jobs
+// of one batch worker. The optimizer charges its large buffers (beam arena
+// and tables, per-trajectory ILS sessions) before allocating them and
+// degrades or throws MemoryBudgetError when they would not fit. Small and
+// transient allocations are not tracked. Thread-safe.
+class MemoryBudget {
+ public:
+  // A zero limit admits nothing
+  explicit MemoryBudget(size_t limit_bytes) noexcept : limit_(limit_bytes) {}
+
+  MemoryBudget(const MemoryBudget&) = delete;
+  MemoryBudget& operator=(const MemoryBudget&) = delete;
+
+  [[nodiscard]] size_t limit() const noexcept { return limit_; }
+  [[nodiscard]] size_t current() const noexcept {
+    return current_.load(std::memory_order_relaxed);
+  }
+  // Highest current() so far
+  [[nodiscard]] size_t peak() const noexcept {
+    return peak_.load(std::memory_order_relaxed);
+  }
+  [[nodiscard]] size_t available() const noexcept {
+    const size_t used = current();
+    return used < limit_ ? limit_ - used : 0;
+  }
+
+  // Adds `bytes` if the total stays within the limit
+  [[nodiscard]] bool try_charge(size_t bytes) noexcept;
+
+  // Requires bytes <= current()
+  void release(size_t bytes) noexcept;
+
+ private:
+  size_t limit_;
+  std::atomic<size_t> current_{0};
+  std::atomic<size_t> peak_{0};
+};
+
+// Move-only grant of bytes from a budget, returned on destruction. A null
+// budget grants anything, so unbudgeted callers share the same code path.
+class MemoryCharge {
+ public:
+  MemoryCharge() noexcept = default;
+
+  // Throws MemoryBudgetError, naming `what`, if the bytes do not fit
+  MemoryCharge(MemoryBudget* budget, size_t bytes, const char* what);
+
+  MemoryCharge(MemoryCharge&& other) noexcept
+      : budget_(std::exchange(other.budget_, nullptr)),
+        bytes_(std::exchange(other.bytes_, 0)) {}
+
+  MemoryCharge& operator=(MemoryCharge&& other) noexcept {
+    if (this != &other) {
+      reset();
+      budget_ = std::exchange(other.budget_, nullptr);
+      bytes_ = std::exchange(other.bytes_, 0);
+    }
+    return *this;
+  }
+
+  MemoryCharge(const MemoryCharge&) = delete;
+  MemoryCharge& operator=(const MemoryCharge&) = delete;
+
+  ~MemoryCharge() { reset(); }
+
+  [[nodiscard]] size_t bytes() const noexcept { return bytes_; }
+
+  void reset() noexcept {
+    if (budget_ != nullptr) {
+      std::exchange(budget_, nullptr)->release(std::exchange(bytes_, 0));
+    }
+  }
+
+ private:
+  MemoryBudget* budget_{nullptr};
+  size_t bytes_{0};
+};
+
+// Resident set size of this process, or 0 where it cannot be read
+[[nodiscard]] size_t current_rss_bytes() noexcept;
+
+// Peak resident set size of this process, or 0 where it cannot be read
+[[nodiscard]] size_t peak_rss_bytes() noexcept;
+
+}  // namespace piano_fingering::optimizer
+
+#endif  // PIANO_FINGERING_OPTIMIZER_MEMORY_BUDGET_H_
@@ -0,0 +1,184 @@
+#ifndef PIANO_FINGERING_OPTIMIZER_OPTIMIZER_H_
+#define PIANO_FINGERING_OPTIMIZER_OPTIMIZER_H_
+
+#include <chrono>
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <optional>
+#include <stop_token>
+#include <vector>
+
+#include "config/config.h"
+#include "domain/hand.h"
+#include "domain/packed_fingering.h"
+#include "domain/piece.h"
+#include "evaluator/eval_piece.h"
+#include "evaluator/score_evaluator.h"
+#include "optimizer/incremental.h"
+#include "optimizer/memory_budget.h"
+#include "optimizer/progress.h"
+#include "optimizer/result_cache.h"
+#include "optimizer/search_stats.h"
+#include "optimizer/thread_pool.h"
+#include "optimizer/worker_placement.h"
+
+namespace piano_fingering::optimizer {
+
+// Two-phase optimizer for one hand: a parallel beam search seeds a fixed
+// schedule of config.algorithm.ils_trajectories ILS trajectories, run
+// across the pool, and the best trajectory wins. Neither phase depends on
+// the thread count, so a seed gives bit-identical results on any machine.
+class Optimizer {
+ public:
+  using Clock = std::chrono::steady_clock;
+
+  struct Result {
+    domain::PackedFingeringSequence fingerings;
+    double score{0.0};
+    // ILS iterations summed over all trajectories
+    size_t iterations_performed{0};
+    // Evaluation, beam and ILS counters and per-thread busy time
+    SearchStats stats;
+  };
+
+  // Both hands of one piece. The hands are scored independently, so the
+  // piece's score is the sum of theirs.
+  struct PieceResult {
+    Result right_hand;
+    Result left_hand;
+    double score{0.0};
+    size_t iterations_performed{0};
+    // Both hands' counters; wall is that of the piece
+    SearchStats stats;
+  };
+
+  // Wall-clock and cooperative stop conditions. ILS trajectories poll both
+  // before every iteration, so either takes effect within one iteration
+  // (well under a millisecond on typical pieces); the beam phase always
+  // completes. When either fires, optimize() returns the best fingering
+  // found so far.
+  //
+  // A memory budget, possibly shared with other optimizers, caps the beam
+  // arena and the ILS sessions. The beam narrows to fit, and fewer
+  // trajectories run at a time, without changing the result. If even a
+  // width-1 beam or a single session does not fit, optimize() throws
+  // MemoryBudgetError. A narrowed beam can change the result.
+  //
+  // A result cache, also shareable, returns a hand already optimized with
+  // the same notes, config and seed without searching. Any hit may be
+  // returned, but only runs with no other limit set are stored, since a
+  // limit can cut a search short.
+  //
+  // Progress events for each hand (start, ILS iterations, completion) go
+  // to a progress channel without blocking; see progress.h.
+  //
+  // on_improvement streams each hand's best fingering so far: the beam
+  // result, then every ILS solution that beats all earlier reports for
+  // that hand. It is called on the searching threads, one call per hand at
+  // a time, so it should only copy or hand the fingering off. It adds one
+  // copy per reported improvement and does not change the result.
+  using ImprovementHandler = std::function<void(
+      domain::Hand hand, const domain::PackedFingeringSequence& fingerings,
+      double score)>;
+
+  struct Limits {
+    std::optional<Clock::time_point> deadline;
+    std::stop_token stop_token;
+    MemoryBudget* memory{nullptr};
+    ResultCache* cache{nullptr};
+    ProgressChannel* progress{nullptr};
+    ImprovementHandler on_improvement;
+  };
+
+  // Throws config::ConfigurationError for an invalid config and
+  // std::invalid_argument for zero threads
+  explicit Optimizer(const config::Config& config,
+                     size_t thread_count = ThreadPool::default_thread_count());
+
+  // Owns a pool placed as `placement` asks (see WorkerPlacement)
+  Optimizer(const config::Config& config, size_t thread_count,
+            const WorkerPlacement& placement);
+
+  // Runs on `pool`, which must outlive the optimizer, so optimizers for
+  // several configs can share one set of workers. optimize() and
+  // optimize_piece() may be called from several threads at once.
+  //
+  // If the pool's placement asks for replicas and its workers span more
+  // than one node, every node gets its own copy of the penalty tables,
+  // and each optimize() its own copy of the compiled hand for the ILS
+  // phase, both built on that node. Trajectories read the copy of the node
+  // they run on and, on a pool with arenas, take their scratch from the
+  // worker's. Either changes where memory lives but not the result.
+  Optimizer(const config::Config& config, ThreadPool& pool);
+
+  // Deterministic for a given seed, whatever the thread count, unless a
+  // limit fires
+  [[nodiscard]] Result optimize(const domain::Piece& piece, domain::Hand hand,
+                                unsigned int seed, const Limits& limits);
+
+  // Without limits
+  [[nodiscard]] Result optimize(const domain::Piece& piece, domain::Hand hand,
+                                unsigned int seed);
+
+  // Already compiled hand, so callers optimizing one piece several times
+  // (see optimize_sweep()) compile it once
+  [[nodiscard]] Result optimize(const evaluator::EvalPiece& piece,
+                                unsigned int seed, const Limits& limits);
+
+  // Optimizes both hands at once on the shared pool: their beam searches
+  // and ILS schedules run concurrently. Each hand's result equals what
+  // optimize() returns for it with the same seed. Limits apply to both.
+  [[nodiscard]] PieceResult optimize_piece(const domain::Piece& piece,
+                                           unsigned int seed,
+                                           const Limits& limits);
+
+  // Without limits
+  [[nodiscard]] PieceResult optimize_piece(const domain::Piece& piece,
+                                           unsigned int seed);
+
+  // Re-fingers one hand after an edit: `previous` is a result for that
+  // hand of `previous_piece`. Only the playable slices that changed in
+  // `edited`, plus `margin` slices on each side, are searched, exactly and
+  // against the kept fingering around them (see refinger() in
+  // incremental.h); every other slice keeps its fingering. Both pieces are
+  // compiled and compared, but the search and rescoring grow with the
+  // edit rather than the piece.
+  [[nodiscard]] Result refinger(const domain::Piece& previous_piece,
+                                const Result& previous,
+                                const domain::Piece& edited,
+                                domain::Hand hand,
+                                size_t margin = kDefaultEditMargin) const;
+
+  // Both hands at once on the pool
+  [[nodiscard]] PieceResult refinger_piece(
+      const domain::Piece& previous_piece, const PieceResult& previous,
+      const domain::Piece& edited, size_t margin = kDefaultEditMargin);
+
+  [[nodiscard]] const evaluator::ScoreEvaluator& evaluator() const noexcept {
+    return evaluator_;
+  }
+
+  // Pool the searches run on, owned or borrowed
+  [[nodiscard]] ThreadPool& pool() const noexcept { return *pool_; }
+
+ private:
+  [[nodiscard]] Result optimize_hand(const evaluator::EvalPiece& piece,
+                                     unsigned int seed,
+                                     const Limits& limits);
+
+  // Builds node_evaluators_ when the pool's placement asks for replicas
+  void replicate_per_node();
+
+  config::Config config_;
+  evaluator::ScoreEvaluator evaluator_;
+  // Set when the optimizer owns its pool
+  std::unique_ptr<ThreadPool> owned_pool_;
+  ThreadPool* pool_;
+  // One evaluator per node of the pool, or empty without replicas
+  std::vector<evaluator::ScoreEvaluator> node_evaluators_;
+};
+
+}  // namespace piano_fingering::optimizer
+
+#endif  // PIANO_FINGERING_OPTIMIZER_OPTIMIZER_H_
@@ -0,0 +1,75 @@
+#ifndef PIANO_FINGERING_OPTIMIZER_PROGRESS_H_
+#define PIANO_FINGERING_OPTIMIZER_PROGRESS_H_
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+#include "domain/hand.h"
+
+namespace piano_fingering::optimizer {
+
+enum class ProgressPhase : std::uint8_t {
+  kBeamSearch,   // a hand's search began
+  kLocalSearch,  // some of its ILS iterations finished
+  kComplete,     // the hand is finished
+};
+
+struct ProgressEvent {
+  ProgressPhase phase{ProgressPhase::kBeamSearch};
+  domain::Hand hand{domain::Hand::kRight};
+  // Measures in the hand; set by kBeamSearch and kComplete
+  std::uint32_t measures{0};
+  // kBeamSearch: ILS iterations scheduled for the hand
+  // kLocalSearch: iterations finished since the trajectory last reported
+  // kComplete: iterations performed in all
+  std::uint64_t iterations{0};
+};
+
+// Bounded lock-free queue of progress events from any number of search
+// threads to one reporter thread. Publishing never blocks or allocates: a
+// full queue drops the event and counts it, so a slow reader costs the
+// searches nothing. Each cell carries a sequence number, so producers
+// claim slots with one compare-exchange and the reader needs no lock.
+class ProgressChannel {
+ public:
+  static constexpr size_t kDefaultCapacity = 4096;
+
+  // Rounds `capacity` up to a power of two; throws std::invalid_argument
+  // for zero
+  explicit ProgressChannel(size_t capacity = kDefaultCapacity);
+
+  ProgressChannel(const ProgressChannel&) = delete;
+  ProgressChannel& operator=(const ProgressChannel&) = delete;
+
+  // Safe from any thread. False if the queue was full.
+  bool publish(const ProgressEvent& event) noexcept;
+
+  // Oldest pending event into `event`; false if there is none. Only one
+  // thread may consume.
+  [[nodiscard]] bool consume(ProgressEvent& event) noexcept;
+
+  [[nodiscard]] size_t capacity() const noexcept { return mask_ + 1; }
+  // Events lost to a full queue
+  [[nodiscard]] size_t dropped() const noexcept {
+    return dropped_.load(std::memory_order_relaxed);
+  }
+
+ private:
+  struct Cell {
+    std::atomic<size_t> sequence{0};
+    ProgressEvent event;
+  };
+
+  std::unique_ptr<Cell[]> cells_;
+  size_t mask_;
+  // Producer and consumer positions on separate cache lines
+  alignas(64) std::atomic<size_t> tail_{0};
+  alignas(64) std::atomic<size_t> head_{0};
+  std::atomic<size_t> dropped_{0};
+};
+
+}  // namespace piano_fingering::optimizer
+
+#endif  // PIANO_FINGERING_OPTIMIZER_PROGRESS_H_
@@ -0,0 +1,96 @@
+#ifndef PIANO_FINGERING_OPTIMIZER_RESULT_CACHE_H_
+#define PIANO_FINGERING_OPTIMIZER_RESULT_CACHE_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <mutex>
+#include <optional>
+#include <unordered_map>
+
+#include "config/config.h"
+#include "domain/hand.h"
+#include "domain/packed_fingering.h"
+#include "evaluator/eval_piece.h"
+
+namespace piano_fingering::optimizer {
+
+// 64-bit hash of everything the search reads from a compiled hand: its
+// pitches, key colours, slice layout and rests. Positions in the source
+// score and metadata are left out, so the same notes in another file hash
+// alike.
+[[nodiscard]] std::uint64_t fingerprint(const evaluator::EvalPiece& piece);
+
+// What one hand's optimization depends on when no limit fires. The config
+// is kept whole and compared exactly; only the piece is reduced to a hash.
+struct ResultKey {
+  std::uint64_t piece{0};
+  domain::Hand hand{domain::Hand::kRight};
+  unsigned int seed{0};
+  config::Config config{};
+
+  [[nodiscard]] bool operator==(const ResultKey& other) const noexcept =
+      default;
+};
+
+struct ResultKeyHash {
+  [[nodiscard]] size_t operator()(const ResultKey& key) const noexcept;
+};
+
+struct CachedResult {
+  domain::PackedFingeringSequence fingerings;
+  double score{0.0};
+  size_t iterations_performed{0};
+};
+
+// In-memory LRU cache of optimized hands, shared by every optimizer given
+// it through Optimizer::Limits (see optimizer.h). Optimization is
+// deterministic for a key, so a hit is exactly what a fresh search would
+// return. Entries are charged their approximate heap size and the least
+// recently used are evicted to stay within the byte limit; an entry
+// larger than the whole limit is not kept. Thread-safe.
+class ResultCache {
+ public:
+  // A zero limit caches nothing
+  explicit ResultCache(size_t limit_bytes) noexcept : limit_(limit_bytes) {}
+
+  ResultCache(const ResultCache&) = delete;
+  ResultCache& operator=(const ResultCache&) = delete;
+
+  // Marks the entry most recently used
+  [[nodiscard]] std::optional<CachedResult> find(const ResultKey& key);
+
+  // Replaces any entry for `key`
+  void insert(const ResultKey& key, const CachedResult& result);
+
+  void clear();
+
+  [[nodiscard]] size_t limit() const noexcept { return limit_; }
+  [[nodiscard]] size_t size() const;
+  [[nodiscard]] size_t bytes() const;
+  [[nodiscard]] size_t hits() const;
+  [[nodiscard]] size_t misses() const;
+
+ private:
+  struct Entry {
+    ResultKey key;
+    CachedResult result;
+    size_t bytes{0};
+  };
+  using EntryList = std::list<Entry>;
+
+  void erase(EntryList::iterator entry);
+
+  size_t limit_;
+  mutable std::mutex mutex_;
+  // Most recently used first
+  EntryList entries_;
+  std::unordered_map<ResultKey, EntryList::iterator, ResultKeyHash> index_;
+  size_t bytes_{0};
+  size_t hits_{0};
+  size_t misses_{0};
+};
+
+}  // namespace piano_fingering::optimizer
+
+#endif  // PIANO_FINGERING_OPTIMIZER_RESULT_CACHE_H_
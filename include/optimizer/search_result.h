@@ -0,0 +1,29 @@
+#ifndef PIANO_FINGERING_OPTIMIZER_SEARCH_RESULT_H_
+#define PIANO_FINGERING_OPTIMIZER_SEARCH_RESULT_H_
+
+#include <cstddef>
+
+#include "domain/packed_fingering.h"
+
+namespace piano_fingering::optimizer {
+
+// Playable slices [begin, end) of a compiled hand, searched as if they were
+// the whole piece: terms reaching outside the range are not counted
+struct SliceRange {
+  size_t begin{0};
+  size_t end{0};
+
+  [[nodiscard]] size_t size() const noexcept { return end - begin; }
+};
+
+// Outcome of a constructive search over one compiled hand
+struct SearchResult {
+  // One fully fingered state per playable slice
+  domain::PackedFingeringSequence fingerings;
+  // evaluator.evaluate(piece, fingerings), up to rounding
+  double cost{0.0};
+};
+
+}  // namespace piano_fingering::optimizer
+
+#endif  // PIANO_FINGERING_OPTIMIZER_SEARCH_RESULT_H_
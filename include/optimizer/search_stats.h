@@ -0,0 +1,111 @@
+#ifndef PIANO_FINGERING_OPTIMIZER_SEARCH_STATS_H_
+#define PIANO_FINGERING_OPTIMIZER_SEARCH_STATS_H_
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "optimizer/thread_pool.h"
+
+namespace piano_fingering::optimizer {
+
+// Counters of one optimization, cheap enough to collect on every run
+struct SearchStats {
+  // Scores computed from scratch (ILS sessions built or refreshed) and
+  // single-note deltas (one per candidate finger of a neighborhood scan)
+  std::uint64_t full_evaluations{0};
+  std::uint64_t delta_evaluations{0};
+
+  // Hands answered by the result cache, and hands that had to be searched
+  // with a cache present
+  std::uint64_t result_cache_hits{0};
+  std::uint64_t result_cache_misses{0};
+
+  // Beam search, summed over its slices: children considered, those the
+  // incumbent bound dropped, those the width dropped, the survivors and the
+  // widths they could have filled. beam_kept / beam_capacity is the
+  // occupancy of the beam.
+  std::uint64_t beam_slices{0};
+  std::uint64_t beam_children{0};
+  std::uint64_t beam_bound_pruned{0};
+  std::uint64_t beam_width_pruned{0};
+  std::uint64_t beam_kept{0};
+  std::uint64_t beam_capacity{0};
+  // Sequential cost matrices computed for the beam's tables
+  std::uint64_t transition_fills{0};
+
+  // ILS perturbation rounds, rounds that found a new best, and single-note
+  // moves applied by perturbation and descent
+  std::uint64_t ils_iterations{0};
+  std::uint64_t ils_improvements{0};
+  std::uint64_t ils_moves{0};
+  // Tabu ILS rounds that ended on a local optimum worse than the best and
+  // reached within the last tabu_tenure rounds; each strengthens the next
+  // perturbation
+  std::uint64_t ils_tabu_revisits{0};
+
+  // Time spent searching by each thread that took part: the pool's workers
+  // in order, then the calling thread. Empty when nothing was searched.
+  std::vector<std::chrono::nanoseconds> thread_busy;
+  // Wall time of the optimize call
+  std::chrono::nanoseconds wall{0};
+
+  [[nodiscard]] std::uint64_t evaluations() const noexcept {
+    return full_evaluations + delta_evaluations;
+  }
+
+  [[nodiscard]] std::chrono::nanoseconds busy() const noexcept;
+
+  // Sums every counter; thread_busy is summed per thread, and wall too, so
+  // callers merging concurrent runs set wall themselves
+  SearchStats& operator+=(const SearchStats& other);
+};
+
+// Per-thread SearchStats for one run on a pool. Each thread counts into its
+// own slot, padded to a cache line, so counting never writes a line another
+// thread is using; merged() sums the slots once the run is over.
+class ThreadStats {
+ public:
+  // One slot per worker plus one for the thread that started the run. At
+  // most one non-worker thread may count into it.
+  explicit ThreadStats(const ThreadPool& pool);
+
+  // The calling thread's slot
+  [[nodiscard]] SearchStats& local() noexcept { return local_slot().stats; }
+
+  // Sum of every slot, with each slot's busy time in thread_busy
+  [[nodiscard]] SearchStats merged() const;
+
+  // Adds the lifetime of the timer to the busy time of the thread that
+  // created it; does nothing for a null ThreadStats
+  class BusyTimer {
+   public:
+    explicit BusyTimer(ThreadStats* stats) noexcept;
+    ~BusyTimer();
+
+    BusyTimer(const BusyTimer&) = delete;
+    BusyTimer& operator=(const BusyTimer&) = delete;
+
+   private:
+    ThreadStats* stats_;
+    std::chrono::steady_clock::time_point start_;
+  };
+
+ private:
+  struct alignas(64) Slot {
+    SearchStats stats;
+    std::chrono::nanoseconds busy{0};
+  };
+
+  [[nodiscard]] Slot& local_slot() noexcept {
+    return slots_[pool_->current_worker()];
+  }
+
+  const ThreadPool* pool_;
+  std::vector<Slot> slots_;
+};
+
+}  // namespace piano_fingering::optimizer
+
+#endif  // PIANO_FINGERING_OPTIMIZER_SEARCH_STATS_H_
@@ -0,0 +1,55 @@
+#ifndef PIANO_FINGERING_OPTIMIZER_SEGMENTED_SEARCH_H_
+#define PIANO_FINGERING_OPTIMIZER_SEGMENTED_SEARCH_H_
+
+#include <cstddef>
+#include <span>
+#include <vector>
+
+#include "evaluator/eval_piece.h"
+#include "evaluator/score_evaluator.h"
+#include "optimizer/search_result.h"
+#include "optimizer/thread_pool.h"
+
+namespace piano_fingering::optimizer {
+
+struct SegmentOptions {
+  // Shortest run of slices worth solving on its own
+  size_t min_segment_slices{64};
+  // Beam width per segment; 0 solves every segment with exact_search()
+  size_t beam_width{0};
+  // Solve each segment shape once and reuse its fingering for every
+  // repeat (see segment_repeats()); the result is the same either way
+  bool reuse_repeats{true};
+};
+
+// Splits the playable slices into consecutive segments. A segment of at
+// least min_segment_slices ends before the next slice that follows a rest,
+// or, once it is twice that long, before the next new measure. Covers
+// [0, slice_count()) in order; empty for an empty hand. Throws
+// std::invalid_argument for a zero min_segment_slices.
+[[nodiscard]] std::vector<SliceRange> split_segments(
+    const evaluator::EvalPiece& piece, size_t min_segment_slices);
+
+// For each of `segments`, the index of the first one with the same shape:
+// the same slice sizes, key colours and pitch intervals, at any
+// transposition. Every rule reads only those, so same-shaped segments cost
+// the same under any fingering and solve to the same one. Entry i is i for
+// the first occurrence of a shape.
+[[nodiscard]] std::vector<size_t> segment_repeats(
+    const evaluator::EvalPiece& piece, std::span<const SliceRange> segments);
+
+// Solves the segments of split_segments() concurrently on the pool, then
+// stitches them together. Sequential rules reach two slices back, so only
+// the transition and triplet terms straddling a cut couple neighbouring
+// segments: they are added back exactly, and a fixup pass re-chooses the
+// two slices around each cut against their fixed surroundings, which also
+// adapts a reused repeat to its neighbours. The returned cost is the exact
+// score of the stitched assignment.
+[[nodiscard]] SearchResult segmented_search(
+    const evaluator::ScoreEvaluator& evaluator,
+    const evaluator::EvalPiece& piece, ThreadPool& pool,
+    const SegmentOptions& options = {});
+
+}  // namespace piano_fingering::optimizer
+
+#endif  // PIANO_FINGERING_OPTIMIZER_SEGMENTED_SEARCH_H_
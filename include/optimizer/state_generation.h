@@ -0,0 +1,86 @@
+#ifndef PIANO_FINGERING_OPTIMIZER_STATE_GENERATION_H_
+#define PIANO_FINGERING_OPTIMIZER_STATE_GENERATION_H_
+
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <stdexcept>
+
+#include "domain/finger.h"
+#include "domain/packed_fingering.h"
+#include "domain/slice.h"
+
+namespace piano_fingering::optimizer {
+
+namespace detail {
+
+// P(5, k): assignments of distinct fingers to k notes
+[[nodiscard]] constexpr size_t state_count(size_t note_count) noexcept {
+  size_t count = 1;
+  for (size_t i = 0; i < note_count; ++i) {
+    count *= domain::kFingerCount - i;
+  }
+  return count;
+}
+
+// States of k-note slices start at kStateOffsets[k]
+inline constexpr auto kStateOffsets = [] {
+  std::array<size_t, domain::kMaxNotesPerSlice + 2> offsets{};
+  for (size_t k = 0; k <= domain::kMaxNotesPerSlice; ++k) {
+    offsets[k + 1] = offsets[k] + state_count(k);
+  }
+  return offsets;
+}();
+
+// Every k-digit base-5 finger sequence in lexicographic order, keeping
+// those without a repeated finger
+inline constexpr auto kStateTable = [] {
+  std::array<domain::PackedFingering, kStateOffsets.back()> table{};
+  size_t out = 0;
+  for (size_t k = 0; k <= domain::kMaxNotesPerSlice; ++k) {
+    size_t sequences = 1;
+    for (size_t i = 0; i < k; ++i) {
+      sequences *= domain::kFingerCount;
+    }
+    for (size_t code = 0; code < sequences; ++code) {
+      domain::PackedFingering state;
+      std::uint8_t used = 0;
+      size_t place = sequences;
+      for (size_t note = 0; note < k; ++note) {
+        place /= domain::kFingerCount;
+        const size_t digit = (code / place) % domain::kFingerCount;
+        used |= static_cast<std::uint8_t>(1U << digit);
+        state.set(note, static_cast<domain::Finger>(digit + 1));
+      }
+      if (static_cast<size_t>(std::popcount(used)) == k) {
+        table[out++] = state;
+      }
+    }
+  }
+  return table;
+}();
+
+}  // namespace detail
+
+// Every assignment of distinct fingers to the notes of a slice: P(5, k)
+// states for k notes, each with every note fingered, in lexicographic order
+// of the finger sequence. The states come from a table built at compile
+// time, so the call neither enumerates nor allocates. Throws
+// std::invalid_argument for more than five notes.
+[[nodiscard]] constexpr std::span<const domain::PackedFingering>
+generate_valid_states(size_t note_count) {
+  if (note_count > domain::kMaxNotesPerSlice) {
+    throw std::invalid_argument("Slice cannot contain more than 5 notes");
+  }
+  return {detail::kStateTable.data() + detail::kStateOffsets[note_count],
+          detail::state_count(note_count)};
+}
+
+static_assert(generate_valid_states(5).size() == 120);
+static_assert(!generate_valid_states(3)[59].violates_hard_constraint());
+
+}  // namespace piano_fingering::optimizer
+
+#endif  // PIANO_FINGERING_OPTIMIZER_STATE_GENERATION_H_
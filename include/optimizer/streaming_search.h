@@ -0,0 +1,105 @@
+#ifndef PIANO_FINGERING_OPTIMIZER_STREAMING_SEARCH_H_
+#define PIANO_FINGERING_OPTIMIZER_STREAMING_SEARCH_H_
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+
+#include "domain/finger.h"
+#include "domain/hand.h"
+#include "domain/packed_fingering.h"
+#include "domain/slice.h"
+#include "evaluator/eval_piece.h"
+#include "evaluator/score_evaluator.h"
+
+namespace piano_fingering::optimizer {
+
+struct StreamingOptions {
+  // Uncommitted slices at most; when a new slice would pass this, the
+  // oldest is committed along the cheapest path so far
+  size_t max_lag{64};
+  // Surviving (previous lead, lead) pairs per slice. At the default of all
+  // 25 the search is exact up to forced commits; fewer trades optimality
+  // for speed.
+  size_t beam_width{domain::kFingerCount * domain::kFingerCount};
+};
+
+// Fingers one hand delivered slice by slice (live MIDI, generated pieces of
+// any length) in memory bounded by the lag rather than the length.
+//
+// The sequential rules read only the leading fingers of the last three
+// slices, so the search keeps, for each new slice, the cheapest path ending
+// in each (previous lead, lead) pair: the Viterbi pass of exact_search(),
+// one layer at a time. Once every surviving path passes through the same
+// state of an older slice, that slice and those before it can no longer
+// change and are committed. Slices are committed in order and never
+// revised; the last ones come out of finish().
+//
+// Not thread-safe; use one instance per stream.
+class StreamingSearch {
+ public:
+  // Throws std::invalid_argument for a zero max_lag or beam_width
+  StreamingSearch(const evaluator::ScoreEvaluator& evaluator,
+                  domain::Hand hand, const StreamingOptions& options = {});
+
+  // Adds the next source slice of the hand, appending any fingerings it
+  // lets the search commit to `committed`. A rest-only slice adds nothing.
+  // Returns the number of slices committed.
+  size_t push(const domain::Slice& slice,
+              domain::PackedFingeringSequence& committed);
+
+  // Ends the stream: commits every remaining slice along the cheapest path
+  // and returns the score of everything committed since the stream began.
+  // The search is then empty and ready for a new stream.
+  double finish(domain::PackedFingeringSequence& committed);
+
+  // Playable slices received but not yet committed
+  [[nodiscard]] size_t pending() const noexcept {
+    return layers_.size() - committed_layers_;
+  }
+
+ private:
+  static constexpr size_t kLeads = domain::kFingerCount;
+  static constexpr size_t kPairs = kLeads * kLeads;
+
+  struct Node {
+    double cost;
+    std::uint8_t parent;  // index into the previous layer's nodes
+    std::uint8_t lead;    // leading finger, 0-based
+  };
+
+  // One playable slice: its cheapest state per lead and the paths into it
+  struct Layer {
+    std::array<domain::PackedFingering, kLeads> states{};
+    std::array<double, kLeads> intra{};
+    std::uint8_t note_count{0};
+    std::array<Node, kPairs> nodes{};
+    std::uint8_t size{0};
+  };
+
+  void extend(const Layer& previous, const Layer* before, Layer& layer) const;
+  // Node of layer `index` on the path ending at `node` of the newest layer
+  [[nodiscard]] std::uint8_t ancestor(size_t index, std::uint8_t node) const;
+  // Commits layers up to and including `last` along the path through `node`
+  // of that layer
+  void commit(size_t last, std::uint8_t node,
+              domain::PackedFingeringSequence& committed);
+  size_t commit_converged(domain::PackedFingeringSequence& committed);
+  void force_commit(domain::PackedFingeringSequence& committed);
+  void reset();
+
+  const evaluator::ScoreEvaluator* evaluator_;
+  StreamingOptions options_;
+  // The last three playable slices, for the evaluator's local terms
+  evaluator::EvalPiece window_;
+  // Uncommitted layers, plus up to two committed ones that new slices
+  // still read
+  std::deque<Layer> layers_;
+  size_t committed_layers_{0};
+  size_t source_slices_{0};
+};
+
+}  // namespace piano_fingering::optimizer
+
+#endif  // PIANO_FINGERING_OPTIMIZER_STREAMING_SEARCH_H_
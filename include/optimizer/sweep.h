@@ -0,0 +1,35 @@
+#ifndef PIANO_FINGERING_OPTIMIZER_SWEEP_H_
+#define PIANO_FINGERING_OPTIMIZER_SWEEP_H_
+
+#include <span>
+#include <vector>
+
+#include "config/config.h"
+#include "domain/piece.h"
+#include "optimizer/optimizer.h"
+#include "optimizer/thread_pool.h"
+
+namespace piano_fingering::optimizer {
+
+// Optimizes one piece under each of `configs` (for example the Small,
+// Medium and Large presets) in one job on `pool`. Both hands are compiled
+// once for all configs, and every config x hand search is scheduled on
+// the pool at once, so short pieces keep every worker busy instead of
+// running one config after another. Result i equals
+// Optimizer(configs[i]).optimize_piece(piece, seed, limits); the stats'
+// wall is that of the whole sweep. Limits apply to every search.
+//
+// Every config is validated before any search starts, so an invalid one
+// throws config::ConfigurationError without wasting the others' work.
+[[nodiscard]] std::vector<Optimizer::PieceResult> optimize_sweep(
+    std::span<const config::Config> configs, const domain::Piece& piece,
+    unsigned int seed, ThreadPool& pool, const Optimizer::Limits& limits);
+
+// Without limits
+[[nodiscard]] std::vector<Optimizer::PieceResult> optimize_sweep(
+    std::span<const config::Config> configs, const domain::Piece& piece,
+    unsigned int seed, ThreadPool& pool);
+
+}  // namespace piano_fingering::optimizer
+
+#endif  // PIANO_FINGERING_OPTIMIZER_SWEEP_H_
@@ -0,0 +1,349 @@
+#ifndef PIANO_FINGERING_OPTIMIZER_THREAD_POOL_H_
+#define PIANO_FINGERING_OPTIMIZER_THREAD_POOL_H_
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <latch>
+#include <memory>
+#include <memory_resource>
+#include <mutex>
+#include <new>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "optimizer/worker_placement.h"
+
+namespace piano_fingering::optimizer {
+
+namespace detail {
+// A worker's scratch arena, defined in thread_pool.cpp
+class WorkerArena;
+}  // namespace detail
+
+// Move-only void() callable with small-buffer storage. Closures of up to
+// kInlineSize bytes that are nothrow-movable live inline, so wrapping them
+// never allocates; larger ones fall back to the heap.
+class Task {
+ public:
+  static constexpr size_t kInlineSize = 48;
+
+  template <class F>
+  static constexpr bool kStoresInline =
+      sizeof(F) <= kInlineSize &&
+      alignof(F) <= alignof(std::max_align_t) &&
+      std::is_nothrow_move_constructible_v<F>;
+
+  Task() noexcept = default;
+
+  template <class F>
+    requires(!std::is_same_v<std::remove_cvref_t<F>, Task> &&
+             std::is_invocable_v<std::decay_t<F>&>)
+  explicit Task(F&& fn) {
+    using Fn = std::decay_t<F>;
+    if constexpr (kStoresInline<Fn>) {
+      ::new (static_cast<void*>(storage_)) Fn(std::forward<F>(fn));
+      vtable_ = &kInlineTable<Fn>;
+    } else {
+      ::new (static_cast<void*>(storage_)) Fn*(new Fn(std::forward<F>(fn)));
+      vtable_ = &kHeapTable<Fn>;
+    }
+  }
+
+  Task(Task&& other) noexcept { take(other); }
+
+  Task& operator=(Task&& other) noexcept {
+    if (this != &other) {
+      reset();
+      take(other);
+    }
+    return *this;
+  }
+
+  Task(const Task&) = delete;
+  Task& operator=(const Task&) = delete;
+
+  ~Task() { reset(); }
+
+  // Requires a non-empty task
+  void operator()() { vtable_->invoke(storage_); }
+
+  explicit operator bool() const noexcept { return vtable_ != nullptr; }
+
+ private:
+  struct VTable {
+    void (*invoke)(std::byte*);
+    void (*relocate)(std::byte* to, std::byte* from) noexcept;
+    void (*destroy)(std::byte*) noexcept;
+  };
+
+  template <class Fn>
+  static Fn* inline_object(std::byte* storage) noexcept {
+    return std::launder(reinterpret_cast<Fn*>(storage));
+  }
+
+  template <class Fn>
+  static Fn*& heap_object(std::byte* storage) noexcept {
+    return *std::launder(reinterpret_cast<Fn**>(storage));
+  }
+
+  template <class Fn>
+  static constexpr VTable kInlineTable{
+      [](std::byte* storage) { (*inline_object<Fn>(storage))(); },
+      [](std::byte* to, std::byte* from) noexcept {
+        Fn* source = inline_object<Fn>(from);
+        ::new (static_cast<void*>(to)) Fn(std::move(*source));
+        source->~Fn();
+      },
+      [](std::byte* storage) noexcept { inline_object<Fn>(storage)->~Fn(); }};
+
+  template <class Fn>
+  static constexpr VTable kHeapTable{
+      [](std::byte* storage) { (*heap_object<Fn>(storage))(); },
+      [](std::byte* to, std::byte* from) noexcept {
+        ::new (static_cast<void*>(to)) Fn*(heap_object<Fn>(from));
+      },
+      [](std::byte* storage) noexcept { delete heap_object<Fn>(storage); }};
+
+  void take(Task& other) noexcept {
+    if (other.vtable_ != nullptr) {
+      other.vtable_->relocate(storage_, other.storage_);
+      vtable_ = std::exchange(other.vtable_, nullptr);
+    }
+  }
+
+  void reset() noexcept {
+    if (vtable_ != nullptr) {
+      std::exchange(vtable_, nullptr)->destroy(storage_);
+    }
+  }
+
+  alignas(std::max_align_t) std::byte storage_[kInlineSize];
+  const VTable* vtable_{nullptr};
+};
+
+// Fixed-size work-stealing pool.
+//
+// Every worker owns a deque: tasks posted from a worker go to the back of
+// its own deque and it pops from the back (newest first, cache-warm), while
+// idle workers steal from the front of the others (oldest first, usually
+// the largest pieces of a split range). Tasks posted from outside the pool
+// are spread round-robin. Each deque has its own lock, so submission never
+// contends on a pool-wide mutex; the shared sleep mutex is only touched
+// when a worker has run out of work or must be woken.
+//
+// A posted task that throws terminates, as with std::thread; use TaskGroup
+// to propagate exceptions. The destructor runs every queued task before
+// joining, and no task may be posted from outside once it has started.
+//
+// By default workers float and allocate from the global heap. A
+// WorkerPlacement can pin them to CPUs and give each a scratch arena; tasks
+// still migrate between workers by stealing, so data they share should be
+// replicated per node (see WorkerPlacement::replicate_per_node).
+class ThreadPool {
+ public:
+  // hardware_concurrency(), or 1 where it is unknown
+  [[nodiscard]] static size_t default_thread_count() noexcept;
+
+  // Throws std::invalid_argument for zero threads
+  explicit ThreadPool(size_t thread_count = default_thread_count());
+
+  // Workers placed as `placement` asks, with its topology detected if
+  // empty. Returns once every worker has pinned itself and allocated its
+  // arena. Throws std::invalid_argument for zero threads.
+  ThreadPool(size_t thread_count, WorkerPlacement placement);
+  ~ThreadPool();
+
+  ThreadPool(const ThreadPool&) = delete;
+  ThreadPool& operator=(const ThreadPool&) = delete;
+
+  [[nodiscard]] size_t thread_count() const noexcept {
+    return threads_.size();
+  }
+
+  // Index of the calling thread among this pool's workers, or
+  // thread_count() when it is not one of them
+  [[nodiscard]] size_t current_worker() const noexcept;
+
+  // Placement the pool was built with, topology included
+  [[nodiscard]] const WorkerPlacement& placement() const noexcept {
+    return placement_;
+  }
+
+  // Workers the OS agreed to pin
+  [[nodiscard]] size_t pinned_workers() const noexcept {
+    return pinned_workers_.load(std::memory_order_relaxed);
+  }
+
+  // Nodes the workers are spread over: the topology's when any worker is
+  // pinned, otherwise 1
+  [[nodiscard]] size_t node_count() const noexcept {
+    return pinned_workers() > 0 ? placement_.topology.node_count() : 1;
+  }
+
+  // Node of worker `worker`; 0 for unpinned workers and for thread_count(),
+  // which current_worker() returns off the pool
+  [[nodiscard]] size_t worker_node(size_t worker) const noexcept {
+    return worker < worker_nodes_.size() ? worker_nodes_[worker] : 0;
+  }
+
+  template <class F>
+  void post(F&& fn) {
+    push(Task(std::forward<F>(fn)));
+  }
+
+  // Runs one queued task on the calling thread, preferring the caller's
+  // own deque when it is a worker. Returns false if none was found.
+  bool run_pending_task();
+
+ private:
+  class Queue;
+
+  void push(Task task);
+  bool acquire(Task& task, size_t home);
+  void work(size_t index, std::latch& ready);
+  // Pins worker `index` and allocates its arena, as placement_ asks
+  void place(size_t index);
+
+  std::vector<std::unique_ptr<Queue>> queues_;
+  WorkerPlacement placement_;
+  // Written by each worker before the constructor returns; empty unless
+  // placement_ pins workers or gives them arenas
+  std::vector<size_t> worker_nodes_;
+  std::vector<std::unique_ptr<detail::WorkerArena>> arenas_;
+  std::atomic<size_t> pinned_workers_{0};
+  std::vector<std::thread> threads_;
+  std::atomic<std::int64_t> queued_{0};
+  std::atomic<size_t> next_queue_{0};
+  std::atomic<size_t> sleepers_{0};
+  std::mutex sleep_mutex_;
+  std::condition_variable wake_;
+  bool stop_{false};
+};
+
+// Scratch memory for the task running on the calling thread. On a worker
+// of a pool with arenas, resource() is that worker's monotonic arena,
+// rewound when the worker's outermost scope closes, so a task's scratch
+// costs no heap traffic once the arena has grown to fit. Elsewhere it is
+// the default resource. Memory taken from resource() must not outlive the
+// scope or leave the thread.
+class ScratchScope {
+ public:
+  ScratchScope() noexcept;
+  ~ScratchScope();
+
+  ScratchScope(const ScratchScope&) = delete;
+  ScratchScope& operator=(const ScratchScope&) = delete;
+
+  [[nodiscard]] std::pmr::memory_resource* resource() const noexcept {
+    return resource_;
+  }
+
+ private:
+  detail::WorkerArena* arena_;
+  std::pmr::memory_resource* resource_;
+};
+
+// Fork-join scope over a pool. run() posts a task counted by the group and
+// wait() blocks until every one of them, including tasks they run() into
+// the group, has finished. While waiting, the caller executes queued tasks
+// itself, so groups nest inside pool tasks without deadlock even on a
+// single-thread pool. The first exception thrown by a task is rethrown by
+// wait(); the destructor waits and discards it.
+class TaskGroup {
+ public:
+  explicit TaskGroup(ThreadPool& pool) noexcept : pool_(&pool) {}
+  ~TaskGroup();
+
+  TaskGroup(const TaskGroup&) = delete;
+  TaskGroup& operator=(const TaskGroup&) = delete;
+
+  template <class F>
+  void run(F&& fn) {
+    pending_.fetch_add(1, std::memory_order_relaxed);
+    pool_->post([this, body = std::decay_t<F>(std::forward<F>(fn))]() mutable {
+      try {
+        // Destroyed before finish(), while the waiter is still blocked
+        auto local = std::move(body);
+        local();
+      } catch (...) {
+        record(std::current_exception());
+      }
+      finish();
+    });
+  }
+
+  void wait();
+
+ private:
+  void record(std::exception_ptr error);
+  void finish();
+
+  ThreadPool* pool_;
+  std::atomic<size_t> pending_{0};
+  // Guards error_ and the final decrement, so wait() cannot return while
+  // the last task still touches the group
+  std::mutex mutex_;
+  std::condition_variable done_;
+  std::exception_ptr error_;
+};
+
+// Calls body(i) for every i in [begin, end), split into contiguous chunks
+// of at least `grain` indices (at most four per thread). The caller runs
+// the first chunk and helps with the rest; the first exception is rethrown
+// once every chunk has finished.
+template <class F>
+void parallel_for(ThreadPool& pool, size_t begin, size_t end, F&& body,
+                  size_t grain = 1) {
+  if (begin >= end) {
+    return;
+  }
+  const size_t count = end - begin;
+  grain = std::max<size_t>(grain, 1);
+  const size_t chunks =
+      std::min((count + grain - 1) / grain, pool.thread_count() * 4);
+  const size_t chunk_size = (count + chunks - 1) / chunks;
+
+  TaskGroup group(pool);
+  for (size_t lo = begin + chunk_size; lo < end; lo += chunk_size) {
+    const size_t hi = std::min(end, lo + chunk_size);
+    group.run([&body, lo, hi] {
+      for (size_t i = lo; i < hi; ++i) {
+        body(i);
+      }
+    });
+  }
+  for (size_t i = begin; i < begin + chunk_size; ++i) {
+    body(i);
+  }
+  group.wait();
+}
+
+// Runs every callable concurrently, the last one on the calling thread, and
+// returns when all have finished. Exceptions propagate as in TaskGroup.
+template <class... Fs>
+void parallel_invoke(ThreadPool& pool, Fs&&... fns) {
+  static_assert(sizeof...(Fs) > 0);
+  TaskGroup group(pool);
+  // Post all but the last, then run the last inline
+  size_t remaining = sizeof...(Fs);
+  (
+      [&](auto& fn) {
+        if (--remaining == 0) {
+          fn();
+        } else {
+          group.run([&fn] { fn(); });
+        }
+      }(fns),
+      ...);
+  group.wait();
+}
+
+}  // namespace piano_fingering::optimizer
+
+#endif  // PIANO_FINGERING_OPTIMIZER_THREAD_POOL_H_
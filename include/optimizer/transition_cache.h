@@ -0,0 +1,92 @@
+#ifndef PIANO_FINGERING_OPTIMIZER_TRANSITION_CACHE_H_
+#define PIANO_FINGERING_OPTIMIZER_TRANSITION_CACHE_H_
+
+#include <array>
+#include <cstddef>
+#include <limits>
+#include <vector>
+
+#include "domain/finger.h"
+#include "domain/packed_fingering.h"
+#include "evaluator/eval_piece.h"
+#include "evaluator/score_evaluator.h"
+
+namespace piano_fingering::optimizer {
+
+// Lazily filled cache of the sequential cost terms of a fully fingered
+// piece, for search engines that score many states per slice.
+//
+// With every note fingered, ScoreEvaluator::evaluate_transition() and
+// evaluate_triplet() depend only on the leading finger of each slice, so a
+// slice boundary needs a 5x5 transition matrix and a 5x5x5 triplet cube
+// however many chord states share those leading fingers. Matrices live in a
+// direct-mapped table of `capacity` slots indexed by slice, which bounds the
+// memory; a slice evicted by a later one is recomputed on its next use.
+//
+// Not thread-safe: each search owns its cache. The evaluator and piece must
+// outlive the cache.
+class TransitionCache {
+ public:
+  static constexpr size_t kDefaultCapacity = 256;
+
+  // Throws std::invalid_argument for a zero capacity
+  TransitionCache(const evaluator::ScoreEvaluator& evaluator,
+                  const evaluator::EvalPiece& piece,
+                  size_t capacity = kDefaultCapacity);
+
+  // evaluate_transition() from slice - 1 led by prev to slice led by curr.
+  // Throws std::out_of_range unless 1 <= slice < piece.slice_count().
+  [[nodiscard]] double transition(size_t slice, domain::Finger prev,
+                                  domain::Finger curr);
+
+  // evaluate_triplet() over slices slice - 2, slice - 1 and slice. Throws
+  // std::out_of_range unless 2 <= slice < piece.slice_count().
+  [[nodiscard]] double triplet(size_t slice, domain::Finger first,
+                               domain::Finger middle, domain::Finger last);
+
+  // State overloads; states must finger their first note, as those from
+  // generate_valid_states() do. Throws std::invalid_argument otherwise.
+  [[nodiscard]] double transition(size_t slice, domain::PackedFingering prev,
+                                  domain::PackedFingering curr);
+  [[nodiscard]] double triplet(size_t slice, domain::PackedFingering first,
+                               domain::PackedFingering middle,
+                               domain::PackedFingering last);
+
+  [[nodiscard]] size_t capacity() const noexcept { return slots_.size(); }
+
+  // Number of matrices computed so far, counting recomputation after
+  // eviction
+  [[nodiscard]] size_t fill_count() const noexcept { return fill_count_; }
+
+ private:
+  static constexpr size_t kPairs = domain::kFingerCount * domain::kFingerCount;
+  static constexpr size_t kTriples = kPairs * domain::kFingerCount;
+  static constexpr size_t kNoSlice = std::numeric_limits<size_t>::max();
+
+  struct Slot {
+    size_t transition_slice{kNoSlice};
+    size_t triplet_slice{kNoSlice};
+    std::array<double, kPairs> transitions{};
+    std::array<double, kTriples> triplets{};
+  };
+
+  [[nodiscard]] static size_t finger_index(domain::Finger finger) noexcept {
+    return static_cast<size_t>(domain::to_int(finger) - 1);
+  }
+
+  [[nodiscard]] Slot& slot(size_t slice) noexcept {
+    return slots_[slice % slots_.size()];
+  }
+
+  void fill_transitions(Slot& entry, size_t slice);
+  void fill_triplets(Slot& entry, size_t slice);
+
+  const evaluator::ScoreEvaluator* evaluator_;
+  const evaluator::EvalPiece* piece_;
+  std::vector<Slot> slots_;
+  size_t fill_count_{0};
+};
+
+}  // namespace piano_fingering::optimizer
+
+#endif  // PIANO_FINGERING_OPTIMIZER_TRANSITION_CACHE_H_
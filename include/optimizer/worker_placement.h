@@ -0,0 +1,82 @@
+#ifndef PIANO_FINGERING_OPTIMIZER_WORKER_PLACEMENT_H_
+#define PIANO_FINGERING_OPTIMIZER_WORKER_PLACEMENT_H_
+
+#include <cstddef>
+#include <exception>
+#include <span>
+#include <thread>
+#include <vector>
+
+namespace piano_fingering::optimizer {
+
+// CPUs this process may run on, grouped by NUMA node. Empty where the
+// platform does not report them, in which case nothing is pinned.
+class CpuTopology {
+ public:
+  CpuTopology() = default;
+
+  // Nodes without an allowed CPU are dropped
+  explicit CpuTopology(std::vector<std::vector<unsigned>> nodes);
+
+  // On Linux, the CPUs in the process affinity mask grouped by
+  // /sys/devices/system/node (one node if that is missing); empty elsewhere
+  [[nodiscard]] static CpuTopology detect();
+
+  [[nodiscard]] bool empty() const noexcept { return nodes_.empty(); }
+  [[nodiscard]] size_t node_count() const noexcept { return nodes_.size(); }
+  [[nodiscard]] const std::vector<unsigned>& cpus(size_t node) const {
+    return nodes_.at(node);
+  }
+
+ private:
+  std::vector<std::vector<unsigned>> nodes_;
+};
+
+// Binds the calling thread to `cpus`. Returns false where affinity is not
+// supported or the OS refuses it; the thread then keeps running unpinned.
+bool pin_current_thread(std::span<const unsigned> cpus) noexcept;
+
+// Runs `fn` on a fresh thread pinned to `node`'s CPUs and waits for it.
+// Memory `fn` first touches then lands on that node under the usual
+// first-touch policy, so this is how per-node replicas are built. An
+// exception thrown by `fn` is rethrown on the caller.
+template <class F>
+void run_on_node(const CpuTopology& topology, size_t node, F&& fn) {
+  std::exception_ptr error;
+  std::thread thread([&] {
+    try {
+      if (node < topology.node_count()) {
+        pin_current_thread(topology.cpus(node));
+      }
+      fn();
+    } catch (...) {
+      error = std::current_exception();
+    }
+  });
+  thread.join();
+  if (error) {
+    std::rethrow_exception(error);
+  }
+}
+
+// Optional NUMA-friendly placement of a ThreadPool's workers. The default
+// places nothing, so the pool keeps the no-topology requirement of SRS
+// HW-1.2; every option is a hint that degrades to the default where the
+// platform cannot honour it.
+struct WorkerPlacement {
+  // Pins worker i to one CPU of node i % node_count(), so the workers
+  // spread evenly over the nodes
+  bool pin_workers{false};
+  // Initial bytes of each worker's scratch arena (see ScratchScope),
+  // allocated by the worker itself after pinning; 0 means no arenas
+  size_t arena_bytes{0};
+  // Asks optimizers on the pool to give every node its own copy of the
+  // read-only penalty tables and compiled piece. Needs pinned workers.
+  bool replicate_per_node{false};
+  // Topology to place on; detected when left empty
+  CpuTopology topology;
+};
+
+}  // namespace piano_fingering::optimizer
+
+#endif  // PIANO_FINGERING_OPTIMIZER_WORKER_PLACEMENT_H_
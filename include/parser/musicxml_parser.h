@@ -1,25 +1,81 @@
 #ifndef PIANO_FINGERING_PARSER_MUSICXML_PARSER_H_
 #define PIANO_FINGERING_PARSER_MUSICXML_PARSER_H_
 
+#include <cstddef>
 #include <filesystem>
 #include <memory>
 #include <pugixml.hpp>
+#include <string>
+#include <vector>
 
 #include "domain/piece.h"
+#include "domain/source_map.h"
 #include "parser/parser_error.h"
 
 namespace piano_fingering::parser {
 
 class MusicXMLParser {
  public:
+  enum class ParseMode {
+    // Build the DOM and return it for MusicXML output
+    kKeepDocument,
+    // Read the Piece in one forward pass over the text, with no DOM. Input
+    // that is not UTF-8 goes through a DOM freed before parse() returns.
+    kDiscardDocument,
+  };
+
+  struct ParseOptions {
+    ParseMode mode{ParseMode::kKeepDocument};
+    // id attribute of the <part> to read; empty reads the first part
+    std::string part_id;
+    // With kKeepDocument, long parts are split into chunks of measures
+    // extracted on up to this many threads; the result is the same for any
+    // count. The forward pass of kDiscardDocument is serial.
+    size_t threads{1};
+    // Copy the score text into ParseResult::score before the in-place parse
+    // rewrites it, so callers splicing output need not read the file again
+    bool keep_score{false};
+  };
+
   struct ParseResult {
     domain::Piece piece;
+    // Null in ParseMode::kDiscardDocument
     std::unique_ptr<pugi::xml_document> original_xml;
+    // One entry per skipped note, e.g. "Measure 3: skipping note: ..."
+    std::vector<std::string> warnings;
+    // Offsets of the notes in read_score()'s text, for the generator;
+    // empty if pugixml had to re-encode the input
+    domain::SourceMap source_map;
+    // read_score()'s text with ParseOptions::keep_score, else empty
+    std::string score;
   };
 
   MusicXMLParser() = delete;
 
+  // Accepts raw MusicXML or a compressed .mxl archive
   [[nodiscard]] static ParseResult parse(const std::filesystem::path& xml_path);
+
+  // Callers that never write MusicXML back from the DOM should use
+  // kDiscardDocument, which never holds one for UTF-8 input, so peak memory
+  // is the score text plus the Piece.
+  [[nodiscard]] static ParseResult parse(const std::filesystem::path& xml_path,
+                                         ParseMode mode);
+
+  // Throws std::invalid_argument for zero threads
+  [[nodiscard]] static ParseResult parse(const std::filesystem::path& xml_path,
+                                         const ParseOptions& options);
+
+  // The score text source maps refer to: the file itself, or the root
+  // score inflated from a .mxl archive
+  [[nodiscard]] static std::string read_score(
+      const std::filesystem::path& xml_path);
+
+  // As kDiscardDocument, but served from the binary piece cache in
+  // `cache_dir` when it holds an entry for this file's content; a miss
+  // parses the XML and stores the result there (see parser/piece_cache.h)
+  [[nodiscard]] static ParseResult parse_cached(
+      const std::filesystem::path& xml_path,
+      const std::filesystem::path& cache_dir);
 };
 
 }  // namespace piano_fingering::parser
@@ -31,6 +31,12 @@ class MissingElementError : public ParserError {
       : ParserError("Missing required element: " + element) {}
 };
 
+class MalformedArchiveError : public ParserError {
+ public:
+  explicit MalformedArchiveError(const std::string& detail)
+      : ParserError("Invalid compressed MusicXML: " + detail) {}
+};
+
 }  // namespace piano_fingering::parser
 
 #endif  // PIANO_FINGERING_PARSER_PARSER_ERROR_H_
@@ -0,0 +1,69 @@
+#ifndef PIANO_FINGERING_PARSER_PIECE_CACHE_H_
+#define PIANO_FINGERING_PARSER_PIECE_CACHE_H_
+
+#include <cstdint>
+#include <filesystem>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "domain/piece.h"
+#include "domain/source_map.h"
+
+namespace piano_fingering::parser {
+
+// Compiled form of a parsed score, so repeated runs over the same file skip
+// the XML entirely. One little-endian blob:
+//
+//   header   magic "PFPC", format version, hash of the source file,
+//            element counts and a checksum of everything after the header
+//   measures number, time signature and end offset into the slices
+//   slices   end offset into the notes
+//   notes    8 bytes each: duration, pitch, octave, rest/staff/voice
+//   offsets  source offset of each note, if the header flags a source map
+//   strings  title, composer, parse warnings (length-prefixed)
+//
+// Offsets are cumulative, so each array is read in one sequential pass.
+// Decoding validates every field, and any mismatch (other version, other
+// source hash, bad checksum) reads as a cache miss rather than an error.
+inline constexpr std::uint32_t kPieceCacheVersion = 2;
+
+struct CachedPiece {
+  domain::Piece piece;
+  std::vector<std::string> warnings;
+  domain::SourceMap source_map;
+};
+
+// Fast 64-bit hash of a file's bytes, used as the cache key
+[[nodiscard]] std::uint64_t content_hash(std::string_view bytes) noexcept;
+
+// An empty source map is stored as absent
+[[nodiscard]] std::string encode_piece_cache(
+    std::uint64_t source_hash, const domain::Piece& piece,
+    const std::vector<std::string>& warnings,
+    const domain::SourceMap& source_map);
+
+// nullopt unless `bytes` is an intact cache of this version for that source
+[[nodiscard]] std::optional<CachedPiece> decode_piece_cache(
+    std::string_view bytes, std::uint64_t source_hash);
+
+// <cache_dir>/<source hash in hex>.pfpc
+[[nodiscard]] std::filesystem::path piece_cache_path(
+    const std::filesystem::path& cache_dir, std::uint64_t source_hash);
+
+// nullopt if the file is missing, unreadable or stale
+[[nodiscard]] std::optional<CachedPiece> load_piece_cache(
+    const std::filesystem::path& cache_dir, std::uint64_t source_hash);
+
+// Writes through a temporary file and renames it into place, so concurrent
+// readers never see a partial cache. Returns false if it could not be
+// written; a missing cache only costs a re-parse.
+bool store_piece_cache(const std::filesystem::path& cache_dir,
+                       std::uint64_t source_hash, const domain::Piece& piece,
+                       const std::vector<std::string>& warnings,
+                       const domain::SourceMap& source_map);
+
+}  // namespace piano_fingering::parser
+
+#endif  // PIANO_FINGERING_PARSER_PIECE_CACHE_H_
@@ -4,7 +4,10 @@
 #define PFING_PARSER_PITCH_MAPPING_H_
 
 #include <array>
+#include <optional>
 #include <stdexcept>
+#include <string>
+#include <string_view>
 
 #include "domain/pitch.h"
 
@@ -13,13 +16,13 @@ namespace piano_fingering::parser {
 // Maps MusicXML pitch (step + alter) to modified pitch class (0-13).
 // step: 'A'-'G' (case-insensitive)
 // alter: -2 (double flat) to +2 (double sharp)
-// Returns: domain::Pitch with value 0-13
-// Throws: std::invalid_argument if step is not A-G
-inline domain::Pitch step_alter_to_pitch(const std::string& step, int alter) {
+// Returns: domain::Pitch with value 0-13, or nullopt if step is not A-G
+inline std::optional<domain::Pitch> try_step_alter_to_pitch(
+    std::string_view step, int alter) noexcept {
   static constexpr std::array<int, 7> kBase = {9, 11, 0, 2, 4, 6, 7};  // A-G
 
   if (step.empty()) {
-    throw std::invalid_argument("Invalid step: empty string");
+    return std::nullopt;
   }
 
   char ch = step[0];
@@ -29,7 +32,7 @@ inline domain::Pitch step_alter_to_pitch(const std::string& step, int alter) {
   } else if (ch >= 'A' && ch <= 'G') {
     idx = ch - 'A';
   } else {
-    throw std::invalid_argument("Invalid step: must be A-G");
+    return std::nullopt;
   }
 
   int base = kBase[idx];
@@ -41,6 +44,19 @@ inline domain::Pitch step_alter_to_pitch(const std::string& step, int alter) {
   return domain::Pitch(result % 14);
 }
 
+// As try_step_alter_to_pitch()
+// Throws: std::invalid_argument if step is not A-G
+inline domain::Pitch step_alter_to_pitch(const std::string& step, int alter) {
+  if (step.empty()) {
+    throw std::invalid_argument("Invalid step: empty string");
+  }
+  auto pitch = try_step_alter_to_pitch(step, alter);
+  if (!pitch.has_value()) {
+    throw std::invalid_argument("Invalid step: must be A-G");
+  }
+  return *pitch;
+}
+
 }  // namespace piano_fingering::parser
 
 #endif  // PFING_PARSER_PITCH_MAPPING_H_
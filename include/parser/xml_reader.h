@@ -0,0 +1,81 @@
+#ifndef PIANO_FINGERING_PARSER_XML_READER_H_
+#define PIANO_FINGERING_PARSER_XML_READER_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace piano_fingering::parser {
+
+// Forward-only pull reader over a UTF-8 XML document held in memory: one
+// token at a time, without building a tree. Covers what MusicXML uses
+// (elements, attributes, character data, CDATA, comments, processing
+// instructions and a DOCTYPE) and reads values as pugixml's default parse
+// does: entities decoded, line endings normalized, whitespace-only text
+// between elements dropped. Names and undecoded values are views into the
+// text, which must outlive the reader. Throws MalformedXMLError, with the
+// byte offset, for a document that is not well formed.
+class XmlReader {
+ public:
+  enum class Token : uint8_t {
+    kStartElement,
+    kEndElement,  // Also follows the start of an empty element (<a/>)
+    kText,        // Character data or a CDATA section
+    kEnd,         // The document is complete and well formed
+  };
+
+  explicit XmlReader(std::string_view text) noexcept;
+
+  [[nodiscard]] Token next();
+
+  // Consumes the rest of the current start element, through its end tag
+  void skip();
+
+  // Of the current start or end element
+  [[nodiscard]] std::string_view name() const noexcept { return name_; }
+
+  // Byte offset of the current token: the '<' of an element
+  [[nodiscard]] size_t offset() const noexcept { return offset_; }
+
+  // Value of the named attribute of the current start element, or nullopt.
+  // Decoded into `scratch` when it holds entities or whitespace to convert.
+  [[nodiscard]] std::optional<std::string_view> attribute(
+      std::string_view name, std::string& scratch) const;
+
+  // Current text, decoded into `scratch` when needed
+  [[nodiscard]] std::string_view text(std::string& scratch) const;
+
+ private:
+  [[noreturn]] void fail(size_t at, const char* detail) const;
+  [[nodiscard]] bool starts_with(std::string_view prefix) const noexcept;
+  // Index just past the terminator found from pos_, or fails with `detail`
+  [[nodiscard]] size_t past(std::string_view terminator,
+                            const char* detail) const;
+  [[nodiscard]] std::string_view read_name();
+  void skip_whitespace() noexcept;
+  void skip_doctype();
+  Token read_start_element();
+  Token read_end_element();
+
+  std::string_view text_;
+  size_t pos_{0};
+  // Names of the open elements, innermost last
+  std::vector<std::string_view> open_;
+  bool seen_element_{false};
+  // The current start element was empty, so an end token comes next
+  bool end_pending_{false};
+
+  std::string_view name_;
+  // Attribute text of the current start element, between name and '>'
+  std::string_view attributes_;
+  std::string_view value_;
+  bool cdata_{false};
+  size_t offset_{0};
+};
+
+}  // namespace piano_fingering::parser
+
+#endif  // PIANO_FINGERING_PARSER_XML_READER_H_
@@ -0,0 +1,51 @@
+#ifndef PIANO_FINGERING_PARSER_ZIP_ARCHIVE_H_
+#define PIANO_FINGERING_PARSER_ZIP_ARCHIVE_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace piano_fingering::parser {
+
+// Read-only view of a zip archive held in memory, enough for compressed
+// MusicXML (.mxl): stored and deflated entries, no ZIP64 or encryption.
+// The bytes must outlive the archive. Throws MalformedArchiveError for
+// anything it cannot read.
+class ZipArchive {
+ public:
+  struct Entry {
+    std::string name;
+    uint16_t method;
+    uint32_t crc;
+    uint32_t compressed_size;
+    uint32_t size;
+    uint32_t local_offset;
+  };
+
+  explicit ZipArchive(std::string_view bytes);
+
+  // True if the bytes start like a zip archive
+  [[nodiscard]] static bool is_zip(std::string_view bytes) noexcept;
+
+  [[nodiscard]] const std::vector<Entry>& entries() const noexcept {
+    return entries_;
+  }
+
+  // nullptr if there is no entry of that name
+  [[nodiscard]] const Entry* find(std::string_view name) const noexcept;
+
+  // Inflates the entry straight into out[0, entry.size) and checks its CRC
+  void extract(const Entry& entry, char* out) const;
+
+  [[nodiscard]] std::string read(const Entry& entry) const;
+
+ private:
+  std::string_view bytes_;
+  std::vector<Entry> entries_;
+};
+
+}  // namespace piano_fingering::parser
+
+#endif  // PIANO_FINGERING_PARSER_ZIP_ARCHIVE_H_
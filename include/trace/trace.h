@@ -0,0 +1,101 @@
+#ifndef PIANO_FINGERING_TRACE_TRACE_H_
+#define PIANO_FINGERING_TRACE_TRACE_H_
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+#include <string_view>
+
+namespace piano_fingering::trace {
+
+// Spans are compiled in only when the build defines PIANO_FINGERING_TRACING
+// (cmake -DENABLE_TRACING=ON). Otherwise Span is inert and instrumented
+// code compiles to what it would be without it.
+#ifdef PIANO_FINGERING_TRACING
+inline constexpr bool kCompiledIn = true;
+#else
+inline constexpr bool kCompiledIn = false;
+#endif
+
+// One finished span. The strings are stored as pointers, so they must be
+// string literals or otherwise outlive the trace.
+struct Event {
+  const char* category{nullptr};
+  const char* name{nullptr};
+  std::int64_t start_ns{0};  // since start()
+  std::int64_t duration_ns{0};
+  const char* arg_name{nullptr};  // nullptr for no argument
+  std::int64_t arg{0};
+};
+
+// Events a thread keeps; later ones are counted in dropped_count()
+inline constexpr size_t kMaxEventsPerThread = size_t{1} << 20;
+
+namespace detail {
+inline std::atomic<bool> recording{false};
+}  // namespace detail
+
+[[nodiscard]] inline bool recording() noexcept {
+  return detail::recording.load(std::memory_order_relaxed);
+}
+
+// Discards everything recorded so far and starts the clock. Events are
+// kept per thread, so recording threads never contend with each other.
+void start();
+
+// Spans that finish after this are not recorded
+void stop() noexcept;
+
+// Nanoseconds since the last start()
+[[nodiscard]] std::int64_t now_ns() noexcept;
+
+// Adds `event` to the calling thread's track; ignored when not recording
+void record(const Event& event) noexcept;
+
+// Label of the calling thread's track, e.g. "worker 3"
+void set_thread_name(std::string_view name);
+
+[[nodiscard]] size_t event_count();
+[[nodiscard]] size_t dropped_count();
+
+// Chrome trace-event JSON (chrome://tracing, ui.perfetto.dev): every event
+// as a complete ("X") event on its thread's track, plus track names.
+// Call after stop(), or while other threads may still be recording.
+void write_chrome_trace(std::ostream& out);
+
+// Times its own scope as one event. Costs one relaxed load when compiled
+// in but not recording, and nothing when compiled out.
+class Span {
+ public:
+  Span(const char* category, const char* name) noexcept
+      : Span(category, name, nullptr, 0) {}
+
+  Span(const char* category, const char* name, const char* arg_name,
+       std::int64_t arg) noexcept {
+    if constexpr (kCompiledIn) {
+      if (recording()) {
+        event_ = {category, name, now_ns(), 0, arg_name, arg};
+      }
+    }
+  }
+
+  ~Span() {
+    if constexpr (kCompiledIn) {
+      if (event_.name != nullptr) {
+        event_.duration_ns = now_ns() - event_.start_ns;
+        record(event_);
+      }
+    }
+  }
+
+  Span(const Span&) = delete;
+  Span& operator=(const Span&) = delete;
+
+ private:
+  Event event_;
+};
+
+}  // namespace piano_fingering::trace
+
+#endif  // PIANO_FINGERING_TRACE_TRACE_H_
@@ -0,0 +1,167 @@
+// src/cli/args.cpp - Command-line argument parsing
+
+#include "cli/args.h"
+
+#include <charconv>
+#include <string_view>
+#include <system_error>
+#include <vector>
+
+namespace piano_fingering::cli {
+
+namespace {
+
+template <class T>
+T parse_number(std::string_view name, std::string_view text) {
+  T value{};
+  const auto [end, error] =
+      std::from_chars(text.data(), text.data() + text.size(), value);
+  if (error != std::errc() || end != text.data() + text.size()) {
+    throw ArgumentError("Invalid value '" + std::string(text) + "' for --" +
+                        std::string(name));
+  }
+  return value;
+}
+
+// True for the options that take a value
+bool takes_value(std::string_view name) noexcept {
+  return name == "output-dir" || name == "preset" || name == "config" ||
+         name == "seed" || name == "threads" || name == "max-requests" ||
+         name == "result-cache" || name == "trace";
+}
+
+void apply(Arguments& args, std::string_view name, std::string_view value) {
+  if (name == "output-dir") {
+    args.output_dir = value;
+  } else if (name == "preset") {
+    args.preset = value;
+  } else if (name == "config") {
+    args.config_path = value;
+  } else if (name == "seed") {
+    args.seed = parse_number<unsigned int>(name, value);
+  } else if (name == "threads") {
+    args.threads = parse_number<size_t>(name, value);
+    if (args.threads == 0) {
+      throw ArgumentError("--threads must be at least 1");
+    }
+  } else if (name == "max-requests") {
+    args.max_requests = parse_number<size_t>(name, value);
+    if (args.max_requests == 0) {
+      throw ArgumentError("--max-requests must be at least 1");
+    }
+  } else if (name == "result-cache") {
+    args.result_cache_mib = parse_number<size_t>(name, value);
+  } else if (name == "trace") {
+    args.trace_path = value;
+  }
+}
+
+void apply_flag(Arguments& args, std::string_view name) {
+  if (name == "batch") {
+    args.batch = true;
+  } else if (name == "serve") {
+    args.serve = true;
+  } else if (name == "stats") {
+    args.stats = true;
+  } else if (name == "force" || name == "f") {
+    args.force_overwrite = true;
+  } else if (name == "quiet" || name == "q") {
+    args.quiet = true;
+  } else if (name == "help" || name == "h") {
+    args.help = true;
+  } else if (name == "version" || name == "v") {
+    args.version = true;
+  } else {
+    throw ArgumentError("Unknown option '" + std::string(name) +
+                        "'. Use --help for usage information.");
+  }
+}
+
+}  // namespace
+
+Arguments parse_arguments(int argc, const char* const* argv) {
+  Arguments args;
+  std::vector<std::string_view> positional;
+  for (int i = 1; i < argc; ++i) {
+    const std::string_view arg = argv[i];
+    if (arg.size() < 2 || arg.front() != '-') {
+      positional.push_back(arg);
+      continue;
+    }
+    std::string_view name = arg.substr(arg[1] == '-' ? 2 : 1);
+    const size_t equals = name.find('=');
+    if (equals != std::string_view::npos) {
+      const std::string_view value = name.substr(equals + 1);
+      name = name.substr(0, equals);
+      if (!takes_value(name)) {
+        throw ArgumentError("Option '" + std::string(name) +
+                            "' does not take a value");
+      }
+      apply(args, name, value);
+    } else if (takes_value(name)) {
+      if (i + 1 == argc) {
+        throw ArgumentError("Missing value for --" + std::string(name));
+      }
+      apply(args, name, argv[++i]);
+    } else {
+      apply_flag(args, name);
+    }
+  }
+
+  if (args.help || args.version) {
+    return args;
+  }
+  if (args.serve) {
+    if (args.batch || !positional.empty()) {
+      throw ArgumentError("--serve takes requests on stdin, not arguments");
+    }
+    return args;
+  }
+  if (positional.empty()) {
+    throw ArgumentError("Missing required argument: input file");
+  }
+  const size_t max_positional = args.batch ? 1 : 2;
+  if (positional.size() > max_positional) {
+    throw ArgumentError("Unexpected argument '" +
+                        std::string(positional[max_positional]) + "'");
+  }
+  args.input = positional[0];
+  if (positional.size() == 2) {
+    args.output = positional[1];
+  }
+  return args;
+}
+
+std::string usage() {
+  return R"(USAGE: piano-fingering [OPTIONS] <input_file> [output_file]
+       piano-fingering --batch [OPTIONS] <directory | manifest>
+       piano-fingering --serve [--threads <n>] [--max-requests <n>]
+
+Automatically generate optimal piano fingerings for MusicXML files.
+
+ARGUMENTS:
+  <input_file>            MusicXML (.musicxml, .xml or .mxl) file to process
+  [output_file]           Output path (default: <input>_fingered.musicxml)
+  <directory>             With --batch: every score in the directory
+  <manifest>              With --batch: a file listing one score per line
+
+OPTIONS:
+  -h, --help              Display this help message
+  -v, --version           Display version information
+      --batch             Process many scores in one pipelined run
+      --output-dir <dir>  Write batch outputs to <dir>, not beside inputs
+      --serve             Answer JSON-lines requests on stdin until it closes
+      --max-requests <n>  Requests served at once [default: 4]
+      --result-cache <n>  MiB of results kept for repeats [default: 64]
+      --preset <name>     Small, Medium or Large hand [default: Medium]
+      --config <path>     Custom configuration JSON file
+      --seed <int>        Random seed for reproducibility
+      --threads <n>       Optimizer threads [default: all cores]
+      --stats             Print optimizer counters after each score
+      --trace <path>      Write a Chrome trace of the run's phases
+  -f, --force             Overwrite existing output files
+  -q, --quiet             Suppress non-error output
+)";
+}
+
+}  // namespace piano_fingering::cli
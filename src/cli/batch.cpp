@@ -0,0 +1,122 @@
+// src/cli/batch.cpp - Batch job discovery and error classification
+
+#include "cli/batch.h"
+
+#include <algorithm>
+#include <array>
+#include <fstream>
+#include <string_view>
+#include <system_error>
+
+#include "config/configuration_error.h"
+#include "generator/generator_error.h"
+#include "parser/parser_error.h"
+
+namespace piano_fingering::cli {
+
+namespace {
+
+constexpr std::string_view kFingeredSuffix = "_fingered";
+constexpr std::array<std::string_view, 3> kScoreExtensions = {
+    ".musicxml", ".xml", ".mxl"};
+
+bool is_score(const std::filesystem::path& path) {
+  const std::string extension = path.extension().string();
+  return std::find(kScoreExtensions.begin(), kScoreExtensions.end(),
+                   extension) != kScoreExtensions.end() &&
+         !path.stem().string().ends_with(kFingeredSuffix);
+}
+
+std::string_view trim(std::string_view line) noexcept {
+  constexpr std::string_view kSpace = " \t\r";
+  const size_t first = line.find_first_not_of(kSpace);
+  if (first == std::string_view::npos) {
+    return {};
+  }
+  return line.substr(first, line.find_last_not_of(kSpace) + 1 - first);
+}
+
+std::vector<std::filesystem::path> scan_directory(
+    const std::filesystem::path& directory) {
+  std::vector<std::filesystem::path> inputs;
+  for (const auto& entry : std::filesystem::directory_iterator(directory)) {
+    if (entry.is_regular_file() && is_score(entry.path())) {
+      inputs.push_back(entry.path());
+    }
+  }
+  std::sort(inputs.begin(), inputs.end());
+  return inputs;
+}
+
+std::vector<std::filesystem::path> read_manifest(
+    const std::filesystem::path& manifest) {
+  std::ifstream file(manifest);
+  if (!file) {
+    throw parser::FileNotFoundError(manifest.string());
+  }
+  std::vector<std::filesystem::path> inputs;
+  std::string line;
+  while (std::getline(file, line)) {
+    const std::string_view entry = trim(line);
+    if (entry.empty() || entry.front() == '#') {
+      continue;
+    }
+    const std::filesystem::path input(entry);
+    inputs.push_back(input.is_absolute() ? input
+                                         : manifest.parent_path() / input);
+  }
+  return inputs;
+}
+
+}  // namespace
+
+std::filesystem::path default_output_path(
+    const std::filesystem::path& input,
+    const std::filesystem::path& output_dir) {
+  const std::string extension =
+      input.extension() == ".mxl" ? ".musicxml" : input.extension().string();
+  const std::string name =
+      input.stem().string() + std::string(kFingeredSuffix) + extension;
+  return (output_dir.empty() ? input.parent_path() : output_dir) / name;
+}
+
+std::vector<BatchJob> collect_batch_jobs(
+    const std::filesystem::path& source,
+    const std::filesystem::path& output_dir) {
+  std::error_code error;
+  if (!std::filesystem::exists(source, error)) {
+    throw parser::FileNotFoundError(source.string());
+  }
+  const std::vector<std::filesystem::path> inputs =
+      std::filesystem::is_directory(source) ? scan_directory(source)
+                                            : read_manifest(source);
+  std::vector<BatchJob> jobs;
+  jobs.reserve(inputs.size());
+  for (const std::filesystem::path& input : inputs) {
+    jobs.push_back({input, default_output_path(input, output_dir)});
+  }
+  return jobs;
+}
+
+int exit_code_for(const std::exception_ptr& error) noexcept {
+  if (!error) {
+    return 0;
+  }
+  try {
+    std::rethrow_exception(error);
+  } catch (const parser::FileNotFoundError&) {
+    return 2;
+  } catch (const parser::ParserError&) {
+    return 3;
+  } catch (const config::ConfigurationError&) {
+    return 4;
+  } catch (const generator::FileExistsError&) {
+    return 5;
+  } catch (const generator::FileWriteError&) {
+    return 6;
+  } catch (...) {
+    return 7;
+  }
+}
+
+}  // namespace piano_fingering::cli
@@ -0,0 +1,132 @@
+// src/cli/batch_runner.cpp - Pipelined parse/optimize/write over a batch
+
+#include <exception>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "cli/batch.h"
+#include "cli/pipeline.h"
+#include "domain/piece.h"
+#include "domain/source_map.h"
+#include "generator/musicxml_generator.h"
+#include "optimizer/optimizer.h"
+#include "optimizer/result_cache.h"
+#include "parser/musicxml_parser.h"
+
+namespace piano_fingering::cli {
+
+namespace {
+
+struct ParsedJob {
+  domain::Piece piece;
+  domain::SourceMap source_map;
+  std::string score;
+  std::vector<std::string> warnings;
+};
+
+struct OptimizedJob {
+  ParsedJob parsed;
+  optimizer::Optimizer::PieceResult result;
+};
+
+// The DOM is never needed: output splices into the score text, which the
+// parse keeps so the file is read and inflated only once
+ParsedJob parse_job(const BatchJob& job) {
+  parser::MusicXMLParser::ParseOptions options;
+  options.mode = parser::MusicXMLParser::ParseMode::kDiscardDocument;
+  options.keep_score = true;
+  auto parsed = parser::MusicXMLParser::parse(job.input, options);
+  return {std::move(parsed.piece), std::move(parsed.source_map),
+          std::move(parsed.score), std::move(parsed.warnings)};
+}
+
+void write_job(const BatchJob& job, const OptimizedJob& done,
+               bool force_overwrite) {
+  generator::MusicXMLGenerator::generate(
+      job.output, done.parsed.score, done.parsed.piece, done.parsed.source_map,
+      done.result.left_hand.fingerings, done.result.right_hand.fingerings,
+      force_overwrite);
+}
+
+void record_error(BatchItemResult& result, const std::exception_ptr& error) {
+  result.exit_code = exit_code_for(error);
+  try {
+    std::rethrow_exception(error);
+  } catch (const std::exception& e) {
+    result.error = e.what();
+  } catch (...) {
+    result.error = "unknown error";
+  }
+}
+
+}  // namespace
+
+BatchItemResult run_job(const BatchJob& job, optimizer::Optimizer& optimizer,
+                        optimizer::ResultCache* cache, unsigned int seed,
+                        bool force_overwrite) {
+  BatchItemResult result{job, 0, {}, 0.0, {}, {}};
+  optimizer::Optimizer::Limits limits;
+  limits.cache = cache;
+  try {
+    ParsedJob parsed = parse_job(job);
+    result.warnings = parsed.warnings;
+    auto optimized = optimizer.optimize_piece(parsed.piece, seed, limits);
+    const OptimizedJob done{std::move(parsed), std::move(optimized)};
+    write_job(job, done, force_overwrite);
+    result.score = done.result.score;
+    result.stats = done.result.stats;
+  } catch (...) {
+    record_error(result, std::current_exception());
+  }
+  return result;
+}
+
+std::vector<BatchItemResult> run_batch(
+    const std::vector<BatchJob>& jobs, const config::Config& config,
+    const BatchOptions& options,
+    const std::function<void(const BatchItemResult&)>& on_complete) {
+  std::vector<BatchItemResult> results(jobs.size());
+  for (size_t i = 0; i < jobs.size(); ++i) {
+    results[i].job = jobs[i];
+  }
+  // One optimizer for the whole batch: its pool is built once and each
+  // piece in turn has every worker
+  optimizer::Optimizer optimizer(config, options.threads);
+  optimizer::ResultCache cache(options.result_cache_bytes);
+  optimizer::Optimizer::Limits limits;
+  limits.cache = &cache;
+  limits.progress = options.progress;
+
+  auto finish = [&](size_t i) {
+    if (on_complete) {
+      on_complete(results[i]);
+    }
+  };
+  run_pipeline<ParsedJob, OptimizedJob>(
+      jobs.size(), options.queue_capacity,
+      [&](size_t i) {
+        // Recorded here so they are reported even if a later stage fails
+        ParsedJob parsed = parse_job(jobs[i]);
+        results[i].warnings = parsed.warnings;
+        return parsed;
+      },
+      [&](size_t, ParsedJob& parsed) {
+        auto result =
+            optimizer.optimize_piece(parsed.piece, options.seed, limits);
+        return OptimizedJob{std::move(parsed), std::move(result)};
+      },
+      [&](size_t i, OptimizedJob& done) {
+        write_job(jobs[i], done, options.force_overwrite);
+        results[i].score = done.result.score;
+        results[i].stats = done.result.stats;
+        finish(i);
+      },
+      [&](size_t i, const std::exception_ptr& error) {
+        record_error(results[i], error);
+        finish(i);
+      });
+  return results;
+}
+
+}  // namespace piano_fingering::cli
@@ -0,0 +1,102 @@
+// src/cli/progress_reporter.cpp - Terminal progress from optimizer events
+
+#include "cli/progress_reporter.h"
+
+#include <algorithm>
+#include <condition_variable>
+#include <cstddef>
+#include <mutex>
+
+namespace piano_fingering::cli {
+
+namespace {
+
+// How often the channel is drained; well below any print interval
+constexpr std::chrono::milliseconds kPollInterval{10};
+
+}  // namespace
+
+ProgressReporter::ProgressReporter(optimizer::ProgressChannel& channel,
+                                   std::ostream& out,
+                                   std::chrono::milliseconds interval)
+    : channel_(&channel),
+      out_(&out),
+      interval_(interval),
+      thread_([this](const std::stop_token& stop) { run(stop); }) {}
+
+ProgressReporter::~ProgressReporter() {
+  thread_.request_stop();
+  thread_.join();
+}
+
+void ProgressReporter::run(const std::stop_token& stop) {
+  using Clock = std::chrono::steady_clock;
+  std::mutex mutex;
+  std::condition_variable_any wake;
+  auto next_print = Clock::now();
+  while (!stop.stop_requested()) {
+    drain();
+    const std::string text = line();
+    if (!text.empty() && text != printed_ && Clock::now() >= next_print) {
+      *out_ << '\r' << text << std::flush;
+      printed_ = text;
+      next_print = Clock::now() + interval_;
+    }
+    std::unique_lock lock(mutex);
+    wake.wait_for(lock, stop, kPollInterval, [] { return false; });
+  }
+
+  drain();
+  const std::string text = line();
+  if (!text.empty() && text != printed_) {
+    *out_ << '\r' << text;
+    printed_ = text;
+  }
+  if (!printed_.empty()) {
+    *out_ << '\n' << std::flush;
+  }
+}
+
+void ProgressReporter::drain() {
+  optimizer::ProgressEvent event;
+  while (channel_->consume(event)) {
+    HandProgress& hand = hands_[static_cast<size_t>(event.hand)];
+    switch (event.phase) {
+      case optimizer::ProgressPhase::kBeamSearch:
+        // A new piece for this hand starts from zero
+        hand = {event.measures, event.iterations, 0, false};
+        break;
+      case optimizer::ProgressPhase::kLocalSearch:
+        hand.done += event.iterations;
+        break;
+      case optimizer::ProgressPhase::kComplete:
+        hand.measures = event.measures;
+        hand.complete = true;
+        break;
+    }
+  }
+}
+
+std::string ProgressReporter::line() const {
+  std::uint64_t total = 0;
+  std::uint64_t current = 0;
+  for (const HandProgress& hand : hands_) {
+    total = std::max<std::uint64_t>(total, hand.measures);
+    std::uint64_t reached = hand.measures;
+    if (!hand.complete) {
+      // Dropped events only make the estimate lag
+      reached = hand.scheduled == 0
+                    ? 0
+                    : std::min(hand.done, hand.scheduled) * hand.measures /
+                          hand.scheduled;
+    }
+    current = std::max(current, reached);
+  }
+  if (total == 0) {
+    return {};
+  }
+  return "Processing Measure [" + std::to_string(current) + " / " +
+         std::to_string(total) + "]...";
+}
+
+}  // namespace piano_fingering::cli
@@ -0,0 +1,166 @@
+// src/cli/server.cpp - JSON-lines request server
+
+#include "cli/server.h"
+
+#include <cstdint>
+#include <exception>
+#include <memory>
+#include <nlohmann/json.hpp>
+#include <random>
+#include <stdexcept>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "cli/batch.h"
+#include "cli/bounded_queue.h"
+#include "config/config.h"
+#include "config/config_manager.h"
+#include "config/fingerprint.h"
+
+namespace piano_fingering::cli {
+
+namespace {
+
+constexpr int kBadRequest = 1;
+constexpr size_t kDefaultResultCacheBytes = size_t{64} << 20;
+
+nlohmann::json error_response(const nlohmann::json& id, int exit_code,
+                              const std::string& message) {
+  return {{"id", id}, {"ok", false}, {"exit_code", exit_code},
+          {"error", message}};
+}
+
+}  // namespace
+
+Server::Server(size_t threads, size_t max_requests)
+    : Server(threads, max_requests, kDefaultResultCacheBytes) {}
+
+Server::Server(size_t threads, size_t max_requests, size_t result_cache_bytes)
+    : pool_(threads),
+      max_requests_(max_requests),
+      results_(result_cache_bytes) {
+  if (max_requests == 0) {
+    throw std::invalid_argument("Server request limit must be > 0");
+  }
+}
+
+size_t Server::cached_configs() const {
+  std::lock_guard lock(mutex_);
+  return optimizers_.size();
+}
+
+std::shared_ptr<optimizer::Optimizer> Server::optimizer_for(
+    const std::string& preset, const std::filesystem::path& config_path) {
+  // Reading the file each time is cheap (parsed configs are cached by
+  // content), and keying by the loaded values means an edited file gets a
+  // new optimizer while equal configs from any source share one
+  const config::Config config =
+      config_path.empty()
+          ? config::ConfigManager::load_preset(preset)
+          : config::ConfigManager::load_custom(config_path, preset);
+  const std::uint64_t key = config::fingerprint(config);
+  // Building under the lock keeps two first requests for the same config
+  // from both doing it
+  std::lock_guard lock(mutex_);
+  for (auto it = optimizers_.begin(); it != optimizers_.end(); ++it) {
+    if (it->key == key && it->config == config) {
+      optimizers_.splice(optimizers_.begin(), optimizers_, it);
+      return it->optimizer;
+    }
+  }
+  optimizers_.push_front(CachedOptimizer{
+      key, config, std::make_shared<optimizer::Optimizer>(config, pool_)});
+  if (optimizers_.size() > kMaxCachedConfigs) {
+    optimizers_.pop_back();
+  }
+  return optimizers_.front().optimizer;
+}
+
+std::string Server::handle(std::string_view request) {
+  nlohmann::json id;
+  BatchJob job;
+  std::string preset = "Medium";
+  std::filesystem::path config_path;
+  unsigned int seed = 0;
+  bool force_overwrite = false;
+  try {
+    const nlohmann::json body = nlohmann::json::parse(request);
+    if (!body.is_object()) {
+      return error_response(id, kBadRequest, "Request must be an object")
+          .dump();
+    }
+    id = body.value("id", nlohmann::json());
+    if (!body.contains("input") || !body["input"].is_string()) {
+      return error_response(id, kBadRequest, "Missing \"input\"").dump();
+    }
+    job.input = body["input"].get<std::string>();
+    const std::string output = body.value("output", std::string());
+    job.output = output.empty() ? default_output_path(job.input, {})
+                                : std::filesystem::path(output);
+    preset = body.value("preset", preset);
+    config_path = body.value("config", std::string());
+    seed = body.contains("seed") ? body["seed"].get<unsigned int>()
+                                 : std::random_device{}();
+    force_overwrite = body.value("force", false);
+  } catch (const nlohmann::json::exception& e) {
+    return error_response(id, kBadRequest,
+                          std::string("Invalid request: ") + e.what())
+        .dump();
+  }
+
+  BatchItemResult result;
+  try {
+    const auto optimizer = optimizer_for(preset, config_path);
+    result = run_job(job, *optimizer, &results_, seed, force_overwrite);
+  } catch (...) {
+    // Only loading the config throws; run_job records its own errors
+    const std::exception_ptr error = std::current_exception();
+    std::string message = "unknown error";
+    try {
+      std::rethrow_exception(error);
+    } catch (const std::exception& e) {
+      message = e.what();
+    } catch (...) {
+    }
+    return error_response(id, exit_code_for(error), message).dump();
+  }
+
+  if (result.exit_code != 0) {
+    return error_response(id, result.exit_code, result.error).dump();
+  }
+  const nlohmann::json response = {{"id", id},
+                                   {"ok", true},
+                                   {"output", job.output.string()},
+                                   {"seed", seed},
+                                   {"score", result.score},
+                                   {"warnings", result.warnings}};
+  return response.dump();
+}
+
+void Server::serve(std::istream& in, std::ostream& out) {
+  BoundedQueue<std::string> requests(max_requests_);
+  std::mutex out_mutex;
+  {
+    std::vector<std::jthread> handlers;
+    handlers.reserve(max_requests_);
+    for (size_t i = 0; i < max_requests_; ++i) {
+      handlers.emplace_back([&] {
+        while (auto request = requests.pop()) {
+          const std::string response = handle(*request);
+          std::lock_guard lock(out_mutex);
+          out << response << '\n' << std::flush;
+        }
+      });
+    }
+    std::string line;
+    while (std::getline(in, line)) {
+      if (line.find_first_not_of(" \t\r") != std::string::npos) {
+        requests.push(std::move(line));
+      }
+    }
+    requests.close();
+  }
+}
+
+}  // namespace piano_fingering::cli
@@ -0,0 +1,95 @@
+// src/cli/stats_report.cpp - Human-readable optimizer counters
+
+#include "cli/stats_report.h"
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+
+namespace piano_fingering::cli {
+
+namespace {
+
+double seconds(std::chrono::nanoseconds time) noexcept {
+  return std::chrono::duration<double>(time).count();
+}
+
+// 3.1M, 45.2k or 812
+std::string count(double value) {
+  char text[32];
+  if (value >= 1e6) {
+    std::snprintf(text, sizeof text, "%.1fM", value / 1e6);
+  } else if (value >= 1e4) {
+    std::snprintf(text, sizeof text, "%.1fk", value / 1e3);
+  } else {
+    std::snprintf(text, sizeof text, "%.0f", value);
+  }
+  return text;
+}
+
+std::string percent(double part, double whole) {
+  char text[16];
+  std::snprintf(text, sizeof text, "%.0f%%",
+                whole <= 0.0 ? 0.0 : 100.0 * part / whole);
+  return text;
+}
+
+std::string percent(std::uint64_t part, std::uint64_t whole) {
+  return percent(static_cast<double>(part), static_cast<double>(whole));
+}
+
+std::string fixed(double value) {
+  char text[32];
+  std::snprintf(text, sizeof text, "%.2f", value);
+  return text;
+}
+
+}  // namespace
+
+void write_stats(std::ostream& out, const optimizer::SearchStats& stats) {
+  const double wall = seconds(stats.wall);
+  if (stats.evaluations() > 0) {
+    out << "  evaluations: " << stats.full_evaluations << " full, "
+        << count(static_cast<double>(stats.delta_evaluations)) << " delta";
+    if (wall > 0.0) {
+      out << ", " << count(static_cast<double>(stats.evaluations()) / wall)
+          << "/s over " << fixed(wall) << " s";
+    }
+    out << '\n';
+  }
+  if (stats.result_cache_hits + stats.result_cache_misses > 0) {
+    out << "  result cache: " << stats.result_cache_hits << " hit(s), "
+        << stats.result_cache_misses << " miss(es)\n";
+  }
+  if (stats.beam_slices > 0) {
+    out << "  beam: " << stats.beam_slices << " slices, "
+        << percent(stats.beam_kept, stats.beam_capacity) << " occupancy, "
+        << percent(stats.beam_bound_pruned, stats.beam_children)
+        << " of children pruned by bound, "
+        << percent(stats.beam_width_pruned, stats.beam_children)
+        << " by width, " << stats.transition_fills << " transition fills\n";
+  }
+  if (stats.ils_iterations > 0) {
+    out << "  ils: " << stats.ils_iterations << " iterations, "
+        << stats.ils_improvements << " improvements, " << stats.ils_moves
+        << " moves\n";
+  }
+  size_t threads = 0;
+  for (const auto busy : stats.thread_busy) {
+    threads += busy.count() > 0 ? 1 : 0;
+  }
+  if (threads > 0 && wall > 0.0) {
+    out << "  threads: " << threads << " busy "
+        << percent(seconds(stats.busy()), wall * static_cast<double>(threads))
+        << " of the time (";
+    const char* separator = "";
+    for (const auto busy : stats.thread_busy) {
+      out << separator << fixed(seconds(busy));
+      separator = " ";
+    }
+    out << " s)\n";
+  }
+}
+
+}  // namespace piano_fingering::cli
@@ -1,25 +1,20 @@
 #include "config/config_manager.h"
 
-#include <algorithm>
-#include <cctype>
+#include <cstdint>
 #include <fstream>
+#include <iterator>
+#include <mutex>
 #include <nlohmann/json.hpp>
 #include <string>
 #include <unordered_map>
 
 #include "config/configuration_error.h"
+#include "config/fingerprint.h"
 #include "config/preset.h"
 
 namespace piano_fingering::config {
 namespace {
 
-std::string to_lower(std::string_view str) {
-  std::string result(str);
-  std::transform(result.begin(), result.end(), result.begin(),
-                 [](unsigned char c) { return std::tolower(c); });
-  return result;
-}
-
 FingerPair finger_pair_from_string(const std::string& str) {
   static const std::unordered_map<std::string, FingerPair> kMapping = {
       {"1-2", FingerPair::kThumbIndex},  {"1-3", FingerPair::kThumbMiddle},
@@ -78,6 +73,16 @@ void apply_algorithm_overrides(AlgorithmParameters& algo_params,
     algo_params.perturbation_strength =
         algo["perturbation_strength"].get<std::size_t>();
   }
+  if (algo.contains("beam_states_per_slice")) {
+    algo_params.beam_states_per_slice =
+        algo["beam_states_per_slice"].get<std::size_t>();
+  }
+  if (algo.contains("ils_trajectories")) {
+    algo_params.ils_trajectories = algo["ils_trajectories"].get<std::size_t>();
+  }
+  if (algo.contains("fixed_point_costs")) {
+    algo_params.fixed_point_costs = algo["fixed_point_costs"].get<bool>();
+  }
 }
 
 void apply_weights_overrides(RuleWeights& weights, const nlohmann::json& json) {
@@ -106,44 +111,77 @@ void apply_distance_matrix_overrides(Config& config,
   }
 }
 
-nlohmann::json read_json_file(const std::filesystem::path& path) {
-  std::ifstream file(path);
+std::string read_file(const std::filesystem::path& path) {
+  std::ifstream file(path, std::ios::binary);
   if (!file) {
     throw ConfigurationError("Cannot open file: " + path.string());
   }
+  return {std::istreambuf_iterator<char>(file),
+          std::istreambuf_iterator<char>()};
+}
 
-  nlohmann::json json;
+nlohmann::json parse_json(const std::string& text) {
   try {
-    file >> json;
+    return nlohmann::json::parse(text);
   } catch (const nlohmann::json::parse_error& e) {
     throw ConfigurationError("JSON parse error: " + std::string(e.what()));
   }
-  return json;
+}
+
+// Custom configs already parsed, keyed by file content and base preset,
+// so a file read again is only hashed and compared, never re-parsed
+struct ParsedConfig {
+  std::string text;
+  std::string_view base_preset;
+  Config config;
+};
+
+constexpr std::size_t kMaxParsedConfigs = 32;
+
+struct ParsedConfigCache {
+  std::mutex mutex;
+  std::unordered_multimap<std::uint64_t, ParsedConfig> entries;
+};
+
+ParsedConfigCache& parsed_config_cache() {
+  static ParsedConfigCache cache;
+  return cache;
 }
 
 }  // namespace
 
 Config ConfigManager::load_preset(std::string_view name) {
-  const std::string lower_name = to_lower(name);  // NOLINT
-
-  if (lower_name == "small") {
-    return get_small_preset().to_config();
-  }
-  if (lower_name == "medium") {
-    return get_medium_preset().to_config();
-  }
-  if (lower_name == "large") {
-    return get_large_preset().to_config();
+  if (const Preset* preset = find_preset(name)) {
+    return preset->to_config();
   }
-
   throw ConfigurationError("Unknown preset: " + std::string(name));
 }
 
 Config ConfigManager::load_custom(const std::filesystem::path& path,
                                   std::string_view base_preset) {
-  Config config = load_preset(base_preset);
-  nlohmann::json json = read_json_file(path);
+  const Preset* base = find_preset(base_preset);
+  if (base == nullptr) {
+    throw ConfigurationError("Unknown preset: " + std::string(base_preset));
+  }
+  const std::string text = read_file(path);
+  Fingerprinter hasher;
+  hasher.add(text);
+  hasher.add(base->name);
+  const std::uint64_t key = hasher.finish();
+
+  ParsedConfigCache& cache = parsed_config_cache();
+  {
+    std::lock_guard lock(cache.mutex);
+    const auto [begin, end] = cache.entries.equal_range(key);
+    for (auto it = begin; it != end; ++it) {
+      if (it->second.text == text && it->second.base_preset == base->name) {
+        return it->second.config;
+      }
+    }
+  }
 
+  Config config = base->to_config();
+  const nlohmann::json json = parse_json(text);
   apply_algorithm_overrides(config.algorithm, json);
   apply_weights_overrides(config.weights, json);
   apply_distance_matrix_overrides(config, json);
@@ -153,6 +191,11 @@ Config ConfigManager::load_custom(const std::filesystem::path& path,
     throw ConfigurationError("Invalid configuration: " + error);
   }
 
+  std::lock_guard lock(cache.mutex);
+  if (cache.entries.size() >= kMaxParsedConfigs) {
+    cache.entries.clear();
+  }
+  cache.entries.emplace(key, ParsedConfig{text, base->name, config});
   return config;
 }
 
@@ -0,0 +1,77 @@
+#include "evaluator/eval_piece.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+
+#include "domain/measure.h"
+#include "domain/note.h"
+#include "domain/slice.h"
+
+namespace piano_fingering::evaluator {
+
+EvalPiece::EvalPiece(const domain::Piece& piece, domain::Hand hand)
+    : EvalPiece(hand) {
+  const auto& measures =
+      (hand == domain::Hand::kLeft) ? piece.left_hand() : piece.right_hand();
+
+  size_t measure_idx = 0;
+  for (const auto& measure : measures) {
+    size_t slice_idx = 0;
+    for (const auto& slice : measure) {
+      append(slice, measure_idx, slice_idx);
+      ++slice_idx;
+    }
+    ++measure_idx;
+  }
+}
+
+EvalPiece::EvalPiece(domain::Hand hand) : hand_(hand) {
+  slice_offsets_.push_back(0);
+}
+
+bool EvalPiece::append(const domain::Slice& slice, size_t measure_index,
+                       size_t slice_index) {
+  const size_t before = pitches_.size();
+  for (const auto& note : slice) {
+    if (!note.is_rest()) {
+      pitches_.push_back(note.absolute_pitch());
+      black_keys_.push_back(note.pitch().is_black_key() ? 1 : 0);
+    }
+  }
+  if (pitches_.size() == before) {
+    after_rest_ = true;
+    return false;
+  }
+  slice_offsets_.push_back(static_cast<std::uint32_t>(pitches_.size()));
+  measure_indices_.push_back(static_cast<std::uint32_t>(measure_index));
+  slice_indices_.push_back(static_cast<std::uint32_t>(slice_index));
+  follows_rest_.push_back(after_rest_ ? 1 : 0);
+  after_rest_ = false;
+  return true;
+}
+
+void EvalPiece::drop_front(size_t count) {
+  count = std::min(count, slice_count());
+  if (count == 0) {
+    return;
+  }
+  const std::uint32_t notes = slice_offsets_[count];
+  const auto drop_notes = static_cast<std::ptrdiff_t>(notes);
+  const auto drop_slices = static_cast<std::ptrdiff_t>(count);
+  pitches_.erase(pitches_.begin(), pitches_.begin() + drop_notes);
+  black_keys_.erase(black_keys_.begin(), black_keys_.begin() + drop_notes);
+  slice_offsets_.erase(slice_offsets_.begin(),
+                       slice_offsets_.begin() + drop_slices);
+  for (std::uint32_t& offset : slice_offsets_) {
+    offset -= notes;
+  }
+  measure_indices_.erase(measure_indices_.begin(),
+                         measure_indices_.begin() + drop_slices);
+  slice_indices_.erase(slice_indices_.begin(),
+                       slice_indices_.begin() + drop_slices);
+  follows_rest_.erase(follows_rest_.begin(),
+                      follows_rest_.begin() + drop_slices);
+}
+
+}  // namespace piano_fingering::evaluator
@@ -0,0 +1,913 @@
+// src/evaluator/evaluation_kernel.h - Scoring kernel shared by the evaluator
+// entry points (internal header)
+#ifndef PIANO_FINGERING_EVALUATOR_EVALUATION_KERNEL_H_
+#define PIANO_FINGERING_EVALUATOR_EVALUATION_KERNEL_H_
+
+#include <algorithm>
+#include <array>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <optional>
+#include <span>
+#include <vector>
+
+#include "config/rule_weights.h"
+#include "domain/finger.h"
+#include "domain/fingering.h"
+#include "domain/hand.h"
+#include "domain/packed_fingering.h"
+#include "domain/slice.h"
+#include "evaluator/eval_piece.h"
+#include "evaluator/fingering_population.h"
+#include "evaluator/penalty_tables.h"
+#include "evaluator/rule_features.h"
+#include "evaluator/rule_stats.h"
+#include "evaluator/rules.h"
+
+namespace piano_fingering::evaluator::detail {
+
+// Helper struct to hold note information
+struct NoteInfo {
+  domain::Finger finger;
+  int pitch;
+  bool is_black;
+};
+
+// Instrumentation policies. The kernel reports every rule result through
+// record() only when kEnabled, so the production instantiation compiles to
+// the plain arithmetic.
+struct NoInstrumentation {
+  static constexpr bool kEnabled = false;
+
+  void record(config::RuleIndex /*rule*/, double /*penalty*/) const noexcept {}
+  [[nodiscard]] NoInstrumentation reversed() const noexcept { return {}; }
+};
+
+// Accumulates into RuleStats; sign is -1 while scoring the old side of a delta
+struct RuleStatsRecorder {
+  static constexpr bool kEnabled = true;
+
+  RuleStats* stats;
+  double sign{1.0};
+
+  void record(config::RuleIndex rule, double penalty) const noexcept {
+    const auto i = static_cast<size_t>(rule);
+    stats->penalty[i] += sign * penalty;
+    ++stats->invocations[i];
+    if (penalty != 0.0) {
+      ++stats->triggered[i];
+    }
+  }
+  [[nodiscard]] RuleStatsRecorder reversed() const noexcept {
+    return {stats, -sign};
+  }
+};
+
+// Accumulates unit-weight rule results into RuleFeatures, with the Rule 14
+// chord term also split by distance rule
+struct RuleFeatureRecorder {
+  static constexpr bool kEnabled = true;
+
+  RuleFeatures* features;
+
+  void record(config::RuleIndex rule, double penalty) const noexcept {
+    features->values[static_cast<size_t>(rule)] += penalty;
+  }
+  void record_chord(
+      const HandPenaltyTable::DistanceParts& parts) const noexcept {
+    features->chord.comfort += parts.comfort;
+    features->chord.relaxed += parts.relaxed;
+    features->chord.practical += parts.practical;
+  }
+};
+
+// Rule-set parameter selecting a kernel that reads the enabled rules from
+// the context at run time. Bit 15 is not a rule, so no real mask collides.
+inline constexpr config::RuleMask kDynamicRules = 1U << config::kRuleCount;
+
+// Evaluation context grouping related parameters. The hand and, unless
+// Rules is kDynamicRules, the enabled rule set are compile-time constants,
+// so hand checks fold away and disabled rules are compiled out.
+template <domain::Hand H, config::RuleMask Rules,
+          typename Policy = NoInstrumentation>
+struct EvaluationContext {
+  using PolicyType = Policy;
+  static constexpr domain::Hand kHand = H;
+
+  // Reference intentional for short-lived aggregation
+  const HandPenaltyTable&
+      table;  // NOLINT(cppcoreguidelines-avoid-const-or-ref-data-members)
+  config::RuleMask rules{config::kAllRules};
+  [[no_unique_address]] Policy policy{};
+
+  // True if any rule in mask is enabled
+  [[nodiscard]] constexpr bool any_enabled(
+      config::RuleMask mask) const noexcept {
+    if constexpr (Rules == kDynamicRules) {
+      return (rules & mask) != 0;
+    } else {
+      return (Rules & mask) != 0;
+    }
+  }
+  [[nodiscard]] constexpr bool enabled(config::RuleIndex rule) const noexcept {
+    return any_enabled(config::rule_bit(rule));
+  }
+};
+
+// Calls fn with the context instantiation matching the hand and the tables'
+// enabled rules: the all-rules set (every preset) has its own kernel, any
+// other mask runs the kDynamicRules one. Chosen once per entry-point call.
+template <typename Policy = NoInstrumentation, typename Fn>
+decltype(auto) with_context(const PenaltyTables& tables, domain::Hand hand,
+                            Fn&& fn, Policy policy = {}) {
+  const HandPenaltyTable& table = tables.for_hand(hand);
+  const config::RuleMask rules = tables.enabled_rules();
+  auto for_hand = [&]<domain::Hand H>() -> decltype(auto) {
+    if (rules == config::kAllRules) {
+      return fn(EvaluationContext<H, config::kAllRules, Policy>{table, rules,
+                                                                policy});
+    }
+    return fn(EvaluationContext<H, kDynamicRules, Policy>{table, rules,
+                                                          policy});
+  };
+  if (hand == domain::Hand::kLeft) {
+    return for_hand.template operator()<domain::Hand::kLeft>();
+  }
+  return for_hand.template operator()<domain::Hand::kRight>();
+}
+
+// Same table, hand and rules, recording with the opposite sign
+template <domain::Hand H, config::RuleMask Rules, typename Policy>
+EvaluationContext<H, Rules, Policy> reversed(
+    const EvaluationContext<H, Rules, Policy>& ctx) {
+  return {ctx.table, ctx.rules, ctx.policy.reversed()};
+}
+
+// Passes a rule result through, reporting it to the policy
+template <typename Context>
+double tally(const Context& ctx, config::RuleIndex rule, double penalty) {
+  if constexpr (Context::PolicyType::kEnabled) {
+    ctx.policy.record(rule, penalty);
+  }
+  return penalty;
+}
+
+// A source of finger assignments for the playable slices of an EvalPiece.
+// slice_count() is the number of leading slices that carry a fingering.
+template <typename T>
+concept FingerSource = requires(const T& source, size_t index) {
+  { source.slice_count() } -> std::convertible_to<size_t>;
+  {
+    source.finger(index, index)
+  } -> std::same_as<std::optional<domain::Finger>>;
+};
+
+// Adapts the public one-Fingering-per-slice representation
+class FingeringVectorSource {
+ public:
+  FingeringVectorSource(const EvalPiece& piece,
+                        const std::vector<domain::Fingering>& fingerings)
+      : fingerings_(&fingerings),
+        slice_count_(std::min(piece.slice_count(), fingerings.size())) {}
+
+  [[nodiscard]] size_t slice_count() const noexcept { return slice_count_; }
+
+  [[nodiscard]] std::optional<domain::Finger> finger(size_t slice,
+                                                     size_t note) const {
+    const auto& fingering = (*fingerings_)[slice];
+    if (note >= fingering.size()) {
+      return std::nullopt;
+    }
+    return *(fingering.begin() + static_cast<std::ptrdiff_t>(note));
+  }
+
+ private:
+  const std::vector<domain::Fingering>* fingerings_;
+  size_t slice_count_;
+};
+
+// Adapts the packed per-hand sequence
+class PackedSequenceSource {
+ public:
+  PackedSequenceSource(const EvalPiece& piece,
+                       const domain::PackedFingeringSequence& fingerings)
+      : fingerings_(&fingerings),
+        slice_count_(std::min(piece.slice_count(), fingerings.size())) {}
+
+  [[nodiscard]] size_t slice_count() const noexcept { return slice_count_; }
+
+  [[nodiscard]] std::optional<domain::Finger> finger(size_t slice,
+                                                     size_t note) const {
+    return (*fingerings_)[slice][note];
+  }
+
+ private:
+  const domain::PackedFingeringSequence* fingerings_;
+  size_t slice_count_;
+};
+
+// Views another source with a single note reassigned
+template <FingerSource Base>
+class OverrideSource {
+ public:
+  OverrideSource(const Base& base, size_t slice, size_t note,
+                 domain::Finger finger)
+      : base_(&base), slice_(slice), note_(note), finger_(finger) {}
+
+  [[nodiscard]] size_t slice_count() const noexcept {
+    return base_->slice_count();
+  }
+
+  [[nodiscard]] std::optional<domain::Finger> finger(size_t slice,
+                                                     size_t note) const {
+    if (slice == slice_ && note == note_) {
+      return finger_;
+    }
+    return base_->finger(slice, note);
+  }
+
+ private:
+  const Base* base_;
+  size_t slice_;
+  size_t note_;
+  domain::Finger finger_;
+};
+
+// Penalties owned by a single slice: Rule 5 for every fingered note and the
+// chord-internal Rule 14 pairs. Also reports the first fingered note, which
+// is the only note of the slice that sequential rules consider.
+struct SliceScore {
+  double penalty{0.0};
+  std::optional<NoteInfo> sequential_note;
+};
+
+// The slice-local part of SliceScore for the fingered notes of one slice
+template <typename Context>
+double chord_penalty(
+    const std::array<NoteInfo, domain::kMaxNotesPerSlice>& chord_notes,
+    size_t chord_size, const Context& ctx) {
+  double penalty = 0.0;
+  if (ctx.enabled(config::RuleIndex::kFourthFingerUsage)) {
+    for (size_t j = 0; j < chord_size; ++j) {
+      penalty += tally(ctx, config::RuleIndex::kFourthFingerUsage,
+                       apply_rule_5(chord_notes[j].finger));
+    }
+  }
+
+  // Rule 14: all note pairs within the chord
+  if (ctx.enabled(config::RuleIndex::kChordDistanceDoubled)) {
+    for (size_t j = 0; j < chord_size; ++j) {
+      for (size_t k = j + 1; k < chord_size; ++k) {
+        const auto& cn1 = chord_notes[j];
+        const auto& cn2 = chord_notes[k];
+        if constexpr (requires { ctx.policy.record_chord({}); }) {
+          ctx.policy.record_chord(ctx.table.chord_parts(
+              cn1.finger, cn2.finger, cn2.pitch - cn1.pitch));
+        }
+        penalty += tally(ctx, config::RuleIndex::kChordDistanceDoubled,
+                         ctx.table.chord_penalty(cn1.finger, cn2.finger,
+                                                 cn2.pitch - cn1.pitch));
+      }
+    }
+  }
+  return penalty;
+}
+
+template <FingerSource Source, typename Context>
+SliceScore score_slice(const EvalPiece& piece, size_t slice,
+                       const Source& fingers,
+                       const Context& ctx) {
+  std::array<NoteInfo, domain::kMaxNotesPerSlice> chord_notes{};
+  size_t chord_size = 0;
+
+  const size_t begin = piece.slice_begin(slice);
+  const size_t count = piece.slice_size(slice);
+  for (size_t k = 0; k < count; ++k) {
+    if (auto finger = fingers.finger(slice, k); finger.has_value()) {
+      chord_notes[chord_size++] = {*finger, piece.pitch(begin + k),
+                                   piece.is_black(begin + k)};
+    }
+  }
+
+  SliceScore result;
+  if (chord_size == 0) {
+    return result;
+  }
+  result.sequential_note = chord_notes[0];
+  result.penalty = chord_penalty(chord_notes, chord_size, ctx);
+  return result;
+}
+
+// Rules 1, 2 and 13, which share one table lookup
+inline constexpr config::RuleMask kDistanceRules =
+    config::rule_bit(config::RuleIndex::kComfortDistance) |
+    config::rule_bit(config::RuleIndex::kRelaxedDistance) |
+    config::rule_bit(config::RuleIndex::kPracticalDistance);
+
+// Compute Rule 11 parameters from two notes
+inline Rule11Params compute_rule11_params(const NoteInfo& n1,
+                                          const NoteInfo& n2) {
+  if (n1.pitch < n2.pitch) {
+    return {n1.pitch, n1.is_black, n1.finger, n2.pitch, n2.is_black, n2.finger};
+  }
+  return {n2.pitch, n2.is_black, n2.finger, n1.pitch, n1.is_black, n1.finger};
+}
+
+// Apply two-note rules between a pair of consecutive notes
+template <typename Context>
+double apply_pair_penalties(const NoteInfo& n1, const NoteInfo& n2,
+                            const NoteInfo* prev_note,
+                            const Context& ctx) {
+  using config::RuleIndex;
+  double penalty = 0.0;
+
+  if (ctx.enabled(RuleIndex::kThirdFourthConsecutive)) {
+    penalty += tally(ctx, RuleIndex::kThirdFourthConsecutive,
+                     apply_rule_6(n1.finger, n2.finger));
+  }
+  if (ctx.enabled(RuleIndex::kThirdWhiteFourthBlack)) {
+    penalty += tally(
+        ctx, RuleIndex::kThirdWhiteFourthBlack,
+        apply_rule_7(n1.finger, n1.is_black, n2.finger, n2.is_black));
+  }
+
+  if (ctx.enabled(RuleIndex::kThumbOnBlack)) {
+    std::optional<bool> prev_black =
+        (prev_note != nullptr) ? std::optional<bool>(prev_note->is_black)
+                               : std::nullopt;
+    std::optional<bool> next_black = n2.is_black;
+    penalty += tally(
+        ctx, RuleIndex::kThumbOnBlack,
+        apply_rule_8(n1.finger, n1.is_black, prev_black, next_black));
+  }
+
+  if (ctx.enabled(RuleIndex::kFifthOnBlack)) {
+    penalty += tally(ctx, RuleIndex::kFifthOnBlack,
+                     apply_rule_9(n1.finger, n1.is_black, n2.is_black));
+    penalty += tally(ctx, RuleIndex::kFifthOnBlack,
+                     apply_rule_9(n2.finger, n2.is_black, n1.is_black));
+  }
+
+  if (ctx.enabled(RuleIndex::kThumbCrossingSameLevel)) {
+    bool crossing = is_crossing<Context::kHand>(n1.finger, n1.pitch,
+                                                n2.finger, n2.pitch);
+    penalty += tally(ctx, RuleIndex::kThumbCrossingSameLevel,
+                     apply_rule_10(crossing, n1.is_black, n2.is_black));
+  }
+
+  if (ctx.enabled(RuleIndex::kThumbBlackCrossedByWhite)) {
+    auto params = compute_rule11_params(n1, n2);
+    penalty += tally(ctx, RuleIndex::kThumbBlackCrossedByWhite,
+                     apply_rule_11(params));
+  }
+
+  // Zero weights are already folded into the distance table
+  if (ctx.any_enabled(kDistanceRules)) {
+    int actual_distance = n2.pitch - n1.pitch;
+    if constexpr (Context::PolicyType::kEnabled) {
+      const auto parts =
+          ctx.table.distance_parts(n1.finger, n2.finger, actual_distance);
+      if (ctx.enabled(RuleIndex::kComfortDistance)) {
+        ctx.policy.record(RuleIndex::kComfortDistance, parts.comfort);
+      }
+      if (ctx.enabled(RuleIndex::kRelaxedDistance)) {
+        ctx.policy.record(RuleIndex::kRelaxedDistance, parts.relaxed);
+      }
+      if (ctx.enabled(RuleIndex::kPracticalDistance)) {
+        ctx.policy.record(RuleIndex::kPracticalDistance, parts.practical);
+      }
+    }
+    penalty +=
+        ctx.table.distance_penalty(n1.finger, n2.finger, actual_distance);
+  }
+
+  return penalty;
+}
+
+// Apply three-note rules on a triplet of consecutive notes
+template <typename Context>
+double apply_triplet_penalties(const NoteInfo& n1, const NoteInfo& n2,
+                               const NoteInfo& n3,
+                               const Context& ctx) {
+  using config::RuleIndex;
+  double penalty = 0.0;
+
+  TripletContext triplet{n1.pitch,  n2.pitch,  n3.pitch,
+                         n1.finger, n2.finger, n3.finger};
+
+  if (ctx.enabled(RuleIndex::kHandPositionChange)) {
+    penalty += tally(ctx, RuleIndex::kHandPositionChange,
+                     ctx.table.rule_3(triplet));
+  }
+
+  if (ctx.enabled(RuleIndex::kTripletComfortExceeds)) {
+    int span = n3.pitch - n1.pitch;
+    penalty += tally(ctx, RuleIndex::kTripletComfortExceeds,
+                     ctx.table.rule_4(n1.finger, n3.finger, span));
+  }
+
+  if (ctx.enabled(RuleIndex::kSameFingerReuse)) {
+    penalty +=
+        tally(ctx, RuleIndex::kSameFingerReuse, apply_rule_12(triplet));
+  }
+
+  if (ctx.enabled(RuleIndex::kSamePitchDifferentFinger)) {
+    penalty += tally(
+        ctx, RuleIndex::kSamePitchDifferentFinger,
+        apply_rule_15(n1.finger, n2.finger, n1.pitch, n2.pitch));
+  }
+
+  return penalty;
+}
+
+// Finger source holding a single slice, for the decomposed cost terms
+class SingleSliceSource {
+ public:
+  SingleSliceSource(size_t slice, domain::PackedFingering fingering)
+      : slice_(slice), fingering_(fingering) {}
+
+  [[nodiscard]] size_t slice_count() const noexcept { return slice_ + 1; }
+
+  [[nodiscard]] std::optional<domain::Finger> finger(size_t slice,
+                                                     size_t note) const {
+    if (slice != slice_) {
+      return std::nullopt;
+    }
+    return fingering_[note];
+  }
+
+ private:
+  size_t slice_;
+  domain::PackedFingering fingering_;
+};
+
+// First fingered note of a slice, the one sequential rules consider
+inline std::optional<NoteInfo> leading_note(const EvalPiece& piece,
+                                            size_t slice,
+                                            domain::PackedFingering fingering) {
+  const size_t begin = piece.slice_begin(slice);
+  for (size_t k = 0; k < piece.slice_size(slice); ++k) {
+    if (auto finger = fingering[k]; finger.has_value()) {
+      return NoteInfo{*finger, piece.pitch(begin + k),
+                      piece.is_black(begin + k)};
+    }
+  }
+  return std::nullopt;
+}
+
+// Part of Rule 8 for the pair (n1, n2) that depends on the key colour of
+// the note before n1. Charged to the triplet term, so a transition depends
+// on its two notes alone.
+template <typename Context>
+double rule_8_lead_in(const NoteInfo& before, const NoteInfo& n1,
+                      const NoteInfo& n2, const Context& ctx) {
+  if (!ctx.enabled(config::RuleIndex::kThumbOnBlack)) {
+    return 0.0;
+  }
+  return apply_rule_8(n1.finger, n1.is_black, before.is_black, n2.is_black) -
+         apply_rule_8(n1.finger, n1.is_black, std::nullopt, n2.is_black);
+}
+
+// Full evaluation rule by rule: a single pass with a sliding window over the
+// last two sequential notes. Used when every rule result is reported.
+template <FingerSource Source, typename Context>
+double evaluate_scalar(const EvalPiece& piece, const Source& fingers,
+                       const Context& ctx) {
+  double total_penalty = 0.0;
+
+  NoteInfo prev_prev{};
+  NoteInfo prev{};
+  size_t sequential_count = 0;
+
+  const size_t limit = fingers.slice_count();
+  for (size_t slice = 0; slice < limit; ++slice) {
+    auto score = score_slice(piece, slice, fingers, ctx);
+    total_penalty += score.penalty;
+    if (!score.sequential_note.has_value()) {
+      continue;
+    }
+
+    const NoteInfo& note = *score.sequential_note;
+    if (sequential_count >= 1) {
+      total_penalty += apply_pair_penalties(
+          prev, note, (sequential_count >= 2) ? &prev_prev : nullptr, ctx);
+    }
+    if (sequential_count >= 2) {
+      total_penalty += apply_triplet_penalties(prev_prev, prev, note, ctx);
+    }
+    prev_prev = prev;
+    prev = note;
+    ++sequential_count;
+  }
+
+  return total_penalty;
+}
+
+// Sequential notes in structure-of-arrays form, scored a block at a time.
+// The first `carried` entries repeat the last two notes of the previous
+// block so that pair and triplet terms straddle block boundaries.
+inline constexpr size_t kBlockNotes = 64;
+
+struct SequentialBlock {
+  static constexpr size_t kCapacity = kBlockNotes + 2;
+
+  std::array<std::uint8_t, kCapacity> finger{};
+  std::array<std::uint8_t, kCapacity> black{};
+  std::array<int, kCapacity> pitch{};
+  size_t size{0};
+  size_t carried{0};
+
+  void push_back(const NoteInfo& note) noexcept {
+    finger[size] = static_cast<std::uint8_t>(domain::to_int(note.finger));
+    black[size] = note.is_black ? 1 : 0;
+    pitch[size] = note.pitch;
+    ++size;
+  }
+
+  // Keeps the last two notes as the context of the next block
+  void carry() noexcept {
+    const size_t keep = std::min<size_t>(size, 2);
+    for (size_t i = 0; i < keep; ++i) {
+      finger[i] = finger[size - keep + i];
+      black[i] = black[size - keep + i];
+      pitch[i] = pitch[size - keep + i];
+    }
+    size = keep;
+    carried = keep;
+  }
+};
+
+// Key of the tabulated Rules 6-11 for the transition from (f1, b1, p1) to
+// (f2, b2, p2); `previous` is HandPenaltyTable::kNoPrevious or one plus the
+// colour of the note before
+inline std::uint16_t transition_key(unsigned f1, unsigned b1, int p1,
+                                    unsigned f2, unsigned b2, int p2,
+                                    unsigned previous) noexcept {
+  const unsigned step = static_cast<unsigned>(p2 == p1) +
+                        2U * static_cast<unsigned>(p2 < p1);
+  return static_cast<std::uint16_t>(
+      HandPenaltyTable::transition_index(f1, b1, f2, b2, step, previous));
+}
+
+// Triplet rules from the tables, with the monotonic test shared by Rules 3
+// and 12. Fingers are to_int() values; the rule conditions mirror rules.cpp
+// and are checked against the scalar path by the tests.
+template <typename Context>
+double tabulated_triplet(std::uint8_t f1, std::uint8_t f2, std::uint8_t f3,
+                         int p1, int p2, int p3, const Context& ctx) {
+  using config::RuleIndex;
+  const auto finger = [](std::uint8_t f) {
+    return static_cast<domain::Finger>(f);
+  };
+  const bool monotonic = (p1 < p2 && p2 < p3) || (p1 > p2 && p2 > p3);
+  double penalty = 0.0;
+  if (ctx.enabled(RuleIndex::kHandPositionChange)) {
+    const std::uint8_t flags =
+        ctx.table.rule_3_flags(finger(f1), finger(f2), p3 - p1);
+    const bool outside_comfort =
+        (flags & HandPenaltyTable::kOutsideComfort) != 0;
+    const bool pivot = (flags & HandPenaltyTable::kOutsidePractical) != 0 &&
+                       finger(f2) == domain::Finger::kThumb && monotonic;
+    const bool substitution = p1 == p3 && f1 != f3;
+    penalty += (outside_comfort ? 1.0 : 0.0) + (pivot ? 1.0 : 0.0) +
+               (substitution ? 1.0 : 0.0);
+  }
+  if (ctx.enabled(RuleIndex::kTripletComfortExceeds)) {
+    penalty += ctx.table.rule_4(finger(f1), finger(f3), p3 - p1);
+  }
+  if (ctx.enabled(RuleIndex::kSameFingerReuse)) {
+    penalty += (p1 != p3 && f1 == f3 && monotonic) ? 1.0 : 0.0;
+  }
+  if (ctx.enabled(RuleIndex::kSamePitchDifferentFinger)) {
+    penalty += (f1 != f2 && p1 == p2) ? 1.0 : 0.0;
+  }
+  return penalty;
+}
+
+// Sequential terms of the block's new notes. Keys of the tabulated Rules
+// 6-11 are computed in a separate branch-free pass the compiler can
+// vectorize; the remaining loops are plain table lookups.
+template <typename Context>
+double score_block(const SequentialBlock& block, const Context& ctx) {
+  const auto& f = block.finger;
+  const auto& b = block.black;
+  const auto& p = block.pitch;
+  const size_t n = block.size;
+  double penalty = 0.0;
+
+  const size_t first_pair = std::max<size_t>(block.carried, 1);
+  std::array<std::uint16_t, SequentialBlock::kCapacity> keys{};
+  for (size_t i = std::max<size_t>(first_pair, 2); i < n; ++i) {
+    keys[i] = transition_key(f[i - 1], b[i - 1], p[i - 1], f[i], b[i], p[i],
+                             1U + b[i - 2]);
+  }
+  if (first_pair == 1 && n > 1) {
+    keys[1] = transition_key(f[0], b[0], p[0], f[1], b[1], p[1],
+                             HandPenaltyTable::kNoPrevious);
+  }
+  for (size_t i = first_pair; i < n; ++i) {
+    penalty += ctx.table.transition_penalty(keys[i]);
+  }
+
+  if (ctx.any_enabled(kDistanceRules)) {
+    for (size_t i = first_pair; i < n; ++i) {
+      penalty += ctx.table.distance_penalty(
+          static_cast<domain::Finger>(f[i - 1]),
+          static_cast<domain::Finger>(f[i]), p[i] - p[i - 1]);
+    }
+  }
+
+  for (size_t i = std::max<size_t>(block.carried, 2); i < n; ++i) {
+    penalty += tabulated_triplet(f[i - 2], f[i - 1], f[i], p[i - 2],
+                                 p[i - 1], p[i], ctx);
+  }
+  return penalty;
+}
+
+// Full evaluation over SequentialBlocks; same result as evaluate_scalar()
+// with the non-distance pair rules fused into one lookup per transition
+template <FingerSource Source, typename Context>
+double evaluate_blocked(const EvalPiece& piece, const Source& fingers,
+                        const Context& ctx) {
+  double total_penalty = 0.0;
+  SequentialBlock block;
+
+  const size_t limit = fingers.slice_count();
+  for (size_t slice = 0; slice < limit; ++slice) {
+    auto score = score_slice(piece, slice, fingers, ctx);
+    total_penalty += score.penalty;
+    if (!score.sequential_note.has_value()) {
+      continue;
+    }
+    block.push_back(*score.sequential_note);
+    if (block.size == SequentialBlock::kCapacity) {
+      total_penalty += score_block(block, ctx);
+      block.carry();
+    }
+  }
+  total_penalty += score_block(block, ctx);
+
+  return total_penalty;
+}
+
+// Full evaluation; the production instantiation takes the blocked path,
+// instrumented ones need the rule-by-rule breakdown
+template <FingerSource Source, typename Context>
+double evaluate_full(const EvalPiece& piece, const Source& fingers,
+                     const Context& ctx) {
+  if constexpr (Context::PolicyType::kEnabled) {
+    return evaluate_scalar(piece, fingers, ctx);
+  } else {
+    return evaluate_blocked(piece, fingers, ctx);
+  }
+}
+
+// Full evaluation of every candidate of a population into totals, one slice
+// at a time. The slice's pitches and colours are loaded once for all
+// candidates. Each candidate keeps its last two sequential notes in its own
+// slot of per-candidate arrays, so the loops run across candidates rather
+// than along the piece. Same terms as evaluate_blocked().
+template <typename Context>
+void evaluate_population(const EvalPiece& piece,
+                         const FingeringPopulation& population,
+                         const Context& ctx, std::span<double> totals) {
+  const size_t size = population.size();
+  std::fill(totals.begin(), totals.end(), 0.0);
+  // Sequential notes so far, capped at 2, and the last two of them
+  std::vector<std::uint8_t> count(size, 0);
+  std::vector<NoteInfo> before(size);
+  std::vector<NoteInfo> previous(size);
+  // This slice's leading note per candidate, if it fingers one
+  std::vector<NoteInfo> lead(size);
+  std::vector<std::uint8_t> has_lead(size, 0);
+
+  for (size_t slice = 0; slice < population.slice_count(); ++slice) {
+    const size_t begin = piece.slice_begin(slice);
+    const size_t notes = piece.slice_size(slice);
+    std::array<int, domain::kMaxNotesPerSlice> pitch{};
+    std::array<bool, domain::kMaxNotesPerSlice> black{};
+    for (size_t k = 0; k < notes; ++k) {
+      pitch[k] = piece.pitch(begin + k);
+      black[k] = piece.is_black(begin + k);
+    }
+    const auto states = population.slice(slice);
+
+    // Slice-local rules
+    for (size_t c = 0; c < size; ++c) {
+      std::array<NoteInfo, domain::kMaxNotesPerSlice> chord_notes{};
+      size_t chord_size = 0;
+      for (size_t k = 0; k < notes; ++k) {
+        if (auto finger = states[c][k]; finger.has_value()) {
+          chord_notes[chord_size++] = {*finger, pitch[k], black[k]};
+        }
+      }
+      has_lead[c] = chord_size != 0 ? 1 : 0;
+      if (chord_size != 0) {
+        lead[c] = chord_notes[0];
+        totals[c] += chord_penalty(chord_notes, chord_size, ctx);
+      }
+    }
+
+    // Sequential rules into each candidate's leading note
+    for (size_t c = 0; c < size; ++c) {
+      if (has_lead[c] == 0) {
+        continue;
+      }
+      const NoteInfo& n3 = lead[c];
+      const NoteInfo& n2 = previous[c];
+      const NoteInfo& n1 = before[c];
+      const auto f1 = static_cast<std::uint8_t>(domain::to_int(n1.finger));
+      const auto f2 = static_cast<std::uint8_t>(domain::to_int(n2.finger));
+      const auto f3 = static_cast<std::uint8_t>(domain::to_int(n3.finger));
+      double penalty = 0.0;
+      if (count[c] >= 1) {
+        const unsigned lead_in = count[c] >= 2
+                                     ? 1U + (n1.is_black ? 1U : 0U)
+                                     : HandPenaltyTable::kNoPrevious;
+        penalty += ctx.table.transition_penalty(
+            transition_key(f2, n2.is_black ? 1U : 0U, n2.pitch, f3,
+                           n3.is_black ? 1U : 0U, n3.pitch, lead_in));
+        if (ctx.any_enabled(kDistanceRules)) {
+          penalty += ctx.table.distance_penalty(n2.finger, n3.finger,
+                                                n3.pitch - n2.pitch);
+        }
+      }
+      if (count[c] >= 2) {
+        penalty +=
+            tabulated_triplet(f1, f2, f3, n1.pitch, n2.pitch, n3.pitch, ctx);
+      }
+      totals[c] += penalty;
+      before[c] = n2;
+      previous[c] = n3;
+      count[c] = static_cast<std::uint8_t>(std::min(count[c] + 1, 2));
+    }
+  }
+}
+
+// Sequential notes at offsets -2..+2 around a changed slice
+inline constexpr size_t kWindowSize = 5;
+inline constexpr size_t kWindowCenter = 2;
+
+struct SequentialWindow {
+  std::array<NoteInfo, kWindowSize> notes{};
+  std::array<bool, kWindowSize> present{};
+};
+
+// Sum of every sequential term that touches the window center
+template <typename Context>
+double window_penalty(const SequentialWindow& w,
+                      const Context& ctx) {
+  const auto& n = w.notes;
+  const auto& has = w.present;
+  double penalty = 0.0;
+
+  // Two-note rules: [prev, changed] and [changed, next]
+  if (has[1]) {
+    penalty += apply_pair_penalties(n[1], n[2], has[0] ? &n[0] : nullptr, ctx);
+  }
+  if (has[3]) {
+    penalty += apply_pair_penalties(n[2], n[3], has[1] ? &n[1] : nullptr, ctx);
+  }
+
+  // Triplets [prev-1, prev, changed], [prev, changed, next] and
+  // [changed, next, next+1]
+  if (has[0] && has[1]) {
+    penalty += apply_triplet_penalties(n[0], n[1], n[2], ctx);
+  }
+  if (has[1] && has[3]) {
+    penalty += apply_triplet_penalties(n[1], n[2], n[3], ctx);
+  }
+  if (has[3] && has[4]) {
+    penalty += apply_triplet_penalties(n[2], n[3], n[4], ctx);
+  }
+
+  return penalty;
+}
+
+// Build the window of sequential notes around `center`. Returns nullopt if a
+// slice inside the window has no fingered note, since sequential positions
+// would then no longer line up with slice positions.
+template <FingerSource Source>
+std::optional<SequentialWindow> build_window(const EvalPiece& piece,
+                                             const Source& fingers,
+                                             size_t center) {
+  SequentialWindow window;
+  const size_t limit = fingers.slice_count();
+  for (size_t w = 0; w < kWindowSize; ++w) {
+    if (center + w < kWindowCenter || center + w - kWindowCenter >= limit) {
+      continue;
+    }
+    const size_t slice = center + w - kWindowCenter;
+    const size_t begin = piece.slice_begin(slice);
+    const size_t count = piece.slice_size(slice);
+    for (size_t k = 0; k < count; ++k) {
+      if (auto finger = fingers.finger(slice, k); finger.has_value()) {
+        window.notes[w] = {*finger, piece.pitch(begin + k),
+                           piece.is_black(begin + k)};
+        window.present[w] = true;
+        break;
+      }
+    }
+    if (!window.present[w]) {
+      return std::nullopt;
+    }
+  }
+  return window;
+}
+
+// Local score change between two finger sources that differ only at
+// (slice, note). Returns nullopt when the neighborhood does not line up
+// slice-for-slice and the caller has to fall back to full evaluation.
+template <FingerSource Old, FingerSource New, typename Context>
+std::optional<double> local_delta(const EvalPiece& piece,
+                                  const Old& old_fingers,
+                                  const New& new_fingers, size_t slice,
+                                  size_t note,
+                                  const Context& ctx) {
+  // The changed slice must lead with a fingered note in both
+  if (!old_fingers.finger(slice, 0).has_value() ||
+      !new_fingers.finger(slice, 0).has_value()) {
+    return std::nullopt;
+  }
+
+  std::optional<SequentialWindow> old_window;
+  std::optional<SequentialWindow> new_window;
+  if (note == 0) {
+    old_window = build_window(piece, old_fingers, slice);
+    new_window = build_window(piece, new_fingers, slice);
+    if (!old_window.has_value() || !new_window.has_value()) {
+      return std::nullopt;
+    }
+  }
+
+  // Slice-local rules (5 and 14); the old side is recorded negated
+  const auto old_ctx = reversed(ctx);
+  double old_penalty = score_slice(piece, slice, old_fingers, old_ctx).penalty;
+  double new_penalty = score_slice(piece, slice, new_fingers, ctx).penalty;
+
+  // Sequential rules: only for first note in slice
+  if (note == 0) {
+    old_penalty += window_penalty(*old_window, old_ctx);
+    new_penalty += window_penalty(*new_window, ctx);
+  }
+
+  return new_penalty - old_penalty;
+}
+
+// Deltas for reassigning (slice, note) to each finger, entry f-1 for Finger f.
+// The neighbor loads (old slice score and sequential window) are shared by
+// all five candidates. The current finger and fingers already used elsewhere
+// in the chord are not legal replacements and score +infinity.
+template <FingerSource Source, typename Context>
+std::array<double, domain::kFingerCount> neighborhood_deltas(
+    const EvalPiece& piece, const Source& fingers, size_t slice, size_t note,
+    const Context& ctx) {
+  std::array<double, domain::kFingerCount> deltas{};
+  std::array<bool, domain::kFingerCount> legal{};
+  legal.fill(true);
+  const size_t count = piece.slice_size(slice);
+  for (size_t k = 0; k < count; ++k) {
+    if (auto used = fingers.finger(slice, k); used.has_value()) {
+      legal[static_cast<size_t>(domain::to_int(*used) - 1)] = false;
+    }
+  }
+
+  // Same alignment requirements as local_delta()
+  const bool leads = fingers.finger(slice, 0).has_value();
+  const double old_slice = score_slice(piece, slice, fingers, ctx).penalty;
+  std::optional<SequentialWindow> window;
+  if (note == 0) {
+    window = build_window(piece, fingers, slice);
+  }
+  const bool local = leads && (note != 0 || window.has_value());
+  const double old_window = window ? window_penalty(*window, ctx) : 0.0;
+  const double old_total = local ? 0.0 : evaluate_full(piece, fingers, ctx);
+
+  for (domain::Finger finger : domain::all_fingers()) {
+    const auto f = static_cast<size_t>(domain::to_int(finger) - 1);
+    if (!legal[f]) {
+      deltas[f] = std::numeric_limits<double>::infinity();
+      continue;
+    }
+    const OverrideSource proposed(fingers, slice, note, finger);
+    if (!local) {
+      deltas[f] = evaluate_full(piece, proposed, ctx) - old_total;
+      continue;
+    }
+    double delta =
+        score_slice(piece, slice, proposed, ctx).penalty - old_slice;
+    if (window.has_value()) {
+      SequentialWindow moved = *window;
+      moved.notes[kWindowCenter].finger = finger;
+      delta += window_penalty(moved, ctx) - old_window;
+    }
+    deltas[f] = delta;
+  }
+  return deltas;
+}
+
+}  // namespace piano_fingering::evaluator::detail
+
+#endif  // PIANO_FINGERING_EVALUATOR_EVALUATION_KERNEL_H_
@@ -0,0 +1,37 @@
+#include "evaluator/fixed_cost.h"
+
+#include <cmath>
+
+namespace piano_fingering::evaluator {
+
+namespace {
+
+// Scaled weights stay well inside the 53-bit mantissa, so summed penalties
+// remain exact integers in either representation
+constexpr double kMaxScaledWeight = 1U << 24U;
+
+bool whole(double value) noexcept {
+  return value <= kMaxScaledWeight && std::floor(value) == value;
+}
+
+}  // namespace
+
+std::optional<FixedCost> fixed_point_scale(
+    const config::RuleWeights& weights) noexcept {
+  using config::RuleIndex;
+  for (FixedCost scale = 1; scale <= kMaxFixedPointScale; scale *= 2) {
+    const auto s = static_cast<double>(scale);
+    // Rule 8 adds 0.5 for a thumb on a black key
+    if (weights[RuleIndex::kThumbOnBlack] != 0.0 && !whole(0.5 * s)) {
+      continue;
+    }
+    if (whole(weights[RuleIndex::kComfortDistance] * s) &&
+        whole(weights[RuleIndex::kRelaxedDistance] * s) &&
+        whole(weights[RuleIndex::kPracticalDistance] * s)) {
+      return scale;
+    }
+  }
+  return std::nullopt;
+}
+
+}  // namespace piano_fingering::evaluator
@@ -0,0 +1,197 @@
+#include "evaluator/incremental_evaluation.h"
+
+#include <algorithm>
+#include <array>
+#include <stdexcept>
+#include <utility>
+
+#include "evaluation_kernel.h"
+
+namespace piano_fingering::evaluator {
+
+namespace {
+
+// Finger source over the session's flat per-note array
+class FlatSource {
+ public:
+  FlatSource(const EvalPiece& piece, const std::vector<std::uint8_t>& fingers,
+             size_t slice_count)
+      : piece_(&piece), fingers_(&fingers), slice_count_(slice_count) {}
+
+  [[nodiscard]] size_t slice_count() const noexcept { return slice_count_; }
+
+  [[nodiscard]] std::optional<domain::Finger> finger(size_t slice,
+                                                     size_t note) const {
+    const std::uint8_t value = (*fingers_)[piece_->slice_begin(slice) + note];
+    if (value == 0) {
+      return std::nullopt;
+    }
+    return static_cast<domain::Finger>(value);
+  }
+
+ private:
+  const EvalPiece* piece_;
+  const std::vector<std::uint8_t>* fingers_;
+  size_t slice_count_;
+};
+
+}  // namespace
+
+IncrementalEvaluation::IncrementalEvaluation(const ScoreEvaluator& evaluator,
+                                             const EvalPiece& piece,
+                                             size_t slice_count)
+    : piece_(&piece),
+      tables_(&evaluator.tables()),
+      slice_count_(std::min(piece.slice_count(), slice_count)),
+      fingers_(piece.note_count(), 0) {}
+
+IncrementalEvaluation::IncrementalEvaluation(
+    const ScoreEvaluator& evaluator, const EvalPiece& piece,
+    const std::vector<domain::Fingering>& fingerings)
+    : IncrementalEvaluation(evaluator, piece, fingerings.size()) {
+  const detail::FingeringVectorSource source(piece, fingerings);
+  for (size_t slice = 0; slice < slice_count_; ++slice) {
+    const size_t begin = piece.slice_begin(slice);
+    for (size_t k = 0; k < piece.slice_size(slice); ++k) {
+      if (auto finger = source.finger(slice, k); finger.has_value()) {
+        fingers_[begin + k] =
+            static_cast<std::uint8_t>(domain::to_int(*finger));
+      }
+    }
+  }
+  refresh();
+}
+
+IncrementalEvaluation::IncrementalEvaluation(
+    const ScoreEvaluator& evaluator, const EvalPiece& piece,
+    const domain::PackedFingeringSequence& fingerings)
+    : IncrementalEvaluation(evaluator, piece, fingerings.size()) {
+  for (size_t slice = 0; slice < slice_count_; ++slice) {
+    const size_t begin = piece.slice_begin(slice);
+    const std::uint16_t bits = fingerings[slice].bits();
+    for (size_t k = 0; k < piece.slice_size(slice); ++k) {
+      fingers_[begin + k] = static_cast<std::uint8_t>(
+          (bits >> (k * domain::PackedFingering::kBitsPerNote)) &
+          domain::PackedFingering::kNoteMask);
+    }
+  }
+  refresh();
+}
+
+void IncrementalEvaluation::check_location(size_t slice, size_t note) const {
+  if (slice >= slice_count_ || note >= piece_->slice_size(slice)) {
+    throw std::out_of_range("Incremental evaluation location out of range");
+  }
+}
+
+std::optional<domain::Finger> IncrementalEvaluation::finger(
+    size_t slice, size_t note) const {
+  check_location(slice, note);
+  return FlatSource(*piece_, fingers_, slice_count_).finger(slice, note);
+}
+
+double IncrementalEvaluation::delta(const SliceLocation& location,
+                                    domain::Finger finger) {
+  const size_t slice = location.fingering_idx;
+  const size_t note = location.note_idx_in_slice;
+  check_location(slice, note);
+
+  const size_t flat = piece_->slice_begin(slice) + note;
+  const auto new_value = static_cast<std::uint8_t>(domain::to_int(finger));
+  Move move{flat, fingers_[flat], new_value, 0.0};
+
+  if (move.old_finger != move.new_finger) {
+    const FlatSource current(*piece_, fingers_, slice_count_);
+    const detail::OverrideSource proposed(current, slice, note, finger);
+
+    move.delta = detail::with_context(
+        *tables_, piece_->hand(), [&](const auto& ctx) {
+          auto local =
+              detail::local_delta(*piece_, current, proposed, slice, note, ctx);
+          // Unaligned neighborhoods (unfingered slices nearby) are rare;
+          // rescore
+          return local.has_value()
+                     ? *local
+                     : detail::evaluate_full(*piece_, proposed, ctx) - total_;
+        });
+  }
+
+  pending_ = move;
+  return move.delta;
+}
+
+ScoreEvaluator::FingerDeltas IncrementalEvaluation::neighborhood(
+    const SliceLocation& location) const {
+  const size_t slice = location.fingering_idx;
+  const size_t note = location.note_idx_in_slice;
+  check_location(slice, note);
+  const FlatSource source(*piece_, fingers_, slice_count_);
+  return detail::with_context(*tables_, piece_->hand(), [&](const auto& ctx) {
+    return detail::neighborhood_deltas(*piece_, source, slice, note, ctx);
+  });
+}
+
+void IncrementalEvaluation::apply() {
+  if (!pending_.has_value()) {
+    throw std::logic_error("No pending move to apply");
+  }
+  fingers_[pending_->note] = pending_->new_finger;
+  total_ += pending_->delta;
+  history_.push_back(*pending_);
+  pending_.reset();
+}
+
+void IncrementalEvaluation::undo() {
+  if (history_.empty()) {
+    throw std::logic_error("No applied move to undo");
+  }
+  const Move& move = history_.back();
+  fingers_[move.note] = move.old_finger;
+  total_ -= move.delta;
+  history_.pop_back();
+  pending_.reset();
+}
+
+double IncrementalEvaluation::refresh() {
+  const FlatSource source(*piece_, fingers_, slice_count_);
+  total_ = detail::with_context(*tables_, piece_->hand(), [&](const auto& ctx) {
+    return detail::evaluate_full(*piece_, source, ctx);
+  });
+  return total_;
+}
+
+std::vector<domain::Fingering> IncrementalEvaluation::fingerings() const {
+  const FlatSource source(*piece_, fingers_, slice_count_);
+  std::vector<domain::Fingering> result;
+  result.reserve(slice_count_);
+  for (size_t slice = 0; slice < slice_count_; ++slice) {
+    const size_t note_count = piece_->slice_size(slice);
+    std::array<std::optional<domain::Finger>, domain::kMaxNotesPerSlice>
+        assignments{};
+    for (size_t k = 0; k < note_count; ++k) {
+      assignments[k] = source.finger(slice, k);
+    }
+    result.emplace_back(assignments.begin(),
+                        assignments.begin() +
+                            static_cast<std::ptrdiff_t>(note_count));
+  }
+  return result;
+}
+
+domain::PackedFingeringSequence IncrementalEvaluation::packed() const {
+  domain::PackedFingeringSequence result;
+  result.reserve(slice_count_);
+  for (size_t slice = 0; slice < slice_count_; ++slice) {
+    const size_t begin = piece_->slice_begin(slice);
+    std::uint16_t bits = 0;
+    for (size_t k = 0; k < piece_->slice_size(slice); ++k) {
+      bits |= static_cast<std::uint16_t>(
+          fingers_[begin + k] << (k * domain::PackedFingering::kBitsPerNote));
+    }
+    result.push_back(domain::PackedFingering::from_bits(bits),
+                     piece_->slice_size(slice));
+  }
+  return result;
+}
+
+}  // namespace piano_fingering::evaluator
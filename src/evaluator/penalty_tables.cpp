@@ -0,0 +1,220 @@
+#include "evaluator/penalty_tables.h"
+
+#include <array>
+#include <mutex>
+#include <optional>
+#include <unordered_map>
+
+#include "config/fingerprint.h"
+
+namespace piano_fingering::evaluator {
+
+using domain::Finger;
+
+namespace {
+
+// Sum of Rules 6-11 for one transition, using representative pitches for
+// the step and skipping rules disabled by a zero weight
+double transition_rules(Finger f1, bool black1, Finger f2, bool black2,
+                        int p1, int p2, std::optional<bool> previous_black,
+                        config::RuleMask enabled, domain::Hand hand) {
+  using config::RuleIndex;
+  auto on = [enabled](RuleIndex rule) {
+    return (enabled & config::rule_bit(rule)) != 0;
+  };
+
+  double penalty = 0.0;
+  if (on(RuleIndex::kThirdFourthConsecutive)) {
+    penalty += apply_rule_6(f1, f2);
+  }
+  if (on(RuleIndex::kThirdWhiteFourthBlack)) {
+    penalty += apply_rule_7(f1, black1, f2, black2);
+  }
+  if (on(RuleIndex::kThumbOnBlack)) {
+    penalty += apply_rule_8(f1, black1, previous_black, black2);
+  }
+  if (on(RuleIndex::kFifthOnBlack)) {
+    penalty += apply_rule_9(f1, black1, black2);
+    penalty += apply_rule_9(f2, black2, black1);
+  }
+  if (on(RuleIndex::kThumbCrossingSameLevel)) {
+    penalty +=
+        apply_rule_10(is_crossing(f1, p1, f2, p2, hand), black1, black2);
+  }
+  if (on(RuleIndex::kThumbBlackCrossedByWhite)) {
+    const Rule11Params params =
+        (p1 < p2) ? Rule11Params{p1, black1, f1, p2, black2, f2}
+                  : Rule11Params{p2, black2, f2, p1, black1, f1};
+    penalty += apply_rule_11(params);
+  }
+  return penalty;
+}
+
+}  // namespace
+
+HandPenaltyTable::HandPenaltyTable(const config::DistanceMatrix& distances,
+                                   const config::RuleWeights& weights,
+                                   domain::Hand hand)
+    : distances_(distances), weights_(weights) {
+  for (Finger f1 : domain::all_fingers()) {
+    for (Finger f2 : domain::all_fingers()) {
+      const auto& d = pair(f1, f2);
+      for (int distance = config::kMinDistanceValue;
+           distance <= config::kMaxDistanceValue; ++distance) {
+        const std::size_t i = index(f1, f2, distance);
+        sequential_[i] = apply_cascading_penalty(d, distance, weights_);
+        chord_[i] = apply_chord_penalty(d, distance, weights_);
+        span_[i] = apply_rule_4(d, distance);
+        rule_3_flags_[i] = span_flags(d, distance);
+      }
+    }
+  }
+
+  // Representative (first, second) pitches for each step
+  static constexpr std::array<std::array<int, 2>, 3> kStepPitches = {
+      {{0, 1}, {0, 0}, {1, 0}}};
+  const std::array<std::optional<bool>, 3> previous_colours = {
+      std::nullopt, false, true};
+  const config::RuleMask enabled = weights_.enabled_rules();
+  for (Finger f1 : domain::all_fingers()) {
+    for (Finger f2 : domain::all_fingers()) {
+      for (unsigned colours = 0; colours < 4; ++colours) {
+        const unsigned black1 = colours >> 1U;
+        const unsigned black2 = colours & 1U;
+        for (unsigned step = 0; step < kStepPitches.size(); ++step) {
+          for (unsigned previous = 0; previous < previous_colours.size();
+               ++previous) {
+            const auto& pitches = kStepPitches[step];
+            transition_[transition_index(
+                static_cast<unsigned>(domain::to_int(f1)), black1,
+                static_cast<unsigned>(domain::to_int(f2)), black2, step,
+                previous)] =
+                transition_rules(f1, black1 != 0, f2, black2 != 0, pitches[0],
+                                 pitches[1], previous_colours[previous],
+                                 enabled, hand);
+          }
+        }
+      }
+    }
+  }
+}
+
+HandPenaltyTable::DistanceParts HandPenaltyTable::distance_parts(
+    Finger f1, Finger f2, int distance) const noexcept {
+  return cascade_parts(f1, f2, distance, 1.0);
+}
+
+HandPenaltyTable::DistanceParts HandPenaltyTable::chord_parts(
+    Finger f1, Finger f2, int distance) const noexcept {
+  return cascade_parts(f1, f2, distance, kChordMultiplier);
+}
+
+HandPenaltyTable::DistanceParts HandPenaltyTable::cascade_parts(
+    Finger f1, Finger f2, int distance, double multiplier) const noexcept {
+  // The cascade is linear in the weights, so each part is the cascade with
+  // every other weight zeroed
+  auto part = [&](config::RuleIndex rule) {
+    config::RuleWeights only{};
+    only.values[static_cast<std::size_t>(rule)] = weights_[rule];
+    return apply_cascading_penalty(pair(f1, f2), distance, only, multiplier);
+  };
+  return {part(config::RuleIndex::kComfortDistance),
+          part(config::RuleIndex::kRelaxedDistance),
+          part(config::RuleIndex::kPracticalDistance)};
+}
+
+double HandPenaltyTable::rule_3(const TripletContext& triplet) const noexcept {
+  const std::uint8_t flags =
+      rule_3_flags(triplet.f1, triplet.f2, triplet.p3 - triplet.p1);
+  double penalty = 0.0;
+
+  // 1. Base penalty: span outside comfort range
+  if ((flags & kOutsideComfort) != 0) {
+    penalty += 1.0;
+  }
+
+  // 2. Full change penalty: monotonic + thumb pivot + outside practical
+  if ((flags & kOutsidePractical) != 0 && triplet.f2 == Finger::kThumb &&
+      is_monotonic(triplet.p1, triplet.p2, triplet.p3)) {
+    penalty += 1.0;
+  }
+
+  // 3. Substitution penalty: same pitch, different finger
+  if (triplet.p1 == triplet.p3 && triplet.f1 != triplet.f3) {
+    penalty += 1.0;
+  }
+
+  return penalty;
+}
+
+namespace {
+
+struct SharedTables {
+  // The fields the tables derive from, algorithm parameters left default
+  config::Config source;
+  std::shared_ptr<const PenaltyTables> tables;
+};
+
+struct SharedTableCache {
+  std::mutex mutex;
+  std::unordered_multimap<std::uint64_t, SharedTables> entries;
+};
+
+SharedTableCache& shared_table_cache() {
+  static SharedTableCache cache;
+  return cache;
+}
+
+// Caller holds the cache mutex
+std::shared_ptr<const PenaltyTables> find_locked(
+    const SharedTableCache& cache, std::uint64_t key,
+    const config::Config& source) {
+  const auto [begin, end] = cache.entries.equal_range(key);
+  for (auto it = begin; it != end; ++it) {
+    if (it->second.source == source) {
+      return it->second.tables;
+    }
+  }
+  return nullptr;
+}
+
+}  // namespace
+
+std::shared_ptr<const PenaltyTables> shared_penalty_tables(
+    const config::Config& config) {
+  const config::Config source{config.left_hand, config.right_hand,
+                              config.weights, config::AlgorithmParameters{}};
+  const std::uint64_t key = config::penalty_fingerprint(source);
+  SharedTableCache& cache = shared_table_cache();
+  {
+    std::lock_guard lock(cache.mutex);
+    if (auto found = find_locked(cache, key, source)) {
+      return found;
+    }
+  }
+
+  // Derived outside the lock; a concurrent miss on the same config builds
+  // a duplicate and the first one stored wins
+  auto tables = std::make_shared<const PenaltyTables>(config);
+  std::lock_guard lock(cache.mutex);
+  if (auto found = find_locked(cache, key, source)) {
+    return found;
+  }
+  if (cache.entries.size() >= kMaxSharedPenaltyTables) {
+    std::erase_if(cache.entries, [](const auto& entry) {
+      return entry.second.tables.use_count() == 1;
+    });
+  }
+  if (cache.entries.size() < kMaxSharedPenaltyTables) {
+    cache.entries.emplace(key, SharedTables{source, tables});
+  }
+  return tables;
+}
+
+std::size_t shared_penalty_table_count() {
+  SharedTableCache& cache = shared_table_cache();
+  std::lock_guard lock(cache.mutex);
+  return cache.entries.size();
+}
+
+}  // namespace piano_fingering::evaluator
@@ -0,0 +1,80 @@
+#include "evaluator/rule_features.h"
+
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+#include "evaluation_kernel.h"
+
+namespace piano_fingering::evaluator {
+
+namespace {
+
+// Every rule on at weight 1, so each kernel result is the bare quantity
+config::Config unit_weight_config(const config::Config& config) {
+  config::Config unit = config;
+  unit.weights.values.fill(1.0);
+  return unit;
+}
+
+}  // namespace
+
+double RuleFeatures::score(const config::RuleWeights& weights) const noexcept {
+  using config::RuleIndex;
+  double total = 0.0;
+  for (std::size_t i = 0; i < config::kRuleCount; ++i) {
+    const double weight = weights.values[i];
+    if (weight == 0.0) {
+      continue;
+    }
+    switch (static_cast<RuleIndex>(i)) {
+      case RuleIndex::kComfortDistance:
+      case RuleIndex::kRelaxedDistance:
+      case RuleIndex::kPracticalDistance:
+        total += weight * values[i];
+        break;
+      case RuleIndex::kChordDistanceDoubled:
+        total += weights[RuleIndex::kComfortDistance] * chord.comfort +
+                 weights[RuleIndex::kRelaxedDistance] * chord.relaxed +
+                 weights[RuleIndex::kPracticalDistance] * chord.practical;
+        break;
+      default:
+        total += values[i];
+        break;
+    }
+  }
+  return total;
+}
+
+RuleFeatureExtractor::RuleFeatureExtractor(const config::Config& config)
+    : tables_(shared_penalty_tables(unit_weight_config(config))) {}
+
+RuleFeatures RuleFeatureExtractor::extract(
+    const EvalPiece& piece,
+    const std::vector<domain::Fingering>& fingerings) const {
+  RuleFeatures features;
+  detail::with_context(
+      *tables_, piece.hand(),
+      [&](const auto& ctx) {
+        return detail::evaluate_full(
+            piece, detail::FingeringVectorSource(piece, fingerings), ctx);
+      },
+      detail::RuleFeatureRecorder{&features});
+  return features;
+}
+
+RuleFeatures RuleFeatureExtractor::extract(
+    const EvalPiece& piece,
+    const domain::PackedFingeringSequence& fingerings) const {
+  RuleFeatures features;
+  detail::with_context(
+      *tables_, piece.hand(),
+      [&](const auto& ctx) {
+        return detail::evaluate_full(
+            piece, detail::PackedSequenceSource(piece, fingerings), ctx);
+      },
+      detail::RuleFeatureRecorder{&features});
+  return features;
+}
+
+}  // namespace piano_fingering::evaluator
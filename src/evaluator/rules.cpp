@@ -80,8 +80,6 @@ double apply_cascading_penalty(const config::FingerPairDistances& distances,
 double apply_chord_penalty(const config::FingerPairDistances& distances,
                            int actual_distance,
                            const config::RuleWeights& weights) {
-  // Chord context doubles penalties for Rules 1 and 2 (not Rule 13)
-  static constexpr double kChordMultiplier = 2.0;
   return apply_cascading_penalty(distances, actual_distance, weights,
                                  kChordMultiplier);
 }
@@ -125,20 +123,10 @@ double apply_rule_9(Finger f, bool is_black, bool adj_is_black) {
 }
 
 bool is_crossing(Finger f1, int pitch1, Finger f2, int pitch2, Hand hand) {
-  bool f1_is_thumb = (f1 == Finger::kThumb);
-  bool f2_is_thumb = (f2 == Finger::kThumb);
-  // Must have exactly one thumb
-  if (f1_is_thumb == f2_is_thumb) {
-    return false;
-  }
-
-  int thumb_pitch = f1_is_thumb ? pitch1 : pitch2;
-  int other_pitch = f1_is_thumb ? pitch2 : pitch1;
-
   if (hand == Hand::kRight) {
-    return thumb_pitch > other_pitch;  // Thumb higher = crossing
+    return is_crossing<Hand::kRight>(f1, pitch1, f2, pitch2);
   }
-  return thumb_pitch < other_pitch;  // Thumb lower = crossing
+  return is_crossing<Hand::kLeft>(f1, pitch1, f2, pitch2);
 }
 
 double apply_rule_10(bool is_crossing, bool note1_black, bool note2_black) {
@@ -0,0 +1,164 @@
+// src/generator/musicxml_generator.cpp - Offset-based fingering writer
+
+#include "generator/musicxml_generator.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <fstream>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "domain/finger.h"
+#include "domain/measure.h"
+#include "domain/note.h"
+#include "domain/slice.h"
+#include "trace/trace.h"
+
+namespace piano_fingering::generator {
+
+namespace {
+
+struct Insertion {
+  std::uint32_t offset;  // of the <note> element
+  domain::Finger finger;
+};
+
+bool is_space(char c) noexcept {
+  return c == ' ' || c == '\t' || c == '\n' || c == '\r';
+}
+
+// Position of the first <name ...> or <name/> tag in text, or npos
+size_t find_tag(std::string_view text, std::string_view name) noexcept {
+  for (size_t at = text.find('<'); at != std::string_view::npos;
+       at = text.find('<', at + 1)) {
+    const size_t after = at + 1 + name.size();
+    if (text.substr(at + 1, name.size()) == name && after < text.size() &&
+        (text[after] == '>' || text[after] == '/' || is_space(text[after]))) {
+      return at;
+    }
+  }
+  return std::string_view::npos;
+}
+
+void collect(const std::vector<domain::Measure>& measures,
+             const std::vector<std::uint32_t>& offsets,
+             const domain::PackedFingeringSequence& fingerings,
+             std::vector<Insertion>& insertions) {
+  size_t note_index = 0;
+  size_t playable = 0;
+  for (const domain::Measure& measure : measures) {
+    for (const domain::Slice& slice : measure) {
+      size_t played = 0;
+      for (const domain::Note& note : slice) {
+        if (note_index >= offsets.size()) {
+          throw GeneratorError("Source map has fewer notes than the piece");
+        }
+        const std::uint32_t offset = offsets[note_index++];
+        if (note.is_rest()) {
+          continue;
+        }
+        // Fingerings index playable slices and their non-rest notes
+        if (playable >= fingerings.size() ||
+            played >= fingerings.note_count(playable)) {
+          throw GeneratorError("Fingering does not match the piece");
+        }
+        if (auto finger = fingerings[playable][played]) {
+          insertions.push_back({offset, *finger});
+        }
+        ++played;
+      }
+      if (played > 0) {
+        if (played != fingerings.note_count(playable)) {
+          throw GeneratorError("Fingering does not match the piece");
+        }
+        ++playable;
+      }
+    }
+  }
+  if (note_index != offsets.size()) {
+    throw GeneratorError("Source map has more notes than the piece");
+  }
+  if (playable != fingerings.size()) {
+    throw GeneratorError("Fingering does not match the piece");
+  }
+}
+
+}  // namespace
+
+void MusicXMLGenerator::write(
+    std::ostream& out, std::string_view score, const domain::Piece& piece,
+    const domain::SourceMap& source_map,
+    const domain::PackedFingeringSequence& left_hand,
+    const domain::PackedFingeringSequence& right_hand) {
+  std::vector<Insertion> insertions;
+  collect(piece.left_hand(), source_map.left_hand, left_hand, insertions);
+  collect(piece.right_hand(), source_map.right_hand, right_hand, insertions);
+  // The hands interleave in the score
+  std::sort(insertions.begin(), insertions.end(),
+            [](const Insertion& a, const Insertion& b) {
+              return a.offset < b.offset;
+            });
+
+  size_t copied = 0;
+  for (const Insertion& insertion : insertions) {
+    const size_t note = insertion.offset;
+    if (note < copied || find_tag(score.substr(note), "note") != 0) {
+      throw GeneratorError("Source map does not match the score");
+    }
+    const size_t end = score.find("</note>", note);
+    const size_t start_tag_end = score.find('>', note);
+    if (end == std::string_view::npos || start_tag_end >= end) {
+      throw GeneratorError("Source map does not match the score");
+    }
+    const std::string_view body =
+        score.substr(start_tag_end + 1, end - start_tag_end - 1);
+    if (find_tag(body, "fingering") != std::string_view::npos) {
+      continue;
+    }
+
+    // Before any <lyric>, <play> or <listen>, otherwise last
+    size_t before = body.size();
+    for (std::string_view later : {"lyric", "play", "listen"}) {
+      before = std::min(before, find_tag(body, later));
+    }
+    // Back up over the whitespace that indents the following tag
+    while (before > 0 && is_space(body[before - 1])) {
+      --before;
+    }
+    const size_t indent_end = static_cast<size_t>(
+        std::find_if_not(body.begin(), body.end(), is_space) - body.begin());
+    const std::string_view indent = body.substr(0, indent_end);
+
+    const size_t at = start_tag_end + 1 + before;
+    out.write(score.data() + copied,
+              static_cast<std::streamsize>(at - copied));
+    out << indent << "<notations><technical><fingering>"
+        << domain::to_int(insertion.finger)
+        << "</fingering></technical></notations>";
+    copied = at;
+  }
+  out.write(score.data() + copied,
+            static_cast<std::streamsize>(score.size() - copied));
+}
+
+void MusicXMLGenerator::generate(
+    const std::filesystem::path& output_path, std::string_view score,
+    const domain::Piece& piece, const domain::SourceMap& source_map,
+    const domain::PackedFingeringSequence& left_hand,
+    const domain::PackedFingeringSequence& right_hand, bool force_overwrite) {
+  const trace::Span span("generator", "generate");
+  if (!force_overwrite && std::filesystem::exists(output_path)) {
+    throw FileExistsError(output_path.string());
+  }
+  std::ofstream file(output_path, std::ios::binary | std::ios::trunc);
+  if (!file) {
+    throw FileWriteError(output_path.string());
+  }
+  write(file, score, piece, source_map, left_hand, right_hand);
+  if (!file.flush()) {
+    throw FileWriteError(output_path.string());
+  }
+}
+
+}  // namespace piano_fingering::generator
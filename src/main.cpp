@@ -1,6 +1,154 @@
+#include <exception>
+#include <filesystem>
+#include <fstream>
 #include <iostream>
+#include <optional>
+#include <random>
+#include <string>
+#include <vector>
 
-int main() {
-  std::cout << "Piano Fingering Generator v1.0.0\n";
+#include "cli/args.h"
+#include "cli/batch.h"
+#include "cli/progress_reporter.h"
+#include "cli/server.h"
+#include "cli/stats_report.h"
+#include "config/config.h"
+#include "config/config_manager.h"
+#include "optimizer/progress.h"
+#include "trace/trace.h"
+
+namespace {
+
+using namespace piano_fingering;
+
+constexpr const char* kVersion = "Piano Fingering Generator v1.0.0\n";
+
+int print_error(const std::string& message, int exit_code) {
+  std::cerr << "piano-fingering: Error: " << message << "\n";
+  return exit_code;
+}
+
+void print_warning(const std::string& message) {
+  std::cerr << "piano-fingering: Warning: " << message << "\n";
+}
+
+config::Config load_config(const cli::Arguments& args) {
+  return args.config_path.empty()
+             ? config::ConfigManager::load_preset(args.preset)
+             : config::ConfigManager::load_custom(args.config_path,
+                                                  args.preset);
+}
+
+// Best effort: a trace that cannot be written does not fail the run
+void write_trace(const std::filesystem::path& path) {
+  trace::stop();
+  std::ofstream out(path, std::ios::binary | std::ios::trunc);
+  trace::write_chrome_trace(out);
+  if (!out.flush()) {
+    print_error("Could not write trace " + path.string(), 0);
+  }
+}
+
+int run(const cli::Arguments& args) {
+  const config::Config config = load_config(args);
+  const std::vector<cli::BatchJob> jobs =
+      args.batch ? cli::collect_batch_jobs(args.input, args.output_dir)
+                 : std::vector<cli::BatchJob>{
+                       {args.input, args.output.empty()
+                                        ? cli::default_output_path(
+                                              args.input, args.output_dir)
+                                        : args.output}};
+
+  cli::BatchOptions options;
+  options.seed = args.seed.value_or(std::random_device{}());
+  options.force_overwrite = args.force_overwrite;
+  options.threads = args.threads;
+  options.result_cache_bytes = args.result_cache_mib << 20;
+  if (!args.quiet) {
+    std::cerr << "Running " << jobs.size() << " score(s) with seed "
+              << options.seed << "\n";
+  }
+
+  // Measure progress for a single score; a batch reports per score instead
+  optimizer::ProgressChannel progress;
+  std::optional<cli::ProgressReporter> reporter;
+  if (!args.quiet && jobs.size() == 1) {
+    options.progress = &progress;
+    reporter.emplace(progress, std::cerr,
+                     cli::ProgressReporter::kDefaultInterval);
+  }
+
+  const auto results = cli::run_batch(
+      jobs, config, options, [&](const cli::BatchItemResult& result) {
+        // Ends the progress line before the summary
+        reporter.reset();
+        if (!args.quiet) {
+          for (const std::string& warning : result.warnings) {
+            print_warning(result.job.input.string() + ": " + warning);
+          }
+        }
+        if (result.exit_code != 0) {
+          print_error(result.job.input.string() + ": " + result.error,
+                      result.exit_code);
+        } else if (!args.quiet) {
+          std::cout << result.job.input.string() << " -> "
+                    << result.job.output.string()
+                    << " (score: " << result.score << ")\n";
+        }
+        if (args.stats && result.exit_code == 0) {
+          cli::write_stats(std::cerr, result.stats);
+        }
+      });
+
+  // The first failure decides the exit code
+  for (const cli::BatchItemResult& result : results) {
+    if (result.exit_code != 0) {
+      return result.exit_code;
+    }
+  }
   return 0;
 }
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+  cli::Arguments args;
+  try {
+    args = cli::parse_arguments(argc, argv);
+  } catch (const cli::ArgumentError& e) {
+    return print_error(e.what(), 1);
+  }
+  if (args.help) {
+    std::cout << cli::usage();
+    return 0;
+  }
+  if (args.version) {
+    std::cout << kVersion;
+    return 0;
+  }
+
+  if (!args.trace_path.empty()) {
+    if constexpr (!trace::kCompiledIn) {
+      return print_error(
+          "--trace needs a build configured with -DENABLE_TRACING=ON", 1);
+    }
+    trace::set_thread_name("main");
+    trace::start();
+  }
+
+  try {
+    if (args.serve) {
+      cli::Server server(args.threads, args.max_requests,
+                         args.result_cache_mib << 20);
+      server.serve(std::cin, std::cout);
+      return 0;
+    }
+    const int exit_code = run(args);
+    if (!args.trace_path.empty()) {
+      write_trace(args.trace_path);
+    }
+    return exit_code;
+  } catch (const std::exception& e) {
+    return print_error(e.what(), cli::exit_code_for(std::current_exception()));
+  }
+}
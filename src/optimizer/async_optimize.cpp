@@ -0,0 +1,30 @@
+#include "optimizer/async_optimize.h"
+
+#include <utility>
+
+namespace piano_fingering::optimizer {
+
+AsyncJob<Optimizer::Result> async_optimize(Optimizer& optimizer,
+                                           const domain::Piece& piece,
+                                           domain::Hand hand,
+                                           unsigned int seed,
+                                           Optimizer::Limits limits,
+                                           Resumer resume) {
+  return {optimizer.pool(),
+          [&optimizer, &piece, hand, seed, limits = std::move(limits)] {
+            return optimizer.optimize(piece, hand, seed, limits);
+          },
+          std::move(resume)};
+}
+
+AsyncJob<Optimizer::PieceResult> async_optimize_piece(
+    Optimizer& optimizer, const domain::Piece& piece, unsigned int seed,
+    Optimizer::Limits limits, Resumer resume) {
+  return {optimizer.pool(),
+          [&optimizer, &piece, seed, limits = std::move(limits)] {
+            return optimizer.optimize_piece(piece, seed, limits);
+          },
+          std::move(resume)};
+}
+
+}  // namespace piano_fingering::optimizer
@@ -0,0 +1,704 @@
+#include "optimizer/beam_search.h"
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <optional>
+#include <span>
+#include <stdexcept>
+#include <tuple>
+#include <vector>
+
+#include "cost_model.h"
+#include "domain/finger.h"
+#include "domain/slice.h"
+#include "evaluator/fixed_cost.h"
+#include "optimizer/memory_budget.h"
+#include "optimizer/search_stats.h"
+#include "optimizer/state_generation.h"
+#include "optimizer/thread_pool.h"
+#include "optimizer/transition_cache.h"
+#include "trace/trace.h"
+
+namespace piano_fingering::optimizer {
+
+namespace {
+
+using detail::CostModel;
+
+// Beam state; children refer to it by arena index. Cost is double, or
+// FixedCost when the evaluator selects fixed point.
+template <typename Cost>
+struct Node {
+  Cost cost;
+  std::uint32_t parent;  // unused in the first slice
+  std::uint8_t state;    // index into the slice's valid states
+  std::uint8_t lead;     // leading finger, as domain::to_int()
+};
+static_assert(sizeof(Node<double>) == 16);
+static_assert(sizeof(Node<evaluator::FixedCost>) == 16);
+
+// One value per leading finger
+template <typename Cost>
+using LeadCosts = std::array<Cost, domain::kFingerCount>;
+
+size_t lead_index(std::uint8_t lead) noexcept {
+  return static_cast<size_t>(lead - 1);
+}
+
+// Orders nodes of one slice by cost plus the lower bound on what their
+// lead still has to pay, breaking ties by predecessor and state
+template <typename Cost>
+class Cheaper {
+ public:
+  explicit Cheaper(const LeadCosts<Cost>& to_go) noexcept : to_go_(&to_go) {}
+
+  bool operator()(const Node<Cost>& a, const Node<Cost>& b) const noexcept {
+    const Cost fa = a.cost + (*to_go_)[lead_index(a.lead)];
+    const Cost fb = b.cost + (*to_go_)[lead_index(b.lead)];
+    return std::tie(fa, a.parent, a.state) < std::tie(fb, b.parent, b.state);
+  }
+
+ private:
+  const LeadCosts<Cost>* to_go_;
+};
+
+// Keeps the beam_width most promising candidates, best first. Returns how
+// many were dropped.
+template <typename Cost>
+size_t prune(std::vector<Node<Cost>>& candidates, size_t beam_width,
+             const LeadCosts<Cost>& to_go) {
+  const Cheaper<Cost> cheaper(to_go);
+  const size_t dropped =
+      candidates.size() > beam_width ? candidates.size() - beam_width : 0;
+  if (candidates.size() > beam_width) {
+    std::nth_element(candidates.begin(),
+                     candidates.begin() + static_cast<std::ptrdiff_t>(
+                                              beam_width),
+                     candidates.end(), cheaper);
+    candidates.resize(beam_width);
+  }
+  std::sort(candidates.begin(), candidates.end(), cheaper);
+  return dropped;
+}
+
+// Sequential costs of one slice boundary by leading finger, copied out of
+// the TransitionCache so parallel workers only read plain arrays
+template <typename Cost>
+struct BoundaryCosts {
+  std::array<Cost, domain::kFingerCount * domain::kFingerCount> transition;
+  std::array<Cost, domain::kFingerCount * domain::kFingerCount *
+                       domain::kFingerCount>
+      triplet;
+
+  [[nodiscard]] Cost step(bool with_triplet, size_t first, size_t prev,
+                          size_t curr) const noexcept {
+    Cost cost = transition[prev * domain::kFingerCount + curr];
+    if (with_triplet) {
+      cost += triplet[(first * domain::kFingerCount + prev) *
+                          domain::kFingerCount +
+                      curr];
+    }
+    return cost;
+  }
+};
+
+template <typename Cost>
+void fill_boundary(TransitionCache& cache, size_t slice, bool with_triplets,
+                   BoundaryCosts<Cost>& costs, CostModel<Cost> model) {
+  for (size_t a = 0; a < domain::kFingerCount; ++a) {
+    const auto first = static_cast<domain::Finger>(a + 1);
+    for (size_t b = 0; b < domain::kFingerCount; ++b) {
+      const auto second = static_cast<domain::Finger>(b + 1);
+      costs.transition[a * domain::kFingerCount + b] =
+          model(cache.transition(slice, first, second));
+      if (!with_triplets) {
+        continue;
+      }
+      for (size_t c = 0; c < domain::kFingerCount; ++c) {
+        costs.triplet[(a * domain::kFingerCount + b) * domain::kFingerCount +
+                      c] =
+            model(cache.triplet(slice, first, second,
+                                static_cast<domain::Finger>(c + 1)));
+      }
+    }
+  }
+}
+
+constexpr size_t kTableCacheSlots = 2;
+
+// Everything the search knows about the slices of its range before the
+// first expansion, indexed by depth
+template <typename Cost>
+struct Tables {
+  // intra[intra_begin[d] + s] is the intra-slice cost of state s
+  std::vector<Cost> intra;
+  std::vector<size_t> intra_begin{0};
+  std::vector<std::uint8_t> leads;
+  // Cheapest intra-slice cost and its state per leading finger
+  std::vector<LeadCosts<Cost>> min_intra;
+  std::vector<std::array<std::uint8_t, domain::kFingerCount>> best_state;
+  std::vector<BoundaryCosts<Cost>> boundaries;  // unused at depth 0
+  // Admissible bound on the cost of slices d + 1 onwards, given the lead
+  // at depth d: each later slice pays at least its cheapest intra cost for
+  // its lead, the transition into it and the cheapest triplet over
+  // whatever preceded the previous slice
+  std::vector<LeadCosts<Cost>> to_go;
+
+  [[nodiscard]] std::span<const Cost> intra_of(size_t depth) const {
+    return {intra.data() + intra_begin[depth],
+            intra_begin[depth + 1] - intra_begin[depth]};
+  }
+  [[nodiscard]] std::span<const std::uint8_t> leads_of(size_t depth) const {
+    return {leads.data() + intra_begin[depth],
+            intra_begin[depth + 1] - intra_begin[depth]};
+  }
+};
+
+// Bytes build_tables() allocates for `range`
+template <typename Cost>
+size_t table_bytes(const evaluator::EvalPiece& piece, SliceRange range) {
+  size_t states = 0;
+  for (size_t slice = range.begin; slice < range.end; ++slice) {
+    states += generate_valid_states(piece.slice_size(slice)).size();
+  }
+  constexpr size_t kPerSlice =
+      sizeof(size_t) + 2 * sizeof(LeadCosts<Cost>) +
+      sizeof(std::array<std::uint8_t, domain::kFingerCount>) +
+      sizeof(BoundaryCosts<Cost>);
+  return states * (sizeof(Cost) + sizeof(std::uint8_t)) +
+         range.size() * kPerSlice;
+}
+
+template <typename Cost>
+Tables<Cost> build_tables(const evaluator::ScoreEvaluator& evaluator,
+                          const evaluator::EvalPiece& piece, SliceRange range,
+                          SearchStats* stats, CostModel<Cost> model) {
+  constexpr Cost kInfinity = CostModel<Cost>::kInfinity;
+  const size_t slice_count = range.size();
+  Tables<Cost> tables;
+  tables.intra_begin.reserve(slice_count + 1);
+  tables.min_intra.resize(slice_count);
+  tables.best_state.resize(slice_count);
+  tables.boundaries.resize(slice_count);
+  tables.to_go.resize(slice_count);
+
+  // Each slice's matrices are read once, so the cache never needs to hold
+  // more than the current one
+  TransitionCache cache(evaluator, piece, kTableCacheSlots);
+  for (size_t depth = 0; depth < slice_count; ++depth) {
+    const size_t slice = range.begin + depth;
+    const auto states = generate_valid_states(piece.slice_size(slice));
+    LeadCosts<Cost>& min_intra = tables.min_intra[depth];
+    min_intra.fill(kInfinity);
+    for (size_t s = 0; s < states.size(); ++s) {
+      const Cost cost =
+          model(evaluator.evaluate_intra_slice(piece, {slice, states[s]}));
+      const auto lead =
+          static_cast<std::uint8_t>(domain::to_int(*states[s][0]));
+      tables.intra.push_back(cost);
+      tables.leads.push_back(lead);
+      if (cost < min_intra[lead_index(lead)]) {
+        min_intra[lead_index(lead)] = cost;
+        tables.best_state[depth][lead_index(lead)] =
+            static_cast<std::uint8_t>(s);
+      }
+    }
+    tables.intra_begin.push_back(tables.intra.size());
+    if (depth > 0) {
+      fill_boundary(cache, slice, depth >= 2, tables.boundaries[depth],
+                    model);
+    }
+  }
+  if (stats != nullptr) {
+    stats->transition_fills += cache.fill_count();
+  }
+
+  tables.to_go.back().fill(Cost{0});
+  for (size_t depth = slice_count; depth-- > 1;) {
+    const BoundaryCosts<Cost>& costs = tables.boundaries[depth];
+    for (size_t prev = 0; prev < domain::kFingerCount; ++prev) {
+      Cost best = kInfinity;
+      for (size_t curr = 0; curr < domain::kFingerCount; ++curr) {
+        Cost step = costs.step(false, 0, prev, curr);
+        if (depth >= 2) {
+          Cost cheapest_triplet = kInfinity;
+          for (size_t first = 0; first < domain::kFingerCount; ++first) {
+            cheapest_triplet = std::min(
+                cheapest_triplet,
+                costs.step(true, first, prev, curr) - step);
+          }
+          step += cheapest_triplet;
+        }
+        best = std::min(best, tables.min_intra[depth][curr] + step +
+                                  tables.to_go[depth][curr]);
+      }
+      tables.to_go[depth - 1][prev] = best;
+    }
+  }
+  return tables;
+}
+
+// Complete assignment found by following the bound greedily, one slice at
+// a time, stored in `path`; its cost, returned, is the incumbent every beam
+// node has to beat
+template <typename Cost>
+Cost greedy_incumbent(const Tables<Cost>& tables,
+                      std::vector<std::uint8_t>& path) {
+  const size_t slice_count = tables.to_go.size();
+  Cost incumbent{0};
+  path.assign(slice_count, 0);
+  size_t first = 0;
+  size_t prev = 0;
+  for (size_t depth = 0; depth < slice_count; ++depth) {
+    Cost best = CostModel<Cost>::kInfinity;
+    Cost best_step{0};
+    size_t best_lead = 0;
+    for (size_t curr = 0; curr < domain::kFingerCount; ++curr) {
+      Cost step = tables.min_intra[depth][curr];
+      if (depth > 0) {
+        step += tables.boundaries[depth].step(depth >= 2, first, prev, curr);
+      }
+      if (step + tables.to_go[depth][curr] < best) {
+        best = step + tables.to_go[depth][curr];
+        best_step = step;
+        best_lead = curr;
+      }
+    }
+    incumbent += best_step;
+    path[depth] = tables.best_state[depth][best_lead];
+    first = prev;
+    prev = best_lead;
+  }
+  return incumbent;
+}
+
+// Per-slice inputs shared read-only by every expansion chunk
+template <typename Cost>
+struct Layer {
+  bool with_triplets;  // the parents have parents of their own
+  std::span<const Cost> intra;
+  std::span<const std::uint8_t> leads;
+  const BoundaryCosts<Cost>* costs;
+  const LeadCosts<Cost>* to_go;
+  Cost bound;  // children whose optimistic total exceeds this are dropped
+};
+
+// Appends the children of arena[begin, end) that can still beat the
+// incumbent to `out`. Returns how many the bound dropped.
+template <typename Cost>
+size_t expand(const std::vector<Node<Cost>>& arena, size_t begin, size_t end,
+              const Layer<Cost>& layer, std::vector<Node<Cost>>& out) {
+  size_t dropped = 0;
+  for (size_t p = begin; p < end; ++p) {
+    const Node<Cost>& parent = arena[p];
+    const size_t prev = lead_index(parent.lead);
+    const size_t first =
+        layer.with_triplets ? lead_index(arena[parent.parent].lead) : 0;
+    for (size_t s = 0; s < layer.intra.size(); ++s) {
+      const size_t curr = lead_index(layer.leads[s]);
+      const Cost cost =
+          parent.cost + layer.intra[s] +
+          layer.costs->step(layer.with_triplets, first, prev, curr);
+      if (cost + (*layer.to_go)[curr] > layer.bound) {
+        ++dropped;
+        continue;
+      }
+      out.push_back({cost, static_cast<std::uint32_t>(p),
+                     static_cast<std::uint8_t>(s), layer.leads[s]});
+    }
+  }
+  return dropped;
+}
+
+// Below this many children a slice is expanded on the calling thread
+constexpr size_t kParallelThreshold = 4096;
+
+// How many states of each slice rank within `margin` of its most promising
+// one, each charged its intra cost, its cheapest way in from any earlier
+// leads and the bound on the rest of the range
+template <typename Cost>
+std::vector<size_t> ambiguity(const Tables<Cost>& tables, Cost margin) {
+  const size_t slice_count = tables.to_go.size();
+  std::vector<size_t> result(slice_count);
+  std::vector<Cost> rank;
+  for (size_t depth = 0; depth < slice_count; ++depth) {
+    LeadCosts<Cost> entry{};
+    if (depth > 0) {
+      const BoundaryCosts<Cost>& costs = tables.boundaries[depth];
+      entry.fill(CostModel<Cost>::kInfinity);
+      for (size_t curr = 0; curr < domain::kFingerCount; ++curr) {
+        for (size_t prev = 0; prev < domain::kFingerCount; ++prev) {
+          for (size_t first = 0; first < domain::kFingerCount; ++first) {
+            entry[curr] = std::min(
+                entry[curr], costs.step(depth >= 2, first, prev, curr));
+          }
+        }
+      }
+    }
+    const auto intra = tables.intra_of(depth);
+    const auto leads = tables.leads_of(depth);
+    rank.clear();
+    for (size_t s = 0; s < intra.size(); ++s) {
+      const size_t lead = lead_index(leads[s]);
+      rank.push_back(intra[s] + entry[lead] + tables.to_go[depth][lead]);
+    }
+    const Cost best = *std::min_element(rank.begin(), rank.end());
+    result[depth] = static_cast<size_t>(
+        std::count_if(rank.begin(), rank.end(),
+                      [&](Cost r) { return r <= best + margin; }));
+  }
+  return result;
+}
+
+// Splits total_states across the slices in proportion to their ambiguity,
+// keeping every width within [1, max_width]
+template <typename Cost>
+std::vector<size_t> adaptive_widths(const Tables<Cost>& tables,
+                                    BeamBudget budget, Cost margin) {
+  std::vector<size_t> widths = ambiguity(tables, margin);
+  size_t demand = 0;
+  for (size_t width : widths) {
+    demand += width;
+  }
+  for (size_t& width : widths) {
+    const auto share = static_cast<size_t>(
+        static_cast<long double>(budget.total_states) * width / demand);
+    width = std::clamp<size_t>(share, 1, budget.max_width);
+  }
+  return widths;
+}
+
+// Most nodes each layer can keep under `widths` capped at `cap`: a layer
+// never outgrows its width nor the children of the layer before it
+template <typename Cost>
+std::vector<size_t> layer_capacities(const Tables<Cost>& tables,
+                                     const std::vector<size_t>& widths,
+                                     size_t cap) {
+  std::vector<size_t> capacities(widths.size());
+  size_t parents = 1;
+  for (size_t depth = 0; depth < widths.size(); ++depth) {
+    parents = std::min({widths[depth], cap,
+                        parents * tables.intra_of(depth).size()});
+    capacities[depth] = parents;
+  }
+  return capacities;
+}
+
+// Nodes the search reserves up front in each of its buffers. None of them
+// grows past its reservation, so these bound its whole footprint.
+template <typename Cost>
+struct BufferSizes {
+  size_t arena{0};       // every layer
+  size_t candidates{0};  // the children of one layer
+  size_t chunk{0};       // the children of one parallel chunk
+
+  [[nodiscard]] size_t bytes(size_t chunks) const {
+    return (arena + candidates + chunks * chunk) * sizeof(Node<Cost>);
+  }
+};
+
+// Buffer sizes for the given widths capped at `cap`, expanding in up to
+// `chunks` parallel chunks (0 without a pool)
+template <typename Cost>
+BufferSizes<Cost> buffer_sizes(const Tables<Cost>& tables,
+                               const std::vector<size_t>& widths, size_t cap,
+                               size_t chunks) {
+  BufferSizes<Cost> sizes;
+  const std::vector<size_t> capacities =
+      layer_capacities(tables, widths, cap);
+  for (size_t depth = 0; depth < widths.size(); ++depth) {
+    sizes.arena += capacities[depth];
+    const size_t states = tables.intra_of(depth).size();
+    const size_t parents = depth == 0 ? 1 : capacities[depth - 1];
+    const size_t children = parents * states;
+    sizes.candidates = std::max(sizes.candidates, children);
+    if (depth > 0 && chunks > 0 && children >= kParallelThreshold) {
+      const size_t used = std::min(chunks, parents);
+      sizes.chunk =
+          std::max(sizes.chunk, (parents + used - 1) / used * states);
+    }
+  }
+  return sizes;
+}
+
+// Largest cap on the widths whose buffers fit in `available` bytes, or 0
+template <typename Cost>
+size_t affordable_cap(const Tables<Cost>& tables,
+                      const std::vector<size_t>& widths, size_t chunks,
+                      size_t available) {
+  size_t lo = 0;
+  size_t hi = *std::max_element(widths.begin(), widths.end());
+  while (lo < hi) {
+    const size_t mid = lo + (hi - lo + 1) / 2;
+    if (buffer_sizes(tables, widths, mid, chunks).bytes(chunks) <=
+        available) {
+      lo = mid;
+    } else {
+      hi = mid - 1;
+    }
+  }
+  return lo;
+}
+
+template <typename Cost>
+SearchResult search(const evaluator::ScoreEvaluator& evaluator,
+                    const evaluator::EvalPiece& piece, BeamBudget budget,
+                    bool adaptive, SliceRange range, ThreadPool* pool,
+                    MemoryBudget* memory, ThreadStats* stats,
+                    CostModel<Cost> model) {
+  if (budget.max_width == 0) {
+    throw std::invalid_argument("Beam width must be positive");
+  }
+  if (adaptive && budget.total_states == 0) {
+    throw std::invalid_argument("Beam state budget must be positive");
+  }
+  if (range.begin > range.end || range.end > piece.slice_count()) {
+    throw std::out_of_range("Beam search range outside the piece");
+  }
+  SearchResult result;
+  const size_t slice_count = range.size();
+  if (slice_count == 0) {
+    return result;
+  }
+  constexpr size_t kMaxNodes = std::numeric_limits<std::uint32_t>::max();
+  if (!adaptive && budget.max_width > kMaxNodes / slice_count) {
+    throw std::length_error("Beam search arena exceeds 2^32 states");
+  }
+
+  const trace::Span span("beam", "search", "slices",
+                         static_cast<std::int64_t>(slice_count));
+  const MemoryCharge table_charge(memory, table_bytes<Cost>(piece, range),
+                                  "Beam search tables");
+  // Everything but the parallel expansions runs on the calling thread
+  std::optional<ThreadStats::BusyTimer> busy(std::in_place, stats);
+  SearchStats* local = stats != nullptr ? &stats->local() : nullptr;
+  const Tables<Cost> tables = [&] {
+    const trace::Span tables_span("beam", "tables");
+    return build_tables(evaluator, piece, range, local, model);
+  }();
+  std::vector<std::uint8_t> path;
+  const Cost incumbent = greedy_incumbent(tables, path);
+  const Cost bound = model.bound(incumbent);
+
+  std::vector<size_t> widths(slice_count, budget.max_width);
+  if (adaptive) {
+    // A state one average slice cost behind the front is still a live
+    // alternative; such gaps are routinely recovered later in the piece
+    const Cost margin =
+        std::max(Cost{0}, incumbent / static_cast<Cost>(slice_count));
+    widths = adaptive_widths(tables, budget, margin);
+    size_t nodes = 0;
+    for (size_t width : widths) {
+      nodes += width;
+    }
+    if (nodes > kMaxNodes) {
+      throw std::length_error("Beam search arena exceeds 2^32 states");
+    }
+  }
+
+  // Under a memory budget, narrow every slice to what the buffers can
+  // afford, then charge exactly what they reserve
+  const size_t max_chunks = pool != nullptr ? pool->thread_count() : 0;
+  MemoryCharge arena_charge;
+  if (memory != nullptr) {
+    const size_t cap =
+        affordable_cap(tables, widths, max_chunks, memory->available());
+    if (cap == 0) {
+      throw MemoryBudgetError(
+          "Beam search arena does not fit in the memory budget even at "
+          "width 1");
+    }
+    for (size_t& width : widths) {
+      width = std::min(width, cap);
+    }
+  }
+  const BufferSizes<Cost> sizes =
+      buffer_sizes(tables, widths, std::numeric_limits<size_t>::max(),
+                   max_chunks);
+  if (memory != nullptr) {
+    arena_charge =
+        MemoryCharge(memory, sizes.bytes(max_chunks), "Beam search arena");
+  }
+
+  // Nodes at depth d of the range occupy
+  // arena[layer_begin[d], layer_begin[d + 1]). Reserved whole, so
+  // appending a layer never copies the earlier ones.
+  std::vector<Node<Cost>> arena;
+  arena.reserve(sizes.arena);
+  std::vector<size_t> layer_begin{0};
+  layer_begin.reserve(slice_count + 1);
+  std::vector<Node<Cost>> candidates;
+  candidates.reserve(sizes.candidates);
+  // One candidate buffer per parallel chunk, reused across slices
+  std::vector<std::vector<Node<Cost>>> chunk_candidates(max_chunks);
+  if (sizes.chunk > 0) {
+    for (auto& out : chunk_candidates) {
+      out.reserve(sizes.chunk);
+    }
+  }
+
+  // One span per measure of the forward pass
+  std::optional<trace::Span> measure_span;
+  size_t traced_measure = std::numeric_limits<size_t>::max();
+
+  for (size_t depth = 0; depth < slice_count; ++depth) {
+    const auto intra = tables.intra_of(depth);
+    const auto leads = tables.leads_of(depth);
+    const LeadCosts<Cost>& to_go = tables.to_go[depth];
+    const size_t beam_width = widths[depth];
+    if constexpr (trace::kCompiledIn) {
+      const size_t measure = piece.measure_index(range.begin + depth);
+      if (measure != traced_measure) {
+        measure_span.reset();
+        measure_span.emplace("beam", "measure", "measure",
+                             static_cast<std::int64_t>(measure));
+        traced_measure = measure;
+      }
+    }
+
+    candidates.clear();
+    size_t children = intra.size();
+    size_t bound_pruned = 0;
+    size_t width_pruned = 0;
+    if (depth == 0) {
+      for (size_t s = 0; s < intra.size(); ++s) {
+        if (intra[s] + to_go[lead_index(leads[s])] <= bound) {
+          candidates.push_back({intra[s], 0, static_cast<std::uint8_t>(s),
+                                leads[s]});
+        } else {
+          ++bound_pruned;
+        }
+      }
+    } else {
+      const Layer<Cost> layer{depth >= 2, intra, leads,
+                              &tables.boundaries[depth], &to_go, bound};
+      const size_t begin = layer_begin[depth - 1];
+      const size_t end = layer_begin[depth];
+      const size_t parents = end - begin;
+      children = parents * intra.size();
+      if (pool == nullptr || children < kParallelThreshold) {
+        bound_pruned = expand(arena, begin, end, layer, candidates);
+      } else {
+        // Each chunk keeps its own top beam_width; Cheaper is a total
+        // order, so the merged top beam_width equals the serial one
+        const size_t chunks = std::min(chunk_candidates.size(), parents);
+        const size_t chunk_size = (parents + chunks - 1) / chunks;
+        // Waiting for the chunks is not busy time; each chunk times itself
+        busy.reset();
+        parallel_for(*pool, 0, chunks, [&](size_t chunk) {
+          const ThreadStats::BusyTimer chunk_busy(stats);
+          auto& out = chunk_candidates[chunk];
+          out.clear();
+          const size_t lo = begin + chunk * chunk_size;
+          const size_t dropped =
+              expand(arena, lo, std::min(end, lo + chunk_size), layer, out);
+          const size_t pruned = prune(out, beam_width, to_go);
+          if (stats != nullptr) {
+            SearchStats& counts = stats->local();
+            counts.beam_bound_pruned += dropped;
+            counts.beam_width_pruned += pruned;
+          }
+        });
+        busy.emplace(stats);
+        for (size_t chunk = 0; chunk < chunks; ++chunk) {
+          candidates.insert(candidates.end(), chunk_candidates[chunk].begin(),
+                            chunk_candidates[chunk].end());
+        }
+      }
+    }
+
+    if (candidates.empty()) {
+      // Every surviving path was beaten by the incumbent
+      break;
+    }
+    width_pruned += prune(candidates, beam_width, to_go);
+    if (local != nullptr) {
+      local->beam_slices += 1;
+      local->beam_children += children;
+      local->beam_bound_pruned += bound_pruned;
+      local->beam_width_pruned += width_pruned;
+      local->beam_kept += candidates.size();
+      local->beam_capacity += beam_width;
+    }
+    arena.insert(arena.end(), candidates.begin(), candidates.end());
+    layer_begin.push_back(arena.size());
+  }
+  measure_span.reset();
+
+  // The last layer is sorted and owes nothing more, so its first node is
+  // the best path; the incumbent wins only if it is strictly cheaper
+  Cost cost = incumbent;
+  if (layer_begin.size() == slice_count + 1) {
+    size_t node = layer_begin[slice_count - 1];
+    if (arena[node].cost <= incumbent) {
+      cost = arena[node].cost;
+      for (size_t depth = slice_count; depth-- > 0;) {
+        path[depth] = arena[node].state;
+        node = arena[node].parent;
+      }
+    }
+  }
+
+  result.cost = model.to_double(cost);
+  result.fingerings.reserve(slice_count);
+  for (size_t depth = 0; depth < slice_count; ++depth) {
+    const size_t note_count = piece.slice_size(range.begin + depth);
+    result.fingerings.push_back(
+        generate_valid_states(note_count)[path[depth]], note_count);
+  }
+  return result;
+}
+
+}  // namespace
+
+SearchResult beam_search(const evaluator::ScoreEvaluator& evaluator,
+                         const evaluator::EvalPiece& piece,
+                         size_t beam_width) {
+  return detail::with_cost_model(evaluator, [&](auto model) {
+    return search(evaluator, piece, {beam_width, 0}, false,
+                  {0, piece.slice_count()}, nullptr, nullptr, nullptr, model);
+  });
+}
+
+SearchResult beam_search(const evaluator::ScoreEvaluator& evaluator,
+                         const evaluator::EvalPiece& piece, size_t beam_width,
+                         SliceRange range) {
+  return detail::with_cost_model(evaluator, [&](auto model) {
+    return search(evaluator, piece, {beam_width, 0}, false, range, nullptr,
+                  nullptr, nullptr, model);
+  });
+}
+
+SearchResult beam_search(const evaluator::ScoreEvaluator& evaluator,
+                         const evaluator::EvalPiece& piece, size_t beam_width,
+                         ThreadPool& pool, MemoryBudget* memory,
+                         ThreadStats* stats) {
+  return detail::with_cost_model(evaluator, [&](auto model) {
+    return search(evaluator, piece, {beam_width, 0}, false,
+                  {0, piece.slice_count()}, &pool, memory, stats, model);
+  });
+}
+
+SearchResult beam_search(const evaluator::ScoreEvaluator& evaluator,
+                         const evaluator::EvalPiece& piece,
+                         BeamBudget budget) {
+  return detail::with_cost_model(evaluator, [&](auto model) {
+    return search(evaluator, piece, budget, true, {0, piece.slice_count()},
+                  nullptr, nullptr, nullptr, model);
+  });
+}
+
+SearchResult beam_search(const evaluator::ScoreEvaluator& evaluator,
+                         const evaluator::EvalPiece& piece, BeamBudget budget,
+                         ThreadPool& pool, MemoryBudget* memory,
+                         ThreadStats* stats) {
+  return detail::with_cost_model(evaluator, [&](auto model) {
+    return search(evaluator, piece, budget, true, {0, piece.slice_count()},
+                  &pool, memory, stats, model);
+  });
+}
+
+}  // namespace piano_fingering::optimizer
@@ -0,0 +1,67 @@
+#ifndef PIANO_FINGERING_OPTIMIZER_COST_MODEL_H_
+#define PIANO_FINGERING_OPTIMIZER_COST_MODEL_H_
+
+#include <cmath>
+#include <limits>
+
+#include "evaluator/fixed_cost.h"
+#include "evaluator/score_evaluator.h"
+
+namespace piano_fingering::optimizer::detail {
+
+// Arithmetic the DP and beam engines accumulate costs in, chosen from
+// ScoreEvaluator::fixed_point_scale(). Both convert the evaluator's double
+// terms once, when the engine tabulates them.
+template <typename Cost>
+struct CostModel;
+
+template <>
+struct CostModel<double> {
+  static constexpr double kInfinity = std::numeric_limits<double>::infinity();
+
+  [[nodiscard]] double operator()(double cost) const noexcept { return cost; }
+  [[nodiscard]] double to_double(double cost) const noexcept { return cost; }
+
+  // Pruning bound for paths that must not cost more than `cost`, with
+  // slack so that paths summing to it in another order survive rounding
+  [[nodiscard]] double bound(double cost) const noexcept {
+    return cost + 1e-9 * (1.0 + std::abs(cost));
+  }
+};
+
+template <>
+struct CostModel<evaluator::FixedCost> {
+  // Far from overflow when a few are added together; sums that may reach
+  // it are clamped back with std::min
+  static constexpr evaluator::FixedCost kInfinity =
+      std::numeric_limits<evaluator::FixedCost>::max() / 4;
+
+  evaluator::FixedCost scale;
+
+  [[nodiscard]] evaluator::FixedCost operator()(double cost) const noexcept {
+    return evaluator::to_fixed(cost, scale);
+  }
+  [[nodiscard]] double to_double(evaluator::FixedCost cost) const noexcept {
+    return evaluator::from_fixed(cost, scale);
+  }
+
+  // Integer sums are exact, so no slack
+  [[nodiscard]] evaluator::FixedCost bound(
+      evaluator::FixedCost cost) const noexcept {
+    return cost;
+  }
+};
+
+// Calls `search` with the CostModel the evaluator selects
+template <typename Search>
+decltype(auto) with_cost_model(const evaluator::ScoreEvaluator& evaluator,
+                               Search&& search) {
+  if (const auto scale = evaluator.fixed_point_scale()) {
+    return search(CostModel<evaluator::FixedCost>{*scale});
+  }
+  return search(CostModel<double>{});
+}
+
+}  // namespace piano_fingering::optimizer::detail
+
+#endif  // PIANO_FINGERING_OPTIMIZER_COST_MODEL_H_
@@ -0,0 +1,255 @@
+#include "optimizer/exact_search.h"
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <vector>
+
+#include "cost_model.h"
+#include "domain/finger.h"
+#include "domain/packed_fingering.h"
+#include "evaluator/fixed_cost.h"
+#include "optimizer/state_generation.h"
+#include "optimizer/transition_cache.h"
+
+namespace piano_fingering::optimizer {
+
+namespace {
+
+using detail::CostModel;
+
+constexpr size_t kLeads = domain::kFingerCount;
+constexpr size_t kPairs = kLeads * kLeads;
+
+// Cheapest state of one slice for each leading finger
+template <typename Cost>
+struct SliceChoice {
+  std::array<Cost, kLeads> cost;
+  std::array<domain::PackedFingering, kLeads> state;
+};
+
+domain::Finger finger_at(size_t index) noexcept {
+  return static_cast<domain::Finger>(index + 1);
+}
+
+template <typename Cost>
+SliceChoice<Cost> choose_states(const evaluator::ScoreEvaluator& evaluator,
+                                const evaluator::EvalPiece& piece,
+                                size_t slice, CostModel<Cost> model) {
+  SliceChoice<Cost> choice{};
+  choice.cost.fill(CostModel<Cost>::kInfinity);
+  for (domain::PackedFingering state :
+       generate_valid_states(piece.slice_size(slice))) {
+    const auto lead = static_cast<size_t>(domain::to_int(*state[0]) - 1);
+    const Cost cost =
+        model(evaluator.evaluate_intra_slice(piece, {slice, state}));
+    if (cost < choice.cost[lead]) {
+      choice.cost[lead] = cost;
+      choice.state[lead] = state;
+    }
+  }
+  return choice;
+}
+
+// (previous lead, current lead) as one DP index
+size_t pair_index(size_t prev, size_t curr) noexcept {
+  return prev * kLeads + curr;
+}
+
+// Viterbi over `range`, where choices[d] lists the states allowed at slice
+// range.begin + d. Everything is indexed by that depth d.
+template <typename Cost>
+SearchResult solve(const evaluator::ScoreEvaluator& evaluator,
+                   const evaluator::EvalPiece& piece, SliceRange range,
+                   const std::vector<SliceChoice<Cost>>& choices,
+                   CostModel<Cost> model) {
+  SearchResult result;
+  const size_t count = range.size();
+  if (count == 0) {
+    return result;
+  }
+  TransitionCache cache(evaluator, piece);
+
+  if (count == 1) {
+    size_t lead = 0;
+    for (size_t c = 1; c < kLeads; ++c) {
+      if (choices[0].cost[c] < choices[0].cost[lead]) {
+        lead = c;
+      }
+    }
+    result.cost = model.to_double(choices[0].cost[lead]);
+    result.fingerings.push_back(choices[0].state[lead],
+                                piece.slice_size(range.begin));
+    return result;
+  }
+
+  // best[pair_index(a, b)]: cheapest prefix ending with leads a, b. From
+  // depth 2 on, back[d][pair_index(b, c)] is the lead a before b.
+  std::array<Cost, kPairs> best{};
+  std::array<Cost, kPairs> next{};
+  std::vector<std::array<std::uint8_t, kPairs>> back(count);
+
+  for (size_t a = 0; a < kLeads; ++a) {
+    for (size_t b = 0; b < kLeads; ++b) {
+      best[pair_index(a, b)] = std::min(
+          choices[0].cost[a] + choices[1].cost[b] +
+              model(cache.transition(range.begin + 1, finger_at(a),
+                                     finger_at(b))),
+          CostModel<Cost>::kInfinity);
+    }
+  }
+
+  for (size_t d = 2; d < count; ++d) {
+    const size_t slice = range.begin + d;
+    for (size_t b = 0; b < kLeads; ++b) {
+      for (size_t c = 0; c < kLeads; ++c) {
+        const Cost local =
+            choices[d].cost[c] +
+            model(cache.transition(slice, finger_at(b), finger_at(c)));
+        Cost cheapest = CostModel<Cost>::kInfinity;
+        std::uint8_t from = 0;
+        for (size_t a = 0; a < kLeads; ++a) {
+          const Cost cost = best[pair_index(a, b)] +
+                            model(cache.triplet(slice, finger_at(a),
+                                                finger_at(b), finger_at(c)));
+          if (cost < cheapest) {
+            cheapest = cost;
+            from = static_cast<std::uint8_t>(a);
+          }
+        }
+        next[pair_index(b, c)] =
+            std::min(cheapest + local, CostModel<Cost>::kInfinity);
+        back[d][pair_index(b, c)] = from;
+      }
+    }
+    best = next;
+  }
+
+  size_t final_pair = 0;
+  for (size_t pair = 1; pair < kPairs; ++pair) {
+    if (best[pair] < best[final_pair]) {
+      final_pair = pair;
+    }
+  }
+  result.cost = model.to_double(best[final_pair]);
+
+  // Recover the lead at every depth, last two first
+  std::vector<size_t> leads(count);
+  leads[count - 2] = final_pair / kLeads;
+  leads[count - 1] = final_pair % kLeads;
+  for (size_t d = count - 1; d >= 2; --d) {
+    leads[d - 2] = back[d][pair_index(leads[d - 1], leads[d])];
+  }
+
+  result.fingerings.reserve(count);
+  for (size_t d = 0; d < count; ++d) {
+    result.fingerings.push_back(choices[d].state[leads[d]],
+                                piece.slice_size(range.begin + d));
+  }
+  return result;
+}
+
+}  // namespace
+
+SearchResult exact_search(const evaluator::ScoreEvaluator& evaluator,
+                          const evaluator::EvalPiece& piece) {
+  return exact_search(evaluator, piece, {0, piece.slice_count()});
+}
+
+SearchResult exact_search(const evaluator::ScoreEvaluator& evaluator,
+                          const evaluator::EvalPiece& piece,
+                          SliceRange range) {
+  if (range.begin > range.end || range.end > piece.slice_count()) {
+    throw std::out_of_range("Exact search range outside the piece");
+  }
+  return detail::with_cost_model(evaluator, [&](auto model) {
+    using Cost = decltype(model(0.0));
+    std::vector<SliceChoice<Cost>> choices;
+    choices.reserve(range.size());
+    for (size_t slice = range.begin; slice < range.end; ++slice) {
+      choices.push_back(choose_states(evaluator, piece, slice, model));
+    }
+    return solve(evaluator, piece, range, choices, model);
+  });
+}
+
+SearchResult exact_search(const evaluator::ScoreEvaluator& evaluator,
+                          const evaluator::EvalPiece& piece,
+                          const domain::PackedFingeringSequence& fingerings,
+                          SliceRange window) {
+  if (fingerings.size() != piece.slice_count()) {
+    throw std::invalid_argument("Fingerings do not match the piece");
+  }
+  if (window.begin > window.end || window.end > piece.slice_count()) {
+    throw std::out_of_range("Exact search window outside the piece");
+  }
+  // The window and the two fixed slices on each side, each fixed slice
+  // allowed only its current state
+  const SliceRange range{window.begin - std::min<size_t>(window.begin, 2),
+                         std::min(window.end + 2, piece.slice_count())};
+  const SearchResult solved =
+      detail::with_cost_model(evaluator, [&](auto model) {
+        using Cost = decltype(model(0.0));
+        std::vector<SliceChoice<Cost>> choices;
+        choices.reserve(range.size());
+        for (size_t slice = range.begin; slice < range.end; ++slice) {
+          if (slice >= window.begin && slice < window.end) {
+            choices.push_back(choose_states(evaluator, piece, slice, model));
+            continue;
+          }
+          SliceChoice<Cost> fixed{};
+          fixed.cost.fill(CostModel<Cost>::kInfinity);
+          const domain::PackedFingering state = fingerings[slice];
+          if (!state[0].has_value()) {
+            throw std::invalid_argument(
+                "Fixed slices must finger their first note");
+          }
+          const auto lead = static_cast<size_t>(domain::to_int(*state[0]) - 1);
+          fixed.cost[lead] =
+              model(evaluator.evaluate_intra_slice(piece, {slice, state}));
+          fixed.state[lead] = state;
+          choices.push_back(fixed);
+        }
+        return solve(evaluator, piece, range, choices, model);
+      });
+
+  SearchResult result;
+  result.fingerings.reserve(piece.slice_count());
+  for (size_t slice = 0; slice < piece.slice_count(); ++slice) {
+    const bool searched = slice >= range.begin && slice < range.end;
+    result.fingerings.push_back(
+        searched ? solved.fingerings[slice - range.begin] : fingerings[slice],
+        piece.slice_size(slice));
+  }
+  result.cost = window_cost(evaluator, piece, result.fingerings, window);
+  return result;
+}
+
+double window_cost(const evaluator::ScoreEvaluator& evaluator,
+                   const evaluator::EvalPiece& piece,
+                   const domain::PackedFingeringSequence& fingerings,
+                   SliceRange window) {
+  const size_t count = fingerings.size();
+  auto at = [&](size_t slice) {
+    return evaluator::ScoreEvaluator::SliceFingering{slice, fingerings[slice]};
+  };
+  double cost = 0.0;
+  for (size_t s = window.begin; s < window.end; ++s) {
+    cost += evaluator.evaluate_intra_slice(piece, at(s));
+  }
+  // Transitions into window.begin through window.end, and triplets ending
+  // at window.begin through window.end + 1
+  for (size_t t = std::max<size_t>(window.begin, 1);
+       t <= window.end && t < count; ++t) {
+    cost += evaluator.evaluate_transition(piece, at(t - 1), at(t));
+  }
+  for (size_t t = std::max<size_t>(window.begin, 2);
+       t <= window.end + 1 && t < count; ++t) {
+    cost += evaluator.evaluate_triplet(piece, at(t - 2), at(t - 1), at(t));
+  }
+  return cost;
+}
+
+}  // namespace piano_fingering::optimizer
@@ -0,0 +1,358 @@
+#include "optimizer/ils.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <memory_resource>
+#include <optional>
+#include <random>
+#include <stdexcept>
+#include <vector>
+
+#include "domain/finger.h"
+#include "domain/inline_vector.h"
+#include "evaluator/incremental_evaluation.h"
+
+namespace piano_fingering::optimizer {
+
+namespace {
+
+using evaluator::IncrementalEvaluation;
+using Location = IncrementalEvaluation::SliceLocation;
+
+// Gains below this are rounding noise; ignoring them guarantees descent
+// terminates
+constexpr double kMinImprovement = 1e-9;
+
+// Reach of the sequential rules, in slices
+constexpr size_t kReach = 2;
+
+// Slices awaiting a rescan, each queued at most once. LIFO, so the region
+// around the latest move is finished before older work.
+class DirtySlices {
+ public:
+  DirtySlices(size_t slice_count, std::pmr::memory_resource* memory)
+      : queued_(slice_count, 1, memory), pending_(memory) {
+    pending_.reserve(slice_count);
+    for (size_t slice = slice_count; slice-- > 0;) {
+      pending_.push_back(slice);
+    }
+  }
+
+  // Queues every slice whose +/-kReach neighbourhood contains `slice`
+  void mark(size_t slice) {
+    const size_t lo = slice >= kReach ? slice - kReach : 0;
+    const size_t hi = std::min(queued_.size(), slice + kReach + 1);
+    for (size_t s = lo; s < hi; ++s) {
+      if (queued_[s] == 0) {
+        queued_[s] = 1;
+        pending_.push_back(s);
+      }
+    }
+  }
+
+  bool pop(size_t& slice) {
+    if (pending_.empty()) {
+      return false;
+    }
+    slice = pending_.back();
+    pending_.pop_back();
+    queued_[slice] = 0;
+    return true;
+  }
+
+ private:
+  std::pmr::vector<std::uint8_t> queued_;
+  std::pmr::vector<size_t> pending_;
+};
+
+// Zobrist hash of the assignment, kept up to date move by move
+class SolutionHash {
+ public:
+  SolutionHash(const evaluator::EvalPiece& piece,
+               const IncrementalEvaluation& session,
+               std::pmr::memory_resource* memory)
+      : piece_(&piece), keys_(piece.note_count() * kValues, memory) {
+    std::uint64_t state = 0x9E3779B97F4A7C15ULL;
+    for (auto& key : keys_) {
+      // splitmix64
+      state += 0x9E3779B97F4A7C15ULL;
+      std::uint64_t z = state;
+      z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+      z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+      key = z ^ (z >> 31);
+    }
+    for (size_t slice = 0; slice < session.slice_count(); ++slice) {
+      for (size_t note = 0; note < piece.slice_size(slice); ++note) {
+        value_ ^= key(slice, note, session.finger(slice, note));
+      }
+    }
+  }
+
+  void move(size_t slice, size_t note, std::optional<domain::Finger> from,
+            domain::Finger to) noexcept {
+    value_ ^= key(slice, note, from) ^ key(slice, note, to);
+  }
+
+  [[nodiscard]] std::uint64_t value() const noexcept { return value_; }
+  void reset(std::uint64_t value) noexcept { value_ = value; }
+
+ private:
+  // Unassigned plus five fingers
+  static constexpr size_t kValues = domain::kFingerCount + 1;
+
+  [[nodiscard]] std::uint64_t key(
+      size_t slice, size_t note,
+      std::optional<domain::Finger> finger) const noexcept {
+    const auto value =
+        finger.has_value() ? static_cast<size_t>(domain::to_int(*finger)) : 0;
+    return keys_[(piece_->slice_begin(slice) + note) * kValues + value];
+  }
+
+  const evaluator::EvalPiece* piece_;
+  std::pmr::vector<std::uint64_t> keys_;
+  std::uint64_t value_{0};
+};
+
+class Search {
+ public:
+  Search(const evaluator::ScoreEvaluator& evaluator,
+         const evaluator::EvalPiece& piece,
+         const domain::PackedFingeringSequence& initial,
+         const IlsOptions& options)
+      : piece_(&piece),
+        options_(&options),
+        session_(evaluator, piece, initial),
+        dirty_(piece.slice_count(), scratch(options)),
+        hash_(piece, session_, scratch(options)),
+        rng_(options.seed),
+        perturbed_at_(piece.slice_count(), kNever, scratch(options)),
+        recent_(scratch(options)) {}
+
+  IlsResult run() {
+    descend();
+    accept_best();
+    size_t strength = options_->perturbation_strength;
+    size_t iteration = 0;
+    for (; iteration < options_->iterations && !should_stop(); ++iteration) {
+      perturb(strength, iteration);
+      descend();
+      // The local optimum just reached, remembered even when it is
+      // abandoned below
+      const std::uint64_t optimum = hash_.value();
+      if (session_.total() < best_cost_ - kMinImprovement) {
+        ++improvements_;
+        accept_best();
+        strength = options_->perturbation_strength;
+      } else {
+        const bool repeated = tabu() && revisited(optimum);
+        if (repeated && optimum != best_hash_) {
+          ++tabu_revisits_;
+        }
+        strength = repeated ? std::min(strength + 1, piece_->note_count())
+                            : options_->perturbation_strength;
+        revert_to_best();
+      }
+      remember(optimum);
+      if ((iteration + 1) % kIlsProgressInterval == 0) {
+        report(kIlsProgressInterval);
+      }
+    }
+    report(iteration % kIlsProgressInterval);
+
+    IlsResult result;
+    result.cost = session_.refresh();
+    result.fingerings = session_.packed();
+    result.iterations_performed = iteration;
+    if (options_->stats != nullptr) {
+      // The session's construction and the final refresh
+      SearchStats& stats = *options_->stats;
+      stats.full_evaluations += 2;
+      stats.delta_evaluations += delta_evaluations_;
+      stats.ils_iterations += iteration;
+      stats.ils_improvements += improvements_;
+      stats.ils_moves += moves_;
+      stats.ils_tabu_revisits += tabu_revisits_;
+    }
+    return result;
+  }
+
+ private:
+  static constexpr size_t kNever = std::numeric_limits<size_t>::max();
+
+  static std::pmr::memory_resource* scratch(const IlsOptions& options) {
+    return options.scratch != nullptr ? options.scratch
+                                      : std::pmr::get_default_resource();
+  }
+
+  [[nodiscard]] bool should_stop() const {
+    return options_->stop_token.stop_requested() ||
+           (options_->deadline.has_value() &&
+            std::chrono::steady_clock::now() >= *options_->deadline);
+  }
+
+  void report(size_t iterations) const noexcept {
+    if (options_->progress != nullptr && iterations > 0) {
+      options_->progress->publish({ProgressPhase::kLocalSearch, piece_->hand(),
+                                   0, iterations});
+    }
+  }
+
+  [[nodiscard]] bool tabu() const noexcept {
+    return options_->strategy == IlsStrategy::kTabu &&
+           options_->tabu_tenure > 0;
+  }
+
+  // Best-improvement per note over the dirty slices until none is left
+  void descend() {
+    size_t slice = 0;
+    while (dirty_.pop(slice)) {
+      for (size_t note = 0; note < piece_->slice_size(slice); ++note) {
+        const Location location{0, 0, note, slice};
+        const auto deltas = session_.neighborhood(location);
+        const auto best = std::min_element(deltas.begin(), deltas.end());
+        delta_evaluations_ += deltas.size();
+        if (*best < -kMinImprovement) {
+          assign(slice, note,
+                 static_cast<domain::Finger>(best - deltas.begin() + 1));
+        }
+      }
+    }
+  }
+
+  // Reassigns `count` random notes to random legal fingers, preferring
+  // slices that have not been perturbed recently under the tabu strategy
+  void perturb(size_t count, size_t iteration) {
+    const size_t slice_count = piece_->slice_count();
+    std::uniform_int_distribution<size_t> pick_slice(0, slice_count - 1);
+    for (size_t k = 0; k < count; ++k) {
+      size_t slice = pick_slice(rng_);
+      for (size_t attempt = 0; tabu() && attempt < kTabuAttempts &&
+                               is_tabu(slice, iteration);
+           ++attempt) {
+        slice = pick_slice(rng_);
+      }
+      std::uniform_int_distribution<size_t> pick_note(
+          0, piece_->slice_size(slice) - 1);
+      const size_t note = pick_note(rng_);
+
+      const auto deltas = session_.neighborhood({0, 0, note, slice});
+      delta_evaluations_ += deltas.size();
+      domain::InlineVector<domain::Finger, domain::kFingerCount> legal;
+      for (size_t f = 0; f < deltas.size(); ++f) {
+        if (deltas[f] != std::numeric_limits<double>::infinity()) {
+          legal.push_back(static_cast<domain::Finger>(f + 1));
+        }
+      }
+      if (legal.empty()) {
+        continue;  // a full five-note chord has no single-note move
+      }
+      std::uniform_int_distribution<size_t> pick_finger(0, legal.size() - 1);
+      assign(slice, note, legal[pick_finger(rng_)]);
+      perturbed_at_[slice] = iteration;
+    }
+  }
+
+  [[nodiscard]] bool is_tabu(size_t slice, size_t iteration) const noexcept {
+    return perturbed_at_[slice] != kNever &&
+           iteration - perturbed_at_[slice] < options_->tabu_tenure;
+  }
+
+  void assign(size_t slice, size_t note, domain::Finger finger) {
+    const auto previous = session_.finger(slice, note);
+    [[maybe_unused]] const double delta =
+        session_.delta({0, 0, note, slice}, finger);
+    session_.apply();
+    ++delta_evaluations_;
+    ++moves_;
+    hash_.move(slice, note, previous, finger);
+    dirty_.mark(slice);
+  }
+
+  void accept_best() {
+    best_cost_ = session_.total();
+    best_hash_ = hash_.value();
+    session_.clear_history();
+    if (options_->on_improvement) {
+      options_->on_improvement(session_.packed(), best_cost_);
+    }
+  }
+
+  // The best solution is a local optimum, so nothing is left dirty
+  void revert_to_best() {
+    while (session_.applied_count() > 0) {
+      session_.undo();
+    }
+    hash_.reset(best_hash_);
+  }
+
+  [[nodiscard]] bool revisited(std::uint64_t hash) const {
+    return std::find(recent_.begin(), recent_.end(), hash) != recent_.end();
+  }
+
+  void remember(std::uint64_t hash) {
+    if (!tabu()) {
+      return;
+    }
+    if (recent_.size() < options_->tabu_tenure) {
+      recent_.push_back(hash);
+    } else {
+      recent_[next_recent_] = hash;
+      next_recent_ = (next_recent_ + 1) % recent_.size();
+    }
+  }
+
+  // Redraws of a tabu slice before settling for it
+  static constexpr size_t kTabuAttempts = 8;
+
+  const evaluator::EvalPiece* piece_;
+  const IlsOptions* options_;
+  IncrementalEvaluation session_;
+  DirtySlices dirty_;
+  SolutionHash hash_;
+  std::mt19937_64 rng_;
+  std::pmr::vector<size_t> perturbed_at_;
+  // Ring buffer of the hashes of recent local optima
+  std::pmr::vector<std::uint64_t> recent_;
+  size_t next_recent_{0};
+  double best_cost_{0.0};
+  std::uint64_t best_hash_{0};
+  // Counted locally and reported once, at the end of run()
+  std::uint64_t delta_evaluations_{0};
+  std::uint64_t improvements_{0};
+  std::uint64_t moves_{0};
+  std::uint64_t tabu_revisits_{0};
+};
+
+}  // namespace
+
+IlsResult ils_improve(const evaluator::ScoreEvaluator& evaluator,
+                      const evaluator::EvalPiece& piece,
+                      const domain::PackedFingeringSequence& initial,
+                      const IlsOptions& options) {
+  if (initial.size() != piece.slice_count()) {
+    throw std::invalid_argument("ILS needs a fingering for every slice");
+  }
+  if (piece.slice_count() == 0) {
+    return {};
+  }
+  return Search(evaluator, piece, initial, options).run();
+}
+
+size_t ils_session_bytes(const evaluator::EvalPiece& piece) noexcept {
+  // Flat fingers plus one Zobrist key per note and value
+  constexpr size_t kPerNote =
+      sizeof(std::uint8_t) +
+      (domain::kFingerCount + 1) * sizeof(std::uint64_t);
+  // Worklist flag and entry, tabu stamp, undo move and two packed copies
+  // (the best solution and the result)
+  constexpr size_t kMoveBytes = 2 * sizeof(size_t) + sizeof(double);
+  constexpr size_t kPerSlice =
+      sizeof(std::uint8_t) + 2 * sizeof(size_t) + kMoveBytes +
+      2 * (sizeof(domain::PackedFingering) + sizeof(std::uint8_t));
+  return piece.note_count() * kPerNote + piece.slice_count() * kPerSlice;
+}
+
+}  // namespace piano_fingering::optimizer
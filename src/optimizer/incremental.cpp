@@ -0,0 +1,90 @@
+#include "optimizer/incremental.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <stdexcept>
+
+#include "optimizer/exact_search.h"
+
+namespace piano_fingering::optimizer {
+
+namespace {
+
+bool same_slice(const evaluator::EvalPiece& a, size_t slice_a,
+                const evaluator::EvalPiece& b, size_t slice_b) {
+  const size_t size = a.slice_size(slice_a);
+  if (size != b.slice_size(slice_b) ||
+      a.follows_rest(slice_a) != b.follows_rest(slice_b)) {
+    return false;
+  }
+  const size_t begin_a = a.slice_begin(slice_a);
+  const size_t begin_b = b.slice_begin(slice_b);
+  for (size_t k = 0; k < size; ++k) {
+    if (a.pitch(begin_a + k) != b.pitch(begin_b + k)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+}  // namespace
+
+SliceDiff diff_slices(const evaluator::EvalPiece& previous,
+                      const evaluator::EvalPiece& edited) {
+  const size_t shorter = std::min(previous.slice_count(), edited.slice_count());
+  SliceDiff diff;
+  while (diff.prefix < shorter &&
+         same_slice(previous, diff.prefix, edited, diff.prefix)) {
+    ++diff.prefix;
+  }
+  while (diff.prefix + diff.suffix < shorter &&
+         same_slice(previous, previous.slice_count() - 1 - diff.suffix, edited,
+                    edited.slice_count() - 1 - diff.suffix)) {
+    ++diff.suffix;
+  }
+  return diff;
+}
+
+SearchResult refinger(const evaluator::ScoreEvaluator& evaluator,
+                      const evaluator::EvalPiece& previous,
+                      const domain::PackedFingeringSequence& previous_fingerings,
+                      double previous_cost, const evaluator::EvalPiece& edited,
+                      size_t margin) {
+  const size_t old_count = previous.slice_count();
+  const size_t new_count = edited.slice_count();
+  if (previous_fingerings.size() != old_count) {
+    throw std::invalid_argument("Previous fingerings do not match the piece");
+  }
+  const SliceDiff diff = diff_slices(previous, edited);
+  if (old_count == new_count && diff.prefix == new_count) {
+    return {previous_fingerings, previous_cost};
+  }
+  if (new_count == 0) {
+    return {};
+  }
+
+  // The edit and its margins in each version; beyond them both versions
+  // hold the same slices, the trailing ones shifted by the length change
+  const size_t begin = diff.prefix - std::min(diff.prefix, margin);
+  const size_t new_end = std::min(new_count - diff.suffix + margin, new_count);
+  const size_t old_end = old_count - (new_count - new_end);
+  const SliceRange window{begin, new_end};
+
+  domain::PackedFingeringSequence seed;
+  seed.reserve(new_count);
+  for (size_t slice = 0; slice < new_count; ++slice) {
+    const domain::PackedFingering state =
+        slice < begin      ? previous_fingerings[slice]
+        : slice >= new_end ? previous_fingerings[old_count - (new_count - slice)]
+                           : domain::PackedFingering{};
+    seed.push_back(state, edited.slice_size(slice));
+  }
+
+  SearchResult result = exact_search(evaluator, edited, seed, window);
+  result.cost += previous_cost - window_cost(evaluator, previous,
+                                             previous_fingerings,
+                                             {begin, old_end});
+  return result;
+}
+
+}  // namespace piano_fingering::optimizer
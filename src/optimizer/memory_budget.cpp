@@ -0,0 +1,75 @@
+#include "optimizer/memory_budget.h"
+
+#include <fstream>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <sys/resource.h>
+#include <unistd.h>
+#endif
+
+namespace piano_fingering::optimizer {
+
+bool MemoryBudget::try_charge(size_t bytes) noexcept {
+  size_t used = current_.load(std::memory_order_relaxed);
+  do {
+    if (bytes > limit_ || used > limit_ - bytes) {
+      return false;
+    }
+  } while (!current_.compare_exchange_weak(used, used + bytes,
+                                           std::memory_order_relaxed));
+  size_t peak = peak_.load(std::memory_order_relaxed);
+  while (used + bytes > peak &&
+         !peak_.compare_exchange_weak(peak, used + bytes,
+                                      std::memory_order_relaxed)) {
+  }
+  return true;
+}
+
+void MemoryBudget::release(size_t bytes) noexcept {
+  current_.fetch_sub(bytes, std::memory_order_relaxed);
+}
+
+MemoryCharge::MemoryCharge(MemoryBudget* budget, size_t bytes,
+                           const char* what) {
+  if (budget == nullptr) {
+    return;
+  }
+  if (!budget->try_charge(bytes)) {
+    throw MemoryBudgetError(std::string(what) + " needs " +
+                            std::to_string(bytes) + " bytes but only " +
+                            std::to_string(budget->available()) + " of " +
+                            std::to_string(budget->limit()) +
+                            " are left in the memory budget");
+  }
+  budget_ = budget;
+  bytes_ = bytes;
+}
+
+size_t current_rss_bytes() noexcept {
+#if defined(__linux__)
+  // Second field of statm: resident pages
+  std::ifstream statm("/proc/self/statm");
+  size_t total_pages = 0;
+  size_t resident_pages = 0;
+  if (statm >> total_pages >> resident_pages) {
+    return resident_pages * static_cast<size_t>(sysconf(_SC_PAGESIZE));
+  }
+#endif
+  return 0;
+}
+
+size_t peak_rss_bytes() noexcept {
+#if defined(__unix__) || defined(__APPLE__)
+  rusage usage{};
+  if (getrusage(RUSAGE_SELF, &usage) == 0) {
+#if defined(__APPLE__)
+    return static_cast<size_t>(usage.ru_maxrss);  // bytes
+#else
+    return static_cast<size_t>(usage.ru_maxrss) * 1024;  // kilobytes
+#endif
+  }
+#endif
+  return 0;
+}
+
+}  // namespace piano_fingering::optimizer
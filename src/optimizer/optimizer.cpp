@@ -0,0 +1,321 @@
+#include "optimizer/optimizer.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+#include "config/configuration_error.h"
+#include "evaluator/eval_piece.h"
+#include "optimizer/beam_search.h"
+#include "optimizer/ils.h"
+#include "trace/trace.h"
+
+namespace piano_fingering::optimizer {
+
+namespace {
+
+const config::Config& validated(const config::Config& config) {
+  if (!config.is_valid()) {
+    throw config::ConfigurationError("Invalid optimizer configuration");
+  }
+  return config;
+}
+
+void report(const Optimizer::Limits& limits, ProgressPhase phase,
+            const evaluator::EvalPiece& piece, std::uint64_t iterations) {
+  if (limits.progress != nullptr) {
+    const auto measures = static_cast<std::uint32_t>(
+        piece.measure_index(piece.slice_count() - 1) + 1);
+    limits.progress->publish({phase, piece.hand(), measures, iterations});
+  }
+}
+
+// Forwards a hand's improvements from concurrent trajectories to
+// Limits::on_improvement, one at a time and only when they beat every
+// earlier report by more than rounding noise
+class ImprovementReporter {
+ public:
+  ImprovementReporter(const Optimizer::Limits& limits, domain::Hand hand)
+      : handler_(&limits.on_improvement), hand_(hand) {}
+
+  [[nodiscard]] bool enabled() const noexcept {
+    return static_cast<bool>(*handler_);
+  }
+
+  void offer(const domain::PackedFingeringSequence& fingerings,
+             double score) {
+    if (!enabled()) {
+      return;
+    }
+    const std::lock_guard lock(mutex_);
+    if (score < best_ - kMinImprovement) {
+      best_ = score;
+      (*handler_)(hand_, fingerings, score);
+    }
+  }
+
+ private:
+  static constexpr double kMinImprovement = 1e-9;
+
+  const Optimizer::ImprovementHandler* handler_;
+  domain::Hand hand_;
+  std::mutex mutex_;
+  double best_{std::numeric_limits<double>::infinity()};
+};
+
+// Seed of trajectory t; mixed so that nearby seeds give unrelated streams
+// rather than sharing trajectories shifted by one
+std::uint64_t trajectory_seed(unsigned int seed, size_t trajectory) {
+  std::uint64_t z = (static_cast<std::uint64_t>(seed) << 32) ^ trajectory;
+  z += 0x9E3779B97F4A7C15ULL;
+  z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+  z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+  return z ^ (z >> 31);
+}
+
+}  // namespace
+
+Optimizer::Optimizer(const config::Config& config, size_t thread_count)
+    : config_(validated(config)),
+      evaluator_(config_),
+      owned_pool_(std::make_unique<ThreadPool>(thread_count)),
+      pool_(owned_pool_.get()) {}
+
+Optimizer::Optimizer(const config::Config& config, size_t thread_count,
+                     const WorkerPlacement& placement)
+    : config_(validated(config)),
+      evaluator_(config_),
+      owned_pool_(std::make_unique<ThreadPool>(thread_count, placement)),
+      pool_(owned_pool_.get()) {
+  replicate_per_node();
+}
+
+Optimizer::Optimizer(const config::Config& config, ThreadPool& pool)
+    : config_(validated(config)), evaluator_(config_), pool_(&pool) {
+  replicate_per_node();
+}
+
+void Optimizer::replicate_per_node() {
+  const size_t nodes = pool_->node_count();
+  if (!pool_->placement().replicate_per_node || nodes < 2) {
+    return;
+  }
+  node_evaluators_.reserve(nodes);
+  for (size_t node = 0; node < nodes; ++node) {
+    run_on_node(pool_->placement().topology, node, [&] {
+      node_evaluators_.push_back(evaluator_.replicate());
+    });
+  }
+}
+
+Optimizer::Result Optimizer::optimize(const domain::Piece& piece,
+                                      domain::Hand hand, unsigned int seed,
+                                      const Limits& limits) {
+  const evaluator::EvalPiece compiled(piece, hand);
+  return optimize_hand(compiled, seed, limits);
+}
+
+Optimizer::Result Optimizer::optimize(const domain::Piece& piece,
+                                      domain::Hand hand, unsigned int seed) {
+  return optimize(piece, hand, seed, Limits{});
+}
+
+Optimizer::Result Optimizer::optimize(const evaluator::EvalPiece& piece,
+                                      unsigned int seed,
+                                      const Limits& limits) {
+  return optimize_hand(piece, seed, limits);
+}
+
+Optimizer::PieceResult Optimizer::optimize_piece(const domain::Piece& piece,
+                                                 unsigned int seed) {
+  return optimize_piece(piece, seed, Limits{});
+}
+
+Optimizer::PieceResult Optimizer::optimize_piece(const domain::Piece& piece,
+                                                 unsigned int seed,
+                                                 const Limits& limits) {
+  const trace::Span span("optimizer", "piece");
+  const evaluator::EvalPiece right(piece, domain::Hand::kRight);
+  const evaluator::EvalPiece left(piece, domain::Hand::kLeft);
+
+  const Clock::time_point start = Clock::now();
+  PieceResult result;
+  parallel_invoke(
+      *pool_, [&] { result.right_hand = optimize_hand(right, seed, limits); },
+      [&] { result.left_hand = optimize_hand(left, seed, limits); });
+  result.score = result.right_hand.score + result.left_hand.score;
+  result.iterations_performed = result.right_hand.iterations_performed +
+                                result.left_hand.iterations_performed;
+  result.stats = result.right_hand.stats;
+  result.stats += result.left_hand.stats;
+  result.stats.wall = Clock::now() - start;
+  return result;
+}
+
+Optimizer::Result Optimizer::refinger(const domain::Piece& previous_piece,
+                                      const Result& previous,
+                                      const domain::Piece& edited,
+                                      domain::Hand hand, size_t margin) const {
+  const trace::Span span("optimizer", "refinger", "hand",
+                         static_cast<std::int64_t>(hand));
+  const Clock::time_point start = Clock::now();
+  const evaluator::EvalPiece before(previous_piece, hand);
+  const evaluator::EvalPiece after(edited, hand);
+  SearchResult found = optimizer::refinger(
+      evaluator_, before, previous.fingerings, previous.score, after, margin);
+  Result result{std::move(found.fingerings), found.cost, 0, {}};
+  result.stats.wall = Clock::now() - start;
+  return result;
+}
+
+Optimizer::PieceResult Optimizer::refinger_piece(
+    const domain::Piece& previous_piece, const PieceResult& previous,
+    const domain::Piece& edited, size_t margin) {
+  const trace::Span span("optimizer", "refinger_piece");
+  const Clock::time_point start = Clock::now();
+  PieceResult result;
+  parallel_invoke(
+      *pool_,
+      [&] {
+        result.right_hand = refinger(previous_piece, previous.right_hand,
+                                     edited, domain::Hand::kRight, margin);
+      },
+      [&] {
+        result.left_hand = refinger(previous_piece, previous.left_hand,
+                                    edited, domain::Hand::kLeft, margin);
+      });
+  result.score = result.right_hand.score + result.left_hand.score;
+  result.stats = result.right_hand.stats;
+  result.stats += result.left_hand.stats;
+  result.stats.wall = Clock::now() - start;
+  return result;
+}
+
+Optimizer::Result Optimizer::optimize_hand(const evaluator::EvalPiece& piece,
+                                           unsigned int seed,
+                                           const Limits& limits) {
+  if (piece.slice_count() == 0) {
+    return {};
+  }
+  const trace::Span span("optimizer", "hand", "hand",
+                         static_cast<std::int64_t>(piece.hand()));
+  const Clock::time_point start = Clock::now();
+  ImprovementReporter improvements(limits, piece.hand());
+  ResultKey key;
+  if (limits.cache != nullptr) {
+    key = ResultKey{fingerprint(piece), piece.hand(), seed, config_};
+    if (auto cached = limits.cache->find(key)) {
+      improvements.offer(cached->fingerings, cached->score);
+      report(limits, ProgressPhase::kComplete, piece,
+             cached->iterations_performed);
+      Result hit{std::move(cached->fingerings), cached->score,
+                 cached->iterations_performed, {}};
+      hit.stats.result_cache_hits = 1;
+      hit.stats.wall = Clock::now() - start;
+      return hit;
+    }
+  }
+  // Every thread of the pool counts into its own slot
+  ThreadStats thread_stats(*pool_);
+
+  // Phase 1
+  const auto& algorithm = config_.algorithm;
+  report(limits, ProgressPhase::kBeamSearch, piece,
+         algorithm.ils_iterations * algorithm.ils_trajectories);
+
+  const SearchResult initial =
+      algorithm.beam_states_per_slice == 0
+          ? beam_search(evaluator_, piece, algorithm.beam_width, *pool_,
+                        limits.memory, &thread_stats)
+          : beam_search(evaluator_, piece,
+                        BeamBudget{algorithm.beam_width,
+                                   algorithm.beam_states_per_slice *
+                                       piece.slice_count()},
+                        *pool_, limits.memory, &thread_stats);
+  Result result{initial.fingerings, initial.cost, 0, {}};
+  improvements.offer(initial.fingerings, initial.cost);
+
+  // Phase 2: a fixed schedule of independently seeded trajectories, spread
+  // over however many threads the pool has
+  std::vector<IlsResult> results(algorithm.ils_trajectories);
+  size_t wave = results.size();
+  MemoryCharge sessions;
+  if (limits.memory != nullptr) {
+    // Run as many sessions at a time as the budget affords
+    const size_t session_bytes = ils_session_bytes(piece);
+    wave = std::min(wave, limits.memory->available() / session_bytes);
+    if (wave == 0) {
+      wave = 1;  // let MemoryCharge report the shortfall
+    }
+    sessions = MemoryCharge(limits.memory, wave * session_bytes,
+                            "ILS sessions");
+  }
+  // Per-node copies of the hand, read by trajectories on that node
+  std::vector<std::unique_ptr<const evaluator::EvalPiece>> node_pieces(
+      node_evaluators_.size());
+  for (size_t node = 0; node < node_pieces.size(); ++node) {
+    run_on_node(pool_->placement().topology, node, [&] {
+      node_pieces[node] = std::make_unique<const evaluator::EvalPiece>(piece);
+    });
+  }
+  for (size_t begin = 0; begin < results.size(); begin += wave) {
+    const size_t end = std::min(results.size(), begin + wave);
+    parallel_for(*pool_, begin, end, [&](size_t t) {
+      const trace::Span trajectory("ils", "trajectory", "trajectory",
+                                   static_cast<std::int64_t>(t));
+      const ThreadStats::BusyTimer busy(&thread_stats);
+      const evaluator::ScoreEvaluator* evaluator = &evaluator_;
+      const evaluator::EvalPiece* hand = &piece;
+      if (!node_pieces.empty()) {
+        const size_t node = pool_->worker_node(pool_->current_worker());
+        evaluator = &node_evaluators_[node];
+        hand = node_pieces[node].get();
+      }
+      const ScratchScope scratch;
+      IlsOptions options;
+      options.iterations = algorithm.ils_iterations;
+      options.perturbation_strength = algorithm.perturbation_strength;
+      options.seed = trajectory_seed(seed, t);
+      options.stop_token = limits.stop_token;
+      options.deadline = limits.deadline;
+      options.progress = limits.progress;
+      options.stats = &thread_stats.local();
+      options.scratch = scratch.resource();
+      if (improvements.enabled()) {
+        options.on_improvement =
+            [&improvements](const domain::PackedFingeringSequence& fingerings,
+                            double cost) {
+              improvements.offer(fingerings, cost);
+            };
+      }
+      results[t] = ils_improve(*evaluator, *hand, initial.fingerings, options);
+    });
+  }
+
+  // Lowest trajectory index wins ties, keeping the result deterministic
+  for (const IlsResult& trajectory : results) {
+    result.iterations_performed += trajectory.iterations_performed;
+    if (trajectory.cost < result.score) {
+      result.fingerings = trajectory.fingerings;
+      result.score = trajectory.cost;
+    }
+  }
+  report(limits, ProgressPhase::kComplete, piece,
+         result.iterations_performed);
+  result.stats = thread_stats.merged();
+  result.stats.result_cache_misses = limits.cache != nullptr ? 1 : 0;
+  result.stats.wall = Clock::now() - start;
+  const bool unlimited = !limits.deadline && limits.memory == nullptr &&
+                         !limits.stop_token.stop_possible();
+  if (limits.cache != nullptr && unlimited) {
+    limits.cache->insert(
+        key, {result.fingerings, result.score, result.iterations_performed});
+  }
+  return result;
+}
+
+}  // namespace piano_fingering::optimizer
@@ -0,0 +1,56 @@
+#include "optimizer/progress.h"
+
+#include <bit>
+#include <stdexcept>
+
+namespace piano_fingering::optimizer {
+
+ProgressChannel::ProgressChannel(size_t capacity) {
+  if (capacity == 0) {
+    throw std::invalid_argument("ProgressChannel capacity must be > 0");
+  }
+  const size_t size = std::bit_ceil(capacity);
+  cells_ = std::make_unique<Cell[]>(size);
+  mask_ = size - 1;
+  // Cell i is free for the producer at position i
+  for (size_t i = 0; i < size; ++i) {
+    cells_[i].sequence.store(i, std::memory_order_relaxed);
+  }
+}
+
+bool ProgressChannel::publish(const ProgressEvent& event) noexcept {
+  size_t position = tail_.load(std::memory_order_relaxed);
+  for (;;) {
+    Cell& cell = cells_[position & mask_];
+    const size_t sequence = cell.sequence.load(std::memory_order_acquire);
+    if (sequence == position) {
+      if (tail_.compare_exchange_weak(position, position + 1,
+                                      std::memory_order_relaxed)) {
+        cell.event = event;
+        cell.sequence.store(position + 1, std::memory_order_release);
+        return true;
+      }
+    } else if (sequence < position) {
+      // Still holds the event from one lap ago: the queue is full
+      dropped_.fetch_add(1, std::memory_order_relaxed);
+      return false;
+    } else {
+      position = tail_.load(std::memory_order_relaxed);
+    }
+  }
+}
+
+bool ProgressChannel::consume(ProgressEvent& event) noexcept {
+  const size_t position = head_.load(std::memory_order_relaxed);
+  Cell& cell = cells_[position & mask_];
+  if (cell.sequence.load(std::memory_order_acquire) != position + 1) {
+    return false;
+  }
+  event = cell.event;
+  // Free the cell for the producer one lap ahead
+  cell.sequence.store(position + mask_ + 1, std::memory_order_release);
+  head_.store(position + 1, std::memory_order_relaxed);
+  return true;
+}
+
+}  // namespace piano_fingering::optimizer
@@ -0,0 +1,104 @@
+#include "optimizer/result_cache.h"
+
+#include <iterator>
+
+#include "config/fingerprint.h"
+
+namespace piano_fingering::optimizer {
+
+namespace {
+
+// Heap bytes held by one entry, list and index nodes included
+size_t entry_bytes(const CachedResult& result) {
+  constexpr size_t kNodeOverhead = 64;
+  return sizeof(ResultKey) + sizeof(CachedResult) + kNodeOverhead +
+         result.fingerings.size() *
+             (sizeof(domain::PackedFingering) + sizeof(std::uint8_t));
+}
+
+}  // namespace
+
+std::uint64_t fingerprint(const evaluator::EvalPiece& piece) {
+  config::Fingerprinter hasher;
+  hasher.add(static_cast<std::uint64_t>(piece.hand()));
+  hasher.add_all(piece.pitches());
+  hasher.add_all(piece.black_keys());
+  hasher.add_all(piece.slice_offsets());
+  for (size_t s = 0; s < piece.slice_count(); ++s) {
+    hasher.add(static_cast<std::uint64_t>(piece.follows_rest(s)));
+  }
+  return hasher.finish();
+}
+
+size_t ResultKeyHash::operator()(const ResultKey& key) const noexcept {
+  config::Fingerprinter hasher;
+  hasher.add(key.piece);
+  hasher.add(static_cast<std::uint64_t>(key.hand));
+  hasher.add(static_cast<std::uint64_t>(key.seed));
+  hasher.add(config::fingerprint(key.config));
+  return static_cast<size_t>(hasher.finish());
+}
+
+std::optional<CachedResult> ResultCache::find(const ResultKey& key) {
+  std::lock_guard lock(mutex_);
+  const auto it = index_.find(key);
+  if (it == index_.end()) {
+    ++misses_;
+    return std::nullopt;
+  }
+  ++hits_;
+  entries_.splice(entries_.begin(), entries_, it->second);
+  return it->second->result;
+}
+
+void ResultCache::insert(const ResultKey& key, const CachedResult& result) {
+  const size_t cost = entry_bytes(result);
+  std::lock_guard lock(mutex_);
+  if (const auto it = index_.find(key); it != index_.end()) {
+    erase(it->second);
+  }
+  if (cost > limit_) {
+    return;
+  }
+  while (bytes_ + cost > limit_) {
+    erase(std::prev(entries_.end()));
+  }
+  entries_.push_front(Entry{key, result, cost});
+  index_.emplace(key, entries_.begin());
+  bytes_ += cost;
+}
+
+void ResultCache::clear() {
+  std::lock_guard lock(mutex_);
+  entries_.clear();
+  index_.clear();
+  bytes_ = 0;
+}
+
+size_t ResultCache::size() const {
+  std::lock_guard lock(mutex_);
+  return entries_.size();
+}
+
+size_t ResultCache::bytes() const {
+  std::lock_guard lock(mutex_);
+  return bytes_;
+}
+
+size_t ResultCache::hits() const {
+  std::lock_guard lock(mutex_);
+  return hits_;
+}
+
+size_t ResultCache::misses() const {
+  std::lock_guard lock(mutex_);
+  return misses_;
+}
+
+void ResultCache::erase(EntryList::iterator entry) {
+  bytes_ -= entry->bytes;
+  index_.erase(entry->key);
+  entries_.erase(entry);
+}
+
+}  // namespace piano_fingering::optimizer
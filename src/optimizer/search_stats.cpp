@@ -0,0 +1,63 @@
+#include "optimizer/search_stats.h"
+
+#include <algorithm>
+
+namespace piano_fingering::optimizer {
+
+std::chrono::nanoseconds SearchStats::busy() const noexcept {
+  std::chrono::nanoseconds total{0};
+  for (const auto busy : thread_busy) {
+    total += busy;
+  }
+  return total;
+}
+
+SearchStats& SearchStats::operator+=(const SearchStats& other) {
+  full_evaluations += other.full_evaluations;
+  delta_evaluations += other.delta_evaluations;
+  result_cache_hits += other.result_cache_hits;
+  result_cache_misses += other.result_cache_misses;
+  beam_slices += other.beam_slices;
+  beam_children += other.beam_children;
+  beam_bound_pruned += other.beam_bound_pruned;
+  beam_width_pruned += other.beam_width_pruned;
+  beam_kept += other.beam_kept;
+  beam_capacity += other.beam_capacity;
+  transition_fills += other.transition_fills;
+  ils_iterations += other.ils_iterations;
+  ils_improvements += other.ils_improvements;
+  ils_moves += other.ils_moves;
+  ils_tabu_revisits += other.ils_tabu_revisits;
+  thread_busy.resize(std::max(thread_busy.size(), other.thread_busy.size()));
+  for (size_t t = 0; t < other.thread_busy.size(); ++t) {
+    thread_busy[t] += other.thread_busy[t];
+  }
+  wall += other.wall;
+  return *this;
+}
+
+ThreadStats::ThreadStats(const ThreadPool& pool)
+    : pool_(&pool), slots_(pool.thread_count() + 1) {}
+
+SearchStats ThreadStats::merged() const {
+  SearchStats total;
+  for (const Slot& slot : slots_) {
+    total += slot.stats;
+    total.thread_busy.push_back(slot.busy);
+  }
+  return total;
+}
+
+ThreadStats::BusyTimer::BusyTimer(ThreadStats* stats) noexcept
+    : stats_(stats),
+      start_(stats != nullptr ? std::chrono::steady_clock::now()
+                              : std::chrono::steady_clock::time_point{}) {}
+
+ThreadStats::BusyTimer::~BusyTimer() {
+  if (stats_ != nullptr) {
+    stats_->local_slot().busy += std::chrono::duration_cast<
+        std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start_);
+  }
+}
+
+}  // namespace piano_fingering::optimizer
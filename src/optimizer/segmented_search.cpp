@@ -0,0 +1,257 @@
+#include "optimizer/segmented_search.h"
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <numeric>
+#include <stdexcept>
+#include <unordered_map>
+#include <vector>
+
+#include "config/fingerprint.h"
+#include "domain/finger.h"
+#include "domain/packed_fingering.h"
+#include "optimizer/beam_search.h"
+#include "optimizer/exact_search.h"
+#include "optimizer/state_generation.h"
+
+namespace piano_fingering::optimizer {
+
+namespace {
+
+using Sequence = domain::PackedFingeringSequence;
+
+// Every term of the score that reads slice a or slice b = a + 1
+double local_cost(const evaluator::ScoreEvaluator& evaluator,
+                  const evaluator::EvalPiece& piece, const Sequence& states,
+                  size_t a) {
+  const size_t count = states.size();
+  auto at = [&](size_t slice) {
+    return evaluator::ScoreEvaluator::SliceFingering{slice, states[slice]};
+  };
+  double cost = evaluator.evaluate_intra_slice(piece, at(a)) +
+                evaluator.evaluate_intra_slice(piece, at(a + 1));
+  // Transitions into a, a + 1 and a + 2
+  for (size_t t = std::max<size_t>(a, 1); t <= a + 2 && t < count; ++t) {
+    cost += evaluator.evaluate_transition(piece, at(t - 1), at(t));
+  }
+  // Triplets ending at a through a + 3
+  for (size_t t = std::max<size_t>(a, 2); t <= a + 3 && t < count; ++t) {
+    cost += evaluator.evaluate_triplet(piece, at(t - 2), at(t - 1), at(t));
+  }
+  return cost;
+}
+
+// Cheapest intra-slice state of a slice for each leading finger
+std::array<domain::PackedFingering, domain::kFingerCount> best_by_lead(
+    const evaluator::ScoreEvaluator& evaluator,
+    const evaluator::EvalPiece& piece, size_t slice) {
+  std::array<domain::PackedFingering, domain::kFingerCount> best{};
+  std::array<double, domain::kFingerCount> cost{};
+  cost.fill(std::numeric_limits<double>::infinity());
+  for (domain::PackedFingering state :
+       generate_valid_states(piece.slice_size(slice))) {
+    const auto lead = static_cast<size_t>(domain::to_int(*state[0]) - 1);
+    const double intra = evaluator.evaluate_intra_slice(piece, {slice, state});
+    if (intra < cost[lead]) {
+      cost[lead] = intra;
+      best[lead] = state;
+    }
+  }
+  return best;
+}
+
+// Re-chooses slices a and a + 1 against their fixed neighbours; returns the
+// (non-positive) change in total score
+double fix_boundary(const evaluator::ScoreEvaluator& evaluator,
+                    const evaluator::EvalPiece& piece, Sequence& states,
+                    size_t a) {
+  const auto first = best_by_lead(evaluator, piece, a);
+  const auto second = best_by_lead(evaluator, piece, a + 1);
+  const domain::PackedFingering keep_first = states[a];
+  const domain::PackedFingering keep_second = states[a + 1];
+
+  const double before = local_cost(evaluator, piece, states, a);
+  double best = before;
+  domain::PackedFingering best_first = keep_first;
+  domain::PackedFingering best_second = keep_second;
+  for (domain::PackedFingering x : first) {
+    for (domain::PackedFingering y : second) {
+      states.set(a, x);
+      states.set(a + 1, y);
+      const double cost = local_cost(evaluator, piece, states, a);
+      if (cost < best) {
+        best = cost;
+        best_first = x;
+        best_second = y;
+      }
+    }
+  }
+  states.set(a, best_first);
+  states.set(a + 1, best_second);
+  return best - before;
+}
+
+// Pitches are taken relative to the segment's first note
+bool same_shape(const evaluator::EvalPiece& piece, SliceRange a,
+                SliceRange b) {
+  if (a.size() != b.size()) {
+    return false;
+  }
+  for (size_t d = 0; d < a.size(); ++d) {
+    if (piece.slice_size(a.begin + d) != piece.slice_size(b.begin + d)) {
+      return false;
+    }
+  }
+  const size_t a_first = piece.slice_begin(a.begin);
+  const size_t b_first = piece.slice_begin(b.begin);
+  const size_t notes = piece.slice_begin(a.end - 1) +
+                       piece.slice_size(a.end - 1) - a_first;
+  for (size_t k = 0; k < notes; ++k) {
+    if (piece.is_black(a_first + k) != piece.is_black(b_first + k) ||
+        piece.pitch(a_first + k) - piece.pitch(a_first) !=
+            piece.pitch(b_first + k) - piece.pitch(b_first)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+std::uint64_t shape_hash(const evaluator::EvalPiece& piece,
+                         SliceRange segment) {
+  config::Fingerprinter hasher;
+  hasher.add(static_cast<std::uint64_t>(segment.size()));
+  const size_t first = piece.slice_begin(segment.begin);
+  for (size_t s = segment.begin; s < segment.end; ++s) {
+    hasher.add(static_cast<std::uint64_t>(piece.slice_size(s)));
+    for (size_t k = 0; k < piece.slice_size(s); ++k) {
+      const size_t note = piece.slice_begin(s) + k;
+      hasher.add(static_cast<std::uint64_t>(piece.is_black(note)));
+      hasher.add(static_cast<std::uint64_t>(
+          static_cast<std::int64_t>(piece.pitch(note) - piece.pitch(first))));
+    }
+  }
+  return hasher.finish();
+}
+
+}  // namespace
+
+std::vector<size_t> segment_repeats(const evaluator::EvalPiece& piece,
+                                    std::span<const SliceRange> segments) {
+  std::vector<size_t> repeats(segments.size());
+  // First occurrences by shape hash; collisions are told apart by
+  // same_shape()
+  std::unordered_map<std::uint64_t, std::vector<size_t>> shapes;
+  for (size_t i = 0; i < segments.size(); ++i) {
+    repeats[i] = i;
+    if (segments[i].size() == 0) {
+      continue;
+    }
+    auto& candidates = shapes[shape_hash(piece, segments[i])];
+    for (size_t j : candidates) {
+      if (same_shape(piece, segments[j], segments[i])) {
+        repeats[i] = j;
+        break;
+      }
+    }
+    if (repeats[i] == i) {
+      candidates.push_back(i);
+    }
+  }
+  return repeats;
+}
+
+std::vector<SliceRange> split_segments(const evaluator::EvalPiece& piece,
+                                       size_t min_segment_slices) {
+  if (min_segment_slices == 0) {
+    throw std::invalid_argument("Minimum segment length must be positive");
+  }
+  std::vector<SliceRange> segments;
+  const size_t count = piece.slice_count();
+  size_t begin = 0;
+  for (size_t slice = 1; slice < count; ++slice) {
+    const size_t length = slice - begin;
+    const bool new_measure =
+        piece.measure_index(slice) != piece.measure_index(slice - 1);
+    if ((piece.follows_rest(slice) && length >= min_segment_slices) ||
+        (new_measure && length >= 2 * min_segment_slices)) {
+      segments.push_back({begin, slice});
+      begin = slice;
+    }
+  }
+  if (count > 0) {
+    segments.push_back({begin, count});
+  }
+  return segments;
+}
+
+SearchResult segmented_search(const evaluator::ScoreEvaluator& evaluator,
+                              const evaluator::EvalPiece& piece,
+                              ThreadPool& pool,
+                              const SegmentOptions& options) {
+  const auto segments = split_segments(piece, options.min_segment_slices);
+  std::vector<size_t> source(segments.size());
+  if (options.reuse_repeats) {
+    source = segment_repeats(piece, segments);
+  } else {
+    std::iota(source.begin(), source.end(), size_t{0});
+  }
+  // Only the first segment of each shape is searched
+  std::vector<size_t> distinct;
+  for (size_t i = 0; i < segments.size(); ++i) {
+    if (source[i] == i) {
+      distinct.push_back(i);
+    }
+  }
+  std::vector<SearchResult> parts(segments.size());
+  parallel_for(pool, 0, distinct.size(), [&](size_t n) {
+    const size_t i = distinct[n];
+    parts[i] = options.beam_width == 0
+                   ? exact_search(evaluator, piece, segments[i])
+                   : beam_search(evaluator, piece, options.beam_width,
+                                 segments[i]);
+  });
+
+  SearchResult result;
+  result.fingerings.reserve(piece.slice_count());
+  for (size_t i = 0; i < segments.size(); ++i) {
+    const SearchResult& part = parts[source[i]];
+    for (size_t d = 0; d < segments[i].size(); ++d) {
+      result.fingerings.push_back(part.fingerings[d],
+                                  part.fingerings.note_count(d));
+    }
+    result.cost += part.cost;
+  }
+
+  // Add back the terms that straddle a cut: the transition into a segment
+  // and the triplets ending at its first two slices (the second of those
+  // belongs to the next cut when that segment is a single slice)
+  const Sequence& states = result.fingerings;
+  auto at = [&](size_t slice) {
+    return evaluator::ScoreEvaluator::SliceFingering{slice, states[slice]};
+  };
+  for (size_t i = 1; i < segments.size(); ++i) {
+    const size_t cut = segments[i].begin;
+    result.cost += evaluator.evaluate_transition(piece, at(cut - 1), at(cut));
+    if (cut >= 2) {
+      result.cost +=
+          evaluator.evaluate_triplet(piece, at(cut - 2), at(cut - 1), at(cut));
+    }
+    const bool next_is_cut =
+        i + 1 < segments.size() && segments[i + 1].begin == cut + 1;
+    if (cut + 1 < states.size() && !next_is_cut) {
+      result.cost += evaluator.evaluate_triplet(piece, at(cut - 1), at(cut),
+                                                at(cut + 1));
+    }
+  }
+
+  for (size_t i = 1; i < segments.size(); ++i) {
+    result.cost += fix_boundary(evaluator, piece, result.fingerings,
+                                segments[i].begin - 1);
+  }
+  return result;
+}
+
+}  // namespace piano_fingering::optimizer
@@ -0,0 +1,245 @@
+#include "optimizer/streaming_search.h"
+
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <stdexcept>
+#include <vector>
+
+#include "optimizer/state_generation.h"
+
+namespace piano_fingering::optimizer {
+
+namespace {
+
+constexpr double kInfinity = std::numeric_limits<double>::infinity();
+
+// Slices the evaluator's local terms reach: a triplet and its last slice
+constexpr size_t kWindowSlices = 3;
+
+}  // namespace
+
+StreamingSearch::StreamingSearch(const evaluator::ScoreEvaluator& evaluator,
+                                 domain::Hand hand,
+                                 const StreamingOptions& options)
+    : evaluator_(&evaluator), options_(options), window_(hand) {
+  if (options.max_lag == 0) {
+    throw std::invalid_argument("Streaming lag must be positive");
+  }
+  if (options.beam_width == 0) {
+    throw std::invalid_argument("Beam width must be positive");
+  }
+}
+
+size_t StreamingSearch::push(const domain::Slice& slice,
+                             domain::PackedFingeringSequence& committed) {
+  if (!window_.append(slice, 0, source_slices_++)) {
+    return 0;
+  }
+  if (window_.slice_count() > kWindowSlices) {
+    window_.drop_front(window_.slice_count() - kWindowSlices);
+  }
+  const size_t index = window_.slice_count() - 1;
+
+  Layer layer;
+  layer.note_count = static_cast<std::uint8_t>(window_.slice_size(index));
+  layer.intra.fill(kInfinity);
+  for (domain::PackedFingering state :
+       generate_valid_states(window_.slice_size(index))) {
+    const auto lead = static_cast<size_t>(domain::to_int(*state[0]) - 1);
+    const double cost = evaluator_->evaluate_intra_slice(window_, {index, state});
+    if (cost < layer.intra[lead]) {
+      layer.intra[lead] = cost;
+      layer.states[lead] = state;
+    }
+  }
+  if (layers_.empty()) {
+    for (size_t lead = 0; lead < kLeads; ++lead) {
+      if (layer.intra[lead] < kInfinity) {
+        layer.nodes[layer.size++] = {layer.intra[lead], 0,
+                                     static_cast<std::uint8_t>(lead)};
+      }
+    }
+  } else {
+    const Layer* before =
+        layers_.size() >= 2 ? &layers_[layers_.size() - 2] : nullptr;
+    extend(layers_.back(), before, layer);
+  }
+  layers_.push_back(layer);
+
+  const size_t before = committed.size();
+  if (pending() > options_.max_lag) {
+    force_commit(committed);
+  }
+  commit_converged(committed);
+  return committed.size() - before;
+}
+
+double StreamingSearch::finish(domain::PackedFingeringSequence& committed) {
+  double cost = 0.0;
+  if (!layers_.empty()) {
+    const Layer& last = layers_.back();
+    std::uint8_t best = 0;
+    for (std::uint8_t n = 1; n < last.size; ++n) {
+      if (last.nodes[n].cost < last.nodes[best].cost) {
+        best = n;
+      }
+    }
+    cost = last.nodes[best].cost;
+    if (pending() > 0) {
+      commit(layers_.size() - 1, best, committed);
+    }
+  }
+  reset();
+  return cost;
+}
+
+void StreamingSearch::extend(const Layer& previous, const Layer* before,
+                             Layer& layer) const {
+  const size_t index = window_.slice_count() - 1;
+  auto at = [](size_t slice, domain::PackedFingering state) {
+    return evaluator::ScoreEvaluator::SliceFingering{slice, state};
+  };
+
+  // Transitions depend on the two leads only
+  std::array<double, kPairs> transition{};
+  for (size_t prev = 0; prev < kLeads; ++prev) {
+    for (size_t lead = 0; lead < kLeads; ++lead) {
+      const bool open =
+          previous.intra[prev] < kInfinity && layer.intra[lead] < kInfinity;
+      transition[prev * kLeads + lead] =
+          open ? evaluator_->evaluate_transition(
+                     window_, at(index - 1, previous.states[prev]),
+                     at(index, layer.states[lead]))
+               : kInfinity;
+    }
+  }
+
+  // Cheapest path into each (previous lead, lead) pair; earlier parents win
+  // ties, so the search is deterministic
+  std::array<Node, kPairs> best{};
+  for (Node& node : best) {
+    node.cost = kInfinity;
+  }
+  for (std::uint8_t p = 0; p < previous.size; ++p) {
+    const Node& parent = previous.nodes[p];
+    for (size_t lead = 0; lead < kLeads; ++lead) {
+      const size_t pair = parent.lead * kLeads + lead;
+      if (transition[pair] == kInfinity) {
+        continue;
+      }
+      double cost = parent.cost + layer.intra[lead] + transition[pair];
+      if (before != nullptr) {
+        const std::uint8_t grand = before->nodes[parent.parent].lead;
+        cost += evaluator_->evaluate_triplet(
+            window_, at(index - 2, before->states[grand]),
+            at(index - 1, previous.states[parent.lead]),
+            at(index, layer.states[lead]));
+      }
+      if (cost < best[pair].cost) {
+        best[pair] = {cost, p, static_cast<std::uint8_t>(lead)};
+      }
+    }
+  }
+
+  for (const Node& node : best) {
+    if (node.cost < kInfinity) {
+      layer.nodes[layer.size++] = node;
+    }
+  }
+  if (layer.size > options_.beam_width) {
+    // Stable, so equal costs keep pair order
+    std::stable_sort(layer.nodes.begin(), layer.nodes.begin() + layer.size,
+                     [](const Node& a, const Node& b) { return a.cost < b.cost; });
+    layer.size = static_cast<std::uint8_t>(options_.beam_width);
+  }
+}
+
+std::uint8_t StreamingSearch::ancestor(size_t index, std::uint8_t node) const {
+  for (size_t k = layers_.size() - 1; k > index; --k) {
+    node = layers_[k].nodes[node].parent;
+  }
+  return node;
+}
+
+void StreamingSearch::commit(size_t last, std::uint8_t node,
+                             domain::PackedFingeringSequence& committed) {
+  // Walk back to the oldest uncommitted layer, then emit oldest first
+  std::vector<std::uint8_t> leads(last + 1 - committed_layers_);
+  for (size_t k = last + 1; k-- > committed_layers_;) {
+    leads[k - committed_layers_] = layers_[k].nodes[node].lead;
+    node = layers_[k].nodes[node].parent;
+  }
+  for (size_t k = committed_layers_; k <= last; ++k) {
+    const Layer& layer = layers_[k];
+    committed.push_back(layer.states[leads[k - committed_layers_]],
+                        layer.note_count);
+  }
+  committed_layers_ = last + 1;
+  // New slices read only the last two layers
+  while (committed_layers_ > 0 && layers_.size() > 2) {
+    layers_.pop_front();
+    --committed_layers_;
+  }
+}
+
+size_t StreamingSearch::commit_converged(
+    domain::PackedFingeringSequence& committed) {
+  if (pending() == 0) {
+    return 0;
+  }
+  // Nodes of layer k that some surviving path passes through, newest first
+  size_t k = layers_.size() - 1;
+  std::uint32_t live = (std::uint32_t{1} << layers_[k].size) - 1;
+  while (true) {
+    if (std::popcount(live) == 1) {
+      const size_t before = committed.size();
+      commit(k, static_cast<std::uint8_t>(std::countr_zero(live)), committed);
+      return committed.size() - before;
+    }
+    if (k == committed_layers_) {
+      return 0;
+    }
+    std::uint32_t parents = 0;
+    const Layer& layer = layers_[k];
+    for (std::uint8_t n = 0; n < layer.size; ++n) {
+      if ((live >> n) & 1U) {
+        parents |= std::uint32_t{1} << layer.nodes[n].parent;
+      }
+    }
+    live = parents;
+    --k;
+  }
+}
+
+void StreamingSearch::force_commit(domain::PackedFingeringSequence& committed) {
+  // Keep only the paths through the oldest pending slice's state on the
+  // cheapest path, so that slice converges
+  Layer& last = layers_.back();
+  std::uint8_t best = 0;
+  for (std::uint8_t n = 1; n < last.size; ++n) {
+    if (last.nodes[n].cost < last.nodes[best].cost) {
+      best = n;
+    }
+  }
+  const std::uint8_t kept = ancestor(committed_layers_, best);
+  std::uint8_t size = 0;
+  for (std::uint8_t n = 0; n < last.size; ++n) {
+    if (ancestor(committed_layers_, n) == kept) {
+      last.nodes[size++] = last.nodes[n];
+    }
+  }
+  last.size = size;
+  commit_converged(committed);
+}
+
+void StreamingSearch::reset() {
+  window_ = evaluator::EvalPiece(window_.hand());
+  layers_.clear();
+  committed_layers_ = 0;
+  source_slices_ = 0;
+}
+
+}  // namespace piano_fingering::optimizer
@@ -0,0 +1,55 @@
+#include "optimizer/sweep.h"
+
+#include <cstddef>
+#include <vector>
+
+#include "domain/hand.h"
+#include "evaluator/eval_piece.h"
+#include "trace/trace.h"
+
+namespace piano_fingering::optimizer {
+
+std::vector<Optimizer::PieceResult> optimize_sweep(
+    std::span<const config::Config> configs, const domain::Piece& piece,
+    unsigned int seed, ThreadPool& pool) {
+  return optimize_sweep(configs, piece, seed, pool, Optimizer::Limits{});
+}
+
+std::vector<Optimizer::PieceResult> optimize_sweep(
+    std::span<const config::Config> configs, const domain::Piece& piece,
+    unsigned int seed, ThreadPool& pool, const Optimizer::Limits& limits) {
+  const trace::Span span("optimizer", "sweep");
+  std::vector<Optimizer> optimizers;
+  optimizers.reserve(configs.size());
+  for (const config::Config& config : configs) {
+    optimizers.emplace_back(config, pool);
+  }
+  const evaluator::EvalPiece right(piece, domain::Hand::kRight);
+  const evaluator::EvalPiece left(piece, domain::Hand::kLeft);
+
+  const Optimizer::Clock::time_point start = Optimizer::Clock::now();
+  std::vector<Optimizer::PieceResult> results(configs.size());
+  TaskGroup group(pool);
+  for (size_t i = 0; i < optimizers.size(); ++i) {
+    group.run([&, i] {
+      results[i].right_hand = optimizers[i].optimize(right, seed, limits);
+    });
+    group.run([&, i] {
+      results[i].left_hand = optimizers[i].optimize(left, seed, limits);
+    });
+  }
+  group.wait();
+
+  const auto wall = Optimizer::Clock::now() - start;
+  for (Optimizer::PieceResult& result : results) {
+    result.score = result.right_hand.score + result.left_hand.score;
+    result.iterations_performed = result.right_hand.iterations_performed +
+                                  result.left_hand.iterations_performed;
+    result.stats = result.right_hand.stats;
+    result.stats += result.left_hand.stats;
+    result.stats.wall = wall;
+  }
+  return results;
+}
+
+}  // namespace piano_fingering::optimizer
@@ -0,0 +1,321 @@
+#include "optimizer/thread_pool.h"
+
+#include <limits>
+#include <stdexcept>
+#include <string>
+
+#include "trace/trace.h"
+
+namespace piano_fingering::optimizer {
+
+namespace {
+
+constexpr size_t kNotAWorker = std::numeric_limits<size_t>::max();
+
+// Pool and deque index of the calling thread, if it is a worker
+thread_local const ThreadPool* current_pool = nullptr;
+thread_local size_t current_index = kNotAWorker;
+
+// Scratch arena of the calling worker, if its pool has arenas
+thread_local detail::WorkerArena* current_arena = nullptr;
+
+}  // namespace
+
+namespace detail {
+
+// Monotonic arena over a buffer the worker allocates and touches itself,
+// so its pages sit on the worker's node. Overflow spills to the heap until
+// the next rewind.
+class WorkerArena {
+ public:
+  explicit WorkerArena(size_t bytes)
+      : buffer_(std::make_unique<std::byte[]>(bytes)),
+        resource_(buffer_.get(), bytes) {}
+
+  std::pmr::memory_resource* open() noexcept {
+    ++depth_;
+    return &resource_;
+  }
+
+  void close() noexcept {
+    if (--depth_ == 0) {
+      resource_.release();  // back to the start of buffer_
+    }
+  }
+
+ private:
+  std::unique_ptr<std::byte[]> buffer_;
+  std::pmr::monotonic_buffer_resource resource_;
+  size_t depth_{0};
+};
+
+}  // namespace detail
+
+// Growable ring buffer of tasks behind its own lock; kept on its own cache
+// line so neighbouring deques do not false-share
+class alignas(64) ThreadPool::Queue {
+ public:
+  Queue() : buffer_(kInitialCapacity) {}
+
+  void push_back(Task task) {
+    const std::lock_guard lock(mutex_);
+    if (count_ == buffer_.size()) {
+      grow();
+    }
+    buffer_[wrap(head_ + count_)] = std::move(task);
+    ++count_;
+  }
+
+  bool pop_back(Task& task) {
+    const std::lock_guard lock(mutex_);
+    if (count_ == 0) {
+      return false;
+    }
+    --count_;
+    task = std::move(buffer_[wrap(head_ + count_)]);
+    return true;
+  }
+
+  bool steal_front(Task& task) {
+    const std::lock_guard lock(mutex_);
+    if (count_ == 0) {
+      return false;
+    }
+    task = std::move(buffer_[head_]);
+    head_ = wrap(head_ + 1);
+    --count_;
+    return true;
+  }
+
+ private:
+  // Power of two, so wrap() is a mask
+  static constexpr size_t kInitialCapacity = 64;
+
+  [[nodiscard]] size_t wrap(size_t index) const noexcept {
+    return index & (buffer_.size() - 1);
+  }
+
+  void grow() {
+    std::vector<Task> larger(buffer_.size() * 2);
+    for (size_t i = 0; i < count_; ++i) {
+      larger[i] = std::move(buffer_[wrap(head_ + i)]);
+    }
+    buffer_.swap(larger);
+    head_ = 0;
+  }
+
+  std::mutex mutex_;
+  std::vector<Task> buffer_;
+  size_t head_{0};
+  size_t count_{0};
+};
+
+size_t ThreadPool::default_thread_count() noexcept {
+  const unsigned int hardware = std::thread::hardware_concurrency();
+  return hardware == 0 ? 1 : hardware;
+}
+
+ThreadPool::ThreadPool(size_t thread_count)
+    : ThreadPool(thread_count, WorkerPlacement{}) {}
+
+ThreadPool::ThreadPool(size_t thread_count, WorkerPlacement placement)
+    : placement_(std::move(placement)) {
+  if (thread_count == 0) {
+    throw std::invalid_argument("Thread pool needs at least one thread");
+  }
+  // Only consulted when asked for, so default pools never probe the OS or
+  // allocate per-worker placement state
+  if (placement_.pin_workers) {
+    if (placement_.topology.empty()) {
+      placement_.topology = CpuTopology::detect();
+    }
+    worker_nodes_.assign(thread_count, 0);
+  }
+  if (placement_.arena_bytes > 0) {
+    arenas_.resize(thread_count);
+  }
+  queues_.reserve(thread_count);
+  for (size_t i = 0; i < thread_count; ++i) {
+    queues_.push_back(std::make_unique<Queue>());
+  }
+  std::latch ready(static_cast<std::ptrdiff_t>(thread_count));
+  threads_.reserve(thread_count);
+  for (size_t i = 0; i < thread_count; ++i) {
+    threads_.emplace_back([this, i, &ready] { work(i, ready); });
+  }
+  ready.wait();
+}
+
+ThreadPool::~ThreadPool() {
+  {
+    const std::lock_guard lock(sleep_mutex_);
+    stop_ = true;
+  }
+  wake_.notify_all();
+  for (std::thread& thread : threads_) {
+    thread.join();
+  }
+}
+
+void ThreadPool::push(Task task) {
+  const size_t index =
+      current_pool == this
+          ? current_index
+          : next_queue_.fetch_add(1, std::memory_order_relaxed) %
+                queues_.size();
+  queues_[index]->push_back(std::move(task));
+
+  // Pairs with the sleeper check in work(): either the sleeper sees the new
+  // count or we see the sleeper and notify under its mutex
+  queued_.fetch_add(1);
+  if (sleepers_.load() > 0) {
+    { const std::lock_guard lock(sleep_mutex_); }
+    wake_.notify_one();
+  }
+}
+
+bool ThreadPool::acquire(Task& task, size_t home) {
+  const size_t count = queues_.size();
+  bool found = false;
+  if (home != kNotAWorker) {
+    found = queues_[home]->pop_back(task);
+  } else {
+    home = next_queue_.load(std::memory_order_relaxed) % count;
+    found = queues_[home]->steal_front(task);
+  }
+  for (size_t step = 1; !found && step < count; ++step) {
+    found = queues_[(home + step) % count]->steal_front(task);
+  }
+  if (found) {
+    queued_.fetch_sub(1);
+  }
+  return found;
+}
+
+size_t ThreadPool::current_worker() const noexcept {
+  return current_pool == this ? current_index : thread_count();
+}
+
+bool ThreadPool::run_pending_task() {
+  Task task;
+  if (!acquire(task, current_pool == this ? current_index : kNotAWorker)) {
+    return false;
+  }
+  const trace::Span span("pool", "task");
+  task();
+  return true;
+}
+
+void ThreadPool::place(size_t index) {
+  const CpuTopology& topology = placement_.topology;
+  if (placement_.pin_workers && !topology.empty()) {
+    // Round-robin over the nodes, then over each node's CPUs
+    const size_t node = index % topology.node_count();
+    const std::vector<unsigned>& cpus = topology.cpus(node);
+    const unsigned cpu = cpus[(index / topology.node_count()) % cpus.size()];
+    if (pin_current_thread({&cpu, 1})) {
+      worker_nodes_[index] = node;
+      pinned_workers_.fetch_add(1, std::memory_order_relaxed);
+    }
+  }
+  if (placement_.arena_bytes > 0) {
+    arenas_[index] =
+        std::make_unique<detail::WorkerArena>(placement_.arena_bytes);
+    current_arena = arenas_[index].get();
+  }
+}
+
+void ThreadPool::work(size_t index, std::latch& ready) {
+  current_pool = this;
+  current_index = index;
+  if constexpr (trace::kCompiledIn) {
+    trace::set_thread_name("worker " + std::to_string(index));
+  }
+  place(index);
+  ready.count_down();
+  Task task;
+  while (true) {
+    if (acquire(task, index)) {
+      {
+        // Gaps between these on a worker's track are idle time
+        const trace::Span span("pool", "task");
+        task();
+      }
+      task = Task();
+      continue;
+    }
+    std::unique_lock lock(sleep_mutex_);
+    if (stop_ && queued_.load() <= 0) {
+      return;
+    }
+    sleepers_.fetch_add(1);
+    wake_.wait(lock, [this] { return stop_ || queued_.load() > 0; });
+    sleepers_.fetch_sub(1);
+  }
+}
+
+ScratchScope::ScratchScope() noexcept
+    : arena_(current_arena),
+      resource_(arena_ != nullptr ? arena_->open()
+                                  : std::pmr::get_default_resource()) {}
+
+ScratchScope::~ScratchScope() {
+  if (arena_ != nullptr) {
+    arena_->close();
+  }
+}
+
+TaskGroup::~TaskGroup() {
+  try {
+    wait();
+  } catch (...) {
+    // Destruction discards task errors; call wait() to observe them
+  }
+}
+
+void TaskGroup::wait() {
+  // Help while there is work; block once the remaining tasks are running
+  while (pending_.load(std::memory_order_acquire) != 0) {
+    if (pool_->run_pending_task()) {
+      continue;
+    }
+    std::unique_lock lock(mutex_);
+    done_.wait(lock, [this] {
+      return pending_.load(std::memory_order_acquire) == 0;
+    });
+  }
+  std::exception_ptr error;
+  {
+    // Also orders us after the final finish(), which decrements under lock
+    const std::lock_guard lock(mutex_);
+    error = std::exchange(error_, nullptr);
+  }
+  if (error) {
+    std::rethrow_exception(error);
+  }
+}
+
+void TaskGroup::record(std::exception_ptr error) {
+  const std::lock_guard lock(mutex_);
+  if (!error_) {
+    error_ = std::move(error);
+  }
+}
+
+void TaskGroup::finish() {
+  size_t expected = pending_.load(std::memory_order_relaxed);
+  while (expected > 1) {
+    if (pending_.compare_exchange_weak(expected, expected - 1,
+                                       std::memory_order_acq_rel)) {
+      return;
+    }
+  }
+  // Possibly the last task: decrement under the lock so a waiter cannot
+  // destroy the group before we are done with it
+  const std::lock_guard lock(mutex_);
+  if (pending_.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+    done_.notify_all();
+  }
+}
+
+}  // namespace piano_fingering::optimizer
@@ -0,0 +1,106 @@
+#include "optimizer/transition_cache.h"
+
+#include <optional>
+#include <stdexcept>
+
+namespace piano_fingering::optimizer {
+
+namespace {
+
+using SliceFingering = evaluator::ScoreEvaluator::SliceFingering;
+
+// Slice led by `finger`; the leading note is all the sequential terms read
+SliceFingering led_by(size_t slice, domain::Finger finger) {
+  domain::PackedFingering fingering;
+  fingering.set(0, finger);
+  return {slice, fingering};
+}
+
+domain::Finger leading_finger(domain::PackedFingering state) {
+  const std::optional<domain::Finger> finger = state[0];
+  if (!finger.has_value()) {
+    throw std::invalid_argument("State must finger its first note");
+  }
+  return *finger;
+}
+
+}  // namespace
+
+TransitionCache::TransitionCache(const evaluator::ScoreEvaluator& evaluator,
+                                 const evaluator::EvalPiece& piece,
+                                 size_t capacity)
+    : evaluator_(&evaluator), piece_(&piece) {
+  if (capacity == 0) {
+    throw std::invalid_argument("Transition cache capacity must be positive");
+  }
+  slots_.resize(capacity);
+}
+
+double TransitionCache::transition(size_t slice, domain::Finger prev,
+                                   domain::Finger curr) {
+  if (slice < 1 || slice >= piece_->slice_count()) {
+    throw std::out_of_range("Transition slice out of range");
+  }
+  Slot& entry = slot(slice);
+  if (entry.transition_slice != slice) {
+    fill_transitions(entry, slice);
+  }
+  return entry.transitions[finger_index(prev) * domain::kFingerCount +
+                           finger_index(curr)];
+}
+
+double TransitionCache::triplet(size_t slice, domain::Finger first,
+                                domain::Finger middle, domain::Finger last) {
+  if (slice < 2 || slice >= piece_->slice_count()) {
+    throw std::out_of_range("Triplet slice out of range");
+  }
+  Slot& entry = slot(slice);
+  if (entry.triplet_slice != slice) {
+    fill_triplets(entry, slice);
+  }
+  return entry.triplets[(finger_index(first) * domain::kFingerCount +
+                         finger_index(middle)) *
+                            domain::kFingerCount +
+                        finger_index(last)];
+}
+
+double TransitionCache::transition(size_t slice, domain::PackedFingering prev,
+                                   domain::PackedFingering curr) {
+  return transition(slice, leading_finger(prev), leading_finger(curr));
+}
+
+double TransitionCache::triplet(size_t slice, domain::PackedFingering first,
+                                domain::PackedFingering middle,
+                                domain::PackedFingering last) {
+  return triplet(slice, leading_finger(first), leading_finger(middle),
+                 leading_finger(last));
+}
+
+void TransitionCache::fill_transitions(Slot& entry, size_t slice) {
+  size_t i = 0;
+  for (domain::Finger prev : domain::all_fingers()) {
+    for (domain::Finger curr : domain::all_fingers()) {
+      entry.transitions[i++] = evaluator_->evaluate_transition(
+          *piece_, led_by(slice - 1, prev), led_by(slice, curr));
+    }
+  }
+  entry.transition_slice = slice;
+  ++fill_count_;
+}
+
+void TransitionCache::fill_triplets(Slot& entry, size_t slice) {
+  size_t i = 0;
+  for (domain::Finger first : domain::all_fingers()) {
+    for (domain::Finger middle : domain::all_fingers()) {
+      for (domain::Finger last : domain::all_fingers()) {
+        entry.triplets[i++] = evaluator_->evaluate_triplet(
+            *piece_, led_by(slice - 2, first), led_by(slice - 1, middle),
+            led_by(slice, last));
+      }
+    }
+  }
+  entry.triplet_slice = slice;
+  ++fill_count_;
+}
+
+}  // namespace piano_fingering::optimizer
@@ -0,0 +1,141 @@
+#include "optimizer/worker_placement.h"
+
+#include <algorithm>
+#include <utility>
+
+#if defined(__linux__)
+#include <pthread.h>
+#include <sched.h>
+
+#include <cctype>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <system_error>
+#endif
+
+namespace piano_fingering::optimizer {
+
+namespace {
+
+#if defined(__linux__)
+// "0-3,8,10-11" as sysfs writes it; stops at the first malformed range
+std::vector<unsigned> parse_cpu_list(const std::string& list) {
+  std::vector<unsigned> cpus;
+  size_t pos = 0;
+  while (pos < list.size()) {
+    size_t end = list.find(',', pos);
+    if (end == std::string::npos) {
+      end = list.size();
+    }
+    const std::string range = list.substr(pos, end - pos);
+    const size_t dash = range.find('-');
+    try {
+      const auto first = static_cast<unsigned>(std::stoul(range));
+      const auto last = dash == std::string::npos
+                            ? first
+                            : static_cast<unsigned>(
+                                  std::stoul(range.substr(dash + 1)));
+      for (unsigned cpu = first; cpu <= last; ++cpu) {
+        cpus.push_back(cpu);
+      }
+    } catch (const std::exception&) {
+      break;
+    }
+    pos = end + 1;
+  }
+  return cpus;
+}
+
+// Node number of a sysfs "node<N>" entry, or -1 for anything else
+long node_number(const std::string& name) {
+  if (name.size() <= 4 || name.compare(0, 4, "node") != 0 ||
+      !std::all_of(name.begin() + 4, name.end(),
+                   [](unsigned char c) { return std::isdigit(c) != 0; })) {
+    return -1;
+  }
+  return std::stol(name.substr(4));
+}
+#endif
+
+}  // namespace
+
+CpuTopology::CpuTopology(std::vector<std::vector<unsigned>> nodes) {
+  for (auto& cpus : nodes) {
+    if (!cpus.empty()) {
+      nodes_.push_back(std::move(cpus));
+    }
+  }
+}
+
+CpuTopology CpuTopology::detect() {
+#if defined(__linux__)
+  cpu_set_t allowed;
+  CPU_ZERO(&allowed);
+  if (sched_getaffinity(0, sizeof(allowed), &allowed) != 0) {
+    return {};
+  }
+  const auto is_allowed = [&allowed](unsigned cpu) {
+    return cpu < CPU_SETSIZE && CPU_ISSET(cpu, &allowed);
+  };
+
+  std::vector<std::pair<long, std::vector<unsigned>>> numbered;
+  std::error_code error;
+  for (std::filesystem::directory_iterator it("/sys/devices/system/node",
+                                              error);
+       !error && it != std::filesystem::directory_iterator();
+       it.increment(error)) {
+    const long number = node_number(it->path().filename().string());
+    if (number < 0) {
+      continue;
+    }
+    std::ifstream file(it->path() / "cpulist");
+    std::string list;
+    std::getline(file, list);
+    std::vector<unsigned> cpus = parse_cpu_list(list);
+    std::erase_if(cpus, [&](unsigned cpu) { return !is_allowed(cpu); });
+    numbered.emplace_back(number, std::move(cpus));
+  }
+  std::sort(numbered.begin(), numbered.end());
+
+  std::vector<std::vector<unsigned>> nodes;
+  for (auto& [number, cpus] : numbered) {
+    nodes.push_back(std::move(cpus));
+  }
+  if (std::all_of(nodes.begin(), nodes.end(),
+                  [](const auto& cpus) { return cpus.empty(); })) {
+    // No NUMA information: every allowed CPU on one node
+    nodes.assign(1, {});
+    for (unsigned cpu = 0; cpu < CPU_SETSIZE; ++cpu) {
+      if (is_allowed(cpu)) {
+        nodes.front().push_back(cpu);
+      }
+    }
+  }
+  return CpuTopology(std::move(nodes));
+#else
+  return {};
+#endif
+}
+
+bool pin_current_thread(
+    [[maybe_unused]] std::span<const unsigned> cpus) noexcept {
+#if defined(__linux__)
+  if (cpus.empty()) {
+    return false;
+  }
+  cpu_set_t set;
+  CPU_ZERO(&set);
+  for (const unsigned cpu : cpus) {
+    if (cpu >= CPU_SETSIZE) {
+      return false;
+    }
+    CPU_SET(cpu, &set);
+  }
+  return pthread_setaffinity_np(pthread_self(), sizeof(set), &set) == 0;
+#else
+  return false;
+#endif
+}
+
+}  // namespace piano_fingering::optimizer
@@ -2,17 +2,37 @@
 
 #include "parser/musicxml_parser.h"
 
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
 #include <fstream>
-#include <iostream>
+#include <iterator>
+#include <limits>
+#include <memory>
+#include <new>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <utility>
 #include <vector>
 
+#include "domain/inline_vector.h"
 #include "domain/measure.h"
 #include "domain/metadata.h"
 #include "domain/note.h"
 #include "domain/piece.h"
 #include "domain/slice.h"
+#include "domain/source_map.h"
 #include "domain/time_signature.h"
+#include "parser/piece_cache.h"
 #include "parser/pitch_mapping.h"
+#include "parser/xml_reader.h"
+#include "parser/zip_archive.h"
+#include "trace/trace.h"
 
 namespace piano_fingering::parser {
 
@@ -38,151 +58,503 @@ domain::Metadata extract_metadata(const pugi::xml_node& root) {
   return {std::move(title), std::move(composer)};
 }
 
-// Extract time signature from attributes node
-domain::TimeSignature extract_time_signature(const pugi::xml_node& attributes) {
-  auto time = attributes.child("time");
-  if (!time) {
-    return domain::common_time();  // Default to 4/4
+// Text of an element, as both parse modes see it: nullopt if the element
+// is absent or has no text
+using ElementText = std::optional<std::string_view>;
+
+// pugixml's xml_text::as_int() and as_uint(), shared by both parse modes so
+// they read numbers identically: leading whitespace, a sign, then decimal
+// or 0x hex digits up to the first other character, saturating at the
+// limits of Int. An element without text reads as `fallback`.
+template <class Int>
+Int to_integer(ElementText text, Int fallback) noexcept {
+  if (!text.has_value()) {
+    return fallback;
   }
+  const std::string_view s = *text;
+  size_t i = s.find_first_not_of(" \t\n\r");
+  if (i == std::string_view::npos) {
+    i = s.size();
+  }
+  const bool negative = i < s.size() && s[i] == '-';
+  if (i < s.size() && (s[i] == '-' || s[i] == '+')) {
+    ++i;
+  }
+  uint64_t base = 10;
+  if (i + 1 < s.size() && s[i] == '0' && (s[i + 1] | ' ') == 'x') {
+    base = 16;
+    i += 2;
+  }
+  uint64_t magnitude = 0;
+  bool overflow = false;
+  for (; i < s.size(); ++i) {
+    const char c = s[i];
+    uint64_t digit = 0;
+    if (c >= '0' && c <= '9') {
+      digit = static_cast<uint64_t>(c - '0');
+    } else if (base == 16 && (c | ' ') >= 'a' && (c | ' ') <= 'f') {
+      digit = static_cast<uint64_t>((c | ' ') - 'a' + 10);
+    } else {
+      break;
+    }
+    overflow = overflow || magnitude > (UINT64_MAX - digit) / base;
+    magnitude = magnitude * base + digit;
+  }
+  using Limits = std::numeric_limits<Int>;
+  if (negative) {
+    const uint64_t limit =
+        Limits::is_signed ? uint64_t{0} - static_cast<uint64_t>(Limits::min())
+                          : 0;
+    return overflow || magnitude > limit
+               ? Limits::min()
+               : static_cast<Int>(0 - static_cast<int64_t>(magnitude));
+  }
+  return overflow || magnitude > static_cast<uint64_t>(Limits::max())
+             ? Limits::max()
+             : static_cast<Int>(magnitude);
+}
 
-  int numerator = time.child("beats").text().as_int(4);
-  int denominator = time.child("beat-type").text().as_int(4);
-
-  return {numerator, denominator};
+// Of an <attributes> element's first <time>: 4/4 without one
+domain::TimeSignature time_signature(bool has_time, ElementText beats,
+                                     ElementText beat_type) {
+  if (!has_time) {
+    return domain::common_time();
+  }
+  return {to_integer(beats, 4), to_integer(beat_type, 4)};
 }
 
-// Extract single note from XML node
-domain::Note extract_note(const pugi::xml_node& note_node) {
-  // Check if it's a rest
-  bool is_rest = note_node.child("rest") != nullptr;
+// Marks a note whose <note> element has no usable source offset
+constexpr uint32_t kNoOffset = UINT32_MAX;
+
+// What read_note() looks at in a <note>: which children it has and the
+// text of the first child of each name, as both parse modes read them
+struct NoteElement {
+  bool rest{false};
+  bool chord{false};
+  bool pitch{false};
+  // Of the first <pitch>
+  bool step{false};
+  bool duration{false};
+  ElementText staff;
+  ElementText step_text;
+  ElementText alter;
+  ElementText octave;
+  ElementText duration_text;
+  ElementText voice;
+  // Of the <note> element's '<' in the score text
+  uint32_t offset{kNoOffset};
+};
+
+// Reads one note without throwing; returns nullopt and sets `problem` if
+// the element is incomplete or out of range. The staff is checked first so
+// notes that belong to neither hand are rejected before anything else.
+std::optional<domain::Note> read_note(const NoteElement& element,
+                                      const char*& problem) {
+  int staff = to_integer(element.staff, kRightHandStaff);
+  if (staff != kRightHandStaff && staff != kLeftHandStaff) {
+    problem = "Staff must be 1 or 2";
+    return std::nullopt;
+  }
 
-  // Extract pitch (or default for rests)
+  bool is_rest = element.rest;
   domain::Pitch pitch(0);
   int octave = 4;
 
   if (!is_rest) {
-    auto pitch_node = note_node.child("pitch");
-    if (!pitch_node) {
-      throw MissingElementError("pitch");
+    if (!element.pitch) {
+      problem = "Missing required element: pitch";
+      return std::nullopt;
     }
-
-    auto step_node = pitch_node.child("step");
-    if (!step_node) {
-      throw MissingElementError("step");
+    if (!element.step) {
+      problem = "Missing required element: step";
+      return std::nullopt;
+    }
+    int alter = to_integer(element.alter, 0);
+    auto mapped =
+        try_step_alter_to_pitch(element.step_text.value_or(""), alter);
+    if (!mapped.has_value()) {
+      problem = "Invalid step: must be A-G";
+      return std::nullopt;
+    }
+    pitch = *mapped;
+    octave = to_integer(element.octave, 4);
+    if (octave < 0 || octave > 10) {
+      problem = "Octave must be in range [0, 10]";
+      return std::nullopt;
     }
-
-    std::string step = step_node.text().as_string();
-    int alter = pitch_node.child("alter").text().as_int(0);
-    octave = pitch_node.child("octave").text().as_int(4);
-
-    pitch = step_alter_to_pitch(step, alter);
   }
 
-  // Extract duration
-  auto duration_node = note_node.child("duration");
-  if (!duration_node) {
-    throw MissingElementError("duration");
+  if (!element.duration) {
+    problem = "Missing required element: duration";
+    return std::nullopt;
+  }
+  uint32_t duration = to_integer(element.duration_text, 0U);
+  if (duration == 0) {
+    problem = "Duration must be > 0";
+    return std::nullopt;
   }
-  uint32_t duration = duration_node.text().as_uint(0);
 
-  // Extract staff (default to right hand)
-  int staff = note_node.child("staff").text().as_int(kRightHandStaff);
+  int voice = to_integer(element.voice, 1);
+  if (voice < 1 || voice > 4) {
+    problem = "Voice must be in range [1, 4]";
+    return std::nullopt;
+  }
 
-  // Extract voice (default to 1)
-  int voice = note_node.child("voice").text().as_int(1);
+  // Every field was validated above, so this cannot throw
+  return domain::Note(pitch, octave, duration, is_rest, staff, voice);
+}
 
-  return {pitch, octave, duration, is_rest, staff, voice};
+uint32_t to_offset(size_t offset) noexcept {
+  return offset < kNoOffset ? static_cast<uint32_t>(offset) : kNoOffset;
 }
 
-// Container for measure data (both hands + metadata)
-struct MeasureData {
-  std::vector<domain::Slice> rh_slices;
-  std::vector<domain::Slice> lh_slices;
-  domain::TimeSignature time_sig{4, 4};
-  int number = 1;
+struct LocatedNote {
+  domain::Note note;
+  uint32_t offset;
 };
 
-// Extract slices from a measure for a specific staff (helper)
-std::vector<domain::Slice> extract_slices_for_staff(
-    const pugi::xml_node& measure_node, int staff_filter) {
+// Slices of one staff and the source offsets of their notes (in sorted
+// slice order), plus the chord being assembled
+struct StaffSlices {
   std::vector<domain::Slice> slices;
-  std::vector<domain::Note> current_chord;
+  std::vector<uint32_t> offsets;
+  domain::InlineVector<LocatedNote, domain::kMaxNotesPerSlice> chord;
 
-  for (auto note_node : measure_node.children("note")) {
-    try {
-      domain::Note note = extract_note(note_node);
+  void flush() {
+    if (chord.empty()) {
+      return;
+    }
+    // Sorted as the Slice sorts its notes, so offsets line up with them
+    std::stable_sort(chord.begin(), chord.end(),
+                     [](const LocatedNote& a, const LocatedNote& b) {
+                       return a.note < b.note;
+                     });
+    domain::InlineVector<domain::Note, domain::kMaxNotesPerSlice> notes;
+    for (const LocatedNote& located : chord) {
+      notes.push_back(located.note);
+      offsets.push_back(located.offset);
+    }
+    slices.emplace_back(notes.begin(), notes.end());
+    chord = {};
+  }
+};
 
-      // Filter by staff
-      if (note.staff() != staff_filter) {
-        continue;
-      }
+void warn(std::vector<std::string>& warnings, int measure,
+          std::string_view problem) {
+  std::string message = "Measure " + std::to_string(measure) +
+                        ": skipping note: ";
+  message += problem;
+  warnings.push_back(std::move(message));
+}
 
-      // Check if this note is part of a chord
-      bool is_chord = note_node.child("chord") != nullptr;
+// Both staves of one measure, filled a note at a time in score order;
+// skipped notes are reported through `warnings`
+struct MeasureSlices {
+  int number;
+  StaffSlices right;
+  StaffSlices left;
+
+  void add(const NoteElement& element, std::vector<std::string>& warnings) {
+    const char* problem = nullptr;
+    auto note = read_note(element, problem);
+    if (!note.has_value()) {
+      warn(warnings, number, problem);
+      return;
+    }
 
-      if (is_chord) {
-        // Add to current chord
-        current_chord.push_back(note);
-      } else {
-        // Finalize previous chord if exists
-        if (!current_chord.empty()) {
-          slices.emplace_back(std::move(current_chord));
-          current_chord.clear();
-        }
-        // Start new chord with this note
-        current_chord.push_back(note);
-      }
-    } catch (const std::exception& e) {
-      std::cerr << "Warning: Skipping note: " << e.what() << "\n";
+    StaffSlices& staff = note->staff() == kRightHandStaff ? right : left;
+    // A note without <chord/> starts a new slice
+    if (!element.chord) {
+      staff.flush();
+    } else if (staff.chord.size() == domain::kMaxNotesPerSlice) {
+      warn(warnings, number, "Slice cannot contain more than 5 notes");
+      return;
     }
+    staff.chord.push_back({*note, element.offset});
   }
+};
 
-  // Finalize last chord
-  if (!current_chord.empty()) {
-    slices.emplace_back(std::move(current_chord));
+// The <part> with the given id, or the first part if the id is empty
+pugi::xml_node find_part(const pugi::xml_node& root,
+                         const std::string& part_id) {
+  if (part_id.empty()) {
+    auto part = root.child("part");
+    if (!part) {
+      throw MissingElementError("part");
+    }
+    return part;
   }
+  auto part = root.find_child_by_attribute("part", "id", part_id.c_str());
+  if (!part) {
+    throw MissingElementError("part with id '" + part_id + "'");
+  }
+  return part;
+}
 
-  return slices;
+// Measures of one part, split by hand, in score order
+struct PartMeasures {
+  std::vector<domain::Measure> right;
+  std::vector<domain::Measure> left;
+  domain::SourceMap source_map;
+  std::vector<std::string> warnings;
+};
+
+template <class T>
+void append(std::vector<T>& to, std::vector<T>& from) {
+  to.insert(to.end(), std::make_move_iterator(from.begin()),
+            std::make_move_iterator(from.end()));
 }
 
-// Extract measure data (both staves + metadata)
-MeasureData extract_measure(const pugi::xml_node& measure_node,
-                            domain::TimeSignature current_time_sig) {
-  MeasureData data;
+// Ends `measure`, adding each hand's slices to `out` unless it has none
+void append_measure(MeasureSlices& measure, domain::TimeSignature time_sig,
+                    PartMeasures& out) {
+  measure.right.flush();
+  measure.left.flush();
+  if (!measure.right.slices.empty()) {
+    out.right.emplace_back(measure.number, std::move(measure.right.slices),
+                           time_sig);
+    append(out.source_map.right_hand, measure.right.offsets);
+  }
+  if (!measure.left.slices.empty()) {
+    out.left.emplace_back(measure.number, std::move(measure.left.slices),
+                          time_sig);
+    append(out.source_map.left_hand, measure.left.offsets);
+  }
+}
 
-  // Extract measure number
-  data.number = measure_node.attribute("number").as_int(1);
+ElementText node_text(const pugi::xml_node& node) {
+  const pugi::xml_text text = node.text();
+  if (!text) {
+    return std::nullopt;
+  }
+  return std::string_view(text.get());
+}
 
-  // Check for time signature change
-  auto attributes = measure_node.child("attributes");
-  if (attributes == nullptr) {
-    data.time_sig = current_time_sig;
-  } else {
-    data.time_sig = extract_time_signature(attributes);
+ElementText attribute_text(const pugi::xml_node& node, const char* name) {
+  const pugi::xml_attribute attribute = node.attribute(name);
+  if (!attribute) {
+    return std::nullopt;
   }
+  return std::string_view(attribute.value());
+}
 
-  // Extract slices for both staves
-  data.rh_slices = extract_slices_for_staff(measure_node, kRightHandStaff);
-  data.lh_slices = extract_slices_for_staff(measure_node, kLeftHandStaff);
+// The DOM's view of a <note>
+NoteElement note_element(const pugi::xml_node& note_node) {
+  NoteElement element;
+  element.rest = note_node.child("rest") != nullptr;
+  element.chord = note_node.child("chord") != nullptr;
+  const pugi::xml_node pitch = note_node.child("pitch");
+  element.pitch = pitch != nullptr;
+  const pugi::xml_node step = pitch.child("step");
+  element.step = step != nullptr;
+  const pugi::xml_node duration = note_node.child("duration");
+  element.duration = duration != nullptr;
+  element.staff = node_text(note_node.child("staff"));
+  element.step_text = node_text(step);
+  element.alter = node_text(pitch.child("alter"));
+  element.octave = node_text(pitch.child("octave"));
+  element.duration_text = node_text(duration);
+  element.voice = node_text(note_node.child("voice"));
+  // offset_debug() locates the element name, just after its '<'
+  const std::ptrdiff_t name = note_node.offset_debug();
+  element.offset = name > 0 ? to_offset(static_cast<size_t>(name - 1))
+                            : kNoOffset;
+  return element;
+}
 
-  return data;
+// Below this many measures per thread, parallel extraction does not pay
+constexpr size_t kMinMeasuresPerChunk = 64;
+
+void extract_range(const std::vector<pugi::xml_node>& measure_nodes,
+                   const std::vector<domain::TimeSignature>& time_sigs,
+                   size_t begin, size_t end, PartMeasures& out) {
+  for (size_t i = begin; i < end; ++i) {
+    const pugi::xml_node& measure_node = measure_nodes[i];
+    MeasureSlices measure{
+        to_integer(attribute_text(measure_node, "number"), 1), {}, {}};
+    for (auto note_node : measure_node.children("note")) {
+      measure.add(note_element(note_node), out.warnings);
+    }
+    append_measure(measure, time_sigs[i], out);
+  }
 }
 
-}  // namespace
+// A cheap prepass collects the measures and the time signature in force in
+// each, which is the only state carried from one measure to the next.
+// Contiguous chunks are then extracted concurrently (the document is only
+// read) and concatenated in order, so the result does not depend on the
+// thread count.
+PartMeasures extract_part(const pugi::xml_node& part, size_t threads) {
+  std::vector<pugi::xml_node> measure_nodes;
+  std::vector<domain::TimeSignature> time_sigs;
+  domain::TimeSignature current_time_sig = domain::common_time();
+  for (auto measure_node : part.children("measure")) {
+    auto attributes = measure_node.child("attributes");
+    if (attributes != nullptr) {
+      auto time = attributes.child("time");
+      current_time_sig =
+          time_signature(time != nullptr, node_text(time.child("beats")),
+                         node_text(time.child("beat-type")));
+    }
+    measure_nodes.push_back(measure_node);
+    time_sigs.push_back(current_time_sig);
+  }
 
-MusicXMLParser::ParseResult MusicXMLParser::parse(
-    const std::filesystem::path& xml_path) {
-  // Load XML document
-  auto doc = std::make_unique<pugi::xml_document>();
-  pugi::xml_parse_result result = doc->load_file(xml_path.c_str());
+  const size_t count = measure_nodes.size();
+  const size_t chunks =
+      std::max<size_t>(1, std::min(threads, count / kMinMeasuresPerChunk));
+  std::vector<PartMeasures> results(chunks);
+  std::vector<std::exception_ptr> errors(chunks);
+  auto run_chunk = [&](size_t chunk) {
+    try {
+      extract_range(measure_nodes, time_sigs, count * chunk / chunks,
+                    count * (chunk + 1) / chunks, results[chunk]);
+    } catch (...) {
+      errors[chunk] = std::current_exception();
+    }
+  };
 
-  if (!result) {
-    if (!std::filesystem::exists(xml_path)) {
-      throw FileNotFoundError(xml_path.string());
+  std::vector<std::thread> workers;
+  workers.reserve(chunks - 1);
+  for (size_t chunk = 1; chunk < chunks; ++chunk) {
+    workers.emplace_back(run_chunk, chunk);
+  }
+  run_chunk(0);
+  for (std::thread& worker : workers) {
+    worker.join();
+  }
+
+  PartMeasures part_measures = std::move(results[0]);
+  for (size_t chunk = 0; chunk < chunks; ++chunk) {
+    if (errors[chunk]) {
+      std::rethrow_exception(errors[chunk]);
     }
+    if (chunk > 0) {
+      append(part_measures.right, results[chunk].right);
+      append(part_measures.left, results[chunk].left);
+      append(part_measures.source_map.right_hand,
+             results[chunk].source_map.right_hand);
+      append(part_measures.source_map.left_hand,
+             results[chunk].source_map.left_hand);
+      append(part_measures.warnings, results[chunk].warnings);
+    }
+  }
+  return part_measures;
+}
+
+// Buffer from pugixml's allocator, so a document can take ownership of it
+using PugiBuffer = std::unique_ptr<char, pugi::deallocation_function>;
+
+PugiBuffer allocate_buffer(size_t size) {
+  PugiBuffer buffer(static_cast<char*>(pugi::get_memory_allocation_function()(
+                        std::max<size_t>(size, 1))),
+                    pugi::get_memory_deallocation_function());
+  if (buffer == nullptr) {
+    throw std::bad_alloc();
+  }
+  return buffer;
+}
+
+// Parses the buffer in place; the document takes ownership whatever the
+// outcome, so node text points into it without a second copy. Returns
+// false if pugixml had to convert the encoding, in which case node offsets
+// no longer refer to the original bytes.
+bool parse_in_place(pugi::xml_document& doc, PugiBuffer buffer, size_t size) {
+  pugi::xml_parse_result result =
+      doc.load_buffer_inplace_own(buffer.release(), size);
+  if (!result) {
     throw MalformedXMLError(static_cast<int>(result.offset),
                             result.description());
   }
+  return result.encoding == pugi::encoding_utf8;
+}
+
+// Compressed MusicXML: META-INF/container.xml names the root score
+const ZipArchive::Entry& root_score(const ZipArchive& archive) {
+  const ZipArchive::Entry* container_entry =
+      archive.find("META-INF/container.xml");
+  if (container_entry == nullptr) {
+    throw MissingElementError("META-INF/container.xml");
+  }
+  const std::string container_text = archive.read(*container_entry);
+  pugi::xml_document container;
+  if (!container.load_buffer(container_text.data(), container_text.size())) {
+    throw MalformedArchiveError("unreadable META-INF/container.xml");
+  }
+  const char* root_path = container.child("container")
+                              .child("rootfiles")
+                              .child("rootfile")
+                              .attribute("full-path")
+                              .as_string();
+  const ZipArchive::Entry* root = archive.find(root_path);
+  if (root == nullptr) {
+    throw MalformedArchiveError(std::string("missing root score '") +
+                                root_path + "'");
+  }
+  return *root;
+}
+
+// Raw bytes of an input file, in a buffer a document can own
+struct FileBytes {
+  PugiBuffer buffer;
+  size_t size;
+
+  [[nodiscard]] std::string_view view() const noexcept {
+    return {buffer.get(), size};
+  }
+};
+
+FileBytes read_file(const std::filesystem::path& xml_path) {
+  std::ifstream file(xml_path, std::ios::binary | std::ios::ate);
+  if (!file) {
+    throw FileNotFoundError(xml_path.string());
+  }
+  const std::streamoff length = file.tellg();
+  if (length < 0) {
+    throw FileNotFoundError(xml_path.string());
+  }
+  const auto size = static_cast<size_t>(length);
+
+  PugiBuffer buffer = allocate_buffer(size);
+  file.seekg(0);
+  if (!file.read(buffer.get(), length)) {
+    throw FileNotFoundError(xml_path.string());
+  }
+  return {std::move(buffer), size};
+}
+
+// The score text of an input file: the file itself or, for a compressed
+// (.mxl) archive, its root score inflated straight into a new buffer
+FileBytes score_text(FileBytes file) {
+  if (!ZipArchive::is_zip(file.view())) {
+    return file;
+  }
+  ZipArchive archive(file.view());
+  const ZipArchive::Entry& root = root_score(archive);
+  PugiBuffer buffer = allocate_buffer(root.size);
+  archive.extract(root, buffer.get());
+  return {std::move(buffer), root.size};
+}
+
+// Empty unless every note has a usable offset
+domain::SourceMap checked_source_map(domain::SourceMap map,
+                                     bool offsets_valid) {
+  auto missing = [](const std::vector<uint32_t>& offsets) {
+    return std::find(offsets.begin(), offsets.end(), kNoOffset) !=
+           offsets.end();
+  };
+  if (!offsets_valid || missing(map.left_hand) || missing(map.right_hand)) {
+    return {};
+  }
+  return map;
+}
+
+// Builds the Piece from a DOM parsed in place over `text`
+MusicXMLParser::ParseResult document_result(
+    FileBytes text, const MusicXMLParser::ParseOptions& options) {
+  auto doc = std::make_unique<pugi::xml_document>();
+  const bool offsets_valid =
+      parse_in_place(*doc, std::move(text.buffer), text.size);
 
   // Get root element
   auto root = doc->child("score-partwise");
@@ -193,36 +565,378 @@ MusicXMLParser::ParseResult MusicXMLParser::parse(
   // Extract metadata
   domain::Metadata metadata = extract_metadata(root);
 
-  // Extract measures for both hands
-  std::vector<domain::Measure> left_hand_measures;
-  std::vector<domain::Measure> right_hand_measures;
+  auto part = find_part(root, options.part_id);
+  PartMeasures measures = extract_part(part, options.threads);
 
-  auto part = root.child("part");
-  if (!part) {
-    throw MissingElementError("part");
+  // Build Piece
+  domain::Piece piece(std::move(metadata), std::move(measures.left),
+                      std::move(measures.right));
+
+  if (options.mode == MusicXMLParser::ParseMode::kDiscardDocument) {
+    // Nothing refers into the DOM any more; free it before the caller
+    // starts optimizing
+    doc.reset();
   }
+  return MusicXMLParser::ParseResult{
+      std::move(piece), std::move(doc), std::move(measures.warnings),
+      checked_source_map(std::move(measures.source_map), offsets_valid),
+      {}};
+}
 
-  domain::TimeSignature current_time_sig = domain::common_time();
+// Whether pugixml would read `text` as UTF-8 as it stands: no UTF-16 or
+// UTF-32 byte order mark or NUL bytes, and no other declared encoding.
+// Anything else is converted by pugixml, so it goes through the DOM.
+bool is_utf8(std::string_view text) noexcept {
+  if (text.starts_with("\xEF\xBB\xBF")) {
+    return true;
+  }
+  if (text.starts_with("\xFE\xFF") || text.starts_with("\xFF\xFE") ||
+      text.substr(0, 4).find('\0') != std::string_view::npos) {
+    return false;
+  }
+  if (!text.starts_with("<?xml")) {
+    return true;
+  }
+  const std::string_view declaration = text.substr(0, text.find("?>"));
+  const size_t encoding = declaration.find("encoding");
+  const size_t quote = declaration.find_first_of("\"'", encoding);
+  if (encoding == std::string_view::npos || quote == std::string_view::npos) {
+    return true;
+  }
+  const size_t close = declaration.find(declaration[quote], quote + 1);
+  std::string name(declaration.substr(quote + 1, close - quote - 1));
+  std::transform(name.begin(), name.end(), name.begin(), [](char c) {
+    return static_cast<char>(c >= 'a' && c <= 'z' ? c - 'a' + 'A' : c);
+  });
+  return name == "UTF-8" || name == "UTF8";
+}
 
-  for (auto measure_node : part.children("measure")) {
-    auto data = extract_measure(measure_node, current_time_sig);
-    current_time_sig = data.time_sig;
+// Builds the result in one forward pass over the score text, without a
+// DOM. It reads what the DOM path reads, taking the first child of each
+// name wherever that uses child(), so both give the same Piece, warnings
+// and source map. Measures are extracted on the calling thread.
+class StreamExtractor {
+ public:
+  StreamExtractor(std::string_view text, const std::string& part_id)
+      : reader_(text), part_id_(part_id) {}
+
+  MusicXMLParser::ParseResult run() {
+    // As with a DOM, a document that is not well formed is reported as
+    // such, even where reading it up to the fault would fail otherwise
+    std::exception_ptr error;
+    bool found_root = false;
+    for (XmlReader::Token token = reader_.next();
+         token != XmlReader::Token::kEnd; token = reader_.next()) {
+      if (token != XmlReader::Token::kStartElement) {
+        continue;
+      }
+      if (found_root || reader_.name() != "score-partwise") {
+        reader_.skip();
+        continue;
+      }
+      found_root = true;
+      try {
+        read_score_partwise();
+      } catch (const MalformedXMLError&) {
+        throw;
+      } catch (...) {
+        error = std::current_exception();
+      }
+    }
+    if (error) {
+      std::rethrow_exception(error);
+    }
+    if (!found_root) {
+      throw MissingElementError("score-partwise");
+    }
+    if (!found_part_) {
+      throw MissingElementError(
+          part_id_.empty() ? "part" : "part with id '" + part_id_ + "'");
+    }
+    domain::Piece piece({std::move(title_), std::move(composer_)},
+                        std::move(measures_.left), std::move(measures_.right));
+    return {std::move(piece), nullptr, std::move(measures_.warnings),
+            checked_source_map(std::move(measures_.source_map), true), {}};
+  }
 
-    if (!data.rh_slices.empty()) {
-      right_hand_measures.emplace_back(data.number, std::move(data.rh_slices),
-                                       data.time_sig);
+ private:
+  // Children of the current start element, up to its end tag: calls
+  // `on_child` with each child's name, which must read or skip it
+  template <class OnChild>
+  void read_children(OnChild on_child) {
+    for (;;) {
+      switch (reader_.next()) {
+        case XmlReader::Token::kStartElement:
+          on_child(reader_.name());
+          break;
+        case XmlReader::Token::kEndElement:
+        case XmlReader::Token::kEnd:
+          return;
+        case XmlReader::Token::kText:
+          break;
+      }
     }
-    if (!data.lh_slices.empty()) {
-      left_hand_measures.emplace_back(data.number, std::move(data.lh_slices),
-                                      data.time_sig);
+  }
+
+  // Text of the current start element, which is consumed: its first
+  // character data or CDATA child, decoded into `scratch` if needed
+  ElementText read_text(std::string& scratch) {
+    ElementText text;
+    for (;;) {
+      switch (reader_.next()) {
+        case XmlReader::Token::kStartElement:
+          reader_.skip();
+          break;
+        case XmlReader::Token::kText:
+          if (!text.has_value()) {
+            text = reader_.text(scratch);
+          }
+          break;
+        case XmlReader::Token::kEndElement:
+        case XmlReader::Token::kEnd:
+          return text;
+      }
     }
   }
 
-  // Build Piece
-  domain::Piece piece(std::move(metadata), std::move(left_hand_measures),
-                      std::move(right_hand_measures));
+  void read_score_partwise() {
+    bool found_work = false;
+    bool found_identification = false;
+    read_children([&](std::string_view name) {
+      if (name == "work" && !found_work) {
+        found_work = true;
+        read_work();
+      } else if (name == "identification" && !found_identification) {
+        found_identification = true;
+        read_identification();
+      } else if (name == "part" && !found_part_ && is_selected_part()) {
+        found_part_ = true;
+        read_part();
+      } else {
+        reader_.skip();
+      }
+    });
+  }
+
+  void read_work() {
+    bool found_title = false;
+    read_children([&](std::string_view name) {
+      if (name == "work-title" && !found_title) {
+        found_title = true;
+        title_ = std::string(read_text(scratch_[0]).value_or(""));
+      } else {
+        reader_.skip();
+      }
+    });
+  }
+
+  void read_identification() {
+    bool found_composer = false;
+    read_children([&](std::string_view name) {
+      if (name == "creator" && !found_composer &&
+          reader_.attribute("type", scratch_[0]) == "composer") {
+        found_composer = true;
+        composer_ = std::string(read_text(scratch_[0]).value_or(""));
+      } else {
+        reader_.skip();
+      }
+    });
+  }
+
+  bool is_selected_part() {
+    return part_id_.empty() || reader_.attribute("id", scratch_[0]) == part_id_;
+  }
 
-  return ParseResult{std::move(piece), std::move(doc)};
+  void read_part() {
+    read_children([&](std::string_view name) {
+      if (name == "measure") {
+        read_measure();
+      } else {
+        reader_.skip();
+      }
+    });
+  }
+
+  void read_measure() {
+    MeasureSlices measure{
+        to_integer(reader_.attribute("number", scratch_[0]), 1), {}, {}};
+    bool found_attributes = false;
+    read_children([&](std::string_view name) {
+      if (name == "note") {
+        measure.add(read_note_element(), measures_.warnings);
+      } else if (name == "attributes" && !found_attributes) {
+        found_attributes = true;
+        read_attributes();
+      } else {
+        reader_.skip();
+      }
+    });
+    append_measure(measure, time_sig_, measures_);
+  }
+
+  // Updates time_sig_ from the first <time>, or resets it to 4/4
+  void read_attributes() {
+    bool found_time = false;
+    ElementText beats;
+    ElementText beat_type;
+    read_children([&](std::string_view name) {
+      if (name != "time" || found_time) {
+        reader_.skip();
+        return;
+      }
+      found_time = true;
+      bool found_beats = false;
+      bool found_beat_type = false;
+      read_children([&](std::string_view time_name) {
+        if (time_name == "beats" && !found_beats) {
+          found_beats = true;
+          beats = read_text(scratch_[0]);
+        } else if (time_name == "beat-type" && !found_beat_type) {
+          found_beat_type = true;
+          beat_type = read_text(scratch_[1]);
+        } else {
+          reader_.skip();
+        }
+      });
+    });
+    time_sig_ = time_signature(found_time, beats, beat_type);
+  }
+
+  // The texts are views into the score text or scratch_, valid until the
+  // next note is read
+  NoteElement read_note_element() {
+    NoteElement element;
+    element.offset = to_offset(reader_.offset());
+    bool found_staff = false;
+    bool found_voice = false;
+    read_children([&](std::string_view name) {
+      if (name == "staff" && !found_staff) {
+        found_staff = true;
+        element.staff = read_text(scratch_[0]);
+      } else if (name == "rest" && !element.rest) {
+        element.rest = true;
+        reader_.skip();
+      } else if (name == "chord" && !element.chord) {
+        element.chord = true;
+        reader_.skip();
+      } else if (name == "pitch" && !element.pitch) {
+        element.pitch = true;
+        read_pitch(element);
+      } else if (name == "duration" && !element.duration) {
+        element.duration = true;
+        element.duration_text = read_text(scratch_[1]);
+      } else if (name == "voice" && !found_voice) {
+        found_voice = true;
+        element.voice = read_text(scratch_[2]);
+      } else {
+        reader_.skip();
+      }
+    });
+    return element;
+  }
+
+  void read_pitch(NoteElement& element) {
+    bool found_alter = false;
+    bool found_octave = false;
+    read_children([&](std::string_view name) {
+      if (name == "step" && !element.step) {
+        element.step = true;
+        element.step_text = read_text(scratch_[3]);
+      } else if (name == "alter" && !found_alter) {
+        found_alter = true;
+        element.alter = read_text(scratch_[4]);
+      } else if (name == "octave" && !found_octave) {
+        found_octave = true;
+        element.octave = read_text(scratch_[5]);
+      } else {
+        reader_.skip();
+      }
+    });
+  }
+
+  XmlReader reader_;
+  const std::string& part_id_;
+  bool found_part_{false};
+  std::string title_{"Untitled"};
+  std::string composer_{"Unknown"};
+  domain::TimeSignature time_sig_{domain::common_time()};
+  PartMeasures measures_;
+  // Decoded texts of the element being read, one per field it needs at
+  // once; reused so reading a note allocates nothing
+  std::array<std::string, 6> scratch_;
+};
+
+// kDiscardDocument reads UTF-8 text in one forward pass; everything else
+// is parsed into a DOM
+MusicXMLParser::ParseResult extract(
+    FileBytes text, const MusicXMLParser::ParseOptions& options) {
+  if (options.mode == MusicXMLParser::ParseMode::kDiscardDocument &&
+      is_utf8(text.view())) {
+    return StreamExtractor(text.view(), options.part_id).run();
+  }
+  return document_result(std::move(text), options);
+}
+
+}  // namespace
+
+MusicXMLParser::ParseResult MusicXMLParser::parse(
+    const std::filesystem::path& xml_path) {
+  return parse(xml_path, ParseMode::kKeepDocument);
+}
+
+MusicXMLParser::ParseResult MusicXMLParser::parse(
+    const std::filesystem::path& xml_path, ParseMode mode) {
+  ParseOptions options;
+  options.mode = mode;
+  return parse(xml_path, options);
+}
+
+MusicXMLParser::ParseResult MusicXMLParser::parse(
+    const std::filesystem::path& xml_path, const ParseOptions& options) {
+  if (options.threads == 0) {
+    throw std::invalid_argument("Parser thread count must be > 0");
+  }
+  const trace::Span span("parser", "parse");
+  FileBytes text = score_text(read_file(xml_path));
+  // Copied before an in-place parse rewrites the buffer
+  std::string score;
+  if (options.keep_score) {
+    score.assign(text.view());
+  }
+  ParseResult result = extract(std::move(text), options);
+  result.score = std::move(score);
+  return result;
+}
+
+MusicXMLParser::ParseResult MusicXMLParser::parse_cached(
+    const std::filesystem::path& xml_path,
+    const std::filesystem::path& cache_dir) {
+  const trace::Span span("parser", "parse_cached");
+  FileBytes file = read_file(xml_path);
+  // Hashed before in-place parsing rewrites the buffer
+  const uint64_t source_hash = content_hash(file.view());
+  if (auto cached = load_piece_cache(cache_dir, source_hash)) {
+    return ParseResult{std::move(cached->piece), nullptr,
+                       std::move(cached->warnings),
+                       std::move(cached->source_map), {}};
+  }
+
+  ParseOptions options;
+  options.mode = ParseMode::kDiscardDocument;
+  ParseResult result = extract(score_text(std::move(file)), options);
+  // Best effort: a cache that cannot be written only costs a re-parse
+  store_piece_cache(cache_dir, source_hash, result.piece, result.warnings,
+                    result.source_map);
+  return result;
+}
+
+std::string MusicXMLParser::read_score(const std::filesystem::path& xml_path) {
+  FileBytes file = read_file(xml_path);
+  if (!ZipArchive::is_zip(file.view())) {
+    return std::string(file.view());
+  }
+  ZipArchive archive(file.view());
+  return archive.read(root_score(archive));
 }
 
 }  // namespace piano_fingering::parser
@@ -0,0 +1,426 @@
+// src/parser/piece_cache.cpp - Binary cache of parsed pieces
+
+#include "parser/piece_cache.h"
+
+#include <bit>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <stdexcept>
+#include <system_error>
+#include <thread>
+#include <utility>
+
+#include "domain/measure.h"
+#include "domain/metadata.h"
+#include "domain/note.h"
+#include "domain/pitch.h"
+#include "domain/slice.h"
+#include "domain/time_signature.h"
+
+namespace piano_fingering::parser {
+
+namespace {
+
+constexpr char kMagic[4] = {'P', 'F', 'P', 'C'};
+constexpr size_t kHeaderSize = 48;
+constexpr size_t kMeasureSize = 16;
+constexpr size_t kSliceSize = 4;
+constexpr size_t kNoteSize = 8;
+constexpr size_t kOffsetSize = 4;
+constexpr uint32_t kSourceMapFlag = 1;
+
+constexpr uint8_t kRestBit = 1;
+constexpr int kStaffShift = 1;
+constexpr int kVoiceShift = 2;
+
+void put_u8(std::string& out, uint32_t value) {
+  out.push_back(static_cast<char>(value & 0xFF));
+}
+
+void put_u32(std::string& out, uint32_t value) {
+  for (int shift = 0; shift < 32; shift += 8) {
+    put_u8(out, value >> shift);
+  }
+}
+
+void put_u64(std::string& out, uint64_t value) {
+  put_u32(out, static_cast<uint32_t>(value));
+  put_u32(out, static_cast<uint32_t>(value >> 32));
+}
+
+void put_string(std::string& out, const std::string& text) {
+  put_u32(out, static_cast<uint32_t>(text.size()));
+  out += text;
+}
+
+// Bounds-checked little-endian reader; every read fails once one has
+class Reader {
+ public:
+  explicit Reader(std::string_view bytes) noexcept : bytes_(bytes) {}
+
+  [[nodiscard]] bool ok() const noexcept { return ok_; }
+  [[nodiscard]] bool at_end() const noexcept {
+    return ok_ && offset_ == bytes_.size();
+  }
+
+  uint32_t u8() noexcept { return take(1) ? byte(offset_ - 1) : 0; }
+
+  uint32_t u32() noexcept {
+    if (!take(4)) {
+      return 0;
+    }
+    uint32_t value = 0;
+    for (int i = 3; i >= 0; --i) {
+      value = (value << 8) | byte(offset_ - 4 + static_cast<size_t>(i));
+    }
+    return value;
+  }
+
+  uint64_t u64() noexcept {
+    const uint64_t low = u32();
+    return low | (static_cast<uint64_t>(u32()) << 32);
+  }
+
+  std::string text() {
+    const uint32_t length = u32();
+    if (!take(length)) {
+      return {};
+    }
+    return std::string(bytes_.substr(offset_ - length, length));
+  }
+
+ private:
+  bool take(size_t count) noexcept {
+    if (!ok_ || bytes_.size() - offset_ < count) {
+      ok_ = false;
+      return false;
+    }
+    offset_ += count;
+    return true;
+  }
+
+  [[nodiscard]] uint32_t byte(size_t at) const noexcept {
+    return static_cast<unsigned char>(bytes_[at]);
+  }
+
+  std::string_view bytes_;
+  size_t offset_{0};
+  bool ok_{true};
+};
+
+void encode_hand(std::string& out, const std::vector<domain::Measure>& hand,
+                 uint32_t& slice_end) {
+  for (const domain::Measure& measure : hand) {
+    slice_end += static_cast<uint32_t>(measure.size());
+    put_u32(out, static_cast<uint32_t>(measure.number()));
+    put_u32(out, static_cast<uint32_t>(measure.time_signature().numerator()));
+    put_u32(out,
+            static_cast<uint32_t>(measure.time_signature().denominator()));
+    put_u32(out, slice_end);
+  }
+}
+
+// Checked like the Note constructor, but reporting instead of throwing
+std::optional<domain::Note> decode_note(Reader& in) {
+  const uint32_t duration = in.u32();
+  const uint32_t pitch = in.u8();
+  const uint32_t octave = in.u8();
+  const uint32_t flags = in.u8();
+  if (in.u8() != 0 || duration == 0 || pitch > 13 || octave > 10 ||
+      flags >> (kVoiceShift + 2) != 0) {
+    return std::nullopt;
+  }
+  return domain::Note(domain::Pitch(static_cast<int>(pitch)),
+                      static_cast<int>(octave), duration,
+                      (flags & kRestBit) != 0,
+                      static_cast<int>((flags >> kStaffShift) & 1) + 1,
+                      static_cast<int>((flags >> kVoiceShift) & 3) + 1);
+}
+
+std::optional<std::vector<domain::Measure>> decode_hand(
+    Reader& in, uint32_t count, const std::vector<domain::Slice>& slices,
+    uint32_t& slice_begin) {
+  std::vector<domain::Measure> hand;
+  hand.reserve(count);
+  for (uint32_t i = 0; i < count; ++i) {
+    const auto number = static_cast<int32_t>(in.u32());
+    const auto numerator = static_cast<int32_t>(in.u32());
+    const auto denominator = static_cast<int32_t>(in.u32());
+    const uint32_t slice_end = in.u32();
+    if (!in.ok() || number <= 0 || numerator <= 0 || denominator <= 0 ||
+        !std::has_single_bit(static_cast<uint32_t>(denominator)) ||
+        slice_end <= slice_begin || slice_end > slices.size()) {
+      return std::nullopt;
+    }
+    hand.emplace_back(number,
+                      std::vector<domain::Slice>(slices.begin() + slice_begin,
+                                                 slices.begin() + slice_end),
+                      domain::TimeSignature(numerator, denominator));
+    slice_begin = slice_end;
+  }
+  return hand;
+}
+
+}  // namespace
+
+uint64_t content_hash(std::string_view bytes) noexcept {
+  // Word-at-a-time multiply-xor with a splitmix64 finalizer
+  constexpr uint64_t kMultiplier = 0x9E3779B97F4A7C15ULL;
+  uint64_t hash = 0xCBF29CE484222325ULL ^ bytes.size();
+  const char* data = bytes.data();
+  size_t i = 0;
+  for (; i + 8 <= bytes.size(); i += 8) {
+    uint64_t word = 0;
+    std::memcpy(&word, data + i, 8);
+    hash = (hash ^ word) * kMultiplier;
+    hash ^= hash >> 32;
+  }
+  uint64_t tail = 0;
+  std::memcpy(&tail, data + i, bytes.size() - i);
+  hash = (hash ^ tail) * kMultiplier;
+
+  hash ^= hash >> 30;
+  hash *= 0xBF58476D1CE4E5B9ULL;
+  hash ^= hash >> 27;
+  hash *= 0x94D049BB133111EBULL;
+  return hash ^ (hash >> 31);
+}
+
+std::string encode_piece_cache(uint64_t source_hash,
+                               const domain::Piece& piece,
+                               const std::vector<std::string>& warnings,
+                               const domain::SourceMap& source_map) {
+  std::string payload;
+  uint32_t slice_end = 0;
+  encode_hand(payload, piece.left_hand(), slice_end);
+  encode_hand(payload, piece.right_hand(), slice_end);
+
+  uint32_t note_end = 0;
+  for (const auto* hand : {&piece.left_hand(), &piece.right_hand()}) {
+    for (const domain::Measure& measure : *hand) {
+      for (const domain::Slice& slice : measure) {
+        note_end += static_cast<uint32_t>(slice.size());
+        put_u32(payload, note_end);
+      }
+    }
+  }
+  for (const auto* hand : {&piece.left_hand(), &piece.right_hand()}) {
+    for (const domain::Measure& measure : *hand) {
+      for (const domain::Slice& slice : measure) {
+        for (const domain::Note& note : slice) {
+          put_u32(payload, note.duration());
+          put_u8(payload, static_cast<uint32_t>(note.pitch().value()));
+          put_u8(payload, static_cast<uint32_t>(note.octave()));
+          put_u8(payload,
+                 (note.is_rest() ? kRestBit : 0U) |
+                     static_cast<uint32_t>((note.staff() - 1) << kStaffShift) |
+                     static_cast<uint32_t>((note.voice() - 1) << kVoiceShift));
+          put_u8(payload, 0);
+        }
+      }
+    }
+  }
+  const bool has_source_map = !source_map.empty();
+  if (has_source_map) {
+    if (source_map.left_hand.size() + source_map.right_hand.size() !=
+        note_end) {
+      throw std::invalid_argument("Source map does not match the piece");
+    }
+    for (const auto* hand : {&source_map.left_hand, &source_map.right_hand}) {
+      for (uint32_t offset : *hand) {
+        put_u32(payload, offset);
+      }
+    }
+  }
+  put_string(payload, piece.metadata().title());
+  put_string(payload, piece.metadata().composer());
+  for (const std::string& warning : warnings) {
+    put_string(payload, warning);
+  }
+
+  std::string out(kMagic, sizeof(kMagic));
+  put_u32(out, kPieceCacheVersion);
+  put_u64(out, source_hash);
+  put_u64(out, content_hash(payload));
+  put_u32(out, static_cast<uint32_t>(piece.left_hand().size()));
+  put_u32(out, static_cast<uint32_t>(piece.right_hand().size()));
+  put_u32(out, slice_end);
+  put_u32(out, note_end);
+  put_u32(out, static_cast<uint32_t>(warnings.size()));
+  put_u32(out, has_source_map ? kSourceMapFlag : 0U);
+  out += payload;
+  return out;
+}
+
+std::optional<CachedPiece> decode_piece_cache(std::string_view bytes,
+                                              uint64_t source_hash) {
+  if (bytes.size() < kHeaderSize ||
+      std::memcmp(bytes.data(), kMagic, sizeof(kMagic)) != 0) {
+    return std::nullopt;
+  }
+  Reader header(bytes.substr(sizeof(kMagic), kHeaderSize - sizeof(kMagic)));
+  const uint32_t version = header.u32();
+  const uint64_t stored_source = header.u64();
+  const uint64_t checksum = header.u64();
+  const uint32_t left_count = header.u32();
+  const uint32_t right_count = header.u32();
+  const uint32_t slice_count = header.u32();
+  const uint32_t note_count = header.u32();
+  const uint32_t warning_count = header.u32();
+  const uint32_t flags = header.u32();
+  const bool has_source_map = (flags & kSourceMapFlag) != 0;
+  const std::string_view payload = bytes.substr(kHeaderSize);
+  if (version != kPieceCacheVersion || stored_source != source_hash ||
+      (flags & ~kSourceMapFlag) != 0 || checksum != content_hash(payload)) {
+    return std::nullopt;
+  }
+  // Reject counts the payload cannot hold before reserving for them
+  const uint64_t measure_count = uint64_t{left_count} + right_count;
+  const uint64_t fixed_bytes = measure_count * kMeasureSize +
+                               uint64_t{slice_count} * kSliceSize +
+                               uint64_t{note_count} * kNoteSize +
+                               (has_source_map ? uint64_t{note_count} : 0U) *
+                                   kOffsetSize;
+  if (fixed_bytes > payload.size() || measure_count == 0) {
+    return std::nullopt;
+  }
+
+  // Measures come first but are decoded last, once their slices exist
+  const auto measure_bytes = static_cast<size_t>(measure_count * kMeasureSize);
+  Reader measures(payload.substr(0, measure_bytes));
+  Reader in(payload.substr(measure_bytes));
+
+  std::vector<uint32_t> note_ends(slice_count);
+  for (uint32_t& end : note_ends) {
+    end = in.u32();
+  }
+  std::vector<domain::Note> notes;
+  notes.reserve(note_count);
+  for (uint32_t i = 0; i < note_count; ++i) {
+    auto note = decode_note(in);
+    if (!note.has_value()) {
+      return std::nullopt;
+    }
+    notes.push_back(*note);
+  }
+  std::vector<uint32_t> offsets(has_source_map ? note_count : 0U);
+  for (uint32_t& offset : offsets) {
+    offset = in.u32();
+  }
+
+  std::vector<domain::Slice> slices;
+  slices.reserve(slice_count);
+  uint32_t note_begin = 0;
+  for (uint32_t end : note_ends) {
+    if (end <= note_begin || end > note_count ||
+        end - note_begin > domain::kMaxNotesPerSlice) {
+      return std::nullopt;
+    }
+    slices.emplace_back(notes.begin() + note_begin, notes.begin() + end);
+    note_begin = end;
+  }
+  if (note_begin != note_count) {
+    return std::nullopt;
+  }
+
+  uint32_t slice_begin = 0;
+  auto left = decode_hand(measures, left_count, slices, slice_begin);
+  const uint32_t left_notes = slice_begin == 0 ? 0 : note_ends[slice_begin - 1];
+  auto right = decode_hand(measures, right_count, slices, slice_begin);
+  if (!left.has_value() || !right.has_value() ||
+      slice_begin != slice_count) {
+    return std::nullopt;
+  }
+
+  std::string title = in.text();
+  std::string composer = in.text();
+  std::vector<std::string> warnings;
+  warnings.reserve(warning_count);
+  for (uint32_t i = 0; i < warning_count && in.ok(); ++i) {
+    warnings.push_back(in.text());
+  }
+  if (!in.at_end()) {
+    return std::nullopt;
+  }
+
+  domain::SourceMap source_map;
+  if (has_source_map) {
+    const auto split = offsets.begin() + left_notes;
+    source_map.left_hand.assign(offsets.begin(), split);
+    source_map.right_hand.assign(split, offsets.end());
+  }
+
+  return CachedPiece{
+      domain::Piece(domain::Metadata(std::move(title), std::move(composer)),
+                    std::move(*left), std::move(*right)),
+      std::move(warnings), std::move(source_map)};
+}
+
+std::filesystem::path piece_cache_path(const std::filesystem::path& cache_dir,
+                                       uint64_t source_hash) {
+  char name[24];
+  std::snprintf(name, sizeof(name), "%016llx.pfpc",
+                static_cast<unsigned long long>(source_hash));
+  return cache_dir / name;
+}
+
+std::optional<CachedPiece> load_piece_cache(
+    const std::filesystem::path& cache_dir, uint64_t source_hash) {
+  std::ifstream file(piece_cache_path(cache_dir, source_hash),
+                     std::ios::binary | std::ios::ate);
+  if (!file) {
+    return std::nullopt;
+  }
+  const std::streamoff length = file.tellg();
+  if (length < 0) {
+    return std::nullopt;
+  }
+  std::string bytes(static_cast<size_t>(length), '\0');
+  file.seekg(0);
+  if (!file.read(bytes.data(), length)) {
+    return std::nullopt;
+  }
+  return decode_piece_cache(bytes, source_hash);
+}
+
+bool store_piece_cache(const std::filesystem::path& cache_dir,
+                       uint64_t source_hash, const domain::Piece& piece,
+                       const std::vector<std::string>& warnings,
+                       const domain::SourceMap& source_map) {
+  std::error_code error;
+  std::filesystem::create_directories(cache_dir, error);
+  if (error) {
+    return false;
+  }
+
+  const std::filesystem::path target = piece_cache_path(cache_dir, source_hash);
+  // Unique per writer, so concurrent runs never share a temporary
+  const size_t salt =
+      std::hash<std::thread::id>{}(std::this_thread::get_id()) ^
+      static_cast<size_t>(
+          std::chrono::steady_clock::now().time_since_epoch().count());
+  std::filesystem::path temporary = target;
+  temporary += ".tmp" + std::to_string(salt);
+
+  const std::string bytes = encode_piece_cache(source_hash, piece, warnings, source_map);
+  {
+    std::ofstream file(temporary, std::ios::binary | std::ios::trunc);
+    if (!file.write(bytes.data(), static_cast<std::streamsize>(bytes.size())) ||
+        !file.flush()) {
+      file.close();
+      std::filesystem::remove(temporary, error);
+      return false;
+    }
+  }
+  std::filesystem::rename(temporary, target, error);
+  if (error) {
+    std::filesystem::remove(temporary, error);
+    return false;
+  }
+  return true;
+}
+
+}  // namespace piano_fingering::parser
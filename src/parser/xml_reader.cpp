@@ -0,0 +1,351 @@
+// src/parser/xml_reader.cpp - Forward-only XML tokenizer for MusicXML
+
+#include "parser/xml_reader.h"
+
+#include <algorithm>
+#include <utility>
+
+#include "parser/parser_error.h"
+
+namespace piano_fingering::parser {
+
+namespace {
+
+constexpr std::string_view kByteOrderMark = "\xEF\xBB\xBF";
+
+bool is_space(char c) noexcept {
+  return c == ' ' || c == '\t' || c == '\n' || c == '\r';
+}
+
+// Name characters as pugixml accepts them; bytes of multi-byte UTF-8
+// sequences are all allowed
+bool is_name_start(char c) noexcept {
+  return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || c == '_' ||
+         c == ':' || static_cast<unsigned char>(c) >= 0x80;
+}
+
+bool is_name_char(char c) noexcept {
+  return is_name_start(c) || (c >= '0' && c <= '9') || c == '-' || c == '.';
+}
+
+void append_utf8(std::string& out, uint32_t code_point) {
+  if (code_point < 0x80) {
+    out += static_cast<char>(code_point);
+  } else if (code_point < 0x800) {
+    out += static_cast<char>(0xC0 | (code_point >> 6));
+    out += static_cast<char>(0x80 | (code_point & 0x3F));
+  } else if (code_point < 0x10000) {
+    out += static_cast<char>(0xE0 | (code_point >> 12));
+    out += static_cast<char>(0x80 | ((code_point >> 6) & 0x3F));
+    out += static_cast<char>(0x80 | (code_point & 0x3F));
+  } else {
+    out += static_cast<char>(0xF0 | (code_point >> 18));
+    out += static_cast<char>(0x80 | ((code_point >> 12) & 0x3F));
+    out += static_cast<char>(0x80 | ((code_point >> 6) & 0x3F));
+    out += static_cast<char>(0x80 | (code_point & 0x3F));
+  }
+}
+
+// Appends the replacement of the reference starting at raw[0] == '&' and
+// returns its length, or returns 0 if it is not one pugixml decodes
+size_t decode_reference(std::string_view raw, std::string& out) {
+  const size_t end = raw.find(';');
+  if (end == std::string_view::npos) {
+    return 0;
+  }
+  const std::string_view name = raw.substr(1, end - 1);
+  if (name.size() > 1 && name[0] == '#') {
+    const bool hex = name[1] == 'x';
+    const std::string_view digits = name.substr(hex ? 2 : 1);
+    if (digits.empty()) {
+      return 0;
+    }
+    uint32_t code_point = 0;
+    for (const char c : digits) {
+      uint32_t digit = 0;
+      if (c >= '0' && c <= '9') {
+        digit = static_cast<uint32_t>(c - '0');
+      } else if (hex && (c | ' ') >= 'a' && (c | ' ') <= 'f') {
+        digit = static_cast<uint32_t>((c | ' ') - 'a' + 10);
+      } else {
+        return 0;
+      }
+      code_point = code_point * (hex ? 16 : 10) + digit;
+    }
+    append_utf8(out, code_point);
+    return end + 1;
+  }
+  static constexpr std::pair<std::string_view, char> kEntities[] = {
+      {"amp", '&'}, {"apos", '\''}, {"gt", '>'}, {"lt", '<'}, {"quot", '"'}};
+  for (const auto& [entity, replacement] : kEntities) {
+    if (name == entity) {
+      out += replacement;
+      return end + 1;
+    }
+  }
+  return 0;
+}
+
+enum class ValueKind : uint8_t { kText, kCData, kAttribute };
+
+// pugixml's default conversions: references decoded outside CDATA, CR LF
+// and lone CR read as LF, and in attributes any whitespace as a space
+std::string_view decode(std::string_view raw, ValueKind kind,
+                        std::string& scratch) {
+  const std::string_view special =
+      kind == ValueKind::kCData       ? "\r"
+      : kind == ValueKind::kAttribute ? "&\r\n\t"
+                                      : "&\r";
+  if (raw.find_first_of(special) == std::string_view::npos) {
+    return raw;
+  }
+  scratch.clear();
+  for (size_t i = 0; i < raw.size(); ++i) {
+    const char c = raw[i];
+    if (c == '&' && kind != ValueKind::kCData) {
+      if (const size_t length = decode_reference(raw.substr(i), scratch)) {
+        i += length - 1;
+        continue;
+      }
+    }
+    if (c == '\r') {
+      if (i + 1 < raw.size() && raw[i + 1] == '\n') {
+        ++i;
+      }
+      scratch += kind == ValueKind::kAttribute ? ' ' : '\n';
+      continue;
+    }
+    scratch += kind == ValueKind::kAttribute && is_space(c) ? ' ' : c;
+  }
+  return scratch;
+}
+
+}  // namespace
+
+XmlReader::XmlReader(std::string_view text) noexcept : text_(text) {
+  if (text_.starts_with(kByteOrderMark)) {
+    pos_ = kByteOrderMark.size();
+  }
+}
+
+void XmlReader::fail(size_t at, const char* detail) const {
+  throw MalformedXMLError(static_cast<int>(at), detail);
+}
+
+bool XmlReader::starts_with(std::string_view prefix) const noexcept {
+  return text_.substr(pos_).starts_with(prefix);
+}
+
+size_t XmlReader::past(std::string_view terminator, const char* detail) const {
+  const size_t at = text_.find(terminator, pos_);
+  if (at == std::string_view::npos) {
+    fail(pos_, detail);
+  }
+  return at + terminator.size();
+}
+
+std::string_view XmlReader::read_name() {
+  const size_t begin = pos_;
+  if (pos_ >= text_.size() || !is_name_start(text_[pos_])) {
+    return {};
+  }
+  while (pos_ < text_.size() && is_name_char(text_[pos_])) {
+    ++pos_;
+  }
+  return text_.substr(begin, pos_ - begin);
+}
+
+void XmlReader::skip_whitespace() noexcept {
+  while (pos_ < text_.size() && is_space(text_[pos_])) {
+    ++pos_;
+  }
+}
+
+// Through the closing '>', past any internal subset and quoted literals
+void XmlReader::skip_doctype() {
+  const size_t begin = pos_;
+  int depth = 0;
+  for (pos_ += 2; pos_ < text_.size(); ++pos_) {
+    const char c = text_[pos_];
+    if (c == '"' || c == '\'') {
+      const size_t close = text_.find(c, pos_ + 1);
+      if (close == std::string_view::npos) {
+        break;
+      }
+      pos_ = close;
+    } else if (c == '[') {
+      ++depth;
+    } else if (c == ']') {
+      --depth;
+    } else if (c == '>' && depth == 0) {
+      ++pos_;
+      return;
+    }
+  }
+  fail(begin, "Unterminated DOCTYPE");
+}
+
+XmlReader::Token XmlReader::read_start_element() {
+  offset_ = pos_++;
+  name_ = read_name();
+  if (name_.empty()) {
+    fail(offset_, "Error parsing start element tag");
+  }
+  const size_t attributes_begin = pos_;
+  for (;;) {
+    const size_t before_space = pos_;
+    skip_whitespace();
+    if (pos_ >= text_.size()) {
+      fail(offset_, "Error parsing start element tag");
+    }
+    if (text_[pos_] == '>' || text_[pos_] == '/') {
+      attributes_ = text_.substr(attributes_begin, pos_ - attributes_begin);
+      end_pending_ = text_[pos_] == '/';
+      if (end_pending_ && !starts_with("/>")) {
+        fail(pos_, "Error parsing start element tag");
+      }
+      pos_ += end_pending_ ? 2 : 1;
+      break;
+    }
+    // Attributes are separated from the name and each other by whitespace
+    if (pos_ == before_space || read_name().empty()) {
+      fail(pos_, "Error parsing attribute");
+    }
+    skip_whitespace();
+    if (pos_ >= text_.size() || text_[pos_] != '=') {
+      fail(pos_, "Error parsing attribute");
+    }
+    ++pos_;
+    skip_whitespace();
+    if (pos_ >= text_.size() || (text_[pos_] != '"' && text_[pos_] != '\'')) {
+      fail(pos_, "Error parsing attribute");
+    }
+    const size_t close = text_.find(text_[pos_], pos_ + 1);
+    if (close == std::string_view::npos) {
+      fail(pos_, "Error parsing attribute");
+    }
+    pos_ = close + 1;
+  }
+  open_.push_back(name_);
+  seen_element_ = true;
+  return Token::kStartElement;
+}
+
+XmlReader::Token XmlReader::read_end_element() {
+  offset_ = pos_;
+  pos_ += 2;
+  name_ = read_name();
+  skip_whitespace();
+  if (open_.empty() || name_ != open_.back() || pos_ >= text_.size() ||
+      text_[pos_] != '>') {
+    fail(offset_, "Start-end tags mismatch");
+  }
+  ++pos_;
+  open_.pop_back();
+  return Token::kEndElement;
+}
+
+XmlReader::Token XmlReader::next() {
+  if (end_pending_) {
+    end_pending_ = false;
+    open_.pop_back();
+    return Token::kEndElement;
+  }
+  while (pos_ < text_.size()) {
+    if (text_[pos_] != '<') {
+      const size_t begin = pos_;
+      pos_ = std::min(text_.find('<', pos_), text_.size());
+      const std::string_view raw = text_.substr(begin, pos_ - begin);
+      // pugixml keeps no text outside the root, nor whitespace-only text
+      if (open_.empty() ||
+          raw.find_first_not_of(" \t\n\r") == std::string_view::npos) {
+        continue;
+      }
+      offset_ = begin;
+      value_ = raw;
+      cdata_ = false;
+      return Token::kText;
+    }
+    if (starts_with("<!--")) {
+      pos_ = past("-->", "Unterminated comment");
+    } else if (starts_with("<![CDATA[")) {
+      if (open_.empty()) {
+        fail(pos_, "CDATA outside the root element");
+      }
+      offset_ = pos_;
+      pos_ = past("]]>", "Unterminated CDATA");
+      value_ = text_.substr(offset_ + 9, pos_ - offset_ - 12);
+      cdata_ = true;
+      return Token::kText;
+    } else if (starts_with("<?")) {
+      pos_ = past("?>", "Unterminated processing instruction");
+    } else if (starts_with("<!DOCTYPE") && open_.empty()) {
+      skip_doctype();
+    } else if (starts_with("<!")) {
+      fail(pos_, "Unrecognized tag");
+    } else if (starts_with("</")) {
+      return read_end_element();
+    } else {
+      return read_start_element();
+    }
+  }
+  if (!open_.empty()) {
+    fail(pos_, "Start-end tags mismatch");
+  }
+  if (!seen_element_) {
+    fail(pos_, "No document element found");
+  }
+  return Token::kEnd;
+}
+
+void XmlReader::skip() {
+  for (size_t depth = 1; depth > 0;) {
+    switch (next()) {
+      case Token::kStartElement:
+        ++depth;
+        break;
+      case Token::kEndElement:
+        --depth;
+        break;
+      case Token::kText:
+      case Token::kEnd:
+        break;
+    }
+  }
+}
+
+std::optional<std::string_view> XmlReader::attribute(
+    std::string_view name, std::string& scratch) const {
+  // The tag was validated when it was read, so this scan can be lenient
+  size_t pos = 0;
+  const std::string_view tag = attributes_;
+  while (pos < tag.size()) {
+    while (pos < tag.size() && is_space(tag[pos])) {
+      ++pos;
+    }
+    const size_t name_begin = pos;
+    while (pos < tag.size() && is_name_char(tag[pos])) {
+      ++pos;
+    }
+    const std::string_view attribute_name =
+        tag.substr(name_begin, pos - name_begin);
+    const size_t quote = tag.find_first_of("\"'", pos);
+    if (quote == std::string_view::npos) {
+      break;
+    }
+    const size_t close = tag.find(tag[quote], quote + 1);
+    if (attribute_name == name) {
+      return decode(tag.substr(quote + 1, close - quote - 1),
+                    ValueKind::kAttribute, scratch);
+    }
+    pos = close + 1;
+  }
+  return std::nullopt;
+}
+
+std::string_view XmlReader::text(std::string& scratch) const {
+  return decode(value_, cdata_ ? ValueKind::kCData : ValueKind::kText,
+                scratch);
+}
+
+}  // namespace piano_fingering::parser
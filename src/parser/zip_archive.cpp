@@ -0,0 +1,159 @@
+// src/parser/zip_archive.cpp - In-memory zip reader for .mxl input
+
+#include "parser/zip_archive.h"
+
+#include <zlib.h>
+
+#include <algorithm>
+#include <cstring>
+
+#include "parser/parser_error.h"
+
+namespace piano_fingering::parser {
+
+namespace {
+
+constexpr uint32_t kLocalHeaderSignature = 0x04034b50;
+constexpr uint32_t kCentralHeaderSignature = 0x02014b50;
+constexpr uint32_t kEndOfDirectorySignature = 0x06054b50;
+
+constexpr size_t kLocalHeaderSize = 30;
+constexpr size_t kCentralHeaderSize = 46;
+constexpr size_t kEndOfDirectorySize = 22;
+constexpr size_t kMaxCommentSize = 0xFFFF;
+
+constexpr uint16_t kStored = 0;
+constexpr uint16_t kDeflated = 8;
+constexpr uint16_t kEncryptedFlag = 1;
+
+// Little-endian field readers; callers check the bounds first
+uint16_t read_u16(std::string_view bytes, size_t offset) noexcept {
+  const auto* p = reinterpret_cast<const unsigned char*>(bytes.data()) + offset;
+  return static_cast<uint16_t>(p[0] | (p[1] << 8));
+}
+
+uint32_t read_u32(std::string_view bytes, size_t offset) noexcept {
+  return read_u16(bytes, offset) |
+         (static_cast<uint32_t>(read_u16(bytes, offset + 2)) << 16);
+}
+
+void require(bool condition, const char* detail) {
+  if (!condition) {
+    throw MalformedArchiveError(detail);
+  }
+}
+
+// Offset of the end-of-central-directory record, searched backwards over
+// the trailing archive comment
+size_t find_end_of_directory(std::string_view bytes) {
+  require(bytes.size() >= kEndOfDirectorySize, "file too short");
+  const size_t last = bytes.size() - kEndOfDirectorySize;
+  const size_t first = last > kMaxCommentSize ? last - kMaxCommentSize : 0;
+  for (size_t offset = last + 1; offset-- > first;) {
+    if (read_u32(bytes, offset) == kEndOfDirectorySignature) {
+      return offset;
+    }
+  }
+  throw MalformedArchiveError("no end of central directory");
+}
+
+}  // namespace
+
+ZipArchive::ZipArchive(std::string_view bytes) : bytes_(bytes) {
+  const size_t end = find_end_of_directory(bytes_);
+  const uint16_t count = read_u16(bytes_, end + 10);
+  const uint32_t directory_size = read_u32(bytes_, end + 12);
+  const uint32_t directory_offset = read_u32(bytes_, end + 16);
+  require(count != 0xFFFF && directory_offset != 0xFFFFFFFF,
+          "ZIP64 archives are not supported");
+  require(directory_offset <= end && directory_size <= end - directory_offset,
+          "central directory out of range");
+
+  entries_.reserve(count);
+  size_t offset = directory_offset;
+  for (uint16_t i = 0; i < count; ++i) {
+    require(offset + kCentralHeaderSize <= end &&
+                read_u32(bytes_, offset) == kCentralHeaderSignature,
+            "bad central directory entry");
+    const uint16_t flags = read_u16(bytes_, offset + 8);
+    const size_t name_length = read_u16(bytes_, offset + 28);
+    const size_t extra_length = read_u16(bytes_, offset + 30);
+    const size_t comment_length = read_u16(bytes_, offset + 32);
+    const size_t next = offset + kCentralHeaderSize + name_length +
+                        extra_length + comment_length;
+    require(next <= end, "bad central directory entry");
+    require((flags & kEncryptedFlag) == 0,
+            "encrypted entries are not supported");
+
+    entries_.push_back(
+        {std::string(bytes_.substr(offset + kCentralHeaderSize, name_length)),
+         read_u16(bytes_, offset + 10), read_u32(bytes_, offset + 16),
+         read_u32(bytes_, offset + 20), read_u32(bytes_, offset + 24),
+         read_u32(bytes_, offset + 42)});
+    offset = next;
+  }
+}
+
+bool ZipArchive::is_zip(std::string_view bytes) noexcept {
+  return bytes.size() >= 4 && read_u32(bytes, 0) == kLocalHeaderSignature;
+}
+
+const ZipArchive::Entry* ZipArchive::find(
+    std::string_view name) const noexcept {
+  auto it = std::find_if(entries_.begin(), entries_.end(),
+                         [name](const Entry& e) { return e.name == name; });
+  return it == entries_.end() ? nullptr : &*it;
+}
+
+void ZipArchive::extract(const Entry& entry, char* out) const {
+  // The local header repeats the name and may carry a different extra field
+  const size_t header = entry.local_offset;
+  require(header <= bytes_.size() &&
+              bytes_.size() - header >= kLocalHeaderSize &&
+              read_u32(bytes_, header) == kLocalHeaderSignature,
+          "bad local header");
+  const size_t data = header + kLocalHeaderSize +
+                      read_u16(bytes_, header + 26) +
+                      read_u16(bytes_, header + 28);
+  require(data <= bytes_.size() &&
+              bytes_.size() - data >= entry.compressed_size,
+          "entry data out of range");
+  const char* input = bytes_.data() + data;
+
+  if (entry.method == kStored) {
+    require(entry.compressed_size == entry.size, "bad stored entry size");
+    std::memcpy(out, input, entry.size);
+  } else if (entry.method == kDeflated) {
+    // Raw deflate stream: negative window bits, no zlib header
+    z_stream stream{};
+    require(inflateInit2(&stream, -MAX_WBITS) == Z_OK,
+            "cannot initialize inflate");
+    stream.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(input));
+    stream.avail_in = entry.compressed_size;
+    stream.next_out = reinterpret_cast<Bytef*>(out);
+    stream.avail_out = entry.size;
+    const int status = inflate(&stream, Z_FINISH);
+    const uLong produced = stream.total_out;
+    inflateEnd(&stream);
+    require(status == Z_STREAM_END && produced == entry.size,
+            "corrupt deflate data");
+  } else {
+    throw MalformedArchiveError("unsupported compression method " +
+                                std::to_string(entry.method));
+  }
+
+  const uLong crc =
+      crc32(crc32(0L, Z_NULL, 0), reinterpret_cast<const Bytef*>(out),
+            entry.size);
+  if (crc != entry.crc) {
+    throw MalformedArchiveError("CRC mismatch in " + entry.name);
+  }
+}
+
+std::string ZipArchive::read(const Entry& entry) const {
+  std::string text(entry.size, '\0');
+  extract(entry, text.data());
+  return text;
+}
+
+}  // namespace piano_fingering::parser
@@ -0,0 +1,189 @@
+// src/trace/trace.cpp - Per-thread span recording and Chrome trace output
+
+#include "trace/trace.h"
+
+#include <chrono>
+#include <cstdio>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace piano_fingering::trace {
+
+namespace {
+
+// One thread's events. Only its thread appends, so the lock is contended
+// only while a trace is being started or written.
+struct Track {
+  std::mutex mutex;
+  std::uint32_t id{0};
+  std::string name;
+  std::vector<Event> events;
+  size_t dropped{0};
+};
+
+struct Registry {
+  std::mutex mutex;
+  // Tracks outlive their threads, so a trace keeps finished workers
+  std::vector<std::unique_ptr<Track>> tracks;
+  std::atomic<std::int64_t> epoch_ns{0};
+};
+
+Registry& registry() {
+  static Registry instance;
+  return instance;
+}
+
+thread_local Track* current_track = nullptr;
+
+Track& this_track() {
+  if (current_track == nullptr) {
+    Registry& all = registry();
+    const std::lock_guard lock(all.mutex);
+    auto track = std::make_unique<Track>();
+    track->id = static_cast<std::uint32_t>(all.tracks.size() + 1);
+    track->name = "thread " + std::to_string(track->id);
+    current_track = track.get();
+    all.tracks.push_back(std::move(track));
+  }
+  return *current_track;
+}
+
+std::int64_t steady_ns() noexcept {
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+             std::chrono::steady_clock::now().time_since_epoch())
+      .count();
+}
+
+void write_string(std::ostream& out, std::string_view text) {
+  out << '"';
+  for (const char c : text) {
+    if (c == '"' || c == '\\') {
+      out << '\\' << c;
+    } else if (static_cast<unsigned char>(c) < 0x20) {
+      char escaped[8];
+      std::snprintf(escaped, sizeof escaped, "\\u%04x",
+                    static_cast<unsigned>(c));
+      out << escaped;
+    } else {
+      out << c;
+    }
+  }
+  out << '"';
+}
+
+// Trace timestamps are microseconds; keep the nanoseconds as decimals
+void write_micros(std::ostream& out, std::int64_t ns) {
+  char text[32];
+  std::snprintf(text, sizeof text, "%lld.%03lld",
+                static_cast<long long>(ns / 1000),
+                static_cast<long long>(ns % 1000));
+  out << text;
+}
+
+void write_event(std::ostream& out, std::uint32_t tid, const Event& event) {
+  out << "{\"ph\":\"X\",\"pid\":1,\"tid\":" << tid << ",\"cat\":";
+  write_string(out, event.category);
+  out << ",\"name\":";
+  write_string(out, event.name);
+  out << ",\"ts\":";
+  write_micros(out, event.start_ns);
+  out << ",\"dur\":";
+  write_micros(out, event.duration_ns);
+  if (event.arg_name != nullptr) {
+    out << ",\"args\":{";
+    write_string(out, event.arg_name);
+    out << ':' << event.arg << '}';
+  }
+  out << '}';
+}
+
+}  // namespace
+
+void start() {
+  Registry& all = registry();
+  const std::lock_guard lock(all.mutex);
+  for (const auto& track : all.tracks) {
+    const std::lock_guard track_lock(track->mutex);
+    track->events.clear();
+    track->dropped = 0;
+  }
+  all.epoch_ns.store(steady_ns(), std::memory_order_relaxed);
+  detail::recording.store(true, std::memory_order_relaxed);
+}
+
+void stop() noexcept {
+  detail::recording.store(false, std::memory_order_relaxed);
+}
+
+std::int64_t now_ns() noexcept {
+  return steady_ns() - registry().epoch_ns.load(std::memory_order_relaxed);
+}
+
+void record(const Event& event) noexcept {
+  if (!recording()) {
+    return;
+  }
+  try {
+    Track& track = this_track();
+    const std::lock_guard lock(track.mutex);
+    if (track.events.size() < kMaxEventsPerThread) {
+      track.events.push_back(event);
+    } else {
+      ++track.dropped;
+    }
+  } catch (...) {
+    // Out of memory: the trace loses the event, the run goes on
+  }
+}
+
+void set_thread_name(std::string_view name) {
+  Track& track = this_track();
+  const std::lock_guard lock(track.mutex);
+  track.name = name;
+}
+
+size_t event_count() {
+  Registry& all = registry();
+  const std::lock_guard lock(all.mutex);
+  size_t count = 0;
+  for (const auto& track : all.tracks) {
+    const std::lock_guard track_lock(track->mutex);
+    count += track->events.size();
+  }
+  return count;
+}
+
+size_t dropped_count() {
+  Registry& all = registry();
+  const std::lock_guard lock(all.mutex);
+  size_t count = 0;
+  for (const auto& track : all.tracks) {
+    const std::lock_guard track_lock(track->mutex);
+    count += track->dropped;
+  }
+  return count;
+}
+
+void write_chrome_trace(std::ostream& out) {
+  Registry& all = registry();
+  const std::lock_guard lock(all.mutex);
+  out << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n"
+         "{\"ph\":\"M\",\"pid\":1,\"name\":\"process_name\","
+         "\"args\":{\"name\":\"piano-fingering\"}}";
+  for (const auto& track : all.tracks) {
+    const std::lock_guard track_lock(track->mutex);
+    out << ",\n{\"ph\":\"M\",\"pid\":1,\"tid\":" << track->id
+        << ",\"name\":\"thread_name\",\"args\":{\"name\":";
+    write_string(out, track->name);
+    out << "}}";
+    for (const Event& event : track->events) {
+      out << ",\n";
+      write_event(out, track->id, event);
+    }
+  }
+  out << "\n]}\n";
+}
+
+}  // namespace piano_fingering::trace
@@ -0,0 +1,85 @@
+// tests/cli/args_test.cpp - Unit tests for command-line parsing
+
+#include "cli/args.h"
+
+#include <gtest/gtest.h>
+
+#include <vector>
+
+namespace piano_fingering::cli {
+namespace {
+
+Arguments parse(std::vector<const char*> argv) {
+  argv.insert(argv.begin(), "piano-fingering");
+  return parse_arguments(static_cast<int>(argv.size()), argv.data());
+}
+
+TEST(ArgsTest, ParsesSingleScoreWithOptions) {
+  const Arguments args = parse({"--preset=Large", "--seed", "12345", "-f",
+                                "input.musicxml", "output.musicxml"});
+  EXPECT_EQ(args.preset, "Large");
+  EXPECT_EQ(args.seed, 12345U);
+  EXPECT_TRUE(args.force_overwrite);
+  EXPECT_FALSE(args.batch);
+  EXPECT_EQ(args.input, "input.musicxml");
+  EXPECT_EQ(args.output, "output.musicxml");
+}
+
+TEST(ArgsTest, ParsesBatchMode) {
+  const Arguments args =
+      parse({"--batch", "--output-dir=out", "--threads=3", "scores/"});
+  EXPECT_TRUE(args.batch);
+  EXPECT_EQ(args.input, "scores/");
+  EXPECT_EQ(args.output_dir, "out");
+  EXPECT_EQ(args.threads, 3);
+  EXPECT_FALSE(args.seed.has_value());
+
+  EXPECT_THROW((void)parse({"--batch", "a", "b"}), ArgumentError);
+}
+
+TEST(ArgsTest, ServeTakesNoPositionalArguments) {
+  const Arguments args = parse({"--serve", "--max-requests=8"});
+  EXPECT_TRUE(args.serve);
+  EXPECT_EQ(args.max_requests, 8);
+  EXPECT_EQ(args.result_cache_mib, 64);
+  EXPECT_EQ(parse({"--serve", "--result-cache", "0"}).result_cache_mib, 0);
+  EXPECT_THROW((void)parse({"--serve", "in.xml"}), ArgumentError);
+  EXPECT_THROW((void)parse({"--serve", "--max-requests=0"}), ArgumentError);
+}
+
+TEST(ArgsTest, TraceTakesAPath) {
+  EXPECT_TRUE(parse({"in.xml"}).trace_path.empty());
+  EXPECT_EQ(parse({"--trace=run.json", "in.xml"}).trace_path, "run.json");
+  EXPECT_EQ(parse({"--trace", "run.json", "in.xml"}).trace_path, "run.json");
+  EXPECT_THROW((void)parse({"in.xml", "--trace"}), ArgumentError);
+}
+
+TEST(ArgsTest, StatsIsAFlag) {
+  EXPECT_FALSE(parse({"in.xml"}).stats);
+  EXPECT_TRUE(parse({"--stats", "in.xml"}).stats);
+  EXPECT_THROW((void)parse({"--stats=1", "in.xml"}), ArgumentError);
+}
+
+TEST(ArgsTest, HelpAndVersionNeedNoInput) {
+  EXPECT_TRUE(parse({"--help"}).help);
+  EXPECT_TRUE(parse({"-v"}).version);
+}
+
+TEST(ArgsTest, RejectsBadArguments) {
+  EXPECT_THROW((void)parse({}), ArgumentError);
+  EXPECT_THROW((void)parse({"--unknown-flag", "in.xml"}), ArgumentError);
+  EXPECT_THROW((void)parse({"--seed=abc", "in.xml"}), ArgumentError);
+  EXPECT_THROW((void)parse({"--threads=0", "in.xml"}), ArgumentError);
+  EXPECT_THROW((void)parse({"in.xml", "--seed"}), ArgumentError);
+  EXPECT_THROW((void)parse({"--force=yes", "in.xml"}), ArgumentError);
+  EXPECT_THROW((void)parse({"a.xml", "b.xml", "c.xml"}), ArgumentError);
+}
+
+TEST(ArgsTest, UsageListsOptions) {
+  const std::string text = usage();
+  EXPECT_NE(text.find("USAGE:"), std::string::npos);
+  EXPECT_NE(text.find("--batch"), std::string::npos);
+}
+
+}  // namespace
+}  // namespace piano_fingering::cli
@@ -0,0 +1,119 @@
+// tests/cli/batch_test.cpp - Unit tests for batch job discovery
+
+#include "cli/batch.h"
+
+#include <gtest/gtest.h>
+
+#include <exception>
+#include <filesystem>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+
+#include "config/config_manager.h"
+#include "config/configuration_error.h"
+#include "generator/generator_error.h"
+#include "parser/parser_error.h"
+
+namespace piano_fingering::cli {
+namespace {
+
+class BatchJobsTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    dir_ = std::filesystem::temp_directory_path() / "batch_jobs_test";
+    std::filesystem::remove_all(dir_);
+    std::filesystem::create_directories(dir_ / "nested");
+  }
+
+  void TearDown() override { std::filesystem::remove_all(dir_); }
+
+  void touch(const std::filesystem::path& path) { std::ofstream(path) << ""; }
+
+  std::filesystem::path dir_;
+};
+
+TEST_F(BatchJobsTest, DefaultOutputPath) {
+  EXPECT_EQ(default_output_path("a/piece.musicxml", ""),
+            std::filesystem::path("a/piece_fingered.musicxml"));
+  EXPECT_EQ(default_output_path("a/piece.xml", "out"),
+            std::filesystem::path("out/piece_fingered.xml"));
+  EXPECT_EQ(default_output_path("a/piece.mxl", ""),
+            std::filesystem::path("a/piece_fingered.musicxml"));
+}
+
+TEST_F(BatchJobsTest, ScansDirectoryForScores) {
+  touch(dir_ / "b.musicxml");
+  touch(dir_ / "a.mxl");
+  touch(dir_ / "c.xml");
+  touch(dir_ / "a_fingered.musicxml");  // output of an earlier run
+  touch(dir_ / "notes.txt");
+  touch(dir_ / "nested" / "d.musicxml");
+
+  const auto jobs = collect_batch_jobs(dir_, dir_ / "out");
+  ASSERT_EQ(jobs.size(), 3);
+  EXPECT_EQ(jobs[0].input, dir_ / "a.mxl");
+  EXPECT_EQ(jobs[0].output, dir_ / "out" / "a_fingered.musicxml");
+  EXPECT_EQ(jobs[1].input, dir_ / "b.musicxml");
+  EXPECT_EQ(jobs[2].input, dir_ / "c.xml");
+}
+
+TEST_F(BatchJobsTest, ReadsManifest) {
+  std::ofstream(dir_ / "batch.txt") << "# scores to finger\n"
+                                       "nested/d.musicxml\r\n"
+                                       "\n"
+                                       "  /abs/e.xml  \n";
+  const auto jobs = collect_batch_jobs(dir_ / "batch.txt", "");
+  ASSERT_EQ(jobs.size(), 2);
+  EXPECT_EQ(jobs[0].input, dir_ / "nested" / "d.musicxml");
+  EXPECT_EQ(jobs[0].output, dir_ / "nested" / "d_fingered.musicxml");
+  EXPECT_EQ(jobs[1].input, std::filesystem::path("/abs/e.xml"));
+}
+
+TEST_F(BatchJobsTest, MissingSourceThrows) {
+  EXPECT_THROW((void)collect_batch_jobs(dir_ / "missing", ""),
+               parser::FileNotFoundError);
+}
+
+TEST_F(BatchJobsTest, ReportsSkippedNotes) {
+  const auto input = dir_ / "skips.musicxml";
+  std::ofstream(input) << R"(<?xml version="1.0" encoding="UTF-8"?>
+<score-partwise version="3.1">
+  <part-list><score-part id="P1"><part-name>Piano</part-name></score-part>
+  </part-list>
+  <part id="P1">
+    <measure number="3">
+      <note><pitch><step>C</step><octave>4</octave></pitch>
+        <duration>1</duration><staff>1</staff></note>
+      <note><pitch><step>H</step><octave>4</octave></pitch>
+        <duration>1</duration><staff>1</staff></note>
+    </measure>
+  </part>
+</score-partwise>
+)";
+  BatchOptions options;
+  options.threads = 1;
+  const auto results =
+      run_batch({{input, dir_ / "out.musicxml"}},
+                config::ConfigManager::load_preset("Medium"), options, {});
+  ASSERT_EQ(results.size(), 1);
+  EXPECT_EQ(results[0].exit_code, 0) << results[0].error;
+  ASSERT_EQ(results[0].warnings.size(), 1);
+  EXPECT_EQ(results[0].warnings[0].rfind("Measure 3: skipping note", 0), 0);
+}
+
+TEST(BatchExitCodeTest, MapsErrorsToCliExitCodes) {
+  auto code = [](auto error) {
+    return exit_code_for(std::make_exception_ptr(error));
+  };
+  EXPECT_EQ(exit_code_for(nullptr), 0);
+  EXPECT_EQ(code(parser::FileNotFoundError("x")), 2);
+  EXPECT_EQ(code(parser::MissingElementError("part")), 3);
+  EXPECT_EQ(code(config::ConfigurationError("bad")), 4);
+  EXPECT_EQ(code(generator::FileExistsError("x")), 5);
+  EXPECT_EQ(code(generator::FileWriteError("x")), 6);
+  EXPECT_EQ(code(std::runtime_error("other")), 7);
+}
+
+}  // namespace
+}  // namespace piano_fingering::cli
@@ -0,0 +1,136 @@
+// tests/cli/pipeline_test.cpp - Unit tests for BoundedQueue and run_pipeline
+
+#include "cli/pipeline.h"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <exception>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "cli/bounded_queue.h"
+
+namespace piano_fingering::cli {
+namespace {
+
+TEST(BoundedQueueTest, DeliversInOrderThenDrainsAfterClose) {
+  BoundedQueue<int> queue(2);
+  EXPECT_TRUE(queue.push(1));
+  EXPECT_TRUE(queue.push(2));
+  queue.close();
+  EXPECT_FALSE(queue.push(3));
+  EXPECT_EQ(queue.pop(), 1);
+  EXPECT_EQ(queue.pop(), 2);
+  EXPECT_EQ(queue.pop(), std::nullopt);
+  EXPECT_THROW(BoundedQueue<int>(0), std::invalid_argument);
+}
+
+TEST(BoundedQueueTest, PushBlocksWhileFull) {
+  BoundedQueue<int> queue(1);
+  ASSERT_TRUE(queue.push(1));
+  std::atomic<bool> pushed{false};
+  std::thread producer([&] {
+    queue.push(2);
+    pushed = true;
+  });
+  std::this_thread::sleep_for(std::chrono::milliseconds(20));
+  EXPECT_FALSE(pushed);
+  EXPECT_EQ(queue.pop(), 1);
+  producer.join();
+  EXPECT_TRUE(pushed);
+  EXPECT_EQ(queue.pop(), 2);
+}
+
+TEST(PipelineTest, RunsEveryItemThroughEveryStageInOrder) {
+  std::vector<std::string> written;
+  std::vector<size_t> failed;
+  run_pipeline<int, std::string>(
+      20, 2, [](size_t i) { return static_cast<int>(i) * 10; },
+      [](size_t, int& value) { return std::to_string(value + 1); },
+      [&](size_t, std::string& text) { written.push_back(text); },
+      [&](size_t i, const std::exception_ptr&) { failed.push_back(i); });
+  ASSERT_EQ(written.size(), 20);
+  for (size_t i = 0; i < written.size(); ++i) {
+    EXPECT_EQ(written[i], std::to_string(i * 10 + 1));
+  }
+  EXPECT_TRUE(failed.empty());
+}
+
+TEST(PipelineTest, StagesOverlap) {
+  // The parse stage runs ahead of optimization, but by no more than the
+  // queue capacity plus the item it is holding
+  std::atomic<size_t> parsed{0};
+  size_t max_lead = 0;
+  run_pipeline<size_t, size_t>(
+      10, 2,
+      [&](size_t i) {
+        parsed = i + 1;
+        return i;
+      },
+      [&](size_t i, size_t& value) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+        max_lead = std::max(max_lead, parsed.load() - i);
+        return value;
+      },
+      [](size_t, size_t&) {}, [](size_t, const std::exception_ptr&) {});
+  EXPECT_GT(max_lead, 1);
+  EXPECT_LE(max_lead, 4);
+}
+
+TEST(PipelineTest, FailuresSkipLaterStagesAndAreReportedInOrder) {
+  std::vector<size_t> order;
+  std::vector<std::string> errors;
+  run_pipeline<int, int>(
+      6, 1,
+      [](size_t i) {
+        if (i == 1) {
+          throw std::runtime_error("parse 1");
+        }
+        return static_cast<int>(i);
+      },
+      [](size_t i, int& value) {
+        if (i == 3) {
+          throw std::runtime_error("optimize 3");
+        }
+        return value;
+      },
+      [&](size_t i, int&) {
+        if (i == 4) {
+          throw std::runtime_error("write 4");
+        }
+        order.push_back(i);
+      },
+      [&](size_t i, const std::exception_ptr& error) {
+        order.push_back(i);
+        try {
+          std::rethrow_exception(error);
+        } catch (const std::exception& e) {
+          errors.emplace_back(e.what());
+        }
+      });
+  EXPECT_EQ(order, (std::vector<size_t>{0, 1, 2, 3, 4, 5}));
+  EXPECT_EQ(errors,
+            (std::vector<std::string>{"parse 1", "optimize 3", "write 4"}));
+}
+
+TEST(PipelineTest, EmptyBatchRunsNothing) {
+  bool called = false;
+  run_pipeline<int, int>(
+      0, 1,
+      [&](size_t) {
+        called = true;
+        return 0;
+      },
+      [&](size_t, int& v) { return v; }, [&](size_t, int&) {},
+      [&](size_t, const std::exception_ptr&) {});
+  EXPECT_FALSE(called);
+}
+
+}  // namespace
+}  // namespace piano_fingering::cli
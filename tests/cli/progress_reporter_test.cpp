@@ -0,0 +1,75 @@
+// tests/cli/progress_reporter_test.cpp - Unit tests for progress output
+
+#include "cli/progress_reporter.h"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <chrono>
+#include <sstream>
+#include <string>
+#include <thread>
+
+#include "domain/hand.h"
+#include "optimizer/progress.h"
+
+namespace piano_fingering::cli {
+namespace {
+
+using optimizer::ProgressChannel;
+using optimizer::ProgressPhase;
+
+void start(ProgressChannel& channel, domain::Hand hand,
+           std::uint32_t measures) {
+  (void)channel.publish({ProgressPhase::kBeamSearch, hand, measures, 100});
+}
+
+void advance(ProgressChannel& channel, domain::Hand hand,
+             std::uint64_t iterations) {
+  (void)channel.publish({ProgressPhase::kLocalSearch, hand, 0, iterations});
+}
+
+TEST(ProgressReporterTest, ShowsTheFurtherHand) {
+  ProgressChannel channel;
+  start(channel, domain::Hand::kRight, 8);
+  start(channel, domain::Hand::kLeft, 6);
+  advance(channel, domain::Hand::kRight, 50);
+  advance(channel, domain::Hand::kLeft, 100);
+  std::ostringstream out;
+  {
+    const ProgressReporter reporter(channel, out,
+                                    std::chrono::milliseconds(0));
+  }
+  EXPECT_EQ(out.str(), "\rProcessing Measure [6 / 8]...\n");
+}
+
+TEST(ProgressReporterTest, RateLimitsButPrintsTheFinalLine) {
+  ProgressChannel channel;
+  start(channel, domain::Hand::kRight, 8);
+  advance(channel, domain::Hand::kRight, 50);
+  std::ostringstream out;
+  {
+    const ProgressReporter reporter(channel, out, std::chrono::hours(1));
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    advance(channel, domain::Hand::kRight, 25);
+    (void)channel.publish(
+        {ProgressPhase::kComplete, domain::Hand::kRight, 8, 100});
+  }
+  const std::string text = out.str();
+  EXPECT_LE(std::count(text.begin(), text.end(), '\r'), 2);
+  EXPECT_EQ(text.find("[6 / 8]"), std::string::npos);
+  EXPECT_NE(text.find("\rProcessing Measure [8 / 8]...\n"), std::string::npos);
+}
+
+TEST(ProgressReporterTest, NothingPublishedPrintsNothing) {
+  ProgressChannel channel;
+  std::ostringstream out;
+  {
+    const ProgressReporter reporter(channel, out,
+                                    ProgressReporter::kDefaultInterval);
+  }
+  EXPECT_TRUE(out.str().empty());
+}
+
+}  // namespace
+}  // namespace piano_fingering::cli
@@ -0,0 +1,154 @@
+// tests/cli/server_test.cpp - Unit tests for the JSON-lines server
+
+#include "cli/server.h"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <nlohmann/json.hpp>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace piano_fingering::cli {
+namespace {
+
+nlohmann::json respond(Server& server, const std::string& request) {
+  return nlohmann::json::parse(server.handle(request));
+}
+
+TEST(ServerTest, MalformedRequestsAreRejected) {
+  Server server(1, 1);
+  for (const char* request :
+       {"not json", "[1, 2]", "{\"id\": 3}", "{\"input\": 5}",
+        "{\"input\": \"a.xml\", \"seed\": \"x\"}"}) {
+    const auto response = respond(server, request);
+    EXPECT_FALSE(response["ok"].get<bool>()) << request;
+    EXPECT_EQ(response["exit_code"], 1) << request;
+  }
+  EXPECT_EQ(respond(server, "{\"id\": 3}")["id"], 3);
+}
+
+TEST(ServerTest, ErrorsCarryCliExitCodes) {
+  Server server(1, 1);
+  const auto missing = respond(
+      server, R"({"id": "a", "input": "/nonexistent/score.musicxml"})");
+  EXPECT_EQ(missing["id"], "a");
+  EXPECT_FALSE(missing["ok"].get<bool>());
+  EXPECT_EQ(missing["exit_code"], 2);
+
+  const auto preset = respond(
+      server, R"({"input": "/nonexistent/score.musicxml", "preset": "Huge"})");
+  EXPECT_EQ(preset["exit_code"], 4);
+}
+
+TEST(ServerTest, KeepsOneOptimizerPerConfig) {
+  Server server(2, 1);
+  EXPECT_EQ(server.cached_configs(), 0);
+  (void)server.handle(R"({"input": "/nonexistent/a.xml", "preset": "Small"})");
+  (void)server.handle(R"({"input": "/nonexistent/b.xml", "preset": "Small"})");
+  EXPECT_EQ(server.cached_configs(), 1);
+  (void)server.handle(R"({"input": "/nonexistent/c.xml", "preset": "Large"})");
+  EXPECT_EQ(server.cached_configs(), 2);
+}
+
+TEST(ServerTest, EqualConfigsShareAnOptimizer) {
+  const auto path =
+      std::filesystem::temp_directory_path() / "server_test_config.json";
+  std::ofstream(path) << "{}";
+  Server server(1, 1);
+  (void)server.handle(R"({"input": "/nonexistent/a.xml"})");
+  // An empty override file over Medium is the Medium preset
+  const nlohmann::json custom = {{"input", "/nonexistent/b.xml"},
+                                 {"config", path.string()}};
+  (void)server.handle(custom.dump());
+  EXPECT_EQ(server.cached_configs(), 1);
+
+  std::ofstream(path) << R"({"rule_weights": [3.0]})";
+  (void)server.handle(custom.dump());
+  EXPECT_EQ(server.cached_configs(), 2);
+  std::filesystem::remove(path);
+}
+
+TEST(ServerTest, EvictsLeastRecentlyUsedConfigs) {
+  const auto dir = std::filesystem::temp_directory_path() / "server_lru";
+  std::filesystem::create_directories(dir);
+  auto request = [&](size_t i) {
+    const auto path = dir / ("config" + std::to_string(i) + ".json");
+    std::ofstream(path) << "{\"rule_weights\": [" << 2 + i << ".0]}";
+    return nlohmann::json{{"input", "/nonexistent/a.xml"},
+                          {"config", path.string()}}
+        .dump();
+  };
+  Server server(1, 1);
+  (void)server.handle(R"({"input": "/nonexistent/a.xml"})");
+  for (size_t i = 0; i < Server::kMaxCachedConfigs + 3; ++i) {
+    (void)server.handle(request(i));
+    // Medium stays the most recently used after every other config
+    (void)server.handle(R"({"input": "/nonexistent/a.xml"})");
+    EXPECT_LE(server.cached_configs(), Server::kMaxCachedConfigs);
+  }
+  EXPECT_EQ(server.cached_configs(), Server::kMaxCachedConfigs);
+  std::filesystem::remove_all(dir);
+}
+
+TEST(ServerTest, ResponsesListSkippedNotes) {
+  const auto dir = std::filesystem::temp_directory_path() / "server_test";
+  std::filesystem::create_directories(dir);
+  const auto input = dir / "skips.musicxml";
+  std::ofstream(input) << R"(<?xml version="1.0" encoding="UTF-8"?>
+<score-partwise version="3.1">
+  <part id="P1">
+    <measure number="2">
+      <note><pitch><step>C</step><octave>4</octave></pitch>
+        <duration>1</duration></note>
+      <note><pitch><step>D</step><octave>4</octave></pitch>
+        <duration>1</duration><voice>9</voice></note>
+    </measure>
+  </part>
+</score-partwise>
+)";
+  Server server(1, 1);
+  const nlohmann::json request = {{"input", input.string()},
+                                  {"output", (dir / "out.musicxml").string()},
+                                  {"seed", 1},
+                                  {"force", true}};
+  const auto response = respond(server, request.dump());
+  ASSERT_TRUE(response["ok"].get<bool>()) << response.dump();
+  ASSERT_EQ(response["warnings"].size(), 1);
+  EXPECT_EQ(response["warnings"][0].get<std::string>().rfind(
+                "Measure 2: skipping note", 0),
+            0);
+  std::filesystem::remove_all(dir);
+}
+
+TEST(ServerTest, ServeAnswersEveryRequestLine) {
+  Server server(2, 3);
+  std::istringstream in(
+      "{\"id\": 1, \"input\": \"/nonexistent/1.xml\"}\n"
+      "\n"
+      "{\"id\": 2, \"input\": \"/nonexistent/2.xml\"}\n"
+      "{\"id\": 3, \"input\": \"/nonexistent/3.xml\"}\n"
+      "{\"id\": 4, \"input\": \"/nonexistent/4.xml\"}\n");
+  std::ostringstream out;
+  server.serve(in, out);
+
+  std::istringstream lines(out.str());
+  std::vector<int> ids;
+  for (std::string line; std::getline(lines, line);) {
+    ids.push_back(nlohmann::json::parse(line)["id"].get<int>());
+  }
+  std::sort(ids.begin(), ids.end());
+  EXPECT_EQ(ids, (std::vector<int>{1, 2, 3, 4}));
+}
+
+TEST(ServerTest, RejectsZeroLimits) {
+  EXPECT_THROW(Server(0, 1), std::invalid_argument);
+  EXPECT_THROW(Server(1, 0), std::invalid_argument);
+}
+
+}  // namespace
+}  // namespace piano_fingering::cli
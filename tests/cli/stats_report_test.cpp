@@ -0,0 +1,60 @@
+// tests/cli/stats_report_test.cpp - Unit tests for --stats output
+
+#include "cli/stats_report.h"
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <sstream>
+#include <string>
+
+#include "optimizer/search_stats.h"
+
+namespace piano_fingering::cli {
+namespace {
+
+using std::chrono::milliseconds;
+
+std::string report(const optimizer::SearchStats& stats) {
+  std::ostringstream out;
+  write_stats(out, stats);
+  return out.str();
+}
+
+TEST(StatsReportTest, ReportsRatesAndOccupancy) {
+  optimizer::SearchStats stats;
+  stats.full_evaluations = 8;
+  stats.delta_evaluations = 1'999'992;
+  stats.beam_slices = 10;
+  stats.beam_children = 200;
+  stats.beam_bound_pruned = 100;
+  stats.beam_width_pruned = 60;
+  stats.beam_kept = 40;
+  stats.beam_capacity = 50;
+  stats.ils_iterations = 400;
+  stats.ils_improvements = 7;
+  stats.ils_moves = 900;
+  stats.thread_busy = {milliseconds(900), milliseconds(700), milliseconds(0)};
+  stats.wall = milliseconds(1000);
+
+  const std::string text = report(stats);
+  EXPECT_NE(text.find("evaluations: 8 full, 2.0M delta, 2.0M/s over 1.00 s"),
+            std::string::npos);
+  EXPECT_NE(text.find("beam: 10 slices, 80% occupancy, 50% of children "
+                      "pruned by bound, 30% by width"),
+            std::string::npos);
+  EXPECT_NE(text.find("ils: 400 iterations, 7 improvements, 900 moves"),
+            std::string::npos);
+  EXPECT_NE(text.find("threads: 2 busy 80% of the time (0.90 0.70 0.00 s)"),
+            std::string::npos);
+  EXPECT_EQ(text.find("result cache"), std::string::npos);
+}
+
+TEST(StatsReportTest, CacheHitHasNoSearchLines) {
+  optimizer::SearchStats stats;
+  stats.result_cache_hits = 2;
+  EXPECT_EQ(report(stats), "  result cache: 2 hit(s), 0 miss(es)\n");
+}
+
+}  // namespace
+}  // namespace piano_fingering::cli
@@ -10,6 +10,9 @@ TEST(AlgorithmParametersTest, HasDefaultValues) {
   EXPECT_EQ(params.beam_width, 100);
   EXPECT_EQ(params.ils_iterations, 1000);
   EXPECT_EQ(params.perturbation_strength, 3);
+  EXPECT_EQ(params.beam_states_per_slice, 0);
+  EXPECT_EQ(params.ils_trajectories, 8);
+  EXPECT_FALSE(params.fixed_point_costs);
 }
 
 TEST(AlgorithmParametersTest, IsValidReturnsTrueForPositiveValues) {
@@ -22,6 +25,12 @@ TEST(AlgorithmParametersTest, IsValidReturnsFalseForZeroBeamWidth) {
   EXPECT_FALSE(params.is_valid());
 }
 
+TEST(AlgorithmParametersTest, IsValidReturnsFalseForZeroTrajectories) {
+  AlgorithmParameters params{};
+  params.ils_trajectories = 0;
+  EXPECT_FALSE(params.is_valid());
+}
+
 TEST(AlgorithmParametersTest, EqualityOperator) {
   AlgorithmParameters a{100, 1000, 3};
   AlgorithmParameters b{100, 1000, 3};
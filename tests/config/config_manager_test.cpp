@@ -89,13 +89,19 @@ TEST_F(ConfigManagerJsonTest, LoadCustomOverridesAlgorithmParameters) {
   write_json("algo.json", R"({
     "algorithm": {
       "beam_width": 200,
-      "ils_iterations": 500
+      "ils_iterations": 500,
+      "beam_states_per_slice": 8,
+      "ils_trajectories": 3,
+      "fixed_point_costs": true
     }
   })");
   Config cfg = ConfigManager::load_custom(test_dir_ / "algo.json");
   EXPECT_EQ(cfg.algorithm.beam_width, 200);
   EXPECT_EQ(cfg.algorithm.ils_iterations, 500);
   EXPECT_EQ(cfg.algorithm.perturbation_strength, 3);
+  EXPECT_EQ(cfg.algorithm.beam_states_per_slice, 8);
+  EXPECT_EQ(cfg.algorithm.ils_trajectories, 3);
+  EXPECT_TRUE(cfg.algorithm.fixed_point_costs);
 }
 
 TEST_F(ConfigManagerJsonTest, LoadCustomOverridesRuleWeights) {
@@ -122,6 +128,26 @@ TEST_F(ConfigManagerJsonTest, LoadCustomOverridesDistanceMatrix) {
   EXPECT_EQ(thumb_index.max_prac, 12);
 }
 
+TEST_F(ConfigManagerJsonTest, LoadCustomRepeatsAreEqual) {
+  write_json("repeat.json", R"({"rule_weights": [2.5]})");
+  const Config first = ConfigManager::load_custom(test_dir_ / "repeat.json");
+  const Config second = ConfigManager::load_custom(test_dir_ / "repeat.json");
+  EXPECT_EQ(first, second);
+  // Same content over another base preset is another config
+  const Config small =
+      ConfigManager::load_custom(test_dir_ / "repeat.json", "small");
+  EXPECT_EQ(small.right_hand, ConfigManager::load_preset("Small").right_hand);
+}
+
+TEST_F(ConfigManagerJsonTest, LoadCustomSeesEditedFile) {
+  write_json("edited.json", R"({"rule_weights": [2.5]})");
+  const Config before = ConfigManager::load_custom(test_dir_ / "edited.json");
+  write_json("edited.json", R"({"rule_weights": [4.0]})");
+  const Config after = ConfigManager::load_custom(test_dir_ / "edited.json");
+  EXPECT_DOUBLE_EQ(before.weights.values[0], 2.5);
+  EXPECT_DOUBLE_EQ(after.weights.values[0], 4.0);
+}
+
 TEST_F(ConfigManagerJsonTest, LoadCustomThrowsForInvalidJson) {
   write_json("invalid.json", "{ not valid }");
   EXPECT_THROW(
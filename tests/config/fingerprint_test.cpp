@@ -0,0 +1,72 @@
+#include "config/fingerprint.h"
+
+#include <gtest/gtest.h>
+
+#include <string_view>
+
+#include "config/preset.h"
+
+namespace piano_fingering::config {
+namespace {
+
+static_assert(fingerprint(kMediumPreset.to_config()) ==
+              fingerprint(kMediumPreset.to_config()));
+static_assert(fingerprint(kSmallPreset.to_config()) !=
+              fingerprint(kLargePreset.to_config()));
+
+TEST(FingerprintTest, EqualConfigsMatch) {
+  const Config a = get_medium_preset().to_config();
+  const Config b = get_medium_preset().to_config();
+  EXPECT_EQ(fingerprint(a), fingerprint(b));
+  EXPECT_EQ(penalty_fingerprint(a), penalty_fingerprint(b));
+}
+
+TEST(FingerprintTest, EveryPartChangesTheFingerprint) {
+  const Config base = get_medium_preset().to_config();
+
+  Config weights = base;
+  weights.weights.values[3] += 0.5;
+  EXPECT_NE(fingerprint(weights), fingerprint(base));
+  EXPECT_NE(penalty_fingerprint(weights), penalty_fingerprint(base));
+
+  Config left = base;
+  left.left_hand.finger_pairs[0].max_prac += 1;
+  EXPECT_NE(fingerprint(left), fingerprint(base));
+  EXPECT_NE(penalty_fingerprint(left), penalty_fingerprint(base));
+
+  // Swapping the hands' matrices is a different config
+  Config swapped = base;
+  swapped.left_hand = base.right_hand;
+  swapped.right_hand = base.left_hand;
+  EXPECT_NE(fingerprint(swapped), fingerprint(base));
+}
+
+TEST(FingerprintTest, PenaltyFingerprintIgnoresSearchParameters) {
+  const Config base = get_medium_preset().to_config();
+  Config algorithm = base;
+  algorithm.algorithm.ils_iterations += 1;
+  EXPECT_NE(fingerprint(algorithm), fingerprint(base));
+  EXPECT_EQ(penalty_fingerprint(algorithm), penalty_fingerprint(base));
+}
+
+TEST(FingerprintTest, SignedZeroWeightsMatch) {
+  Config positive = get_medium_preset().to_config();
+  Config negative = positive;
+  positive.weights.values[0] = 0.0;
+  negative.weights.values[0] = -0.0;
+  EXPECT_EQ(fingerprint(positive), fingerprint(negative));
+}
+
+TEST(FingerprintTest, StringsHashByContentAndLength) {
+  const auto hash = [](std::string_view text) {
+    Fingerprinter hasher;
+    hasher.add(text);
+    return hasher.finish();
+  };
+  EXPECT_EQ(hash("{\"rule_weights\": [1]}"), hash("{\"rule_weights\": [1]}"));
+  EXPECT_NE(hash("{}"), hash("{ }"));
+  EXPECT_NE(hash(std::string_view("a\0", 2)), hash("a"));
+}
+
+}  // namespace
+}  // namespace piano_fingering::config
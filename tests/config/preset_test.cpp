@@ -49,6 +49,24 @@ TEST(PresetTest, LargePresetIsValid) {
   EXPECT_TRUE(preset.to_config().is_valid());
 }
 
+TEST(PresetTest, PresetsAreCompileTimeConstants) {
+  static_assert(kMediumPreset.left_hand ==
+                mirror_to_left_hand(kMediumPreset.right_hand));
+  static_assert(get_large_preset().name == kPresetLarge);
+  constexpr Config kConfig = kSmallPreset.to_config();
+  static_assert(kConfig.is_valid());
+  EXPECT_EQ(kConfig, get_small_preset().to_config());
+}
+
+TEST(PresetTest, FindPresetIgnoresCase) {
+  static_assert(find_preset("medium") == &kMediumPreset);
+  EXPECT_EQ(find_preset("LARGE"), &get_large_preset());
+  EXPECT_EQ(find_preset("sMaLl"), &get_small_preset());
+  EXPECT_EQ(find_preset("Huge"), nullptr);
+  EXPECT_EQ(find_preset("Smal"), nullptr);
+  EXPECT_EQ(find_preset(""), nullptr);
+}
+
 TEST(PresetTest, PresetsHaveDifferentDistances) {
   const Preset& small = get_small_preset();
   const Preset& large = get_large_preset();
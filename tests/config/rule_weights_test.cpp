@@ -2,6 +2,8 @@
 
 #include <gtest/gtest.h>
 
+#include <cstddef>
+
 namespace piano_fingering::config {
 namespace {
 
@@ -36,6 +38,16 @@ TEST(RuleWeightsTest, DefaultWeightsMatchSRS) {
   EXPECT_DOUBLE_EQ(weights.values[12], 10.0);  // Rule 13
 }
 
+TEST(RuleWeightsTest, EnabledRulesSkipsZeroWeights) {
+  RuleWeights weights = RuleWeights::defaults();
+  EXPECT_EQ(weights.enabled_rules(), kAllRules);
+
+  weights.values[static_cast<std::size_t>(RuleIndex::kThumbOnBlack)] = 0.0;
+  EXPECT_EQ(weights.enabled_rules(),
+            kAllRules & ~rule_bit(RuleIndex::kThumbOnBlack));
+  EXPECT_EQ(RuleWeights{}.enabled_rules(), 0);
+}
+
 TEST(RuleWeightsTest, EqualityOperator) {
   RuleWeights a = RuleWeights::defaults();
   RuleWeights b = RuleWeights::defaults();
@@ -2,7 +2,10 @@
 
 #include <gtest/gtest.h>
 
+#include <array>
 #include <sstream>
+#include <stdexcept>
+#include <vector>
 
 namespace piano_fingering::domain {
 namespace {
@@ -21,6 +24,30 @@ TEST(FingeringTest, ConstructWithAssignments) {
   EXPECT_FALSE(f.empty());
 }
 
+TEST(FingeringTest, ConstructFromVector) {
+  std::vector<std::optional<Finger>> assignments = {Finger::kIndex,
+                                                    std::nullopt};
+  Fingering f(assignments);
+  EXPECT_EQ(f.size(), 2);
+  EXPECT_EQ(f[0], Finger::kIndex);
+  EXPECT_FALSE(f[1].has_value());
+}
+
+TEST(FingeringTest, ConstructTooManyAssignments) {
+  std::vector<std::optional<Finger>> assignments(6, Finger::kThumb);
+  EXPECT_THROW({ [[maybe_unused]] Fingering f(assignments); },
+               std::invalid_argument);
+}
+
+TEST(FingeringTest, ConstructFromRange) {
+  const std::array<std::optional<Finger>, 3> assignments{
+      Finger::kRing, std::nullopt, Finger::kMiddle};
+  Fingering f(assignments.begin(), assignments.end());
+  EXPECT_EQ(f.size(), 3);
+  EXPECT_EQ(f[0], Finger::kRing);
+  EXPECT_EQ(f[2], Finger::kMiddle);
+}
+
 TEST(FingeringTest, Access) {
   Fingering f({Finger::kThumb, std::nullopt, Finger::kPinky});
   EXPECT_TRUE(f[0].has_value());
@@ -0,0 +1,63 @@
+#include "domain/inline_vector.h"
+
+#include <gtest/gtest.h>
+
+#include <array>
+#include <stdexcept>
+
+#include "domain/note.h"
+#include "domain/pitch.h"
+
+namespace piano_fingering::domain {
+namespace {
+
+TEST(InlineVectorTest, PushBackUpToCapacity) {
+  InlineVector<int, 3> values;
+  EXPECT_TRUE(values.empty());
+  EXPECT_EQ(values.capacity(), 3);
+
+  values.push_back(4);
+  values.push_back(5);
+  values.push_back(6);
+  EXPECT_EQ(values.size(), 3);
+  EXPECT_EQ(values[0], 4);
+  EXPECT_EQ(values[2], 6);
+  EXPECT_THROW(values.push_back(7), std::length_error);
+  EXPECT_EQ(values.size(), 3);
+}
+
+TEST(InlineVectorTest, ConstructFromRange) {
+  const std::array<int, 4> source{1, 2, 3, 4};
+  InlineVector<int, 4> values(source.begin(), source.end());
+  int sum = 0;
+  for (int value : values) {
+    sum += value;
+  }
+  EXPECT_EQ(sum, 10);
+
+  using Small = InlineVector<int, 3>;
+  EXPECT_THROW({ [[maybe_unused]] Small s(source.begin(), source.end()); },
+               std::length_error);
+}
+
+TEST(InlineVectorTest, CopiesAreIndependent) {
+  InlineVector<int, 2> original;
+  original.push_back(1);
+  InlineVector<int, 2> copy = original;
+  copy[0] = 9;
+  copy.push_back(2);
+  EXPECT_EQ(original.size(), 1);
+  EXPECT_EQ(original[0], 1);
+  EXPECT_EQ(copy.size(), 2);
+  EXPECT_EQ(copy[0], 9);
+}
+
+TEST(InlineVectorTest, HoldsTypesWithoutDefaultConstructor) {
+  InlineVector<Note, 2> notes;
+  notes.push_back(Note(Pitch(3), 4, 240, false, 1, 1));
+  EXPECT_EQ(notes[0].absolute_pitch(), 4 * 14 + 3);
+  static_assert(sizeof(notes) <= 2 * sizeof(Note) + alignof(Note));
+}
+
+}  // namespace
+}  // namespace piano_fingering::domain
@@ -55,6 +55,24 @@ TEST(NoteTest, Accessors) {
   EXPECT_EQ(n.voice(), 3);
 }
 
+TEST(NoteTest, PackedFieldsRoundTrip) {
+  static_assert(sizeof(Note) == 8);
+  for (int staff = 1; staff <= 2; ++staff) {
+    for (int voice = 1; voice <= 4; ++voice) {
+      for (bool rest : {false, true}) {
+        Note n(Pitch(13), 10, 0xFFFFFFFFU, rest, staff, voice);
+        EXPECT_EQ(n.pitch(), Pitch(13));
+        EXPECT_EQ(n.octave(), 10);
+        EXPECT_EQ(n.duration(), 0xFFFFFFFFU);
+        EXPECT_EQ(n.is_rest(), rest);
+        EXPECT_EQ(n.staff(), staff);
+        EXPECT_EQ(n.voice(), voice);
+        EXPECT_EQ(n.absolute_pitch(), 10 * 14 + 13);
+      }
+    }
+  }
+}
+
 TEST(NoteTest, AbsolutePitchCalculation) {
   Note n1(Pitch(0), 0, 240, false, 1, 1);  // C0 -> 0*14 + 0 = 0
   EXPECT_EQ(n1.absolute_pitch(), 0);
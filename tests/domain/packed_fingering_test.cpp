@@ -0,0 +1,121 @@
+#include "domain/packed_fingering.h"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <sstream>
+#include <stdexcept>
+#include <type_traits>
+#include <vector>
+
+namespace piano_fingering::domain {
+namespace {
+
+static_assert(sizeof(PackedFingering) == sizeof(std::uint16_t));
+static_assert(std::is_trivially_copyable_v<PackedFingering>);
+
+TEST(PackedFingeringTest, DefaultIsUnassigned) {
+  PackedFingering packed;
+  EXPECT_EQ(packed.bits(), 0);
+  for (size_t k = 0; k < kMaxNotesPerSlice; ++k) {
+    EXPECT_FALSE(packed[k].has_value());
+  }
+}
+
+TEST(PackedFingeringTest, RoundTripsFingering) {
+  Fingering fingering({Finger::kThumb, std::nullopt, Finger::kMiddle,
+                       Finger::kRing, Finger::kPinky});
+  PackedFingering packed(fingering);
+
+  EXPECT_EQ(packed[0], Finger::kThumb);
+  EXPECT_FALSE(packed[1].has_value());
+  EXPECT_EQ(packed[4], Finger::kPinky);
+
+  Fingering unpacked = packed.unpack(fingering.size());
+  EXPECT_TRUE(std::equal(unpacked.begin(), unpacked.end(), fingering.begin(),
+                         fingering.end()));
+}
+
+TEST(PackedFingeringTest, SetReplacesSingleNote) {
+  PackedFingering packed(Fingering({Finger::kThumb, Finger::kIndex}));
+  packed.set(1, Finger::kPinky);
+  packed.set(0, std::nullopt);
+
+  EXPECT_FALSE(packed[0].has_value());
+  EXPECT_EQ(packed[1], Finger::kPinky);
+  EXPECT_FALSE(packed[2].has_value());
+}
+
+TEST(PackedFingeringTest, FingerMask) {
+  PackedFingering packed(Fingering({Finger::kIndex, Finger::kPinky}));
+  EXPECT_EQ(packed.finger_mask(), 0b10010);
+}
+
+TEST(PackedFingeringTest, ViolatesHardConstraint) {
+  EXPECT_FALSE(PackedFingering(Fingering({Finger::kThumb, std::nullopt,
+                                          Finger::kRing}))
+                   .violates_hard_constraint());
+  EXPECT_TRUE(
+      PackedFingering(Fingering({Finger::kThumb, Finger::kIndex,
+                                 Finger::kThumb}))
+          .violates_hard_constraint());
+}
+
+TEST(PackedFingeringTest, RejectsOutOfRange) {
+  PackedFingering packed;
+  EXPECT_THROW({ [[maybe_unused]] auto f = packed[5]; }, std::out_of_range);
+  EXPECT_THROW(packed.set(5, Finger::kThumb), std::out_of_range);
+  EXPECT_THROW({ [[maybe_unused]] auto f = packed.unpack(6); },
+               std::out_of_range);
+  EXPECT_THROW(
+      PackedFingering(Fingering({Finger::kThumb, Finger::kIndex,
+                                 Finger::kMiddle, Finger::kRing,
+                                 Finger::kPinky, Finger::kThumb})),
+      std::invalid_argument);
+}
+
+TEST(PackedFingeringTest, StreamOutput) {
+  std::ostringstream os;
+  os << PackedFingering(Fingering({Finger::kIndex}));
+  EXPECT_EQ(os.str(), "PackedFingering([2, null, null, null, null])");
+}
+
+TEST(PackedFingeringSequenceTest, RoundTripsFingerings) {
+  std::vector<Fingering> fingerings = {
+      Fingering({Finger::kThumb}),
+      Fingering({Finger::kIndex, std::nullopt, Finger::kPinky}), Fingering()};
+  PackedFingeringSequence sequence(fingerings);
+
+  ASSERT_EQ(sequence.size(), 3);
+  EXPECT_EQ(sequence.note_count(1), 3);
+  EXPECT_EQ(sequence[1][2], Finger::kPinky);
+
+  auto unpacked = sequence.unpack();
+  ASSERT_EQ(unpacked.size(), fingerings.size());
+  for (size_t s = 0; s < unpacked.size(); ++s) {
+    EXPECT_TRUE(std::equal(unpacked[s].begin(), unpacked[s].end(),
+                           fingerings[s].begin(), fingerings[s].end()));
+  }
+}
+
+TEST(PackedFingeringSequenceTest, SetAndHardConstraint) {
+  PackedFingeringSequence sequence(
+      std::vector<Fingering>{Fingering({Finger::kThumb, Finger::kIndex})});
+  EXPECT_FALSE(sequence.violates_hard_constraint());
+
+  sequence.set(0, PackedFingering(Fingering({Finger::kRing, Finger::kRing})));
+  EXPECT_TRUE(sequence.violates_hard_constraint());
+  EXPECT_THROW(sequence.set(1, PackedFingering()), std::out_of_range);
+}
+
+TEST(PackedFingeringSequenceTest, CopiesCompareEqual) {
+  PackedFingeringSequence sequence(
+      std::vector<Fingering>{Fingering({Finger::kThumb})});
+  PackedFingeringSequence copy = sequence;
+  EXPECT_EQ(copy, sequence);
+  copy.set(0, PackedFingering(Fingering({Finger::kIndex})));
+  EXPECT_NE(copy, sequence);
+}
+
+}  // namespace
+}  // namespace piano_fingering::domain
@@ -0,0 +1,165 @@
+#include "evaluator/eval_piece.h"
+
+#include <gtest/gtest.h>
+
+#include <vector>
+
+#include "domain/hand.h"
+#include "domain/measure.h"
+#include "domain/metadata.h"
+#include "domain/note.h"
+#include "domain/piece.h"
+#include "domain/pitch.h"
+#include "domain/slice.h"
+
+namespace piano_fingering::evaluator {
+namespace {
+
+using domain::Hand;
+using domain::Measure;
+using domain::Metadata;
+using domain::Note;
+using domain::Piece;
+using domain::Pitch;
+using domain::Slice;
+using domain::TimeSignature;
+
+Note make_note(int pitch_val, int octave) {
+  return Note(Pitch(pitch_val), octave, 480, false, 1, 1);
+}
+
+Note make_rest() { return Note(Pitch(0), 4, 480, true, 1, 1); }
+
+TEST(EvalPieceTest, EmptyHandHasNoSlices) {
+  Piece piece(Metadata("Test", "Composer"), {},
+              {Measure(1, {Slice({make_note(0, 4)})}, TimeSignature(4, 4))});
+
+  EvalPiece compiled(piece, Hand::kLeft);
+
+  EXPECT_EQ(compiled.hand(), Hand::kLeft);
+  EXPECT_EQ(compiled.slice_count(), 0);
+  EXPECT_EQ(compiled.note_count(), 0);
+  EXPECT_TRUE(compiled.empty());
+}
+
+TEST(EvalPieceTest, FlattensPitchesAndBlackKeys) {
+  // C4, C#4 (black), D5
+  Piece piece(Metadata("Test", "Composer"), {},
+              {Measure(1, {Slice({make_note(0, 4)}), Slice({make_note(1, 4)})},
+                       TimeSignature(4, 4)),
+               Measure(2, {Slice({make_note(2, 5)})}, TimeSignature(4, 4))});
+
+  EvalPiece compiled(piece, Hand::kRight);
+
+  ASSERT_EQ(compiled.slice_count(), 3);
+  ASSERT_EQ(compiled.note_count(), 3);
+  EXPECT_EQ(compiled.pitch(0), 56);
+  EXPECT_EQ(compiled.pitch(1), 57);
+  EXPECT_EQ(compiled.pitch(2), 72);
+  EXPECT_FALSE(compiled.is_black(0));
+  EXPECT_TRUE(compiled.is_black(1));
+  EXPECT_FALSE(compiled.is_black(2));
+}
+
+TEST(EvalPieceTest, SkipsRestSlicesAndRecordsSourcePositions) {
+  Piece piece(Metadata("Test", "Composer"), {},
+              {Measure(1,
+                       {Slice({make_note(0, 4)}), Slice({make_rest()}),
+                        Slice({make_note(4, 4)})},
+                       TimeSignature(4, 4)),
+               Measure(2, {Slice({make_rest()}), Slice({make_note(6, 4)})},
+                       TimeSignature(4, 4))});
+
+  EvalPiece compiled(piece, Hand::kRight);
+
+  ASSERT_EQ(compiled.slice_count(), 3);
+  EXPECT_EQ(compiled.measure_index(0), 0);
+  EXPECT_EQ(compiled.slice_index(0), 0);
+  EXPECT_EQ(compiled.measure_index(1), 0);
+  EXPECT_EQ(compiled.slice_index(1), 2);
+  EXPECT_EQ(compiled.measure_index(2), 1);
+  EXPECT_EQ(compiled.slice_index(2), 1);
+  EXPECT_FALSE(compiled.follows_rest(0));
+  EXPECT_TRUE(compiled.follows_rest(1));
+  EXPECT_TRUE(compiled.follows_rest(2));
+}
+
+TEST(EvalPieceTest, ChordOffsetsExcludeRests) {
+  Piece piece(
+      Metadata("Test", "Composer"), {},
+      {Measure(1,
+               {Slice({make_note(0, 4), make_rest(), make_note(8, 4)}),
+                Slice({make_note(2, 4)})},
+               TimeSignature(4, 4))});
+
+  EvalPiece compiled(piece, Hand::kRight);
+
+  ASSERT_EQ(compiled.slice_count(), 2);
+  EXPECT_EQ(compiled.slice_begin(0), 0);
+  EXPECT_EQ(compiled.slice_size(0), 2);
+  EXPECT_EQ(compiled.slice_begin(1), 2);
+  EXPECT_EQ(compiled.slice_size(1), 1);
+  EXPECT_EQ(compiled.slice_offsets().size(), 3);
+}
+
+TEST(EvalPieceTest, SelectsRequestedHand) {
+  Piece piece(Metadata("Test", "Composer"),
+              {Measure(1, {Slice({make_note(0, 3)})}, TimeSignature(4, 4))},
+              {Measure(1, {Slice({make_note(0, 5)}), Slice({make_note(2, 5)})},
+                       TimeSignature(4, 4))});
+
+  EvalPiece left(piece, Hand::kLeft);
+  EvalPiece right(piece, Hand::kRight);
+
+  EXPECT_EQ(left.slice_count(), 1);
+  EXPECT_EQ(left.pitch(0), 42);
+  EXPECT_EQ(right.slice_count(), 2);
+  EXPECT_EQ(right.pitch(0), 70);
+}
+
+TEST(EvalPieceTest, AppendMatchesPieceCompilation) {
+  const std::vector<Slice> slices = {
+      Slice({make_note(0, 4)}), Slice({make_rest()}),
+      Slice({make_note(1, 4), make_note(4, 4)}), Slice({make_note(2, 5)})};
+  Piece piece(Metadata("Test", "Composer"), {},
+              {Measure(1, slices, TimeSignature(4, 4))});
+  const EvalPiece compiled(piece, Hand::kRight);
+
+  EvalPiece streamed(Hand::kRight);
+  for (size_t i = 0; i < slices.size(); ++i) {
+    EXPECT_EQ(streamed.append(slices[i], 0, i), i != 1);
+  }
+  ASSERT_EQ(streamed.slice_count(), compiled.slice_count());
+  for (size_t s = 0; s < compiled.slice_count(); ++s) {
+    EXPECT_EQ(streamed.slice_size(s), compiled.slice_size(s));
+    EXPECT_EQ(streamed.follows_rest(s), compiled.follows_rest(s));
+    EXPECT_EQ(streamed.slice_index(s), compiled.slice_index(s));
+  }
+  for (size_t n = 0; n < compiled.note_count(); ++n) {
+    EXPECT_EQ(streamed.pitch(n), compiled.pitch(n));
+    EXPECT_EQ(streamed.is_black(n), compiled.is_black(n));
+  }
+}
+
+TEST(EvalPieceTest, DropFrontRenumbersSlices) {
+  EvalPiece piece(Hand::kRight);
+  static_cast<void>(piece.append(Slice({make_note(0, 4)}), 0, 0));
+  static_cast<void>(
+      piece.append(Slice({make_note(1, 4), make_note(4, 4)}), 0, 1));
+  static_cast<void>(piece.append(Slice({make_note(2, 5)}), 1, 0));
+
+  piece.drop_front(1);
+  ASSERT_EQ(piece.slice_count(), 2);
+  EXPECT_EQ(piece.slice_begin(0), 0);
+  EXPECT_EQ(piece.slice_size(0), 2);
+  EXPECT_EQ(piece.slice_begin(1), 2);
+  EXPECT_EQ(piece.pitch(0), 57);
+  EXPECT_EQ(piece.measure_index(1), 1);
+
+  piece.drop_front(5);
+  EXPECT_EQ(piece.slice_count(), 0);
+  EXPECT_TRUE(piece.empty());
+}
+
+}  // namespace
+}  // namespace piano_fingering::evaluator
@@ -0,0 +1,180 @@
+#include "evaluator/fingering_population.h"
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <optional>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+#include "config/config.h"
+#include "config/preset.h"
+#include "config/rule_weights.h"
+#include "domain/finger.h"
+#include "domain/hand.h"
+#include "domain/measure.h"
+#include "domain/metadata.h"
+#include "domain/note.h"
+#include "domain/packed_fingering.h"
+#include "domain/piece.h"
+#include "domain/pitch.h"
+#include "domain/slice.h"
+#include "evaluator/eval_piece.h"
+#include "evaluator/score_evaluator.h"
+
+namespace piano_fingering::evaluator {
+namespace {
+
+using config::Config;
+using domain::Finger;
+using domain::Hand;
+using domain::Measure;
+using domain::Metadata;
+using domain::Note;
+using domain::PackedFingering;
+using domain::PackedFingeringSequence;
+using domain::Piece;
+using domain::Pitch;
+using domain::Slice;
+using domain::TimeSignature;
+
+Note make_note(int pitch_val, int octave) {
+  return Note(Pitch(pitch_val), octave, 480, false, 1, 1);
+}
+
+Note make_rest() { return Note(Pitch(0), 4, 480, true, 1, 1); }
+
+Config make_config() {
+  Config config{};
+  config.right_hand = config::make_medium_right_hand();
+  config.left_hand = config::mirror_to_left_hand(config.right_hand);
+  config.weights = config::RuleWeights::defaults();
+  return config;
+}
+
+// Leaps, black keys, repeats, chords and a rest, in both hands
+Piece make_piece() {
+  std::vector<Slice> slices;
+  std::uint32_t seed = 5;
+  auto next = [&seed](std::uint32_t range) {
+    seed = seed * 1103515245U + 12345U;
+    return static_cast<int>((seed >> 16) % range);
+  };
+  for (size_t i = 0; i < 40; ++i) {
+    if (i == 17) {
+      slices.push_back(Slice({make_rest()}));
+    } else if (i % 6 == 5) {
+      slices.push_back(Slice({make_note(next(12), 3), make_note(next(12), 4),
+                              make_note(next(12), 5)}));
+    } else {
+      slices.push_back(Slice({make_note(next(12), 3 + next(3))}));
+    }
+  }
+  std::vector<Measure> hand{Measure(1, std::move(slices), TimeSignature(4, 4))};
+  return Piece(Metadata("Test", "Composer"), hand, hand);
+}
+
+// Any finger on every note, or with `gaps` some notes left unfingered
+PackedFingeringSequence random_fingering(const EvalPiece& piece,
+                                         std::uint32_t seed, bool gaps) {
+  auto next = [&seed](std::uint32_t range) {
+    seed = seed * 1103515245U + 12345U;
+    return (seed >> 16) % range;
+  };
+  PackedFingeringSequence fingerings;
+  for (size_t s = 0; s < piece.slice_count(); ++s) {
+    PackedFingering state;
+    for (size_t k = 0; k < piece.slice_size(s); ++k) {
+      if (!gaps || next(4) != 0) {
+        state.set(k, static_cast<Finger>(next(5) + 1));
+      }
+    }
+    fingerings.push_back(state, piece.slice_size(s));
+  }
+  return fingerings;
+}
+
+void expect_matches_evaluate(const ScoreEvaluator& evaluator,
+                             const EvalPiece& piece, bool gaps) {
+  constexpr size_t kSize = 37;
+  FingeringPopulation population(piece.slice_count(), kSize);
+  std::vector<PackedFingeringSequence> candidates;
+  for (size_t c = 0; c < kSize; ++c) {
+    candidates.push_back(
+        random_fingering(piece, static_cast<std::uint32_t>(c + 1), gaps));
+    population.assign(c, candidates.back());
+  }
+  const std::vector<double> scores =
+      evaluator.evaluate_population(piece, population);
+  ASSERT_EQ(scores.size(), kSize);
+  for (size_t c = 0; c < kSize; ++c) {
+    EXPECT_NEAR(scores[c], evaluator.evaluate(piece, candidates[c]), 1e-9)
+        << "candidate " << c;
+  }
+}
+
+TEST(FingeringPopulationTest, MatchesEvaluatePerCandidate) {
+  const ScoreEvaluator evaluator(make_config());
+  const Piece piece = make_piece();
+  for (Hand hand : {Hand::kRight, Hand::kLeft}) {
+    expect_matches_evaluate(evaluator, EvalPiece(piece, hand), false);
+  }
+}
+
+TEST(FingeringPopulationTest, MatchesEvaluateWithGapsAndDisabledRules) {
+  Config config = make_config();
+  config.weights.values[static_cast<size_t>(
+      config::RuleIndex::kThumbOnBlack)] = 0.0;
+  config.weights.values[static_cast<size_t>(
+      config::RuleIndex::kTripletComfortExceeds)] = 0.0;
+  const Piece piece = make_piece();
+  const EvalPiece compiled(piece, Hand::kRight);
+  expect_matches_evaluate(ScoreEvaluator(make_config()), compiled, true);
+  expect_matches_evaluate(ScoreEvaluator(config), compiled, true);
+}
+
+TEST(FingeringPopulationTest, StoresCandidatesPositionMajor) {
+  const Piece piece = make_piece();
+  const EvalPiece compiled(piece, Hand::kRight);
+  FingeringPopulation population(compiled.slice_count(), 3);
+  EXPECT_EQ(population.size(), 3);
+  EXPECT_EQ(population.slice_count(), compiled.slice_count());
+
+  const PackedFingeringSequence fingering = random_fingering(compiled, 9, false);
+  population.assign(1, fingering);
+  for (size_t s = 0; s < compiled.slice_count(); ++s) {
+    EXPECT_EQ(population.at(s, 1), fingering[s]);
+    EXPECT_EQ(population.slice(s).size(), 3);
+    EXPECT_EQ(population.slice(s)[1], fingering[s]);
+    EXPECT_EQ(population.at(s, 0), PackedFingering());
+  }
+
+  EXPECT_THROW(population.assign(3, fingering), std::out_of_range);
+  EXPECT_THROW(population.assign(0, PackedFingeringSequence()),
+               std::invalid_argument);
+}
+
+TEST(FingeringPopulationTest, UnfingeredAndMismatchedPopulations) {
+  const ScoreEvaluator evaluator(make_config());
+  const Piece piece = make_piece();
+  const EvalPiece compiled(piece, Hand::kRight);
+
+  const FingeringPopulation unfingered(compiled.slice_count(), 2);
+  EXPECT_EQ(evaluator.evaluate_population(compiled, unfingered),
+            (std::vector<double>{0.0, 0.0}));
+  EXPECT_TRUE(
+      evaluator
+          .evaluate_population(compiled,
+                               FingeringPopulation(compiled.slice_count(), 0))
+          .empty());
+  EXPECT_THROW(
+      {
+        [[maybe_unused]] auto scores = evaluator.evaluate_population(
+            compiled, FingeringPopulation(compiled.slice_count() + 1, 2));
+      },
+      std::invalid_argument);
+}
+
+}  // namespace
+}  // namespace piano_fingering::evaluator
@@ -0,0 +1,65 @@
+#include "evaluator/fixed_cost.h"
+
+#include <gtest/gtest.h>
+
+#include "config/config.h"
+#include "config/preset.h"
+#include "config/rule_weights.h"
+#include "evaluator/score_evaluator.h"
+
+namespace piano_fingering::evaluator {
+namespace {
+
+using config::RuleIndex;
+using config::RuleWeights;
+
+void set_weight(RuleWeights& weights, RuleIndex rule, double value) {
+  weights.values[static_cast<size_t>(rule)] = value;
+}
+
+TEST(FixedCostTest, DefaultWeightsNeedHalves) {
+  // Rule 8's 0.5 base is the only fraction
+  EXPECT_EQ(fixed_point_scale(RuleWeights::defaults()), 2);
+
+  RuleWeights whole = RuleWeights::defaults();
+  set_weight(whole, RuleIndex::kThumbOnBlack, 0.0);
+  EXPECT_EQ(fixed_point_scale(whole), 1);
+}
+
+TEST(FixedCostTest, ScaleCoversTheDistanceWeights) {
+  RuleWeights weights = RuleWeights::defaults();
+  set_weight(weights, RuleIndex::kRelaxedDistance, 0.375);
+  EXPECT_EQ(fixed_point_scale(weights), 8);
+
+  // The other rules only switch on and off, so their weights do not matter
+  weights = RuleWeights::defaults();
+  set_weight(weights, RuleIndex::kFourthFingerUsage, 0.3);
+  EXPECT_EQ(fixed_point_scale(weights), 2);
+}
+
+TEST(FixedCostTest, InexactWeightsHaveNoScale) {
+  RuleWeights weights = RuleWeights::defaults();
+  set_weight(weights, RuleIndex::kPracticalDistance, 0.1);
+  EXPECT_FALSE(fixed_point_scale(weights).has_value());
+}
+
+TEST(FixedCostTest, ConversionRoundTrips) {
+  EXPECT_EQ(to_fixed(12.5, 2), 25);
+  EXPECT_EQ(to_fixed(0.0, 8), 0);
+  EXPECT_DOUBLE_EQ(from_fixed(25, 2), 12.5);
+  EXPECT_DOUBLE_EQ(from_fixed(to_fixed(3.375, 8), 8), 3.375);
+}
+
+TEST(FixedCostTest, EvaluatorScaleFollowsTheConfig) {
+  config::Config config{};
+  config.right_hand = config::make_medium_right_hand();
+  config.left_hand = config::mirror_to_left_hand(config.right_hand);
+  config.weights = RuleWeights::defaults();
+  EXPECT_FALSE(ScoreEvaluator(config).fixed_point_scale().has_value());
+
+  config.algorithm.fixed_point_costs = true;
+  EXPECT_EQ(ScoreEvaluator(config).fixed_point_scale(), 2);
+}
+
+}  // namespace
+}  // namespace piano_fingering::evaluator
@@ -0,0 +1,276 @@
+#include "evaluator/incremental_evaluation.h"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cmath>
+#include <optional>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+#include "config/config.h"
+#include "config/preset.h"
+#include "domain/finger.h"
+#include "domain/fingering.h"
+#include "domain/hand.h"
+#include "domain/measure.h"
+#include "domain/metadata.h"
+#include "domain/note.h"
+#include "domain/packed_fingering.h"
+#include "domain/piece.h"
+#include "domain/pitch.h"
+#include "domain/slice.h"
+#include "evaluator/eval_piece.h"
+#include "evaluator/score_evaluator.h"
+
+namespace piano_fingering::evaluator {
+namespace {
+
+using config::Config;
+using domain::Finger;
+using domain::Fingering;
+using domain::Hand;
+using domain::Measure;
+using domain::Metadata;
+using domain::Note;
+using domain::Piece;
+using domain::Pitch;
+using domain::Slice;
+using domain::TimeSignature;
+using Location = ScoreEvaluator::SliceLocation;
+
+Note make_note(int pitch_val, int octave) {
+  return Note(Pitch(pitch_val), octave, 480, false, 1, 1);
+}
+
+Config make_medium_config() {
+  Config config{};
+  config.right_hand = config::make_medium_right_hand();
+  config.left_hand = config::mirror_to_left_hand(config.right_hand);
+  config.weights = config::RuleWeights::defaults();
+  return config;
+}
+
+// Melody with a chord in the middle
+Piece make_piece() {
+  return Piece(
+      Metadata("Test", "Composer"), {},
+      {Measure(1,
+               {Slice({make_note(0, 4)}), Slice({make_note(3, 4)}),
+                Slice({make_note(6, 4), make_note(10, 4)}),
+                Slice({make_note(1, 4)}), Slice({make_note(10, 4)}),
+                Slice({make_note(4, 5)})},
+               TimeSignature(4, 4))});
+}
+
+std::vector<Fingering> make_fingerings() {
+  return {Fingering({Finger::kThumb}),
+          Fingering({Finger::kIndex}),
+          Fingering({Finger::kThumb, Finger::kMiddle}),
+          Fingering({Finger::kIndex}),
+          Fingering({Finger::kRing}),
+          Fingering({Finger::kPinky})};
+}
+
+class IncrementalEvaluationTest : public ::testing::Test {
+ protected:
+  Config config_ = make_medium_config();
+  ScoreEvaluator evaluator_{config_};
+  Piece piece_ = make_piece();
+  EvalPiece compiled_{piece_, Hand::kRight};
+};
+
+TEST_F(IncrementalEvaluationTest, TotalMatchesFullEvaluation) {
+  auto fingerings = make_fingerings();
+  IncrementalEvaluation session(evaluator_, compiled_, fingerings);
+
+  EXPECT_DOUBLE_EQ(session.total(),
+                   evaluator_.evaluate(compiled_, fingerings));
+  EXPECT_EQ(session.slice_count(), 6);
+  EXPECT_EQ(session.finger(2, 1), Finger::kMiddle);
+}
+
+TEST_F(IncrementalEvaluationTest, PackedRoundTrip) {
+  const auto fingerings = make_fingerings();
+  const domain::PackedFingeringSequence packed(fingerings);
+  IncrementalEvaluation session(evaluator_, compiled_, packed);
+
+  EXPECT_DOUBLE_EQ(session.total(), evaluator_.evaluate(compiled_, fingerings));
+  EXPECT_EQ(session.packed(), packed);
+}
+
+TEST_F(IncrementalEvaluationTest, DeltaMatchesFullDifferenceForEveryMove) {
+  auto fingerings = make_fingerings();
+  IncrementalEvaluation session(evaluator_, compiled_, fingerings);
+  const double base = evaluator_.evaluate(compiled_, fingerings);
+
+  for (size_t slice = 0; slice < compiled_.slice_count(); ++slice) {
+    for (size_t note = 0; note < compiled_.slice_size(slice); ++note) {
+      for (Finger finger : domain::all_fingers()) {
+        auto proposed_notes = std::vector<std::optional<Finger>>(
+            fingerings[slice].begin(), fingerings[slice].end());
+        proposed_notes[note] = finger;
+        auto proposed = fingerings;
+        proposed[slice] = Fingering(proposed_notes);
+
+        double delta = session.delta(Location{0, 0, note, slice}, finger);
+        double expected = evaluator_.evaluate(compiled_, proposed) - base;
+        EXPECT_DOUBLE_EQ(delta, expected)
+            << "slice " << slice << " note " << note << " finger " << finger;
+      }
+    }
+  }
+}
+
+TEST_F(IncrementalEvaluationTest, DeltaDoesNotChangeState) {
+  IncrementalEvaluation session(evaluator_, compiled_, make_fingerings());
+  const double before = session.total();
+
+  [[maybe_unused]] double delta =
+      session.delta(Location{0, 0, 0, 1}, Finger::kPinky);
+
+  EXPECT_DOUBLE_EQ(session.total(), before);
+  EXPECT_EQ(session.finger(1, 0), Finger::kIndex);
+}
+
+TEST_F(IncrementalEvaluationTest, ApplyUpdatesTotalAndFingerings) {
+  IncrementalEvaluation session(evaluator_, compiled_, make_fingerings());
+
+  double delta = session.delta(Location{0, 0, 0, 3}, Finger::kMiddle);
+  const double expected_total = session.total() + delta;
+  session.apply();
+
+  EXPECT_DOUBLE_EQ(session.total(), expected_total);
+  EXPECT_EQ(session.finger(3, 0), Finger::kMiddle);
+  EXPECT_DOUBLE_EQ(session.total(),
+                   evaluator_.evaluate(compiled_, session.fingerings()));
+  EXPECT_EQ(session.applied_count(), 1);
+}
+
+TEST_F(IncrementalEvaluationTest, UndoRestoresPreviousState) {
+  auto fingerings = make_fingerings();
+  IncrementalEvaluation session(evaluator_, compiled_, fingerings);
+  const double before = session.total();
+
+  [[maybe_unused]] double first =
+      session.delta(Location{0, 0, 0, 0}, Finger::kIndex);
+  session.apply();
+  [[maybe_unused]] double second =
+      session.delta(Location{0, 0, 1, 2}, Finger::kPinky);
+  session.apply();
+
+  session.undo();
+  EXPECT_EQ(session.finger(2, 1), Finger::kMiddle);
+  EXPECT_EQ(session.finger(0, 0), Finger::kIndex);
+  session.undo();
+  EXPECT_DOUBLE_EQ(session.total(), before);
+  EXPECT_EQ(session.applied_count(), 0);
+
+  auto restored = session.fingerings();
+  ASSERT_EQ(restored.size(), fingerings.size());
+  for (size_t s = 0; s < restored.size(); ++s) {
+    EXPECT_TRUE(std::equal(restored[s].begin(), restored[s].end(),
+                           fingerings[s].begin(), fingerings[s].end()));
+  }
+}
+
+TEST_F(IncrementalEvaluationTest, RandomWalkStaysConsistent) {
+  IncrementalEvaluation session(evaluator_, compiled_, make_fingerings());
+
+  // Deterministic walk over every slice/finger combination
+  for (size_t step = 0; step < 60; ++step) {
+    const size_t slice = (step * 7) % compiled_.slice_count();
+    const size_t note = step % compiled_.slice_size(slice);
+    const Finger finger = domain::all_fingers()[(step * 3) % 5];
+    [[maybe_unused]] double delta =
+        session.delta(Location{0, 0, note, slice}, finger);
+    session.apply();
+    if (step % 4 == 3) {
+      session.undo();
+    }
+  }
+
+  EXPECT_NEAR(session.total(),
+              evaluator_.evaluate(compiled_, session.fingerings()), 1e-9);
+  const double refreshed = session.refresh();
+  EXPECT_DOUBLE_EQ(refreshed,
+                   evaluator_.evaluate(compiled_, session.fingerings()));
+}
+
+TEST_F(IncrementalEvaluationTest, UnfingeredNeighbourFallsBackToFullScore) {
+  auto fingerings = make_fingerings();
+  fingerings[1] = Fingering({std::nullopt});
+  IncrementalEvaluation session(evaluator_, compiled_, fingerings);
+
+  auto proposed = fingerings;
+  proposed[2] = Fingering({Finger::kIndex, Finger::kMiddle});
+  double delta = session.delta(Location{0, 0, 0, 2}, Finger::kIndex);
+
+  EXPECT_DOUBLE_EQ(delta, evaluator_.evaluate(compiled_, proposed) -
+                              evaluator_.evaluate(compiled_, fingerings));
+}
+
+TEST_F(IncrementalEvaluationTest, NeighborhoodMatchesSingleDeltas) {
+  IncrementalEvaluation session(evaluator_, compiled_, make_fingerings());
+
+  Location loc{0, 0, 0, 3};
+  auto deltas = session.neighborhood(loc);
+  for (Finger finger : {Finger::kThumb, Finger::kMiddle, Finger::kRing}) {
+    EXPECT_DOUBLE_EQ(deltas[static_cast<size_t>(domain::to_int(finger) - 1)],
+                     session.delta(loc, finger));
+  }
+  EXPECT_TRUE(std::isinf(deltas[1]));  // current finger
+}
+
+TEST_F(IncrementalEvaluationTest, SessionsShareOneEvaluatorAcrossThreads) {
+  const auto fingerings = make_fingerings();
+  const double expected = evaluator_.evaluate(compiled_, fingerings);
+  constexpr size_t kThreads = 4;
+  std::vector<double> totals(kThreads, 0.0);
+  std::vector<double> walked(kThreads, 0.0);
+
+  std::vector<std::thread> workers;
+  for (size_t t = 0; t < kThreads; ++t) {
+    workers.emplace_back([&, t] {
+      IncrementalEvaluation session(evaluator_, compiled_, fingerings);
+      totals[t] = session.total();
+      for (size_t step = 0; step < 200; ++step) {
+        const size_t slice = (step + t) % compiled_.slice_count();
+        const Finger finger = domain::all_fingers()[(step * 3 + t) % 5];
+        [[maybe_unused]] double delta =
+            session.delta(Location{0, 0, 0, slice}, finger);
+        session.apply();
+      }
+      walked[t] = session.total() -
+                  evaluator_.evaluate(compiled_, session.fingerings());
+    });
+  }
+  for (auto& worker : workers) {
+    worker.join();
+  }
+
+  for (size_t t = 0; t < kThreads; ++t) {
+    EXPECT_DOUBLE_EQ(totals[t], expected);
+    EXPECT_NEAR(walked[t], 0.0, 1e-9);
+  }
+}
+
+TEST_F(IncrementalEvaluationTest, InvalidUseThrows) {
+  IncrementalEvaluation session(evaluator_, compiled_, make_fingerings());
+
+  EXPECT_THROW(session.apply(), std::logic_error);
+  EXPECT_THROW(session.undo(), std::logic_error);
+  // Slice past the end, and a second note in a single-note slice
+  Location past_end{0, 0, 0, 6};
+  Location past_chord{0, 0, 1, 0};
+  EXPECT_THROW(
+      { [[maybe_unused]] auto d = session.delta(past_end, Finger::kThumb); },
+      std::out_of_range);
+  EXPECT_THROW(
+      { [[maybe_unused]] auto d = session.delta(past_chord, Finger::kThumb); },
+      std::out_of_range);
+}
+
+}  // namespace
+}  // namespace piano_fingering::evaluator
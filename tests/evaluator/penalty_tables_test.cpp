@@ -0,0 +1,115 @@
+#include "evaluator/penalty_tables.h"
+
+#include <gtest/gtest.h>
+
+#include "config/config.h"
+#include "config/preset.h"
+#include "config/rule_weights.h"
+#include "domain/finger.h"
+#include "domain/hand.h"
+#include "evaluator/rules.h"
+
+namespace piano_fingering::evaluator {
+namespace {
+
+using config::Config;
+using domain::Finger;
+using domain::Hand;
+
+Config make_medium_config() {
+  Config config{};
+  config.right_hand = config::make_medium_right_hand();
+  config.left_hand = config::mirror_to_left_hand(config.right_hand);
+  config.weights = config::RuleWeights::defaults();
+  return config;
+}
+
+// Distances well outside the tabulated range exercise the fallback path
+constexpr int kTestMinDistance = -45;
+constexpr int kTestMaxDistance = 45;
+
+TEST(PenaltyTablesTest, DistancePenaltyMatchesCascadingRule) {
+  Config config = make_medium_config();
+  PenaltyTables tables(config);
+
+  for (Hand hand : {Hand::kLeft, Hand::kRight}) {
+    const auto& table = tables.for_hand(hand);
+    const auto& matrix =
+        (hand == Hand::kLeft) ? config.left_hand : config.right_hand;
+    for (Finger f1 : domain::all_fingers()) {
+      for (Finger f2 : domain::all_fingers()) {
+        const auto& d = matrix.get_pair(finger_pair_from(f1, f2));
+        for (int dist = kTestMinDistance; dist <= kTestMaxDistance; ++dist) {
+          EXPECT_DOUBLE_EQ(table.distance_penalty(f1, f2, dist),
+                           apply_cascading_penalty(d, dist, config.weights));
+          EXPECT_DOUBLE_EQ(table.chord_penalty(f1, f2, dist),
+                           apply_chord_penalty(d, dist, config.weights));
+          EXPECT_DOUBLE_EQ(table.rule_4(f1, f2, dist), apply_rule_4(d, dist));
+        }
+      }
+    }
+  }
+}
+
+TEST(PenaltyTablesTest, Rule3MatchesRuleFunction) {
+  Config config = make_medium_config();
+  PenaltyTables tables(config);
+  const auto& table = tables.for_hand(Hand::kRight);
+
+  for (Finger f1 : domain::all_fingers()) {
+    for (Finger f2 : domain::all_fingers()) {
+      for (Finger f3 : {Finger::kThumb, Finger::kRing}) {
+        const auto& d = config.right_hand.get_pair(finger_pair_from(f1, f2));
+        for (int p2 = -30; p2 <= 30; p2 += 5) {
+          for (int p3 = kTestMinDistance; p3 <= kTestMaxDistance; ++p3) {
+            TripletContext triplet{0, p2, p3, f1, f2, f3};
+            EXPECT_DOUBLE_EQ(table.rule_3(triplet), apply_rule_3(d, triplet));
+          }
+        }
+      }
+    }
+  }
+}
+
+TEST(PenaltyTablesTest, UsesConfiguredWeights) {
+  Config config = make_medium_config();
+  config.weights.values[static_cast<size_t>(
+      config::RuleIndex::kRelaxedDistance)] = 3.0;
+  PenaltyTables tables(config);
+
+  // Medium 1-2: max_rel = 5, so distance 6 violates Rule 2 by one unit
+  EXPECT_DOUBLE_EQ(
+      tables.for_hand(Hand::kRight).distance_penalty(Finger::kThumb,
+                                                     Finger::kIndex, 6),
+      3.0);
+}
+
+TEST(PenaltyTablesTest, SharedTablesAreReusedForEqualPenalties) {
+  const Config config = make_medium_config();
+  Config search = config;
+  search.algorithm.beam_width += 1;
+  const auto tables = shared_penalty_tables(config);
+  EXPECT_EQ(shared_penalty_tables(config), tables);
+  EXPECT_EQ(shared_penalty_tables(search), tables);
+  EXPECT_GE(shared_penalty_table_count(), 1U);
+
+  Config weights = config;
+  weights.weights.values[0] += 1.0;
+  EXPECT_NE(shared_penalty_tables(weights), tables);
+}
+
+TEST(PenaltyTablesTest, HandsUseTheirOwnMatrix) {
+  Config config = make_medium_config();
+  PenaltyTables tables(config);
+
+  // Right hand 1-2 upward by 3 is relaxed; mirrored left hand is not
+  EXPECT_DOUBLE_EQ(tables.for_hand(Hand::kRight)
+                       .distance_penalty(Finger::kThumb, Finger::kIndex, 3),
+                   0.0);
+  EXPECT_GT(tables.for_hand(Hand::kLeft)
+                .distance_penalty(Finger::kThumb, Finger::kIndex, 3),
+            0.0);
+}
+
+}  // namespace
+}  // namespace piano_fingering::evaluator
@@ -0,0 +1,177 @@
+#include "evaluator/rule_features.h"
+
+#include <gtest/gtest.h>
+
+#include <vector>
+
+#include "config/config.h"
+#include "config/preset.h"
+#include "config/rule_weights.h"
+#include "domain/finger.h"
+#include "domain/fingering.h"
+#include "domain/hand.h"
+#include "domain/measure.h"
+#include "domain/metadata.h"
+#include "domain/note.h"
+#include "domain/packed_fingering.h"
+#include "domain/piece.h"
+#include "domain/pitch.h"
+#include "domain/slice.h"
+#include "evaluator/eval_piece.h"
+#include "evaluator/rule_stats.h"
+#include "evaluator/score_evaluator.h"
+
+namespace piano_fingering::evaluator {
+namespace {
+
+using config::Config;
+using config::RuleIndex;
+using config::RuleWeights;
+using domain::Finger;
+using domain::Fingering;
+using domain::Hand;
+using domain::Measure;
+using domain::Metadata;
+using domain::Note;
+using domain::Piece;
+using domain::Pitch;
+using domain::Slice;
+using domain::TimeSignature;
+
+Note make_note(int pitch_val, int octave) {
+  return Note(Pitch(pitch_val), octave, 480, false, 1, 1);
+}
+
+Config make_config(const RuleWeights& weights) {
+  Config config{};
+  config.right_hand = config::make_medium_right_hand();
+  config.left_hand = config::mirror_to_left_hand(config.right_hand);
+  config.weights = weights;
+  return config;
+}
+
+// Wide leaps, black keys, repeated pitches and chords, so every rule fires
+Piece make_piece() {
+  return Piece(
+      Metadata("Test", "Composer"), {},
+      {Measure(1,
+               {Slice({make_note(0, 4)}), Slice({make_note(1, 5)}),
+                Slice({make_note(6, 4), make_note(10, 5)}),
+                Slice({make_note(3, 4)}), Slice({make_note(0, 6)})},
+               TimeSignature(4, 4)),
+       Measure(2,
+               {Slice({make_note(8, 4)}), Slice({make_note(8, 4)}),
+                Slice({make_note(0, 4), make_note(2, 4), make_note(4, 4)}),
+                Slice({make_note(5, 4)}), Slice({make_note(10, 4)})},
+               TimeSignature(4, 4))});
+}
+
+std::vector<Fingering> make_fingerings() {
+  return {Fingering({Finger::kMiddle}),
+          Fingering({Finger::kThumb}),
+          Fingering({Finger::kRing, Finger::kPinky}),
+          Fingering({Finger::kRing}),
+          Fingering({Finger::kThumb}),
+          Fingering({Finger::kPinky}),
+          Fingering({Finger::kThumb}),
+          Fingering({Finger::kThumb, Finger::kIndex, Finger::kMiddle}),
+          Fingering({Finger::kMiddle}),
+          Fingering({Finger::kRing})};
+}
+
+void set_weight(RuleWeights& weights, RuleIndex rule, double value) {
+  weights.values[static_cast<size_t>(rule)] = value;
+}
+
+// A weight set with every kind of entry: scaled, unit, and disabled
+RuleWeights mixed_weights() {
+  RuleWeights weights = RuleWeights::defaults();
+  set_weight(weights, RuleIndex::kComfortDistance, 0.75);
+  set_weight(weights, RuleIndex::kRelaxedDistance, 3.0);
+  set_weight(weights, RuleIndex::kPracticalDistance, 4.5);
+  set_weight(weights, RuleIndex::kThumbOnBlack, 0.0);
+  set_weight(weights, RuleIndex::kThumbBlackCrossedByWhite, 0.0);
+  return weights;
+}
+
+class RuleFeaturesTest : public ::testing::Test {
+ protected:
+  Piece piece_ = make_piece();
+  EvalPiece compiled_{piece_, Hand::kRight};
+  RuleFeatureExtractor extractor_{make_config(RuleWeights::defaults())};
+};
+
+TEST_F(RuleFeaturesTest, ScoreMatchesEvaluateUnderDefaultWeights) {
+  const RuleFeatures features =
+      extractor_.extract(compiled_, make_fingerings());
+  const ScoreEvaluator evaluator(make_config(RuleWeights::defaults()));
+  EXPECT_NEAR(features.score(RuleWeights::defaults()),
+              evaluator.evaluate(compiled_, make_fingerings()), 1e-9);
+}
+
+TEST_F(RuleFeaturesTest, ScoreMatchesEvaluateUnderOtherWeights) {
+  const RuleFeatures features =
+      extractor_.extract(compiled_, make_fingerings());
+
+  RuleWeights no_chords = RuleWeights::defaults();
+  set_weight(no_chords, RuleIndex::kChordDistanceDoubled, 0.0);
+  RuleWeights no_distances = RuleWeights::defaults();
+  set_weight(no_distances, RuleIndex::kComfortDistance, 0.0);
+  set_weight(no_distances, RuleIndex::kRelaxedDistance, 0.0);
+  set_weight(no_distances, RuleIndex::kPracticalDistance, 0.0);
+
+  for (const RuleWeights& weights :
+       {mixed_weights(), no_chords, no_distances, RuleWeights{}}) {
+    const ScoreEvaluator evaluator(make_config(weights));
+    EXPECT_NEAR(features.score(weights),
+                evaluator.evaluate(compiled_, make_fingerings()), 1e-9);
+  }
+}
+
+TEST_F(RuleFeaturesTest, IgnoresTheConfigWeights) {
+  const RuleFeatureExtractor other(make_config(mixed_weights()));
+  const RuleFeatures a = extractor_.extract(compiled_, make_fingerings());
+  const RuleFeatures b = other.extract(compiled_, make_fingerings());
+  EXPECT_EQ(a.values, b.values);
+  EXPECT_DOUBLE_EQ(a.chord.comfort, b.chord.comfort);
+  EXPECT_DOUBLE_EQ(a.chord.relaxed, b.chord.relaxed);
+  EXPECT_DOUBLE_EQ(a.chord.practical, b.chord.practical);
+}
+
+TEST_F(RuleFeaturesTest, ValuesAreUnitWeightRuleStats) {
+  const RuleFeatures features =
+      extractor_.extract(compiled_, make_fingerings());
+  RuleWeights unit;
+  unit.values.fill(1.0);
+  const ScoreEvaluator evaluator(make_config(unit));
+  RuleStats stats;
+  static_cast<void>(evaluator.evaluate(compiled_, make_fingerings(), stats));
+  for (size_t i = 0; i < config::kRuleCount; ++i) {
+    EXPECT_NEAR(features.values[i], stats.penalty[i], 1e-9) << "rule " << i + 1;
+  }
+  EXPECT_NEAR(features.value_of(RuleIndex::kChordDistanceDoubled),
+              features.chord.comfort + features.chord.relaxed +
+                  features.chord.practical,
+              1e-9);
+}
+
+TEST_F(RuleFeaturesTest, PackedAndUnpackedAgree) {
+  const std::vector<Fingering> fingerings = make_fingerings();
+  const domain::PackedFingeringSequence packed(fingerings);
+  const RuleFeatures a = extractor_.extract(compiled_, fingerings);
+  const RuleFeatures b = extractor_.extract(compiled_, packed);
+  EXPECT_EQ(a.values, b.values);
+  EXPECT_DOUBLE_EQ(a.score(mixed_weights()), b.score(mixed_weights()));
+}
+
+TEST_F(RuleFeaturesTest, SumsAcrossHands) {
+  const RuleFeatures right = extractor_.extract(compiled_, make_fingerings());
+  RuleFeatures total;
+  total += right;
+  total += right;
+  EXPECT_NEAR(total.score(mixed_weights()), 2.0 * right.score(mixed_weights()),
+              1e-9);
+}
+
+}  // namespace
+}  // namespace piano_fingering::evaluator
@@ -0,0 +1,193 @@
+#include "evaluator/rule_stats.h"
+
+#include <gtest/gtest.h>
+
+#include <vector>
+
+#include "config/config.h"
+#include "config/preset.h"
+#include "config/rule_weights.h"
+#include "domain/finger.h"
+#include "domain/fingering.h"
+#include "domain/hand.h"
+#include "domain/measure.h"
+#include "domain/metadata.h"
+#include "domain/note.h"
+#include "domain/piece.h"
+#include "domain/pitch.h"
+#include "domain/slice.h"
+#include "evaluator/eval_piece.h"
+#include "evaluator/score_evaluator.h"
+
+namespace piano_fingering::evaluator {
+namespace {
+
+using config::Config;
+using config::RuleIndex;
+using domain::Finger;
+using domain::Fingering;
+using domain::Hand;
+using domain::Measure;
+using domain::Metadata;
+using domain::Note;
+using domain::Piece;
+using domain::Pitch;
+using domain::Slice;
+using domain::TimeSignature;
+
+Note make_note(int pitch_val, int octave) {
+  return Note(Pitch(pitch_val), octave, 480, false, 1, 1);
+}
+
+Config make_medium_config() {
+  Config config{};
+  config.right_hand = config::make_medium_right_hand();
+  config.left_hand = config::mirror_to_left_hand(config.right_hand);
+  config.weights = config::RuleWeights::defaults();
+  return config;
+}
+
+// Wide leaps, a black-key thumb and a chord, so most rules fire
+Piece make_piece() {
+  return Piece(Metadata("Test", "Composer"), {},
+               {Measure(1,
+                        {Slice({make_note(0, 4)}), Slice({make_note(1, 5)}),
+                         Slice({make_note(6, 4), make_note(10, 4)}),
+                         Slice({make_note(3, 4)}), Slice({make_note(0, 6)})},
+                        TimeSignature(4, 4))});
+}
+
+std::vector<Fingering> make_fingerings() {
+  return {Fingering({Finger::kMiddle}), Fingering({Finger::kThumb}),
+          Fingering({Finger::kRing, Finger::kPinky}),
+          Fingering({Finger::kRing}), Fingering({Finger::kThumb})};
+}
+
+class RuleStatsTest : public ::testing::Test {
+ protected:
+  Config config_ = make_medium_config();
+  ScoreEvaluator evaluator_{config_};
+  Piece piece_ = make_piece();
+  EvalPiece compiled_{piece_, Hand::kRight};
+};
+
+TEST_F(RuleStatsTest, InstrumentedEvaluateMatchesProduction) {
+  RuleStats stats;
+  double score = evaluator_.evaluate(compiled_, make_fingerings(), stats);
+
+  EXPECT_DOUBLE_EQ(score, evaluator_.evaluate(compiled_, make_fingerings()));
+  EXPECT_NEAR(stats.total_penalty(), score, 1e-9);
+}
+
+TEST_F(RuleStatsTest, CountsInvocationsPerRule) {
+  RuleStats stats;
+  [[maybe_unused]] double score =
+      evaluator_.evaluate(compiled_, make_fingerings(), stats);
+
+  // Six fingered notes, four sequential pairs, three triplets, one chord pair
+  EXPECT_EQ(stats.invocations_of(RuleIndex::kFourthFingerUsage), 6);
+  EXPECT_EQ(stats.invocations_of(RuleIndex::kThirdFourthConsecutive), 4);
+  EXPECT_EQ(stats.invocations_of(RuleIndex::kFifthOnBlack), 8);
+  EXPECT_EQ(stats.invocations_of(RuleIndex::kRelaxedDistance), 4);
+  EXPECT_EQ(stats.invocations_of(RuleIndex::kHandPositionChange), 3);
+  EXPECT_EQ(stats.invocations_of(RuleIndex::kChordDistanceDoubled), 1);
+
+  // Two ring-finger notes
+  EXPECT_EQ(stats.triggered_of(RuleIndex::kFourthFingerUsage), 2);
+  EXPECT_DOUBLE_EQ(stats.penalty_of(RuleIndex::kFourthFingerUsage), 2.0);
+  EXPECT_GT(stats.penalty_of(RuleIndex::kPracticalDistance), 0.0);
+  EXPECT_GT(stats.penalty_of(RuleIndex::kThumbOnBlack), 0.0);
+}
+
+TEST_F(RuleStatsTest, InstrumentedDeltaRecordsSignedBreakdown) {
+  const auto current = make_fingerings();
+  auto proposed = current;
+  proposed[3] = Fingering({Finger::kIndex});
+  ScoreEvaluator::SliceLocation loc{0, 3, 0, 3};
+
+  RuleStats stats;
+  double delta =
+      evaluator_.evaluate_delta(compiled_, current, proposed, loc, stats);
+
+  double expected =
+      evaluator_.evaluate_delta(compiled_, current, proposed, loc);
+  EXPECT_DOUBLE_EQ(delta, expected);
+  EXPECT_NEAR(stats.total_penalty(), delta, 1e-9);
+  // Ring finger replaced by index finger removes one Rule 5 penalty
+  EXPECT_DOUBLE_EQ(stats.penalty_of(RuleIndex::kFourthFingerUsage), -1.0);
+  EXPECT_EQ(stats.delta_local, 1);
+  EXPECT_EQ(stats.delta_fallback, 0);
+}
+
+TEST_F(RuleStatsTest, CountsDeltaFallbacks) {
+  auto current = make_fingerings();
+  // Unfingered chord next to the change misaligns the sequential window
+  current[2] = Fingering({std::nullopt, std::nullopt});
+  auto proposed = current;
+  proposed[1] = Fingering({Finger::kIndex});
+  ScoreEvaluator::SliceLocation loc{0, 1, 0, 1};
+
+  RuleStats stats;
+  double delta =
+      evaluator_.evaluate_delta(compiled_, current, proposed, loc, stats);
+
+  double expected =
+      evaluator_.evaluate_delta(compiled_, current, proposed, loc);
+  EXPECT_DOUBLE_EQ(delta, expected);
+  EXPECT_NEAR(stats.total_penalty(), delta, 1e-9);
+  EXPECT_EQ(stats.delta_local, 0);
+  EXPECT_EQ(stats.delta_fallback, 1);
+}
+
+TEST_F(RuleStatsTest, ZeroWeightRulesAreSkipped) {
+  Config sparse = config_;
+  for (RuleIndex rule :
+       {RuleIndex::kThirdWhiteFourthBlack, RuleIndex::kThumbOnBlack,
+        RuleIndex::kThumbCrossingSameLevel, RuleIndex::kFourthFingerUsage}) {
+    sparse.weights.values[static_cast<size_t>(rule)] = 0.0;
+  }
+  const ScoreEvaluator evaluator(sparse);
+
+  RuleStats full;
+  double full_score = evaluator_.evaluate(compiled_, make_fingerings(), full);
+  RuleStats stats;
+  double score = evaluator.evaluate(compiled_, make_fingerings(), stats);
+
+  EXPECT_NEAR(score,
+              full_score - full.penalty_of(RuleIndex::kThirdWhiteFourthBlack) -
+                  full.penalty_of(RuleIndex::kThumbOnBlack) -
+                  full.penalty_of(RuleIndex::kThumbCrossingSameLevel) -
+                  full.penalty_of(RuleIndex::kFourthFingerUsage),
+              1e-9);
+  EXPECT_EQ(stats.invocations_of(RuleIndex::kThumbOnBlack), 0);
+  EXPECT_EQ(stats.invocations_of(RuleIndex::kFourthFingerUsage), 0);
+  EXPECT_EQ(stats.invocations_of(RuleIndex::kFifthOnBlack), 8);
+
+  // Delta evaluation runs on the same reduced rule set
+  const auto current = make_fingerings();
+  auto proposed = current;
+  proposed[1] = Fingering({Finger::kIndex});
+  ScoreEvaluator::SliceLocation loc{0, 1, 0, 1};
+  EXPECT_NEAR(evaluator.evaluate_delta(compiled_, current, proposed, loc),
+              evaluator.evaluate(compiled_, proposed) - score, 1e-9);
+}
+
+TEST(RuleStatsMergeTest, PlusEqualsAddsEveryCounter) {
+  RuleStats a;
+  a.penalty[0] = 1.5;
+  a.invocations[0] = 2;
+  a.triggered[0] = 1;
+  a.delta_local = 3;
+  RuleStats b = a;
+  b.delta_fallback = 4;
+
+  a += b;
+  EXPECT_DOUBLE_EQ(a.penalty_of(RuleIndex::kComfortDistance), 3.0);
+  EXPECT_EQ(a.invocations_of(RuleIndex::kComfortDistance), 4);
+  EXPECT_EQ(a.triggered_of(RuleIndex::kComfortDistance), 2);
+  EXPECT_EQ(a.delta_local, 6);
+  EXPECT_EQ(a.delta_fallback, 4);
+}
+
+}  // namespace
+}  // namespace piano_fingering::evaluator
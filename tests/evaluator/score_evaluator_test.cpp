@@ -2,6 +2,13 @@
 
 #include <gtest/gtest.h>
 
+#include <algorithm>
+#include <cmath>
+#include <optional>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
 #include "config/config.h"
 #include "config/preset.h"
 #include "domain/finger.h"
@@ -10,9 +17,12 @@
 #include "domain/measure.h"
 #include "domain/metadata.h"
 #include "domain/note.h"
+#include "domain/packed_fingering.h"
 #include "domain/piece.h"
 #include "domain/pitch.h"
 #include "domain/slice.h"
+#include "evaluator/eval_piece.h"
+#include "evaluator/rule_stats.h"
 
 namespace piano_fingering::evaluator {
 namespace {
@@ -87,6 +97,27 @@ TEST(ScoreEvaluatorTest, EvaluateTwoNotesAppliesRules) {
   EXPECT_GT(score, 0.0);
 }
 
+TEST(ScoreEvaluatorTest, ReplicaOwnsItsTablesAndScoresTheSame) {
+  Config config{};
+  config.right_hand = config::make_medium_right_hand();
+  config.weights = config::RuleWeights::defaults();
+  const ScoreEvaluator evaluator(config);
+  const ScoreEvaluator replica = evaluator.replicate();
+  EXPECT_NE(&replica.tables(), &evaluator.tables());
+  EXPECT_EQ(&ScoreEvaluator(config).tables(), &evaluator.tables());
+
+  Piece piece(Metadata("Test", "Composer"), {},
+              {Measure(1,
+                       {Slice({make_note(0, 4)}), Slice({make_note(4, 5)}),
+                        Slice({make_note(1, 4)})},
+                       TimeSignature(4, 4))});
+  const std::vector<Fingering> fingerings = {Fingering({Finger::kThumb}),
+                                             Fingering({Finger::kIndex}),
+                                             Fingering({Finger::kThumb})};
+  EXPECT_EQ(replica.evaluate(piece, fingerings, Hand::kRight),
+            evaluator.evaluate(piece, fingerings, Hand::kRight));
+}
+
 TEST(ScoreEvaluatorTest, EvaluateSkipsRests) {
   Config config{};
   config.right_hand = config::make_medium_right_hand();
@@ -324,5 +355,307 @@ TEST(ScoreEvaluatorTest, EvaluateDeltaWithChordChange) {
   EXPECT_DOUBLE_EQ(delta, new_score - old_score);
 }
 
+TEST(ScoreEvaluatorTest, CompiledPieceMatchesPieceOverload) {
+  Config config{};
+  config.right_hand = config::make_medium_right_hand();
+  config.weights = config::RuleWeights::defaults();
+  ScoreEvaluator evaluator(config);
+
+  Piece piece(Metadata("Test", "Composer"), {},
+              {Measure(1,
+                       {Slice({make_note(0, 4), make_note(8, 4)}),
+                        Slice({make_rest()}), Slice({make_note(1, 4)}),
+                        Slice({make_note(12, 4)})},
+                       TimeSignature(4, 4)),
+               Measure(2, {Slice({make_note(0, 5)}), Slice({make_note(3, 5)})},
+                       TimeSignature(4, 4))});
+
+  std::vector<Fingering> fingerings = {
+      Fingering({Finger::kThumb, Finger::kPinky}), Fingering({Finger::kIndex}),
+      Fingering({Finger::kRing}), Fingering({Finger::kThumb}),
+      Fingering({Finger::kMiddle})};
+
+  EvalPiece compiled(piece, Hand::kRight);
+  EXPECT_DOUBLE_EQ(evaluator.evaluate(compiled, fingerings),
+                   evaluator.evaluate(piece, fingerings, Hand::kRight));
+}
+
+TEST(ScoreEvaluatorTest, CompiledDeltaMatchesFullDifference) {
+  Config config{};
+  config.right_hand = config::make_medium_right_hand();
+  config.weights = config::RuleWeights::defaults();
+  ScoreEvaluator evaluator(config);
+
+  Piece piece(Metadata("Test", "Composer"), {},
+              {Measure(1,
+                       {Slice({make_note(0, 4)}), Slice({make_note(3, 4)}),
+                        Slice({make_note(6, 4)}), Slice({make_note(1, 4)}),
+                        Slice({make_note(10, 4)})},
+                       TimeSignature(4, 4))});
+  EvalPiece compiled(piece, Hand::kRight);
+
+  std::vector<Fingering> current = {
+      Fingering({Finger::kThumb}), Fingering({Finger::kIndex}),
+      Fingering({Finger::kMiddle}), Fingering({Finger::kIndex}),
+      Fingering({Finger::kRing})};
+
+  for (size_t idx = 0; idx < current.size(); ++idx) {
+    for (Finger finger : domain::all_fingers()) {
+      std::vector<Fingering> proposed = current;
+      proposed[idx] = Fingering({finger});
+      ScoreEvaluator::SliceLocation loc{0, idx, 0, idx};
+      double delta =
+          evaluator.evaluate_delta(compiled, current, proposed, loc);
+      EXPECT_DOUBLE_EQ(delta, evaluator.evaluate(compiled, proposed) -
+                                  evaluator.evaluate(compiled, current))
+          << "slice " << idx << " finger " << finger;
+    }
+  }
+}
+
+TEST(ScoreEvaluatorTest, EvaluateDeltaWithUnfingeredNeighbourFallsBack) {
+  Config config{};
+  config.right_hand = config::make_medium_right_hand();
+  config.weights = config::RuleWeights::defaults();
+  ScoreEvaluator evaluator(config);
+
+  Piece piece(Metadata("Test", "Composer"), {},
+              {Measure(1,
+                       {Slice({make_note(0, 4)}), Slice({make_note(2, 4)}),
+                        Slice({make_note(4, 4)})},
+                       TimeSignature(4, 4))});
+
+  // Middle slice has no finger: sequential neighbours of slice 2 shift
+  std::vector<Fingering> current = {Fingering({Finger::kThumb}),
+                                    Fingering({std::nullopt}),
+                                    Fingering({Finger::kMiddle})};
+  std::vector<Fingering> proposed = {Fingering({Finger::kThumb}),
+                                     Fingering({std::nullopt}),
+                                     Fingering({Finger::kPinky})};
+
+  ScoreEvaluator::SliceLocation changed_loc{0, 2, 0, 2};
+  double delta = evaluator.evaluate_delta(piece, current, proposed, changed_loc,
+                                          Hand::kRight);
+  double old_score = evaluator.evaluate(piece, current, Hand::kRight);
+  double new_score = evaluator.evaluate(piece, proposed, Hand::kRight);
+
+  EXPECT_DOUBLE_EQ(delta, new_score - old_score);
+}
+
+TEST(ScoreEvaluatorTest, PackedSequenceMatchesFingerings) {
+  Config config{};
+  config.right_hand = config::make_medium_right_hand();
+  config.weights = config::RuleWeights::defaults();
+  ScoreEvaluator evaluator(config);
+
+  Piece piece(Metadata("Test", "Composer"), {},
+              {Measure(1,
+                       {Slice({make_note(0, 4), make_note(8, 4)}),
+                        Slice({make_rest()}), Slice({make_note(3, 4)}),
+                        Slice({make_note(0, 5)})},
+                       TimeSignature(4, 4))});
+  EvalPiece compiled(piece, Hand::kRight);
+  std::vector<Fingering> fingerings = {
+      Fingering({Finger::kThumb, Finger::kMiddle}), Fingering({std::nullopt}),
+      Fingering({Finger::kPinky})};
+
+  EXPECT_DOUBLE_EQ(
+      evaluator.evaluate(compiled, domain::PackedFingeringSequence(fingerings)),
+      evaluator.evaluate(compiled, fingerings));
+}
+
+// Chord slice between melody notes, with one unfingered chord note
+Piece make_neighborhood_piece() {
+  return Piece(
+      Metadata("Test", "Composer"), {},
+      {Measure(1,
+               {Slice({make_note(0, 4)}), Slice({make_note(3, 4)}),
+                Slice({make_note(6, 4), make_note(10, 4), make_note(2, 5)}),
+                Slice({make_note(1, 4)}), Slice({make_note(10, 4)})},
+               TimeSignature(4, 4))});
+}
+
+TEST(ScoreEvaluatorTest, NeighborhoodMatchesDeltaForEveryFinger) {
+  Config config{};
+  config.right_hand = config::make_medium_right_hand();
+  config.weights = config::RuleWeights::defaults();
+  ScoreEvaluator evaluator(config);
+  Piece piece = make_neighborhood_piece();
+  EvalPiece compiled(piece, Hand::kRight);
+
+  std::vector<Fingering> current = {
+      Fingering({Finger::kThumb}), Fingering({Finger::kIndex}),
+      Fingering({Finger::kThumb, std::nullopt, Finger::kPinky}),
+      Fingering({Finger::kIndex}), Fingering({Finger::kRing})};
+  const double base = evaluator.evaluate(compiled, current);
+
+  for (size_t slice = 0; slice < current.size(); ++slice) {
+    for (size_t note = 0; note < compiled.slice_size(slice); ++note) {
+      ScoreEvaluator::SliceLocation loc{0, slice, note, slice};
+      auto deltas = evaluator.evaluate_neighborhood(compiled, current, loc);
+      for (Finger finger : domain::all_fingers()) {
+        double delta = deltas[static_cast<size_t>(domain::to_int(finger) - 1)];
+        bool used = std::any_of(current[slice].begin(), current[slice].end(),
+                                [&](const auto& f) { return f == finger; });
+        if (used) {
+          EXPECT_TRUE(std::isinf(delta));
+          continue;
+        }
+        std::vector<std::optional<Finger>> notes(current[slice].begin(),
+                                                 current[slice].end());
+        notes[note] = finger;
+        auto proposed = current;
+        proposed[slice] = Fingering(notes);
+        EXPECT_DOUBLE_EQ(delta, evaluator.evaluate(compiled, proposed) - base)
+            << "slice " << slice << " note " << note << " finger " << finger;
+      }
+    }
+  }
+}
+
+TEST(ScoreEvaluatorTest, NeighborhoodRangeCoversEveryNote) {
+  Config config{};
+  config.right_hand = config::make_medium_right_hand();
+  ScoreEvaluator evaluator(config);
+  Piece piece = make_neighborhood_piece();
+  EvalPiece compiled(piece, Hand::kRight);
+
+  std::vector<Fingering> current = {
+      Fingering({Finger::kThumb}), Fingering({Finger::kIndex}),
+      Fingering({Finger::kThumb, Finger::kMiddle, Finger::kPinky}),
+      Fingering({Finger::kIndex}), Fingering({Finger::kRing})};
+
+  auto range = evaluator.evaluate_neighborhood(compiled, current, 1, 100);
+  ASSERT_EQ(range.size(), compiled.note_count() - 1);
+  ScoreEvaluator::SliceLocation loc{0, 2, 1, 2};
+  EXPECT_EQ(range[2], evaluator.evaluate_neighborhood(compiled, current, loc));
+  EXPECT_TRUE(evaluator.evaluate_neighborhood(compiled, current, 3, 3).empty());
+}
+
+TEST(ScoreEvaluatorTest, NeighborhoodOutOfRangeThrows) {
+  Config config{};
+  ScoreEvaluator evaluator(config);
+  Piece piece = make_neighborhood_piece();
+  EvalPiece compiled(piece, Hand::kRight);
+  std::vector<Fingering> current = {Fingering({Finger::kThumb})};
+
+  ScoreEvaluator::SliceLocation past_end{0, 1, 0, 1};
+  EXPECT_THROW(
+      {
+        [[maybe_unused]] auto deltas =
+            evaluator.evaluate_neighborhood(compiled, current, past_end);
+      },
+      std::out_of_range);
+}
+
+// Long pseudo-random melody with chords and unfingered slices; the same
+// slices in both hands
+struct RandomPiece {
+  Piece piece;
+  std::vector<Fingering> fingerings;
+};
+
+RandomPiece make_random_piece() {
+  std::vector<Slice> slices;
+  std::vector<Fingering> fingerings;
+  unsigned state = 12345;
+  auto next = [&state](unsigned bound) {
+    state = state * 1103515245U + 12345U;
+    return static_cast<int>((state >> 16U) % bound);
+  };
+  for (int s = 0; s < 300; ++s) {
+    // Small pitch pool so repeated pitches and black keys are common
+    const int pitch = next(14);
+    const int octave = 4 + next(2);
+    const auto f1 = static_cast<Finger>(1 + next(5));
+    const auto f2 = static_cast<Finger>(1 + (domain::to_int(f1) + 1) % 5);
+    if (s % 11 == 5) {
+      slices.push_back(Slice({make_note(pitch, octave),
+                              make_note((pitch + 4) % 14, octave + 1)}));
+      fingerings.push_back(Fingering({f1, f2}));
+    } else {
+      slices.push_back(Slice({make_note(pitch, octave)}));
+      fingerings.push_back(s % 29 == 13 ? Fingering({std::nullopt})
+                                        : Fingering({f1}));
+    }
+  }
+  return {Piece(Metadata("Test", "Composer"),
+                {Measure(1, slices, TimeSignature(4, 4))},
+                {Measure(1, slices, TimeSignature(4, 4))}),
+          std::move(fingerings)};
+}
+
+// Production evaluate() scores in blocks of sequential notes; the
+// instrumented overload goes rule by rule. They must agree across block
+// boundaries, unfingered slices, both hands and reduced rule sets.
+TEST(ScoreEvaluatorTest, BlockedEvaluationMatchesRuleByRule) {
+  const auto [piece, fingerings] = make_random_piece();
+
+  Config config{};
+  config.right_hand = config::make_medium_right_hand();
+  config.left_hand = config::mirror_to_left_hand(config.right_hand);
+  config.weights = config::RuleWeights::defaults();
+  Config sparse = config;
+  sparse.weights.values[static_cast<size_t>(
+      config::RuleIndex::kThirdWhiteFourthBlack)] = 0.0;
+  sparse.weights.values[static_cast<size_t>(
+      config::RuleIndex::kSameFingerReuse)] = 0.0;
+
+  for (const Config& cfg : {config, sparse}) {
+    ScoreEvaluator evaluator(cfg);
+    for (Hand hand : {Hand::kRight, Hand::kLeft}) {
+      const EvalPiece compiled(piece, hand);
+      RuleStats stats;
+      double reference = evaluator.evaluate(compiled, fingerings, stats);
+      EXPECT_GT(reference, 0.0);
+      EXPECT_NEAR(evaluator.evaluate(compiled, fingerings), reference, 1e-9);
+    }
+  }
+}
+
+TEST(ScoreEvaluatorTest, DecomposedTermsSumToEvaluate) {
+  const auto [piece, fingerings] = make_random_piece();
+  Config config{};
+  config.right_hand = config::make_medium_right_hand();
+  config.left_hand = config::mirror_to_left_hand(config.right_hand);
+  config.weights = config::RuleWeights::defaults();
+  ScoreEvaluator evaluator(config);
+
+  for (Hand hand : {Hand::kRight, Hand::kLeft}) {
+    const EvalPiece compiled(piece, hand);
+    using SliceFingering = ScoreEvaluator::SliceFingering;
+    std::vector<SliceFingering> sequential;
+    double sum = 0.0;
+    for (size_t s = 0; s < compiled.slice_count(); ++s) {
+      const SliceFingering slice{s, domain::PackedFingering(fingerings[s])};
+      sum += evaluator.evaluate_intra_slice(compiled, slice);
+      if (!fingerings[s].begin()->has_value()) {
+        continue;  // no sequential note
+      }
+      sequential.push_back(slice);
+      const size_t n = sequential.size();
+      if (n >= 2) {
+        sum += evaluator.evaluate_transition(compiled, sequential[n - 2],
+                                             sequential[n - 1]);
+      }
+      if (n >= 3) {
+        sum += evaluator.evaluate_triplet(compiled, sequential[n - 3],
+                                          sequential[n - 2],
+                                          sequential[n - 1]);
+      }
+    }
+    EXPECT_NEAR(sum, evaluator.evaluate(compiled, fingerings), 1e-9);
+  }
+
+  const EvalPiece compiled(piece, Hand::kRight);
+  const ScoreEvaluator::SliceFingering past_end{compiled.slice_count(), {}};
+  EXPECT_THROW(
+      {
+        [[maybe_unused]] auto cost =
+            evaluator.evaluate_intra_slice(compiled, past_end);
+      },
+      std::out_of_range);
+}
+
 }  // namespace
 }  // namespace piano_fingering::evaluator
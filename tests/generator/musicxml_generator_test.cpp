@@ -0,0 +1,213 @@
+// tests/generator/musicxml_generator_test.cpp - Unit tests for
+// MusicXMLGenerator
+
+#include "generator/musicxml_generator.h"
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <initializer_list>
+#include <iterator>
+#include <optional>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "domain/finger.h"
+#include "domain/fingering.h"
+#include "domain/measure.h"
+#include "domain/metadata.h"
+#include "domain/note.h"
+#include "domain/packed_fingering.h"
+#include "domain/piece.h"
+#include "domain/pitch.h"
+#include "domain/slice.h"
+#include "domain/source_map.h"
+#include "domain/time_signature.h"
+#include "generator/generator_error.h"
+
+namespace piano_fingering::generator {
+namespace {
+
+using domain::Finger;
+using domain::Fingering;
+using domain::Measure;
+using domain::Note;
+using domain::PackedFingeringSequence;
+using domain::Pitch;
+using domain::Slice;
+
+Note note(int pitch, int staff) {
+  return Note(Pitch(pitch), 4, 1, false, staff, 1);
+}
+
+Note rest(int staff) { return Note(Pitch(0), 4, 1, true, staff, 1); }
+
+Measure measure(std::initializer_list<Slice> slices) {
+  return Measure(1, slices, domain::common_time());
+}
+
+// Offsets of the first `count` <note> elements of `score`
+std::vector<uint32_t> note_offsets(const std::string& score, size_t count) {
+  std::vector<uint32_t> offsets;
+  for (size_t at = score.find("<note>"); offsets.size() < count;
+       at = score.find("<note>", at + 1)) {
+    offsets.push_back(static_cast<uint32_t>(at));
+  }
+  return offsets;
+}
+
+std::string write(const std::string& score, const domain::Piece& piece,
+                  const domain::SourceMap& source_map,
+                  const PackedFingeringSequence& left,
+                  const PackedFingeringSequence& right) {
+  std::ostringstream out;
+  MusicXMLGenerator::write(out, score, piece, source_map, left, right);
+  return out.str();
+}
+
+// One right-hand note and one left-hand note
+class SimpleScoreTest : public ::testing::Test {
+ protected:
+  const std::string score_ =
+      "<measure>\n"
+      "  <note>\n"
+      "    <pitch><step>C</step><octave>4</octave></pitch>\n"
+      "    <staff>1</staff>\n"
+      "  </note>\n"
+      "  <note>\n"
+      "    <pitch><step>E</step><octave>4</octave></pitch>\n"
+      "    <staff>2</staff>\n"
+      "    <lyric><text>la</text></lyric>\n"
+      "  </note>\n"
+      "</measure>\n";
+  const domain::Piece piece_{domain::Metadata("", ""),
+                             {measure({Slice{note(4, 2)}})},
+                             {measure({Slice{note(0, 1)}})}};
+  domain::SourceMap source_map_;
+
+  void SetUp() override {
+    const auto offsets = note_offsets(score_, 2);
+    source_map_.right_hand = {offsets[0]};
+    source_map_.left_hand = {offsets[1]};
+  }
+};
+
+TEST_F(SimpleScoreTest, InsertsFingeringLastAndBeforeLyrics) {
+  const std::string output =
+      write(score_, piece_, source_map_,
+            PackedFingeringSequence({Fingering{Finger::kPinky}}),
+            PackedFingeringSequence({Fingering{Finger::kThumb}}));
+  EXPECT_EQ(output,
+            "<measure>\n"
+            "  <note>\n"
+            "    <pitch><step>C</step><octave>4</octave></pitch>\n"
+            "    <staff>1</staff>\n"
+            "    <notations><technical><fingering>1</fingering>"
+            "</technical></notations>\n"
+            "  </note>\n"
+            "  <note>\n"
+            "    <pitch><step>E</step><octave>4</octave></pitch>\n"
+            "    <staff>2</staff>\n"
+            "    <notations><technical><fingering>5</fingering>"
+            "</technical></notations>\n"
+            "    <lyric><text>la</text></lyric>\n"
+            "  </note>\n"
+            "</measure>\n");
+}
+
+TEST_F(SimpleScoreTest, UnassignedNotesAreCopiedThrough) {
+  const std::string output =
+      write(score_, piece_, source_map_,
+            PackedFingeringSequence({Fingering{std::nullopt}}),
+            PackedFingeringSequence({Fingering{std::nullopt}}));
+  EXPECT_EQ(output, score_);
+}
+
+TEST_F(SimpleScoreTest, KeepsExistingFingerings) {
+  const auto left = PackedFingeringSequence({Fingering{Finger::kRing}});
+  const auto right = PackedFingeringSequence({Fingering{Finger::kIndex}});
+  const std::string once = write(score_, piece_, source_map_, left, right);
+
+  // The output of a first run, re-read, gets nothing more
+  domain::SourceMap again;
+  const auto offsets = note_offsets(once, 2);
+  again.right_hand = {offsets[0]};
+  again.left_hand = {offsets[1]};
+  EXPECT_EQ(write(once, piece_, again, left, right), once);
+}
+
+TEST_F(SimpleScoreTest, MismatchedInputThrows) {
+  const auto one = PackedFingeringSequence({Fingering{Finger::kThumb}});
+  const auto two = PackedFingeringSequence(
+      {Fingering{Finger::kThumb}, Fingering{Finger::kIndex}});
+  EXPECT_THROW((void)write(score_, piece_, source_map_, one, two),
+               GeneratorError);
+
+  domain::SourceMap short_map = source_map_;
+  short_map.left_hand.clear();
+  EXPECT_THROW((void)write(score_, piece_, short_map, one, one),
+               GeneratorError);
+
+  domain::SourceMap wrong_map = source_map_;
+  wrong_map.right_hand[0] += 1;
+  EXPECT_THROW((void)write(score_, piece_, wrong_map, one, one),
+               GeneratorError);
+}
+
+TEST(MusicXMLGeneratorTest, ChordsFollowSliceOrderAndSkipRests) {
+  // The chord is written G then C, but the slice sorts C first
+  const std::string score =
+      "<note><pitch><step>G</step></pitch></note>"
+      "<note><chord/><pitch><step>C</step></pitch></note>"
+      "<note><rest/></note>"
+      "<note><pitch><step>D</step></pitch></note>";
+  const auto offsets = note_offsets(score, 4);
+  const domain::Piece piece(
+      domain::Metadata("", ""), std::vector<Measure>{},
+      {measure({Slice{note(7, 1), note(0, 1)}, Slice{rest(1)},
+                Slice{note(2, 1)}})});
+  domain::SourceMap source_map;
+  source_map.right_hand = {offsets[1], offsets[0], offsets[2], offsets[3]};
+
+  const std::string output = write(
+      score, piece, source_map, PackedFingeringSequence(),
+      PackedFingeringSequence({Fingering{Finger::kThumb, Finger::kPinky},
+                               Fingering{Finger::kIndex}}));
+  const std::string fingered = "<notations><technical><fingering>";
+  EXPECT_EQ(output,
+            "<note><pitch><step>G</step></pitch>" + fingered +
+                "5</fingering></technical></notations></note>"
+                "<note><chord/><pitch><step>C</step></pitch>" +
+                fingered +
+                "1</fingering></technical></notations></note>"
+                "<note><rest/></note>"
+                "<note><pitch><step>D</step></pitch>" +
+                fingered + "2</fingering></technical></notations></note>");
+}
+
+TEST_F(SimpleScoreTest, GenerateRefusesToOverwriteUnlessForced) {
+  const auto dir =
+      std::filesystem::temp_directory_path() / "musicxml_generator_test";
+  std::filesystem::create_directories(dir);
+  const auto output = dir / "fingered.musicxml";
+  std::ofstream(output) << "existing";
+
+  const auto fingering = PackedFingeringSequence({Fingering{Finger::kThumb}});
+  EXPECT_THROW(MusicXMLGenerator::generate(output, score_, piece_, source_map_,
+                                           fingering, fingering, false),
+               FileExistsError);
+  MusicXMLGenerator::generate(output, score_, piece_, source_map_, fingering,
+                              fingering, true);
+
+  std::ifstream file(output);
+  const std::string written((std::istreambuf_iterator<char>(file)),
+                            std::istreambuf_iterator<char>());
+  EXPECT_EQ(written, write(score_, piece_, source_map_, fingering, fingering));
+  std::filesystem::remove_all(dir);
+}
+
+}  // namespace
+}  // namespace piano_fingering::generator
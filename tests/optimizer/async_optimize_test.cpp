@@ -0,0 +1,252 @@
+#include "optimizer/async_optimize.h"
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <coroutine>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <latch>
+#include <mutex>
+#include <stop_token>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "config/config.h"
+#include "config/preset.h"
+#include "domain/hand.h"
+#include "domain/measure.h"
+#include "domain/metadata.h"
+#include "domain/note.h"
+#include "domain/packed_fingering.h"
+#include "domain/piece.h"
+#include "domain/pitch.h"
+#include "domain/slice.h"
+#include "optimizer/memory_budget.h"
+#include "optimizer/optimizer.h"
+
+namespace piano_fingering::optimizer {
+namespace {
+
+using config::Config;
+using domain::Hand;
+using domain::Measure;
+using domain::Metadata;
+using domain::Note;
+using domain::Piece;
+using domain::Pitch;
+using domain::Slice;
+using domain::TimeSignature;
+
+Note make_note(int pitch_val, int octave) {
+  return Note(Pitch(pitch_val), octave, 480, false, 1, 1);
+}
+
+Config make_config() {
+  Config config{};
+  config.right_hand = config::make_medium_right_hand();
+  config.left_hand = config::mirror_to_left_hand(config.right_hand);
+  config.weights = config::RuleWeights::defaults();
+  config.algorithm.beam_width = 20;
+  config.algorithm.ils_iterations = 50;
+  config.algorithm.ils_trajectories = 4;
+  return config;
+}
+
+// Pseudo-random melody with a chord every sixth slice, in both hands
+Piece make_piece(size_t slice_count) {
+  std::vector<Slice> slices;
+  std::uint32_t seed = 3;
+  auto next_pitch = [&seed] {
+    seed = seed * 1103515245U + 12345U;
+    return static_cast<int>((seed >> 16) % 14);
+  };
+  for (size_t i = 0; i < slice_count; ++i) {
+    if (i % 6 == 5) {
+      slices.push_back(Slice({make_note(next_pitch(), 4),
+                              make_note(next_pitch(), 5)}));
+    } else {
+      slices.push_back(Slice({make_note(next_pitch(), 4)}));
+    }
+  }
+  std::vector<Measure> hand{Measure(1, std::move(slices), TimeSignature(4, 4))};
+  return Piece(Metadata("Test", "Composer"), hand, hand);
+}
+
+// Coroutine that starts at once and cleans up after itself, as a service's
+// request handler would
+struct Detached {
+  struct promise_type {
+    Detached get_return_object() noexcept { return {}; }
+    std::suspend_never initial_suspend() noexcept { return {}; }
+    std::suspend_never final_suspend() noexcept { return {}; }
+    void return_void() noexcept {}
+    void unhandled_exception() noexcept { std::terminate(); }
+  };
+};
+
+// Single-threaded loop that resumes the coroutines handed to its Resumer
+class EventLoop {
+ public:
+  Resumer resumer() {
+    return [this](std::coroutine_handle<> handle) {
+      {
+        const std::lock_guard lock(mutex_);
+        ready_.push_back(handle);
+      }
+      wake_.notify_one();
+    };
+  }
+
+  // Resumes queued coroutines on the calling thread until `pending` is 0
+  void run(const std::atomic<int>& pending) {
+    while (pending.load() > 0) {
+      std::coroutine_handle<> handle;
+      {
+        std::unique_lock lock(mutex_);
+        wake_.wait(lock, [this] { return !ready_.empty(); });
+        handle = ready_.front();
+        ready_.pop_front();
+      }
+      handle.resume();
+    }
+  }
+
+ private:
+  std::mutex mutex_;
+  std::condition_variable wake_;
+  std::deque<std::coroutine_handle<>> ready_;
+};
+
+Detached optimize_hand(Optimizer& optimizer, const Piece& piece,
+                       unsigned int seed, Optimizer::Limits limits,
+                       Optimizer::Result& result, std::exception_ptr& error,
+                       std::latch& done) {
+  try {
+    result = co_await async_optimize(optimizer, piece, Hand::kRight, seed,
+                                     std::move(limits));
+  } catch (...) {
+    error = std::current_exception();
+  }
+  done.count_down();
+}
+
+Detached optimize_on_loop(Optimizer& optimizer, const Piece& piece,
+                          unsigned int seed, EventLoop& loop,
+                          Optimizer::PieceResult& result,
+                          std::thread::id& resumed_on,
+                          std::atomic<int>& pending) {
+  result = co_await async_optimize_piece(optimizer, piece, seed, {},
+                                         loop.resumer());
+  resumed_on = std::this_thread::get_id();
+  --pending;
+}
+
+TEST(AsyncOptimizeTest, ResumesWithTheResultOfOptimize) {
+  Optimizer optimizer(make_config(), 2);
+  const Piece piece = make_piece(50);
+  const auto expected = optimizer.optimize(piece, Hand::kRight, 5);
+
+  Optimizer::Result result;
+  std::exception_ptr error;
+  std::latch done(1);
+  optimize_hand(optimizer, piece, 5, {}, result, error, done);
+  done.wait();
+
+  ASSERT_FALSE(error);
+  EXPECT_EQ(result.fingerings, expected.fingerings);
+  EXPECT_EQ(result.score, expected.score);
+  EXPECT_EQ(result.iterations_performed, expected.iterations_performed);
+}
+
+TEST(AsyncOptimizeTest, OneLoopThreadMultiplexesRequests) {
+  Optimizer optimizer(make_config(), 3);
+  const Piece piece = make_piece(40);
+  EventLoop loop;
+  std::atomic<int> pending{3};
+  std::vector<Optimizer::PieceResult> results(3);
+  std::vector<std::thread::id> resumed_on(3);
+  for (unsigned int i = 0; i < 3; ++i) {
+    optimize_on_loop(optimizer, piece, i, loop, results[i], resumed_on[i],
+                     pending);
+  }
+  // Every request is in flight before the loop runs
+  loop.run(pending);
+
+  for (unsigned int i = 0; i < 3; ++i) {
+    const auto expected = optimizer.optimize_piece(piece, i);
+    EXPECT_EQ(resumed_on[i], std::this_thread::get_id());
+    EXPECT_EQ(results[i].right_hand.fingerings,
+              expected.right_hand.fingerings);
+    EXPECT_EQ(results[i].left_hand.fingerings, expected.left_hand.fingerings);
+    EXPECT_EQ(results[i].score, expected.score);
+  }
+}
+
+TEST(AsyncOptimizeTest, StreamsImprovementsAndStopsOnRequest) {
+  Config config = make_config();
+  // A greedy beam leaves ILS plenty to improve
+  config.algorithm.beam_width = 1;
+  config.algorithm.ils_iterations = 100'000'000;
+  Optimizer optimizer(config, 2);
+  const Piece piece = make_piece(60);
+
+  std::stop_source stop;
+  std::mutex mutex;
+  std::vector<double> reported;
+  Optimizer::Limits limits;
+  limits.stop_token = stop.get_token();
+  // In case the search stops improving before the stop request
+  limits.deadline = Optimizer::Clock::now() + std::chrono::seconds(2);
+  limits.on_improvement = [&](Hand hand,
+                              const domain::PackedFingeringSequence& fingerings,
+                              double score) {
+    EXPECT_EQ(hand, Hand::kRight);
+    EXPECT_EQ(fingerings.size(), 60);
+    const std::lock_guard lock(mutex);
+    reported.push_back(score);
+    if (reported.size() == 3) {
+      stop.request_stop();
+    }
+  };
+
+  Optimizer::Result result;
+  std::exception_ptr error;
+  std::latch done(1);
+  optimize_hand(optimizer, piece, 2, limits, result, error, done);
+  done.wait();
+
+  ASSERT_FALSE(error);
+  ASSERT_GE(reported.size(), 3);
+  for (size_t i = 1; i < reported.size(); ++i) {
+    EXPECT_LT(reported[i], reported[i - 1]);
+  }
+  EXPECT_LE(result.score, reported.front());
+  EXPECT_NEAR(result.score, reported.back(), 1e-6);
+  EXPECT_LT(result.iterations_performed,
+            config.algorithm.ils_iterations * config.algorithm.ils_trajectories);
+}
+
+TEST(AsyncOptimizeTest, RethrowsSearchErrorsInTheCaller) {
+  Optimizer optimizer(make_config(), 2);
+  const Piece piece = make_piece(20);
+  MemoryBudget budget(16);
+  Optimizer::Limits limits;
+  limits.memory = &budget;
+
+  Optimizer::Result result;
+  std::exception_ptr error;
+  std::latch done(1);
+  optimize_hand(optimizer, piece, 1, limits, result, error, done);
+  done.wait();
+
+  ASSERT_TRUE(error);
+  EXPECT_THROW(std::rethrow_exception(error), MemoryBudgetError);
+}
+
+}  // namespace
+}  // namespace piano_fingering::optimizer
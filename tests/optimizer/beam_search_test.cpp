@@ -0,0 +1,268 @@
+#include "optimizer/beam_search.h"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+#include "config/config.h"
+#include "config/preset.h"
+#include "domain/fingering.h"
+#include "domain/hand.h"
+#include "domain/measure.h"
+#include "domain/metadata.h"
+#include "domain/note.h"
+#include "domain/packed_fingering.h"
+#include "domain/piece.h"
+#include "domain/pitch.h"
+#include "domain/slice.h"
+#include "evaluator/eval_piece.h"
+#include "evaluator/score_evaluator.h"
+#include "optimizer/exact_search.h"
+#include "optimizer/memory_budget.h"
+#include "optimizer/state_generation.h"
+#include "optimizer/thread_pool.h"
+
+namespace piano_fingering::optimizer {
+namespace {
+
+using config::Config;
+using domain::Hand;
+using domain::Measure;
+using domain::Metadata;
+using domain::Note;
+using domain::PackedFingering;
+using domain::PackedFingeringSequence;
+using domain::Piece;
+using domain::Pitch;
+using domain::Slice;
+using domain::TimeSignature;
+using evaluator::EvalPiece;
+using evaluator::ScoreEvaluator;
+
+Note make_note(int pitch_val, int octave) {
+  return Note(Pitch(pitch_val), octave, 480, false, 1, 1);
+}
+
+Config make_medium_config() {
+  Config config{};
+  config.right_hand = config::make_medium_right_hand();
+  config.left_hand = config::mirror_to_left_hand(config.right_hand);
+  config.weights = config::RuleWeights::defaults();
+  return config;
+}
+
+// Five slices with a chord; small enough to enumerate every assignment
+Piece make_piece() {
+  return Piece(
+      Metadata("Test", "Composer"), {},
+      {Measure(1,
+               {Slice({make_note(0, 4)}), Slice({make_note(3, 4)}),
+                Slice({make_note(6, 4), make_note(10, 4)}),
+                Slice({make_note(1, 4)}), Slice({make_note(10, 5)})},
+               TimeSignature(4, 4))});
+}
+
+// Lowest evaluate() over every combination of valid states
+double brute_force_optimum(const ScoreEvaluator& evaluator,
+                           const EvalPiece& piece) {
+  double best = std::numeric_limits<double>::infinity();
+  PackedFingeringSequence current;
+  auto recurse = [&](auto& self, size_t slice) -> void {
+    if (slice == piece.slice_count()) {
+      best = std::min(best, evaluator.evaluate(piece, current.unpack()));
+      return;
+    }
+    for (PackedFingering state :
+         generate_valid_states(piece.slice_size(slice))) {
+      PackedFingeringSequence saved = current;
+      current.push_back(state, piece.slice_size(slice));
+      self(self, slice + 1);
+      current = saved;
+    }
+  };
+  recurse(recurse, 0);
+  return best;
+}
+
+// Pseudo-random melody with a chord every seventh slice
+Piece make_long_piece(size_t slice_count) {
+  std::vector<Slice> slices;
+  std::uint32_t seed = 11;
+  auto next_pitch = [&seed] {
+    seed = seed * 1103515245U + 12345U;
+    return static_cast<int>((seed >> 16) % 14);
+  };
+  for (size_t i = 0; i < slice_count; ++i) {
+    if (i % 7 == 6) {
+      slices.push_back(Slice({make_note(next_pitch(), 4),
+                              make_note(next_pitch(), 5)}));
+    } else {
+      slices.push_back(Slice({make_note(next_pitch(), 4)}));
+    }
+  }
+  return Piece(Metadata("Test", "Composer"), {},
+               {Measure(1, std::move(slices), TimeSignature(4, 4))});
+}
+
+class BeamSearchTest : public ::testing::Test {
+ protected:
+  Config config_ = make_medium_config();
+  ScoreEvaluator evaluator_{config_};
+  Piece piece_ = make_piece();
+  EvalPiece compiled_{piece_, Hand::kRight};
+};
+
+TEST_F(BeamSearchTest, CostMatchesFullEvaluation) {
+  auto result = beam_search(evaluator_, compiled_, 10);
+
+  ASSERT_EQ(result.fingerings.size(), compiled_.slice_count());
+  EXPECT_FALSE(result.fingerings.violates_hard_constraint());
+  EXPECT_NEAR(result.cost, evaluator_.evaluate(compiled_, result.fingerings),
+              1e-9);
+}
+
+TEST_F(BeamSearchTest, WideBeamFindsOptimum) {
+  // Wider than the number of complete assignments, so nothing is pruned
+  auto result = beam_search(evaluator_, compiled_, 20000);
+  EXPECT_NEAR(result.cost, brute_force_optimum(evaluator_, compiled_), 1e-9);
+}
+
+TEST_F(BeamSearchTest, NarrowBeamIsNoBetterThanWide) {
+  auto narrow = beam_search(evaluator_, compiled_, 1);
+  auto wide = beam_search(evaluator_, compiled_, 100);
+  EXPECT_GE(narrow.cost, wide.cost);
+  EXPECT_NEAR(narrow.cost, evaluator_.evaluate(compiled_, narrow.fingerings),
+              1e-9);
+}
+
+TEST_F(BeamSearchTest, BoundKeepsNarrowBeamNearOptimum) {
+  const Piece piece = make_long_piece(200);
+  const EvalPiece compiled(piece, Hand::kRight);
+  const double optimum = exact_search(evaluator_, compiled).cost;
+
+  // Ranking by accumulated cost alone left width 4 about 7% above optimal
+  auto narrow = beam_search(evaluator_, compiled, 4);
+  EXPECT_LE(narrow.cost, optimum * 1.01);
+  EXPECT_NEAR(narrow.cost, evaluator_.evaluate(compiled, narrow.fingerings),
+              1e-9);
+}
+
+TEST_F(BeamSearchTest, AdaptiveBudgetBeatsWideFixedBeam) {
+  const Piece piece = make_long_piece(200);
+  const EvalPiece compiled(piece, Hand::kRight);
+
+  // Four states per slice on average, against a hundred everywhere
+  auto adaptive = beam_search(evaluator_, compiled, BeamBudget{100, 800});
+  auto fixed = beam_search(evaluator_, compiled, 100);
+  EXPECT_LE(adaptive.cost, fixed.cost);
+  EXPECT_NEAR(adaptive.cost,
+              evaluator_.evaluate(compiled, adaptive.fingerings), 1e-9);
+}
+
+TEST_F(BeamSearchTest, AdaptiveParallelExpansionIsBitIdentical) {
+  const Piece piece = make_long_piece(40);
+  const EvalPiece compiled(piece, Hand::kRight);
+  ThreadPool pool(4);
+
+  const BeamBudget budget{1000, 20000};
+  auto serial = beam_search(evaluator_, compiled, budget);
+  auto parallel = beam_search(evaluator_, compiled, budget, pool);
+  EXPECT_EQ(parallel.fingerings, serial.fingerings);
+  EXPECT_EQ(parallel.cost, serial.cost);
+}
+
+TEST_F(BeamSearchTest, MemoryBudgetNarrowsTheBeam) {
+  const Piece piece = make_long_piece(200);
+  const EvalPiece compiled(piece, Hand::kRight);
+  ThreadPool pool(2);
+
+  MemoryBudget ample(64U << 20);
+  auto unlimited = beam_search(evaluator_, compiled, 100, pool);
+  auto charged = beam_search(evaluator_, compiled, 100, pool, &ample);
+  EXPECT_EQ(charged.fingerings, unlimited.fingerings);
+  EXPECT_EQ(ample.current(), 0);
+  const size_t full_peak = ample.peak();
+
+  // Two thirds of the bytes still complete, on a narrower beam
+  MemoryBudget tight(full_peak * 2 / 3);
+  auto narrowed = beam_search(evaluator_, compiled, 100, pool, &tight);
+  EXPECT_LE(tight.peak(), tight.limit());
+  EXPECT_GT(tight.peak(), 0);
+  EXPECT_NEAR(narrowed.cost,
+              evaluator_.evaluate(compiled, narrowed.fingerings), 1e-9);
+
+  MemoryBudget starved(1024);
+  EXPECT_THROW(
+      {
+        [[maybe_unused]] auto r =
+            beam_search(evaluator_, compiled, 100, pool, &starved);
+      },
+      MemoryBudgetError);
+  EXPECT_EQ(starved.current(), 0);
+}
+
+TEST_F(BeamSearchTest, IsDeterministic) {
+  auto first = beam_search(evaluator_, compiled_, 7);
+  auto second = beam_search(evaluator_, compiled_, 7);
+  EXPECT_EQ(first.fingerings, second.fingerings);
+  EXPECT_DOUBLE_EQ(first.cost, second.cost);
+}
+
+TEST_F(BeamSearchTest, ParallelExpansionIsBitIdentical) {
+  const Piece piece = make_long_piece(40);
+  const EvalPiece compiled(piece, Hand::kRight);
+  ThreadPool pool(4);
+
+  // Wide enough that every slice after the first few expands in parallel
+  auto serial = beam_search(evaluator_, compiled, 1000);
+  auto parallel = beam_search(evaluator_, compiled, 1000, pool);
+  EXPECT_EQ(parallel.fingerings, serial.fingerings);
+  EXPECT_EQ(parallel.cost, serial.cost);
+}
+
+TEST_F(BeamSearchTest, FixedPointCostsMatchFloatingPoint) {
+  const Piece piece = make_long_piece(200);
+  const EvalPiece compiled(piece, Hand::kRight);
+  Config fixed = config_;
+  fixed.algorithm.fixed_point_costs = true;
+  const ScoreEvaluator fixed_evaluator(fixed);
+  ASSERT_EQ(fixed_evaluator.fixed_point_scale(), 2);
+  ThreadPool pool(4);
+
+  // The default weights are exact in both, so the searches agree
+  auto floating = beam_search(evaluator_, compiled, 16);
+  auto integer = beam_search(fixed_evaluator, compiled, 16);
+  EXPECT_EQ(integer.fingerings, floating.fingerings);
+  EXPECT_EQ(integer.cost, floating.cost);
+  EXPECT_EQ(integer.cost, evaluator_.evaluate(compiled, integer.fingerings));
+
+  const BeamBudget budget{100, 800};
+  auto adaptive = beam_search(fixed_evaluator, compiled, budget, pool);
+  EXPECT_EQ(adaptive.fingerings,
+            beam_search(evaluator_, compiled, budget).fingerings);
+}
+
+TEST_F(BeamSearchTest, EmptyHandAndZeroWidth) {
+  EvalPiece left(piece_, Hand::kLeft);
+  auto result = beam_search(evaluator_, left, 10);
+  EXPECT_TRUE(result.fingerings.empty());
+  EXPECT_DOUBLE_EQ(result.cost, 0.0);
+
+  EXPECT_THROW(
+      { [[maybe_unused]] auto r = beam_search(evaluator_, compiled_, 0); },
+      std::invalid_argument);
+  EXPECT_THROW(
+      {
+        [[maybe_unused]] auto r =
+            beam_search(evaluator_, compiled_, BeamBudget{10, 0});
+      },
+      std::invalid_argument);
+}
+
+}  // namespace
+}  // namespace piano_fingering::optimizer
@@ -0,0 +1,193 @@
+#include "optimizer/exact_search.h"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <limits>
+#include <stdexcept>
+#include <vector>
+
+#include "config/config.h"
+#include "config/preset.h"
+#include "domain/hand.h"
+#include "domain/measure.h"
+#include "domain/metadata.h"
+#include "domain/note.h"
+#include "domain/packed_fingering.h"
+#include "domain/piece.h"
+#include "domain/pitch.h"
+#include "domain/slice.h"
+#include "evaluator/eval_piece.h"
+#include "evaluator/score_evaluator.h"
+#include "optimizer/beam_search.h"
+#include "optimizer/state_generation.h"
+
+namespace piano_fingering::optimizer {
+namespace {
+
+using config::Config;
+using domain::Hand;
+using domain::Measure;
+using domain::Metadata;
+using domain::Note;
+using domain::PackedFingering;
+using domain::PackedFingeringSequence;
+using domain::Piece;
+using domain::Pitch;
+using domain::Slice;
+using domain::TimeSignature;
+using evaluator::EvalPiece;
+using evaluator::ScoreEvaluator;
+
+Note make_note(int pitch_val, int octave) {
+  return Note(Pitch(pitch_val), octave, 480, false, 1, 1);
+}
+
+Config make_medium_config() {
+  Config config{};
+  config.right_hand = config::make_medium_right_hand();
+  config.left_hand = config::mirror_to_left_hand(config.right_hand);
+  config.weights = config::RuleWeights::defaults();
+  return config;
+}
+
+Piece make_piece(std::vector<Slice> slices) {
+  return Piece(Metadata("Test", "Composer"), {},
+               {Measure(1, std::move(slices), TimeSignature(4, 4))});
+}
+
+double brute_force_optimum(const ScoreEvaluator& evaluator,
+                           const EvalPiece& piece) {
+  double best = std::numeric_limits<double>::infinity();
+  PackedFingeringSequence current;
+  auto recurse = [&](auto& self, size_t slice) -> void {
+    if (slice == piece.slice_count()) {
+      best = std::min(best, evaluator.evaluate(piece, current.unpack()));
+      return;
+    }
+    for (PackedFingering state :
+         generate_valid_states(piece.slice_size(slice))) {
+      PackedFingeringSequence saved = current;
+      current.push_back(state, piece.slice_size(slice));
+      self(self, slice + 1);
+      current = saved;
+    }
+  };
+  recurse(recurse, 0);
+  return best;
+}
+
+class ExactSearchTest : public ::testing::Test {
+ protected:
+  void expect_optimal(const Piece& piece) const {
+    const EvalPiece compiled(piece, Hand::kRight);
+    auto result = exact_search(evaluator_, compiled);
+    ASSERT_EQ(result.fingerings.size(), compiled.slice_count());
+    EXPECT_NEAR(result.cost, evaluator_.evaluate(compiled, result.fingerings),
+                1e-9);
+    EXPECT_NEAR(result.cost, brute_force_optimum(evaluator_, compiled), 1e-9);
+  }
+
+  Config config_ = make_medium_config();
+  ScoreEvaluator evaluator_{config_};
+};
+
+TEST_F(ExactSearchTest, MatchesBruteForceOnMelody) {
+  // Leaps, a black key and a repeated pitch exercise rules 3, 4, 12 and 15
+  expect_optimal(make_piece(
+      {Slice({make_note(0, 4)}), Slice({make_note(8, 4)}),
+       Slice({make_note(3, 4)}), Slice({make_note(3, 4)}),
+       Slice({make_note(12, 4)}), Slice({make_note(2, 5)}),
+       Slice({make_note(6, 4)})}));
+}
+
+TEST_F(ExactSearchTest, MatchesBruteForceWithChords) {
+  expect_optimal(make_piece(
+      {Slice({make_note(0, 4)}), Slice({make_note(3, 4)}),
+       Slice({make_note(6, 4), make_note(10, 4)}), Slice({make_note(1, 4)}),
+       Slice({make_note(0, 4), make_note(4, 4), make_note(8, 4)})}));
+}
+
+TEST_F(ExactSearchTest, FixedPointCostsStayOptimal) {
+  config_.algorithm.fixed_point_costs = true;
+  config_.weights.values[0] = 0.75;
+  evaluator_ = ScoreEvaluator(config_);
+  ASSERT_EQ(evaluator_.fixed_point_scale(), 4);
+  expect_optimal(make_piece(
+      {Slice({make_note(0, 4)}), Slice({make_note(8, 4)}),
+       Slice({make_note(3, 4)}), Slice({make_note(6, 4), make_note(10, 4)}),
+       Slice({make_note(12, 4)}), Slice({make_note(2, 5)})}));
+
+  // No power-of-two scale makes 0.1 whole, so the search stays in double
+  config_.weights.values[0] = 0.1;
+  evaluator_ = ScoreEvaluator(config_);
+  EXPECT_FALSE(evaluator_.fixed_point_scale().has_value());
+  expect_optimal(make_piece({Slice({make_note(0, 4)}), Slice({make_note(9, 4)}),
+                             Slice({make_note(2, 4)})}));
+}
+
+TEST_F(ExactSearchTest, ShortPieces) {
+  expect_optimal(make_piece({Slice({make_note(0, 4), make_note(8, 4)})}));
+  expect_optimal(make_piece({Slice({make_note(0, 4)}),
+                             Slice({make_note(1, 5)})}));
+
+  const Piece piece = make_piece({Slice({make_note(0, 4)})});
+  const EvalPiece left(piece, Hand::kLeft);
+  auto result = exact_search(evaluator_, left);
+  EXPECT_TRUE(result.fingerings.empty());
+  EXPECT_DOUBLE_EQ(result.cost, 0.0);
+}
+
+TEST_F(ExactSearchTest, RangeIsSolvedAsItsOwnPiece) {
+  const Piece piece = make_piece(
+      {Slice({make_note(0, 4)}), Slice({make_note(8, 4)}),
+       Slice({make_note(3, 4)}), Slice({make_note(12, 4)}),
+       Slice({make_note(2, 5)})});
+  const Piece tail = make_piece({Slice({make_note(3, 4)}),
+                                 Slice({make_note(12, 4)}),
+                                 Slice({make_note(2, 5)})});
+  const EvalPiece compiled(piece, Hand::kRight);
+  const EvalPiece compiled_tail(tail, Hand::kRight);
+
+  auto range = exact_search(evaluator_, compiled, SliceRange{2, 5});
+  auto whole = exact_search(evaluator_, compiled_tail);
+  EXPECT_EQ(range.fingerings, whole.fingerings);
+  EXPECT_DOUBLE_EQ(range.cost, whole.cost);
+  // Wide enough to keep every assignment of the three slices
+  EXPECT_NEAR(beam_search(evaluator_, compiled, 200, SliceRange{2, 5}).cost,
+              whole.cost, 1e-9);
+
+  EXPECT_THROW(
+      {
+        [[maybe_unused]] auto r =
+            exact_search(evaluator_, compiled, SliceRange{3, 6});
+      },
+      std::out_of_range);
+  EXPECT_THROW(
+      {
+        [[maybe_unused]] auto r =
+            beam_search(evaluator_, compiled, 10, SliceRange{4, 3});
+      },
+      std::out_of_range);
+}
+
+TEST_F(ExactSearchTest, NeverWorseThanBeamSearch) {
+  std::vector<Slice> slices;
+  std::uint32_t seed = 7;
+  for (size_t i = 0; i < 120; ++i) {
+    seed = seed * 1103515245U + 12345U;
+    const int pitch = static_cast<int>((seed >> 16) % 14);
+    slices.emplace_back(std::vector<Note>{make_note(pitch, 4 + (i % 3) / 2)});
+  }
+  const Piece piece = make_piece(std::move(slices));
+  const EvalPiece compiled(piece, Hand::kRight);
+
+  auto exact = exact_search(evaluator_, compiled);
+  auto beam = beam_search(evaluator_, compiled, 100);
+  EXPECT_LE(exact.cost, beam.cost + 1e-9);
+  EXPECT_NEAR(exact.cost, evaluator_.evaluate(compiled, exact.fingerings),
+              1e-9);
+}
+
+}  // namespace
+}  // namespace piano_fingering::optimizer
@@ -0,0 +1,180 @@
+#include "optimizer/ils.h"
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+#include "config/config.h"
+#include "config/preset.h"
+#include "domain/hand.h"
+#include "domain/measure.h"
+#include "domain/metadata.h"
+#include "domain/note.h"
+#include "domain/packed_fingering.h"
+#include "domain/piece.h"
+#include "domain/pitch.h"
+#include "domain/slice.h"
+#include "evaluator/eval_piece.h"
+#include "evaluator/incremental_evaluation.h"
+#include "evaluator/score_evaluator.h"
+#include "optimizer/exact_search.h"
+#include "optimizer/state_generation.h"
+
+namespace piano_fingering::optimizer {
+namespace {
+
+using config::Config;
+using domain::Hand;
+using domain::Measure;
+using domain::Metadata;
+using domain::Note;
+using domain::PackedFingeringSequence;
+using domain::Piece;
+using domain::Pitch;
+using domain::Slice;
+using domain::TimeSignature;
+using evaluator::EvalPiece;
+using evaluator::ScoreEvaluator;
+
+Note make_note(int pitch_val, int octave) {
+  return Note(Pitch(pitch_val), octave, 480, false, 1, 1);
+}
+
+Config make_medium_config() {
+  Config config{};
+  config.right_hand = config::make_medium_right_hand();
+  config.left_hand = config::mirror_to_left_hand(config.right_hand);
+  config.weights = config::RuleWeights::defaults();
+  return config;
+}
+
+// Pseudo-random melody with a chord every fifth slice
+Piece make_piece(size_t slice_count) {
+  std::vector<Slice> slices;
+  std::uint32_t seed = 3;
+  auto next_pitch = [&seed] {
+    seed = seed * 1103515245U + 12345U;
+    return static_cast<int>((seed >> 16) % 14);
+  };
+  for (size_t i = 0; i < slice_count; ++i) {
+    if (i % 5 == 4) {
+      slices.push_back(Slice({make_note(next_pitch(), 4),
+                              make_note(next_pitch(), 5)}));
+    } else {
+      slices.push_back(Slice({make_note(next_pitch(), 4)}));
+    }
+  }
+  return Piece(Metadata("Test", "Composer"), {},
+               {Measure(1, std::move(slices), TimeSignature(4, 4))});
+}
+
+// The first valid state of every slice: thumb-led throughout
+PackedFingeringSequence make_naive_start(const EvalPiece& piece) {
+  PackedFingeringSequence start;
+  for (size_t slice = 0; slice < piece.slice_count(); ++slice) {
+    start.push_back(generate_valid_states(piece.slice_size(slice)).front(),
+                    piece.slice_size(slice));
+  }
+  return start;
+}
+
+class IlsTest : public ::testing::Test {
+ protected:
+  Config config_ = make_medium_config();
+  ScoreEvaluator evaluator_{config_};
+  Piece piece_ = make_piece(40);
+  EvalPiece compiled_{piece_, Hand::kRight};
+};
+
+TEST_F(IlsTest, ImprovesToAConsistentLocalOptimum) {
+  const auto start = make_naive_start(compiled_);
+  IlsOptions options;
+  options.iterations = 200;
+  auto result = ils_improve(evaluator_, compiled_, start, options);
+
+  ASSERT_EQ(result.fingerings.size(), compiled_.slice_count());
+  EXPECT_FALSE(result.fingerings.violates_hard_constraint());
+  EXPECT_NEAR(result.cost, evaluator_.evaluate(compiled_, result.fingerings),
+              1e-9);
+  EXPECT_LT(result.cost, evaluator_.evaluate(compiled_, start));
+  EXPECT_GE(result.cost, exact_search(evaluator_, compiled_).cost - 1e-9);
+
+  // No single-note move improves the result
+  evaluator::IncrementalEvaluation session(evaluator_, compiled_,
+                                           result.fingerings);
+  for (size_t slice = 0; slice < compiled_.slice_count(); ++slice) {
+    for (size_t note = 0; note < compiled_.slice_size(slice); ++note) {
+      for (double delta : session.neighborhood({0, 0, note, slice})) {
+        EXPECT_GE(delta, -1e-9) << "slice " << slice << " note " << note;
+      }
+    }
+  }
+}
+
+TEST_F(IlsTest, DeterministicForSeed) {
+  const auto start = make_naive_start(compiled_);
+  for (IlsStrategy strategy : {IlsStrategy::kClassic, IlsStrategy::kTabu}) {
+    IlsOptions options;
+    options.iterations = 100;
+    options.seed = 42;
+    options.strategy = strategy;
+    auto first = ils_improve(evaluator_, compiled_, start, options);
+    auto second = ils_improve(evaluator_, compiled_, start, options);
+    EXPECT_EQ(first.fingerings, second.fingerings);
+    EXPECT_DOUBLE_EQ(first.cost, second.cost);
+  }
+}
+
+TEST_F(IlsTest, RevisitedWorseOptimaStrengthenPerturbation) {
+  // Starting at the optimum, no round improves, so every optimum reached
+  // afterwards is worse than the best and only tabu if it was remembered
+  const SearchResult optimum = exact_search(evaluator_, compiled_);
+  IlsOptions options;
+  options.iterations = 400;
+  options.seed = 7;
+  options.tabu_tenure = 64;
+  SearchStats tabu;
+  options.stats = &tabu;
+  const auto result =
+      ils_improve(evaluator_, compiled_, optimum.fingerings, options);
+
+  EXPECT_EQ(tabu.ils_improvements, 0);
+  EXPECT_GT(tabu.ils_tabu_revisits, 0);
+  EXPECT_NEAR(result.cost, optimum.cost, 1e-9);
+
+  options.strategy = IlsStrategy::kClassic;
+  SearchStats classic;
+  options.stats = &classic;
+  (void)ils_improve(evaluator_, compiled_, optimum.fingerings, options);
+  EXPECT_EQ(classic.ils_tabu_revisits, 0);
+}
+
+TEST_F(IlsTest, MoreIterationsNeverHurt) {
+  const auto start = make_naive_start(compiled_);
+  IlsOptions options;
+  options.iterations = 0;
+  const double descent =
+      ils_improve(evaluator_, compiled_, start, options).cost;
+  options.iterations = 300;
+  const double iterated =
+      ils_improve(evaluator_, compiled_, start, options).cost;
+  EXPECT_LE(iterated, descent + 1e-9);
+}
+
+TEST_F(IlsTest, RejectsMismatchedStart) {
+  PackedFingeringSequence start = make_naive_start(compiled_);
+  PackedFingeringSequence short_start;
+  short_start.push_back(start[0], 1);
+  EXPECT_THROW(
+      {
+        [[maybe_unused]] auto r =
+            ils_improve(evaluator_, compiled_, short_start);
+      },
+      std::invalid_argument);
+}
+
+}  // namespace
+}  // namespace piano_fingering::optimizer
@@ -0,0 +1,247 @@
+#include "optimizer/incremental.h"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cstddef>
+#include <stdexcept>
+#include <vector>
+
+#include "config/config.h"
+#include "config/preset.h"
+#include "domain/hand.h"
+#include "domain/measure.h"
+#include "domain/metadata.h"
+#include "domain/note.h"
+#include "domain/packed_fingering.h"
+#include "domain/piece.h"
+#include "domain/pitch.h"
+#include "domain/slice.h"
+#include "evaluator/eval_piece.h"
+#include "evaluator/score_evaluator.h"
+#include "optimizer/exact_search.h"
+#include "optimizer/optimizer.h"
+
+namespace piano_fingering::optimizer {
+namespace {
+
+using config::Config;
+using domain::Hand;
+using domain::Measure;
+using domain::Metadata;
+using domain::Note;
+using domain::PackedFingeringSequence;
+using domain::Piece;
+using domain::Pitch;
+using domain::Slice;
+using domain::TimeSignature;
+using evaluator::EvalPiece;
+using evaluator::ScoreEvaluator;
+
+Config make_medium_config() {
+  Config config{};
+  config.right_hand = config::make_medium_right_hand();
+  config.left_hand = config::mirror_to_left_hand(config.right_hand);
+  config.weights = config::RuleWeights::defaults();
+  return config;
+}
+
+// Absolute pitches, one slice each; a chord every seventh slice
+std::vector<int> make_line(size_t count, unsigned seed) {
+  std::vector<int> line;
+  unsigned state = seed;
+  int pitch = 4 * 14 + 4;
+  for (size_t i = 0; i < count; ++i) {
+    state = state * 1103515245U + 12345U;
+    pitch += static_cast<int>((state >> 16) % 9) - 4;
+    pitch = std::max(3 * 14, std::min(6 * 14, pitch));
+    line.push_back(pitch);
+  }
+  return line;
+}
+
+Note note_at(int absolute) {
+  return Note(Pitch(absolute % 14), absolute / 14, 480, false, 1, 1);
+}
+
+// Right hand only, four slices per measure
+Piece make_piece(const std::vector<int>& line) {
+  std::vector<Measure> measures;
+  std::vector<Slice> slices;
+  for (size_t i = 0; i < line.size(); ++i) {
+    if (i % 7 == 6) {
+      slices.emplace_back(std::vector<Note>{note_at(line[i]),
+                                            note_at(line[i] + 4)});
+    } else {
+      slices.emplace_back(std::vector<Note>{note_at(line[i])});
+    }
+    if (slices.size() == 4 || i + 1 == line.size()) {
+      measures.emplace_back(static_cast<int>(measures.size() + 1),
+                            std::move(slices), TimeSignature(4, 4));
+      slices = {};
+    }
+  }
+  return Piece(Metadata("Test", "Composer"), {}, std::move(measures));
+}
+
+class IncrementalTest : public ::testing::Test {
+ protected:
+  IncrementalTest() : evaluator_(make_medium_config()) {}
+
+  [[nodiscard]] double score(const EvalPiece& piece,
+                             const PackedFingeringSequence& fingerings) const {
+    return evaluator_.evaluate(piece, fingerings.unpack());
+  }
+
+  ScoreEvaluator evaluator_;
+};
+
+TEST_F(IncrementalTest, DiffFindsCommonPrefixAndSuffix) {
+  std::vector<int> line = make_line(40, 1);
+  const EvalPiece before(make_piece(line), Hand::kRight);
+  line[20] += 2;
+  line[22] += 2;
+  const EvalPiece after(make_piece(line), Hand::kRight);
+
+  const SliceDiff diff = diff_slices(before, after);
+  EXPECT_EQ(diff.prefix, 20U);
+  EXPECT_EQ(diff.suffix, 17U);
+}
+
+TEST_F(IncrementalTest, DiffOfIdenticalPiecesIsAllPrefix) {
+  const EvalPiece piece(make_piece(make_line(30, 2)), Hand::kRight);
+  const SliceDiff diff = diff_slices(piece, piece);
+  EXPECT_EQ(diff.prefix, 30U);
+  EXPECT_EQ(diff.suffix, 0U);
+}
+
+TEST_F(IncrementalTest, DiffOfInsertionNeverOverlaps) {
+  // Repeated pitches could match on both sides of the insertion
+  const std::vector<int> line(10, 60);
+  std::vector<int> longer = line;
+  longer.insert(longer.begin() + 5, 60);
+  const SliceDiff diff =
+      diff_slices(EvalPiece(make_piece(line), Hand::kRight),
+                  EvalPiece(make_piece(longer), Hand::kRight));
+  EXPECT_LE(diff.prefix + diff.suffix, line.size());
+}
+
+TEST_F(IncrementalTest, UnchangedPieceKeepsPreviousResult) {
+  const EvalPiece piece(make_piece(make_line(30, 3)), Hand::kRight);
+  const SearchResult previous = exact_search(evaluator_, piece);
+  const SearchResult result = refinger(evaluator_, piece, previous.fingerings,
+                                       previous.cost, piece);
+  ASSERT_EQ(result.fingerings.size(), previous.fingerings.size());
+  for (size_t s = 0; s < result.fingerings.size(); ++s) {
+    EXPECT_EQ(result.fingerings[s], previous.fingerings[s]);
+  }
+  EXPECT_DOUBLE_EQ(result.cost, previous.cost);
+}
+
+TEST_F(IncrementalTest, KeepsFingeringOutsideTheWindow) {
+  std::vector<int> line = make_line(80, 4);
+  const EvalPiece before(make_piece(line), Hand::kRight);
+  const SearchResult previous = exact_search(evaluator_, before);
+  line[40] += 3;
+  const EvalPiece after(make_piece(line), Hand::kRight);
+
+  constexpr size_t kMargin = 4;
+  const SearchResult result = refinger(evaluator_, before, previous.fingerings,
+                                       previous.cost, after, kMargin);
+  ASSERT_EQ(result.fingerings.size(), after.slice_count());
+  for (size_t s = 0; s < after.slice_count(); ++s) {
+    if (s < 40 - kMargin || s > 40 + kMargin) {
+      EXPECT_EQ(result.fingerings[s], previous.fingerings[s]) << "slice " << s;
+    }
+  }
+  EXPECT_NEAR(result.cost, score(after, result.fingerings), 1e-6);
+}
+
+TEST_F(IncrementalTest, WideMarginMatchesTheExactOptimum) {
+  std::vector<int> line = make_line(50, 5);
+  const EvalPiece before(make_piece(line), Hand::kRight);
+  const SearchResult previous = exact_search(evaluator_, before);
+  line[10] -= 5;
+  line[30] += 1;
+  const EvalPiece after(make_piece(line), Hand::kRight);
+
+  const SearchResult result = refinger(evaluator_, before, previous.fingerings,
+                                       previous.cost, after, 100);
+  EXPECT_NEAR(result.cost, exact_search(evaluator_, after).cost, 1e-6);
+}
+
+TEST_F(IncrementalTest, NeverWorseThanKeepingTheOldFingering) {
+  std::vector<int> line = make_line(60, 6);
+  const EvalPiece before(make_piece(line), Hand::kRight);
+  const SearchResult previous = exact_search(evaluator_, before);
+  line[25] += 7;
+  const EvalPiece after(make_piece(line), Hand::kRight);
+
+  const SearchResult result = refinger(evaluator_, before, previous.fingerings,
+                                       previous.cost, after, 0);
+  // The edit changes no slice size, so the old fingering still fits
+  EXPECT_LE(result.cost, score(after, previous.fingerings) + 1e-9);
+}
+
+TEST_F(IncrementalTest, HandlesInsertedAndDeletedSlices) {
+  const std::vector<int> line = make_line(60, 7);
+  const EvalPiece before(make_piece(line), Hand::kRight);
+  const SearchResult previous = exact_search(evaluator_, before);
+
+  std::vector<int> inserted = line;
+  inserted.insert(inserted.begin() + 30, {50, 52, 54});
+  const EvalPiece longer(make_piece(inserted), Hand::kRight);
+  const SearchResult grown = refinger(evaluator_, before, previous.fingerings,
+                                      previous.cost, longer);
+  ASSERT_EQ(grown.fingerings.size(), longer.slice_count());
+  EXPECT_NEAR(grown.cost, score(longer, grown.fingerings), 1e-6);
+
+  std::vector<int> deleted = line;
+  deleted.erase(deleted.begin() + 10, deleted.begin() + 15);
+  const EvalPiece shorter(make_piece(deleted), Hand::kRight);
+  const SearchResult shrunk = refinger(evaluator_, before, previous.fingerings,
+                                       previous.cost, shorter);
+  ASSERT_EQ(shrunk.fingerings.size(), shorter.slice_count());
+  EXPECT_NEAR(shrunk.cost, score(shorter, shrunk.fingerings), 1e-6);
+}
+
+TEST_F(IncrementalTest, EditAtTheEdges) {
+  std::vector<int> line = make_line(30, 8);
+  const EvalPiece before(make_piece(line), Hand::kRight);
+  const SearchResult previous = exact_search(evaluator_, before);
+  line.front() += 2;
+  line.back() -= 2;
+  const EvalPiece after(make_piece(line), Hand::kRight);
+
+  const SearchResult result = refinger(evaluator_, before, previous.fingerings,
+                                       previous.cost, after, 1);
+  EXPECT_NEAR(result.cost, score(after, result.fingerings), 1e-6);
+}
+
+TEST_F(IncrementalTest, RejectsMismatchedFingerings) {
+  const EvalPiece piece(make_piece(make_line(20, 9)), Hand::kRight);
+  EXPECT_THROW(static_cast<void>(refinger(evaluator_, piece,
+                                          PackedFingeringSequence{}, 0.0,
+                                          piece)),
+               std::invalid_argument);
+}
+
+TEST_F(IncrementalTest, OptimizerRefingersBothHands) {
+  std::vector<int> line = make_line(40, 10);
+  const Piece before = make_piece(line);
+  Optimizer optimizer(make_medium_config(), 2);
+  const auto previous = optimizer.optimize_piece(before, 1);
+  line[12] += 3;
+  const Piece after = make_piece(line);
+
+  const auto result = optimizer.refinger_piece(before, previous, after);
+  const EvalPiece right(after, Hand::kRight);
+  EXPECT_NEAR(result.right_hand.score,
+              score(right, result.right_hand.fingerings), 1e-6);
+  EXPECT_TRUE(result.left_hand.fingerings.empty());
+  EXPECT_DOUBLE_EQ(result.score,
+                   result.right_hand.score + result.left_hand.score);
+}
+
+}  // namespace
+}  // namespace piano_fingering::optimizer
@@ -0,0 +1,91 @@
+#include "optimizer/memory_budget.h"
+
+#include <gtest/gtest.h>
+
+#include <cstddef>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace piano_fingering::optimizer {
+namespace {
+
+TEST(MemoryBudgetTest, TracksCurrentAndPeak) {
+  MemoryBudget budget(100);
+  EXPECT_TRUE(budget.try_charge(60));
+  EXPECT_TRUE(budget.try_charge(30));
+  EXPECT_FALSE(budget.try_charge(11));
+  EXPECT_EQ(budget.current(), 90);
+  EXPECT_EQ(budget.available(), 10);
+
+  budget.release(50);
+  EXPECT_EQ(budget.current(), 40);
+  EXPECT_EQ(budget.peak(), 90);
+  EXPECT_FALSE(budget.try_charge(61));
+  EXPECT_TRUE(budget.try_charge(60));
+  EXPECT_EQ(budget.available(), 0);
+}
+
+TEST(MemoryBudgetTest, ChargeReleasesOnDestructionAndMove) {
+  MemoryBudget budget(100);
+  {
+    MemoryCharge first(&budget, 70, "First");
+    EXPECT_EQ(budget.current(), 70);
+    EXPECT_THROW(MemoryCharge(&budget, 31, "Second"), MemoryBudgetError);
+
+    MemoryCharge moved = std::move(first);
+    EXPECT_EQ(moved.bytes(), 70);
+    EXPECT_EQ(budget.current(), 70);
+    moved = MemoryCharge(&budget, 20, "Third");
+    EXPECT_EQ(budget.current(), 20);
+  }
+  EXPECT_EQ(budget.current(), 0);
+  EXPECT_EQ(budget.peak(), 90);
+
+  // Without a budget anything is granted
+  MemoryCharge unbudgeted(nullptr, 1U << 30, "Unbudgeted");
+  EXPECT_EQ(unbudgeted.bytes(), 0);
+}
+
+TEST(MemoryBudgetTest, ErrorNamesTheRequest) {
+  MemoryBudget budget(10);
+  try {
+    MemoryCharge charge(&budget, 11, "Beam arena");
+    FAIL() << "expected MemoryBudgetError";
+  } catch (const MemoryBudgetError& error) {
+    EXPECT_NE(std::string(error.what()).find("Beam arena needs 11 bytes"),
+              std::string::npos);
+  }
+}
+
+TEST(MemoryBudgetTest, ConcurrentChargesNeverExceedTheLimit) {
+  MemoryBudget budget(1000);
+  std::vector<std::thread> threads;
+  for (int t = 0; t < 4; ++t) {
+    threads.emplace_back([&budget] {
+      for (int i = 0; i < 10000; ++i) {
+        if (budget.try_charge(7)) {
+          budget.release(7);
+        }
+      }
+    });
+  }
+  for (std::thread& thread : threads) {
+    thread.join();
+  }
+  EXPECT_EQ(budget.current(), 0);
+  EXPECT_LE(budget.peak(), 1000);
+}
+
+TEST(MemoryBudgetTest, ReadsProcessRss) {
+#if defined(__linux__)
+  EXPECT_GT(current_rss_bytes(), 0);
+  EXPECT_GT(peak_rss_bytes(), 0);
+#else
+  GTEST_SKIP() << "RSS is only read on Linux";
+#endif
+}
+
+}  // namespace
+}  // namespace piano_fingering::optimizer
@@ -0,0 +1,439 @@
+#include "optimizer/optimizer.h"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <stop_token>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "config/config.h"
+#include "config/configuration_error.h"
+#include "config/preset.h"
+#include "domain/hand.h"
+#include "domain/measure.h"
+#include "domain/metadata.h"
+#include "domain/note.h"
+#include "domain/piece.h"
+#include "domain/pitch.h"
+#include "domain/slice.h"
+#include "evaluator/eval_piece.h"
+#include "optimizer/beam_search.h"
+#include "optimizer/ils.h"
+#include "optimizer/memory_budget.h"
+#include "optimizer/progress.h"
+#include "optimizer/result_cache.h"
+#include "optimizer/search_stats.h"
+#include "optimizer/thread_pool.h"
+#include "optimizer/worker_placement.h"
+
+namespace piano_fingering::optimizer {
+namespace {
+
+using config::Config;
+using domain::Hand;
+using domain::Measure;
+using domain::Metadata;
+using domain::Note;
+using domain::Piece;
+using domain::Pitch;
+using domain::Slice;
+using domain::TimeSignature;
+using evaluator::EvalPiece;
+
+Note make_note(int pitch_val, int octave) {
+  return Note(Pitch(pitch_val), octave, 480, false, 1, 1);
+}
+
+Config make_medium_config() {
+  Config config{};
+  config.right_hand = config::make_medium_right_hand();
+  config.left_hand = config::mirror_to_left_hand(config.right_hand);
+  config.weights = config::RuleWeights::defaults();
+  config.algorithm.beam_width = 20;
+  config.algorithm.ils_iterations = 50;
+  config.algorithm.ils_trajectories = 4;
+  return config;
+}
+
+// Pseudo-random melody with a chord every sixth slice
+Piece make_piece(size_t slice_count) {
+  std::vector<Slice> slices;
+  std::uint32_t seed = 9;
+  auto next_pitch = [&seed] {
+    seed = seed * 1103515245U + 12345U;
+    return static_cast<int>((seed >> 16) % 14);
+  };
+  for (size_t i = 0; i < slice_count; ++i) {
+    if (i % 6 == 5) {
+      slices.push_back(Slice({make_note(next_pitch(), 4),
+                              make_note(next_pitch(), 5)}));
+    } else {
+      slices.push_back(Slice({make_note(next_pitch(), 4)}));
+    }
+  }
+  return Piece(Metadata("Test", "Composer"), {},
+               {Measure(1, std::move(slices), TimeSignature(4, 4))});
+}
+
+// Both hands as measures of one slice sequence each
+Piece make_two_hand_piece(size_t right_slices, size_t left_slices) {
+  auto right = make_piece(right_slices).right_hand();
+  auto left = make_piece(left_slices).right_hand();
+  return Piece(Metadata("Test", "Composer"),
+               std::vector<Measure>(left.begin(), left.end()),
+               std::vector<Measure>(right.begin(), right.end()));
+}
+
+class OptimizerTest : public ::testing::Test {
+ protected:
+  Config config_ = make_medium_config();
+  Piece piece_ = make_piece(60);
+  EvalPiece compiled_{piece_, Hand::kRight};
+};
+
+TEST_F(OptimizerTest, RunsEveryTrajectoryToCompletion) {
+  Optimizer optimizer(config_, 2);
+  auto result = optimizer.optimize(piece_, Hand::kRight, 1);
+
+  ASSERT_EQ(result.fingerings.size(), compiled_.slice_count());
+  EXPECT_FALSE(result.fingerings.violates_hard_constraint());
+  EXPECT_NEAR(result.score,
+              optimizer.evaluator().evaluate(compiled_, result.fingerings),
+              1e-9);
+  EXPECT_EQ(result.iterations_performed, 200);
+
+  auto again = optimizer.optimize(piece_, Hand::kRight, 1);
+  EXPECT_EQ(again.fingerings, result.fingerings);
+  EXPECT_DOUBLE_EQ(again.score, result.score);
+}
+
+TEST_F(OptimizerTest, CountsEvaluationsAndSearchWork) {
+  Optimizer optimizer(config_, 2);
+  const auto result = optimizer.optimize(piece_, Hand::kRight, 1);
+  const SearchStats& stats = result.stats;
+
+  // Two full scores per trajectory, and every ILS move is scored first
+  EXPECT_EQ(stats.full_evaluations, 2 * config_.algorithm.ils_trajectories);
+  EXPECT_GE(stats.delta_evaluations, stats.ils_moves);
+  EXPECT_EQ(stats.ils_iterations, result.iterations_performed);
+  EXPECT_LE(stats.ils_improvements, stats.ils_iterations);
+
+  EXPECT_GT(stats.beam_slices, 0);
+  EXPECT_LE(stats.beam_slices, compiled_.slice_count());
+  EXPECT_LE(stats.beam_kept, stats.beam_capacity);
+  EXPECT_EQ(stats.beam_kept + stats.beam_bound_pruned +
+                stats.beam_width_pruned,
+            stats.beam_children);
+  EXPECT_EQ(stats.result_cache_hits + stats.result_cache_misses, 0);
+
+  // A slot per worker plus the caller, with someone doing the work
+  ASSERT_EQ(stats.thread_busy.size(), 3);
+  EXPECT_GT(stats.busy().count(), 0);
+  EXPECT_GT(stats.wall.count(), 0);
+
+  const auto piece = optimizer.optimize_piece(piece_, 1);
+  EXPECT_EQ(piece.stats.ils_iterations, piece.iterations_performed);
+  EXPECT_EQ(piece.stats.full_evaluations,
+            piece.right_hand.stats.full_evaluations +
+                piece.left_hand.stats.full_evaluations);
+}
+
+TEST_F(OptimizerTest, StatesPerSliceSelectsAdaptiveBeam) {
+  config_.algorithm.beam_states_per_slice = 4;
+  Optimizer optimizer(config_, 2);
+
+  // No ILS iteration runs, so the score is the adaptive beam's
+  std::stop_source stopped;
+  stopped.request_stop();
+  Optimizer::Limits cancelled;
+  cancelled.stop_token = stopped.get_token();
+  auto result = optimizer.optimize(piece_, Hand::kRight, 1, cancelled);
+  const auto beam = beam_search(optimizer.evaluator(), compiled_,
+                                BeamBudget{config_.algorithm.beam_width,
+                                           4 * compiled_.slice_count()});
+  EXPECT_EQ(result.fingerings, beam.fingerings);
+  EXPECT_DOUBLE_EQ(result.score, beam.cost);
+}
+
+TEST_F(OptimizerTest, ExpiredLimitsReturnTheBeamResult) {
+  Optimizer optimizer(config_, 2);
+
+  std::stop_source stopped;
+  stopped.request_stop();
+  Optimizer::Limits cancelled;
+  cancelled.stop_token = stopped.get_token();
+  auto result = optimizer.optimize(piece_, Hand::kRight, 1, cancelled);
+  EXPECT_EQ(result.iterations_performed, 0);
+  EXPECT_NEAR(result.score,
+              optimizer.evaluator().evaluate(compiled_, result.fingerings),
+              1e-9);
+
+  Optimizer::Limits late;
+  late.deadline = Optimizer::Clock::now();
+  EXPECT_EQ(optimizer.optimize(piece_, Hand::kRight, 1, late)
+                .iterations_performed,
+            0);
+}
+
+TEST_F(OptimizerTest, CancellationStopsLongRunPromptly) {
+  config_.algorithm.ils_iterations = 1'000'000'000;
+  Optimizer optimizer(config_, 2);
+
+  std::stop_source source;
+  std::thread canceller([&source] {
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    source.request_stop();
+  });
+  Optimizer::Limits limits;
+  limits.stop_token = source.get_token();
+  const auto start = Optimizer::Clock::now();
+  auto result = optimizer.optimize(piece_, Hand::kRight, 1, limits);
+  const auto elapsed = Optimizer::Clock::now() - start;
+  canceller.join();
+
+  EXPECT_LT(elapsed, std::chrono::seconds(2));
+  EXPECT_GT(result.iterations_performed, 0);
+  EXPECT_LT(result.iterations_performed, 2'000'000'000);
+  EXPECT_NEAR(result.score,
+              optimizer.evaluator().evaluate(compiled_, result.fingerings),
+              1e-9);
+}
+
+TEST_F(OptimizerTest, DeadlineBoundsRunTime) {
+  config_.algorithm.ils_iterations = 1'000'000'000;
+  Optimizer optimizer(config_, 2);
+
+  Optimizer::Limits limits;
+  limits.deadline = Optimizer::Clock::now() + std::chrono::milliseconds(30);
+  auto result = optimizer.optimize(piece_, Hand::kRight, 1, limits);
+  EXPECT_LE(Optimizer::Clock::now(),
+            *limits.deadline + std::chrono::seconds(2));
+  EXPECT_GT(result.iterations_performed, 0);
+}
+
+TEST_F(OptimizerTest, OptimizePieceCoversBothHands) {
+  Optimizer optimizer(config_, 4);
+  const Piece piece = make_two_hand_piece(40, 40);
+  auto result = optimizer.optimize_piece(piece, 3);
+
+  const EvalPiece right(piece, Hand::kRight);
+  const EvalPiece left(piece, Hand::kLeft);
+  ASSERT_EQ(result.right_hand.fingerings.size(), right.slice_count());
+  ASSERT_EQ(result.left_hand.fingerings.size(), left.slice_count());
+  EXPECT_NEAR(result.right_hand.score,
+              optimizer.evaluator().evaluate(right,
+                                             result.right_hand.fingerings),
+              1e-9);
+  EXPECT_NEAR(result.left_hand.score,
+              optimizer.evaluator().evaluate(left, result.left_hand.fingerings),
+              1e-9);
+  EXPECT_DOUBLE_EQ(result.score,
+                   result.right_hand.score + result.left_hand.score);
+  EXPECT_EQ(result.right_hand.iterations_performed, 200);
+  EXPECT_EQ(result.left_hand.iterations_performed, 200);
+  EXPECT_EQ(result.iterations_performed, 400);
+}
+
+TEST_F(OptimizerTest, OptimizePieceMatchesPerHandOptimize) {
+  Optimizer optimizer(config_, 4);
+  const Piece piece = make_two_hand_piece(30, 50);
+  auto whole = optimizer.optimize_piece(piece, 5);
+  auto right = optimizer.optimize(piece, Hand::kRight, 5);
+  auto left = optimizer.optimize(piece, Hand::kLeft, 5);
+
+  EXPECT_EQ(whole.right_hand.fingerings, right.fingerings);
+  EXPECT_EQ(whole.left_hand.fingerings, left.fingerings);
+  EXPECT_DOUBLE_EQ(whole.score, right.score + left.score);
+}
+
+TEST_F(OptimizerTest, ResultDoesNotDependOnThreadCount) {
+  Optimizer serial(config_, 1);
+  Optimizer parallel(config_, 3);
+  auto one = serial.optimize(piece_, Hand::kRight, 9);
+  auto three = parallel.optimize(piece_, Hand::kRight, 9);
+
+  EXPECT_EQ(one.fingerings, three.fingerings);
+  EXPECT_EQ(one.score, three.score);
+  EXPECT_EQ(one.iterations_performed, three.iterations_performed);
+}
+
+TEST_F(OptimizerTest, PlacementAndReplicasKeepTheResult) {
+  Optimizer plain(config_, 3);
+  const auto expected = plain.optimize_piece(make_two_hand_piece(40, 30), 6);
+
+  // Two nodes on one allowed CPU, so replicas are built on any machine
+  WorkerPlacement placement;
+  placement.pin_workers = true;
+  placement.arena_bytes = 1 << 16;
+  placement.replicate_per_node = true;
+  const CpuTopology detected = CpuTopology::detect();
+  if (!detected.empty()) {
+    const unsigned cpu = detected.cpus(0).front();
+    placement.topology = CpuTopology({{cpu}, {cpu}});
+  }
+  Optimizer placed(config_, 3, placement);
+  const auto result = placed.optimize_piece(make_two_hand_piece(40, 30), 6);
+
+  EXPECT_EQ(result.right_hand.fingerings, expected.right_hand.fingerings);
+  EXPECT_EQ(result.left_hand.fingerings, expected.left_hand.fingerings);
+  EXPECT_EQ(result.score, expected.score);
+  EXPECT_EQ(result.iterations_performed, expected.iterations_performed);
+}
+
+TEST_F(OptimizerTest, SharedPoolServesConcurrentCallers) {
+  ThreadPool pool(3);
+  Optimizer shared(config_, pool);
+  Config other = config_;
+  other.algorithm.ils_iterations = 10;
+  Optimizer second(other, pool);
+  Optimizer owned(config_, 2);
+  const auto expected = owned.optimize(piece_, Hand::kRight, 4);
+
+  std::vector<Optimizer::Result> results(4);
+  {
+    std::vector<std::jthread> callers;
+    for (size_t i = 0; i < results.size(); ++i) {
+      callers.emplace_back([&, i] {
+        results[i] = (i % 2 == 0 ? shared : second)
+                         .optimize(piece_, Hand::kRight, 4);
+      });
+    }
+  }
+  EXPECT_EQ(results[0].fingerings, expected.fingerings);
+  EXPECT_EQ(results[2].fingerings, expected.fingerings);
+  EXPECT_EQ(results[1].iterations_performed, 40);
+}
+
+TEST_F(OptimizerTest, ResultCacheReturnsStoredHands) {
+  Optimizer optimizer(config_, 2);
+  const Piece piece = make_two_hand_piece(30, 40);
+  const auto fresh = optimizer.optimize_piece(piece, 3);
+
+  ResultCache cache(1U << 20);
+  Optimizer::Limits limits;
+  limits.cache = &cache;
+  const auto first = optimizer.optimize_piece(piece, 3, limits);
+  EXPECT_EQ(cache.size(), 2);
+  EXPECT_EQ(cache.misses(), 2);
+
+  // Another optimizer with the same config, and the per-hand entry point,
+  // share the entries
+  Optimizer other(config_, 1);
+  const auto again = other.optimize_piece(piece, 3, limits);
+  const auto right = other.optimize(piece, Hand::kRight, 3, limits);
+  EXPECT_EQ(cache.hits(), 3);
+  EXPECT_EQ(first.stats.result_cache_misses, 2);
+  EXPECT_EQ(again.stats.result_cache_hits, 2);
+  EXPECT_EQ(again.stats.evaluations(), 0);
+  EXPECT_EQ(again.right_hand.fingerings, fresh.right_hand.fingerings);
+  EXPECT_EQ(again.left_hand.fingerings, fresh.left_hand.fingerings);
+  EXPECT_DOUBLE_EQ(again.score, first.score);
+  EXPECT_EQ(right.fingerings, fresh.right_hand.fingerings);
+
+  (void)optimizer.optimize(piece, Hand::kRight, 4, limits);
+  Config changed = config_;
+  changed.weights.values[0] += 1.0;
+  Optimizer reweighted(changed, 1);
+  (void)reweighted.optimize(piece, Hand::kRight, 3, limits);
+  EXPECT_EQ(cache.size(), 4);
+}
+
+TEST_F(OptimizerTest, LimitedRunsAreNotCached) {
+  Optimizer optimizer(config_, 2);
+  ResultCache cache(1U << 20);
+  std::stop_source stopped;
+  stopped.request_stop();
+  Optimizer::Limits limits;
+  limits.cache = &cache;
+  limits.stop_token = stopped.get_token();
+  (void)optimizer.optimize(piece_, Hand::kRight, 1, limits);
+  EXPECT_EQ(cache.size(), 0);
+
+  // A full result stored earlier still serves a limited request
+  Optimizer::Limits unlimited;
+  unlimited.cache = &cache;
+  const auto full = optimizer.optimize(piece_, Hand::kRight, 1, unlimited);
+  const auto cached = optimizer.optimize(piece_, Hand::kRight, 1, limits);
+  EXPECT_EQ(cached.fingerings, full.fingerings);
+  EXPECT_EQ(cached.iterations_performed, full.iterations_performed);
+}
+
+TEST_F(OptimizerTest, PublishesProgressForEachHand) {
+  Optimizer optimizer(config_, 2);
+  ProgressChannel channel;
+  Optimizer::Limits limits;
+  limits.progress = &channel;
+  const Piece piece = make_two_hand_piece(30, 40);
+  const auto result = optimizer.optimize_piece(piece, 1, limits);
+
+  std::vector<ProgressEvent> starts;
+  std::vector<ProgressEvent> ends;
+  std::uint64_t iterations = 0;
+  ProgressEvent event;
+  while (channel.consume(event)) {
+    switch (event.phase) {
+      case ProgressPhase::kBeamSearch:
+        starts.push_back(event);
+        break;
+      case ProgressPhase::kLocalSearch:
+        iterations += event.iterations;
+        break;
+      case ProgressPhase::kComplete:
+        ends.push_back(event);
+        break;
+    }
+  }
+  ASSERT_EQ(starts.size(), 2);
+  ASSERT_EQ(ends.size(), 2);
+  EXPECT_EQ(starts[0].iterations, 200);
+  EXPECT_EQ(starts[0].measures, 1);
+  EXPECT_EQ(iterations, result.iterations_performed);
+  EXPECT_EQ(ends[0].iterations + ends[1].iterations,
+            result.iterations_performed);
+  EXPECT_EQ(channel.dropped(), 0);
+}
+
+TEST_F(OptimizerTest, MemoryBudgetLimitsConcurrentSessions) {
+  Optimizer optimizer(config_, 4);
+  const auto unlimited = optimizer.optimize(piece_, Hand::kRight, 2);
+
+  // Room for the beam and one ILS session at a time: same result
+  MemoryBudget probe(64U << 20);
+  ThreadPool pool(1);
+  (void)beam_search(optimizer.evaluator(), compiled_,
+                    config_.algorithm.beam_width, pool, &probe);
+  MemoryBudget budget(std::max(probe.peak(), ils_session_bytes(compiled_)));
+  Optimizer::Limits limits;
+  limits.memory = &budget;
+  const auto limited = optimizer.optimize(piece_, Hand::kRight, 2, limits);
+  EXPECT_EQ(limited.fingerings, unlimited.fingerings);
+  EXPECT_EQ(limited.iterations_performed, unlimited.iterations_performed);
+  EXPECT_LE(budget.peak(), budget.limit());
+  EXPECT_EQ(budget.current(), 0);
+
+  MemoryBudget starved(64);
+  limits.memory = &starved;
+  EXPECT_THROW(
+      {
+        [[maybe_unused]] auto r =
+            optimizer.optimize(piece_, Hand::kRight, 2, limits);
+      },
+      MemoryBudgetError);
+}
+
+TEST_F(OptimizerTest, EmptyHandAndInvalidConfig) {
+  Optimizer optimizer(config_, 1);
+  auto result = optimizer.optimize(piece_, Hand::kLeft, 1);
+  EXPECT_TRUE(result.fingerings.empty());
+  EXPECT_EQ(result.iterations_performed, 0);
+
+  config_.algorithm.beam_width = 0;
+  EXPECT_THROW(Optimizer invalid(config_), config::ConfigurationError);
+}
+
+}  // namespace
+}  // namespace piano_fingering::optimizer
@@ -0,0 +1,91 @@
+#include "optimizer/progress.h"
+
+#include <gtest/gtest.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+namespace piano_fingering::optimizer {
+namespace {
+
+ProgressEvent iterations(std::uint64_t count) {
+  return {ProgressPhase::kLocalSearch, domain::Hand::kRight, 0, count};
+}
+
+TEST(ProgressChannelTest, DeliversInOrderAndRoundsCapacity) {
+  ProgressChannel channel(3);
+  EXPECT_EQ(channel.capacity(), 4);
+  ProgressEvent event;
+  EXPECT_FALSE(channel.consume(event));
+
+  for (std::uint64_t lap = 0; lap < 3; ++lap) {
+    for (std::uint64_t i = 0; i < 4; ++i) {
+      EXPECT_TRUE(channel.publish(iterations(lap * 4 + i)));
+    }
+    for (std::uint64_t i = 0; i < 4; ++i) {
+      ASSERT_TRUE(channel.consume(event));
+      EXPECT_EQ(event.iterations, lap * 4 + i);
+    }
+    EXPECT_FALSE(channel.consume(event));
+  }
+  EXPECT_THROW(ProgressChannel(0), std::invalid_argument);
+}
+
+TEST(ProgressChannelTest, FullChannelDropsWithoutBlocking) {
+  ProgressChannel channel(2);
+  EXPECT_TRUE(channel.publish(iterations(1)));
+  EXPECT_TRUE(channel.publish(iterations(2)));
+  EXPECT_FALSE(channel.publish(iterations(3)));
+  EXPECT_EQ(channel.dropped(), 1);
+
+  ProgressEvent event;
+  ASSERT_TRUE(channel.consume(event));
+  EXPECT_EQ(event.iterations, 1);
+  EXPECT_TRUE(channel.publish(iterations(4)));
+  ASSERT_TRUE(channel.consume(event));
+  EXPECT_EQ(event.iterations, 2);
+  ASSERT_TRUE(channel.consume(event));
+  EXPECT_EQ(event.iterations, 4);
+}
+
+TEST(ProgressChannelTest, ConcurrentProducersLoseNothingDelivered) {
+  constexpr std::uint64_t kPerThread = 20000;
+  ProgressChannel channel(64);
+  std::uint64_t received = 0;
+  std::uint64_t sum = 0;
+  {
+    std::vector<std::jthread> producers;
+    for (int t = 0; t < 4; ++t) {
+      producers.emplace_back([&] {
+        for (std::uint64_t i = 0; i < kPerThread; ++i) {
+          (void)channel.publish(iterations(1));
+        }
+      });
+    }
+    std::jthread consumer([&](const std::stop_token& stop) {
+      ProgressEvent event;
+      for (;;) {
+        // Read before consuming, so events published before the stop are
+        // all drained
+        const bool stopping = stop.stop_requested();
+        if (channel.consume(event)) {
+          ++received;
+          sum += event.iterations;
+        } else if (stopping) {
+          break;
+        }
+      }
+    });
+    for (auto& producer : producers) {
+      producer.join();
+    }
+  }
+  EXPECT_EQ(sum, received);
+  EXPECT_EQ(received + channel.dropped(), 4 * kPerThread);
+}
+
+}  // namespace
+}  // namespace piano_fingering::optimizer
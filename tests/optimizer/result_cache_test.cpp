@@ -0,0 +1,146 @@
+#include "optimizer/result_cache.h"
+
+#include <gtest/gtest.h>
+
+#include <cstddef>
+#include <thread>
+#include <vector>
+
+#include "domain/hand.h"
+#include "domain/measure.h"
+#include "domain/metadata.h"
+#include "domain/note.h"
+#include "domain/packed_fingering.h"
+#include "domain/piece.h"
+#include "domain/pitch.h"
+#include "domain/slice.h"
+#include "evaluator/eval_piece.h"
+
+namespace piano_fingering::optimizer {
+namespace {
+
+using domain::Hand;
+using domain::Measure;
+using domain::Metadata;
+using domain::Note;
+using domain::Piece;
+using domain::Pitch;
+using domain::Slice;
+using domain::TimeSignature;
+using evaluator::EvalPiece;
+
+Piece make_piece(const std::vector<int>& pitches, const char* title) {
+  std::vector<Slice> slices;
+  for (const int pitch : pitches) {
+    slices.push_back(Slice({Note(Pitch(pitch), 4, 480, false, 1, 1)}));
+  }
+  return Piece(Metadata(title, "Composer"), {},
+               {Measure(1, std::move(slices), TimeSignature(4, 4))});
+}
+
+CachedResult make_result(size_t slices, double score) {
+  CachedResult result;
+  for (size_t s = 0; s < slices; ++s) {
+    result.fingerings.push_back(domain::PackedFingering::from_bits(1), 1);
+  }
+  result.score = score;
+  return result;
+}
+
+ResultKey make_key(std::uint64_t piece) {
+  ResultKey key;
+  key.piece = piece;
+  return key;
+}
+
+TEST(ResultCacheTest, FingerprintCoversNotesOnly) {
+  const EvalPiece scale(make_piece({0, 2, 4, 5}, "A"), Hand::kRight);
+  const EvalPiece renamed(make_piece({0, 2, 4, 5}, "B"), Hand::kRight);
+  const EvalPiece changed(make_piece({0, 2, 4, 6}, "A"), Hand::kRight);
+  EXPECT_EQ(fingerprint(scale), fingerprint(renamed));
+  EXPECT_NE(fingerprint(scale), fingerprint(changed));
+}
+
+TEST(ResultCacheTest, KeysDifferInEveryField) {
+  const ResultKey base = make_key(1);
+  ResultKey seed = base;
+  seed.seed = 2;
+  ResultKey hand = base;
+  hand.hand = Hand::kLeft;
+  ResultKey config = base;
+  config.config.algorithm.ils_iterations = 7;
+
+  ResultCache cache(1U << 20);
+  cache.insert(base, make_result(4, 1.0));
+  EXPECT_TRUE(cache.find(base).has_value());
+  EXPECT_FALSE(cache.find(seed).has_value());
+  EXPECT_FALSE(cache.find(hand).has_value());
+  EXPECT_FALSE(cache.find(config).has_value());
+  EXPECT_EQ(cache.hits(), 1);
+  EXPECT_EQ(cache.misses(), 3);
+  EXPECT_NE(ResultKeyHash{}(base), ResultKeyHash{}(config));
+}
+
+TEST(ResultCacheTest, EvictsLeastRecentlyUsed) {
+  const CachedResult result = make_result(16, 2.0);
+  ResultCache probe(1U << 20);
+  probe.insert(make_key(0), result);
+  const size_t entry = probe.bytes();
+
+  ResultCache cache(3 * entry);
+  cache.insert(make_key(1), result);
+  cache.insert(make_key(2), result);
+  cache.insert(make_key(3), result);
+  ASSERT_TRUE(cache.find(make_key(1)).has_value());
+  cache.insert(make_key(4), result);
+
+  EXPECT_EQ(cache.size(), 3);
+  EXPECT_EQ(cache.bytes(), 3 * entry);
+  EXPECT_TRUE(cache.find(make_key(1)).has_value());
+  EXPECT_FALSE(cache.find(make_key(2)).has_value());
+  EXPECT_TRUE(cache.find(make_key(4)).has_value());
+
+  // Replacing an entry keeps one copy
+  cache.insert(make_key(4), make_result(16, 3.0));
+  EXPECT_EQ(cache.size(), 3);
+  EXPECT_DOUBLE_EQ(cache.find(make_key(4))->score, 3.0);
+
+  cache.clear();
+  EXPECT_EQ(cache.size(), 0);
+  EXPECT_EQ(cache.bytes(), 0);
+}
+
+TEST(ResultCacheTest, OversizedEntriesAreNotKept) {
+  ResultCache disabled(0);
+  disabled.insert(make_key(1), make_result(1, 1.0));
+  EXPECT_EQ(disabled.size(), 0);
+
+  ResultCache cache(1U << 20);
+  cache.insert(make_key(1), make_result(1, 1.0));
+  cache.insert(make_key(2), make_result(1U << 20, 1.0));
+  EXPECT_EQ(cache.size(), 1);
+  EXPECT_TRUE(cache.find(make_key(1)).has_value());
+}
+
+TEST(ResultCacheTest, ConcurrentInsertsStayWithinLimit) {
+  const CachedResult result = make_result(8, 1.0);
+  ResultCache probe(1U << 20);
+  probe.insert(make_key(0), result);
+  ResultCache cache(10 * probe.bytes());
+  {
+    std::vector<std::jthread> threads;
+    for (std::uint64_t t = 0; t < 4; ++t) {
+      threads.emplace_back([&, t] {
+        for (std::uint64_t i = 0; i < 100; ++i) {
+          cache.insert(make_key(t * 1000 + i), result);
+          (void)cache.find(make_key(t * 1000 + i / 2));
+        }
+      });
+    }
+  }
+  EXPECT_EQ(cache.size(), 10);
+  EXPECT_LE(cache.bytes(), cache.limit());
+}
+
+}  // namespace
+}  // namespace piano_fingering::optimizer
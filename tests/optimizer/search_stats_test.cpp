@@ -0,0 +1,71 @@
+#include "optimizer/search_stats.h"
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <thread>
+
+#include "optimizer/thread_pool.h"
+
+namespace piano_fingering::optimizer {
+namespace {
+
+using std::chrono::nanoseconds;
+
+TEST(SearchStatsTest, SumsCountersAndBusyTimePerThread) {
+  SearchStats a;
+  a.full_evaluations = 2;
+  a.delta_evaluations = 10;
+  a.beam_kept = 3;
+  a.thread_busy = {nanoseconds(5)};
+  a.wall = nanoseconds(7);
+  SearchStats b;
+  b.full_evaluations = 1;
+  b.ils_moves = 4;
+  b.ils_tabu_revisits = 6;
+  b.thread_busy = {nanoseconds(1), nanoseconds(2)};
+  b.wall = nanoseconds(3);
+
+  a += b;
+  EXPECT_EQ(a.full_evaluations, 3);
+  EXPECT_EQ(a.evaluations(), 13);
+  EXPECT_EQ(a.beam_kept, 3);
+  EXPECT_EQ(a.ils_moves, 4);
+  EXPECT_EQ(a.ils_tabu_revisits, 6);
+  ASSERT_EQ(a.thread_busy.size(), 2);
+  EXPECT_EQ(a.thread_busy[0], nanoseconds(6));
+  EXPECT_EQ(a.thread_busy[1], nanoseconds(2));
+  EXPECT_EQ(a.busy(), nanoseconds(8));
+  EXPECT_EQ(a.wall, nanoseconds(10));
+}
+
+TEST(ThreadStatsTest, EachThreadCountsIntoItsOwnSlot) {
+  ThreadPool pool(3);
+  ThreadStats stats(pool);
+  constexpr size_t kTasks = 64;
+  parallel_for(pool, 0, kTasks, [&](size_t) {
+    const ThreadStats::BusyTimer busy(&stats);
+    ++stats.local().ils_iterations;
+    std::this_thread::sleep_for(std::chrono::microseconds(50));
+  });
+  ++stats.local().full_evaluations;
+
+  const SearchStats total = stats.merged();
+  EXPECT_EQ(total.ils_iterations, kTasks);
+  EXPECT_EQ(total.full_evaluations, 1);
+  // Workers first, then the calling thread
+  ASSERT_EQ(total.thread_busy.size(), pool.thread_count() + 1);
+  EXPECT_GE(total.busy(), std::chrono::microseconds(50 * kTasks));
+}
+
+TEST(ThreadStatsTest, NullTimerRecordsNothing) {
+  const ThreadStats::BusyTimer busy(nullptr);
+  ThreadPool pool(1);
+  EXPECT_EQ(pool.current_worker(), pool.thread_count());
+  EXPECT_EQ(ThreadStats(pool).merged().busy(), nanoseconds(0));
+}
+
+}  // namespace
+}  // namespace piano_fingering::optimizer
@@ -0,0 +1,201 @@
+#include "optimizer/segmented_search.h"
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+#include "config/config.h"
+#include "config/preset.h"
+#include "domain/hand.h"
+#include "domain/measure.h"
+#include "domain/metadata.h"
+#include "domain/note.h"
+#include "domain/piece.h"
+#include "domain/pitch.h"
+#include "domain/slice.h"
+#include "evaluator/eval_piece.h"
+#include "evaluator/score_evaluator.h"
+#include "optimizer/exact_search.h"
+#include "optimizer/thread_pool.h"
+
+namespace piano_fingering::optimizer {
+namespace {
+
+using config::Config;
+using domain::Hand;
+using domain::Measure;
+using domain::Metadata;
+using domain::Note;
+using domain::Piece;
+using domain::Pitch;
+using domain::Slice;
+using domain::TimeSignature;
+using evaluator::EvalPiece;
+using evaluator::ScoreEvaluator;
+
+Note make_note(int pitch_val, int octave) {
+  return Note(Pitch(pitch_val), octave, 480, false, 1, 1);
+}
+
+Note make_rest() { return Note(Pitch(0), 4, 480, true, 1, 1); }
+
+Config make_medium_config() {
+  Config config{};
+  config.right_hand = config::make_medium_right_hand();
+  config.left_hand = config::mirror_to_left_hand(config.right_hand);
+  config.weights = config::RuleWeights::defaults();
+  return config;
+}
+
+// Measures of eight slices; a rest every `rest_every` slices and a chord
+// every ninth
+Piece make_piece(size_t measure_count, size_t rest_every) {
+  std::vector<Measure> measures;
+  std::uint32_t seed = 5;
+  auto next_pitch = [&seed] {
+    seed = seed * 1103515245U + 12345U;
+    return static_cast<int>((seed >> 16) % 14);
+  };
+  size_t position = 0;
+  for (size_t m = 0; m < measure_count; ++m) {
+    std::vector<Slice> slices;
+    for (size_t k = 0; k < 8; ++k, ++position) {
+      if (position % rest_every == rest_every - 1) {
+        slices.push_back(Slice({make_rest()}));
+      } else if (position % 9 == 4) {
+        slices.push_back(Slice({make_note(next_pitch(), 4),
+                                make_note(next_pitch(), 5)}));
+      } else {
+        slices.push_back(Slice({make_note(next_pitch(), 4)}));
+      }
+    }
+    measures.emplace_back(static_cast<int>(m + 1), std::move(slices),
+                          TimeSignature(4, 4));
+  }
+  return Piece(Metadata("Test", "Composer"), {}, std::move(measures));
+}
+
+// One measure per figure, each figure followed by a rest: a figure, the
+// same an octave up, a variant with one note moved, then the figure again
+Piece make_repeated_piece() {
+  const std::vector<int> figure = {0, 4, 7, 11, 9, 2, 6, 1};
+  std::vector<Measure> measures;
+  for (int m = 0; m < 4; ++m) {
+    const int octave = m == 1 ? 5 : 4;
+    std::vector<Slice> slices;
+    for (size_t k = 0; k < figure.size(); ++k) {
+      const int pitch = (m == 2 && k == 3) ? 13 : figure[k];
+      if (k == 4) {
+        slices.push_back(Slice({make_note(pitch, octave),
+                                make_note(pitch, octave + 1)}));
+      } else {
+        slices.push_back(Slice({make_note(pitch, octave)}));
+      }
+    }
+    slices.push_back(Slice({make_rest()}));
+    measures.emplace_back(m + 1, std::move(slices), TimeSignature(4, 4));
+  }
+  return Piece(Metadata("Test", "Composer"), {}, std::move(measures));
+}
+
+class SegmentedSearchTest : public ::testing::Test {
+ protected:
+  Config config_ = make_medium_config();
+  ScoreEvaluator evaluator_{config_};
+  ThreadPool pool_{4};
+};
+
+TEST_F(SegmentedSearchTest, SplitsAtRestsThenMeasures) {
+  // Rests after playable slices 4, 9, 14, ... (every sixth source slice)
+  const Piece piece = make_piece(4, 6);
+  const EvalPiece compiled(piece, Hand::kRight);
+  ASSERT_EQ(compiled.slice_count(), 27);
+
+  auto segments = split_segments(compiled, 8);
+  ASSERT_EQ(segments.size(), 3);
+  EXPECT_EQ(segments[0].begin, 0);
+  EXPECT_EQ(segments[0].end, 10);
+  EXPECT_EQ(segments[1].begin, 10);
+  EXPECT_EQ(segments[1].end, 20);
+  EXPECT_EQ(segments[2].end, 27);
+
+  // Without rests, cut at the first bar line once twice the minimum is met
+  const Piece legato = make_piece(4, 1000);
+  const EvalPiece legato_compiled(legato, Hand::kRight);
+  segments = split_segments(legato_compiled, 5);
+  ASSERT_EQ(segments.size(), 2);
+  EXPECT_EQ(segments[0].end, 16);
+
+  EXPECT_THROW(
+      { [[maybe_unused]] auto s = split_segments(compiled, 0); },
+      std::invalid_argument);
+  const EvalPiece empty(piece, Hand::kLeft);
+  EXPECT_TRUE(split_segments(empty, 4).empty());
+}
+
+TEST_F(SegmentedSearchTest, CostIsExactScoreOfStitchedResult) {
+  const Piece piece = make_piece(12, 7);
+  const EvalPiece compiled(piece, Hand::kRight);
+
+  // Minimum length 1 cuts at every rest, including one-slice segments
+  for (size_t min_length : {1, 3, 16}) {
+    SegmentOptions options;
+    options.min_segment_slices = min_length;
+    auto result = segmented_search(evaluator_, compiled, pool_, options);
+    ASSERT_EQ(result.fingerings.size(), compiled.slice_count());
+    EXPECT_FALSE(result.fingerings.violates_hard_constraint());
+    EXPECT_NEAR(result.cost, evaluator_.evaluate(compiled, result.fingerings),
+                1e-9)
+        << "min length " << min_length;
+    EXPECT_GE(result.cost, exact_search(evaluator_, compiled).cost - 1e-9);
+  }
+
+  SegmentOptions beam;
+  beam.min_segment_slices = 8;
+  beam.beam_width = 20;
+  auto result = segmented_search(evaluator_, compiled, pool_, beam);
+  EXPECT_NEAR(result.cost, evaluator_.evaluate(compiled, result.fingerings),
+              1e-9);
+}
+
+TEST_F(SegmentedSearchTest, SingleSegmentMatchesExactSearch) {
+  const Piece piece = make_piece(3, 1000);
+  const EvalPiece compiled(piece, Hand::kRight);
+
+  auto segmented = segmented_search(evaluator_, compiled, pool_);
+  auto exact = exact_search(evaluator_, compiled);
+  EXPECT_EQ(segmented.fingerings, exact.fingerings);
+  EXPECT_DOUBLE_EQ(segmented.cost, exact.cost);
+}
+
+TEST_F(SegmentedSearchTest, FindsTransposedRepeats) {
+  const EvalPiece compiled(make_repeated_piece(), Hand::kRight);
+  const auto segments = split_segments(compiled, 4);
+  ASSERT_EQ(segments.size(), 4U);
+  const std::vector<size_t> expected = {0, 0, 2, 0};
+  EXPECT_EQ(segment_repeats(compiled, segments), expected);
+}
+
+TEST_F(SegmentedSearchTest, ReusingRepeatsChangesNothing) {
+  const EvalPiece compiled(make_repeated_piece(), Hand::kRight);
+  SegmentOptions reuse;
+  reuse.min_segment_slices = 4;
+  SegmentOptions fresh = reuse;
+  fresh.reuse_repeats = false;
+
+  const auto reused = segmented_search(evaluator_, compiled, pool_, reuse);
+  const auto solved = segmented_search(evaluator_, compiled, pool_, fresh);
+  EXPECT_DOUBLE_EQ(reused.cost, solved.cost);
+  ASSERT_EQ(reused.fingerings.size(), solved.fingerings.size());
+  for (size_t s = 0; s < solved.fingerings.size(); ++s) {
+    EXPECT_EQ(reused.fingerings[s], solved.fingerings[s]) << "slice " << s;
+  }
+  EXPECT_NEAR(reused.cost, evaluator_.evaluate(compiled, reused.fingerings),
+              1e-9);
+}
+
+}  // namespace
+}  // namespace piano_fingering::optimizer
@@ -0,0 +1,73 @@
+#include "optimizer/state_generation.h"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <iterator>
+#include <optional>
+#include <stdexcept>
+#include <vector>
+
+#include "domain/finger.h"
+#include "domain/packed_fingering.h"
+
+namespace piano_fingering::optimizer {
+namespace {
+
+using domain::Finger;
+using domain::PackedFingering;
+
+TEST(StateGenerationTest, SingleNoteHasOneStatePerFinger) {
+  auto states = generate_valid_states(1);
+  ASSERT_EQ(states.size(), domain::kFingerCount);
+  for (size_t i = 0; i < states.size(); ++i) {
+    EXPECT_EQ(states[i][0], domain::all_fingers()[i]);
+    EXPECT_EQ(states[i][1], std::nullopt);
+  }
+}
+
+TEST(StateGenerationTest, CountsArePermutations) {
+  EXPECT_EQ(generate_valid_states(0).size(), 1);
+  EXPECT_EQ(generate_valid_states(2).size(), 20);
+  EXPECT_EQ(generate_valid_states(3).size(), 60);
+  EXPECT_EQ(generate_valid_states(5).size(), 120);
+}
+
+TEST(StateGenerationTest, StatesAreDistinctAndValid) {
+  auto states = generate_valid_states(3);
+  for (PackedFingering state : states) {
+    EXPECT_FALSE(state.violates_hard_constraint());
+    EXPECT_TRUE(state[2].has_value());
+  }
+  EXPECT_EQ(states.front().unpack(3).size(), 3);
+  EXPECT_EQ(states.front()[1], Finger::kIndex);
+
+  auto bits = [](PackedFingering state) { return state.bits(); };
+  std::vector<std::uint16_t> codes;
+  std::transform(states.begin(), states.end(), std::back_inserter(codes),
+                 bits);
+  std::sort(codes.begin(), codes.end());
+  EXPECT_EQ(std::adjacent_find(codes.begin(), codes.end()), codes.end());
+}
+
+TEST(StateGenerationTest, TableIsBuiltAtCompileTime) {
+  constexpr auto pairs = generate_valid_states(2);
+  static_assert(pairs.size() == 20);
+  static_assert(pairs[0][0] == Finger::kThumb && pairs[0][1] == Finger::kIndex);
+  static_assert(pairs[19][0] == Finger::kPinky &&
+                pairs[19][1] == Finger::kRing);
+
+  // Views into one static table: repeated calls share storage
+  EXPECT_EQ(generate_valid_states(4).data(), generate_valid_states(4).data());
+  EXPECT_EQ(generate_valid_states(0).size(), 1);
+  EXPECT_EQ(generate_valid_states(0)[0], PackedFingering{});
+}
+
+TEST(StateGenerationTest, TooManyNotesThrows) {
+  EXPECT_THROW({ [[maybe_unused]] auto s = generate_valid_states(6); },
+               std::invalid_argument);
+}
+
+}  // namespace
+}  // namespace piano_fingering::optimizer
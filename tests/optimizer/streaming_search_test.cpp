@@ -0,0 +1,180 @@
+#include "optimizer/streaming_search.h"
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+#include "config/config.h"
+#include "config/preset.h"
+#include "domain/hand.h"
+#include "domain/measure.h"
+#include "domain/metadata.h"
+#include "domain/note.h"
+#include "domain/packed_fingering.h"
+#include "domain/piece.h"
+#include "domain/pitch.h"
+#include "domain/slice.h"
+#include "evaluator/eval_piece.h"
+#include "evaluator/score_evaluator.h"
+#include "optimizer/exact_search.h"
+
+namespace piano_fingering::optimizer {
+namespace {
+
+using config::Config;
+using domain::Hand;
+using domain::Measure;
+using domain::Metadata;
+using domain::Note;
+using domain::PackedFingeringSequence;
+using domain::Piece;
+using domain::Pitch;
+using domain::Slice;
+using domain::TimeSignature;
+using evaluator::EvalPiece;
+using evaluator::ScoreEvaluator;
+
+Note make_note(int pitch_val, int octave) {
+  return Note(Pitch(pitch_val), octave, 480, false, 1, 1);
+}
+
+Note make_rest() { return Note(Pitch(0), 4, 480, true, 1, 1); }
+
+Config make_medium_config() {
+  Config config{};
+  config.right_hand = config::make_medium_right_hand();
+  config.left_hand = config::mirror_to_left_hand(config.right_hand);
+  config.weights = config::RuleWeights::defaults();
+  return config;
+}
+
+// Pseudo-random slices with a chord every fifth and a rest every eleventh
+std::vector<Slice> make_slices(size_t count) {
+  std::vector<Slice> slices;
+  std::uint32_t seed = 3;
+  auto next_pitch = [&seed] {
+    seed = seed * 1103515245U + 12345U;
+    return static_cast<int>((seed >> 16) % 14);
+  };
+  for (size_t i = 0; i < count; ++i) {
+    if (i % 11 == 10) {
+      slices.push_back(Slice({make_rest()}));
+    } else if (i % 5 == 4) {
+      slices.push_back(
+          Slice({make_note(next_pitch(), 4), make_note(next_pitch(), 5)}));
+    } else {
+      slices.push_back(Slice({make_note(next_pitch(), 4)}));
+    }
+  }
+  return slices;
+}
+
+Piece make_piece(const std::vector<Slice>& slices) {
+  return Piece(Metadata("Test", "Composer"), {},
+               {Measure(1, slices, TimeSignature(4, 4))});
+}
+
+class StreamingSearchTest : public ::testing::Test {
+ protected:
+  // Streams every slice, then finishes; returns the finished score
+  double stream(const std::vector<Slice>& slices,
+                const StreamingOptions& options,
+                PackedFingeringSequence& out, size_t* max_pending = nullptr) {
+    StreamingSearch search(evaluator_, Hand::kRight, options);
+    for (const Slice& slice : slices) {
+      static_cast<void>(search.push(slice, out));
+      if (max_pending != nullptr) {
+        *max_pending = std::max(*max_pending, search.pending());
+      }
+    }
+    return search.finish(out);
+  }
+
+  ScoreEvaluator evaluator_{make_medium_config()};
+};
+
+TEST_F(StreamingSearchTest, MatchesExactSearchWithoutForcedCommits) {
+  const std::vector<Slice> slices = make_slices(120);
+  const EvalPiece piece(make_piece(slices), Hand::kRight);
+
+  StreamingOptions options;
+  options.max_lag = slices.size();
+  PackedFingeringSequence out;
+  const double cost = stream(slices, options, out);
+
+  ASSERT_EQ(out.size(), piece.slice_count());
+  EXPECT_FALSE(out.violates_hard_constraint());
+  EXPECT_NEAR(cost, evaluator_.evaluate(piece, out), 1e-9);
+  EXPECT_NEAR(cost, exact_search(evaluator_, piece).cost, 1e-9);
+}
+
+TEST_F(StreamingSearchTest, LagBoundsPendingSlices) {
+  const std::vector<Slice> slices = make_slices(300);
+  const EvalPiece piece(make_piece(slices), Hand::kRight);
+
+  for (size_t lag : {1, 4, 16}) {
+    StreamingOptions options;
+    options.max_lag = lag;
+    PackedFingeringSequence out;
+    size_t max_pending = 0;
+    const double cost = stream(slices, options, out, &max_pending);
+    ASSERT_EQ(out.size(), piece.slice_count()) << "lag " << lag;
+    EXPECT_LE(max_pending, lag);
+    EXPECT_NEAR(cost, evaluator_.evaluate(piece, out), 1e-9);
+    EXPECT_GE(cost, exact_search(evaluator_, piece).cost - 1e-9);
+  }
+}
+
+TEST_F(StreamingSearchTest, CommitsBeforeTheStreamEnds) {
+  StreamingSearch search(evaluator_, Hand::kRight);
+  PackedFingeringSequence out;
+  const std::vector<Slice> slices = make_slices(200);
+  for (const Slice& slice : slices) {
+    static_cast<void>(search.push(slice, out));
+  }
+  // Paths converge long before the default lag forces anything
+  EXPECT_GT(out.size(), 0U);
+  EXPECT_LT(search.pending(), StreamingOptions{}.max_lag);
+}
+
+TEST_F(StreamingSearchTest, NarrowBeamStaysConsistent) {
+  const std::vector<Slice> slices = make_slices(150);
+  const EvalPiece piece(make_piece(slices), Hand::kRight);
+  StreamingOptions options;
+  options.beam_width = 3;
+  PackedFingeringSequence out;
+  const double cost = stream(slices, options, out);
+  ASSERT_EQ(out.size(), piece.slice_count());
+  EXPECT_NEAR(cost, evaluator_.evaluate(piece, out), 1e-9);
+}
+
+TEST_F(StreamingSearchTest, RestsAndEmptyStreams) {
+  StreamingSearch search(evaluator_, Hand::kRight);
+  PackedFingeringSequence out;
+  EXPECT_EQ(search.push(Slice({make_rest()}), out), 0U);
+  EXPECT_EQ(search.pending(), 0U);
+  EXPECT_DOUBLE_EQ(search.finish(out), 0.0);
+  EXPECT_TRUE(out.empty());
+
+  // Reusable after finish()
+  static_cast<void>(search.push(Slice({make_note(0, 4)}), out));
+  EXPECT_DOUBLE_EQ(search.finish(out), 0.0);
+  EXPECT_EQ(out.size(), 1U);
+}
+
+TEST_F(StreamingSearchTest, RejectsZeroOptions) {
+  StreamingOptions no_lag;
+  no_lag.max_lag = 0;
+  EXPECT_THROW(StreamingSearch(evaluator_, Hand::kRight, no_lag),
+               std::invalid_argument);
+  StreamingOptions no_beam;
+  no_beam.beam_width = 0;
+  EXPECT_THROW(StreamingSearch(evaluator_, Hand::kRight, no_beam),
+               std::invalid_argument);
+}
+
+}  // namespace
+}  // namespace piano_fingering::optimizer
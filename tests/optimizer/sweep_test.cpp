@@ -0,0 +1,122 @@
+#include "optimizer/sweep.h"
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+#include "config/config.h"
+#include "config/configuration_error.h"
+#include "config/preset.h"
+#include "domain/measure.h"
+#include "domain/metadata.h"
+#include "domain/note.h"
+#include "domain/piece.h"
+#include "domain/pitch.h"
+#include "domain/slice.h"
+#include "optimizer/optimizer.h"
+#include "optimizer/thread_pool.h"
+
+namespace piano_fingering::optimizer {
+namespace {
+
+using config::Config;
+using domain::Measure;
+using domain::Metadata;
+using domain::Note;
+using domain::Piece;
+using domain::Pitch;
+using domain::Slice;
+using domain::TimeSignature;
+
+Config make_config(const config::DistanceMatrix& right_hand) {
+  Config config{};
+  config.right_hand = right_hand;
+  config.left_hand = config::mirror_to_left_hand(right_hand);
+  config.weights = config::RuleWeights::defaults();
+  config.algorithm.beam_width = 20;
+  config.algorithm.ils_iterations = 50;
+  config.algorithm.ils_trajectories = 4;
+  return config;
+}
+
+std::vector<Config> make_presets() {
+  return {make_config(config::make_small_right_hand()),
+          make_config(config::make_medium_right_hand()),
+          make_config(config::make_large_right_hand())};
+}
+
+Note make_note(int pitch_val, int octave, int staff) {
+  return Note(Pitch(pitch_val), octave, 480, false, staff, 1);
+}
+
+// Pseudo-random melody over a left-hand line
+Piece make_piece(size_t slice_count) {
+  std::vector<Slice> left;
+  std::vector<Slice> right;
+  std::uint32_t seed = 5;
+  auto next_pitch = [&seed] {
+    seed = seed * 1103515245U + 12345U;
+    return static_cast<int>((seed >> 16) % 14);
+  };
+  for (size_t i = 0; i < slice_count; ++i) {
+    left.push_back(Slice({make_note(next_pitch(), 2, 2)}));
+    right.push_back(Slice({make_note(next_pitch(), 5, 1)}));
+  }
+  return Piece(Metadata("Test", "Composer"),
+               {Measure(1, std::move(left), TimeSignature(4, 4))},
+               {Measure(1, std::move(right), TimeSignature(4, 4))});
+}
+
+TEST(SweepTest, MatchesSeparateRuns) {
+  const std::vector<Config> configs = make_presets();
+  const Piece piece = make_piece(40);
+  ThreadPool pool(4);
+
+  const auto results = optimize_sweep(configs, piece, 7, pool);
+  ASSERT_EQ(results.size(), configs.size());
+  for (size_t i = 0; i < configs.size(); ++i) {
+    Optimizer optimizer(configs[i], pool);
+    const auto expected = optimizer.optimize_piece(piece, 7);
+    EXPECT_DOUBLE_EQ(results[i].score, expected.score) << "config " << i;
+    EXPECT_DOUBLE_EQ(results[i].right_hand.score, expected.right_hand.score);
+    EXPECT_DOUBLE_EQ(results[i].left_hand.score, expected.left_hand.score);
+    EXPECT_EQ(results[i].iterations_performed,
+              expected.iterations_performed);
+    ASSERT_EQ(results[i].right_hand.fingerings.size(),
+              expected.right_hand.fingerings.size());
+    for (size_t s = 0; s < expected.right_hand.fingerings.size(); ++s) {
+      EXPECT_EQ(results[i].right_hand.fingerings[s],
+                expected.right_hand.fingerings[s]);
+    }
+  }
+}
+
+TEST(SweepTest, ConfigsDiffer) {
+  const Piece piece = make_piece(40);
+  ThreadPool pool(2);
+  const auto results = optimize_sweep(make_presets(), piece, 1, pool);
+  ASSERT_EQ(results.size(), 3U);
+  EXPECT_FALSE(results[0].left_hand.fingerings.empty());
+  EXPECT_FALSE(results[0].right_hand.fingerings.empty());
+  // The same leaps cost a small hand more than a large one
+  EXPECT_NE(results[0].score, results[2].score);
+}
+
+TEST(SweepTest, EmptySweep) {
+  ThreadPool pool(1);
+  EXPECT_TRUE(optimize_sweep({}, make_piece(5), 1, pool).empty());
+}
+
+TEST(SweepTest, RejectsAnInvalidConfigUpFront) {
+  std::vector<Config> configs = make_presets();
+  configs[1].algorithm.beam_width = 0;
+  ThreadPool pool(2);
+  EXPECT_THROW(static_cast<void>(optimize_sweep(configs, make_piece(10), 1,
+                                                pool)),
+               config::ConfigurationError);
+}
+
+}  // namespace
+}  // namespace piano_fingering::optimizer
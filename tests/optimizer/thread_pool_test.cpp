@@ -0,0 +1,229 @@
+#include "optimizer/thread_pool.h"
+
+#include <gtest/gtest.h>
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <memory_resource>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+namespace piano_fingering::optimizer {
+namespace {
+
+size_t fibonacci(ThreadPool& pool, size_t n) {
+  if (n < 2) {
+    return n;
+  }
+  size_t left = 0;
+  size_t right = 0;
+  TaskGroup group(pool);
+  group.run([&] { left = fibonacci(pool, n - 1); });
+  right = fibonacci(pool, n - 2);
+  group.wait();
+  return left + right;
+}
+
+TEST(TaskTest, SmallClosuresStoreInline) {
+  int a = 0;
+  int b = 0;
+  auto small = [&a, &b, n = size_t{3}] { a += static_cast<int>(n) + b; };
+  static_assert(Task::kStoresInline<decltype(small)>);
+
+  std::array<char, 128> payload{};
+  auto large = [payload, &a] { a += payload[0] + 1; };
+  static_assert(!Task::kStoresInline<decltype(large)>);
+
+  Task first(small);
+  Task second(std::move(large));
+  Task moved(std::move(first));
+  EXPECT_FALSE(first);
+  ASSERT_TRUE(moved);
+  moved();
+  second = std::move(moved);
+  second();
+  EXPECT_EQ(a, 6);
+}
+
+TEST(TaskTest, MoveOnlyClosuresAreReleased) {
+  auto resource = std::make_shared<int>(1);
+  {
+    Task task([owned = std::make_unique<std::shared_ptr<int>>(resource)] {
+      ++**owned;
+    });
+    task();
+    EXPECT_EQ(resource.use_count(), 2);
+  }
+  EXPECT_EQ(*resource, 2);
+  EXPECT_EQ(resource.use_count(), 1);
+}
+
+TEST(ThreadPoolTest, ZeroThreadsThrows) {
+  EXPECT_THROW(ThreadPool pool(0), std::invalid_argument);
+  EXPECT_GE(ThreadPool::default_thread_count(), 1);
+}
+
+TEST(ThreadPoolTest, DestructorRunsPostedTasks) {
+  std::atomic<int> count{0};
+  {
+    ThreadPool pool(3);
+    EXPECT_EQ(pool.thread_count(), 3);
+    for (int i = 0; i < 1000; ++i) {
+      pool.post([&count] { count.fetch_add(1); });
+    }
+  }
+  EXPECT_EQ(count.load(), 1000);
+}
+
+TEST(ThreadPoolTest, GroupsNestOnOneThread) {
+  ThreadPool pool(1);
+  EXPECT_EQ(fibonacci(pool, 18), 2584);
+}
+
+TEST(ThreadPoolTest, GroupsNestAcrossThreads) {
+  ThreadPool pool(4);
+  EXPECT_EQ(fibonacci(pool, 20), 6765);
+}
+
+TEST(ThreadPoolTest, GroupRethrowsFirstError) {
+  ThreadPool pool(2);
+  TaskGroup group(pool);
+  std::atomic<int> finished{0};
+  for (int i = 0; i < 8; ++i) {
+    group.run([i, &finished] {
+      finished.fetch_add(1);
+      if (i == 3) {
+        throw std::runtime_error("task failed");
+      }
+    });
+  }
+  EXPECT_THROW(group.wait(), std::runtime_error);
+  EXPECT_EQ(finished.load(), 8);
+  // The error is consumed; the group is reusable
+  group.run([&finished] { finished.fetch_add(1); });
+  group.wait();
+  EXPECT_EQ(finished.load(), 9);
+}
+
+TEST(ThreadPoolTest, ParallelForVisitsEveryIndexOnce) {
+  ThreadPool pool(4);
+  std::vector<std::atomic<int>> visits(1001);
+  parallel_for(pool, 0, visits.size(), [&](size_t i) {
+    visits[i].fetch_add(1);
+  });
+  for (size_t i = 0; i < visits.size(); ++i) {
+    EXPECT_EQ(visits[i].load(), 1) << "index " << i;
+  }
+
+  std::atomic<size_t> sum{0};
+  parallel_for(
+      pool, 10, 20, [&](size_t i) { sum.fetch_add(i); }, 3);
+  EXPECT_EQ(sum.load(), 145);
+  parallel_for(pool, 5, 5, [&](size_t) { sum.fetch_add(1); });
+  EXPECT_EQ(sum.load(), 145);
+}
+
+TEST(ThreadPoolTest, ParallelForPropagatesErrors) {
+  ThreadPool pool(2);
+  EXPECT_THROW(parallel_for(pool, 0, 100,
+                            [](size_t i) {
+                              if (i == 77) {
+                                throw std::out_of_range("bad index");
+                              }
+                            }),
+               std::out_of_range);
+}
+
+TEST(ThreadPoolTest, ParallelInvokeRunsEveryCallable) {
+  ThreadPool pool(2);
+  int a = 0;
+  int b = 0;
+  int c = 0;
+  parallel_invoke(
+      pool, [&] { a = 1; }, [&] { b = 2; }, [&] { c = 3; });
+  EXPECT_EQ(a + b + c, 6);
+}
+
+// Two nodes on one allowed CPU, so placement is testable on any machine
+CpuTopology two_node_topology() {
+  const CpuTopology detected = CpuTopology::detect();
+  if (detected.empty()) {
+    return {};
+  }
+  const unsigned cpu = detected.cpus(0).front();
+  return CpuTopology({{cpu}, {cpu}});
+}
+
+TEST(ThreadPoolTest, DefaultPoolIsNotPlaced) {
+  ThreadPool pool(2);
+  EXPECT_EQ(pool.pinned_workers(), 0);
+  EXPECT_EQ(pool.node_count(), 1);
+  EXPECT_TRUE(pool.placement().topology.empty());
+  pool.post([] {
+    const ScratchScope scratch;
+    EXPECT_EQ(scratch.resource(), std::pmr::get_default_resource());
+  });
+}
+
+TEST(ThreadPoolTest, PinnedWorkersSpreadOverNodes) {
+  WorkerPlacement placement;
+  placement.pin_workers = true;
+  placement.topology = two_node_topology();
+  if (placement.topology.empty()) {
+    GTEST_SKIP() << "No CPU topology on this platform";
+  }
+  ThreadPool pool(4, placement);
+  if (pool.pinned_workers() == 0) {
+    GTEST_SKIP() << "Thread affinity refused";
+  }
+  EXPECT_EQ(pool.pinned_workers(), 4);
+  EXPECT_EQ(pool.node_count(), 2);
+  for (size_t worker = 0; worker < 4; ++worker) {
+    EXPECT_EQ(pool.worker_node(worker), worker % 2);
+  }
+  EXPECT_EQ(pool.worker_node(pool.thread_count()), 0);
+
+  std::atomic<size_t> sum{0};
+  parallel_for(pool, 0, 100, [&](size_t i) { sum += i; });
+  EXPECT_EQ(sum.load(), 4950);
+}
+
+TEST(ThreadPoolTest, WorkerArenasRewindAfterOutermostScope) {
+  WorkerPlacement placement;
+  placement.arena_bytes = 4096;
+  std::atomic<bool> ran{false};
+  {
+    // Posted rather than run in a group, whose waiter could run it itself;
+    // the destructor lets the worker finish it
+    ThreadPool pool(1, placement);
+    pool.post([&ran] {
+      void* first = nullptr;
+      {
+        const ScratchScope outer;
+        EXPECT_NE(outer.resource(), std::pmr::get_default_resource());
+        first = outer.resource()->allocate(64);
+        {
+          // Nested scopes share the arena and do not rewind it
+          const ScratchScope inner;
+          EXPECT_EQ(inner.resource(), outer.resource());
+          EXPECT_NE(inner.resource()->allocate(64), first);
+        }
+        EXPECT_NE(outer.resource()->allocate(64), first);
+      }
+      const ScratchScope next;
+      EXPECT_EQ(next.resource()->allocate(64), first);
+      ran = true;
+    });
+  }
+  EXPECT_TRUE(ran.load());
+
+  // Off the pool there is no arena
+  const ScratchScope outside;
+  EXPECT_EQ(outside.resource(), std::pmr::get_default_resource());
+}
+
+}  // namespace
+}  // namespace piano_fingering::optimizer
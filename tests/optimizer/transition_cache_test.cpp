@@ -0,0 +1,148 @@
+#include "optimizer/transition_cache.h"
+
+#include <gtest/gtest.h>
+
+#include <stdexcept>
+
+#include "config/config.h"
+#include "config/preset.h"
+#include "domain/finger.h"
+#include "domain/hand.h"
+#include "domain/measure.h"
+#include "domain/metadata.h"
+#include "domain/note.h"
+#include "domain/packed_fingering.h"
+#include "domain/piece.h"
+#include "domain/pitch.h"
+#include "domain/slice.h"
+#include "evaluator/eval_piece.h"
+#include "evaluator/score_evaluator.h"
+#include "optimizer/state_generation.h"
+
+namespace piano_fingering::optimizer {
+namespace {
+
+using config::Config;
+using domain::Finger;
+using domain::Hand;
+using domain::Measure;
+using domain::Metadata;
+using domain::Note;
+using domain::PackedFingering;
+using domain::Piece;
+using domain::Pitch;
+using domain::Slice;
+using domain::TimeSignature;
+using evaluator::EvalPiece;
+using evaluator::ScoreEvaluator;
+
+Note make_note(int pitch_val, int octave) {
+  return Note(Pitch(pitch_val), octave, 480, false, 1, 1);
+}
+
+Config make_medium_config() {
+  Config config{};
+  config.right_hand = config::make_medium_right_hand();
+  config.left_hand = config::mirror_to_left_hand(config.right_hand);
+  config.weights = config::RuleWeights::defaults();
+  return config;
+}
+
+// Black keys, a leap and a chord
+Piece make_piece() {
+  return Piece(
+      Metadata("Test", "Composer"), {},
+      {Measure(1,
+               {Slice({make_note(0, 4)}), Slice({make_note(3, 4)}),
+                Slice({make_note(6, 4), make_note(10, 4)}),
+                Slice({make_note(1, 4)}), Slice({make_note(10, 5)})},
+               TimeSignature(4, 4))});
+}
+
+class TransitionCacheTest : public ::testing::Test {
+ protected:
+  Config config_ = make_medium_config();
+  ScoreEvaluator evaluator_{config_};
+  Piece piece_ = make_piece();
+  EvalPiece compiled_{piece_, Hand::kRight};
+};
+
+TEST_F(TransitionCacheTest, MatchesEvaluatorForEveryStatePair) {
+  TransitionCache cache(evaluator_, compiled_);
+  for (size_t slice = 1; slice < compiled_.slice_count(); ++slice) {
+    for (PackedFingering prev :
+         generate_valid_states(compiled_.slice_size(slice - 1))) {
+      for (PackedFingering curr :
+           generate_valid_states(compiled_.slice_size(slice))) {
+        EXPECT_DOUBLE_EQ(cache.transition(slice, prev, curr),
+                         evaluator_.evaluate_transition(
+                             compiled_, {slice - 1, prev}, {slice, curr}));
+      }
+    }
+  }
+  // One matrix per boundary, shared by every chord state
+  EXPECT_EQ(cache.fill_count(), compiled_.slice_count() - 1);
+}
+
+TEST_F(TransitionCacheTest, TripletMatchesEvaluator) {
+  TransitionCache cache(evaluator_, compiled_);
+  const auto chord_states = generate_valid_states(2);
+  for (PackedFingering middle : chord_states) {
+    for (Finger first : domain::all_fingers()) {
+      for (Finger last : domain::all_fingers()) {
+        PackedFingering a;
+        a.set(0, first);
+        PackedFingering c;
+        c.set(0, last);
+        EXPECT_DOUBLE_EQ(
+            cache.triplet(3, a, middle, c),
+            evaluator_.evaluate_triplet(compiled_, {1, a}, {2, middle},
+                                        {3, c}));
+      }
+    }
+  }
+}
+
+TEST_F(TransitionCacheTest, EvictsWhenCapacityIsExceeded) {
+  TransitionCache cache(evaluator_, compiled_, 2);
+  EXPECT_EQ(cache.capacity(), 2);
+
+  const double first = cache.transition(1, Finger::kThumb, Finger::kIndex);
+  [[maybe_unused]] double again =
+      cache.transition(1, Finger::kIndex, Finger::kThumb);
+  EXPECT_EQ(cache.fill_count(), 1);
+
+  // Slice 3 maps to the same slot as slice 1
+  [[maybe_unused]] double other =
+      cache.transition(3, Finger::kThumb, Finger::kIndex);
+  EXPECT_DOUBLE_EQ(cache.transition(1, Finger::kThumb, Finger::kIndex), first);
+  EXPECT_EQ(cache.fill_count(), 3);
+}
+
+TEST_F(TransitionCacheTest, InvalidUseThrows) {
+  EXPECT_THROW(TransitionCache(evaluator_, compiled_, 0),
+               std::invalid_argument);
+
+  TransitionCache cache(evaluator_, compiled_);
+  EXPECT_THROW(
+      {
+        [[maybe_unused]] auto c =
+            cache.transition(0, Finger::kThumb, Finger::kThumb);
+      },
+      std::out_of_range);
+  EXPECT_THROW(
+      {
+        [[maybe_unused]] auto c = cache.triplet(
+            1, Finger::kThumb, Finger::kIndex, Finger::kMiddle);
+      },
+      std::out_of_range);
+  EXPECT_THROW(
+      {
+        [[maybe_unused]] auto c =
+            cache.transition(1, PackedFingering{}, PackedFingering{});
+      },
+      std::invalid_argument);
+}
+
+}  // namespace
+}  // namespace piano_fingering::optimizer
@@ -0,0 +1,59 @@
+#include "optimizer/worker_placement.h"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+namespace piano_fingering::optimizer {
+namespace {
+
+TEST(WorkerPlacementTest, TopologyDropsNodesWithoutCpus) {
+  const CpuTopology topology({{0, 1}, {}, {4}});
+  ASSERT_EQ(topology.node_count(), 2);
+  EXPECT_EQ(topology.cpus(0), (std::vector<unsigned>{0, 1}));
+  EXPECT_EQ(topology.cpus(1), (std::vector<unsigned>{4}));
+  EXPECT_THROW((void)topology.cpus(2), std::out_of_range);
+  EXPECT_TRUE(CpuTopology().empty());
+}
+
+TEST(WorkerPlacementTest, DetectedTopologyListsEachCpuOnce) {
+  const CpuTopology topology = CpuTopology::detect();
+  std::vector<unsigned> all;
+  for (size_t node = 0; node < topology.node_count(); ++node) {
+    EXPECT_FALSE(topology.cpus(node).empty());
+    all.insert(all.end(), topology.cpus(node).begin(),
+               topology.cpus(node).end());
+  }
+  std::sort(all.begin(), all.end());
+  EXPECT_EQ(std::adjacent_find(all.begin(), all.end()), all.end());
+#if defined(__linux__)
+  EXPECT_FALSE(topology.empty());
+#endif
+}
+
+TEST(WorkerPlacementTest, PinningNothingFails) {
+  std::thread([] { EXPECT_FALSE(pin_current_thread({})); }).join();
+}
+
+TEST(WorkerPlacementTest, RunOnNodeRunsOnAnotherThreadAndRethrows) {
+  const CpuTopology topology = CpuTopology::detect();
+  const std::thread::id caller = std::this_thread::get_id();
+  std::thread::id runner;
+  run_on_node(topology, 0, [&] { runner = std::this_thread::get_id(); });
+  EXPECT_NE(runner, caller);
+
+  // Out-of-range nodes run unpinned
+  bool ran = false;
+  run_on_node(topology, topology.node_count(), [&] { ran = true; });
+  EXPECT_TRUE(ran);
+
+  EXPECT_THROW(
+      run_on_node(topology, 0, [] { throw std::runtime_error("replica"); }),
+      std::runtime_error);
+}
+
+}  // namespace
+}  // namespace piano_fingering::optimizer
@@ -4,16 +4,55 @@
 
 #include <gtest/gtest.h>
 
+#include <cstdint>
 #include <filesystem>
 #include <fstream>
+#include <stdexcept>
 #include <string>
+#include <vector>
 
+#include "domain/measure.h"
+#include "domain/note.h"
 #include "domain/piece.h"
 #include "parser/parser_error.h"
 
 namespace piano_fingering::parser {
 namespace {
 
+void expect_same_hand(const std::vector<domain::Measure>& actual,
+                      const std::vector<domain::Measure>& expected) {
+  ASSERT_EQ(actual.size(), expected.size());
+  for (size_t m = 0; m < actual.size(); ++m) {
+    EXPECT_EQ(actual[m].number(), expected[m].number());
+    EXPECT_EQ(actual[m].time_signature(), expected[m].time_signature());
+    ASSERT_EQ(actual[m].size(), expected[m].size());
+    for (size_t s = 0; s < actual[m].size(); ++s) {
+      ASSERT_EQ(actual[m][s].size(), expected[m][s].size());
+      for (size_t n = 0; n < actual[m][s].size(); ++n) {
+        const domain::Note& a = actual[m][s][n];
+        const domain::Note& e = expected[m][s][n];
+        EXPECT_EQ(a.pitch(), e.pitch());
+        EXPECT_EQ(a.octave(), e.octave());
+        EXPECT_EQ(a.duration(), e.duration());
+        EXPECT_EQ(a.is_rest(), e.is_rest());
+        EXPECT_EQ(a.staff(), e.staff());
+        EXPECT_EQ(a.voice(), e.voice());
+      }
+    }
+  }
+}
+
+// Everything but the DOM
+void expect_same_result(const MusicXMLParser::ParseResult& actual,
+                        const MusicXMLParser::ParseResult& expected) {
+  EXPECT_EQ(actual.piece.metadata(), expected.piece.metadata());
+  expect_same_hand(actual.piece.right_hand(), expected.piece.right_hand());
+  expect_same_hand(actual.piece.left_hand(), expected.piece.left_hand());
+  EXPECT_EQ(actual.warnings, expected.warnings);
+  EXPECT_EQ(actual.source_map.right_hand, expected.source_map.right_hand);
+  EXPECT_EQ(actual.source_map.left_hand, expected.source_map.left_hand);
+}
+
 // Fixture for parser tests
 class MusicXMLParserTest : public ::testing::Test {
  protected:
@@ -69,6 +108,12 @@ TEST_F(MusicXMLParserTest, MalformedXML) {
   EXPECT_THROW(MusicXMLParser::parse(path), MalformedXMLError);
 }
 
+// Test: Empty file is reported as malformed, not missing
+TEST_F(MusicXMLParserTest, EmptyFileIsMalformed) {
+  auto path = write_temp_xml("empty.xml", "");
+  EXPECT_THROW(MusicXMLParser::parse(path), MalformedXMLError);
+}
+
 // Test: Missing score-partwise root
 TEST_F(MusicXMLParserTest, MissingScorePartwise) {
   auto xml = R"(<?xml version="1.0"?>
@@ -308,5 +353,467 @@ TEST_F(MusicXMLParserTest, PreservesOriginalXML) {
   EXPECT_STREQ(title.text().as_string(), "Original Title");
 }
 
+// Test: Both staves are collected from one measure
+TEST_F(MusicXMLParserTest, InterleavedStavesSplitIntoHands) {
+  auto xml = R"(<?xml version="1.0"?>
+<score-partwise version="4.0">
+  <part id="P1">
+    <measure number="1">
+      <note>
+        <pitch><step>C</step><octave>5</octave></pitch>
+        <duration>4</duration>
+        <staff>1</staff>
+      </note>
+      <note>
+        <pitch><step>C</step><octave>3</octave></pitch>
+        <duration>4</duration>
+        <staff>2</staff>
+      </note>
+      <note>
+        <chord/>
+        <pitch><step>G</step><octave>3</octave></pitch>
+        <duration>4</duration>
+        <staff>2</staff>
+      </note>
+      <note>
+        <pitch><step>D</step><octave>5</octave></pitch>
+        <duration>4</duration>
+        <staff>1</staff>
+      </note>
+    </measure>
+  </part>
+</score-partwise>
+)";
+
+  auto path = write_temp_xml("interleaved.xml", xml);
+  auto result = MusicXMLParser::parse(path);
+
+  const auto& rh = result.piece.right_hand();
+  ASSERT_EQ(rh.size(), 1);
+  ASSERT_EQ(rh[0].size(), 2);
+  EXPECT_EQ(rh[0][1][0].pitch().value(), 2);
+
+  const auto& lh = result.piece.left_hand();
+  ASSERT_EQ(lh.size(), 1);
+  ASSERT_EQ(lh[0].size(), 1);
+  EXPECT_EQ(lh[0][0].size(), 2);
+  EXPECT_TRUE(result.warnings.empty());
+}
+
+// Test: Invalid notes are skipped and reported instead of thrown
+TEST_F(MusicXMLParserTest, SkippedNotesAreReportedAsWarnings) {
+  auto xml = R"(<?xml version="1.0"?>
+<score-partwise version="4.0">
+  <part id="P1">
+    <measure number="7">
+      <note>
+        <duration>4</duration>
+        <staff>1</staff>
+      </note>
+      <note>
+        <pitch><step>C</step><octave>4</octave></pitch>
+        <duration>4</duration>
+        <staff>3</staff>
+      </note>
+      <note>
+        <pitch><step>E</step><octave>4</octave></pitch>
+        <duration>4</duration>
+        <staff>1</staff>
+      </note>
+    </measure>
+  </part>
+</score-partwise>
+)";
+
+  auto path = write_temp_xml("warnings.xml", xml);
+  auto result = MusicXMLParser::parse(path);
+
+  ASSERT_EQ(result.piece.right_hand().size(), 1);
+  EXPECT_EQ(result.piece.right_hand()[0].size(), 1);
+
+  ASSERT_EQ(result.warnings.size(), 2);
+  EXPECT_EQ(result.warnings[0],
+            "Measure 7: skipping note: Missing required element: pitch");
+  EXPECT_EQ(result.warnings[1],
+            "Measure 7: skipping note: Staff must be 1 or 2");
+}
+
+// Test: Discard-document mode returns the same piece without the DOM
+TEST_F(MusicXMLParserTest, DiscardDocumentModeDropsOriginalXML) {
+  auto xml = R"(<?xml version="1.0"?>
+<score-partwise version="4.0">
+  <work>
+    <work-title>Piece Only</work-title>
+  </work>
+  <part id="P1">
+    <measure number="1">
+      <note>
+        <pitch><step>C</step><octave>4</octave></pitch>
+        <duration>4</duration>
+        <staff>1</staff>
+      </note>
+      <note>
+        <pitch><step>C</step><octave>3</octave></pitch>
+        <duration>4</duration>
+        <staff>2</staff>
+      </note>
+    </measure>
+  </part>
+</score-partwise>
+)";
+
+  auto path = write_temp_xml("piece_only.xml", xml);
+  auto full = MusicXMLParser::parse(path);
+  auto lean =
+      MusicXMLParser::parse(path, MusicXMLParser::ParseMode::kDiscardDocument);
+
+  EXPECT_EQ(lean.original_xml, nullptr);
+  EXPECT_EQ(lean.piece.metadata().title(), "Piece Only");
+  ASSERT_EQ(lean.piece.right_hand().size(), full.piece.right_hand().size());
+  ASSERT_EQ(lean.piece.left_hand().size(), full.piece.left_hand().size());
+  EXPECT_EQ(lean.piece.right_hand()[0][0][0],
+            full.piece.right_hand()[0][0][0]);
+}
+
+// Test: The forward pass reads exactly what the DOM path reads, down to
+// the first-child rules, entity decoding and number conversion
+TEST_F(MusicXMLParserTest, DiscardDocumentModeMatchesDocumentMode) {
+  auto xml = R"(<?xml version="1.0" encoding="UTF-8"?>
+<!DOCTYPE score-partwise PUBLIC "-//Recordare//DTD MusicXML 4.0 Partwise//EN"
+  "http://www.musicxml.org/dtds/partwise.dtd">
+<score-partwise version="4.0">
+  <part id="P0"><measure number="1"><note>
+    <pitch><step>B</step><octave>2</octave></pitch><duration>1</duration>
+  </note></measure></part>
+  <work><work-title>Etude &amp; <![CDATA[Fugue]]></work-title></work>
+  <work><work-title>Second work</work-title></work>
+  <identification>
+    <creator type="lyricist">Someone</creator>
+    <creator type='composer'>C&#233;sar</creator>
+  </identification>
+  <part id="P&amp;1">
+    <measure number=" 7">
+      <attributes><time><beats>3</beats><beat-type>4</beat-type></time>
+      </attributes>
+      <attributes><time><beats>5</beats></time></attributes>
+      <!-- a chord, written top down -->
+      <note default-x="10">
+        <pitch><step>G</step><alter>+1</alter><octave> 4 </octave></pitch>
+        <duration>0x10</duration><voice>2</voice><staff>1</staff>
+        <staff>2</staff>
+      </note>
+      <note><chord/><pitch><step><![CDATA[e]]></step><octave>4</octave>
+        </pitch><duration>16</duration></note>
+      <note><chord/><pitch><step>C</step><alter>-1</alter><octave>4</octave>
+        </pitch><duration>16</duration></note>
+      <note><rest/><duration>8</duration><staff>2</staff></note>
+      <note><pitch><step>H</step><octave>4</octave></pitch>
+        <duration>4</duration></note>
+      <note><pitch><octave>4</octave></pitch><duration>4</duration></note>
+      <note><duration>4</duration></note>
+      <note><pitch><step>A</step></pitch><duration>-4</duration></note>
+      <note><pitch><step>A</step></pitch></note>
+      <note><pitch><step>A</step><octave>11</octave></pitch>
+        <duration>4</duration></note>
+      <note><pitch><step>D</step></pitch><duration>4</duration>
+        <voice>5</voice></note>
+      <note><pitch><step>D</step></pitch><duration>4</duration>
+        <staff>3</staff></note>
+      <note><pitch><step>D</step></pitch><duration>4</duration>
+        <staff>x</staff></note>
+      <direction><note><duration>4</duration></note></direction>
+    </measure>
+    <measure>
+      <note><pitch><step>F</step><octave>3</octave></pitch>
+        <duration>99999999999</duration><staff>2</staff></note>
+    </measure>
+    <measure number="9">
+      <attributes><divisions>4</divisions></attributes>
+      <note><pitch><step>C</step><octave>5</octave></pitch>
+        <duration>4</duration></note>
+      <note><chord/><pitch><step>D</step><octave>5</octave></pitch>
+        <duration>4</duration></note>
+      <note><chord/><pitch><step>E</step><octave>5</octave></pitch>
+        <duration>4</duration></note>
+      <note><chord/><pitch><step>F</step><octave>5</octave></pitch>
+        <duration>4</duration></note>
+      <note><chord/><pitch><step>G</step><octave>5</octave></pitch>
+        <duration>4</duration></note>
+      <note><chord/><pitch><step>A</step><octave>5</octave></pitch>
+        <duration>4</duration></note>
+    </measure>
+  </part>
+</score-partwise>
+)";
+
+  auto path = write_temp_xml("streamed.xml", xml);
+  MusicXMLParser::ParseOptions options;
+  options.part_id = "P&1";
+  auto full = MusicXMLParser::parse(path, options);
+  options.mode = MusicXMLParser::ParseMode::kDiscardDocument;
+  auto lean = MusicXMLParser::parse(path, options);
+
+  EXPECT_EQ(lean.original_xml, nullptr);
+  expect_same_result(lean, full);
+  EXPECT_EQ(lean.piece.metadata().title(), "Etude & ");
+  EXPECT_EQ(lean.piece.metadata().composer(), "C\xC3\xA9sar");
+  EXPECT_EQ(lean.warnings.size(), 10);
+  ASSERT_EQ(lean.piece.right_hand().size(), 2);
+  EXPECT_EQ(lean.piece.right_hand()[0].number(), 7);
+  EXPECT_EQ(lean.piece.right_hand()[0].time_signature(),
+            domain::TimeSignature(3, 4));
+  EXPECT_EQ(lean.piece.right_hand()[1].time_signature(),
+            domain::common_time());
+  EXPECT_EQ(lean.piece.right_hand()[0][0].size(), 3);
+  EXPECT_EQ(lean.piece.right_hand()[0][0][2].duration(), 16);
+  EXPECT_EQ(lean.piece.left_hand()[1].number(), 1);
+  EXPECT_EQ(lean.piece.left_hand()[1][0][0].duration(), UINT32_MAX);
+  EXPECT_FALSE(lean.source_map.right_hand.empty());
+}
+
+// Test: Both modes fail the same way on bad input
+TEST_F(MusicXMLParserTest, DiscardDocumentModeReportsTheSameErrors) {
+  const std::string valid_part = R"(<part id="P1"><measure number="1">
+  <note><pitch><step>C</step><octave>4</octave></pitch>
+    <duration>1</duration></note></measure></part>)";
+  auto check = [&](const std::string& name, const std::string& xml,
+                   auto error) {
+    SCOPED_TRACE(name);
+    using Error = decltype(error);
+    auto path = write_temp_xml(name + ".xml", xml);
+    for (auto mode : {MusicXMLParser::ParseMode::kKeepDocument,
+                      MusicXMLParser::ParseMode::kDiscardDocument}) {
+      EXPECT_THROW((void)MusicXMLParser::parse(path, mode), Error);
+    }
+  };
+  check("empty", "", MalformedXMLError(0, ""));
+  check("unclosed", "<score-partwise>" + valid_part,
+        MalformedXMLError(0, ""));
+  // The fault is after the part the forward pass has already read
+  check("trailing", "<score-partwise>" + valid_part + "</score-partwise></x>",
+        MalformedXMLError(0, ""));
+  check("timewise", "<score-timewise>" + valid_part + "</score-timewise>",
+        MissingElementError(""));
+  check("no_part", "<score-partwise></score-partwise>",
+        MissingElementError(""));
+  check("bad_time",
+        "<score-partwise><part><measure><attributes><time><beats>0</beats>"
+        "</time></attributes></measure></part></score-partwise>",
+        std::invalid_argument(""));
+  // A semantic error still loses to a later syntax error, as with a DOM
+  check("bad_time_then_malformed",
+        "<score-partwise><part><measure><attributes><time><beats>0</beats>"
+        "</time></attributes></measure></part></score-partwise><",
+        MalformedXMLError(0, ""));
+}
+
+// Test: Both modes agree on every golden-set file
+TEST_F(MusicXMLParserTest, DiscardDocumentModeMatchesOnGoldenSet) {
+  size_t files = 0;
+  for (const auto& entry :
+       std::filesystem::directory_iterator(BASELINE_DIR)) {
+    if (entry.path().extension() != ".musicxml") {
+      continue;
+    }
+    SCOPED_TRACE(entry.path().filename().string());
+    auto full = MusicXMLParser::parse(entry.path());
+    auto lean = MusicXMLParser::parse(
+        entry.path(), MusicXMLParser::ParseMode::kDiscardDocument);
+    expect_same_result(lean, full);
+    ++files;
+  }
+  EXPECT_EQ(files, 8);
+}
+
+// Test: A second cached parse is served from the piece cache
+TEST_F(MusicXMLParserTest, ParseCachedReusesCompiledPiece) {
+  auto xml = R"(<?xml version="1.0"?>
+<score-partwise version="4.0">
+  <work>
+    <work-title>Cached</work-title>
+  </work>
+  <part id="P1">
+    <measure number="1">
+      <note>
+        <pitch><step>E</step><octave>4</octave></pitch>
+        <duration>4</duration>
+        <staff>1</staff>
+      </note>
+      <note>
+        <duration>4</duration>
+        <staff>1</staff>
+      </note>
+    </measure>
+  </part>
+</score-partwise>
+)";
+
+  auto path = write_temp_xml("cached.xml", xml);
+  auto cache_dir = temp_dir_ / "cache";
+  auto first = MusicXMLParser::parse_cached(path, cache_dir);
+  EXPECT_EQ(first.original_xml, nullptr);
+  ASSERT_EQ(first.warnings.size(), 1);
+  EXPECT_FALSE(std::filesystem::is_empty(cache_dir));
+
+  auto second = MusicXMLParser::parse_cached(path, cache_dir);
+  EXPECT_EQ(second.piece.metadata().title(), "Cached");
+  EXPECT_EQ(second.warnings, first.warnings);
+  ASSERT_EQ(second.piece.right_hand().size(), 1);
+  EXPECT_EQ(second.piece.right_hand()[0][0][0].pitch().value(), 4);
+
+  // Editing the file changes its hash, so the stale entry is not used
+  std::string edited = xml;
+  edited.replace(edited.find("Cached"), 6, "Edited");
+  write_temp_xml("cached.xml", edited);
+  auto third = MusicXMLParser::parse_cached(path, cache_dir);
+  EXPECT_EQ(third.piece.metadata().title(), "Edited");
+}
+
+// Test: A part other than the first can be chosen by id
+TEST_F(MusicXMLParserTest, SelectsPartById) {
+  auto xml = R"(<?xml version="1.0"?>
+<score-partwise version="4.0">
+  <part id="P1">
+    <measure number="1">
+      <note>
+        <pitch><step>C</step><octave>4</octave></pitch>
+        <duration>4</duration>
+      </note>
+    </measure>
+  </part>
+  <part id="P2">
+    <measure number="1">
+      <note>
+        <pitch><step>A</step><octave>4</octave></pitch>
+        <duration>4</duration>
+      </note>
+    </measure>
+  </part>
+</score-partwise>
+)";
+
+  auto path = write_temp_xml("parts.xml", xml);
+  MusicXMLParser::ParseOptions options;
+  options.part_id = "P2";
+  auto result = MusicXMLParser::parse(path, options);
+  ASSERT_EQ(result.piece.right_hand().size(), 1);
+  EXPECT_EQ(result.piece.right_hand()[0][0][0].pitch().value(), 9);
+
+  options.part_id = "P3";
+  EXPECT_THROW((void)MusicXMLParser::parse(path, options),
+               MissingElementError);
+  options.part_id.clear();
+  options.threads = 0;
+  EXPECT_THROW((void)MusicXMLParser::parse(path, options),
+               std::invalid_argument);
+}
+
+// Test: Parallel extraction gives exactly the serial result
+TEST_F(MusicXMLParserTest, ParallelExtractionMatchesSerial) {
+  const char* steps = "CDEFGAB";
+  std::string xml = R"(<?xml version="1.0"?>
+<score-partwise version="4.0">
+  <part id="P1">
+)";
+  for (int m = 1; m <= 500; ++m) {
+    xml += "<measure number=\"" + std::to_string(m) + "\">";
+    if (m % 97 == 0) {
+      xml += "<attributes><time><beats>3</beats><beat-type>8</beat-type>"
+             "</time></attributes>";
+    }
+    xml += std::string("<note><pitch><step>") + steps[m % 7] +
+           "</step><octave>5</octave></pitch><duration>2</duration>"
+           "<staff>1</staff></note>";
+    if (m % 3 == 0) {
+      xml += "<note><pitch><step>C</step><octave>3</octave></pitch>"
+             "<duration>2</duration><staff>2</staff></note>";
+    }
+    if (m % 50 == 0) {
+      xml += "<note><duration>2</duration></note>";  // missing pitch
+    }
+    xml += "</measure>\n";
+  }
+  xml += "  </part>\n</score-partwise>\n";
+
+  auto path = write_temp_xml("long.xml", xml);
+  auto serial = MusicXMLParser::parse(path);
+  MusicXMLParser::ParseOptions options;
+  options.threads = 4;
+  auto parallel = MusicXMLParser::parse(path, options);
+
+  EXPECT_EQ(parallel.warnings, serial.warnings);
+  EXPECT_EQ(serial.warnings.size(), 10);
+  EXPECT_EQ(parallel.source_map.right_hand, serial.source_map.right_hand);
+  EXPECT_EQ(parallel.source_map.left_hand, serial.source_map.left_hand);
+  for (bool right : {true, false}) {
+    const auto& a =
+        right ? serial.piece.right_hand() : serial.piece.left_hand();
+    const auto& b =
+        right ? parallel.piece.right_hand() : parallel.piece.left_hand();
+    ASSERT_EQ(a.size(), b.size());
+    for (size_t i = 0; i < a.size(); ++i) {
+      EXPECT_EQ(a[i].number(), b[i].number());
+      EXPECT_EQ(a[i].time_signature(), b[i].time_signature());
+      EXPECT_EQ(a[i][0][0], b[i][0][0]);
+    }
+  }
+  EXPECT_EQ(serial.piece.right_hand()[100].time_signature(),
+            domain::TimeSignature(3, 8));
+}
+
+// Test: Source map offsets point at each note, in sorted slice order
+TEST_F(MusicXMLParserTest, SourceMapLocatesNotes) {
+  auto xml = R"(<?xml version="1.0"?>
+<score-partwise version="4.0">
+  <part id="P1">
+    <measure number="1">
+      <note>
+        <pitch><step>G</step><octave>4</octave></pitch>
+        <duration>4</duration>
+        <staff>1</staff>
+      </note>
+      <note>
+        <chord/>
+        <pitch><step>C</step><octave>4</octave></pitch>
+        <duration>4</duration>
+        <staff>1</staff>
+      </note>
+      <note>
+        <rest/>
+        <duration>4</duration>
+        <staff>2</staff>
+      </note>
+    </measure>
+  </part>
+</score-partwise>
+)";
+
+  auto path = write_temp_xml("source_map.xml", xml);
+  auto result = MusicXMLParser::parse(path);
+  const std::string score = MusicXMLParser::read_score(path);
+  EXPECT_EQ(score, xml);
+
+  const auto& right = result.source_map.right_hand;
+  const auto& left = result.source_map.left_hand;
+  ASSERT_EQ(right.size(), 2);
+  ASSERT_EQ(left.size(), 1);
+  for (uint32_t offset : {right[0], right[1], left[0]}) {
+    EXPECT_EQ(score.compare(offset, 6, "<note>"), 0);
+  }
+  // C sorts first though it is written second
+  EXPECT_EQ(score.find("<step>", right[0]), score.find("<step>C"));
+  EXPECT_EQ(score.find("<step>", right[1]), score.find("<step>G"));
+  EXPECT_GT(left[0], right[0]);
+
+  // The same text comes back from the parse itself when asked for
+  EXPECT_TRUE(result.score.empty());
+  MusicXMLParser::ParseOptions options;
+  options.mode = MusicXMLParser::ParseMode::kDiscardDocument;
+  options.keep_score = true;
+  const auto kept = MusicXMLParser::parse(path, options);
+  EXPECT_EQ(kept.score, score);
+  EXPECT_EQ(kept.source_map.right_hand, right);
+}
+
 }  // namespace
 }  // namespace piano_fingering::parser
@@ -0,0 +1,139 @@
+// tests/parser/piece_cache_test.cpp - Unit tests for the binary piece cache
+
+#include "parser/piece_cache.h"
+
+#include <gtest/gtest.h>
+
+#include <filesystem>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "domain/measure.h"
+#include "domain/metadata.h"
+#include "domain/note.h"
+#include "domain/piece.h"
+#include "domain/pitch.h"
+#include "domain/slice.h"
+#include "domain/time_signature.h"
+
+namespace piano_fingering::parser {
+namespace {
+
+using domain::Measure;
+using domain::Note;
+using domain::Pitch;
+using domain::Slice;
+
+domain::Piece sample_piece() {
+  Slice chord{Note(Pitch(0), 4, 480, false, 1, 1),
+              Note(Pitch(4), 4, 480, false, 1, 1),
+              Note(Pitch(7), 4, 480, false, 1, 2)};
+  Slice rest{Note(Pitch(0), 4, 240, true, 1, 1)};
+  Slice bass{Note(Pitch(13), 2, 960, false, 2, 3)};
+  return {domain::Metadata("Title", "Composer"),
+          {Measure(1, {bass}, domain::cut_time())},
+          {Measure(1, {chord, rest}, domain::common_time()),
+           Measure(2, {rest}, domain::TimeSignature(3, 8))}};
+}
+
+void expect_same_hand(const std::vector<Measure>& actual,
+                      const std::vector<Measure>& expected) {
+  ASSERT_EQ(actual.size(), expected.size());
+  for (size_t m = 0; m < actual.size(); ++m) {
+    EXPECT_EQ(actual[m].number(), expected[m].number());
+    EXPECT_EQ(actual[m].time_signature(), expected[m].time_signature());
+    ASSERT_EQ(actual[m].size(), expected[m].size());
+    for (size_t s = 0; s < actual[m].size(); ++s) {
+      ASSERT_EQ(actual[m][s].size(), expected[m][s].size());
+      for (size_t n = 0; n < actual[m][s].size(); ++n) {
+        const Note& a = actual[m][s][n];
+        const Note& e = expected[m][s][n];
+        EXPECT_EQ(a.pitch(), e.pitch());
+        EXPECT_EQ(a.octave(), e.octave());
+        EXPECT_EQ(a.duration(), e.duration());
+        EXPECT_EQ(a.is_rest(), e.is_rest());
+        EXPECT_EQ(a.staff(), e.staff());
+        EXPECT_EQ(a.voice(), e.voice());
+      }
+    }
+  }
+}
+
+TEST(PieceCacheTest, RoundTripsPieceAndWarnings) {
+  const domain::Piece piece = sample_piece();
+  const std::vector<std::string> warnings = {"Measure 3: skipping note: x"};
+  const std::string bytes = encode_piece_cache(42, piece, warnings, {});
+
+  auto cached = decode_piece_cache(bytes, 42);
+  ASSERT_TRUE(cached.has_value());
+  EXPECT_EQ(cached->piece.metadata(), piece.metadata());
+  EXPECT_EQ(cached->warnings, warnings);
+  expect_same_hand(cached->piece.left_hand(), piece.left_hand());
+  expect_same_hand(cached->piece.right_hand(), piece.right_hand());
+  EXPECT_TRUE(cached->source_map.empty());
+}
+
+TEST(PieceCacheTest, RoundTripsSourceMap) {
+  domain::SourceMap source_map;
+  source_map.left_hand = {900};
+  source_map.right_hand = {100, 200, 300, 400, 500};
+  const std::string bytes =
+      encode_piece_cache(42, sample_piece(), {}, source_map);
+
+  auto cached = decode_piece_cache(bytes, 42);
+  ASSERT_TRUE(cached.has_value());
+  EXPECT_EQ(cached->source_map.left_hand, source_map.left_hand);
+  EXPECT_EQ(cached->source_map.right_hand, source_map.right_hand);
+
+  source_map.right_hand.pop_back();
+  EXPECT_THROW((void)encode_piece_cache(42, sample_piece(), {}, source_map),
+               std::invalid_argument);
+}
+
+TEST(PieceCacheTest, StaleOrDamagedBytesAreAMiss) {
+  const std::string bytes = encode_piece_cache(42, sample_piece(), {}, {});
+  EXPECT_FALSE(decode_piece_cache(bytes, 43).has_value());
+  EXPECT_FALSE(decode_piece_cache(bytes.substr(0, bytes.size() - 1), 42));
+  EXPECT_FALSE(decode_piece_cache("", 42).has_value());
+
+  std::string damaged = bytes;
+  damaged[damaged.size() / 2] ^= 0x40;
+  EXPECT_FALSE(decode_piece_cache(damaged, 42).has_value());
+
+  std::string other_version = bytes;
+  other_version[4] = static_cast<char>(kPieceCacheVersion + 1);
+  EXPECT_FALSE(decode_piece_cache(other_version, 42).has_value());
+}
+
+TEST(PieceCacheTest, ContentHashSeesEveryByte) {
+  const std::string text = "<score-partwise>0123456789</score-partwise>";
+  const uint64_t hash = content_hash(text);
+  EXPECT_EQ(content_hash(text), hash);
+  for (size_t i = 0; i < text.size(); ++i) {
+    std::string changed = text;
+    changed[i] ^= 1;
+    EXPECT_NE(content_hash(changed), hash) << "byte " << i;
+  }
+  EXPECT_NE(content_hash(text + '\0'), hash);
+}
+
+TEST(PieceCacheTest, StoresAndLoadsFromDirectory) {
+  const auto dir =
+      std::filesystem::temp_directory_path() / "piece_cache_test";
+  std::filesystem::remove_all(dir);
+
+  EXPECT_FALSE(load_piece_cache(dir, 7).has_value());
+  ASSERT_TRUE(store_piece_cache(dir, 7, sample_piece(), {}, {}));
+  EXPECT_TRUE(std::filesystem::exists(piece_cache_path(dir, 7)));
+
+  auto cached = load_piece_cache(dir, 7);
+  ASSERT_TRUE(cached.has_value());
+  EXPECT_EQ(cached->piece.metadata().title(), "Title");
+  EXPECT_FALSE(load_piece_cache(dir, 8).has_value());
+
+  std::filesystem::remove_all(dir);
+}
+
+}  // namespace
+}  // namespace piano_fingering::parser
@@ -43,5 +43,11 @@ TEST(PitchMappingTest, InvalidStep) {
   EXPECT_THROW(step_alter_to_pitch("X", 0), std::invalid_argument);
 }
 
+TEST(PitchMappingTest, TryVariantReportsInvalidStep) {
+  EXPECT_EQ(try_step_alter_to_pitch("g", 1)->value(), 8);
+  EXPECT_FALSE(try_step_alter_to_pitch("X", 0).has_value());
+  EXPECT_FALSE(try_step_alter_to_pitch("", 0).has_value());
+}
+
 }  // namespace
 }  // namespace piano_fingering::parser
@@ -0,0 +1,123 @@
+// tests/parser/xml_reader_test.cpp - Unit tests for XmlReader
+
+#include "parser/xml_reader.h"
+
+#include <gtest/gtest.h>
+
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "parser/parser_error.h"
+
+namespace piano_fingering::parser {
+namespace {
+
+using Token = XmlReader::Token;
+
+// One line per token: "<name", ">name" for its end, or the decoded text
+std::vector<std::string> tokens(std::string_view xml) {
+  XmlReader reader(xml);
+  std::vector<std::string> out;
+  std::string scratch;
+  for (Token token = reader.next(); token != Token::kEnd;
+       token = reader.next()) {
+    switch (token) {
+      case Token::kStartElement:
+        out.push_back("<" + std::string(reader.name()));
+        break;
+      case Token::kEndElement:
+        out.push_back(">" + std::string(reader.name()));
+        break;
+      case Token::kText:
+        out.emplace_back(reader.text(scratch));
+        break;
+      case Token::kEnd:
+        break;
+    }
+  }
+  return out;
+}
+
+TEST(XmlReaderTest, ReadsElementsAndText) {
+  const std::vector<std::string> expected = {"<a", "<b", "1", ">b", "<c",
+                                             ">c", ">a"};
+  EXPECT_EQ(
+      tokens("<?xml version=\"1.0\"?>\n<a>\n  <b>1</b>\n  <c/>\n</a>\n"),
+      expected);
+}
+
+TEST(XmlReaderTest, SkipsPrologCommentsAndInstructions) {
+  const std::string xml =
+      "\xEF\xBB\xBF<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n"
+      "<!DOCTYPE score-partwise PUBLIC \"-//Recordare//DTD 4.0//EN\" "
+      "\"http://www.musicxml.org/dtds/partwise.dtd\" "
+      "[ <!ENTITY e \"x>\"> ]>\n"
+      "<!-- before -->\n"
+      "<a><!-- <b> --><?pi data?>x<!---->y</a>\n"
+      "<!-- after -->";
+  const std::vector<std::string> expected = {"<a", "x", "y", ">a"};
+  EXPECT_EQ(tokens(xml), expected);
+}
+
+TEST(XmlReaderTest, DecodesAsPugixmlDoes) {
+  const std::vector<std::string> expected = {
+      "<a", "<t", "a<b>&\"'", ">t", "<u", "\xC3\xA9\xE2\x82\xAC", ">u",
+      "<v", "&unknown; & x", ">v", "<w", "line\nbreak\n", ">w",
+      "<x", "<&amp;\n", ">x", ">a"};
+  EXPECT_EQ(tokens("<a><t>a&lt;b&gt;&amp;&quot;&apos;</t>"
+                   "<u>&#233;&#x20AC;</u>"
+                   "<v>&unknown; & x</v>"
+                   "<w>line\r\nbreak\r</w>"
+                   "<x><![CDATA[<&amp;\r\n]]></x></a>"),
+            expected);
+}
+
+TEST(XmlReaderTest, ReadsAttributes) {
+  const std::string_view xml =
+      "<a id='P&amp;1' type = \"comp\tos\ner\" empty=\"\"><b/></a>";
+  XmlReader reader(xml);
+  ASSERT_EQ(reader.next(), Token::kStartElement);
+  EXPECT_EQ(reader.offset(), 0);
+  std::string scratch;
+  EXPECT_EQ(reader.attribute("id", scratch), "P&1");
+  EXPECT_EQ(reader.attribute("type", scratch), "comp os er");
+  EXPECT_EQ(reader.attribute("empty", scratch), "");
+  EXPECT_EQ(reader.attribute("missing", scratch), std::nullopt);
+  ASSERT_EQ(reader.next(), Token::kStartElement);
+  EXPECT_EQ(reader.name(), "b");
+  EXPECT_EQ(reader.offset(), xml.find("<b/>"));
+  EXPECT_EQ(reader.attribute("id", scratch), std::nullopt);
+}
+
+TEST(XmlReaderTest, DropsWhitespaceOnlyTextButNotCData) {
+  const std::vector<std::string> expected = {"<a", " ", ">a"};
+  EXPECT_EQ(tokens("<a> \r\n\t<![CDATA[ ]]>\n</a>"), expected);
+}
+
+TEST(XmlReaderTest, SkipConsumesTheWholeElement) {
+  XmlReader reader("<a><b><c>1</c><d/></b><e/></a>");
+  ASSERT_EQ(reader.next(), Token::kStartElement);
+  ASSERT_EQ(reader.next(), Token::kStartElement);
+  reader.skip();
+  ASSERT_EQ(reader.next(), Token::kStartElement);
+  EXPECT_EQ(reader.name(), "e");
+  EXPECT_EQ(reader.next(), Token::kEndElement);
+  EXPECT_EQ(reader.next(), Token::kEndElement);
+  EXPECT_EQ(reader.next(), Token::kEnd);
+}
+
+TEST(XmlReaderTest, RejectsDocumentsThatAreNotWellFormed) {
+  for (const char* xml :
+       {"", "  \n", "<!-- only -->", "<a>", "<a></b>", "<a><b></a></b>",
+        "</a>", "<a>x", "<a/></a>", "<a b></a>", "<a b=1></a>",
+        "<a b=\"1\"c=\"2\"/>", "<a b=\"1></a>", "<a><!-- x</a>",
+        "<a><![CDATA[x</a>", "<1a/>", "<a/ >", "<a><!ELEMENT x></a>"}) {
+    SCOPED_TRACE(xml);
+    EXPECT_THROW(tokens(xml), MalformedXMLError);
+  }
+}
+
+}  // namespace
+}  // namespace piano_fingering::parser
@@ -0,0 +1,140 @@
+// tests/parser/zip_archive_test.cpp - Unit tests for ZipArchive
+
+#include "parser/zip_archive.h"
+
+#include <gtest/gtest.h>
+#include <zlib.h>
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "parser/parser_error.h"
+
+namespace piano_fingering::parser {
+namespace {
+
+struct TestEntry {
+  std::string name;
+  std::string content;
+  bool deflate;
+};
+
+void put_u16(std::string& out, uint32_t value) {
+  out.push_back(static_cast<char>(value & 0xFF));
+  out.push_back(static_cast<char>((value >> 8) & 0xFF));
+}
+
+void put_u32(std::string& out, uint32_t value) {
+  put_u16(out, value & 0xFFFF);
+  put_u16(out, value >> 16);
+}
+
+std::string raw_deflate(const std::string& input) {
+  z_stream stream{};
+  deflateInit2(&stream, Z_BEST_COMPRESSION, Z_DEFLATED, -MAX_WBITS, 8,
+               Z_DEFAULT_STRATEGY);
+  std::string output(deflateBound(&stream, input.size()), '\0');
+  stream.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(input.data()));
+  stream.avail_in = static_cast<uInt>(input.size());
+  stream.next_out = reinterpret_cast<Bytef*>(output.data());
+  stream.avail_out = static_cast<uInt>(output.size());
+  deflate(&stream, Z_FINISH);
+  output.resize(stream.total_out);
+  deflateEnd(&stream);
+  return output;
+}
+
+// Minimal zip writer: local headers, central directory, end record
+std::string make_zip(const std::vector<TestEntry>& entries) {
+  std::string zip;
+  std::string directory;
+  for (const TestEntry& entry : entries) {
+    const std::string data =
+        entry.deflate ? raw_deflate(entry.content) : entry.content;
+    const auto crc = static_cast<uint32_t>(
+        crc32(0L, reinterpret_cast<const Bytef*>(entry.content.data()),
+              static_cast<uInt>(entry.content.size())));
+    const auto offset = static_cast<uint32_t>(zip.size());
+    const uint16_t method = entry.deflate ? 8 : 0;
+
+    put_u32(zip, 0x04034b50);
+    put_u16(zip, 20);
+    put_u16(zip, 0);
+    put_u16(zip, method);
+    put_u32(zip, 0);  // time, date
+    put_u32(zip, crc);
+    put_u32(zip, static_cast<uint32_t>(data.size()));
+    put_u32(zip, static_cast<uint32_t>(entry.content.size()));
+    put_u16(zip, static_cast<uint32_t>(entry.name.size()));
+    put_u16(zip, 0);
+    zip += entry.name;
+    zip += data;
+
+    put_u32(directory, 0x02014b50);
+    put_u16(directory, 20);
+    put_u16(directory, 20);
+    put_u16(directory, 0);
+    put_u16(directory, method);
+    put_u32(directory, 0);
+    put_u32(directory, crc);
+    put_u32(directory, static_cast<uint32_t>(data.size()));
+    put_u32(directory, static_cast<uint32_t>(entry.content.size()));
+    put_u16(directory, static_cast<uint32_t>(entry.name.size()));
+    put_u32(directory, 0);  // extra and comment lengths
+    put_u32(directory, 0);  // disk, internal attributes
+    put_u32(directory, 0);  // external attributes
+    put_u32(directory, offset);
+    directory += entry.name;
+  }
+  const auto directory_offset = static_cast<uint32_t>(zip.size());
+  zip += directory;
+  put_u32(zip, 0x06054b50);
+  put_u32(zip, 0);
+  put_u16(zip, static_cast<uint32_t>(entries.size()));
+  put_u16(zip, static_cast<uint32_t>(entries.size()));
+  put_u32(zip, static_cast<uint32_t>(directory.size()));
+  put_u32(zip, directory_offset);
+  put_u16(zip, 0);
+  return zip;
+}
+
+TEST(ZipArchiveTest, ReadsStoredAndDeflatedEntries) {
+  const std::string score(5000, 'x');
+  const std::string zip = make_zip({{"mimetype", "application/x", false},
+                                    {"score.xml", score, true}});
+  ASSERT_TRUE(ZipArchive::is_zip(zip));
+
+  ZipArchive archive(zip);
+  ASSERT_EQ(archive.entries().size(), 2);
+  EXPECT_EQ(archive.find("missing.xml"), nullptr);
+
+  const ZipArchive::Entry* mimetype = archive.find("mimetype");
+  ASSERT_NE(mimetype, nullptr);
+  EXPECT_EQ(archive.read(*mimetype), "application/x");
+
+  const ZipArchive::Entry* entry = archive.find("score.xml");
+  ASSERT_NE(entry, nullptr);
+  EXPECT_EQ(entry->method, 8);
+  EXPECT_LT(entry->compressed_size, entry->size);
+  EXPECT_EQ(archive.read(*entry), score);
+}
+
+TEST(ZipArchiveTest, RejectsNonArchives) {
+  EXPECT_FALSE(ZipArchive::is_zip("<?xml version=\"1.0\"?>"));
+  EXPECT_THROW(ZipArchive("PK"), MalformedArchiveError);
+  EXPECT_THROW(ZipArchive(std::string(100, 'x')), MalformedArchiveError);
+}
+
+TEST(ZipArchiveTest, DetectsCorruptEntries) {
+  std::string zip = make_zip({{"a.xml", "hello world", false}});
+  // Flip one byte of the stored data, just after the 30-byte local header
+  // and the 5-byte name
+  zip[35] = 'H';
+  ZipArchive archive(zip);
+  EXPECT_THROW((void)archive.read(archive.entries()[0]),
+               MalformedArchiveError);
+}
+
+}  // namespace
+}  // namespace piano_fingering::parser
@@ -0,0 +1,60 @@
+#include "trace/trace.h"
+
+#include <gtest/gtest.h>
+
+#include <sstream>
+#include <string>
+#include <thread>
+
+namespace piano_fingering::trace {
+namespace {
+
+TEST(TraceTest, RecordsOnlyWhileStarted) {
+  record({"test", "before", 0, 1, nullptr, 0});
+  start();
+  EXPECT_EQ(event_count(), 0);
+  record({"test", "during", 0, 1, nullptr, 0});
+  stop();
+  record({"test", "after", 0, 1, nullptr, 0});
+  EXPECT_EQ(event_count(), 1);
+  EXPECT_EQ(dropped_count(), 0);
+
+  start();
+  EXPECT_EQ(event_count(), 0);
+  stop();
+}
+
+TEST(TraceTest, WritesCompleteEventsPerThreadTrack) {
+  start();
+  set_thread_name("main \"test\"");
+  record({"beam", "measure", 1500, 2250, "measure", 7});
+  std::thread worker([] {
+    set_thread_name("worker 0");
+    record({"pool", "task", 0, 10, nullptr, 0});
+  });
+  worker.join();
+  stop();
+
+  std::ostringstream out;
+  write_chrome_trace(out);
+  const std::string json = out.str();
+  EXPECT_NE(json.find("\"traceEvents\""), std::string::npos);
+  EXPECT_NE(json.find(R"("args":{"name":"main \"test\""})"),
+            std::string::npos);
+  EXPECT_NE(json.find(R"("args":{"name":"worker 0"})"), std::string::npos);
+  EXPECT_NE(json.find(R"("cat":"beam","name":"measure","ts":1.500,)"
+                      R"("dur":2.250,"args":{"measure":7})"),
+            std::string::npos);
+  EXPECT_NE(json.find(R"("cat":"pool","name":"task")"), std::string::npos);
+}
+
+TEST(TraceTest, SpanRecordsWhenCompiledIn) {
+  start();
+  { const Span span("test", "span", "index", 3); }
+  stop();
+  { const Span span("test", "ignored"); }
+  EXPECT_EQ(event_count(), kCompiledIn ? 1 : 0);
+}
+
+}  // namespace
+}  // namespace piano_fingering::trace